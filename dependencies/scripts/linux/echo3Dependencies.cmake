@@ -52,6 +52,12 @@ set(PKG_CONFIG_EXECUTABLE pkg-config --dont-define-prefix)
 if(BUILD_WITH_PNG)
 	pkg_check_modules(libpng REQUIRED IMPORTED_TARGET libpng)
 endif()
+if(BUILD_WITH_LZ4)
+	pkg_check_modules(liblz4 REQUIRED IMPORTED_TARGET liblz4)
+endif()
+if(BUILD_WITH_ZSTD)
+	pkg_check_modules(libzstd REQUIRED IMPORTED_TARGET libzstd)
+endif()
 
 if (ECHO_UI_FRAMEWORK STREQUAL "GTK")
 	pkg_check_modules(gtkmm REQUIRED IMPORTED_TARGET gtkmm-2.4)
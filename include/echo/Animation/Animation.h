@@ -62,6 +62,12 @@ namespace Echo
 		*/
 		void AnimationLengthAdjusted(Seconds time);
 
+		/**
+		* @brief	Called by AnimationTrack when a key frame is added.
+		* @details	Derived classes can override this to invalidate data built from the key frames.
+		*/
+		virtual void KeyFramesChanged(){}
+
 		/**
 		* @brief	Get length of the animation.
 		* @return   Animation time in seconds.
@@ -75,6 +81,12 @@ namespace Echo
 		*/
 		shared_ptr<AnimationTrack> GetAnimationTrack( size_t forIndex );
 
+		/**
+		* @brief	Get all of the animation tracks.
+		* @return   The tracks by index.
+		*/
+		const std::map<size_t, shared_ptr<AnimationTrack> >& GetAnimationTracks() const { return mTracks; }
+
 		/**
 		* @brief	Apply the animation at a given time index.
 		* @param	AnimationTimeIndex & timeIndex
@@ -0,0 +1,196 @@
+#ifndef _ECHOANIMATIONCLIP_H_
+#define _ECHOANIMATIONCLIP_H_
+
+#include <echo/Types.h>
+#include <echo/Chrono/Chrono.h>
+#include <echo/Maths/Vector3.h>
+#include <echo/Maths/Quaternion.h>
+#include <string>
+#include <vector>
+
+namespace Echo
+{
+	class SkeletonAnimation;
+	class Skeleton;
+
+	/**
+	 * AnimationClip is a baked, read only copy of a SkeletonAnimation that is fast to sample.
+	 *
+	 * The key frames of every bone track are stored in flat arrays, one set of arrays for each of the position,
+	 * orientation and scale channels. Each channel of each track references a range of keys in the arrays so a
+	 * track that doesn't change is stored as a single key. Key lookup uses a direct index if the keys of a
+	 * channel are evenly spaced and a binary search otherwise.
+	 *
+	 * Clips can optionally be compressed:
+	 *	- Keys that can be reproduced by interpolating their neighbours within a tolerance are removed.
+	 *	- Values can be quantised to 16 bits per component. Positions and scales are stored relative to the
+	 *	  range of their channel, orientations are stored as normalised components.
+	 *
+	 * Clips are normally created with SkeletonAnimation::Bake() and sampled with an AnimationClipSampler.
+	 * A clip does not reference the animation it was created from.
+	 */
+	class AnimationClip
+	{
+	public:
+		struct CompressionOptions
+		{
+			CompressionOptions() :
+				mSampleRate(0.f),
+				mPositionTolerance(0.f),
+				mOrientationTolerance(0.f),
+				mScaleTolerance(0.f),
+				mQuantise(false)
+			{}
+			f32 mSampleRate;				/// If greater than 0 the tracks are resampled at this many keys per second.
+			f32 mPositionTolerance;			/// Maximum distance error when removing position keys, 0 to keep all keys.
+			f32 mOrientationTolerance;		/// Maximum angle error in radians when removing orientation keys.
+			f32 mScaleTolerance;			/// Maximum error when removing scale keys.
+			bool mQuantise;					/// Store values with 16 bits per component.
+		};
+
+		/**
+		 * Bake an animation.
+		 * @param animation The animation to bake.
+		 * @param options The compression options, by default the clip is not compressed.
+		 */
+		AnimationClip(const SkeletonAnimation& animation, const CompressionOptions& options = CompressionOptions());
+		~AnimationClip();
+
+		const std::string& GetName() const {return mName;}
+		Seconds GetLength() const {return Seconds(mLength);}
+		const CompressionOptions& GetOptions() const {return mOptions;}
+
+		/**
+		 * Get the number of tracks. Tracks are sorted by bone index and tracks without keys are not included.
+		 */
+		Size GetNumberOfTracks() const {return mTracks.size();}
+		Size GetTrackBoneIndex(Size track) const {return mTracks[track].mBoneIndex;}
+
+		/**
+		 * Get the total number of keys across all tracks and channels.
+		 */
+		Size GetNumberOfKeys() const;
+
+		/**
+		 * Get the approximate number of bytes used by the clip.
+		 */
+		Size GetMemoryUsage() const;
+
+		/**
+		 * Sample a track.
+		 * Times before the first key or after the last key of a channel use the first or last key.
+		 * @param track The track index.
+		 * @param time The time in seconds.
+		 */
+		Vector3 SamplePosition(Size track, f32 time) const;
+		Quaternion SampleOrientation(Size track, f32 time) const;
+		Vector3 SampleScale(Size track, f32 time) const;
+	private:
+		struct Channel
+		{
+			u32 mFirstKey;
+			u32 mNumberOfKeys;
+			f32 mStartTime;
+			f32 mInverseInterval;	/// 1/(average time between keys) if the keys are close to evenly spaced, otherwise 0.
+			Vector3 mMinimum;		/// Quantised positions and scales are mMinimum + value * mStep.
+			Vector3 mStep;
+		};
+		struct Track
+		{
+			Size mBoneIndex;
+			Channel mPosition;
+			Channel mOrientation;
+			Channel mScale;
+		};
+		struct Key
+		{
+			f32 mTime;
+			Vector3 mPosition;
+			Quaternion mOrientation;
+			Vector3 mScale;
+		};
+
+		void AddVectorChannel(Channel& channel, const std::vector<Key>& keys, Vector3 Key::* member, f32 tolerance,
+							std::vector<f32>& times, std::vector<Vector3>& values, std::vector<u16>& quantisedValues);
+		void AddOrientationChannel(Channel& channel, const std::vector<Key>& keys, f32 tolerance);
+		static void SetTiming(Channel& channel, const std::vector<f32>& times);
+
+		/**
+		 * Find the key before the time and the fraction of the way to the next key.
+		 */
+		inline u32 FindKey(const Channel& channel, const std::vector<f32>& times, f32 time, f32& fraction) const;
+		inline Vector3 GetVector(const Channel& channel, const std::vector<Vector3>& values, const std::vector<u16>& quantisedValues, u32 key) const;
+		inline Quaternion GetOrientation(u32 key) const;
+
+		std::string mName;
+		f32 mLength;
+		CompressionOptions mOptions;
+		std::vector<Track> mTracks;
+		std::vector<f32> mPositionTimes;
+		std::vector<f32> mOrientationTimes;
+		std::vector<f32> mScaleTimes;
+		std::vector<Vector3> mPositions;
+		std::vector<Quaternion> mOrientations;
+		std::vector<Vector3> mScales;
+		std::vector<u16> mQuantisedPositions;
+		std::vector<s16> mQuantisedOrientations;
+		std::vector<u16> mQuantisedScales;
+	};
+
+	/**
+	 * AnimationClipSampler blends a number of AnimationClips and applies the result to a Skeleton.
+	 *
+	 * The pose is built in arrays indexed by bone index, starting from the initial pose of each bone. Each layer
+	 * is then sampled over all of its tracks and combined with the pose the same way SkeletonAnimation applies
+	 * key frames: positions are offset by the weighted key position and orientations are rotated by the weighted
+	 * key orientation. The bones are written once at the end with Skeleton::SetPose().
+	 *
+	 *		sampler.Clear();
+	 *		sampler.AddLayer(*walkClip, walkTime, 0.7f);
+	 *		sampler.AddLayer(*waveClip, waveTime, 0.3f);
+	 *		sampler.Apply(skeleton);
+	 *
+	 * Skeleton::UpdateTransforms() uses a sampler when all of its enabled animations have been baked.
+	 * @note Scale keys are not applied, which matches SkeletonAnimation::ApplyKeyFrame().
+	 */
+	class AnimationClipSampler
+	{
+	public:
+		AnimationClipSampler();
+		~AnimationClipSampler();
+
+		/**
+		 * Remove all layers.
+		 */
+		void Clear();
+
+		/**
+		 * Add a layer. Layers are combined in the order they are added.
+		 * @param clip The clip, it must remain valid until Apply() is called.
+		 * @param time The time to sample the clip.
+		 * @param weight The weight of the layer.
+		 */
+		void AddLayer(const AnimationClip& clip, Seconds time, f32 weight);
+
+		Size GetNumberOfLayers() const {return mLayers.size();}
+
+		/**
+		 * Blend the layers and set the position and orientation of each bone in the skeleton.
+		 */
+		void Apply(Skeleton& skeleton);
+
+		const std::vector<Vector3>& GetPositions() const {return mPositions;}
+		const std::vector<Quaternion>& GetOrientations() const {return mOrientations;}
+	private:
+		struct Layer
+		{
+			const AnimationClip* mClip;
+			f32 mTime;
+			f32 mWeight;
+		};
+		std::vector<Layer> mLayers;
+		std::vector<Vector3> mPositions;
+		std::vector<Quaternion> mOrientations;
+	};
+}
+#endif
@@ -71,6 +71,12 @@ namespace Echo
 		 */
 		const Seconds& GetAnimationLength() const { return mAnimationLength; }
 
+		/**
+		 * Get the key frames.
+		 * @return the key frames in time order.
+		 */
+		const std::vector< shared_ptr<KeyFrame> >& GetKeyFrames() const { return mKeyFrames; }
+
 		/**
 		 * Interpolates two KeyFrames of the derived key frame type.
 		 * The method can safely assume that the key frames will be the same type as what is
@@ -22,6 +22,12 @@ namespace Echo
 		{
 			mCachedOffsetTransform=Matrix4::IDENTITY;
 		}
+	protected:
+		/**
+		 * Marks the skeleton's pose as changed before the Node update.
+		 * Defined in Skeleton.cpp.
+		 */
+		void NeedUpdate(bool forceParent = false) const override;
 	public:
 		~Bone()
 		{
@@ -3,12 +3,15 @@
 
 #include <echo/Types.h>
 #include <echo/Animation/Bone.h>
+#include <echo/Animation/AnimationClip.h>
 #include <echo/Maths/Vector3.h>
 #include <echo/Maths/Quaternion.h>
 #include <echo/Kernel/TaskGroup.h>
 #include <echo/Resource/Resource.h>
+#include <echo/Kernel/Mutex.h>
 #include <set>
 #include <map>
+#include <vector>
 
 namespace Echo
 {
@@ -29,6 +32,11 @@ namespace Echo
 		shared_ptr<Bone> mRootBone;
 		std::string mName;
 		bool mTransformsOutOfDate;
+		Size mPoseVersion;
+		Size mSkinningPaletteVersion;
+		std::vector<Matrix4> mSkinningPalette;
+		Mutex mSkinningPaletteMutex;
+		AnimationClipSampler mAnimationSampler;
 		virtual bool _Unload() override;
 		virtual Size OnRequestMemoryRelease() override;
 	public:
@@ -83,6 +91,8 @@ namespace Echo
 		 * This method resets the skeleton pose then applies each active SkeletonAnimationState with the
 		 * configured weight (a setting on the animation state). The bone transforms are then updated
 		 * ready for the final pose.
+		 * If every enabled animation has been baked (see SkeletonAnimation::Bake()) the states are blended in
+		 * a single pass with an AnimationClipSampler.
 		 */
 		void UpdateTransforms();
 		
@@ -100,8 +110,37 @@ namespace Echo
 		void SetBindingPose();
 		
 		void MarkTransformsOutOfDate();
+
+		/**
+		 * Set the local position and orientation of every bone and reset the scales to the initial scales.
+		 * This is faster than setting each bone individually since the change is propagated through the bone
+		 * hierarchy once.
+		 * @param positions Positions by bone index, there must be an entry for every bone.
+		 * @param orientations Orientations by bone index, there must be an entry for every bone.
+		 */
+		void SetPose(const std::vector<Vector3>& positions, const std::vector<Quaternion>& orientations);
 		
 		bool GetTransformsOutOfDate() const {return mTransformsOutOfDate;}
+
+		/**
+		 * Get the pose version.
+		 * The version changes whenever a bone is modified or the binding pose is set. It can be used to check
+		 * whether something calculated from the pose, such as skinned vertices, is out of date.
+		 */
+		Size GetPoseVersion() const {return mPoseVersion;}
+
+		/**
+		 * Called by bones when they are modified.
+		 */
+		void MarkPoseChanged() {++mPoseVersion;}
+
+		/**
+		 * Get the skinning palette.
+		 * The palette contains the offset transform of each bone by bone index. Bone indices that are not used
+		 * have an identity matrix. The palette is only rebuilt when the pose version changes. This method can be
+		 * called from multiple threads as long as the bones are not being modified at the same time.
+		 */
+		const std::vector<Matrix4>& GetSkinningPalette();
 	};
 }
 
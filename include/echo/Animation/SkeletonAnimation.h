@@ -3,6 +3,7 @@
 
 #include <echo/Types.h>
 #include <echo/Animation/Animation.h>
+#include <echo/Animation/AnimationClip.h>
 #include <vector>
 
 namespace Echo
@@ -24,6 +25,7 @@ namespace Echo
 	private:
 		friend class Skeleton;
 		Skeleton& mSkeleton;
+		shared_ptr<AnimationClip> mClip;
 
 		SkeletonAnimation(const std::string& name, Skeleton& skeleton);
 	
@@ -38,6 +40,32 @@ namespace Echo
 		shared_ptr<BoneAnimationTrack> GetAnimationTrack( shared_ptr<Bone> forBone );
 
 		void ApplyKeyFrame(AnimationTrack& track, KeyFrame& keyFrame, f32 weight);
+
+		/**
+		 * Bake the key frames into an AnimationClip.
+		 * Once baked the Skeleton samples the clip rather than the key frames when it updates. The clip is
+		 * discarded if key frames are added, modifying existing key frames requires the animation to be baked
+		 * again.
+		 * @param options The compression options for the clip.
+		 * @return The clip.
+		 */
+		shared_ptr<AnimationClip> Bake(const AnimationClip::CompressionOptions& options = AnimationClip::CompressionOptions());
+
+		/**
+		 * Get the baked clip.
+		 * @return The clip or null if the animation has not been baked.
+		 */
+		shared_ptr<AnimationClip> GetClip() const { return mClip; }
+
+		/**
+		 * Discard the baked clip so the key frames are used.
+		 */
+		void ClearClip() { mClip.reset(); }
+
+		/**
+		 * Animation override, discards the baked clip.
+		 */
+		void KeyFramesChanged() override;
 	};
 }
 #endif 
@@ -27,6 +27,7 @@ namespace Echo
 			Frame(std::string resource, Seconds seconds) :
 				mFrameTime(seconds),
 				mResource(resource),
+				mHasTransform(false),
 				mOffset(Vector3::ZERO),
 				mScale(Vector3::UNIT_SCALE),
 				mOrientation(Quaternion::IDENTITY),
@@ -206,6 +207,8 @@ namespace Echo
 		size_t GetNumberOfFrames() const;
 	private:
 		friend class Sprite;
+		friend class SpriteBatch;
+		friend class SpriteAtlas;
 		/**
 		 * Internally used by Sprite to get the current frame.
 		 * @param index
@@ -88,6 +88,16 @@ namespace Echo
 		size_t GetPosition() const;
 		bool EndOfFile();
 
+		/**
+		 * Get direct access to the file's data.
+		 * Some FileSystemSources keep whole files in memory, for example memory files and memory mapped VFS
+		 * archives. For these files the data can be used in place rather than copied with Read().
+		 * @note Endian conversion is not applied to the data.
+		 * @return A pointer to GetSize() bytes of data from the start of the file, or nullptr if the file isn't
+		 * open or the data isn't directly accessible. The pointer is valid while the file is open.
+		 */
+		const u8* GetData() const;
+
 		/**
 		 * Get the requested file name.
 		 * The requested file name is the one specified in FileSystem::Open().
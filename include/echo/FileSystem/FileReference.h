@@ -31,6 +31,14 @@ namespace Echo
 		virtual size_t Seek(size_t position) = 0;
 		virtual bool EndOfFile() = 0;
 
+		/**
+		 * Get direct access to the file's data if the implementation keeps the whole file in memory.
+		 * The pointer is to the start of the file, not the current position, and remains valid while the reference
+		 * exists. Reading through the pointer does not modify the position.
+		 * @return A pointer to GetFileSize() bytes of data, or nullptr if the data is not directly accessible.
+		 */
+		virtual const u8* GetData() const {return nullptr;}
+
 		const size_t& GetPosition() const {return mPosition;}
 		const size_t& GetFileSize() const {return mFileSize;}
 		
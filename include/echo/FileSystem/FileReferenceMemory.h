@@ -23,6 +23,7 @@ namespace Echo
 		size_t Write(const void* buffer, size_t typeSize, size_t numberToWrite);
 		size_t Seek(size_t position);
 		bool EndOfFile();
+		const u8* GetData() const override {return reinterpret_cast<const u8*>(mConstData);}
 	private:
 		friend class FileSystemSourceMemory;
 		const void* mConstData;
@@ -2,6 +2,7 @@
 #define _ECHOFILEREFERENCEVFS_H_
 #include <echo/FileSystem/FileReference.h>
 #include <echo/FileSystem/FileSystemSourceVFS.h>
+#include <vector>
 
 namespace Echo
 {
@@ -10,7 +11,9 @@ namespace Echo
 	public:	
 		FileReferenceVFS(FileSystemSourceVFS* source, FileSystemSourceVFS::VFSEntry vfsEntry) : 
 			FileReference(source),
-			mFileEntry(vfsEntry)
+			mFileEntry(vfsEntry),
+			mCachedBlock(0),
+			mBlockCached(false)
 		{
 			mFileSize = mFileEntry.mDataSize;
 		}
@@ -20,9 +23,24 @@ namespace Echo
 		size_t Write(const void* buffer, size_t typeSize, size_t numberToWrite);
 		size_t Seek(size_t position);
 		bool EndOfFile();
+
+		/**
+		 * Get the file's data within the archive.
+		 * @return The data if the archive is memory mapped or a memory file and the entry isn't compressed,
+		 * otherwise nullptr.
+		 */
+		const u8* GetData() const override;
 	private:
 		friend class FileSystemSourceVFS;
+		size_t ReadCompressed(u8* buffer, size_t bytesToRead);
+		bool CacheBlock(u32 block);
+
 		FileSystemSourceVFS::VFSEntry mFileEntry;
+		// Compressed entries are decompressed a block at a time into a buffer per reference.
+		std::vector<u8> mBlock;
+		std::vector<u8> mStoredBlock;		/// Compressed data read from the archive when it isn't in memory.
+		u32 mCachedBlock;
+		bool mBlockCached;
 	};
 }
 #endif
@@ -2,6 +2,7 @@
 #define _ECHOFILESYSTEM_H_
 #include <echo/Types.h>
 #include <echo/FileSystem/File.h>
+#include <echo/Kernel/Mutex.h>
 
 #include <map>
 #include <list>
@@ -219,6 +220,7 @@ namespace Echo
 	private:
 		std::map< std::string, shared_ptr<FileSystemSource> > mSources;
 		std::list< FileReference* > mOpenFiles;
+		Mutex mOpenFilesMutex;					/// Files can be opened and closed from multiple threads.
 		shared_ptr<FileSystemSource> mDefaultSource;
 	private:
 		friend class FileSystemSource;
@@ -4,12 +4,15 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 #include <echo/FileSystem/File.h>
 #include <echo/FileSystem/FileSystemSource.h>
+#include <echo/Kernel/Mutex.h>
 
 namespace Echo
 {
 	class FileSystemEntry;
+	class WorkerPool;
 
 	class FileSystemSourceVFS : public FileSystemSource
 	{
@@ -26,39 +29,150 @@ namespace Echo
 		};
 		typedef VFSEntryNameModes::_ VFSEntryNameMode;
 
+		/**
+		 * Compression of entries in the indexed format.
+		 * LZ4 decompresses fastest while ZSTD produces smaller archives. Support for each is optional at build time
+		 * with ECHO_LZ4_SUPPORT_ENABLED and ECHO_ZSTD_SUPPORT_ENABLED.
+		 * DEFAULT is used when adding files to use the compression specified when saving.
+		 */
+		struct VFSCompressions
+		{
+			enum _{NONE=0,LZ4=1,ZSTD=2,DEFAULT=0xFF};
+		};
+		typedef VFSCompressions::_ VFSCompression;
+
 		struct VFSEntry
 		{
-			VFSEntry() : mMainOffset(0), mDataSize(0){}
+			VFSEntry() : mMainOffset(0), mDataSize(0), mCompression(VFSCompressions::NONE), mFirstBlock(0), mNumberOfBlocks(0){}
 			size_t mMainOffset;		//Main offset from start of VFS file
-			size_t mDataSize;
+			size_t mDataSize;		//Uncompressed size
+			VFSCompression mCompression;
+			u32 mFirstBlock;		//Index of the entry's first block in the block table when compressed
+			u32 mNumberOfBlocks;
 		};
 		const u32 EVFS_VERSION;
 		const u32 EVFS_VERSION_SWITCH;
+		const u32 EVFS_INDEXED_VERSION;
+		const u32 EVFS_INDEXED_VERSION_SWITCH;
+
+		/**
+		 * Compressed entries in the indexed format are compressed in blocks of this size so any part of an entry
+		 * can be read by decompressing one block.
+		 */
+		static const u32 INDEXED_BLOCK_SIZE = 65536;
+
+		/**
+		 * Uncompressed entries in the indexed format start at a multiple of this many bytes so their data can be
+		 * used in place from a mapped archive.
+		 */
+		static const u32 INDEXED_ALIGNMENT = 16;
+
+		/**
+		 * Check whether a compression method was enabled in this build.
+		 */
+		static bool GetCompressionSupported(VFSCompression compression);
 	private:
 		struct VFSOutEntry
 		{
-			VFSOutEntry() : mMainOffset(0), mDataSize(0){}
+			VFSOutEntry() : mMainOffset(0), mDataSize(0), mCompression(VFSCompressions::DEFAULT){}
 			std::string mTargetFileName;
 			std::string mFileIncSource;
 			size_t mMainOffset;		//Main offset from start of data
 			size_t mDataSize;
+			VFSCompression mCompression;
+		};
+
+		// The indexed format is a header followed by the entry table, the names, the block table and then the data.
+		// The tables are fixed size records that are used in place when the archive is in memory. Entries are
+		// sorted by name hash so they can be found with a binary search. All values are in the endianness of the
+		// header version.
+		struct IndexedHeader
+		{
+			u32 mVersion;
+			u32 mNumberOfEntries;
+			u32 mNumberOfBlocks;
+			u32 mBlockSize;
+			u64 mEntriesOffset;
+			u64 mNamesOffset;
+			u64 mNamesSize;
+			u64 mBlocksOffset;
+		};
+		struct IndexedEntry
+		{
+			u64 mNameHash;
+			u64 mDataOffset;		//Offset of uncompressed data from the start of the file
+			u64 mDataSize;			//Uncompressed size
+			u32 mNameOffset;		//Offset within the names
+			u32 mNameLength;
+			u32 mFirstBlock;
+			u32 mNumberOfBlocks;
+			u32 mCompression;
+			u32 mReserved;
 		};
+		struct IndexedBlock
+		{
+			u64 mOffset;			//Offset from the start of the file
+			u32 mStoredSize;
+			u32 mCompression;		//Blocks that don't compress are stored with NONE
+		};
+		static u64 HashName(const char* name, size_t length);
+		static void SwapEndian(IndexedHeader& header);
+		static void SwapEndian(IndexedEntry& entry);
+		static void SwapEndian(IndexedBlock& block);
+		bool LoadIndexedVFS(bool swapEndian);
+		const IndexedEntry* FindIndexedEntry(const std::string& fileName) const;
+		const IndexedBlock& GetIndexedBlock(u32 index) const {return mIndexedBlocks[index];}
+		static bool Decompress(VFSCompression compression, const u8* source, size_t sourceSize, u8* destination, size_t destinationSize);
+
 		std::map< std::string, VFSEntry > mDirectory;
 		std::map< std::string, std::string > mOutDirectory;
-		//Mutex mFileMutex;
+		std::map< std::string, VFSCompression > mOutCompression;
+		IndexedHeader mIndexedHeader;
+		const IndexedEntry* mIndexedEntries;	/// Point into mData when the archive is in memory, otherwise into mIndex.
+		const IndexedBlock* mIndexedBlocks;
+		const char* mIndexedNames;
+		std::vector<u64> mIndex;				/// The index tables when they can't be used in place.
+		Mutex mFileMutex;				/// Serialises seek and read pairs on mVFSFile when the archive isn't in memory.
 		friend class FileReferenceVFS;
 		File mVFSFile;
 		u32 mVFSVersion;
 		FileSystem& mVFSLoaderFileSystem;
+		const u8* mData;				/// The whole archive when it is memory mapped or a memory file, otherwise nullptr.
+		void* mMapping;					/// The memory mapping owned by this source.
+		size_t mMappingSize;
+
+		bool MapVFS();
+		void UnmapVFS();
 	public:
 		FileSystemSourceVFS(FileSystem& vfsLoaderFileSystem);
 		virtual ~FileSystemSourceVFS();
 
 		//////////////////////////////////////////////////////////////////////////
 		//VFS Source functionality
-		bool LoadVFS(const std::string& vfsFile);
+		/**
+		 * Load a VFS archive.
+		 * Files opened from the archive read directly from memory when the archive has been memory mapped or is
+		 * itself a memory file. In this case reads don't lock, so many threads can read files from the archive
+		 * concurrently, and File::GetData() provides access to the file data without copying. Otherwise reads
+		 * seek and read the archive file under a lock.
+		 * @param vfsFile The archive file name, opened using the loader FileSystem.
+		 * @param memoryMap Whether to attempt to memory map the archive. If mapping isn't supported on the platform
+		 * or fails the archive is read through the file instead.
+		 * @return true if the archive was loaded.
+		 */
+		bool LoadVFS(const std::string& vfsFile, bool memoryMap = true);
 		void UnloadVFS();
 
+		/**
+		 * Get whether the loaded archive data is accessed directly from memory.
+		 */
+		bool GetInMemory() const {return mData!=nullptr;}
+
+		/**
+		 * Get whether the loaded archive is in the indexed format.
+		 */
+		bool GetIndexed() const {return mIndexedEntries!=nullptr;}
+
 		/**
 		 * Add a file to the VFS out directory list for saving.
 		 * @note This method does not make the file available in the source.
@@ -75,9 +189,10 @@ namespace Echo
 		 * @param targetName The name of the file that will be referenced when loading it from the VFS after it has been saved.
 		 * @param fileName The filename. The file is later resolved when calling SaveVFS() and is resolved via the FileSystem object
 		 * this VFS source is installed into.
+		 * @param compression The compression to use for the file when saving in the indexed format.
 		 * @return true if the entry was added.
 		 */
-		bool AddFile(std::string targetName, const std::string& source);
+		bool AddFile(std::string targetName, const std::string& source, VFSCompression compression = VFSCompressions::DEFAULT);
 
 		/**
 		 * Clears the current list of files that will be written when calling SaveVFS()
@@ -94,7 +209,33 @@ namespace Echo
 		 */
 		bool SaveVFS(const std::string& fileName, VFSEndianMode endianMode, VFSEntryNameMode entryNameMode = VFSEntryNameModes::FULL);
 
+		/**
+		 * Save the files in the out directory in the indexed format.
+		 * The indexed format can be opened without building a directory, stores files compressed in blocks so
+		 * they can still be read from any position, and aligns uncompressed files so their data can be used in
+		 * place when the archive is memory mapped.
+		 * Compressed files and blocks that don't become smaller are stored uncompressed.
+		 * @param fileName The archive file name.
+		 * @param endianMode The endianness of the archive tables.
+		 * @param entryNameMode Which names to create entries for.
+		 * @param compression The compression used for files that were added with VFSCompressions::DEFAULT.
+		 * @param workerPool If provided blocks are compressed in parallel on the pool.
+		 * @return true if the archive was written, false if it couldn't be written or a compression method isn't
+		 * supported. Files that can't be read are logged and skipped as with SaveVFS().
+		 */
+		bool SaveIndexedVFS(const std::string& fileName, VFSEndianMode endianMode, VFSEntryNameMode entryNameMode = VFSEntryNameModes::FULL,
+							VFSCompression compression = VFSCompressions::NONE, shared_ptr<WorkerPool> workerPool = nullptr);
+
+		/**
+		 * Get the directory of an archive in the original format.
+		 * @note The directory is empty for indexed archives, use GetFileNames() to list the files in either format.
+		 */
 		const std::map< std::string, VFSEntry >& GetDirectory() const {return mDirectory;}
+
+		/**
+		 * Get the names of all of the files in the loaded archive.
+		 */
+		std::vector<std::string> GetFileNames() const;
 		const std::string& GetVFSFileName() const {return mVFSFile.GetActualFileName();}
 		u32 GetVFSVersion() const {return mVFSVersion;}
 		Size GetVFSSize() {return mVFSFile.GetSize(); }
@@ -1208,7 +1208,8 @@ namespace Echo
 			FunctionContainer mPressedFunctions;
 			FunctionContainer mHoldFunctions;
 			FunctionContainer mReleasedFunctions;
-			typedef std::map< std::string, std::list<std::string> > ConditionalFunctionMap;
+			struct ConditionalFunctions;
+			typedef std::map< std::string, shared_ptr<ConditionalFunctions> > ConditionalFunctionMap;
 			ConditionalFunctionMap mConditionalFunctions;
 			shared_ptr<FunctionBinder> mFunctionBinder;
 			bool mTargetable;				/// Most elements can be targeted by the cursor, this is true by default. Set
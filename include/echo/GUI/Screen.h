@@ -26,6 +26,12 @@ namespace Echo
 			 * @param updateSizeToCamera true to cause the update.
 			 */
 			void SetUpdateSizeToCamera(bool updateSizeToCamera) {mUpdateSizeToCamera=updateSizeToCamera;}
+
+			/**
+			 * Override from SceneRenderable.
+			 * @return true if the screen updates its size to fit the camera's view.
+			 */
+			virtual bool GetBoundsDependOnCamera() const override {return mUpdateSizeToCamera;}
 			
 		private:
 			virtual shared_ptr<Element> _Clone() const override;
@@ -371,7 +371,7 @@ namespace Echo
 		}
 
 		/** Returns the custom culling frustum in use. */
-		Frustum* SetCullingFrustum(void) const
+		Frustum* GetCullingFrustum(void) const
 		{
 			return mCullFrustum;
 		}
@@ -391,6 +391,9 @@ namespace Echo
 		/// @copydoc Frustum::IsVisible
 		bool IsVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const override;
 
+		/// @copydoc Frustum::IsVisible
+		Size IsVisible(const PackedAxisAlignedBoxes& boxes, std::vector<u32>& visibilityOut, std::vector<u8>* culledBy = 0) const override;
+
 		/// @copydoc Frustum::GetWorldSpaceCorners
 		const WorldSpaceCorners& GetWorldSpaceCorners(void) const override;
 
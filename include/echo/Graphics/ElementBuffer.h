@@ -116,6 +116,7 @@ namespace Echo
 		ElementBuffer& operator=(const ElementBuffer& rhs);
 		ElementBuffer& operator=(ElementBuffer&& rhs);
 		
+		Type GetType() const {return mType;}
 		IndexType GetIndexType() const;
 		ElementType GetElementType() const;
 
@@ -305,6 +306,15 @@ namespace Echo
 		{
 			return mData;
 		}
+
+		/**
+		 * Get the pointer to the data for writing.
+		 * @return A pointer to the start of the allocated buffer, GetBufferSize() bytes can be written.
+		 */
+		char* GetDataPointer()
+		{
+			return mData;
+		}
 		
 		/**
 		 * Get the byte stride between elements.
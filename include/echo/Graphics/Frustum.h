@@ -2,6 +2,7 @@
 #define _ECHOFRUSTUM_H_
 
 #include <echo/Maths/AxisAlignedBox.h>
+#include <echo/Maths/PackedAxisAlignedBoxes.h>
 #include <echo/Maths/Vector2.h>
 #include <string>
 
@@ -424,6 +425,28 @@ namespace Echo
 		*/
 		virtual bool IsVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
 
+		/** Tests which of a packed array of boxes are visible in the Frustum.
+			@remarks
+				The planes are updated once and the boxes are tested several at a time using SIMD
+				instructions when the build enables them (see ECHO_SIMD_MATHS). The results are the same
+				as calling IsVisible() for each box.
+			@param
+				boxes The boxes to check (world space).
+			@param
+				visibilityOut Resized to one bit per box, rounded up to whole u32s. Bit (i % 32) of
+				element (i / 32) is set if box i is visible.
+			@param
+				culledBy Optional plane coherency cache. The planes that culled boxes are stored here
+				and tested first next time, since boxes that were culled by a plane are likely to be
+				culled by it again. Reuse the same vector for the same boxes and frustum each frame. It
+				is resized to match boxes if needed. The SIMD implementation stores one plane for each
+				group of boxes that are tested together so the entries don't always match culledBy for
+				IsVisible().
+			@returns
+				The number of visible boxes.
+		*/
+		virtual Size IsVisible(const PackedAxisAlignedBoxes& boxes, std::vector<u32>& visibilityOut, std::vector<u8>* culledBy = 0) const;
+
 		/** Gets the world space corners of the frustum.
 		@remarks
 			The corners are ordered as follows:
@@ -15,6 +15,12 @@ namespace Echo
 		virtual ~MultipassRenderable();
 		
 		virtual void Render(RenderContext& renderContext, const RenderPass& pass, Colour compoundDiffuse) = 0;
+
+		/**
+		 * Get an object that identifies the geometry this renderable draws.
+		 * RenderBucket uses this to group draws that use the same geometry. The default is this object.
+		 */
+		virtual const void* GetGeometryIdentifier() const {return this;}
 	};
 }
 #endif 
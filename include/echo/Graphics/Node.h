@@ -11,6 +11,15 @@
 
 namespace Echo
 {
+	class TransformHierarchy;
+
+	/**
+	 * A Node is a transform in a hierarchy.
+	 * By default a Node calculates its derived properties on demand from its parent. A Node tree can be added
+	 * to a TransformHierarchy which stores the transforms in flat arrays and updates them in batches, in which
+	 * case the Node acts as a handle to its entry in the hierarchy.
+	 * @see TransformHierarchy.
+	 */
 	class Node : public NodeInterface
 	{
 	public:
@@ -88,6 +97,8 @@ namespace Echo
 		/**
 		 * Get the transform of this node.
 		 * The transform returned reflects the derived position, scale and orientation.
+		 * If the node is in a TransformHierarchy the reference is invalidated when the hierarchy's structure
+		 * changes.
 		 * @return transform matrix for the node.
 		 */
 		const Matrix4& GetTransform() const;
@@ -193,7 +204,14 @@ namespace Echo
 
 		//Reset the node to the initial position
 		void Reset();
+
+		/**
+		 * Get the TransformHierarchy this node is in.
+		 * @return The hierarchy or nullptr if the node is not in one.
+		 */
+		TransformHierarchy* GetTransformHierarchy() const {return mTransformHierarchy;}
 	protected:
+		friend class TransformHierarchy;
 		std::set< Node* > mChildNodes;
 		mutable std::set< const Node* > mChildrenToUpdate;
 		std::set< shared_ptr<Node> > mSharedChildren;
@@ -223,6 +241,8 @@ namespace Echo
 		mutable Mutex mTransformMutex;
 		mutable Mutex mLocalTransformMutex;
 		std::string mName;
+		TransformHierarchy* mTransformHierarchy;
+		Size mTransformHierarchyIndex;
 		
 		void ApplyDefaults(const Vector3& position, const Quaternion& orientation, const Vector3& scale);
 
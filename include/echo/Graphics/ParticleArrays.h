@@ -0,0 +1,157 @@
+#ifndef _ECHOPARTICLEARRAYS_H_
+#define _ECHOPARTICLEARRAYS_H_
+
+#include <echo/Graphics/ParticleSystems.h>
+#include <vector>
+
+namespace Echo
+{
+	class WorkerPool;
+
+	/**
+	 * StandardParticleArrays stores StandardParticles as a structure of arrays.
+	 *
+	 * Each particle property component is kept in its own contiguous array so the processing and building
+	 * loops only touch the data they need and can be vectorised by the compiler. A StandardParticle is around
+	 * 240 bytes where the arrays use 184 bytes per particle. The current colour isn't stored, it is calculated
+	 * when building the visual.
+	 *
+	 * The class provides the subset of the std::vector interface that ParticleSystem uses so it can be used as
+	 * the ParticleSystem container with StandardParticleArrayProcessor and StandardParticleArrayQuadBuilder.
+	 */
+	class StandardParticleArrays
+	{
+	public:
+		struct Streams
+		{
+			enum _
+			{
+				POSITION_X, POSITION_Y, POSITION_Z,
+				VELOCITY_X, VELOCITY_Y, VELOCITY_Z,
+				ACCELERATION_X, ACCELERATION_Y, ACCELERATION_Z,
+				LINEAR_DAMPING_X, LINEAR_DAMPING_Y, LINEAR_DAMPING_Z,
+				SCALE_X, SCALE_Y, SCALE_Z,
+				SCALE_VELOCITY_X, SCALE_VELOCITY_Y, SCALE_VELOCITY_Z,
+				SCALE_ACCELERATION_X, SCALE_ACCELERATION_Y, SCALE_ACCELERATION_Z,
+				SCALE_DAMPING_X, SCALE_DAMPING_Y, SCALE_DAMPING_Z,
+				ANGLE_X, ANGLE_Y, ANGLE_Z,
+				ANGULAR_VELOCITY_X, ANGULAR_VELOCITY_Y, ANGULAR_VELOCITY_Z,
+				ANGULAR_ACCELERATION_X, ANGULAR_ACCELERATION_Y, ANGULAR_ACCELERATION_Z,
+				ANGULAR_DAMPING_X, ANGULAR_DAMPING_Y, ANGULAR_DAMPING_Z,
+				INITIAL_COLOUR_R, INITIAL_COLOUR_G, INITIAL_COLOUR_B, INITIAL_COLOUR_A,
+				FINAL_COLOUR_R, FINAL_COLOUR_G, FINAL_COLOUR_B, FINAL_COLOUR_A,
+				TIME_LEFT,
+				INVERSE_INITIAL_TIME,
+				NUMBER_OF_STREAMS
+			};
+		};
+		typedef Streams::_ Stream;
+
+		StandardParticleArrays();
+		~StandardParticleArrays();
+
+		Size size() const {return mSize;}
+		bool empty() const {return mSize==0;}
+		Size capacity() const {return mStreams[0].capacity();}
+		void reserve(Size numberOfParticles);
+		void push_back(const StandardParticle& particle);
+		void clear() {mSize = 0;}
+
+		/**
+		 * Get a particle as a StandardParticle.
+		 * The colour is calculated from the initial and final colours.
+		 */
+		StandardParticle Get(Size index) const;
+
+		/**
+		 * Get the array for a stream.
+		 * The array is valid until particles are added.
+		 */
+		f32* GetStream(Stream stream) {return mStreams[stream].data();}
+		const f32* GetStream(Stream stream) const {return mStreams[stream].data();}
+
+		/**
+		 * Integrate a range of particles.
+		 * This applies the same calculations as SimpleStandardParticleProcessor except that expired particles are
+		 * not removed. Ranges that do not overlap can be integrated concurrently.
+		 * @param begin The first particle index.
+		 * @param end One past the last particle index.
+		 * @param lastFrameTime The time to integrate over.
+		 */
+		void Integrate(Size begin, Size end, Seconds lastFrameTime);
+
+		/**
+		 * Remove particles that have no time left.
+		 * As with SimpleStandardParticleProcessor the last particle is moved into the position of the removed one
+		 * so the order of particles is not maintained.
+		 */
+		void RemoveExpired();
+	private:
+		std::vector<f32> mStreams[Streams::NUMBER_OF_STREAMS];
+		Size mSize;
+	};
+
+	/**
+	 * A particle processor for StandardParticleArrays.
+	 * The processing is equivalent to SimpleStandardParticleProcessor.
+	 * If a WorkerPool is provided integration is split across the workers for large numbers of particles.
+	 */
+	class StandardParticleArrayProcessor
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param workerPool Optional pool used to process particles in parallel.
+		 * @param particlesPerJob The number of particles processed by each job.
+		 */
+		StandardParticleArrayProcessor(shared_ptr<WorkerPool> workerPool = shared_ptr<WorkerPool>(), Size particlesPerJob = 16384);
+		void ProcessParticles(StandardParticleArrays& particles, Seconds lastFrameTime);
+	private:
+		shared_ptr<WorkerPool> mWorkerPool;
+		Size mParticlesPerJob;
+	};
+
+	/**
+	 * Builds a quad for each particle in a StandardParticleArrays, the result is the same as
+	 * StandardParticleQuadMeshBuilder.
+	 * The corners are calculated in blocks of particles so the maths can be vectorised by the compiler and then
+	 * written to the vertex buffer using the buffer's VertexLayout. Indices are only written when the number of
+	 * particles increases past the number previously indexed.
+	 * If a WorkerPool is provided the quads are built in parallel for large numbers of particles.
+	 * @note The vertex buffer needs "Position", "Normal", "Colour" and "UV0" attributes as created by
+	 * Mesh::CreateCommonSubMesh().
+	 */
+	class StandardParticleArrayQuadBuilder
+	{
+	public:
+		StandardParticleArrayQuadBuilder(Vector2 particleSize, shared_ptr<WorkerPool> workerPool = shared_ptr<WorkerPool>(), Size particlesPerJob = 16384);
+		void BuildVisual(StandardParticleArrays& particles, SceneEntity& entity);
+	private:
+		struct VertexAccessors
+		{
+			VertexBuffer::Accessor<Vector3> mPositions;
+			VertexBuffer::Accessor<Vector3> mNormals;
+			VertexBuffer::Accessor<VertexColour> mColours;
+			VertexBuffer::Accessor<TextureUV> mTextureCoordinates;
+		};
+
+		/**
+		 * Write the vertices for a range of particles.
+		 */
+		void BuildQuads(const StandardParticleArrays& particles, Size begin, Size end, VertexAccessors& vertices) const;
+
+		Vector2 mParticleHalfSize;
+		shared_ptr<WorkerPool> mWorkerPool;
+		Size mParticlesPerJob;
+		const char* mIndexedData;
+		Size mNumberOfIndexedParticles;
+	};
+
+	/**
+	 * A ParticleSystem for StandardParticles that uses structure of arrays storage and processing.
+	 * It can be used with the emitters in place of SimpleStandardParticleSystem. Create with:
+	 *	make_shared<ArrayStandardParticleSystem>(StandardParticleArrayProcessor(workerPool),StandardParticleArrayQuadBuilder(Vector2(quadWidth,quadHeight),workerPool))
+	 */
+	typedef ParticleSystem<StandardParticle, StandardParticleArrayProcessor, StandardParticleArrayQuadBuilder, StandardParticleArrays> ArrayStandardParticleSystem;
+}
+#endif
@@ -9,6 +9,7 @@
 #include <echo/Graphics/Mesh.h>
 #include <echo/Graphics/SceneEntity.h>
 #include <echo/Graphics/ElementBuffer.h>
+#include <algorithm>
 
 namespace Echo
 {
@@ -291,8 +292,11 @@ namespace Echo
 	 * a renderable.
 	 * ParticleRenderer - must be able to be copied and have a method:
 	 *		BuildVisual(std::vector<StandardParticle>& particles, SceneEntity& entity)
+	 * ParticleContainer - the container particles are stored in, std::vector<ParticleType> by default. The
+	 * processor and renderer receive the container instead of a std::vector if one is specified. The container
+	 * needs reserve(), capacity(), size(), push_back() and clear() methods, see StandardParticleArrays.
 	 */
-	template<class ParticleType, class ParticleProcessor, class ParticleRenderer>
+	template<class ParticleType, class ParticleProcessor, class ParticleRenderer, class ParticleContainer = std::vector<ParticleType> >
 	class ParticleSystem : public SceneEntity, public TaskGroup, public ParticleEmitterInterface<ParticleType>
 	{
 	public:
@@ -323,7 +327,16 @@ namespace Echo
 
 		void Emit(std::vector<ParticleType> particleBatch) override
 		{
-			mParticles.insert(mParticles.end(), particleBatch.begin(), particleBatch.end());
+			// Grow geometrically so emitting a batch every frame doesn't reallocate every time.
+			const size_t required = mParticles.size() + particleBatch.size();
+			if(mParticles.capacity() < required)
+			{
+				mParticles.reserve(std::max(mParticles.capacity() * 2, required));
+			}
+			BOOST_FOREACH(const ParticleType& particle, particleBatch)
+			{
+				mParticles.push_back(particle);
+			}
 		}
 
 		void Update(Seconds lastFrameTime) override
@@ -335,10 +348,10 @@ namespace Echo
 		
 		void Clear()
 		{
-			mParticles.resize(0);
+			mParticles.clear();
 		}
 	private:
-		std::vector< ParticleType > mParticles;
+		ParticleContainer mParticles;
 		ParticleRenderer mRenderer;
 		ParticleProcessor mParticleProcessor;
 	};
@@ -0,0 +1,119 @@
+#ifndef _ECHORENDERBUCKET_H_
+#define _ECHORENDERBUCKET_H_
+
+#include <echo/Types.h>
+#include <echo/Graphics/Colour.h>
+#include <echo/Maths/Matrix4.h>
+#include <unordered_map>
+#include <vector>
+
+namespace Echo
+{
+	class Light;
+	class MultipassRenderable;
+	class RenderContext;
+	class RenderPass;
+
+	/**
+	 * A RenderBucket collects draw commands so they can be submitted to a RenderTarget in an order that
+	 * minimises state changes.
+	 *
+	 * When a RenderContext has a bucket Material::ApplyAndRender() submits a command for each pass instead
+	 * of applying the pass and rendering immediately. Each command has a 64 bit key built from:
+	 *	- The layer, opaque passes are drawn before transparent passes.
+	 *	- For opaque passes: the shader program, the pass, the first texture, the geometry then the depth from
+	 *	  front to back. Opaque draws are grouped by state.
+	 *	- For transparent passes: the depth from back to front followed by the program, pass and texture.
+	 *	  Transparent draws keep their back to front order. Passes blend with BlendModes::TRANSPARENT by default
+	 *	  so only passes explicitly set to BlendModes::NONE are treated as opaque.
+	 * Sort() radix sorts the keys and Execute() replays the commands between RenderTarget::BeginBatch() and
+	 * RenderTarget::EndBatch() so the target can skip redundant binds.
+	 *
+	 * @note Commands reference the passes and renderables that submitted them. The bucket needs to be executed
+	 * before any of them are modified or destroyed, this is usually within the same Scene::Render() call.
+	 */
+	class RenderBucket
+	{
+	public:
+		struct Command
+		{
+			RenderPass* mPass;
+			MultipassRenderable* mRenderable;
+			Matrix4 mWorld;
+			Matrix4 mWorldView;
+			Colour mCompoundDiffuse;
+			Size mLightList;
+		};
+
+		RenderBucket();
+		~RenderBucket();
+
+		/**
+		 * Remove all commands.
+		 * Memory is kept so the bucket can be reused each frame without allocating.
+		 */
+		void Clear();
+
+		/**
+		 * Submit a command to render a pass of a renderable.
+		 * @param pass The pass to apply.
+		 * @param renderable The renderable to render with the pass.
+		 * @param world The world matrix of the renderable.
+		 * @param worldView The world * view matrix of the renderable, the depth for sorting is taken from it.
+		 * @param compoundDiffuse The diffuse colour to apply.
+		 * @param lights The lights that affect the renderable, these are copied.
+		 */
+		void Submit(RenderPass& pass, MultipassRenderable& renderable, const Matrix4& world, const Matrix4& worldView, Colour compoundDiffuse, const std::vector< Light* >& lights);
+
+		/**
+		 * Sort the commands by key.
+		 * The sort is stable so commands with equal keys are executed in the order they were submitted.
+		 */
+		void Sort();
+
+		/**
+		 * Apply and render each command in sorted order.
+		 * @param renderContext The context the commands were submitted with. The view, projection and camera
+		 * are used for each command along with the lights of each command.
+		 */
+		void Execute(RenderContext& renderContext);
+
+		Size GetNumberOfCommands() const {return mCommands.size();}
+
+		/**
+		 * Get a command in sorted order.
+		 * @note Until Sort() is called commands are in submission order.
+		 */
+		const Command& GetCommand(Size index) const {return mCommands[mSortItems[index].mIndex];}
+
+		/**
+		 * Get the sort key of a command in sorted order.
+		 */
+		u64 GetKey(Size index) const {return mSortItems[index].mKey;}
+
+		/**
+		 * Get whether a key belongs to a transparent pass.
+		 */
+		static bool IsTransparentKey(u64 key) {return (key >> 63)!=0;}
+	private:
+		struct SortItem
+		{
+			u64 mKey;
+			u32 mIndex;
+		};
+
+		u32 GetID(std::unordered_map< const void*, u32 >& ids, const void* object);
+		u64 MakeKey(const RenderPass& pass, const MultipassRenderable& renderable, f32 depth);
+
+		std::vector< Command > mCommands;
+		std::vector< SortItem > mSortItems;
+		std::vector< SortItem > mSortScratch;
+		std::vector< std::vector< Light* > > mLightLists;	/// Pooled, only the first mNumberOfLightLists are in use.
+		Size mNumberOfLightLists;
+		std::unordered_map< const void*, u32 > mProgramIDs;
+		std::unordered_map< const void*, u32 > mPassIDs;
+		std::unordered_map< const void*, u32 > mTextureIDs;
+		std::unordered_map< const void*, u32 > mGeometryIDs;
+	};
+}
+#endif
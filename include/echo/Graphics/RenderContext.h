@@ -9,6 +9,7 @@ namespace Echo
 	class Matrix4;
 	class Camera;
 	class Light;
+	class RenderBucket;
 
 	/**
 	 * RenderContext is an object that holds references to objects pertaining to the current render settings.
@@ -29,6 +30,9 @@ namespace Echo
 	 * Platform implementation level. The "context" here corresponds to object rendering such as in a Scene.
 	 * 
 	 * @note Nothing should be referenced after the context is used (i.e. do not store references to objects).
+	 * 
+	 * @note When mRenderBucket is set Materials submit their passes to the bucket rather than rendering
+	 * immediately. The owner of the bucket is responsible for executing it, see RenderBucket.
 	 */
 	class RenderContext
 	{
@@ -39,13 +43,15 @@ namespace Echo
 			const Matrix4& projectionMatrix,
 			const Matrix4& viewProjectionMatrix,
 			const Camera& camera,
-			const std::vector< Light* >& lights) :
+			const std::vector< Light* >& lights,
+			RenderBucket* renderBucket = nullptr) :
 			mRenderTarget(renderTarget),
 			mViewMatrix(viewMatrix),
 			mProjectionMatrix(projectionMatrix),
 			mViewProjectionMatrix(viewProjectionMatrix),
 			mCamera(camera),
-			mLights(lights)
+			mLights(lights),
+			mRenderBucket(renderBucket)
 		{
 			
 		}
@@ -55,6 +61,7 @@ namespace Echo
 		const Matrix4& mViewProjectionMatrix;
 		const Camera& mCamera;
 		const std::vector< Light* >& mLights;
+		RenderBucket* mRenderBucket;
 	};
 }
 #endif
@@ -98,6 +98,9 @@ namespace Echo
 		std::vector< shared_ptr<Vector3> > mProgramLightColourCache;
 		std::vector< shared_ptr<f32> > mProgramLightPowerCache;
 		shared_ptr<int> mNumberOfLightsCached;
+		mutable std::vector< shared_ptr<Matrix4> > mProgramBoneMatrixCache;
+		mutable Size mProgramBoneMatrixCacheVersion;
+		mutable const ShaderProgram* mProgramBoneMatrixCacheProgram;
 		Size mProgramCacheVersion;
 
 		RenderPass();
@@ -335,6 +338,15 @@ namespace Echo
 		 */
 		Size CacheProgramVariables(Size numLights);
 
+		/**
+		 * Checks the program's "boneMatrices" uniform array cache.
+		 * The array elements are looked up once per program version.
+		 * @note This method should only be called if a program is set.
+		 * @param numberOfBones The number of bone matrices required.
+		 * @return The number of bone matrices the shader supports up to numberOfBones.
+		 */
+		Size CacheProgramBoneMatrices(Size numberOfBones) const;
+
 		void Apply(RenderContext& renderContext, const Matrix4& world, const Matrix4& worldView, Colour compoundDiffuse);
 	};
 }
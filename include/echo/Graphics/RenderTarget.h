@@ -49,7 +49,43 @@ namespace Echo
 			};
 		};
 		typedef size_t ClearMask;
+
+		/**
+		 * Counts of the work a render target has submitted to the underlying API.
+		 * Binds are only counted when they reach the API, redundant binds that are skipped are counted
+		 * separately. Not all render targets keep statistics, those that don't report zeros.
+		 */
+		struct Statistics
+		{
+			Statistics() :
+				mDrawCalls(0),
+				mProgramBinds(0),
+				mTextureBinds(0),
+				mVertexBufferBinds(0),
+				mRedundantBindsSkipped(0),
+				mUniformUploads(0)
+			{}
+			Size mDrawCalls;
+			Size mProgramBinds;
+			Size mTextureBinds;
+			Size mVertexBufferBinds;
+			Size mRedundantBindsSkipped;
+			Size mUniformUploads;		//!< Uniforms and uniform blocks uploaded, unchanged values are not uploaded.
+
+			Statistics operator-(const Statistics& rhs) const
+			{
+				Statistics difference;
+				difference.mDrawCalls = mDrawCalls - rhs.mDrawCalls;
+				difference.mProgramBinds = mProgramBinds - rhs.mProgramBinds;
+				difference.mTextureBinds = mTextureBinds - rhs.mTextureBinds;
+				difference.mVertexBufferBinds = mVertexBufferBinds - rhs.mVertexBufferBinds;
+				difference.mRedundantBindsSkipped = mRedundantBindsSkipped - rhs.mRedundantBindsSkipped;
+				difference.mUniformUploads = mUniformUploads - rhs.mUniformUploads;
+				return difference;
+			}
+		};
 	protected:
+		Statistics mStatistics;
 		Viewport* mCurrentViewport;
 		Camera* mCurrentCamera;
 		bool mIsPrimary;
@@ -251,8 +287,38 @@ namespace Echo
 		virtual bool ActivateProgram(shared_ptr<ShaderProgram> shaderProgram) = 0;
 		virtual void DeactivateProgram(shared_ptr<ShaderProgram> shaderProgram) = 0;
 		virtual bool BuildProgram(shared_ptr<ShaderProgram> shaderProgram) = 0;
+
+		/**
+		 * Begin a batch of draws.
+		 * Within a batch the target may defer resetting state between draws, such as deactivating programs,
+		 * unbinding vertex buffers and resetting texture units, so state that is set again by the next draw
+		 * doesn't need to be rebound. Deferred resets are performed before they would affect a draw and at
+		 * EndBatch(). RenderBucket uses batches when replaying sorted commands.
+		 * The default implementation does nothing.
+		 */
+		virtual void BeginBatch() {}
+
+		/**
+		 * End a batch of draws, performing any deferred state changes.
+		 */
+		virtual void EndBatch() {}
 		///////////////////////////////////////////////////
 
+		/**
+		 * Get the statistics accumulated since the render target was created or ResetStatistics() was called.
+		 * To get the statistics of a single frame take the difference between two calls or use
+		 * Renderer::GetFrameStatistics().
+		 */
+		const Statistics& GetStatistics() const
+		{
+			return mStatistics;
+		}
+
+		void ResetStatistics()
+		{
+			mStatistics = Statistics();
+		}
+
 		void SetDisplayXDPI(f32 displayXDPI)
 		{
 			mDisplayXDPI = displayXDPI;
@@ -113,6 +113,13 @@ namespace Echo
 		shared_ptr<RenderTarget> GetRenderTarget() const {return mRenderTarget;}
 		void SetViewport(shared_ptr<Viewport> viewport) {mViewport=viewport;}
 		void SetCamera(shared_ptr<Camera> camera) {mCamera=camera;}
+
+		/**
+		 * Get the render target statistics for the most recent Update().
+		 * This only includes the work performed for this Renderer, which is useful when several Renderers
+		 * share a render target.
+		 */
+		const RenderTarget::Statistics& GetFrameStatistics() const {return mFrameStatistics;}
 	private:
 		shared_ptr<RenderTarget> mRenderTarget;	//!< The render target to render to.
 		shared_ptr<Viewport> mViewport;			//!< The viewport to render through.
@@ -127,6 +134,7 @@ namespace Echo
 		Viewport::Rectangle mScissorBox;//!< The scissor box.
 		RenderTarget::ClearMask mClearMask;
 		f32 mClearDepth;				//!< Clear depth, valid range 0.0-1.0, see RenderTarget::SetClearDepth().
+		RenderTarget::Statistics mFrameStatistics;	//!< Statistics for the last Update().
 		typedef std::pair<const std::string, NotificationCallback> CallbackPair;
 		std::map<std::string, NotificationCallback> mBeginRenderCallbacks;
 		std::map<std::string, NotificationCallback> mEndRenderCallbacks;
@@ -5,21 +5,30 @@
 #include <echo/Graphics/Renderable.h>
 #include <echo/Graphics/SceneRenderable.h>
 #include <echo/Graphics/PickResult.h>
+#include <echo/Graphics/RenderBucket.h>
+#include <echo/Kernel/Mutex.h>
+#include <echo/Maths/BoundingVolumeHierarchy.h>
+#include <echo/Maths/PackedAxisAlignedBoxes.h>
+#include <echo/Maths/Plane.h>
 #include <echo/cpp/functional>
 #include <boost/foreach.hpp>
+#include <atomic>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace Echo
 {
 	class Camera;
+	class Frustum;
 	class Light;
 	class RenderTarget;
 	class Matrix4;
 	class Ray;
 	class PickResult;
+	class TextureResidencyManager;
 	
-	class Scene : public TaskGroup, public SceneRenderableVisitor
+	class Scene : public TaskGroup, public SceneRenderableVisitor, public SceneRenderable::Listener
 	{
 	public:
 		typedef std::pair< f32, SceneRenderable* > DistanceRenderablePair;
@@ -114,13 +123,94 @@ namespace Echo
 		 * Pick the closest object from the scene that are visible by the given camera and intersect with the ray.
 		 * @note The scene axis aligned bounding boxes are used for the intersect test.
 		 * @note This method may be expensive depending on the number of scene objects you have. You may need to consider
-		 * other alternatives to Pick() if you want to pick items frequently (multiple times a frame).
+		 * other alternatives to Pick() if you want to pick items frequently (multiple times a frame), such as enabling
+		 * the spatial index.
 		 * @param camera Camera that objects should be visible for.
 		 * @param ray The ray to test for intersections on.
 		 * @return A null pointer if no object intersects by the ray and is visible, otherwise the closest object to the camera.
 		 */
 		optional<PickResult> Pick(const Camera& camera, const Ray& ray);
 
+		/**
+		 * Find the renderables whose scene axis aligned boxes intersect a region.
+		 * @note Only renderables that have been added to the Scene are considered, their children are not tested
+		 * individually.
+		 * @param region The region in scene space.
+		 * @param renderablesOut Renderables that intersect the region are appended to this vector.
+		 */
+		void QueryRenderables(const AxisAlignedBox& region, std::vector< shared_ptr<SceneRenderable> >& renderablesOut);
+
+		/**
+		 * Enable or disable the spatial index.
+		 * When enabled the renderables added to the Scene are kept in a BoundingVolumeHierarchy using the bounds of
+		 * each renderable and its SceneRenderable descendants. BuildRenderQueue() then only visits renderables whose
+		 * bounds are in the camera's view and Pick() and QueryRenderables() only test nearby renderables.
+		 *
+		 * Renderables notify the Scene when they move so only renderables that have changed are updated before each
+		 * query. Renderables that return true from SceneRenderable::GetBoundsDependOnCamera(), or that do not have
+		 * finite bounds, are not indexed and are always visited.
+		 *
+		 * The spatial index is worthwhile when a scene has many renderables and only some of them are visible at a
+		 * time. The default is disabled.
+		 * @param enabled true to enable the spatial index.
+		 */
+		void SetSpatialIndexEnabled(bool enabled);
+		bool GetSpatialIndexEnabled() const {return mSpatialIndexEnabled;}
+
+		/**
+		 * Enable or disable render queue caching.
+		 * When enabled Render() keeps the render queue built for each culling frustum and reuses it until a
+		 * renderable changes, a renderable is added or removed, or the culling frustum changes. This means rendering
+		 * the same view several times, for example to multiple render targets or in multiple passes, only builds
+		 * the queue once.
+		 *
+		 * Cameras that share a culling frustum (see Camera::SetCullingFrustum()) share visibility results, such as
+		 * the eyes of a stereoscopic view. When a camera moves but its culling frustum doesn't, only the distances
+		 * are recalculated and the queue is re-sorted, which is cheap since the order is mostly unchanged.
+		 *
+		 * When the culling frustum moves but nothing in the scene has changed, the bounds of the renderables are
+		 * gathered once and then culled in one batch for each move, and only the visible renderables are visited.
+		 * This avoids walking each renderable's hierarchy for bounds every frame. The spatial index is used instead
+		 * when it is enabled since it only updates renderables that have changed.
+		 * @note Accept() is only called on renderables when the queue is built. If any renderables modify themselves
+		 * for each camera in Accept() (see SceneRenderable::GetBoundsDependOnCamera()) the queue is rebuilt whenever
+		 * the camera position or orientation changes.
+		 * @param enabled true to enable caching, the default is disabled.
+		 */
+		void SetRenderQueueCachingEnabled(bool enabled);
+		bool GetRenderQueueCachingEnabled() const {return mRenderQueueCachingEnabled;}
+
+		/**
+		 * Set the size of the cells used to assign lights to renderables.
+		 * Renderables receive lights sorted by distance. When the size is greater than 0 the lights are sorted once
+		 * for each cell of a grid rather than for each renderable, and the results are kept until a light is added,
+		 * removed or moved. Renderables in the same cell receive the same list, sorted by distance from the centre of
+		 * the cell. The size should be small relative to the distances between lights.
+		 * @param size The size of the cells, 0 (the default) sorts lights for each renderable.
+		 */
+		void SetLightClusterSize(f32 size);
+		f32 GetLightClusterSize() const {return mLightClusterSize;}
+
+		/**
+		 * Enable or disable state sorted rendering.
+		 * When enabled renderables submit their passes to a RenderBucket during Render() which is then sorted
+		 * and executed. Opaque passes are grouped by program, pass, texture and geometry to reduce state changes
+		 * and transparent passes are drawn afterwards from back to front. The sky box is always drawn first.
+		 * Use RenderTarget::GetStatistics() or Renderer::GetFrameStatistics() to measure the effect.
+		 * @note Renderables that draw without a Material are unaffected and draw before the bucket is executed.
+		 * @param enabled true to enable, the default is disabled.
+		 */
+		void SetRenderBucketEnabled(bool enabled) {mRenderBucketEnabled = enabled;}
+		bool GetRenderBucketEnabled() const {return mRenderBucketEnabled;}
+		/**
+		 * Set the TextureResidencyManager that is told which textures are used during Render().
+		 * The textures of each renderable that is rendered are reported along with the renderable's estimated size
+		 * on screen. The manager can be shared between Scenes. Updating the manager is left to the application.
+		 * @param textureResidencyManager The manager, or null to stop reporting.
+		 */
+		void SetTextureResidencyManager(shared_ptr<TextureResidencyManager> textureResidencyManager) {mTextureResidencyManager = textureResidencyManager;}
+		shared_ptr<TextureResidencyManager> GetTextureResidencyManager() const {return mTextureResidencyManager;}
+
 		/**
 		 * Build the render queue.
 		 */
@@ -139,6 +229,12 @@ namespace Echo
 		virtual const RenderTarget* GetCurrentRenderTarget() override;
 
 		void Render(RenderTarget& renderTarget, const Camera& camera);
+
+		/**
+		 * Override from SceneRenderable::Listener.
+		 * The Scene listens to its renderables while render queue caching is enabled.
+		 */
+		void OnSceneBoundsChanged(const SceneRenderable& renderable) override;
 		
 		void SetSkyBox(shared_ptr< SceneRenderable > skyBox);
 		
@@ -186,7 +282,78 @@ namespace Echo
 			return shared_ptr<T>();
 		}
 	protected:
+		class SpatialIndexEntry;
+		typedef BoundingVolumeHierarchy<SpatialIndexEntry*> SpatialIndex;
+
+		/**
+		 * Tracks a renderable in the spatial index.
+		 * The entry listens to the renderable so it can be queued for an update when the renderable moves.
+		 */
+		class SpatialIndexEntry : public SceneRenderable::Listener
+		{
+		public:
+			SpatialIndexEntry(Scene& scene, shared_ptr<SceneRenderable> renderable, bool pickable);
+			~SpatialIndexEntry();
+			void OnSceneBoundsChanged(const SceneRenderable& renderable) override;
+
+			Scene& mScene;
+			shared_ptr<SceneRenderable> mRenderable;
+			SpatialIndex::ProxyID mProxy;
+			bool mPickable;
+			std::atomic<bool> mDirty;
+		};
+
+		void AddToSpatialIndex(shared_ptr<SceneRenderable> sceneRenderable, bool pickable);
+		void RemoveFromSpatialIndex(SceneRenderable& sceneRenderable);
+		void QueueSpatialIndexUpdate(SpatialIndexEntry& entry);
+		void UpdateSpatialIndex();
+		void UpdateSpatialIndexEntry(SpatialIndexEntry& entry);
+
+		/**
+		 * Render queue for a culling frustum along with the state used to build it.
+		 */
+		struct CachedRenderQueue
+		{
+			CachedRenderQueue() : mSceneVersion(0), mCameraDependent(false), mBoundsValid(false), mValid(false){}
+			std::vector< DistanceRenderablePair > mRenderQueue;
+			std::vector< SceneRenderable* > mRenderables;	/// Renderables in the order of mBounds.
+			PackedAxisAlignedBoxes mBounds;					/// Hierarchy bounds, used when the spatial index is disabled.
+			std::vector< u32 > mVisibility;
+			std::vector< u8 > mPlaneCache;
+			Plane mCullPlanes[6];
+			Vector3 mCameraPosition;
+			Quaternion mCameraOrientation;
+			u64 mSceneVersion;
+			bool mCameraDependent;	/// Whether renderables that modify themselves for the camera in Accept() were involved.
+			bool mBoundsValid;		/// Whether mBounds were gathered since the scene last changed.
+			bool mValid;
+		};
+		std::vector< DistanceRenderablePair >& GetCachedRenderQueue(const Camera& camera);
+
+		/**
+		 * Gather the hierarchy bounds of the renderables for the cache.
+		 */
+		void GatherCullBounds(CachedRenderQueue& cache);
+
+		/**
+		 * Build the render queue from the bounds gathered with GatherCullBounds().
+		 * The renderables are culled in one batch and only the visible ones are visited.
+		 */
+		void BuildRenderQueue(const Camera& camera, CachedRenderQueue& cache);
+
 		std::vector< Light* > BuildLightList(const Node& node);
+		void BuildLightList(const Vector3& position, std::vector< Light* >& lightsOut);
+
+		/**
+		 * Get the lights for a node using the light clusters if enabled.
+		 * @note The returned reference is valid until the next call.
+		 */
+		const std::vector< Light* >& GetLightList(const Node& node);
+
+		/**
+		 * Clear the light clusters if any light was added, removed or moved since the last call.
+		 */
+		void UpdateLightClusters();
 
 		void ApplyLights(RenderTarget& renderTarget, const Camera& camera);
 		typedef std::pair< const std::string, shared_ptr< Light > > NamedLightPair;
@@ -202,6 +369,23 @@ namespace Echo
 		DistanceFunction mDistanceFunction;
 		const Camera* mCurrentCamera;				/// Camera set for operations over multiple methods.
 		const RenderTarget* mCurrentRenderTarget;	/// RenderTarget set for operations over multiple methods.
+		bool mVisitedCameraDependent;				/// Whether a renderable that depends on the camera was visited.
+		bool mSpatialIndexEnabled;
+		SpatialIndex mSpatialIndex;
+		std::unordered_map< SceneRenderable*, unique_ptr<SpatialIndexEntry> > mSpatialIndexEntries;
+		std::vector< SpatialIndexEntry* > mUnindexedEntries;	/// Entries that are always visited.
+		Mutex mSpatialIndexUpdatesMutex;
+		std::vector< SpatialIndexEntry* > mSpatialIndexUpdates;	/// Entries that have changed since the last update.
+		bool mRenderQueueCachingEnabled;
+		std::atomic<u64> mSceneVersion;								/// Incremented whenever a cached render queue could be invalidated.
+		std::map< const Frustum*, CachedRenderQueue > mRenderQueueCache;	/// Keyed by culling frustum.
+		f32 mLightClusterSize;
+		std::unordered_map< u64, std::vector< Light* > > mLightClusters;
+		std::vector< std::pair< Light*, Vector3 > > mLightClusterLights;	/// Lights and positions the clusters were built with.
+		std::vector< Light* > mLightList;								/// Used when lights are not clustered.
+		bool mRenderBucketEnabled;
+		RenderBucket mRenderBucket;
+		shared_ptr<TextureResidencyManager> mTextureResidencyManager;
 	};
 }
 #endif
@@ -4,6 +4,7 @@
 #include <echo/Graphics/Renderable.h>
 #include <echo/Graphics/Node.h>
 #include <echo/Maths/AxisAlignedBox.h>
+#include <list>
 
 namespace Echo
 {
@@ -49,6 +50,32 @@ namespace Echo
 	class SceneRenderable : public Renderable, public Node
 	{
 	public:
+		/**
+		 * SceneRenderable Listeners are notified when the scene bounds or visibility of the renderable, or of any
+		 * of its descendants, may have changed.
+		 * This allows objects such as spatial indices to track moving renderables without checking every
+		 * renderable each frame.
+		 * @note Notifications can occur on any thread that modifies the renderable.
+		 */
+		class Listener
+		{
+		public:
+			Listener(){}
+			virtual ~Listener(){}
+
+			/**
+			 * Called when the bounds of the renderable or one of its descendants may have changed.
+			 * Changes are one of the following:
+			 * - The transform of the renderable or an ancestor changed.
+			 * - The transform of a descendant changed.
+			 * - A SceneRenderable sub class has a reason to notify that the local bounds changed, such as its
+			 *   mesh changing.
+			 * - The visibility flag of the renderable or a descendant changed.
+			 * @param renderable The renderable the listener is registered with.
+			 */
+			virtual void OnSceneBoundsChanged(const SceneRenderable& renderable) = 0;
+		};
+
 		SceneRenderable(const Vector3& position = Vector3::ZERO,
 						const Quaternion& orientation = Quaternion::IDENTITY,
 						const Vector3& scale = Vector3::UNIT_SCALE);
@@ -61,6 +88,20 @@ namespace Echo
 		SceneRenderable& operator=(const SceneRenderable& rhs);
 		
 		AxisAlignedBox GetSceneAxisAlignedBox() const;
+
+		/**
+		 * Get the scene axis aligned box that contains this renderable and all of its SceneRenderable descendants.
+		 * @note This method needs to visit the whole hierarchy below this object so it is more expensive than
+		 * GetSceneAxisAlignedBox().
+		 */
+		AxisAlignedBox GetSceneHierarchyAxisAlignedBox() const;
+
+		/**
+		 * Get whether the bounds of this object are modified during Accept() based on the visitor's camera.
+		 * Objects that return true cannot be culled by their bounds before they are visited.
+		 * @note The default implementation returns false.
+		 */
+		virtual bool GetBoundsDependOnCamera() const {return false;}
 		
 		/**
 		 * Visitor pattern Accept method.
@@ -84,7 +125,14 @@ namespace Echo
 		 * Use GetVisible() to determine the final visibility.
 		 * @param visible true if the object should be visible, otherwise false for invisible.
 		 */
-		void SetVisibilityFlag(bool visible) {mVisible = visible;}
+		void SetVisibilityFlag(bool visible)
+		{
+			if(mVisible!=visible)
+			{
+				mVisible = visible;
+				NotifyBoundsChanged();
+			}
+		}
 		
 		/**
 		 * Get the SceneRenderable visibility flag.
@@ -108,11 +156,32 @@ namespace Echo
 		virtual AxisAlignedBox GetAxisAlignedBox(bool applyLocalTransform = true) const = 0;
 		
 		virtual void Render(RenderContext& renderContext, Colour compoundDiffuse) override = 0;
+
+		/**
+		 * Add a listener to be notified when the scene bounds may have changed.
+		 * @note Before destruction of the listener RemoveListener() should be called.
+		 * @param listener The listener, if null the call does nothing.
+		 */
+		void AddListener(Listener* listener);
+
+		/**
+		 * Remove a listener.
+		 * @param listener The listener to remove.
+		 */
+		void RemoveListener(Listener* listener);
 	private:
 		bool mVisible;		///Flag to indicate whether the object is visible or not.
 		SceneRenderable* mParentSceneRenderable;
+		std::list< Listener* > mListeners;
 	protected:
 		virtual void OnParentSet(Node* node) override;
+		virtual void NeedUpdate(bool forceParent = false) const override;
+
+		/**
+		 * Notify the listeners of this object and its ancestors that the scene bounds may have changed.
+		 * Derived classes should call this when their local bounds change.
+		 */
+		void NotifyBoundsChanged() const;
 	};
 }
 #endif 
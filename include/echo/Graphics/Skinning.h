@@ -0,0 +1,158 @@
+#ifndef _ECHOSKINNING_H_
+#define _ECHOSKINNING_H_
+
+#include <echo/Types.h>
+#include <echo/Maths/Matrix4.h>
+#include <echo/Graphics/VertexBuffer.h>
+#include <map>
+#include <vector>
+
+namespace Echo
+{
+	class BoneBinding;
+	class Mesh;
+	class SubMesh;
+	class WorkerPool;
+
+	/**
+	 * SkinWeights stores the bone influences of each vertex in fixed width arrays.
+	 *
+	 * Every vertex has the same number of influences, either 4 or 8 depending on the vertex with the most
+	 * influences. The influences of each vertex are sorted largest weight first and normalised so they sum to 1.
+	 * Unused influences have a weight of 0. If a vertex has more than MAXIMUM_INFLUENCES influences the smallest
+	 * are dropped.
+	 *
+	 * SkinWeights can also add the influences to a VertexBuffer as vertex attributes for skinning in a vertex
+	 * shader. The attributes are:
+	 * "BoneIndices"	- 4 x VertexAttribute::ComponentTypes::UNSIGNED16
+	 * "BoneWeights"	- 1 x VertexAttribute::ComponentTypes::VECTOR4
+	 * For 8 influences per vertex "BoneIndices1" and "BoneWeights1" hold the second four.
+	 */
+	class SkinWeights
+	{
+	public:
+		static const Size MAXIMUM_INFLUENCES = 8;
+
+		SkinWeights();
+		~SkinWeights();
+
+		/**
+		 * Build the weights from a BoneBinding per vertex.
+		 * A null binding results in a vertex with no influences. Vertices without influences are skinned to the
+		 * origin.
+		 */
+		void Build(const std::vector<BoneBinding*>& bindings);
+
+		/**
+		 * Build the weights from maps of bone index to weight.
+		 * @param influences Influences by vertex index, vertices not in the map have no influences.
+		 * @param numberOfVertices The number of vertices.
+		 */
+		void Build(const std::map< u32, std::map< Size, f32 > >& influences, Size numberOfVertices);
+
+		Size GetNumberOfVertices() const {return mNumberOfVertices;}
+
+		/**
+		 * Get the number of influences per vertex, 4 or 8.
+		 */
+		Size GetInfluencesPerVertex() const {return mInfluencesPerVertex;}
+
+		/**
+		 * Get the largest bone index referenced. A skinning palette needs at least this many entries plus one.
+		 */
+		Size GetMaximumBoneIndex() const {return mMaximumBoneIndex;}
+
+		/**
+		 * Get the bone indices, GetInfluencesPerVertex() per vertex.
+		 */
+		const u16* GetBoneIndices() const {return mBoneIndices.data();}
+
+		/**
+		 * Get the weights, GetInfluencesPerVertex() per vertex.
+		 */
+		const f32* GetWeights() const {return mWeights.data();}
+
+		/**
+		 * Add the bone index and weight attributes to a vertex buffer.
+		 * This should be called before the vertex buffer is allocated.
+		 */
+		void AddVertexAttributes(VertexBuffer& vertexBuffer) const;
+
+		/**
+		 * Copy the bone indices and weights into a vertex buffer's attributes.
+		 * @return false if the vertex buffer does not have the attributes or is too small.
+		 */
+		bool WriteVertexAttributes(VertexBuffer& vertexBuffer) const;
+	private:
+		template< class InfluenceFunction >
+		void Build(Size numberOfVertices, InfluenceFunction getInfluences);
+
+		Size mNumberOfVertices;
+		Size mInfluencesPerVertex;
+		Size mMaximumBoneIndex;
+		std::vector<u16> mBoneIndices;
+		std::vector<f32> mWeights;
+	};
+
+	/**
+	 * SkinningEngine performs linear blend skinning on the CPU for a group of meshes.
+	 *
+	 * Skinning is normally performed on demand when a skinned SubMesh is rendered. SkinningEngine can be used to
+	 * skin many meshes before rendering, for example a crowd of characters, by splitting the work across the
+	 * workers of a WorkerPool. Each skeleton's palette of bone matrices is built once, then the vertices of all
+	 * of the SubMeshes are processed in parallel. SubMeshes skinned this way are not skinned again when they are
+	 * rendered unless their skeleton's pose changes.
+	 *
+	 *		SkinningEngine skinningEngine(workerPool);
+	 *		...
+	 *		skinningEngine.Skin(characterMeshes);
+	 *		scene.Render(...);
+	 *
+	 * SubMeshes that will be skinned in a vertex shader are skipped, see SubMesh::Render().
+	 */
+	class SkinningEngine
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param workerPool Optional worker pool to skin meshes in parallel.
+		 * @param verticesPerJob The maximum number of vertices each job processes.
+		 */
+		SkinningEngine(shared_ptr<WorkerPool> workerPool = shared_ptr<WorkerPool>(), Size verticesPerJob = 4096);
+		~SkinningEngine();
+
+		/**
+		 * Skin the SubMeshes of each Mesh that uses a skeleton.
+		 */
+		void Skin(const std::vector< shared_ptr<Mesh> >& meshes);
+
+		/**
+		 * Skin a range of vertex positions.
+		 * For each vertex the palette matrices are blended by weight and the source position is transformed by the
+		 * blended matrix.
+		 * @param palette The bone offset transforms by bone index, must have at least weights.GetMaximumBoneIndex()+1
+		 * entries.
+		 * @param weights The vertex influences.
+		 * @param source The source positions.
+		 * @param destination Where to write the skinned positions.
+		 * @param begin The first vertex to skin.
+		 * @param end One past the last vertex to skin.
+		 */
+		static void SkinPositions(const Matrix4* palette, const SkinWeights& weights, const Vector3* source,
+								VertexBuffer::Accessor<Vector3>& destination, Size begin, Size end);
+	private:
+		struct Job
+		{
+			SubMesh* mSubMesh;
+			const std::vector<Matrix4>* mPalette;
+			Size mBegin;
+			Size mEnd;
+		};
+		shared_ptr<WorkerPool> mWorkerPool;
+		Size mVerticesPerJob;
+		std::vector<Job> mJobs;
+		std::vector<SubMesh*> mSubMeshes;
+		std::vector<Size> mPoseVersions;
+	};
+}
+#endif
@@ -41,6 +41,12 @@ namespace Echo
 		 * @param visitor
 		 */
 		virtual void Accept(SceneRenderableVisitor& visitor) override;
+
+		/**
+		 * Override from SceneRenderable.
+		 * @return true if the sprite is set to always face the camera.
+		 */
+		virtual bool GetBoundsDependOnCamera() const override {return mAlwaysFaceCamera;}
 		
 		/**
 		 * Set the animation for this sprite.
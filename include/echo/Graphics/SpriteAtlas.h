@@ -0,0 +1,113 @@
+#ifndef _ECHOSPRITEATLAS_H_
+#define _ECHOSPRITEATLAS_H_
+
+#include <echo/Graphics/Texture.h>
+#include <echo/Graphics/PrimitiveTypes.h>
+#include <map>
+#include <vector>
+
+namespace Echo
+{
+	class SpriteAnimation;
+
+	/**
+	 * SpriteAtlas packs the textures used by SpriteAnimation frames into a small number of page textures.
+	 *
+	 * Sprites that use different textures cannot be drawn together, packing the frames of many animations into
+	 * shared pages allows a SpriteBatch to draw them with one call per page. Build() is intended to be called at
+	 * load time once the animations have been set up:
+	 *
+	 *		SpriteAtlas atlas;
+	 *		atlas.AddAnimation(walk);
+	 *		atlas.AddAnimation(run);
+	 *		atlas.Build();
+	 *
+	 * Each distinct source texture is packed once, including the textures of sprite sheets where many frames
+	 * reference parts of the same texture. After building, each frame references its page and its texture
+	 * coordinates are remapped to the area of the page the source texture was copied to.
+	 *
+	 * Textures are placed on shelves in order of decreasing height. Each texture is surrounded by a border of
+	 * repeated edge pixels so filtering doesn't sample neighbouring textures.
+	 * @note Only source textures in memory in the atlas format that fit within a page are packed. Frames that
+	 * use other textures are left unchanged.
+	 */
+	class SpriteAtlas
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param pageWidth The width of each page in pixels.
+		 * @param pageHeight The maximum height of each page in pixels. Pages are trimmed to the smallest power
+		 * of two that fits the packed textures.
+		 * @param padding The number of border pixels around each texture.
+		 * @param format The format of the pages.
+		 */
+		SpriteAtlas(u32 pageWidth = 2048, u32 pageHeight = 2048, u32 padding = 1, Texture::Format format = Texture::Formats::R8G8B8A8);
+		~SpriteAtlas();
+
+		/**
+		 * Add an animation to be packed by Build().
+		 */
+		void AddAnimation(shared_ptr<SpriteAnimation> animation);
+
+		/**
+		 * Pack the textures of all added animations and update the frames.
+		 * Calling Build() again creates new pages for animations added since the last call.
+		 * @return The number of source textures that were packed.
+		 */
+		Size Build();
+
+		Size GetNumberOfPages() const {return mPages.size();}
+		shared_ptr<Texture> GetPage(Size index) const {return mPages[index];}
+
+		/**
+		 * Where a source texture was placed.
+		 */
+		struct Region
+		{
+			shared_ptr<Texture> mPage;
+			TextureUV mUV1;
+			TextureUV mUV2;
+		};
+
+		/**
+		 * Find where a source texture was placed.
+		 * @param source The source texture.
+		 * @param region Set to the region if the texture was packed.
+		 * @return true if the texture was packed.
+		 */
+		bool GetRegion(const Texture& source, Region& region) const;
+	private:
+		struct Placement
+		{
+			shared_ptr<Texture> mSource;
+			Size mPage;
+			u32 mX;		/// Position of the source texture within the page, excluding the padding.
+			u32 mY;
+		};
+		struct Shelf
+		{
+			u32 mY;
+			u32 mHeight;
+			u32 mWidthUsed;
+		};
+		struct PageLayout
+		{
+			std::vector<Shelf> mShelves;
+			u32 mHeightUsed;
+		};
+
+		void Place(std::vector<PageLayout>& layouts, u32 width, u32 height, Size& page, u32& x, u32& y) const;
+		void CopyTexture(const Texture& source, Texture& page, u32 x, u32 y) const;
+
+		u32 mPageWidth;
+		u32 mPageHeight;
+		u32 mPadding;
+		Texture::Format mFormat;
+		std::vector< shared_ptr<SpriteAnimation> > mAnimations;
+		std::vector< shared_ptr<Texture> > mPages;
+		std::map<const Texture*, Region> mRegions;
+		std::vector< shared_ptr<Texture> > mSources;	/// Held so the region keys remain unique.
+	};
+}
+#endif
@@ -0,0 +1,231 @@
+#ifndef _ECHOSPRITEBATCH_H_
+#define _ECHOSPRITEBATCH_H_
+
+#include <echo/Graphics/SceneEntity.h>
+#include <echo/Animation/SpriteAnimation.h>
+#include <echo/Kernel/Task.h>
+#include <echo/Maths/Vector2.h>
+#include <map>
+#include <vector>
+
+namespace Echo
+{
+	class WorkerPool;
+
+	/**
+	 * SpriteBatch renders many sprites as a single SceneEntity.
+	 *
+	 * Each Sprite is a SceneEntity and a Task with its own mesh so every sprite costs an update, a transform
+	 * and a draw call. A SpriteBatch stores sprites as plain data and each time it is rendered writes the quads
+	 * into one dynamic vertex buffer per material and texture combination, so the number of draw calls is the
+	 * number of distinct materials and textures rather than the number of sprites. Sprites that use frames from
+	 * the same SpriteAtlas page share a texture and are drawn together.
+	 *
+	 * The batch is a Task, Update() advances the animation of every sprite in one loop.
+	 *
+	 *		SpriteBatch batch;
+	 *		SpriteBatch::Instance sprite;
+	 *		sprite.mPosition = Vector3(1.f, 2.f, 0.f);
+	 *		Size id = batch.AddSprite(sprite);
+	 *		batch.SetAnimation(id, walkAnimation);
+	 *		batch.GetSprite(id).mColour = Colours::RED;
+	 *
+	 * Sprite positions are in the local space of the batch. When the batch faces the camera the quads are
+	 * oriented to the camera as Sprite::SetAlwaysFaceCamera() does, otherwise they lie in the batch's XY plane.
+	 * @note SpriteAnimation frame callbacks are not triggered for sprites in a batch since they require a Sprite.
+	 * Frame orientations are also not applied, a sprite's rotation is about the view direction only.
+	 * @note Per sprite colours are written as vertex colours so the material needs vertex colouring enabled for
+	 * them to have an effect. The default material has it enabled.
+	 */
+	class SpriteBatch : public SceneEntity, public Task
+	{
+	public:
+		/**
+		 * The properties of a sprite in the batch.
+		 */
+		struct Instance
+		{
+			Instance() :
+				mPosition(Vector3::ZERO),
+				mSize(1.f, 1.f),
+				mRotation(0.f),
+				mColour(Colours::WHITE),
+				mUV1(0.f, 0.f),
+				mUV2(1.f, 1.f),
+				mVisible(true),
+				mFlippedHorizontally(false),
+				mFlippedVertically(false),
+				mUseAnimationSize(true),
+				mAnimationMode(SpriteAnimation::Modes::NOT_SET),
+				mFrameIndex(0),
+				mFrameTime(0.),
+				mFrameOffset(Vector3::ZERO),
+				mFrameScale(Vector3::UNIT_SCALE)
+			{}
+			Vector3 mPosition;
+			Vector2 mSize;							/// Size in world units.
+			f32 mRotation;							/// Rotation about the view direction in radians.
+			Colour mColour;
+			TextureUV mUV1;
+			TextureUV mUV2;
+			shared_ptr<Material> mMaterial;			/// If null the batch material is used.
+			shared_ptr<Texture> mTexture;			/// If null the texture of the material is used.
+			bool mVisible;
+			bool mFlippedHorizontally;
+			bool mFlippedVertically;
+			bool mUseAnimationSize;					/// If true frames set the size, @see Sprite::SetUseAnimationSize().
+
+			// Animation state, set with SpriteBatch::SetAnimation() and advanced by SpriteBatch::Update().
+			shared_ptr<SpriteAnimation> mAnimation;
+			SpriteAnimation::Mode mAnimationMode;	/// NOT_SET uses the mode of the animation.
+			Size mFrameIndex;
+			Seconds mFrameTime;						/// Negative once a play once animation has finished.
+			Vector3 mFrameOffset;
+			Vector3 mFrameScale;
+		};
+
+		/**
+		 * Constructor.
+		 * @param material The material used by sprites that don't specify one, if null a default material with
+		 * vertex colouring enabled is created.
+		 * @param workerPool Optional pool used to write the quads in parallel for large batches.
+		 * @param spritesPerJob The number of sprites written by each job.
+		 */
+		SpriteBatch(shared_ptr<Material> material = shared_ptr<Material>(), shared_ptr<WorkerPool> workerPool = shared_ptr<WorkerPool>(), Size spritesPerJob = 16384);
+		virtual ~SpriteBatch();
+
+		/**
+		 * Add a sprite.
+		 * @return The id of the sprite, ids of removed sprites are reused.
+		 */
+		Size AddSprite(const Instance& instance = Instance());
+
+		/**
+		 * Remove a sprite.
+		 * @param id The id returned by AddSprite().
+		 */
+		void RemoveSprite(Size id);
+
+		/**
+		 * Remove all sprites.
+		 */
+		void ClearSprites();
+
+		/**
+		 * Get a sprite to modify.
+		 * @param id An id returned by AddSprite() of a sprite that has not been removed.
+		 */
+		Instance& GetSprite(Size id);
+		const Instance& GetSprite(Size id) const;
+
+		/**
+		 * Get the number of sprites in the batch.
+		 */
+		Size GetNumberOfSprites() const {return mSlots.size() - mFreeSlots.size();}
+
+		/**
+		 * Set the animation of a sprite.
+		 * The first frame is processed immediately, @see Sprite::SetAnimation().
+		 */
+		void SetAnimation(Size id, shared_ptr<SpriteAnimation> animation);
+
+		/**
+		 * Sets the number of pixels that corresponds to a world unit.
+		 * This is used to convert animation frame sizes in pixels to sprite sizes. The default is 100.
+		 */
+		void SetPixelToWorldUnitRatio(f32 ratio) {mPixelToWorldUnitRatio = ratio;}
+		f32 GetPixelToWorldUnitRatio() const {return mPixelToWorldUnitRatio;}
+
+		/**
+		 * Set whether the sprites face the camera, the default is true.
+		 */
+		void SetAlwaysFaceCamera(bool alwaysFaceCamera) {mAlwaysFaceCamera = alwaysFaceCamera;}
+		bool GetAlwaysFaceCamera() const {return mAlwaysFaceCamera;}
+
+		/**
+		 * Task override that advances the animations of all sprites.
+		 */
+		void Update(Seconds lastFrameTime) override;
+
+		/**
+		 * Write the quads of all visible sprites into the mesh.
+		 * Render() calls this, it is public so the batch can be built without rendering.
+		 * @param cameraOrientation The derived orientation of the camera the quads should face.
+		 */
+		void Build(const Quaternion& cameraOrientation);
+
+		/**
+		 * Get the number of sub meshes, and so draw calls per pass, used by the last Build().
+		 */
+		Size GetNumberOfBatches() const {return mNumberOfBatches;}
+
+		/**
+		 * Override from SceneRenderable that updates the bounds if sprites have changed.
+		 */
+		virtual void Accept(SceneRenderableVisitor& visitor) override;
+
+		/**
+		 * Override from SceneRenderable.
+		 * @return true if the sprites face the camera.
+		 */
+		virtual bool GetBoundsDependOnCamera() const override {return mAlwaysFaceCamera;}
+
+		/**
+		 * Overrides SceneEntity::Render() to build the quads for the camera before rendering.
+		 */
+		virtual void Render(RenderContext& renderContext, Colour compoundDiffuse) override;
+	private:
+		struct Slot
+		{
+			Instance mInstance;
+			bool mInUse;
+			Size mGroup;	/// The group used in the last build, checked before searching for the group.
+		};
+
+		/**
+		 * A group is a sub mesh for sprites with the same material and texture.
+		 */
+		struct Group
+		{
+			shared_ptr<Material> mBaseMaterial;		/// Held so the key remains unique while the group exists.
+			shared_ptr<Texture> mTexture;
+			shared_ptr<SubMesh> mSubMesh;
+			std::vector<u32> mSprites;
+			const char* mIndexedData;
+			Size mNumberOfIndexedSprites;
+		};
+		typedef std::pair<const Material*, const Texture*> GroupKey;
+
+		struct VertexAccessors
+		{
+			VertexBuffer::Accessor<Vector3> mPositions;
+			VertexBuffer::Accessor<Vector3> mNormals;
+			VertexBuffer::Accessor<VertexColour> mColours;
+			VertexBuffer::Accessor<TextureUV> mTextureCoordinates;
+		};
+
+		Size GetGroup(const Instance& instance, Size cachedGroup);
+		bool PrepareGroup(Group& group, VertexAccessors& vertices);
+		void BuildQuads(const Group& group, Size begin, Size end, const Vector3& right, const Vector3& up, const Vector3& back, VertexAccessors& vertices) const;
+		void ProcessFrame(Instance& instance);
+		void ProcessAnimationEnd(Instance& instance);
+		void UpdateBounds();
+
+		//Disabled
+		SpriteBatch(const SpriteBatch& other);
+		SpriteBatch& operator=(const SpriteBatch& rhs);
+
+		shared_ptr<Material> mMaterial;
+		shared_ptr<WorkerPool> mWorkerPool;
+		Size mSpritesPerJob;
+		std::vector<Slot> mSlots;
+		std::vector<Size> mFreeSlots;
+		std::vector<Group> mGroups;
+		std::map<GroupKey, Size> mGroupLookup;
+		Size mNumberOfBatches;
+		f32 mPixelToWorldUnitRatio;
+		bool mAlwaysFaceCamera;
+		bool mBoundsOutOfDate;
+	};
+}
+#endif
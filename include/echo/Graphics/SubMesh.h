@@ -17,6 +17,7 @@ namespace Echo
 {
 	class BoneBinding;
 	class Mesh;
+	class SkinWeights;
 
 	class SubMesh : public MultipassRenderable
 	{
@@ -115,7 +116,34 @@ namespace Echo
 		void SetBoneWeights(shared_ptr< std::vector<BoneBinding*> > boneBindings)
 		{
 			mBoneWeights = boneBindings;
+			mSkinWeights.reset();
 		}
+
+		/**
+		 * Set the packed skin weights used for skinning.
+		 * If skin weights are not set they are built from the bone weights the first time the SubMesh is skinned.
+		 * MeshReader sets them when loading skinned meshes.
+		 * @param skinWeights The skin weights, these may be shared with other SubMeshes that use the same vertices.
+		 */
+		void SetSkinWeights(shared_ptr<SkinWeights> skinWeights)
+		{
+			mSkinWeights = skinWeights;
+		}
+
+		shared_ptr<SkinWeights> GetSkinWeights() const
+		{
+			return mSkinWeights;
+		}
+
+		/**
+		 * Get whether the SubMesh was last skinned in a vertex shader rather than on the CPU.
+		 * Skinning is performed in a vertex shader when the vertex buffer has the SkinWeights vertex attributes
+		 * and every active pass of the material has a program with a "boneMatrices" uniform array large enough
+		 * for the skeleton. The program needs to be built before this can be detected so the first frame may be
+		 * skinned on the CPU.
+		 * @note The axis aligned box is not updated when skinning is performed in a shader.
+		 */
+		bool GetSkinnedOnGPU() const {return mSkinnedOnGPU;}
 		
 		/**
 		 * Get the name of the SubMesh.
@@ -236,8 +264,10 @@ namespace Echo
 		}
 		void SetMaterial(shared_ptr<Material> material);
 		void SetType(MeshType t){mType=t;}
+		MeshType GetType() const {return mType;}
 		void Render(RenderContext& renderContext, const Matrix4& world, const Matrix4& worldView, Colour compoundDiffuse);
 		void Render(RenderContext& renderContext, const RenderPass& pass, Colour compoundDiffuse);
+		const void* GetGeometryIdentifier() const override {return mVertexBuffer.get();}
 		void GenerateNormals();
 		void GenerateTangents(bool logError);
 		void TranslateVertices(const Vector3& translation);
@@ -248,10 +278,14 @@ namespace Echo
 		~SubMesh();
 	private:
 		friend class Mesh;
+		friend class SkinningEngine;
 		shared_ptr<Material> mMaterial;
 		shared_ptr<VertexBuffer> mVertexBuffer;
 		shared_ptr< std::vector<Vector3> > mOriginalVertices;
 		shared_ptr< std::vector<BoneBinding*> > mBoneWeights;
+		shared_ptr<SkinWeights> mSkinWeights;
+		Size mSkinnedPoseVersion;		///The skeleton pose version the vertices were skinned for.
+		bool mSkinnedOnGPU;
 		shared_ptr<ElementBuffer> mElementBuffer;
 		Mesh& mParent;
 		mutable AxisAlignedBox mAxisAlignedBox;
@@ -267,6 +301,34 @@ namespace Echo
 		 * Apply the Bone transforms to the vertices
 		 */
 		void ApplyVertexBoneTransforms();
+
+		/**
+		 * Prepare to skin the vertices on the CPU.
+		 * Builds the skin weights and transform buffers if needed and checks whether the SubMesh can be skinned
+		 * in a shader instead.
+		 * @return true if the vertices need to be skinned for the pose.
+		 */
+		bool PrepareCPUSkinning(const std::vector<Matrix4>& palette, Size poseVersion);
+
+		/**
+		 * Skin a range of vertices. This can be called from multiple threads for different ranges.
+		 */
+		void SkinVertices(const std::vector<Matrix4>& palette, Size begin, Size end);
+
+		/**
+		 * Mark the vertices as skinned for the pose and update the buffer version and extents.
+		 */
+		void FinishCPUSkinning(Size poseVersion);
+
+		/**
+		 * Check whether the material can skin the vertices in a shader.
+		 */
+		bool CanSkinOnGPU(Size numberOfBones);
+
+		/**
+		 * Copy the original vertices back if the vertices have been skinned on the CPU.
+		 */
+		void RestoreUnskinnedVertices();
 		
 		/**
 		 * Generate a copy of the current vertices buffer (in its current state) so we have
@@ -286,6 +286,13 @@ namespace Echo
 		 */
 		Texture& operator=(const Texture& rhs);
 
+		/**
+		 * Replace the buffer, dimensions and format with those of another texture.
+		 * The buffer is shared. Unlike operator=() the name, TextureManager and loaded state are kept so the
+		 * texture can still be reloaded. The version is incremented so render targets upload the new data.
+		 */
+		void ReplaceBuffer(const Texture& source);
+
 		//!\brief Get the width of the texture buffer.
 		u32 GetWidth() const {return mWidth;}
 		
@@ -0,0 +1,112 @@
+#ifndef _ECHOTEXTUREPROCESSOR_H_
+#define _ECHOTEXTUREPROCESSOR_H_
+
+#include <echo/Graphics/Texture.h>
+#include <echo/cpp/functional>
+#include <vector>
+
+namespace Echo
+{
+	class WorkerPool;
+
+	/**
+	 * TextureProcessor converts, resizes and generates mipmaps for Textures on the CPU.
+	 *
+	 * This allows textures to be prepared offline or at load time rather than relying on the driver. All colour
+	 * formats are supported, depth and UNKNOWN formats are not.
+	 *
+	 *		TextureProcessor processor(workerPool);
+	 *		shared_ptr<Texture> rgba = processor.Convert(*texture, Texture::Formats::R8G8B8A8);
+	 *		std::vector< shared_ptr<Texture> > mipmaps = processor.GenerateMipmaps(*rgba, TextureProcessor::Filters::KAISER, true);
+	 *
+	 * Conversions between the common 8 bit formats are performed directly, with SSE2 where available. Other
+	 * conversions, resizing and filtering go through 32 bit float RGBA. Work is split across rows.
+	 *
+	 * When sRGB is specified the colour channels are converted to linear before filtering and back afterwards
+	 * so that averaging doesn't darken the result. Alpha is always linear.
+	 */
+	class TextureProcessor
+	{
+	public:
+		struct Filters
+		{
+			enum _
+			{
+				BOX,		/// Average of the pixels covered, the fastest.
+				TRIANGLE,	/// Bilinear.
+				KAISER		/// Kaiser windowed sinc, sharper with less aliasing.
+			};
+		};
+		typedef Filters::_ Filter;
+
+		/**
+		 * Constructor.
+		 * @param workerPool Optional worker pool to process textures in parallel.
+		 * @param rowsPerJob The maximum number of rows each job processes.
+		 */
+		TextureProcessor(shared_ptr<WorkerPool> workerPool = shared_ptr<WorkerPool>(), Size rowsPerJob = 32);
+		~TextureProcessor();
+
+		/**
+		 * Get whether a format can be processed.
+		 */
+		static bool GetFormatSupported(Texture::Format format);
+
+		/**
+		 * Convert a texture to another format.
+		 * Channels that the destination doesn't have are dropped. Missing colour channels are zero and missing
+		 * alpha is opaque. Converting colour to luminance uses the Rec. 709 weights.
+		 * @return The converted texture, or null if either format is not supported or the texture has no data.
+		 */
+		shared_ptr<Texture> Convert(const Texture& source, Texture::Format format) const;
+
+		/**
+		 * Convert pixels from one format to another.
+		 * @param source The source pixels.
+		 * @param sourceFormat The format of the source pixels.
+		 * @param destination Where to write the converted pixels, this cannot overlap the source.
+		 * @param destinationFormat The format to convert to.
+		 * @param numberOfPixels The number of pixels to convert.
+		 * @return false if either format is not supported.
+		 */
+		static bool ConvertPixels(const u8* source, Texture::Format sourceFormat, u8* destination, Texture::Format destinationFormat, Size numberOfPixels);
+
+		/**
+		 * Resize a texture.
+		 * The filter is widened when reducing the size so that every source pixel contributes.
+		 * @param source The texture to resize.
+		 * @param width The new width, must be greater than 0.
+		 * @param height The new height, must be greater than 0.
+		 * @param filter The filter to use.
+		 * @param sRGB Whether the colour channels are sRGB encoded.
+		 * @return A texture of the same format as the source, or null if the source can't be processed.
+		 */
+		shared_ptr<Texture> Resize(const Texture& source, u32 width, u32 height, Filter filter = Filters::TRIANGLE, bool sRGB = false) const;
+
+		/**
+		 * Generate the mipmap chain for a texture.
+		 * Each level is half the size of the previous level, rounded down, until both dimensions are 1. Each level
+		 * is filtered from the previous level. Box filtering 8 bit RGBA and BGRA textures with even dimensions
+		 * uses a faster path.
+		 * @param source The texture to generate the mipmaps of, this is level 0.
+		 * @param filter The filter to use.
+		 * @param sRGB Whether the colour channels are sRGB encoded.
+		 * @param maximumLevels The maximum number of levels to generate, 0 for all of them.
+		 * @return Levels 1 onwards in the format of the source, empty if the source can't be processed.
+		 */
+		std::vector< shared_ptr<Texture> > GenerateMipmaps(const Texture& source, Filter filter = Filters::BOX, bool sRGB = false, Size maximumLevels = 0) const;
+
+		/**
+		 * Get the number of levels in a full mipmap chain, including level 0.
+		 */
+		static Size GetNumberOfMipmapLevels(u32 width, u32 height);
+	private:
+		typedef function<void(Size begin, Size end)> RangeFunction;
+		void ForEach(Size count, Size grainSize, RangeFunction rangeFunction) const;
+		shared_ptr<Texture> HalveBox(const Texture& source, bool sRGB) const;
+
+		shared_ptr<WorkerPool> mWorkerPool;
+		Size mRowsPerJob;
+	};
+}
+#endif
@@ -0,0 +1,155 @@
+#ifndef _ECHOTRANSFORMHIERARCHY_H_
+#define _ECHOTRANSFORMHIERARCHY_H_
+
+#include <echo/Types.h>
+#include <echo/Maths/Quaternion.h>
+#include <echo/Maths/Matrix4.h>
+#include <echo/Kernel/Mutex.h>
+#include <atomic>
+#include <vector>
+
+namespace Echo
+{
+	class Node;
+	class WorkerPool;
+
+	/**
+	 * A TransformHierarchy stores the transforms of one or more Node trees in flat arrays.
+	 *
+	 * Nodes are stored in depth order, so every node in a level has its parent in an earlier level. Local and
+	 * derived position, orientation and scale, the world transform matrix and a dirty flag are each kept in
+	 * their own contiguous array. Updating is a linear pass over each level that only calculates dirty nodes
+	 * and the descendants of dirty nodes. The nodes in a level are independent so a level can be split across
+	 * the workers of a WorkerPool.
+	 *
+	 * Adding a root adds the whole tree below it. Nodes added to or removed from the tree with the Node methods
+	 * are added to or removed from the hierarchy automatically. While a Node is in a hierarchy it acts as a
+	 * handle, setting properties marks the node dirty rather than notifying every descendant and the derived
+	 * getters return values from the hierarchy's arrays. Structural changes are deferred and the arrays are
+	 * rebuilt on the next update.
+	 *
+	 *		TransformHierarchy hierarchy(workerPool);
+	 *		hierarchy.AddRoot(sceneRoot);
+	 *		...
+	 *		hierarchy.Update();	// Update all of the nodes, in parallel if possible.
+	 *
+	 * Derived values are also updated on demand when one is requested from a Node, so calling Update() is
+	 * optional. The transform properties of nodes can be set while another thread is updating the hierarchy,
+	 * the change is included in the next update. Like Node, changing the structure of the tree while the
+	 * hierarchy is being updated is not supported.
+	 *
+	 * References to derived values returned by Nodes in a hierarchy are invalidated when the structure of the
+	 * hierarchy changes.
+	 */
+	class TransformHierarchy
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param workerPool Optional WorkerPool used to update large levels in parallel.
+		 * @param nodesPerJob The number of nodes to process per job when updating with the worker pool. Levels
+		 * smaller than this are processed on the calling thread.
+		 */
+		TransformHierarchy(shared_ptr<WorkerPool> workerPool = shared_ptr<WorkerPool>(), Size nodesPerJob = 4096);
+
+		/**
+		 * Destructor.
+		 * All nodes are removed from the hierarchy.
+		 */
+		~TransformHierarchy();
+
+		/**
+		 * Add a node and all of its descendants to the hierarchy.
+		 * The node's derived transform is calculated as if it does not have a parent so root nodes should not
+		 * have a parent. If the node is already in another hierarchy it is removed from that hierarchy first,
+		 * which means removing it from its parent if it is not a root of the other hierarchy.
+		 * If the node is already in this hierarchy this method does nothing.
+		 * @param node The root node, it needs to stay valid until it is removed from the hierarchy or destroyed.
+		 */
+		void AddRoot(Node& node);
+
+		/**
+		 * Remove a root node and all of its descendants from the hierarchy.
+		 * The nodes calculate their derived values themselves again.
+		 * @return true if the node was a root of this hierarchy.
+		 */
+		bool RemoveRoot(Node& node);
+
+		/**
+		 * Update the derived properties of every dirty node and their descendants.
+		 * If the hierarchy has a WorkerPool then levels with more than the nodes per job are updated in parallel.
+		 */
+		void Update();
+
+		/**
+		 * Get the number of nodes in the hierarchy.
+		 * This will rebuild the hierarchy if the structure has changed.
+		 */
+		Size GetNumberOfNodes();
+
+		/**
+		 * Get the depth of the deepest node plus one.
+		 * This will rebuild the hierarchy if the structure has changed.
+		 */
+		Size GetNumberOfLevels();
+	private:
+		friend class Node;
+		static const u8 INHERIT_ORIENTATION = 1;
+		static const u8 INHERIT_SCALE = 2;
+
+		shared_ptr<WorkerPool> mWorkerPool;
+		Size mNodesPerJob;
+		std::vector<Node*> mRoots;
+
+		std::vector<Node*> mNodes;
+		std::vector<Size> mParents;					// Parent index, or the node's own index for roots.
+		std::vector<Size> mLevelStarts;				// Index of the first node of each level plus one past the end.
+		std::vector<Vector3> mPositions;
+		std::vector<Quaternion> mOrientations;
+		std::vector<Vector3> mScales;
+		std::vector<u8> mInheritFlags;
+		std::vector<u8> mDirty;
+		std::vector<Vector3> mDerivedPositions;
+		std::vector<Quaternion> mDerivedOrientations;
+		std::vector<Vector3> mDerivedScales;
+		std::vector<Matrix4> mTransforms;
+
+		bool mStructureOutOfDate;
+		std::atomic<bool> mOutOfDate;
+		Mutex mMutex;
+
+		/**
+		 * Called by Node when one of its transform properties changes.
+		 * This locks the hierarchy so it can be called while another thread updates the hierarchy.
+		 */
+		void NodeChanged(const Node& node);
+
+		/**
+		 * Called by Node when a node is added as a child of a node in this hierarchy.
+		 */
+		void AttachSubtree(Node& node);
+
+		/**
+		 * Called by Node when a node is removed from a parent in this hierarchy.
+		 */
+		void DetachSubtree(Node& node);
+
+		/**
+		 * Update the hierarchy if anything has changed since the last update.
+		 * This is cheap to call when nothing has changed.
+		 */
+		inline void EnsureUpdated()
+		{
+			if(mOutOfDate.load(std::memory_order_acquire))
+			{
+				Update();
+			}
+		}
+
+		void Rebuild();
+		void CopyLocalProperties(Size index);
+		void UpdateRange(Size begin, Size end);
+		void SetHierarchy(Node& node, TransformHierarchy* hierarchy);
+	};
+}
+#endif
@@ -3,6 +3,7 @@
 
 #include <echo/Types.h>
 #include <echo/Graphics/VertexAttribute.h>
+#include <echo/Graphics/VertexLayout.h>
 #include <echo/Resource/Resource.h>
 #include <vector>
 #include <map>
@@ -124,6 +125,19 @@ namespace Echo
 			return mVertexAttributes.size();
 		}
 
+		/**
+		 * Get the compiled layout of the buffer's attributes.
+		 * The layout is created when attributes are added and is shared with other buffers that have the same
+		 * attributes. Since it is not created on demand it is safe to call from multiple threads while the
+		 * attributes are not being modified. Render targets should use the layout rather than looking up
+		 * attributes by name.
+		 * @return The layout.
+		 */
+		shared_ptr<const VertexLayout> GetLayout() const
+		{
+			return mLayout;
+		}
+
 		/**
 		 * Allocate a buffer big enough to contain the specified number of vertices.
 		 * This method needs to be called after all of the VertexAttributes have been added.
@@ -291,6 +305,23 @@ namespace Echo
 		{
 			return mData;
 		}
+
+		/**
+		 * Get the pointer to the data for writing.
+		 * @return A pointer to the start of the allocated buffer, GetBufferSize() bytes can be written.
+		 */
+		char* GetDataPointer()
+		{
+			return mData;
+		}
+
+		/**
+		 * Get the names of the attributes mapped to their indices.
+		 */
+		const std::map< std::string, Size >& GetNamedAttributes() const
+		{
+			return mNamedAttributes;
+		}
 	private:
 		virtual bool _Unload() override;
 		virtual size_t OnRequestMemoryRelease() override;
@@ -299,6 +330,7 @@ namespace Echo
 		Size mStride;
 		std::vector< VertexAttribute > mVertexAttributes;
 		std::map< std::string, Size > mNamedAttributes;
+		shared_ptr<const VertexLayout> mLayout;
 		char* mData;
 		Size mDataSize;
 		Size mNumberOfElements;
@@ -0,0 +1,105 @@
+#ifndef _ECHOVERTEXLAYOUT_H_
+#define _ECHOVERTEXLAYOUT_H_
+
+#include <echo/Types.h>
+#include <echo/Graphics/VertexAttribute.h>
+#include <vector>
+#include <map>
+#include <string>
+
+namespace Echo
+{
+	/**
+	 * A VertexLayout is the compiled, immutable description of the attributes in a VertexBuffer.
+	 *
+	 * Render targets need to know where well known attributes such as the position, normals, colours and
+	 * texture coordinates are in each vertex. Looking these up by name every draw is expensive so the layout
+	 * resolves them once when it is created.
+	 *
+	 * Layouts are shared. Create() returns the same object for VertexBuffers that have the same attributes,
+	 * names and offsets, so layouts can be compared and used as cache keys by pointer.
+	 *
+	 * Well known attribute names are:
+	 *	- "Position"
+	 *	- "Normal"
+	 *	- "Colour"
+	 *	- "UV0", "UV1", ... for texture coordinate sets.
+	 */
+	class VertexLayout
+	{
+	public:
+		/**
+		 * The location of an attribute in the layout.
+		 */
+		struct Slot
+		{
+			Slot() : mIndex(-1), mOffset(0){}
+			Slot(s32 index, Size offset) : mIndex(index), mOffset(offset){}
+			s32 mIndex;		/// The attribute index, -1 if the layout does not contain the attribute.
+			Size mOffset;	/// The offset in bytes from the start of a vertex.
+			inline bool IsValid() const {return mIndex>=0;}
+		};
+
+		/**
+		 * Create or find a shared layout.
+		 * @param attributes The attributes, the offsets need to have been set.
+		 * @param namedAttributes The names of the attributes mapped to indices into attributes.
+		 * @return The layout, layouts with equivalent attributes are the same object.
+		 */
+		static shared_ptr<const VertexLayout> Create(const std::vector< VertexAttribute >& attributes, const std::map< std::string, Size >& namedAttributes);
+
+		~VertexLayout();
+
+		/**
+		 * Get the hash of the layout.
+		 * Equal layouts have equal hashes.
+		 */
+		Size GetHash() const {return mHash;}
+
+		Size GetStride() const {return mStride;}
+		Size GetNumberOfAttributes() const {return mAttributes.size();}
+		const VertexAttribute& GetAttribute(Size index) const {return mAttributes[index];}
+
+		/**
+		 * Find a named attribute.
+		 * @note This performs a lookup, prefer the well known slots when rendering.
+		 */
+		Slot FindSlot(const std::string& name) const;
+
+		const Slot& GetPositionSlot() const {return mPosition;}
+		const Slot& GetNormalSlot() const {return mNormal;}
+		const Slot& GetColourSlot() const {return mColour;}
+
+		/**
+		 * Get the slot for a texture coordinate set.
+		 * @param set The set index, "UV0" is set 0.
+		 * @return The slot, which is invalid if the layout does not have the set.
+		 */
+		const Slot& GetTextureCoordinateSlot(Size set) const
+		{
+			if(set >= mTextureCoordinates.size())
+			{
+				return mInvalidSlot;
+			}
+			return mTextureCoordinates[set];
+		}
+
+		bool operator==(const VertexLayout& rhs) const;
+		bool operator!=(const VertexLayout& rhs) const {return !(*this==rhs);}
+	private:
+		VertexLayout(const std::vector< VertexAttribute >& attributes, const std::map< std::string, Size >& namedAttributes);
+		VertexLayout(const VertexLayout&) = delete;
+		VertexLayout& operator=(const VertexLayout&) = delete;
+
+		std::vector< VertexAttribute > mAttributes;
+		std::map< std::string, Size > mNamedAttributes;
+		Size mStride;
+		Size mHash;
+		Slot mPosition;
+		Slot mNormal;
+		Slot mColour;
+		std::vector< Slot > mTextureCoordinates;
+		Slot mInvalidSlot;
+	};
+}
+#endif
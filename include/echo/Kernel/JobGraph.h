@@ -0,0 +1,83 @@
+#ifndef _ECHO_JOBGRAPH_H_
+#define _ECHO_JOBGRAPH_H_
+#include <echo/Kernel/WorkerPool.h>
+#include <atomic>
+#include <vector>
+
+namespace Echo
+{
+	/**
+	 * A JobGraph is a set of jobs with dependencies between them.
+	 * Each job keeps a count of the dependencies that haven't completed. When a job completes the counts of the jobs
+	 * that depend on it are decremented and any that reach zero are scheduled. Jobs without dependencies between them
+	 * are executed in parallel.
+	 *
+	 * A graph can be executed many times, for example once per frame, without being rebuilt.
+	 *
+	 *		JobGraph graph;
+	 *		JobGraph::JobID animate = graph.AddJob([&](){ AnimateSkeletons(); });
+	 *		JobGraph::JobID particles = graph.AddJob([&](){ UpdateParticles(); });
+	 *		JobGraph::JobID skin = graph.AddJob([&](){ SkinMeshes(); });
+	 *		graph.AddDependency(skin, animate);
+	 *		graph.Execute(pool);
+	 */
+	class JobGraph
+	{
+	public:
+		typedef Size JobID;
+
+		JobGraph();
+		~JobGraph();
+
+		/**
+		 * Add a job to the graph.
+		 * @param job The job to execute.
+		 * @return the ID of the job to use with AddDependency().
+		 */
+		JobID AddJob(WorkerPool::Job job);
+
+		/**
+		 * Add a dependency between two jobs.
+		 * @param job The job that needs to wait.
+		 * @param dependency The job that needs to complete before job is executed.
+		 * @return false if either ID is invalid or job and dependency are the same job.
+		 */
+		bool AddDependency(JobID job, JobID dependency);
+
+		/**
+		 * Get the number of jobs in the graph.
+		 */
+		Size GetNumberOfJobs() const
+		{
+			return mNodes.size();
+		}
+
+		/**
+		 * Remove all jobs.
+		 */
+		void Clear();
+
+		/**
+		 * Execute the graph.
+		 * The calling thread will help execute jobs and the method returns once all jobs have completed.
+		 * @param workerPool The pool to execute the jobs on.
+		 * @return false if the graph contains a dependency cycle, in which case no jobs are executed.
+		 */
+		bool Execute(WorkerPool& workerPool);
+	private:
+		struct Node
+		{
+			Node(WorkerPool::Job job) : mJob(job), mNumberOfDependencies(0), mRemainingDependencies(0){}
+			WorkerPool::Job mJob;
+			std::vector<JobID> mDependents;
+			Size mNumberOfDependencies;
+			std::atomic<Size> mRemainingDependencies;
+		};
+		void ScheduleJob(WorkerPool& workerPool, JobID job, WorkerPool::Counter& counter);
+		bool HasCycle() const;
+
+		std::vector< unique_ptr<Node> > mNodes;
+		bool mValidated;
+	};
+}
+#endif
@@ -87,6 +87,18 @@ namespace Echo
 		 * @return the frame rate limiter.
 		 */
 		FrameRateLimiter& GetFrameRateLimiter() {return mFrameLimiter;}
+
+		/**
+		 * Set the number of worker threads used to update parallel safe tasks.
+		 * The thread executing the Kernel also processes tasks so on a machine with N cores N-1 workers will
+		 * keep all cores busy. All parallel safe tasks are joined before the next non parallel safe task is
+		 * updated so tasks such as rendering, which are not parallel safe, see the results of the frame.
+		 * The pool is available through GetWorkerPool() so tasks can also split their own work with
+		 * WorkerPool::ParallelFor(), fork/join with WorkerPool::Schedule() and WorkerPool::Wait(), or use a JobGraph.
+		 * @see Task::SetParallelSafe()
+		 * @param numberOfWorkerThreads the number of worker threads, 0 disables parallel task updates.
+		 */
+		void SetNumberOfWorkerThreads(Size numberOfWorkerThreads);
 	private:
 		shared_ptr<ExecutionModel> mExecutionModel;
 		std::list< TaskThread* > mThreads;
@@ -137,6 +137,32 @@ namespace Echo
 			return mPausable;
 		}
 
+		/**
+		 * Set whether this task can be updated in parallel with other tasks.
+		 * If a TaskManager has a WorkerPool, parallel safe tasks that have the same priority are updated
+		 * concurrently and the TaskManager waits for all of them to finish before updating tasks with a
+		 * different priority. Priority can therefore be used to express dependencies between parallel
+		 * safe tasks, e.g. give tasks that need to run after physics a higher priority value than the
+		 * physics task.
+		 *
+		 * A parallel safe task must not access unsynchronised state that is shared with other tasks of
+		 * the same priority and must not add or remove tasks from its TaskManager during Update().
+		 * @param parallelSafe true to allow the task to be updated in parallel with other tasks.
+		 */
+		inline void SetParallelSafe(bool parallelSafe)
+		{
+			mParallelSafe = parallelSafe;
+		}
+
+		/**
+		 * Get whether this task can be updated in parallel with other tasks.
+		 * @see SetParallelSafe()
+		 */
+		inline bool GetParallelSafe() const
+		{
+			return mParallelSafe;
+		}
+
 		/**
 		 * Attempt to start this task.
 		 * Calling this method will cause OnStart() to be called if the task has not already started.
@@ -230,6 +256,8 @@ namespace Echo
 		bool mPausable;
 		/// Pause flag.
 		bool mPaused;
+		/// Parallel safe flag.
+		bool mParallelSafe;
 		/// Lower values are updated first
 		u32 mPriority;
 		/// Task name
@@ -2,14 +2,17 @@
 #define _ECHO_TASKMANAGER_H_
 #include <list>
 #include <queue>
+#include <vector>
 #include <echo/Types.h>
 #include <echo/Chrono/ProfilerAverager.h>
 #include <echo/Kernel/Task.h>
+#include <echo/Kernel/Mutex.h>
 #include <echo/cpp/functional>
 
 namespace Echo
 {
 	class Task;
+	class WorkerPool;
 
 	/**
 	 * TaskManagers manages a list of tasks.
@@ -303,8 +306,31 @@ namespace Echo
 		/**
 		 * Update all active tasks.
 		 * Calling this after StopTasks() may still result in tasks being updated. @see StopTasks() for more information.
+		 * If a WorkerPool has been set, parallel safe tasks with the same priority are updated concurrently. This method
+		 * does not return until all tasks have been updated.
+		 * @see Task::SetParallelSafe()
 		 */
 		void UpdateTasks(Seconds lastFrameTime);
+
+		/**
+		 * Set the WorkerPool used to update parallel safe tasks.
+		 * If no pool is set all tasks are updated on the thread calling UpdateTasks().
+		 * @note The pool is not automatically shared with child TaskManagers such as TaskGroups.
+		 * @param workerPool the pool to use, or a null pointer to update all tasks serially.
+		 */
+		void SetWorkerPool(shared_ptr<WorkerPool> workerPool)
+		{
+			mWorkerPool = workerPool;
+		}
+
+		/**
+		 * Get the WorkerPool used to update parallel safe tasks.
+		 * @return the WorkerPool, or a null pointer if tasks are updated serially.
+		 */
+		shared_ptr<WorkerPool> GetWorkerPool() const
+		{
+			return mWorkerPool;
+		}
 		
 		//!\ brief Get the number of active tasks in this manager.
 		//!\ param includeChildTaskManagerTasks if true include the number of tasks active in child state manages too.
@@ -329,6 +355,7 @@ namespace Echo
 		 * specialised Tasks.
 		 * @note Actions cannot be cancelled so only queue actions that you know will be valid when the TaskManager gets around to
 		 * executing them.
+		 * @note This method is safe to call from parallel safe tasks during an update.
 		 * @param action Generic action to be called. The action is executed once then discarded.
 		 */
 		void QueuePostUpdateAction(Action action);
@@ -361,6 +388,11 @@ namespace Echo
 	private:
 		void UpdateLists();
 
+		/**
+		 * Update a set of tasks that share the same priority using the worker pool.
+		 */
+		void UpdateParallelTasks(std::vector<Task*>& tasks, Seconds lastFrameTime);
+
 		/**
 		 * Internal structure used to manage the different ways a task might be added to a manager and
 		 * to provide a consistent way for the manager to use Tasks without checking how each task was
@@ -495,6 +527,9 @@ namespace Echo
 		bool AddTask(Task* task, shared_ptr<Task> taskPtr);
 		
 		std::vector<Action> mPostUpdateActions;
+		Mutex mPostUpdateActionsMutex;
+		shared_ptr<WorkerPool> mWorkerPool;
+		std::vector<Task*> mParallelTasks;
 		std::string mManagerName;
 		TaskList mTaskList;
 		TaskList mActiveTaskList;
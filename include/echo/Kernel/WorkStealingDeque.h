@@ -0,0 +1,157 @@
+#ifndef _ECHO_WORKSTEALINGDEQUE_H_
+#define _ECHO_WORKSTEALINGDEQUE_H_
+#include <echo/Types.h>
+#include <atomic>
+#include <vector>
+
+namespace Echo
+{
+	/**
+	 * A lock-free single owner, multiple thief deque.
+	 * This is the Chase-Lev deque as described in "Correct and Efficient Work-Stealing for Weak Memory
+	 * Models" (Le, Pop, Cohen and Zappa Nardelli).
+	 *
+	 * Only the owning thread may call Push() and Pop(), which operate on the bottom of the deque. Any
+	 * thread may call Steal(), which takes from the top of the deque.
+	 *
+	 * The buffer grows as needed. Old buffers are kept until the deque is destroyed since a thief might
+	 * still be reading from them, this means memory use is at most double the peak size.
+	 * @note T needs to be trivially copyable, it is intended to be used with pointers.
+	 */
+	template< typename T >
+	class WorkStealingDeque
+	{
+	public:
+		WorkStealingDeque(Size initialCapacity = 256) : mTop(0), mBottom(0)
+		{
+			// The capacity needs to be a power of two.
+			Size capacity = 1;
+			while(capacity < initialCapacity)
+			{
+				capacity <<= 1;
+			}
+			mBuffers.push_back(unique_ptr<Buffer>(new Buffer(capacity)));
+			mBuffer.store(mBuffers.back().get(), std::memory_order_relaxed);
+		}
+
+		/**
+		 * Push an item onto the bottom of the deque.
+		 * @note Only the owner may call this method.
+		 */
+		void Push(T item)
+		{
+			s64 bottom = mBottom.load(std::memory_order_relaxed);
+			s64 top = mTop.load(std::memory_order_acquire);
+			Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+			if(bottom - top > static_cast<s64>(buffer->mCapacity) - 1)
+			{
+				buffer = Grow(buffer, bottom, top);
+			}
+			buffer->Put(bottom, item);
+			// Publishes the item to thieves which acquire mBottom.
+			mBottom.store(bottom + 1, std::memory_order_release);
+		}
+
+		/**
+		 * Pop an item from the bottom of the deque.
+		 * @note Only the owner may call this method.
+		 * @return true if an item was popped, false if the deque was empty.
+		 */
+		bool Pop(T& itemOut)
+		{
+			s64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+			Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+			mBottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			s64 top = mTop.load(std::memory_order_relaxed);
+			if(top > bottom)
+			{
+				// Empty
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+			itemOut = buffer->Get(bottom);
+			if(top == bottom)
+			{
+				// Last item, race against thieves.
+				bool won = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+
+		/**
+		 * Steal an item from the top of the deque.
+		 * Any thread may call this method.
+		 * @return true if an item was stolen, false if the deque was empty or another thread won the race.
+		 */
+		bool Steal(T& itemOut)
+		{
+			s64 top = mTop.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			s64 bottom = mBottom.load(std::memory_order_acquire);
+			if(top >= bottom)
+			{
+				return false;
+			}
+			Buffer* buffer = mBuffer.load(std::memory_order_acquire);
+			T item = buffer->Get(top);
+			if(!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return false;
+			}
+			itemOut = item;
+			return true;
+		}
+
+		/**
+		 * Get whether the deque appears empty.
+		 * The result is only a hint when called from a thread other than the owner.
+		 */
+		bool IsEmpty() const
+		{
+			return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+		}
+	private:
+		struct Buffer
+		{
+			Buffer(Size capacity) : mCapacity(capacity), mMask(capacity - 1), mItems(new std::atomic<T>[capacity])
+			{
+			}
+			inline void Put(s64 index, T item)
+			{
+				mItems[index & mMask].store(item, std::memory_order_relaxed);
+			}
+			inline T Get(s64 index) const
+			{
+				return mItems[index & mMask].load(std::memory_order_relaxed);
+			}
+			Size mCapacity;
+			Size mMask;
+			unique_ptr< std::atomic<T>[] > mItems;
+		};
+
+		Buffer* Grow(Buffer* buffer, s64 bottom, s64 top)
+		{
+			unique_ptr<Buffer> newBuffer(new Buffer(buffer->mCapacity * 2));
+			for(s64 i = top; i < bottom; ++i)
+			{
+				newBuffer->Put(i, buffer->Get(i));
+			}
+			Buffer* result = newBuffer.get();
+			mBuffers.push_back(std::move(newBuffer));
+			mBuffer.store(result, std::memory_order_release);
+			return result;
+		}
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+		std::atomic<s64> mTop;
+		std::atomic<s64> mBottom;
+		std::atomic<Buffer*> mBuffer;
+		std::vector< unique_ptr<Buffer> > mBuffers;	//!< Only accessed by the owner.
+	};
+}
+#endif
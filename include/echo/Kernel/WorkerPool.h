@@ -0,0 +1,148 @@
+#ifndef _ECHO_WORKERPOOL_H_
+#define _ECHO_WORKERPOOL_H_
+#include <echo/Types.h>
+#include <echo/Kernel/Mutex.h>
+#include <echo/Kernel/WorkStealingDeque.h>
+#include <echo/cpp/functional>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Echo
+{
+	class Thread;
+
+	/**
+	 * A WorkerPool is a set of threads that execute jobs.
+	 * Each worker owns a lock-free WorkStealingDeque. Jobs scheduled from a worker thread are pushed onto that
+	 * worker's deque, jobs scheduled from any other thread are added to a shared queue. A worker takes jobs from
+	 * the bottom of its own deque, then from the shared queue, and when there is nothing else to do it will steal
+	 * jobs from the top of the other workers' deques. This keeps all of the workers busy when jobs are unevenly
+	 * distributed, for example when a job forks more jobs.
+	 *
+	 * Jobs are tracked with a Counter. Waiting on a counter does not block the calling thread idly, instead the
+	 * calling thread helps process jobs until the counter reaches zero. This means it is safe to wait from within
+	 * a job, which is how fork/join is achieved:
+	 *
+	 *		WorkerPool pool(4);
+	 *		WorkerPool::Counter counter;
+	 *		pool.Schedule([](){ DoSomething(); }, counter);		// Fork
+	 *		pool.Schedule([](){ DoSomethingElse(); }, counter);	// Fork
+	 *		pool.Wait(counter);									// Join
+	 *
+	 * Loops can be split across the workers with ParallelFor() and jobs with dependencies can be executed with a
+	 * JobGraph.
+	 */
+	class WorkerPool
+	{
+	public:
+		typedef function<void()> Job;
+		typedef function<void(Size begin, Size end)> RangeFunction;
+
+		/**
+		 * Counter used to track the completion of a set of jobs.
+		 * A counter must outlive the jobs it is tracking.
+		 */
+		class Counter
+		{
+		public:
+			Counter() : mPending(0){}
+			/**
+			 * Get whether all of the jobs being tracked have completed.
+			 */
+			inline bool IsComplete() const
+			{
+				return mPending.load(std::memory_order_acquire)==0;
+			}
+		private:
+			friend class WorkerPool;
+			Counter(const Counter&) = delete;
+			Counter& operator=(const Counter&) = delete;
+			std::atomic<Size> mPending;
+		};
+
+		/**
+		 * Constructor
+		 * @param numberOfWorkers the number of worker threads to create.
+		 * @param name the name used for the worker threads, each thread will have its index appended.
+		 */
+		WorkerPool(Size numberOfWorkers, const std::string& name = "Worker");
+
+		/**
+		 * Destructor.
+		 * Workers will finish the job they are currently executing and then terminate. Any jobs that
+		 * have not been started will not be executed.
+		 */
+		~WorkerPool();
+
+		/**
+		 * Get the number of worker threads.
+		 */
+		Size GetNumberOfWorkers() const
+		{
+			return mWorkers.size();
+		}
+
+		/**
+		 * Schedule a job for execution.
+		 * @param job The job to execute.
+		 * @param counter The counter used to track the completion of the job.
+		 */
+		void Schedule(Job job, Counter& counter);
+
+		/**
+		 * Wait for all of the jobs tracked by the counter to complete.
+		 * The calling thread will execute jobs while it waits.
+		 */
+		void Wait(Counter& counter);
+
+		/**
+		 * Split a range into chunks and process them on the workers.
+		 * The calling thread processes chunks too and the method returns once the whole range has been processed.
+		 * @param begin The first index of the range.
+		 * @param end One past the last index of the range.
+		 * @param grainSize The maximum number of indices per chunk. If 0 the range will be split into a few chunks
+		 * per worker. Choose a grain size that makes each chunk significantly more expensive than scheduling a job.
+		 * @param rangeFunction The function to call for each chunk with the chunk's begin and end indices.
+		 */
+		void ParallelFor(Size begin, Size end, Size grainSize, RangeFunction rangeFunction);
+	private:
+		struct Entry
+		{
+			Job mJob;
+			Counter* mCounter;
+		};
+
+		struct Worker
+		{
+			WorkStealingDeque<Entry*> mJobs;
+			unique_ptr<Thread> mThread;
+		};
+
+		/**
+		 * Attempt to execute a single job.
+		 * The worker's own queue is checked first, then the other workers' queues are checked.
+		 * @param workerIndex the index of the worker, GetNumberOfWorkers() if the caller is not a worker.
+		 * @return true if a job was executed, false if no job could be found.
+		 */
+		bool ExecuteNextJob(Size workerIndex);
+		bool TakeSharedJob(Entry*& entryOut);
+		bool StealJob(Size workerIndex, Entry*& entryOut);
+		void WakeWorker();
+		void WorkerMain(Size workerIndex);
+		Size GetCurrentWorkerIndex() const;
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		std::vector< unique_ptr<Worker> > mWorkers;
+		Mutex mSharedJobsMutex;
+		std::deque<Entry*> mSharedJobs;
+		std::atomic<Size> mNumberOfSharedJobs;
+		std::atomic<Size> mNextWorker;
+		std::atomic<Size> mSleepingWorkers;
+		std::atomic<bool> mShutdown;
+	};
+}
+#endif
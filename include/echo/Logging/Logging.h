@@ -6,6 +6,7 @@
 #include <sstream>
 #include <map>
 #include <vector>
+#include <atomic>
 #undef ERROR
 
 namespace Echo
@@ -15,6 +16,8 @@ namespace Echo
 	/**
 	 * Logger that writes to multiple output streams.
 	 * The default output stream is added with SetLogOutputStream("stdout",&std::cout).
+	 * By default messages are formatted and written on the calling thread. See SetAsynchronous() to move formatting
+	 * and writing to a background thread.
 	 */
 	class Logger
 	{
@@ -32,8 +35,24 @@ namespace Echo
 		};
 		typedef LogLevels::_ LogLevel;
 		typedef u64 LogMask;
+
+		/**
+		 * What to do when a thread's asynchronous buffer is full.
+		 *	DROP - The message is discarded and counted, the number dropped is reported in the log once there is space.
+		 *	BLOCK - The logging thread waits until the background thread has made space.
+		 */
+		struct OverflowPolicies
+		{
+			enum _
+			{
+				DROP,
+				BLOCK
+			};
+		};
+		typedef OverflowPolicies::_ OverflowPolicy;
 		
 		Logger();
+		~Logger();
 		
 		/**
 		 * Set the log format.
@@ -50,12 +69,47 @@ namespace Echo
 		/**
 		 * Log a message at the given log level.
 		 */
-		void Log(LogLevel level, const char* file, int line, const std::string& message) const;
+		void Log(LogLevel level, const char* file, int line, std::string message) const;
 
 		/**
 		 * Log a message with the level specified by label.
 		 */
-		void Log(const std::string& label, const char* file, int line, const std::string& message) const;
+		void Log(const std::string& label, const char* file, int line, std::string message) const;
+
+		/**
+		 * Check whether messages at a level will be logged.
+		 * This is used by the ECHO_LOG_* macros to avoid building messages that would be discarded.
+		 */
+		inline bool IsLogLevelEnabled(LogMask level) const
+		{
+			return (mLogMask & level)!=0;
+		}
+
+		/**
+		 * Enable or disable asynchronous logging.
+		 * When enabled Log() moves the message into a lock-free buffer owned by the calling thread and returns. A
+		 * background thread formats the messages and writes them to the output streams. Messages from one thread are
+		 * written in the order they were logged but messages from different threads may be interleaved differently
+		 * to when they were logged.
+		 * Disabling waits for queued messages to be written before returning.
+		 * @param asynchronous Whether to log asynchronously.
+		 * @param messagesPerThread The number of messages each thread can queue. This only affects threads that log
+		 * for the first time after the call.
+		 * @param overflowPolicy What to do when a thread's buffer is full.
+		 */
+		void SetAsynchronous(bool asynchronous, Size messagesPerThread = 4096, OverflowPolicy overflowPolicy = OverflowPolicies::DROP);
+		bool GetAsynchronous() const;
+
+		/**
+		 * Wait until all asynchronously queued messages have been written.
+		 * This does nothing if asynchronous logging has never been enabled.
+		 */
+		void Flush() const;
+
+		/**
+		 * Get the number of messages that have been dropped because a thread's asynchronous buffer was full.
+		 */
+		Size GetNumberOfDroppedMessages() const;
 
 		/**
 		 * Set the log mask.
@@ -145,7 +199,7 @@ namespace Echo
 		std::string GetLogLevelLabel(const LogLevel& logLevel) const;
 		LogMask ConvertLabelToLogMask(const std::string& label) const;
 	private:
-		inline void LocklessLog(const std::string& label, const char* file, int line, const std::string& message) const;
+		inline void LocklessLog(const std::string& label, const char* file, int line, const std::string& message, const std::string& timestamp) const;
 		inline std::string LocklessGetLogLevelLabel(const LogLevel& logLevel) const;
 		LogMask mLogMask;
 		std::vector< std::ostream* > mOutputStreams;
@@ -160,22 +214,55 @@ namespace Echo
 		shared_ptr<Formatter> mFormatter;
 		std::string mFormat;
 		mutable unique_ptr<Mutex> mMutex;
+		class AsynchronousBackend;
+		unique_ptr<AsynchronousBackend> mAsynchronousBackend;
+		std::atomic<bool> mAsynchronous;
 	};
 	
 	extern Logger gDefaultLogger;
 
 #define ECHO_LOG_(level,file,line,message)\
 	do{\
-		std::stringstream ss;\
-		ss << message;\
-		Echo::gDefaultLogger.Log(level,file,line,ss.str());\
+		if(Echo::gDefaultLogger.IsLogLevelEnabled(level))\
+		{\
+			std::stringstream ss;\
+			ss << message;\
+			Echo::gDefaultLogger.Log(level,file,line,ss.str());\
+		}\
 	}while(false)
 
+// Levels that are not in ECHO_LOG_COMPILE_TIME_MASK are compiled out, including evaluation of the message. The values
+// are the same as Logger::LogLevels, for example -DECHO_LOG_COMPILE_TIME_MASK=3 keeps only errors and warnings.
+#ifndef ECHO_LOG_COMPILE_TIME_MASK
+#define ECHO_LOG_COMPILE_TIME_MASK 0xF
+#endif
+
+#if (ECHO_LOG_COMPILE_TIME_MASK & 8)
 #define ECHO_LOG_DEBUG(message) ECHO_LOG_(Echo::Logger::LogLevels::DEBUG, __FILE__, __LINE__, message)
+#else
+#define ECHO_LOG_DEBUG(message) do{}while(false)
+#endif
+#if (ECHO_LOG_COMPILE_TIME_MASK & 1)
 #define ECHO_LOG_ERROR(message) ECHO_LOG_(Echo::Logger::LogLevels::ERROR, __FILE__, __LINE__, message)
+#else
+#define ECHO_LOG_ERROR(message) do{}while(false)
+#endif
+#if (ECHO_LOG_COMPILE_TIME_MASK & 2)
 #define ECHO_LOG_WARNING(message) ECHO_LOG_(Echo::Logger::LogLevels::WARNING, __FILE__, __LINE__, message)
+#else
+#define ECHO_LOG_WARNING(message) do{}while(false)
+#endif
+#if (ECHO_LOG_COMPILE_TIME_MASK & 4)
 #define ECHO_LOG_INFO(message) ECHO_LOG_(Echo::Logger::LogLevels::INFO, __FILE__, __LINE__, message)
-#define ECHO_LOG(label,message) ECHO_LOG_(std::string(label), __FILE__, __LINE__, message)
+#else
+#define ECHO_LOG_INFO(message) do{}while(false)
+#endif
+#define ECHO_LOG(label,message)\
+	do{\
+		std::stringstream ss;\
+		ss << message;\
+		Echo::gDefaultLogger.Log(std::string(label),__FILE__,__LINE__,ss.str());\
+	}while(false)
 }
 
 #endif
@@ -506,6 +506,16 @@ namespace Echo
 
 			SetExtents(newCentre - newHalfSize, newCentre + newHalfSize);
 		}
+
+		/** Transforms an array of boxes according to the affine matrix supplied.
+		@remarks
+		The results are the same as calling TransformAffine() on a copy of each box but the matrix is
+		only prepared once and the boxes are transformed with SIMD maths when it is enabled. input and
+		output may be the same array.
+		@note
+		The matrix must be an affine matrix. @see Matrix4::IsAffine.
+		 */
+		static void TransformAffine(const Matrix4& m, const AxisAlignedBox* input, AxisAlignedBox* output, Size count);
 		
 		inline void Translate(const Vector3& byAmount)
 		{
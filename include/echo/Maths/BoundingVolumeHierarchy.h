@@ -0,0 +1,639 @@
+#ifndef _ECHO_BOUNDINGVOLUMEHIERARCHY_H_
+#define _ECHO_BOUNDINGVOLUMEHIERARCHY_H_
+#include <echo/Types.h>
+#include <echo/Maths/AxisAlignedBox.h>
+#include <echo/Maths/Ray.h>
+#include <algorithm>
+#include <vector>
+
+namespace Echo
+{
+	/**
+	 * Result of a containment test between a volume and a box.
+	 */
+	struct Containments
+	{
+		enum _
+		{
+			OUTSIDE,	//!< The box is completely outside of the volume.
+			PARTIAL,	//!< The box is partially inside the volume.
+			INSIDE		//!< The box is completely inside the volume.
+		};
+	};
+	typedef Containments::_ Containment;
+
+	/**
+	 * A dynamic bounding volume hierarchy of axis aligned boxes.
+	 * Each item is stored in a leaf along with a "fat" box, which is the box the item was inserted with expanded
+	 * by a margin. Internal nodes bound their two children and the tree is kept balanced with rotations as items
+	 * are inserted and removed. New leaves are placed next to the sibling that results in the smallest increase
+	 * in surface area.
+	 *
+	 * Moving an item only restructures the tree when the item's new box is no longer contained by its fat box,
+	 * which means items that move a small amount each frame are cheap to update.
+	 *
+	 * Queries return items whose fat boxes pass the query, so results are conservative and callers that need
+	 * exact results should test their own bounds.
+	 *
+	 * Nodes store their boxes as minimum and maximum points rather than AxisAlignedBoxes to keep the nodes small
+	 * and the tests during traversal cheap.
+	 * @note T is copied into the nodes, it is intended to be used with pointers or small handles.
+	 */
+	template< typename T >
+	class BoundingVolumeHierarchy
+	{
+	public:
+		typedef s32 ProxyID;
+		static const ProxyID INVALID_PROXY = -1;
+
+		/**
+		 * Constructor
+		 * @param fatMargin The fraction of each box's size to expand the box by on each side when it is stored.
+		 * Larger margins mean fewer updates to the tree for moving items but less precise queries.
+		 */
+		BoundingVolumeHierarchy(f32 fatMargin = 0.1f) : mRoot(INVALID_PROXY), mFreeList(INVALID_PROXY), mNumberOfItems(0), mFatMargin(fatMargin)
+		{
+		}
+
+		/**
+		 * Insert an item into the hierarchy.
+		 * @param box The bounds of the item, this needs to be a finite box.
+		 * @param item The item.
+		 * @return A proxy that identifies the item in the hierarchy, or INVALID_PROXY if the box is not finite.
+		 */
+		ProxyID Insert(const AxisAlignedBox& box, T item)
+		{
+			if(!box.IsFinite())
+			{
+				return INVALID_PROXY;
+			}
+			ProxyID proxy = AllocateNode();
+			TreeNode& node = mNodes[proxy];
+			node.mBounds = Fatten(box);
+			node.mItem = item;
+			node.mHeight = 0;
+			InsertLeaf(proxy);
+			++mNumberOfItems;
+			return proxy;
+		}
+
+		/**
+		 * Remove an item from the hierarchy.
+		 * @param proxy The proxy returned by Insert().
+		 */
+		void Remove(ProxyID proxy)
+		{
+			if(!IsValidLeaf(proxy))
+			{
+				return;
+			}
+			RemoveLeaf(proxy);
+			FreeNode(proxy);
+			--mNumberOfItems;
+		}
+
+		/**
+		 * Update the bounds of an item.
+		 * @param proxy The proxy returned by Insert().
+		 * @param box The new bounds of the item, this needs to be a finite box.
+		 * @return true if the tree was restructured, false if the box was still contained by the item's fat box
+		 * or the parameters were invalid.
+		 */
+		bool Move(ProxyID proxy, const AxisAlignedBox& box)
+		{
+			if(!IsValidLeaf(proxy) || !box.IsFinite())
+			{
+				return false;
+			}
+			if(mNodes[proxy].mBounds.Contains(box.GetMinimum(), box.GetMaximum()))
+			{
+				return false;
+			}
+			RemoveLeaf(proxy);
+			mNodes[proxy].mBounds = Fatten(box);
+			InsertLeaf(proxy);
+			return true;
+		}
+
+		/**
+		 * Get the item for a proxy.
+		 */
+		const T& GetItem(ProxyID proxy) const
+		{
+			return mNodes[proxy].mItem;
+		}
+
+		/**
+		 * Get the fat box stored for a proxy.
+		 */
+		AxisAlignedBox GetFatBox(ProxyID proxy) const
+		{
+			return AxisAlignedBox(mNodes[proxy].mBounds.mMinimum, mNodes[proxy].mBounds.mMaximum);
+		}
+
+		Size GetNumberOfItems() const
+		{
+			return mNumberOfItems;
+		}
+
+		/**
+		 * Get the height of the tree, 0 if empty and 1 if there is a single item.
+		 */
+		Size GetHeight() const
+		{
+			if(mRoot==INVALID_PROXY)
+			{
+				return 0;
+			}
+			return static_cast<Size>(mNodes[mRoot].mHeight) + 1;
+		}
+
+		/**
+		 * Remove all items.
+		 */
+		void Clear()
+		{
+			mNodes.clear();
+			mRoot = INVALID_PROXY;
+			mFreeList = INVALID_PROXY;
+			mNumberOfItems = 0;
+		}
+
+		/**
+		 * Find items using a containment test.
+		 * The test is called for nodes of the hierarchy. Subtrees that are OUTSIDE are skipped and subtrees that are
+		 * INSIDE have all of their items reported without any further tests.
+		 * @param containmentTest Function object with the signature Containment(const Vector3& minimum, const Vector3& maximum).
+		 * @param callback Function object with the signature void(const T&), called for each item found.
+		 */
+		template< typename ContainmentTest, typename Callback >
+		void Query(ContainmentTest containmentTest, Callback callback) const
+		{
+			if(mRoot==INVALID_PROXY)
+			{
+				return;
+			}
+			std::vector<ProxyID> stack;
+			stack.reserve(64);
+			stack.push_back(mRoot);
+			while(!stack.empty())
+			{
+				ProxyID index = stack.back();
+				stack.pop_back();
+				const TreeNode& node = mNodes[index];
+				Containment containment = containmentTest(node.mBounds.mMinimum, node.mBounds.mMaximum);
+				if(containment==Containments::OUTSIDE)
+				{
+					continue;
+				}
+				if(containment==Containments::INSIDE)
+				{
+					ReportAll(index, callback);
+					continue;
+				}
+				if(node.IsLeaf())
+				{
+					callback(node.mItem);
+				}else
+				{
+					stack.push_back(node.mLeft);
+					stack.push_back(node.mRight);
+				}
+			}
+		}
+
+		/**
+		 * Find items whose fat boxes intersect a region.
+		 * @param region The region to search.
+		 * @param callback Function object with the signature void(const T&), called for each item found.
+		 */
+		template< typename Callback >
+		void Query(const AxisAlignedBox& region, Callback callback) const
+		{
+			if(!region.IsFinite())
+			{
+				if(region.IsInfinite())
+				{
+					Query([](const Vector3&, const Vector3&){return Containments::INSIDE;}, callback);
+				}
+				return;
+			}
+			const Bounds regionBounds(region.GetMinimum(), region.GetMaximum());
+			Query([&regionBounds](const Vector3& minimum, const Vector3& maximum) -> Containment
+			{
+				if(!regionBounds.Intersects(minimum, maximum))
+				{
+					return Containments::OUTSIDE;
+				}
+				return regionBounds.Contains(minimum, maximum) ? Containments::INSIDE : Containments::PARTIAL;
+			}, callback);
+		}
+
+		/**
+		 * Find items whose fat boxes are hit by a ray.
+		 * Nodes are skipped if the ray enters them further than the current maximum distance. The callback returns
+		 * the new maximum distance which allows a closest hit search to cull the remaining nodes as it goes.
+		 * @param ray The ray.
+		 * @param maxDistance The maximum distance along the ray to search.
+		 * @param callback Function object with the signature f32(const T&, f32 maxDistance), called for each item
+		 * found. The callback should return maxDistance to continue the search unchanged or a smaller distance to
+		 * limit the remaining search.
+		 */
+		template< typename Callback >
+		void RayCast(const Ray& ray, f32 maxDistance, Callback callback) const
+		{
+			if(mRoot==INVALID_PROXY)
+			{
+				return;
+			}
+			const Vector3& origin = ray.GetOrigin();
+			const Vector3& direction = ray.GetDirection();
+			const Vector3 inverseDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+			std::vector<ProxyID> stack;
+			stack.reserve(64);
+			stack.push_back(mRoot);
+			while(!stack.empty())
+			{
+				ProxyID index = stack.back();
+				stack.pop_back();
+				const TreeNode& node = mNodes[index];
+				f32 distance;
+				if(!node.mBounds.IntersectsRay(origin, inverseDirection, distance) || distance > maxDistance)
+				{
+					continue;
+				}
+				if(node.IsLeaf())
+				{
+					maxDistance = callback(node.mItem, maxDistance);
+				}else
+				{
+					stack.push_back(node.mLeft);
+					stack.push_back(node.mRight);
+				}
+			}
+		}
+	private:
+		struct Bounds
+		{
+			Bounds(){}
+			Bounds(const Vector3& minimum, const Vector3& maximum) : mMinimum(minimum), mMaximum(maximum){}
+			inline bool Contains(const Vector3& minimum, const Vector3& maximum) const
+			{
+				return mMinimum.x <= minimum.x && mMinimum.y <= minimum.y && mMinimum.z <= minimum.z &&
+					maximum.x <= mMaximum.x && maximum.y <= mMaximum.y && maximum.z <= mMaximum.z;
+			}
+			inline bool Intersects(const Vector3& minimum, const Vector3& maximum) const
+			{
+				return mMinimum.x <= maximum.x && mMinimum.y <= maximum.y && mMinimum.z <= maximum.z &&
+					minimum.x <= mMaximum.x && minimum.y <= mMaximum.y && minimum.z <= mMaximum.z;
+			}
+			/**
+			 * Slab test. Distance is 0 if the origin is inside the bounds.
+			 */
+			inline bool IntersectsRay(const Vector3& origin, const Vector3& inverseDirection, f32& distanceOut) const
+			{
+				f32 tx1 = (mMinimum.x - origin.x) * inverseDirection.x;
+				f32 tx2 = (mMaximum.x - origin.x) * inverseDirection.x;
+				f32 ty1 = (mMinimum.y - origin.y) * inverseDirection.y;
+				f32 ty2 = (mMaximum.y - origin.y) * inverseDirection.y;
+				f32 tz1 = (mMinimum.z - origin.z) * inverseDirection.z;
+				f32 tz2 = (mMaximum.z - origin.z) * inverseDirection.z;
+				// NaNs, from an origin on a slab with a zero direction component, are ignored by the argument order.
+				f32 tMinimum = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::min(tz1, tz2));
+				f32 tMaximum = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::max(tz1, tz2));
+				tMinimum = std::max(tMinimum, 0.f);
+				if(tMaximum < tMinimum)
+				{
+					return false;
+				}
+				distanceOut = tMinimum;
+				return true;
+			}
+			inline Bounds Combine(const Bounds& other) const
+			{
+				return Bounds(Vector3(std::min(mMinimum.x, other.mMinimum.x), std::min(mMinimum.y, other.mMinimum.y), std::min(mMinimum.z, other.mMinimum.z)),
+							Vector3(std::max(mMaximum.x, other.mMaximum.x), std::max(mMaximum.y, other.mMaximum.y), std::max(mMaximum.z, other.mMaximum.z)));
+			}
+			inline f32 GetSurfaceArea() const
+			{
+				Vector3 size = mMaximum - mMinimum;
+				return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+			}
+			Vector3 mMinimum;
+			Vector3 mMaximum;
+		};
+
+		struct TreeNode
+		{
+			TreeNode() : mParent(INVALID_PROXY), mLeft(INVALID_PROXY), mRight(INVALID_PROXY), mHeight(-1), mItem()
+			{
+			}
+			inline bool IsLeaf() const
+			{
+				return mLeft==INVALID_PROXY;
+			}
+			Bounds mBounds;
+			ProxyID mParent;	//!< The next free node when the node is in the free list.
+			ProxyID mLeft;
+			ProxyID mRight;
+			s32 mHeight;		//!< 0 for leaves, -1 for free nodes.
+			T mItem;
+		};
+
+		inline bool IsValidLeaf(ProxyID proxy) const
+		{
+			return proxy >= 0 && static_cast<Size>(proxy) < mNodes.size() && mNodes[proxy].mHeight==0;
+		}
+
+		Bounds Fatten(const AxisAlignedBox& box) const
+		{
+			Vector3 margin = (box.GetMaximum() - box.GetMinimum()) * mFatMargin;
+			return Bounds(box.GetMinimum() - margin, box.GetMaximum() + margin);
+		}
+
+		template< typename Callback >
+		void ReportAll(ProxyID subtreeRoot, Callback& callback) const
+		{
+			std::vector<ProxyID> stack;
+			stack.reserve(64);
+			stack.push_back(subtreeRoot);
+			while(!stack.empty())
+			{
+				const TreeNode& node = mNodes[stack.back()];
+				stack.pop_back();
+				if(node.IsLeaf())
+				{
+					callback(node.mItem);
+				}else
+				{
+					stack.push_back(node.mLeft);
+					stack.push_back(node.mRight);
+				}
+			}
+		}
+
+		ProxyID AllocateNode()
+		{
+			if(mFreeList==INVALID_PROXY)
+			{
+				mNodes.push_back(TreeNode());
+				return static_cast<ProxyID>(mNodes.size() - 1);
+			}
+			ProxyID index = mFreeList;
+			mFreeList = mNodes[index].mParent;
+			mNodes[index] = TreeNode();
+			return index;
+		}
+
+		void FreeNode(ProxyID index)
+		{
+			TreeNode& node = mNodes[index];
+			node.mParent = mFreeList;
+			node.mLeft = INVALID_PROXY;
+			node.mRight = INVALID_PROXY;
+			node.mHeight = -1;
+			node.mItem = T();
+			mFreeList = index;
+		}
+
+		void InsertLeaf(ProxyID leaf)
+		{
+			if(mRoot==INVALID_PROXY)
+			{
+				mRoot = leaf;
+				mNodes[leaf].mParent = INVALID_PROXY;
+				return;
+			}
+
+			// Find the best sibling by descending towards the child that results in the smallest cost.
+			Bounds leafBounds = mNodes[leaf].mBounds;
+			ProxyID index = mRoot;
+			while(!mNodes[index].IsLeaf())
+			{
+				const TreeNode& node = mNodes[index];
+				f32 area = node.mBounds.GetSurfaceArea();
+				f32 combinedArea = node.mBounds.Combine(leafBounds).GetSurfaceArea();
+
+				// Cost of creating a new parent for this node and the new leaf.
+				f32 cost = 2.f * combinedArea;
+
+				// Minimum cost of pushing the leaf further down the tree.
+				f32 inheritanceCost = 2.f * (combinedArea - area);
+				f32 leftCost = GetDescendCost(node.mLeft, leafBounds) + inheritanceCost;
+				f32 rightCost = GetDescendCost(node.mRight, leafBounds) + inheritanceCost;
+
+				if(cost < leftCost && cost < rightCost)
+				{
+					break;
+				}
+				index = (leftCost < rightCost) ? node.mLeft : node.mRight;
+			}
+
+			ProxyID sibling = index;
+			ProxyID oldParent = mNodes[sibling].mParent;
+			ProxyID newParent = AllocateNode();
+			{
+				TreeNode& parentNode = mNodes[newParent];
+				parentNode.mParent = oldParent;
+				parentNode.mBounds = leafBounds.Combine(mNodes[sibling].mBounds);
+				parentNode.mHeight = mNodes[sibling].mHeight + 1;
+				parentNode.mLeft = sibling;
+				parentNode.mRight = leaf;
+			}
+			if(oldParent!=INVALID_PROXY)
+			{
+				TreeNode& oldParentNode = mNodes[oldParent];
+				if(oldParentNode.mLeft==sibling)
+				{
+					oldParentNode.mLeft = newParent;
+				}else
+				{
+					oldParentNode.mRight = newParent;
+				}
+			}else
+			{
+				mRoot = newParent;
+			}
+			mNodes[sibling].mParent = newParent;
+			mNodes[leaf].mParent = newParent;
+
+			Refit(mNodes[leaf].mParent);
+		}
+
+		f32 GetDescendCost(ProxyID index, const Bounds& leafBounds) const
+		{
+			const TreeNode& node = mNodes[index];
+			f32 combinedArea = leafBounds.Combine(node.mBounds).GetSurfaceArea();
+			if(node.IsLeaf())
+			{
+				return combinedArea;
+			}
+			return combinedArea - node.mBounds.GetSurfaceArea();
+		}
+
+		void RemoveLeaf(ProxyID leaf)
+		{
+			if(leaf==mRoot)
+			{
+				mRoot = INVALID_PROXY;
+				return;
+			}
+			ProxyID parent = mNodes[leaf].mParent;
+			ProxyID grandParent = mNodes[parent].mParent;
+			ProxyID sibling = (mNodes[parent].mLeft==leaf) ? mNodes[parent].mRight : mNodes[parent].mLeft;
+
+			if(grandParent!=INVALID_PROXY)
+			{
+				// Replace the parent with the sibling.
+				TreeNode& grandParentNode = mNodes[grandParent];
+				if(grandParentNode.mLeft==parent)
+				{
+					grandParentNode.mLeft = sibling;
+				}else
+				{
+					grandParentNode.mRight = sibling;
+				}
+				mNodes[sibling].mParent = grandParent;
+				FreeNode(parent);
+				Refit(grandParent);
+			}else
+			{
+				mRoot = sibling;
+				mNodes[sibling].mParent = INVALID_PROXY;
+				FreeNode(parent);
+			}
+			mNodes[leaf].mParent = INVALID_PROXY;
+		}
+
+		/**
+		 * Walk up the tree from index, balancing and recalculating the boxes and heights.
+		 */
+		void Refit(ProxyID index)
+		{
+			while(index!=INVALID_PROXY)
+			{
+				index = Balance(index);
+				TreeNode& node = mNodes[index];
+				const TreeNode& left = mNodes[node.mLeft];
+				const TreeNode& right = mNodes[node.mRight];
+				node.mHeight = 1 + std::max(left.mHeight, right.mHeight);
+				node.mBounds = left.mBounds.Combine(right.mBounds);
+				index = node.mParent;
+			}
+		}
+
+		/**
+		 * Perform a left or right rotation if node A is imbalanced.
+		 * @return the index of the node that is now in A's position.
+		 */
+		ProxyID Balance(ProxyID iA)
+		{
+			TreeNode& a = mNodes[iA];
+			if(a.IsLeaf() || a.mHeight < 2)
+			{
+				return iA;
+			}
+
+			ProxyID iB = a.mLeft;
+			ProxyID iC = a.mRight;
+			TreeNode& b = mNodes[iB];
+			TreeNode& c = mNodes[iC];
+			s32 balance = c.mHeight - b.mHeight;
+
+			if(balance > 1)
+			{
+				// Rotate C up
+				ProxyID iF = c.mLeft;
+				ProxyID iG = c.mRight;
+				TreeNode& f = mNodes[iF];
+				TreeNode& g = mNodes[iG];
+
+				c.mLeft = iA;
+				c.mParent = a.mParent;
+				a.mParent = iC;
+				ReplaceChild(c.mParent, iA, iC);
+
+				if(f.mHeight > g.mHeight)
+				{
+					c.mRight = iF;
+					a.mRight = iG;
+					g.mParent = iA;
+					a.mBounds = b.mBounds.Combine(g.mBounds);
+					c.mBounds = a.mBounds.Combine(f.mBounds);
+					a.mHeight = 1 + std::max(b.mHeight, g.mHeight);
+					c.mHeight = 1 + std::max(a.mHeight, f.mHeight);
+				}else
+				{
+					c.mRight = iG;
+					a.mRight = iF;
+					f.mParent = iA;
+					a.mBounds = b.mBounds.Combine(f.mBounds);
+					c.mBounds = a.mBounds.Combine(g.mBounds);
+					a.mHeight = 1 + std::max(b.mHeight, f.mHeight);
+					c.mHeight = 1 + std::max(a.mHeight, g.mHeight);
+				}
+				return iC;
+			}
+
+			if(balance < -1)
+			{
+				// Rotate B up
+				ProxyID iD = b.mLeft;
+				ProxyID iE = b.mRight;
+				TreeNode& d = mNodes[iD];
+				TreeNode& e = mNodes[iE];
+
+				b.mLeft = iA;
+				b.mParent = a.mParent;
+				a.mParent = iB;
+				ReplaceChild(b.mParent, iA, iB);
+
+				if(d.mHeight > e.mHeight)
+				{
+					b.mRight = iD;
+					a.mLeft = iE;
+					e.mParent = iA;
+					a.mBounds = c.mBounds.Combine(e.mBounds);
+					b.mBounds = a.mBounds.Combine(d.mBounds);
+					a.mHeight = 1 + std::max(c.mHeight, e.mHeight);
+					b.mHeight = 1 + std::max(a.mHeight, d.mHeight);
+				}else
+				{
+					b.mRight = iE;
+					a.mLeft = iD;
+					d.mParent = iA;
+					a.mBounds = c.mBounds.Combine(d.mBounds);
+					b.mBounds = a.mBounds.Combine(e.mBounds);
+					a.mHeight = 1 + std::max(c.mHeight, d.mHeight);
+					b.mHeight = 1 + std::max(a.mHeight, e.mHeight);
+				}
+				return iB;
+			}
+			return iA;
+		}
+
+		void ReplaceChild(ProxyID parent, ProxyID oldChild, ProxyID newChild)
+		{
+			if(parent==INVALID_PROXY)
+			{
+				mRoot = newChild;
+				return;
+			}
+			TreeNode& parentNode = mNodes[parent];
+			if(parentNode.mLeft==oldChild)
+			{
+				parentNode.mLeft = newChild;
+			}else
+			{
+				parentNode.mRight = newChild;
+			}
+		}
+
+		std::vector<TreeNode> mNodes;
+		ProxyID mRoot;
+		ProxyID mFreeList;
+		Size mNumberOfItems;
+		f32 mFatMargin;
+	};
+}
+#endif
@@ -6,6 +6,7 @@
 #include <echo/Maths/Vector4.h>
 #include <echo/Maths/Matrix3.h>
 #include <echo/Maths/Plane.h>
+#include <echo/Maths/SIMD.h>
 
 namespace Echo
 {
@@ -171,6 +172,21 @@ namespace Echo
 		inline Matrix4 Concatenate(const Matrix4 &m2) const
 		{
 			Matrix4 r;
+#ifdef ECHO_MATHS_SIMD
+			// Each row of the result is the rows of m2 weighted by the row of this matrix.
+			SIMD::f32x4 row0 = SIMD::Load(m2.m[0]);
+			SIMD::f32x4 row1 = SIMD::Load(m2.m[1]);
+			SIMD::f32x4 row2 = SIMD::Load(m2.m[2]);
+			SIMD::f32x4 row3 = SIMD::Load(m2.m[3]);
+			for(size_t i = 0; i < 4; ++i)
+			{
+				SIMD::f32x4 row = SIMD::Multiply(SIMD::Splat(m[i][0]), row0);
+				row = SIMD::MultiplyAdd(SIMD::Splat(m[i][1]), row1, row);
+				row = SIMD::MultiplyAdd(SIMD::Splat(m[i][2]), row2, row);
+				row = SIMD::MultiplyAdd(SIMD::Splat(m[i][3]), row3, row);
+				SIMD::Store(r.m[i], row);
+			}
+#else
 			r.m[0][0] = m[0][0] * m2.m[0][0] + m[0][1] * m2.m[1][0] + m[0][2] * m2.m[2][0] + m[0][3] * m2.m[3][0];
 			r.m[0][1] = m[0][0] * m2.m[0][1] + m[0][1] * m2.m[1][1] + m[0][2] * m2.m[2][1] + m[0][3] * m2.m[3][1];
 			r.m[0][2] = m[0][0] * m2.m[0][2] + m[0][1] * m2.m[1][2] + m[0][2] * m2.m[2][2] + m[0][3] * m2.m[3][2];
@@ -190,7 +206,7 @@ namespace Echo
 			r.m[3][1] = m[3][0] * m2.m[0][1] + m[3][1] * m2.m[1][1] + m[3][2] * m2.m[2][1] + m[3][3] * m2.m[3][1];
 			r.m[3][2] = m[3][0] * m2.m[0][2] + m[3][1] * m2.m[1][2] + m[3][2] * m2.m[2][2] + m[3][3] * m2.m[3][2];
 			r.m[3][3] = m[3][0] * m2.m[0][3] + m[3][1] * m2.m[1][3] + m[3][2] * m2.m[2][3] + m[3][3] * m2.m[3][3];
-
+#endif
 			return r;
 		}
 
@@ -597,6 +613,21 @@ namespace Echo
 		{
 			assert(IsAffine() && m2.IsAffine());
 
+#ifdef ECHO_MATHS_SIMD
+			Matrix4 r;
+			SIMD::f32x4 row0 = SIMD::Load(m2.m[0]);
+			SIMD::f32x4 row1 = SIMD::Load(m2.m[1]);
+			SIMD::f32x4 row2 = SIMD::Load(m2.m[2]);
+			for(size_t i = 0; i < 3; ++i)
+			{
+				SIMD::f32x4 row = SIMD::MultiplyAdd(SIMD::Splat(m[i][0]), row0, SIMD::Set(0, 0, 0, m[i][3]));
+				row = SIMD::MultiplyAdd(SIMD::Splat(m[i][1]), row1, row);
+				row = SIMD::MultiplyAdd(SIMD::Splat(m[i][2]), row2, row);
+				SIMD::Store(r.m[i], row);
+			}
+			r.m[3][0] = 0; r.m[3][1] = 0; r.m[3][2] = 0; r.m[3][3] = 1;
+			return r;
+#else
 			return Matrix4(
 				m[0][0] * m2.m[0][0] + m[0][1] * m2.m[1][0] + m[0][2] * m2.m[2][0],
 				m[0][0] * m2.m[0][1] + m[0][1] * m2.m[1][1] + m[0][2] * m2.m[2][1],
@@ -614,6 +645,7 @@ namespace Echo
 				m[2][0] * m2.m[0][3] + m[2][1] * m2.m[1][3] + m[2][2] * m2.m[2][3] + m[2][3],
 
 				0, 0, 0, 1);
+#endif
 		}
 
 		/** 3-D Vector transformation specially for an affine matrix.
@@ -647,6 +679,16 @@ namespace Echo
 				m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + m[2][3] * v.w,
 				v.w);
 		}
+
+		/** 3-D Vector transformation of an array of vectors specially for an affine matrix.
+			@remarks
+				The results are the same as calling TransformAffine() for each vector but the vectors
+				are transformed several at a time when SIMD maths is enabled. input and output may be
+				the same array.
+			@note
+				The matrix must be an affine matrix. @see EMatrix4::IsAffine.
+		 */
+		void TransformAffine(const Vector3* input, Vector3* output, Size count) const;
 	};
 
 	/* Removed from EVector4 and made a non-member here because otherwise
@@ -655,12 +697,22 @@ namespace Echo
 	 */
 	inline Vector4 operator *(const Vector4& v, const Matrix4& mat)
 	{
+#ifdef ECHO_MATHS_SIMD
+		SIMD::f32x4 r = SIMD::Multiply(SIMD::Splat(v.x), SIMD::Load(mat[0]));
+		r = SIMD::MultiplyAdd(SIMD::Splat(v.y), SIMD::Load(mat[1]), r);
+		r = SIMD::MultiplyAdd(SIMD::Splat(v.z), SIMD::Load(mat[2]), r);
+		r = SIMD::MultiplyAdd(SIMD::Splat(v.w), SIMD::Load(mat[3]), r);
+		Vector4 result;
+		SIMD::Store(result.Ptr(), r);
+		return result;
+#else
 		return Vector4(
 			v.x*mat[0][0] + v.y*mat[1][0] + v.z*mat[2][0] + v.w*mat[3][0],
 			v.x*mat[0][1] + v.y*mat[1][1] + v.z*mat[2][1] + v.w*mat[3][1],
 			v.x*mat[0][2] + v.y*mat[1][2] + v.z*mat[2][2] + v.w*mat[3][2],
 			v.x*mat[0][3] + v.y*mat[1][3] + v.z*mat[2][3] + v.w*mat[3][3]
 			);
+#endif
 	}
 	/** @} */
 	/** @} */
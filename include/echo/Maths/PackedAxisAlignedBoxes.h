@@ -0,0 +1,183 @@
+#ifndef _ECHO_PACKEDAXISALIGNEDBOXES_H_
+#define _ECHO_PACKEDAXISALIGNEDBOXES_H_
+
+#include <echo/Maths/AxisAlignedBox.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Echo
+{
+	/**
+	 * An array of axis aligned boxes stored as separate arrays of centre and half size components.
+	 *
+	 * This layout allows operations such as Frustum::IsVisible() to process several boxes at once with SIMD
+	 * instructions. The arrays are padded to a multiple of PADDING entries with null boxes so batch operations
+	 * don't need to handle a remainder.
+	 *
+	 * Null and infinite boxes are stored with a zero centre and a half size of -max or +max f32. This means they
+	 * are always outside or inside a plane without needing to be treated as special cases. GetBox() does not
+	 * reconstruct these extents.
+	 */
+	class PackedAxisAlignedBoxes
+	{
+	public:
+		static const Size PADDING = 8;
+
+		PackedAxisAlignedBoxes() : mSize(0)
+		{
+		}
+
+		/**
+		 * Remove all of the boxes.
+		 * @note The memory is not released.
+		 */
+		void Clear()
+		{
+			mSize = 0;
+			for(Size c = 0; c < 3; ++c)
+			{
+				mCentre[c].resize(0);
+				mHalfSize[c].resize(0);
+			}
+		}
+
+		/**
+		 * Reserve memory for the number of boxes.
+		 */
+		void Reserve(Size count)
+		{
+			Size padded = GetPaddedSize(count);
+			for(Size c = 0; c < 3; ++c)
+			{
+				mCentre[c].reserve(padded);
+				mHalfSize[c].reserve(padded);
+			}
+		}
+
+		/**
+		 * Resize the array, new boxes are null.
+		 */
+		void Resize(Size count)
+		{
+			Size padded = GetPaddedSize(count);
+			for(Size c = 0; c < 3; ++c)
+			{
+				// Clear the existing padding first so it gets reset to null.
+				mCentre[c].resize(std::min(mSize, count));
+				mHalfSize[c].resize(std::min(mSize, count));
+				mCentre[c].resize(padded, 0.f);
+				mHalfSize[c].resize(padded, -std::numeric_limits<f32>::max());
+			}
+			mSize = count;
+		}
+
+		/**
+		 * Add a box to the end of the array.
+		 * @return The index of the box.
+		 */
+		Size Add(const AxisAlignedBox& box)
+		{
+			Size index = mSize;
+			Resize(mSize + 1);
+			Set(index, box);
+			return index;
+		}
+
+		/**
+		 * Set the box at the index, which must be less than GetSize().
+		 */
+		void Set(Size index, const AxisAlignedBox& box)
+		{
+			if(box.IsFinite())
+			{
+				const Vector3& minimum = box.GetMinimum();
+				const Vector3& maximum = box.GetMaximum();
+				Set(index, (minimum + maximum) * 0.5f, (maximum - minimum) * 0.5f);
+			}else
+			{
+				f32 halfSize = box.IsInfinite() ? std::numeric_limits<f32>::max() : -std::numeric_limits<f32>::max();
+				Set(index, Vector3::ZERO, Vector3(halfSize, halfSize, halfSize));
+			}
+		}
+
+		/**
+		 * Set the box at the index, which must be less than GetSize().
+		 */
+		void Set(Size index, const Vector3& centre, const Vector3& halfSize)
+		{
+			mCentre[0][index] = centre.x;
+			mCentre[1][index] = centre.y;
+			mCentre[2][index] = centre.z;
+			mHalfSize[0][index] = halfSize.x;
+			mHalfSize[1][index] = halfSize.y;
+			mHalfSize[2][index] = halfSize.z;
+		}
+
+		/**
+		 * Get the box at the index, which must be less than GetSize().
+		 */
+		AxisAlignedBox GetBox(Size index) const
+		{
+			Vector3 centre = GetCentre(index);
+			Vector3 halfSize = GetHalfSize(index);
+			return AxisAlignedBox(centre - halfSize, centre + halfSize);
+		}
+
+		Vector3 GetCentre(Size index) const
+		{
+			return Vector3(mCentre[0][index], mCentre[1][index], mCentre[2][index]);
+		}
+
+		Vector3 GetHalfSize(Size index) const
+		{
+			return Vector3(mHalfSize[0][index], mHalfSize[1][index], mHalfSize[2][index]);
+		}
+
+		/**
+		 * Get the number of boxes.
+		 */
+		Size GetSize() const
+		{
+			return mSize;
+		}
+
+		/**
+		 * Get the number of entries in each component array, which is GetSize() rounded up to a multiple of PADDING.
+		 */
+		Size GetPaddedSize() const
+		{
+			return GetPaddedSize(mSize);
+		}
+
+		/**
+		 * Get the array for a component of the centres.
+		 * @param component 0, 1 or 2 for x, y and z.
+		 * @return An array of GetPaddedSize() values.
+		 */
+		const f32* GetCentres(Size component) const
+		{
+			return mCentre[component].data();
+		}
+
+		/**
+		 * Get the array for a component of the half sizes.
+		 * @param component 0, 1 or 2 for x, y and z.
+		 * @return An array of GetPaddedSize() values.
+		 */
+		const f32* GetHalfSizes(Size component) const
+		{
+			return mHalfSize[component].data();
+		}
+	private:
+		static Size GetPaddedSize(Size count)
+		{
+			return (count + PADDING - 1) / PADDING * PADDING;
+		}
+		Size mSize;
+		std::vector<f32> mCentre[3];
+		std::vector<f32> mHalfSize[3];
+	};
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include <echo/Maths/Vector3.h>
 #include <echo/Maths/Matrix3.h>
 #include <echo/Util/StringUtils.h>
+#include <echo/Maths/SIMD.h>
 #include <ostream>
 #include <assert.h>
 
@@ -311,5 +312,38 @@ namespace Echo
 			return i;
 		}
 	};
+
+#ifdef ECHO_MATHS_SIMD
+	static_assert(sizeof(Quaternion)==sizeof(f32) * 4, "Quaternions are accessed as w, x, y, z f32 vectors");
+#endif
+
+	inline Quaternion Quaternion::operator*(const Quaternion& rkQ) const
+	{
+		// NOTE:  Multiplication is not generally commutative, so in most
+		// cases p*q != q*p.
+
+#ifdef ECHO_MATHS_SIMD
+		// The components are in w, x, y, z order. The terms for each component are arranged with shuffles
+		// so each column below is one term of the scalar version.
+		SIMD::f32x4 p = SIMD::Load(&w);
+		SIMD::f32x4 q = SIMD::Load(&rkQ.w);
+		SIMD::f32x4 terms = SIMD::Multiply(SIMD::Shuffle<1, 1, 2, 3>(p), SIMD::Shuffle<1, 0, 0, 0>(q));
+		terms = SIMD::MultiplyAdd(SIMD::Shuffle<2, 2, 3, 1>(p), SIMD::Shuffle<2, 3, 1, 2>(q), terms);
+		terms = SIMD::Multiply(terms, SIMD::Set(-1.0f, 1.0f, 1.0f, 1.0f));
+		terms = SIMD::MultiplyAdd(SIMD::Splat(w), q, terms);
+		terms = SIMD::Subtract(terms, SIMD::Multiply(SIMD::Shuffle<3, 3, 1, 2>(p), SIMD::Shuffle<3, 2, 3, 1>(q)));
+		Quaternion result;
+		SIMD::Store(&result.w, terms);
+		return result;
+#else
+		return Quaternion
+		(
+			w * rkQ.x + x * rkQ.w + y * rkQ.z - z * rkQ.y,
+			w * rkQ.y + y * rkQ.w + z * rkQ.x - x * rkQ.z,
+			w * rkQ.z + z * rkQ.w + x * rkQ.y - y * rkQ.x,
+			w * rkQ.w - x * rkQ.x - y * rkQ.y - z * rkQ.z
+		);
+#endif
+	}
 }
 #endif 
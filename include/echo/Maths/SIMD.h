@@ -0,0 +1,235 @@
+#ifndef _ECHO_SIMD_H_
+#define _ECHO_SIMD_H_
+
+#include <echo/Types.h>
+
+// ECHO_SIMD_MATHS_ENABLED is defined by the build when ECHO_SIMD_MATHS selects an instruction set. The maths
+// types only use the functions below if the compiler is also targeting a supported instruction set, otherwise
+// they use their scalar implementations. ECHO_MATHS_SIMD is defined when the functions are available.
+#ifdef ECHO_SIMD_MATHS_ENABLED
+	#if defined(__SSE4_1__)
+		#include <smmintrin.h>
+		#ifdef __FMA__
+			#include <immintrin.h>
+		#endif
+		#define ECHO_MATHS_SIMD
+		#define ECHO_MATHS_SIMD_SSE
+	#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+		#include <arm_neon.h>
+		#define ECHO_MATHS_SIMD
+		#define ECHO_MATHS_SIMD_NEON
+	#endif
+#endif
+
+#ifdef ECHO_MATHS_SIMD
+namespace Echo
+{
+	/**
+	 * A minimal set of four component f32 operations used to implement the maths types.
+	 *
+	 * Each function maps to one or a few instructions for each instruction set so the maths types can be
+	 * written once. Loads and stores do not require alignment since the maths types are not aligned.
+	 */
+	namespace SIMD
+	{
+#ifdef ECHO_MATHS_SIMD_SSE
+		typedef __m128 f32x4;
+
+		inline f32x4 Load(const f32* values) { return _mm_loadu_ps(values); }
+		inline void Store(f32* values, f32x4 v) { _mm_storeu_ps(values, v); }
+		inline f32x4 Set(f32 x, f32 y, f32 z, f32 w) { return _mm_setr_ps(x, y, z, w); }
+		inline f32x4 Splat(f32 value) { return _mm_set1_ps(value); }
+		inline f32x4 Add(f32x4 a, f32x4 b) { return _mm_add_ps(a, b); }
+		inline f32x4 Subtract(f32x4 a, f32x4 b) { return _mm_sub_ps(a, b); }
+		inline f32x4 Multiply(f32x4 a, f32x4 b) { return _mm_mul_ps(a, b); }
+		inline f32x4 Min(f32x4 a, f32x4 b) { return _mm_min_ps(a, b); }
+		inline f32x4 Max(f32x4 a, f32x4 b) { return _mm_max_ps(a, b); }
+		inline f32x4 Abs(f32x4 v) { return _mm_andnot_ps(_mm_set1_ps(-0.f), v); }
+		inline f32 GetX(f32x4 v) { return _mm_cvtss_f32(v); }
+
+		/**
+		 * Compare each component, bit n of the result is set if component n of a is less than b.
+		 */
+		inline u32 LessMask(f32x4 a, f32x4 b)
+		{
+			return static_cast<u32>(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+		}
+
+		/**
+		 * Calculate a * b + c, fused if the instruction set supports it.
+		 */
+		inline f32x4 MultiplyAdd(f32x4 a, f32x4 b, f32x4 c)
+		{
+	#ifdef __FMA__
+			return _mm_fmadd_ps(a, b, c);
+	#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+	#endif
+		}
+
+		/**
+		 * Dot product of all four components.
+		 */
+		inline f32 Dot4(f32x4 a, f32x4 b)
+		{
+			return _mm_cvtss_f32(_mm_dp_ps(a, b, 0xF1));
+		}
+
+		/**
+		 * Rearrange the components, each template parameter is the index of the source component.
+		 */
+		template< u32 X, u32 Y, u32 Z, u32 W >
+		inline f32x4 Shuffle(f32x4 v)
+		{
+			return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+		}
+
+		inline void Transpose(f32x4& r0, f32x4& r1, f32x4& r2, f32x4& r3)
+		{
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		}
+
+		/**
+		 * Load four consecutive x, y, z triples and separate the components.
+		 */
+		inline void LoadVector3x4(const f32* values, f32x4& x, f32x4& y, f32x4& z)
+		{
+			f32x4 a = _mm_loadu_ps(values);			// x0 y0 z0 x1
+			f32x4 b = _mm_loadu_ps(values + 4);		// y1 z1 x2 y2
+			f32x4 c = _mm_loadu_ps(values + 8);		// z2 x3 y3 z3
+			f32x4 a2a3b1b2 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 1, 3, 2));
+			f32x4 b1b2c0c1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 2, 1));
+			f32x4 a1a1b0b0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+			f32x4 b3b3c2c2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+			x = _mm_shuffle_ps(a, b1b2c0c1, _MM_SHUFFLE(3, 1, 3, 0));
+			y = _mm_shuffle_ps(a1a1b0b0, b3b3c2c2, _MM_SHUFFLE(2, 0, 2, 0));
+			z = _mm_shuffle_ps(a2a3b1b2, c, _MM_SHUFFLE(3, 0, 2, 0));
+		}
+
+		/**
+		 * Interleave the components and store them as four consecutive x, y, z triples.
+		 */
+		inline void StoreVector3x4(f32* values, f32x4 x, f32x4 y, f32x4 z)
+		{
+			f32x4 x0x0y0y0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+			f32x4 z0z0x1x1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+			f32x4 y1y1z1z1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+			f32x4 x2x2y2y2 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+			f32x4 z2z2x3x3 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+			f32x4 y3y3z3z3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+			_mm_storeu_ps(values, _mm_shuffle_ps(x0x0y0y0, z0z0x1x1, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(values + 4, _mm_shuffle_ps(y1y1z1z1, x2x2y2y2, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(values + 8, _mm_shuffle_ps(z2z2x3x3, y3y3z3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+		}
+#endif
+
+#ifdef ECHO_MATHS_SIMD_NEON
+		typedef float32x4_t f32x4;
+
+		inline f32x4 Load(const f32* values) { return vld1q_f32(values); }
+		inline void Store(f32* values, f32x4 v) { vst1q_f32(values, v); }
+		inline f32x4 Set(f32 x, f32 y, f32 z, f32 w)
+		{
+			const f32 values[4] = {x, y, z, w};
+			return vld1q_f32(values);
+		}
+		inline f32x4 Splat(f32 value) { return vdupq_n_f32(value); }
+		inline f32x4 Add(f32x4 a, f32x4 b) { return vaddq_f32(a, b); }
+		inline f32x4 Subtract(f32x4 a, f32x4 b) { return vsubq_f32(a, b); }
+		inline f32x4 Multiply(f32x4 a, f32x4 b) { return vmulq_f32(a, b); }
+		inline f32x4 Min(f32x4 a, f32x4 b) { return vminq_f32(a, b); }
+		inline f32x4 Max(f32x4 a, f32x4 b) { return vmaxq_f32(a, b); }
+		inline f32x4 Abs(f32x4 v) { return vabsq_f32(v); }
+		inline f32 GetX(f32x4 v) { return vgetq_lane_f32(v, 0); }
+
+		/**
+		 * Compare each component, bit n of the result is set if component n of a is less than b.
+		 */
+		inline u32 LessMask(f32x4 a, f32x4 b)
+		{
+			const u32 bits[4] = {1, 2, 4, 8};
+			uint32x4_t mask = vandq_u32(vcltq_f32(a, b), vld1q_u32(bits));
+	#ifdef __aarch64__
+			return vaddvq_u32(mask);
+	#else
+			uint32x2_t sum = vadd_u32(vget_low_u32(mask), vget_high_u32(mask));
+			return vget_lane_u32(vpadd_u32(sum, sum), 0);
+	#endif
+		}
+
+		/**
+		 * Calculate a * b + c, fused if the instruction set supports it.
+		 */
+		inline f32x4 MultiplyAdd(f32x4 a, f32x4 b, f32x4 c)
+		{
+	#ifdef __aarch64__
+			return vfmaq_f32(c, a, b);
+	#else
+			return vmlaq_f32(c, a, b);
+	#endif
+		}
+
+		/**
+		 * Dot product of all four components.
+		 */
+		inline f32 Dot4(f32x4 a, f32x4 b)
+		{
+			f32x4 products = vmulq_f32(a, b);
+	#ifdef __aarch64__
+			return vaddvq_f32(products);
+	#else
+			float32x2_t sum = vadd_f32(vget_low_f32(products), vget_high_f32(products));
+			return vget_lane_f32(vpadd_f32(sum, sum), 0);
+	#endif
+		}
+
+		/**
+		 * Rearrange the components, each template parameter is the index of the source component.
+		 */
+		template< u32 X, u32 Y, u32 Z, u32 W >
+		inline f32x4 Shuffle(f32x4 v)
+		{
+			f32x4 r = vdupq_n_f32(vgetq_lane_f32(v, X));
+			r = vsetq_lane_f32(vgetq_lane_f32(v, Y), r, 1);
+			r = vsetq_lane_f32(vgetq_lane_f32(v, Z), r, 2);
+			return vsetq_lane_f32(vgetq_lane_f32(v, W), r, 3);
+		}
+
+		inline void Transpose(f32x4& r0, f32x4& r1, f32x4& r2, f32x4& r3)
+		{
+			float32x4x2_t r01 = vtrnq_f32(r0, r1);
+			float32x4x2_t r23 = vtrnq_f32(r2, r3);
+			r0 = vcombine_f32(vget_low_f32(r01.val[0]), vget_low_f32(r23.val[0]));
+			r1 = vcombine_f32(vget_low_f32(r01.val[1]), vget_low_f32(r23.val[1]));
+			r2 = vcombine_f32(vget_high_f32(r01.val[0]), vget_high_f32(r23.val[0]));
+			r3 = vcombine_f32(vget_high_f32(r01.val[1]), vget_high_f32(r23.val[1]));
+		}
+
+		/**
+		 * Load four consecutive x, y, z triples and separate the components.
+		 */
+		inline void LoadVector3x4(const f32* values, f32x4& x, f32x4& y, f32x4& z)
+		{
+			float32x4x3_t xyz = vld3q_f32(values);
+			x = xyz.val[0];
+			y = xyz.val[1];
+			z = xyz.val[2];
+		}
+
+		/**
+		 * Interleave the components and store them as four consecutive x, y, z triples.
+		 */
+		inline void StoreVector3x4(f32* values, f32x4 x, f32x4 y, f32x4 z)
+		{
+			float32x4x3_t xyz;
+			xyz.val[0] = x;
+			xyz.val[1] = y;
+			xyz.val[2] = z;
+			vst3q_f32(values, xyz);
+		}
+#endif
+	}
+}
+#endif
+
+#endif
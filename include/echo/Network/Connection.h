@@ -75,6 +75,20 @@ namespace Echo
 			Size mBytesReceived;
 			ReceiveStatus mStatus;
 		};
+
+		/**
+		 * A contiguous block of data to send as part of a SendVectored() call.
+		 */
+		struct SendBuffer
+		{
+			const u8* mData;
+			Size mSize;
+		};
+
+		/**
+		 * The maximum number of queued packets SendPackets() will send in one SendVectored() call.
+		 */
+		static const Size MAXIMUM_PACKETS_PER_SEND = 64;
 		
 		/**
 		 * PacketCallback
@@ -327,8 +341,11 @@ namespace Echo
 		 * This method will call Receive().
 		 * @note You do not normally need to call this method manually. The NetworkSystem
 		 * managing the connection.
+		 * @param drain If true, keep receiving until the connection would block or no more data
+		 * is received. NetworkSystems that use edge-triggered notifications need this since they
+		 * won't be notified again for data that is already waiting.
 		 */
-		void UpdateReceive();
+		void UpdateReceive(bool drain = false);
 		
 		/**
 		 * Attempts to send data.
@@ -675,6 +692,18 @@ namespace Echo
 		 */
 		virtual SendResult Send(const u8 * buffer, int numberOfBytesToSend) = 0;
 
+		/**
+		 * Send multiple buffers, in order, as though they were one contiguous buffer.
+		 * SendPackets() uses this to send the headers and data of several queued packets at once. Implementations
+		 * should override this to use a scatter-gather call such as sendmsg() so that one system call is made for
+		 * the whole batch. The default implementation calls Send() for each buffer until a buffer is only
+		 * partially sent or a send fails.
+		 * @param buffers The buffers to send.
+		 * @param numberOfBuffers The number of buffers.
+		 * @return A SendResult that includes the status and the total number of bytes sent.
+		 */
+		virtual SendResult SendVectored(const SendBuffer* buffers, Size numberOfBuffers);
+
 		/**
 		 * Normally the implementation is just a wrapper around a receive method.
 		 * The method should be non-blocking.
@@ -24,6 +24,12 @@ namespace Echo
 	public:
 		DataPacketHeader();
 		bool BuildFromPacketData(const DataPacket& packet);
+		/**
+		 * Build the header directly from received data.
+		 * @param data Pointer to at least GetHeaderDataSizeInBytes() bytes.
+		 * @param isBigEndian Whether the data is big endian.
+		 */
+		void BuildFromData(const u8* data, bool isBigEndian);
 		void BuildForPacket(const DataPacket& packet);
 		const bool IsBigEndian() const					{return mIsBigEndian;}
 		inline u8* GetHeaderData()						{return reinterpret_cast<u8*>(mData);}
@@ -70,7 +70,7 @@ namespace Echo
 
 		void UpdateIncoming(shared_ptr<Connection> connection, IncomingConnectionListener* listener);
 		void UpdateConnect(shared_ptr<Connection> connection);
-		void UpdateReceive(shared_ptr<Connection> connection);
+		void UpdateReceive(shared_ptr<Connection> connection, bool drain = false);
 		void UpdateSend(shared_ptr<Connection> connection);
 	};
 }
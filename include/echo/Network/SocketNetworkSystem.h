@@ -7,6 +7,7 @@
 #include <echo/Kernel/Mutex.h>
 #include <list>
 #include <map>
+#include <vector>
 
 namespace Echo
 {
@@ -17,8 +18,28 @@ namespace Echo
 
 	class SocketNetworkSystem : public NetworkSystem
 	{
+	public:
+		/**
+		 * The mechanism used to wait for socket readiness.
+		 *	POLL - Sockets are checked with poll() by worker threads that are created as they are needed. Each thread
+		 *		monitors up to the maximum number of sockets per thread. This is supported on all platforms.
+		 *	EPOLL - Sockets are sharded by a hash of the socket across a fixed number of I/O threads that each wait
+		 *		on an epoll instance. Readiness is dispatched in O(1) with edge-triggered read and write events on
+		 *		connections. Only available on Linux, requesting it on other platforms falls back to POLL.
+		 */
+		struct Backends
+		{
+			enum _
+			{
+				POLL,
+				EPOLL
+			};
+		};
+		typedef Backends::_ Backend;
 	protected:
 		class SocketThreadTask;
+		class PollSocketThreadTask;
+		class EpollSocketThreadTask;
 		Mutex mConnectionsMutex;
 		std::map< Socket, shared_ptr<Connection> > mConnections;
 		std::map< Socket, IncomingConnectionListener* > mIncomingConnectionListeners;
@@ -31,9 +52,13 @@ namespace Echo
 		std::list< shared_ptr<ThreadTaskPair> > mSocketThreadTasks;
 		std::list< shared_ptr<ThreadTaskPair> > mThreadTasksToCleanup;
 		std::map< Socket, shared_ptr<ThreadTaskPair> > mSocketThreadTaskConnectionLookup;
+		// The EPOLL backend's fixed I/O threads. These are created in Initialise() and don't change until CleanUp().
+		std::vector< shared_ptr<ThreadTaskPair> > mSocketThreadShards;
 		bool mStarted;
 		Size mMaximumSocketsPerThread;
 		int mPollTimeInMS;
+		Backend mBackend;
+		Size mNumberOfIOThreads;
 		Mutex mSocketThreadTasksMutex;
 
 		// A few platforms require some extra initialisation and clean up. It is currently maintained within the implementation.
@@ -46,20 +71,26 @@ namespace Echo
 		//Write set for connect and write data
 		//except for connect failed
 
-		//Each SocketThreadTask can monitor up to FD_SETSIZE
+		/**
+		 * Base class for the tasks that wait for socket readiness and notify the SocketNetworkSystem.
+		 */
 		class SocketThreadTask : public Task
 		{
 		public:
 			SocketThreadTask(SocketNetworkSystem& s, Size maximumSockets, int pollTimeInMS);
-			~SocketThreadTask();
+			virtual ~SocketThreadTask();
+
+			virtual bool AddSocket(Socket s) = 0;
+			virtual bool RemoveSocket(Socket s) = 0;
 
-			bool AddSocket(Socket s);
-			bool RemoveSocket(Socket s);
+			virtual void EnableWriteCheck(Socket s) = 0;
+			virtual void DisableWriteCheck(Socket s) = 0;
 
-			void EnableWriteCheck(Socket s);
-			void DisableWriteCheck(Socket s);
+			/**
+			 * Interrupt a blocking wait so the task can respond to being stopped.
+			 */
+			virtual void Wake(){}
 
-			void Update(Seconds lastFrameTime);
 			Size GetSocketCount() const
 			{
 				return mCount;
@@ -68,6 +99,27 @@ namespace Echo
 			{
 				return (mCount<mMaximumSockets);
 			}
+		protected:
+			std::atomic<Size> mCount;
+			Size mMaximumSockets;
+			int mPollTimeInMS;
+			SocketNetworkSystem& mSystem;
+		};
+
+		//Each PollSocketThreadTask can monitor up to FD_SETSIZE
+		class PollSocketThreadTask : public SocketThreadTask
+		{
+		public:
+			PollSocketThreadTask(SocketNetworkSystem& s, Size maximumSockets, int pollTimeInMS);
+			~PollSocketThreadTask();
+
+			bool AddSocket(Socket s) override;
+			bool RemoveSocket(Socket s) override;
+
+			void EnableWriteCheck(Socket s) override;
+			void DisableWriteCheck(Socket s) override;
+
+			void Update(Seconds lastFrameTime) override;
 		private:
 			Mutex mPendingSocketsMutex;
 			std::set< Socket > mPendingAddSockets;
@@ -82,21 +134,33 @@ namespace Echo
 			void InternalWriteDisable(Socket s);
 			void InternalWriteEnable(Socket s);
 			std::atomic<bool> mPollUpdateRequired;
-			Size mCount;
-			Size mMaximumSockets;
-			int mPollTimeInMS;
-			SocketNetworkSystem& mSystem;
 		};
 
 	private:
 		friend class SocketThreadTask;
 		void CheckForTimeout(Socket s);
-		void ReadNotify(Socket s);
+		/**
+		 * Notify the connection for the socket that it is readable.
+		 * @param drain When true the connection keeps receiving until it would block, this is required for edge
+		 * triggered notifications.
+		 */
+		void ReadNotify(Socket s, bool drain = false);
 		void WriteNotify(Socket s);
 		void ExceptNotify(Socket s);
 		bool IsSocketConnected(Socket s);
+		bool IsListeningSocket(Socket s);
 		bool AssignThreadTask(Socket s);
 
+		/**
+		 * Create a ThreadTaskPair using the configured backend.
+		 */
+		shared_ptr<ThreadTaskPair> CreateThreadTask();
+
+		/**
+		 * Get the I/O thread a socket belongs to when using the EPOLL backend.
+		 */
+		shared_ptr<ThreadTaskPair> GetSocketThreadShard(Socket s) const;
+
 		/**
 		 * Mutex must be locked
 		 * @return a ThreadTaskPair if one has capacity, otherwise false.
@@ -123,7 +187,17 @@ namespace Echo
 			std::string mMacAddress;
 		};
 
-		SocketNetworkSystem(NetworkManager& networkManager, Size maximumSocketsPerThread = 0, int pollTimeInMS = 2000);
+		/**
+		 * Constructor.
+		 * @param networkManager The manager this system belongs to.
+		 * @param maximumSocketsPerThread The maximum number of sockets a thread will monitor, 0 uses FD_SETSIZE for the
+		 * POLL backend and is unlimited for the EPOLL backend.
+		 * @param pollTimeInMS The maximum time a thread will wait for socket events before checking for updates.
+		 * @param backend The readiness mechanism to use, see Backends.
+		 * @param numberOfIOThreads The number of I/O threads the EPOLL backend shards sockets across, 0 uses the number
+		 * of hardware threads. This is ignored by the POLL backend.
+		 */
+		SocketNetworkSystem(NetworkManager& networkManager, Size maximumSocketsPerThread = 0, int pollTimeInMS = 2000, Backend backend = Backends::POLL, Size numberOfIOThreads = 0);
 		~SocketNetworkSystem();
 
 		//Initialise the Network System. Perform initialisation/allocations here
@@ -135,6 +209,8 @@ namespace Echo
 
 		void CleanUp();
 
+		Backend GetBackend() const {return mBackend;}
+
 		void DisconnectAll();
 
 		//This method should fill outSupportedConnectionTypes with any connection types this system supports.
@@ -59,6 +59,12 @@ namespace Echo
 									//	3. Connect();
 
 		SendResult Send(const u8 * buffer, int numberOfBytesToSend) override;
+#ifdef ECHO_POSIX_NETWORKING
+		/**
+		 * Sends all of the buffers with one sendmsg() call.
+		 */
+		SendResult SendVectored(const SendBuffer* buffers, Size numberOfBuffers) override;
+#endif
 		ReceiveResult Receive(u8* buffer, int bufferSizeInBytes) override;
 		bool _HandleError(int code);
 	};
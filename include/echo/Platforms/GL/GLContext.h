@@ -5,8 +5,10 @@
 #define _ECHOGLRENDERCONTEXT_H_
 
 #include <echo/Graphics/RenderPass.h>
+#include <echo/Graphics/Viewport.h>
 #include <echo/Util/PseudoAtomicSet.h>
 #include <map>
+#include <unordered_map>
 
 namespace Echo
 {
@@ -18,6 +20,8 @@ namespace Echo
 	class GLVertexBuffer;
 	class CubeMapTexture;
 	class GLCubeMapTexture;
+	class GLUniformBlock;
+	class GLUniformRingBuffer;
 	
 	/**
 	 * GLContext is used to store the render state of a GL context.
@@ -45,6 +49,11 @@ namespace Echo
 			mMaxTextureStagesUsed = 0;
 			mTextureCoordinateArrayIndex = nullptr;
 			mTexture2DEnabled = 0;
+			mBoundTextures = nullptr;
+			mBlendMode = BlendModes::NONE;
+			mCullMode = RenderPass::CullModes::NONE;
+			mBlendModeKnown = false;
+			mCullModeKnown = false;
 			mClearDepth = 1.0f;
 			mAlphaTestValue = 0.f;
 			mContextReady = false;
@@ -58,6 +67,7 @@ namespace Echo
 			delete [] mTexture2DEnabled;
 			delete [] mTextureCoordinateArrayEnabled;
 			delete [] mTextureCoordinateArrayIndex;
+			delete [] mBoundTextures;
 		}
 		RenderPass::DepthFunction mDepthFunction;		//!< Depth funciton used by depth test.
 		RenderPass::DepthFunction mNonForceDepthFunction;	//!< Depth write depends on depth test (see GL docs), used to restore depth funciton after enabling for depth write.
@@ -78,6 +88,11 @@ namespace Echo
 		bool* mTextureCoordinateArrayEnabled;
 		Size* mTextureCoordinateArrayIndex;
 		bool* mTexture2DEnabled;
+		GLuint* mBoundTextures;					//!< The 2D texture bound to each stage, used to skip redundant binds.
+		BlendMode mBlendMode;
+		RenderPass::CullMode mCullMode;
+		bool mBlendModeKnown;					//!< Whether mBlendMode reflects the GL state.
+		bool mCullModeKnown;					//!< Whether mCullMode reflects the GL state.
 		f32 mClearDepth;
 		f32 mAlphaTestValue;
 		bool mContextReady;
@@ -91,11 +106,14 @@ namespace Echo
 		Mutex mTextureLookupMutex;
 		std::map< Texture*, shared_ptr<GLTexture> > mTextureLookup;
 		Mutex mVertexBufferLookupMutex;
-		std::map< VertexBuffer*, shared_ptr<GLVertexBuffer> > mVertexBufferLookup;
+		std::unordered_map< VertexBuffer*, shared_ptr<GLVertexBuffer> > mVertexBufferLookup;
 		Mutex mShaderProgramLookupMutex;
 		std::map< ShaderProgram*, shared_ptr<GLShaderProgram> > mShaderProgramLookup;
 		Mutex mCubeMapTextureLookupMutex;
 		std::map< CubeMapTexture*, shared_ptr<GLCubeMapTexture> > mCubeMapTextureLookup;
+		Mutex mUniformBlockLookupMutex;
+		std::map< std::string, shared_ptr<GLUniformBlock> > mUniformBlockLookup;	//!< Uniform blocks are shared between programs by name.
+		shared_ptr<GLUniformRingBuffer> mUniformRingBuffer;						//!< Created when the first program with a uniform block is linked.
 
 		PseudoAtomicSet< shared_ptr<GLTexture> > mTexturesToClean;
 		PseudoAtomicSet< shared_ptr<GLCubeMapTexture> > mCubeMapTexturesToClean;
@@ -101,6 +101,9 @@ namespace Echo
 		virtual void DeactivateProgram(shared_ptr<ShaderProgram> shaderProgram) override;
 		virtual bool BuildProgram(shared_ptr<ShaderProgram> shaderProgram) override;
 
+		virtual void BeginBatch() override;
+		virtual void EndBatch() override;
+
 		void SetLight(u32 lightindex, Light* light) override;
 		
 		/**
@@ -146,6 +149,28 @@ namespace Echo
 		}
 		bool _SetActiveTextureStage(u32 stage);
 		void EnableDepthTestForOnlyDepthWrite();
+
+		/**
+		 * Unbind the active vertex buffer and, when no program is active, disable the client arrays.
+		 */
+		void ResetVertexBuffer();
+
+		/**
+		 * Mark all texture bindings as unknown so the next SetTexture() on each stage binds.
+		 */
+		void InvalidateTextureBindings();
+
+		/**
+		 * Perform the state resets that were deferred while batching.
+		 */
+		void ApplyDeferredState();
+
+		bool mBatching;
+		bool mProgramDeactivatePending;
+		bool mVertexBufferResetPending;
+		u32 mTextureStagesToReset;						//!< Stages that need resetting unless they are set before the next draw.
+		std::vector<bool> mTextureStagesSetInBatch;
+
 	};
 }
 #endif 
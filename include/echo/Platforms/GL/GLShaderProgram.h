@@ -4,12 +4,16 @@
 #include <echo/Types.h>
 #include <echo/Platforms/GL/GLSupport.h>
 #include <echo/Graphics/ShaderProgram.h>
+#include <echo/Platforms/GL/GLUniformBlock.h>
+#include <cstring>
 #include <map>
 #include <echo/cpp/functional>
 
 namespace Echo
 {
 	class GLShader;
+	class GLContext;
+	class GLUniformRingBuffer;
 	
 	/**
 	 * GLShaderProgram manages the activation of a shader script and setting of any mapped variables.
@@ -29,6 +33,14 @@ namespace Echo
 	 * GLContext. There may be more than one mapping of a ShaderProgram to GLShaderProgram objects.
 	 * In the case of multiple mappings there is still only one shared_ptr<T> shared across all, that means
 	 * that setting the ShaderProgram variable in code affects all GLShaderPrograms when they are used.
+	 *
+	 * Each TargetVariable keeps a copy of the value it last uploaded and only calls the GL API when the value
+	 * changes. GL keeps uniform values per program so the copy remains valid while the program is inactive.
+	 *
+	 * Variables in std140 uniform blocks are mapped the same way but they write to a GLUniformBlock that is
+	 * shared by name with the other programs in the GLContext. Dirty blocks are streamed through the context's
+	 * GLUniformRingBuffer when the variables are set. Declaring per frame or per camera data in a uniform block
+	 * means it is uploaded once when it changes rather than once for each program that uses it.
 	 */
 	class GLShaderProgram
 	{
@@ -36,13 +48,26 @@ namespace Echo
 		GLShaderProgram();
 		~GLShaderProgram();
 
-		//Links the program
-		bool CompileAndLink(ShaderProgram& shaderProgram);
+		/**
+		 * Compile the shaders and link the program.
+		 * @param context The context the program will be used with, uniform blocks are shared through it.
+		 */
+		bool CompileAndLink(ShaderProgram& shaderProgram, GLContext& context);
 
-		//Setting active assigns all of the variables.
-		void Activate();
+		/**
+		 * Activate the program and assign all of the variables.
+		 * @return The number of uniforms and uniform blocks that were uploaded.
+		 */
+		Size Activate();
 		void Deactivate();
 
+		/**
+		 * Assign all of the variables without activating the program.
+		 * @note The program must already be active.
+		 * @return The number of uniforms and uniform blocks that were uploaded.
+		 */
+		Size SetVariables();
+
 		std::string GetErrors();
 		Size GetVersion() const
 		{
@@ -58,7 +83,11 @@ namespace Echo
 		public:
 			TargetVariable(){}
 			virtual ~TargetVariable(){}
-			virtual void Set()=0;
+			/**
+			 * Set the variable.
+			 * @return true if the GL API was called to upload the value.
+			 */
+			virtual bool Set()=0;
 			virtual void Unset(){};
 		};
 
@@ -70,20 +99,30 @@ namespace Echo
 			TargetUniformVariable(GLint location, shared_ptr<T> variable, SetFunction func) :
 				mLocation(location),
 				mVariable(variable),
-				mSetFunction(func)
+				mSetFunction(func),
+				mUploaded(false)
 			{
 				assert((mLocation!=-1) && "TargetUniformVariable mLocation cannot be -1");
 				assert(mVariable && "TargetUniformVariable mVariable cannot be null");
 				assert(mSetFunction && "TargetUniformVariable mSetFunction cannot be null");
 			}
-			void Set()
+			bool Set()
 			{
+				if(mUploaded && mUploadedValue==*mVariable)
+				{
+					return false;
+				}
 				mSetFunction(mLocation, *(mVariable));
+				mUploadedValue = *mVariable;
+				mUploaded = true;
+				return true;
 			}
 		private:
 			GLint mLocation;
 			shared_ptr<T> mVariable;
 			SetFunction mSetFunction;
+			T mUploadedValue;
+			bool mUploaded;
 		};
 
 		template < typename T >
@@ -94,27 +133,101 @@ namespace Echo
 			TargetUniformVariableFloatVector(GLint location, shared_ptr<T> variable, SetFunction func) :
 				mLocation(location),
 				mVariable(variable),
-				mSetFunction(func)
+				mSetFunction(func),
+				mUploaded(false)
 			{
 				assert((mLocation!=-1) && "TargetUniformVariableFloatVector mLocation cannot be -1");
 				assert(mVariable && "TargetUniformVariableFloatVector mVariable cannot be null");
 				assert(mSetFunction && "TargetUniformVariableFloatVector mSetFunction cannot be null");
 			}
-			void Set()
+			bool Set()
 			{
+				// The values are compared bitwise since they are uploaded as an array of floats.
+				if(mUploaded && std::memcmp(&mUploadedValue, mVariable.get(), sizeof(T))==0)
+				{
+					return false;
+				}
 				mSetFunction(mLocation, (GLfloat*)mVariable.get());
+				mUploadedValue = *mVariable;
+				mUploaded = true;
+				return true;
 			}
 		private:
 			GLint mLocation;
 			shared_ptr<T> mVariable;
 			SetFunction mSetFunction;
+			T mUploadedValue;
+			bool mUploaded;
+		};
+
+		/**
+		 * A variable in a uniform block. Setting it only writes to the block, which is uploaded if it changed
+		 * once all of the variables have been set.
+		 */
+		template < typename T >
+		class TargetBlockVariable : public TargetVariable
+		{
+		public:
+			TargetBlockVariable(shared_ptr<GLUniformBlock> block, Size offset, shared_ptr<T> variable) :
+				mBlock(block),
+				mOffset(offset),
+				mVariable(variable)
+			{
+				assert(mBlock && "TargetBlockVariable mBlock cannot be null");
+				assert(mVariable && "TargetBlockVariable mVariable cannot be null");
+			}
+			bool Set()
+			{
+				mBlock->Write(mOffset, *mVariable);
+				return false;
+			}
+		private:
+			shared_ptr<GLUniformBlock> mBlock;
+			Size mOffset;
+			shared_ptr<T> mVariable;
+		};
+
+		template < typename T >
+		class TargetBlockMatrixVariable : public TargetVariable
+		{
+		public:
+			TargetBlockMatrixVariable(shared_ptr<GLUniformBlock> block, Size offset, Size matrixStride, bool rowMajor, shared_ptr<T> variable) :
+				mBlock(block),
+				mOffset(offset),
+				mMatrixStride(matrixStride),
+				mRowMajor(rowMajor),
+				mVariable(variable)
+			{
+				assert(mBlock && "TargetBlockMatrixVariable mBlock cannot be null");
+				assert(mVariable && "TargetBlockMatrixVariable mVariable cannot be null");
+			}
+			bool Set()
+			{
+				mBlock->Write(mOffset, *mVariable, mMatrixStride, mRowMajor);
+				return false;
+			}
+		private:
+			shared_ptr<GLUniformBlock> mBlock;
+			Size mOffset;
+			Size mMatrixStride;
+			bool mRowMajor;
+			shared_ptr<T> mVariable;
 		};
 		
 		std::list < shared_ptr<TargetVariable> > mTargetVariables;
+		std::vector < shared_ptr<GLUniformBlock> > mUniformBlocks;
+		shared_ptr<GLUniformRingBuffer> mUniformRingBuffer;
 		
 		std::map< const Shader*, shared_ptr<GLShader> > mShaderLookup;
 		
 		shared_ptr<GLShader> CompileShader(const Shader* shader);
+
+		/**
+		 * Map a variable in a uniform block to a ShaderProgram variable.
+		 * @param variableType The GL type of the variable.
+		 * @param offset The offset of the variable in the block, including the array element offset.
+		 */
+		void AddBlockVariable(ShaderProgram& shaderProgram, shared_ptr<GLUniformBlock> block, const std::string& uniformName, u32 variableType, Size offset, Size matrixStride, bool rowMajor);
 	};
 }
 #endif
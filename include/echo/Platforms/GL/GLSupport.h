@@ -40,6 +40,7 @@
 	#define ECHO_GL_SUPPORTS_FRAGMENT_SHADER
 	#define ECHO_GL_SUPPORTS_VERTEX_SHADER
 	#define ECHO_GL_SUPPORTS_SHADER
+	#define ECHO_GL_SUPPORTS_UNIFORM_BUFFER
 
 #elif ECHO_PLATFORM_ANDROID
 
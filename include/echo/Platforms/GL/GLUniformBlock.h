@@ -0,0 +1,108 @@
+#ifndef _ECHOGLUNIFORMBLOCK_H_
+#define _ECHOGLUNIFORMBLOCK_H_
+
+#include <echo/Types.h>
+#include <echo/Maths/Vector2.h>
+#include <echo/Maths/Vector3.h>
+#include <echo/Maths/Vector4.h>
+#include <echo/Maths/Matrix3.h>
+#include <echo/Maths/Matrix4.h>
+#include <string>
+#include <vector>
+
+namespace Echo
+{
+	/**
+	 * GLUniformBlock is the CPU copy of the data for a std140 uniform block.
+	 *
+	 * Blocks are shared by name between all GLShaderPrograms in a GLContext so data such as the per camera
+	 * matrices is uploaded once rather than for each program. Each block has its own binding point.
+	 *
+	 * Writes only mark the block as dirty if the data changes. When a program's variables are set, dirty blocks
+	 * are copied to the GLUniformRingBuffer and bound. Since the block is shared, the first program that is
+	 * activated after a change uploads it and other programs that write the same values don't. Clean blocks
+	 * are uploaded again if the ring buffer has since reused the segment they were uploaded to, see
+	 * GLUniformRingBuffer::NeedsUpload().
+	 */
+	class GLUniformBlock
+	{
+	public:
+		GLUniformBlock(const std::string& name, Size size, u32 bindingPoint);
+		~GLUniformBlock();
+
+		/**
+		 * Write data into the block.
+		 * @return false if the data does not fit in the block.
+		 */
+		bool Write(Size offset, const void* data, Size size);
+
+		bool Write(Size offset, f32 value);
+		bool Write(Size offset, s32 value);
+		bool Write(Size offset, bool value);
+		bool Write(Size offset, const Vector2& value);
+		bool Write(Size offset, const Vector3& value);
+		bool Write(Size offset, const Vector4& value);
+
+		/**
+		 * Write a matrix with the layout reported by GL.
+		 * @param matrixStride The number of bytes between each column, or row if rowMajor is true.
+		 * @param rowMajor Whether the block declares the matrix as row_major.
+		 */
+		bool Write(Size offset, const Matrix3& value, Size matrixStride, bool rowMajor);
+		bool Write(Size offset, const Matrix4& value, Size matrixStride, bool rowMajor);
+
+		const std::string& GetName() const
+		{
+			return mName;
+		}
+
+		Size GetSize() const
+		{
+			return mData.size();
+		}
+
+		u32 GetBindingPoint() const
+		{
+			return mBindingPoint;
+		}
+
+		const u8* GetData() const
+		{
+			return mData.data();
+		}
+
+		/**
+		 * Get whether the data has changed since the last call to SetUploaded().
+		 * Blocks start dirty so they are uploaded at least once.
+		 */
+		bool GetDirty() const
+		{
+			return mDirty;
+		}
+
+		/**
+		 * Record that the data was uploaded and clear the dirty flag.
+		 * @param sequence The sequence number of the ring buffer segment the data was uploaded to.
+		 */
+		void SetUploaded(u64 sequence)
+		{
+			mDirty = false;
+			mUploadedSequence = sequence;
+		}
+
+		/**
+		 * Get the sequence number of the ring buffer segment the data was last uploaded to.
+		 */
+		u64 GetUploadedSequence() const
+		{
+			return mUploadedSequence;
+		}
+	private:
+		std::string mName;
+		u32 mBindingPoint;
+		std::vector<u8> mData;
+		bool mDirty;
+		u64 mUploadedSequence;
+	};
+}
+#endif
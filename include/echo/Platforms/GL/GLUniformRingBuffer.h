@@ -0,0 +1,69 @@
+#ifndef _ECHOGLUNIFORMRINGBUFFER_H_
+#define _ECHOGLUNIFORMRINGBUFFER_H_
+
+#include <echo/Platforms/GL/GLSupport.h>
+#include <echo/Types.h>
+#include <echo/Util/SegmentedRingAllocator.h>
+
+#ifdef ECHO_GL_SUPPORTS_UNIFORM_BUFFER
+namespace Echo
+{
+	class GLUniformBlock;
+
+	/**
+	 * GLUniformRingBuffer is a persistently mapped uniform buffer that uniform block data is streamed through.
+	 *
+	 * Each time a block changes its data is copied to the next free range of the buffer and that range is
+	 * bound to the block's binding point. Nothing that the GPU may still be reading is overwritten so per
+	 * object data can change every draw without the driver synchronising or copying.
+	 *
+	 * The buffer is divided into segments. When a segment is full a fence is inserted and writing continues in
+	 * the next segment, waiting for its fence first if the GPU hasn't finished with it.
+	 *
+	 * Reusing a segment overwrites the data of every block that was uploaded to it, including blocks that
+	 * haven't changed since and are still bound to that range. Each block records the sequence number of the
+	 * segment it was uploaded to so NeedsUpload() can report these blocks as well as dirty ones.
+	 */
+	class GLUniformRingBuffer
+	{
+	public:
+		static const Size DEFAULT_SIZE = 4 * 1024 * 1024;
+		static const Size NUMBER_OF_SEGMENTS = 4;
+
+		GLUniformRingBuffer(Size size = DEFAULT_SIZE);
+		~GLUniformRingBuffer();
+
+		/**
+		 * Get whether the block needs to be uploaded before it is used, either because it is dirty or because
+		 * the segment it was last uploaded to has been reused.
+		 */
+		bool NeedsUpload(const GLUniformBlock& block) const;
+
+		/**
+		 * Copy the block's data to the buffer, bind it to the block's binding point and mark it as uploaded.
+		 * @return false if the buffer couldn't be created or the block is larger than a segment.
+		 */
+		bool Upload(GLUniformBlock& block);
+
+		/**
+		 * Get the sequence number of the segment that is currently being written to.
+		 * This changes each time writing moves to another segment.
+		 */
+		u64 GetSequence() const
+		{
+			return mAllocator.GetSequence();
+		}
+	private:
+		/**
+		 * Fence the previous segment and wait for the GPU to finish with the current one.
+		 */
+		void BeginSegment();
+
+		GLuint mBuffer;
+		u8* mMappedData;
+		SegmentedRingAllocator mAllocator;
+		GLsync mFences[NUMBER_OF_SEGMENTS];
+	};
+}
+#endif
+#endif
@@ -9,6 +9,8 @@ namespace Echo
 	/**
 	 * GLVertexBuffer manages the Vertex Array Object and buffer objects for a VertexBuffer.
 	 * One of these is mapped to each VertexBuffer that is used by a GLRenderTarget.
+	 * The attribute pointers are stored in the Vertex Array Object so they are only specified when the
+	 * buffer's VertexLayout changes, updating the data of a buffer only uploads the data.
  	 */
 	class GLVertexBuffer
 	{
@@ -50,7 +52,13 @@ namespace Echo
 			mVersion++;
 		}
 	private:
+		/**
+		 * Specify the attribute pointers for the layout, the buffer needs to be bound.
+		 */
+		void SetAttributes(const VertexLayout& layout);
+
 		Size mVersion;
+		shared_ptr<const VertexLayout> mLayout;
 		bool mIsReady;
 		GLuint mVertexArrayObject;
 		GLuint mVertexBuffer;
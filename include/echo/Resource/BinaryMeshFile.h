@@ -0,0 +1,51 @@
+#ifndef _ECHOBINARYMESHFILE_H_
+#define _ECHOBINARYMESHFILE_H_
+#include <echo/Types.h>
+
+namespace Echo
+{
+	class Mesh;
+	class File;
+	class MaterialManager;
+
+	/**
+	 * Echo binary mesh files (.emesh) store meshes in the layout that VertexBuffer and ElementBuffer use.
+	 *
+	 * The file is a fixed size header followed by tables describing the vertex buffers, their attributes and
+	 * the sub meshes, a string table, then the vertex and index data. Each vertex buffer and element buffer is a
+	 * single block that is copied into the allocated buffer as is. When the file's data is directly accessible,
+	 * for example a memory file or a memory mapped VFS archive, the blocks are copied from there, otherwise the
+	 * tables are read with one Read() and each block is read straight into its buffer. Nothing is converted per
+	 * vertex so loading is mostly bounded by memory bandwidth.
+	 *
+	 * Vertex buffers shared between sub meshes are stored once and remain shared when loaded. Materials are
+	 * stored by name and looked up with the MaterialManager relative to the mesh file.
+	 *
+	 * The data is stored in the byte order of the platform that wrote the file, loading a file written on a
+	 * platform with a different byte order fails. Use the emeshc tool to convert other mesh formats.
+	 * @note Skinning information is not stored, skinned meshes should use the .mesh format.
+	 */
+	namespace BinaryMeshFile
+	{
+		const u32 VERSION = 1;
+	}
+
+	/**
+	 * Read a binary mesh file into a mesh.
+	 * @param file The file to read from, this is closed once loaded.
+	 * @param materialManager The MaterialManager to acquire the sub mesh materials from.
+	 * @param targetMesh The mesh to create the sub meshes in.
+	 * @return true if the mesh was loaded, false if the file isn't valid.
+	 */
+	bool ReadBinaryMeshFile(File& file, MaterialManager& materialManager, Mesh& targetMesh);
+
+	/**
+	 * Write a mesh to a binary mesh file.
+	 * @param file The file to write to, this should be opened in write mode.
+	 * @param mesh The mesh to write.
+	 * @return false if the mesh is skinned or writing failed.
+	 */
+	bool WriteBinaryMeshFile(File& file, const Mesh& mesh);
+}
+
+#endif
@@ -12,6 +12,8 @@ namespace Echo
 		BitmapLoader();
 		~BitmapLoader();
 		
+		shared_ptr<TextureLoader> CreateInstance() const override;
+		
 		std::vector<std::string> GetFileExtensions() const;
 		bool ProcessFile(File& textureFile);
 		u32 GetWidth() const;
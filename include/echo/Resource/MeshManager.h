@@ -22,6 +22,7 @@ namespace Echo
 
 		static bool Load3DS(const std::string& resourceFile, FileSystem& fileSystem, Mesh& mesh);
 		static bool LoadMesh(const std::string& resourceFile, FileSystem& fileSystem,MaterialManager& materialManager, SkeletonManager& skeletonManager, Mesh& mesh);
+		static bool LoadBinaryMesh(const std::string& resourceFile, FileSystem& fileSystem, MaterialManager& materialManager, Mesh& mesh);
 
 		/**
 		 * Register file loader.
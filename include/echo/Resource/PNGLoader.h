@@ -13,6 +13,8 @@ namespace Echo
 		PNGLoader();
 		~PNGLoader();
 		
+		shared_ptr<TextureLoader> CreateInstance() const override;
+		
 		std::vector<std::string> GetFileExtensions() const;
 		bool ProcessFile(File& textureFile);
 		u32 GetWidth() const;
@@ -4,6 +4,7 @@
 #include <echo/FileSystem/FileSystem.h>
 #include <echo/Resource/ResourceManagerBase.h>
 #include <echo/Resource/ResourceLoader.h>
+#include <echo/Kernel/WorkerPool.h>
 #include <echo/Util/StringUtils.h>
 #include <map>
 #ifdef ECHO_EFSW_SUPPORT
@@ -12,18 +13,83 @@
 
 namespace Echo
 {
+	/**
+	 * A ResourceManager maps names to resources and loads them from their files when they are first requested.
+	 *
+	 * Resources are normally loaded synchronously by GetResource(). If the manager is given a WorkerPool, and the
+	 * manager supports concurrent loading, GetResourceAsync() will load resources on the workers instead:
+	 *
+	 *		manager.SetWorkerPool(workerPool);
+	 *		ResourceManager<Texture>::AsyncResource request = manager.GetResourceAsync("Level1.png");
+	 *		...
+	 *		if(request.IsReady())
+	 *		{
+	 *			shared_ptr<Texture> texture = request.Get();
+	 *		}
+	 *
+	 * Loads are finished on the thread that uses the manager, either when the resource is requested, by
+	 * UpdateAsyncLoads() or by WaitForAsyncLoads(). The manager itself is not thread safe, only the loading is.
+	 */
 	template< typename T >
 	class ResourceManager : public ResourceManagerBase, public ResourceLoader<T>
 	{
 	public:
+		/**
+		 * The state of a resource that is being loaded on a worker.
+		 */
+		struct PendingLoad
+		{
+			WorkerPool::Counter mCounter;
+			shared_ptr<T> mResource;	//Set by the job, only read once mCounter is complete.
+		};
+
 		struct ResourceProfile
 		{
 			shared_ptr<T> mResource;
 			std::string mFile;		//File to load from if the resource is not loaded
+			shared_ptr<PendingLoad> mPendingLoad;	//Set while the resource is being loaded asynchronously.
 		};
 		typedef typename std::map< std::string, ResourceProfile >::iterator ResourceIterator;
+
+		/**
+		 * Handle to a resource requested with GetResourceAsync().
+		 */
+		class AsyncResource
+		{
+		public:
+			AsyncResource() : mManager(nullptr) {}
+
+			/**
+			 * Get whether the resource has finished loading.
+			 */
+			bool IsReady() const
+			{
+				return (!mPendingLoad || mPendingLoad->mCounter.IsComplete());
+			}
+
+			/**
+			 * Get the resource, waiting for it to load if needed.
+			 * Like GetResource() this must be called from the thread that uses the manager.
+			 */
+			shared_ptr<T> Get() const
+			{
+				if(mPendingLoad)
+				{
+					return mManager->GetResource(mName);
+				}
+				return mResource;
+			}
+
+			const std::string& GetName() const {return mName;}
+		private:
+			friend class ResourceManager<T>;
+			ResourceManager<T>* mManager;
+			std::string mName;
+			shared_ptr<T> mResource;
+			shared_ptr<PendingLoad> mPendingLoad;
+		};
 		
-		ResourceManager(const std::string& resourceTypeName) : mResourceType(resourceTypeName)
+		ResourceManager(const std::string& resourceTypeName) : mResourceType(resourceTypeName), mPrefetchLists(false)
 		{
 			#ifdef ECHO_EFSW_SUPPORT
 			mDirectoryMonitor = make_shared<DirectoryMonitor>();
@@ -33,6 +99,26 @@ namespace Echo
 		virtual ~ResourceManager()
 		{
 			//No explicit cleanup required. Resources will be unloaded as their reference counts become 0.
+			//Managers that support concurrent loading need to call WaitForAsyncLoads() from their destructor
+			//since the jobs call LoadResource().
+		}
+
+		/**
+		 * Set the WorkerPool used by GetResourceAsync().
+		 * Any loads in progress on the previous pool are finished first.
+		 * @param workerPool The pool to load with, if null resources are always loaded synchronously.
+		 * @param prefetchLists If true LoadList() will start loading every resource in the list.
+		 */
+		void SetWorkerPool(shared_ptr<WorkerPool> workerPool, bool prefetchLists = false)
+		{
+			WaitForAsyncLoads();
+			mWorkerPool = workerPool;
+			mPrefetchLists = prefetchLists;
+		}
+
+		shared_ptr<WorkerPool> GetWorkerPool() const
+		{
+			return mWorkerPool;
 		}
 		
 		/**
@@ -88,6 +174,10 @@ namespace Echo
 				ECHO_LOG_ERROR("ResourceManager(" << mResourceType << ") Resource \"" << name << "\" does not exist.");
 				return false;
 			}
+			if(it->second.mPendingLoad)
+			{
+				mWorkerPool->Wait(it->second.mPendingLoad->mCounter);
+			}
 			mResources.erase(it);
 			return true;
 		}
@@ -140,35 +230,122 @@ namespace Echo
 					return GetErrorResource();
 				}
 			}
+			if(it->second.mPendingLoad)
+			{
+				mWorkerPool->Wait(it->second.mPendingLoad->mCounter);
+				FinishLoad(it, it->second.mPendingLoad->mResource);
+			}else
 			if(!it->second.mResource)
 			{
-				it->second.mResource = LoadResource(it->second.mFile, nameOrFile);
-				if(it->second.mResource)
+				FinishLoad(it, LoadResource(it->second.mFile, nameOrFile));
+			}
+			return it->second.mResource;
+		}
+
+		/**
+		 * Start loading a resource on the WorkerPool.
+		 * The resource is resolved the same way as GetResource(). If the resource is already loaded or loading
+		 * the returned handle refers to it. If there is no WorkerPool or the manager does not support concurrent
+		 * loading the resource is loaded synchronously.
+		 * @note Texture data is only decoded on the workers, it is uploaded by the render thread when the texture
+		 * is first used.
+		 * @param nameOrFile The name or file name of the resource
+		 * @param relativeToFile If specifying a file, specifying another file will perform a relative
+		 * file look up.
+		 * @return A handle to get the resource from once it has loaded.
+		 */
+		AsyncResource GetResourceAsync(const std::string& nameOrFile, std::string relativeToFile="")
+		{
+			AsyncResource request;
+			request.mManager = this;
+			request.mName = nameOrFile;
+			if(!mWorkerPool || !GetConcurrentLoadingSupported())
+			{
+				request.mResource = GetResource(nameOrFile, relativeToFile);
+				return request;
+			}
+
+			ResourceIterator it = mResources.find(nameOrFile);
+			if(it == mResources.end())
+			{
+				FileSystem* fileSystem = GetFileSystem();
+				if(fileSystem)
+				{
+					std::string fileName = fileSystem->ResolveFullNameForFileWithParent(nameOrFile,relativeToFile);
+					it = mResources.find(fileName);
+					if(it == mResources.end() && fileSystem->FileExists(fileName))
+					{
+						AddResource(fileName, fileName);
+						it = mResources.find(fileName);
+					}
+				}
+				if(it == mResources.end())
 				{
-					it->second.mResource->SetResourceLoader(this);
+					ECHO_LOG_ERROR("ResourceManager(" << mResourceType << ") Resource \"" << nameOrFile << "\" not found.");
+					request.mResource = GetErrorResource();
+					return request;
 				}
+				request.mName = it->first;
+			}
 
-				#ifdef ECHO_EFSW_SUPPORT
-				if(it->second.mResource && mDirectoryMonitor)
+			if(it->second.mResource)
+			{
+				request.mResource = it->second.mResource;
+				return request;
+			}
+			if(!it->second.mPendingLoad)
+			{
+				// The job only has copies of what it needs so the map can be modified while it runs.
+				shared_ptr<PendingLoad> pendingLoad = make_shared<PendingLoad>();
+				std::string file = it->second.mFile;
+				std::string name = it->first;
+				mWorkerPool->Schedule([this, pendingLoad, file, name]()
 				{
-					std::string fileToWatch = it->second.mFile;
-					mDirectoryMonitor->RegisterFileModifiedCallback(fileToWatch,[this,nameOrFile,fileToWatch](std::string directory, std::string modifiedFilename){
-						ResourceIterator it = mResources.find(nameOrFile);
-						if(it != mResources.end())
-						{
-							if(!it->second.mResource->Reload())
-							{
-								ECHO_LOG_INFO("Resource reload failed: " << nameOrFile);
-							}
-						}else
-						{
-							ECHO_LOG_INFO("Resource not found for reload: " << nameOrFile);
-						}
-					});
+					pendingLoad->mResource = LoadResource(file, name);
+				}, pendingLoad->mCounter);
+				it->second.mPendingLoad = pendingLoad;
+			}
+			request.mPendingLoad = it->second.mPendingLoad;
+			return request;
+		}
+
+		/**
+		 * Finish any asynchronous loads that have completed without waiting for the others.
+		 * @return The number of loads that are still in progress.
+		 */
+		Size UpdateAsyncLoads()
+		{
+			Size numberInProgress = 0;
+			for(ResourceIterator it = mResources.begin(); it != mResources.end(); ++it)
+			{
+				if(it->second.mPendingLoad)
+				{
+					if(it->second.mPendingLoad->mCounter.IsComplete())
+					{
+						FinishLoad(it, it->second.mPendingLoad->mResource);
+					}else
+					{
+						++numberInProgress;
+					}
+				}
+			}
+			return numberInProgress;
+		}
+
+		/**
+		 * Wait for all asynchronous loads to complete and finish them.
+		 * The calling thread helps the workers while waiting.
+		 */
+		void WaitForAsyncLoads()
+		{
+			for(ResourceIterator it = mResources.begin(); it != mResources.end(); ++it)
+			{
+				if(it->second.mPendingLoad)
+				{
+					mWorkerPool->Wait(it->second.mPendingLoad->mCounter);
+					FinishLoad(it, it->second.mPendingLoad->mResource);
 				}
-				#endif
 			}
-			return it->second.mResource;
 		}
 
 		/**
@@ -233,7 +410,7 @@ namespace Echo
 				ECHO_LOG_ERROR("ResourceManager(" << mResourceType << ")::IsResourceLoaded(): Resource \"" << name << "\" not found.");
 				return false;
 			}
-			return (it->second.mResource);
+			return (it->second.mResource!=nullptr);
 		}
 
 		/**
@@ -244,6 +421,17 @@ namespace Echo
 		 */
 		virtual shared_ptr<T> LoadResource(const std::string& resourceFile, const std::string& resourceName) = 0;
 
+		/**
+		 * Get whether LoadResource() can be called from worker threads.
+		 * Managers that return true need LoadResource() to be safe to call concurrently with itself and with
+		 * the manager being used on another thread. It must not access the resource map.
+		 * @return true if GetResourceAsync() can load on the WorkerPool, the default is false.
+		 */
+		virtual bool GetConcurrentLoadingSupported() const
+		{
+			return false;
+		}
+
 		/**
 		 * Load a list of resources from a file using a standard format.
 		 * The format is:
@@ -270,6 +458,7 @@ namespace Echo
 			FileSystem* fileSystem=GetFileSystem();
 			
 			std::vector<std::string> lines;
+			std::vector<std::string> addedResources;
 			listFile.ReadLines(lines,false);
 			for(u32 l=0;l<lines.size();++l)
 			{
@@ -292,8 +481,8 @@ namespace Echo
 				{
 					switch(params.size())
 					{
-						case 2:	AddResource(params[1],resourceFileName); break;
-						case 1:	AddResource(params[0],resourceFileName); break;		//params[0] is the reference used.
+						case 2:	AddResource(params[1],resourceFileName); addedResources.push_back(params[1]); break;
+						case 1:	AddResource(params[0],resourceFileName); addedResources.push_back(params[0]); break;		//params[0] is the reference used.
 					}
 				}else
 				{
@@ -304,6 +493,13 @@ namespace Echo
 					}
 				}
 			}
+			if(mPrefetchLists && mWorkerPool)
+			{
+				for(const std::string& resourceName : addedResources)
+				{
+					GetResourceAsync(resourceName);
+				}
+			}
 			return true;
 		}
 
@@ -366,10 +562,48 @@ namespace Echo
 		}
 		std::map< std::string,  ResourceProfile > mResources;
 		std::string mResourceType;	//Name of the resource type.
+		shared_ptr<WorkerPool> mWorkerPool;
+		bool mPrefetchLists;		//If true LoadList() starts loading the resources in the list.
 
 		#ifdef ECHO_EFSW_SUPPORT
 		shared_ptr<DirectoryMonitor> mDirectoryMonitor;
 		#endif
+	private:
+		/**
+		 * Store a loaded resource in its profile and set up reloading.
+		 * This is the part of loading that needs to happen on the thread that uses the manager.
+		 */
+		void FinishLoad(ResourceIterator it, shared_ptr<T> resource)
+		{
+			it->second.mPendingLoad.reset();
+			it->second.mResource = resource;
+			if(!resource)
+			{
+				return;
+			}
+			resource->SetResourceLoader(this);
+
+			#ifdef ECHO_EFSW_SUPPORT
+			if(mDirectoryMonitor)
+			{
+				std::string resourceName = it->first;
+				std::string fileToWatch = it->second.mFile;
+				mDirectoryMonitor->RegisterFileModifiedCallback(fileToWatch,[this,resourceName,fileToWatch](std::string directory, std::string modifiedFilename){
+					ResourceIterator it = mResources.find(resourceName);
+					if(it != mResources.end())
+					{
+						if(!it->second.mResource->Reload())
+						{
+							ECHO_LOG_INFO("Resource reload failed: " << resourceName);
+						}
+					}else
+					{
+						ECHO_LOG_INFO("Resource not found for reload: " << resourceName);
+					}
+				});
+			}
+			#endif
+		}
 	};
 }
 #endif 
@@ -1,6 +1,7 @@
 #ifndef _ECHOTEXTUTURELOADER_H_
 #define _ECHOTEXTUTURELOADER_H_
 #include <echo/Graphics/Texture.h>
+#include <echo/Kernel/Mutex.h>
 
 namespace Echo
 {
@@ -8,6 +9,9 @@ namespace Echo
 	
 	/**
 	 * A texture loader loads a specific file type and creates a texture.
+	 * Loaders keep state while loading a file. LoadTexture() can be called from multiple threads but calls on
+	 * the same loader are serialised. To decode in parallel the TextureManager uses CreateInstance() to get a
+	 * loader for each file.
 	 */
 	class TextureLoader
 	{
@@ -16,6 +20,17 @@ namespace Echo
 		virtual ~TextureLoader();
 		
 		Texture* LoadTexture(File& file, bool forcePowerOfTwoTextures, Texture* textureToLoadInto = nullptr);
+
+		/**
+		 * Create a new loader of the same type.
+		 * Loaders that can be constructed without any external state should override this so that files can be
+		 * loaded concurrently.
+		 * @return A new loader, or null if this loader needs to be shared.
+		 */
+		virtual shared_ptr<TextureLoader> CreateInstance() const
+		{
+			return nullptr;
+		}
 		
 		/**
 		 * Get supported file extensions that the loader is designed to load.
@@ -72,6 +87,8 @@ namespace Echo
 		 * This method will be called when an error occurs or when the loader is no longer required.
 		 */
 		virtual void CleanUp() = 0;
+	private:
+		Mutex mLoadMutex;
 	};
 }
 #endif
@@ -17,6 +17,7 @@ namespace Echo
 
 		/**
 		 * Register a loader.
+		 * Loaders should be registered before any textures are loaded asynchronously.
 		 * @param loader
 		 * @return true on success, false if a loader alread exists for the supported file type or the loader is null.
 		 */
@@ -92,6 +93,21 @@ namespace Echo
 		virtual shared_ptr<Texture> GetErrorResource() const override;
 
 		virtual bool LoadIntoResource(const std::string& resourceNameOrFile, Texture& textureToLoadInto) override;
+
+		/**
+		 * Textures can be decoded on worker threads, see GetResourceAsync().
+		 * @return true.
+		 */
+		virtual bool GetConcurrentLoadingSupported() const override;
+
+		/**
+		 * Load a texture from a file without adding it as a resource.
+		 * This does not access the resources so it can be called from worker threads once the loaders have been
+		 * registered.
+		 * @param fileName The image file to load.
+		 * @return The texture, or null if the file could not be loaded.
+		 */
+		shared_ptr<Texture> LoadTextureFromFile(const std::string& fileName);
 	private:
 		/**
 		 * Load a resource from the specified file.
@@ -120,6 +136,13 @@ namespace Echo
 		 *		 This will be null if there was a failure.
 		 */
 		Texture* _LoadResource(const std::string& resourceNameOrFile, Texture* textureToLoadInto = nullptr);
+
+		/**
+		 * Load a texture from a file using the loader registered for the file's extension.
+		 * This does not access the resource map so it is safe to call from worker threads.
+		 * @see _LoadResource() for the memory management of the return value.
+		 */
+		Texture* LoadTextureFile(const std::string& resourceFileName, Texture* textureToLoadInto);
 		
 		FileSystem& mFileSystem;
 		std::map< std::string, shared_ptr<TextureLoader> > mImageLoaders;
@@ -0,0 +1,221 @@
+#ifndef _ECHOTEXTURERESIDENCYMANAGER_H_
+#define _ECHOTEXTURERESIDENCYMANAGER_H_
+
+#include <echo/Graphics/Texture.h>
+#include <echo/Graphics/TextureProcessor.h>
+#include <echo/Kernel/Mutex.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <unordered_map>
+#include <vector>
+
+namespace Echo
+{
+	class AxisAlignedBox;
+	class Camera;
+	class Material;
+	class SceneRenderable;
+	class TextureManager;
+
+	/**
+	 * TextureResidencyManager keeps a set of textures within a memory budget by changing their resolution.
+	 *
+	 * Each frame the renderer reports which textures were used and how large they appeared on screen, a Scene does
+	 * this when it has been given a residency manager, see Scene::SetTextureResidencyManager(). When Update() is
+	 * called at the end of the frame each texture is given the lowest resolution that still covers its size on
+	 * screen. Textures that haven't been used for a while drop to the minimum size. If the total is over budget
+	 * the least recently used and smallest on screen textures are reduced further, one mip level at a time, so
+	 * quality degrades gradually rather than running out of memory.
+	 *
+	 *		shared_ptr<TextureResidencyManager> residency(new TextureResidencyManager(textureManager, 256 * 1024 * 1024, workerPool));
+	 *		residency->AddTexture(textureManager.GetResource("Tile0"));
+	 *		scene.SetTextureResidencyManager(residency);
+	 *		...
+	 *		// Once per frame after rendering.
+	 *		residency->Update();
+	 *
+	 * Reducing a texture filters the data it already has, increasing a texture reloads it from its file. This
+	 * work is done on the worker pool if one is provided and the results are applied in Update(). Changing the
+	 * data increments the texture's version so render targets upload the new resolution, which means graphics
+	 * memory follows the same budget.
+	 *
+	 * Only textures loaded from a file by the TextureManager can be tracked since they need to be reloaded.
+	 * @note Usage can be reported from any thread but Update() should only be called from one thread at a time.
+	 */
+	class TextureResidencyManager
+	{
+	public:
+		struct Statistics
+		{
+			Statistics() : mTrackedTextures(0), mResidentBytes(0), mFullResolutionBytes(0), mBudget(0),
+				mPendingLoads(0), mReductions(0), mEvictions(0), mRestorations(0), mFailedLoads(0){}
+			Size mTrackedTextures;
+			Size mResidentBytes;		/// Bytes used by the tracked textures at their current resolution.
+			Size mFullResolutionBytes;	/// Bytes the tracked textures would use at full resolution.
+			Size mBudget;
+			Size mPendingLoads;			/// Resolution changes in progress.
+			Size mReductions;			/// Number of times a texture's resolution was reduced.
+			Size mEvictions;			/// Number of reductions that were only made to stay within the budget.
+			Size mRestorations;			/// Number of times a texture's resolution was increased.
+			Size mFailedLoads;			/// Number of resolution changes that failed.
+		};
+
+		/**
+		 * Constructor.
+		 * @param textureManager The TextureManager the tracked textures were loaded with.
+		 * @param budget The number of bytes the tracked textures can use.
+		 * @param workerPool Optional worker pool to load and filter textures on, without one changes are made
+		 * during Update().
+		 */
+		TextureResidencyManager(TextureManager& textureManager, Size budget, shared_ptr<WorkerPool> workerPool = shared_ptr<WorkerPool>());
+
+		/**
+		 * Destructor.
+		 * Waits for any changes in progress, textures are left at their current resolution.
+		 */
+		~TextureResidencyManager();
+
+		void SetBudget(Size budget);
+		Size GetBudget() const {return mBudget;}
+
+		/**
+		 * Set the size, in pixels, that the largest dimension of a texture won't be reduced below.
+		 * Textures that are already smaller than this are not reduced. The default is 32.
+		 */
+		void SetMinimumSize(u32 minimumSize);
+		u32 GetMinimumSize() const {return mMinimumSize;}
+
+		/**
+		 * Set the number of frames a texture can go unused before it is reduced to the minimum size.
+		 * The default is 120.
+		 */
+		void SetUnusedFrames(u32 frames) {mUnusedFrames = frames;}
+		u32 GetUnusedFrames() const {return mUnusedFrames;}
+
+		/**
+		 * Set the maximum number of resolution changes that can be in progress at once.
+		 * This limits how much memory loading can temporarily use and how much work is queued at once. The default
+		 * is 8.
+		 */
+		void SetMaximumPendingLoads(Size maximumPendingLoads) {mMaximumPendingLoads = maximumPendingLoads;}
+		Size GetMaximumPendingLoads() const {return mMaximumPendingLoads;}
+
+		/**
+		 * Start tracking a texture.
+		 * The texture is assumed to be at full resolution.
+		 * @return false if the texture is already tracked, wasn't loaded from a file by the TextureManager or its
+		 * format can't be filtered.
+		 */
+		bool AddTexture(shared_ptr<Texture> texture);
+
+		/**
+		 * Stop tracking a texture.
+		 * Any change in progress is waited for. The texture is left at its current resolution.
+		 * @return false if the texture isn't tracked.
+		 */
+		bool RemoveTexture(const Texture& texture);
+
+		/**
+		 * Record that a texture was used this frame.
+		 * Untracked textures are ignored.
+		 * @param texture The texture.
+		 * @param screenSize The number of pixels the texture spans on screen, the largest value reported during a
+		 * frame is used.
+		 */
+		void TextureUsed(const Texture& texture, f32 screenSize);
+
+		/**
+		 * Record that each texture used by a material was used this frame.
+		 */
+		void MaterialUsed(Material& material, f32 screenSize);
+
+		/**
+		 * Record that the textures used by a renderable were used this frame.
+		 * The screen size is estimated from the renderable's scene bounds. Only SceneEntities are supported.
+		 * @param renderable The renderable being rendered.
+		 * @param camera The camera the renderable is being rendered with.
+		 * @param viewportHeight The height of the viewport in pixels.
+		 */
+		void RenderableUsed(SceneRenderable& renderable, const Camera& camera, u32 viewportHeight);
+
+		/**
+		 * Apply completed changes and start new ones, then advance to the next frame.
+		 * Call this once per frame after rendering.
+		 */
+		void Update();
+
+		/**
+		 * Wait for all of the changes in progress and apply them.
+		 */
+		void WaitForPendingLoads();
+
+		/**
+		 * Get the mip level a tracked texture is currently at, 0 is full resolution.
+		 * @return The level or 0 if the texture isn't tracked.
+		 */
+		Size GetResidentLevel(const Texture& texture) const;
+
+		Statistics GetStatistics() const;
+
+		/**
+		 * Get the current frame number, this is incremented by Update().
+		 */
+		u64 GetFrame() const {return mFrame;}
+
+		/**
+		 * Estimate the number of pixels a bounding box spans on screen.
+		 * The box's bounding sphere is projected with the camera's projection.
+		 * @return The estimated diameter in pixels, if the camera is inside the sphere this is the viewport height.
+		 */
+		static f32 CalculateScreenSize(const AxisAlignedBox& box, const Camera& camera, u32 viewportHeight);
+	private:
+		/**
+		 * The result of a resolution change, filled in by a job.
+		 */
+		struct PendingLoad
+		{
+			WorkerPool::Counter mCounter;
+			Size mLevel;
+			Size mVersion;				/// The version of the texture when the change was started.
+			shared_ptr<Texture> mResult;
+		};
+		struct Entry
+		{
+			shared_ptr<Texture> mTexture;
+			std::string mFileName;
+			u32 mWidth;					/// Full resolution width.
+			u32 mHeight;				/// Full resolution height.
+			Size mBytesPerPixel;
+			Size mLowestLevel;			/// The level that reaches the minimum size.
+			Size mLevel;				/// The resident level.
+			Size mTargetLevel;
+			bool mOverBudget;			/// Whether the target level was reduced to stay within the budget.
+			bool mUsed;					/// Whether any use has been reported since the texture was added.
+			u64 mLastUsedFrame;
+			f32 mScreenSize;
+			shared_ptr<PendingLoad> mPendingLoad;
+		};
+		typedef std::unordered_map< const Texture*, Entry > EntryMap;
+
+		Size GetLevelBytes(const Entry& entry, Size level) const;
+		Size CalculateLowestLevel(const Entry& entry) const;
+		Size CalculateTargetLevel(const Entry& entry) const;
+		void SynchroniseLevel(Entry& entry);
+		void FinishLoad(Entry& entry);
+		void StartLoad(Entry& entry, Size level);
+		static shared_ptr<Texture> LoadLevel(TextureManager& textureManager, const TextureProcessor& processor,
+											const std::string& fileName, shared_ptr<Texture> source, u32 width, u32 height);
+
+		TextureManager& mTextureManager;
+		shared_ptr<WorkerPool> mWorkerPool;
+		TextureProcessor mProcessor;
+		mutable Mutex mMutex;
+		EntryMap mEntries;
+		Size mBudget;
+		u32 mMinimumSize;
+		u32 mUnusedFrames;
+		Size mMaximumPendingLoads;
+		u64 mFrame;
+		Statistics mStatistics;
+	};
+}
+#endif
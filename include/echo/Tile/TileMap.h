@@ -128,6 +128,12 @@ namespace Echo
 		void UpdateLayerMeshes();
 				
 		void Accept(SceneRenderableVisitor& visitor) override;
+
+		/**
+		 * Override from SceneRenderable.
+		 * @return true if the layer meshes are updated for cameras.
+		 */
+		bool GetBoundsDependOnCamera() const override {return mUpdateMeshForCameras;}
 		
 		/**
 		 * Get whether or not to update layers to only fill the camera view while rendering.
@@ -62,6 +62,8 @@
 #include <echo/Graphics/Colour.h>
 #include <map>
 #include <iostream>
+#include <atomic>
+#include <type_traits>
 #include <boost/regex.hpp>
 #include <boost/fusion/include/vector.hpp>
 #include <boost/fusion/include/invoke.hpp>
@@ -188,6 +190,17 @@ namespace Echo
 			}
 		};
 
+		/**
+		 * A call with its parameters already converted, created by BoundFunction::Prepare().
+		 */
+		class PreparedCall
+		{
+		public:
+			PreparedCall(){}
+			virtual ~PreparedCall(){}
+			virtual CallResult operator()() = 0;
+		};
+
 		struct AnyAssigner
 		{
 			template <typename T>
@@ -242,6 +255,40 @@ namespace Echo
 			 * @return A CallResult object with the status of the call and value on success.
 			 */
 			virtual CallResult operator()(FunctionBinder& binder, const std::vector< boost::any >& parameters) = 0;
+
+			/**
+			 * Convert the parameters for a call that will be made repeatedly so the conversion only happens once.
+			 * @param binder The binder required for conversions.
+			 * @param parameters The parameters in the same form as the string call operator.
+			 * @return The prepared call or null if the parameters need to be processed each time the function is
+			 * called, for example when a parameter is a nested call.
+			 */
+			virtual shared_ptr<PreparedCall> Prepare(FunctionBinder&, const std::vector< std::pair<std::string, bool> >&)
+			{
+				return shared_ptr<PreparedCall>();
+			}
+
+			/**
+			 * Check whether the function has the given return type and parameter sequence type.
+			 * This is used by Resolve() to check that the function can be invoked with Invoke().
+			 */
+			virtual bool HasSignature(const std::type_info&, const std::type_info&) const
+			{
+				return false;
+			}
+
+			/**
+			 * Invoke the function without any conversions.
+			 * This is used by TypedFunction, use Resolve() rather than calling this directly.
+			 * @param parameters Pointer to the parameter sequence, which must be the type checked by HasSignature().
+			 * @param returnValue Pointer to uninitialised storage that the return value is constructed in, or null
+			 * for void functions.
+			 */
+			virtual void Invoke(void*, void*)
+			{
+				// Resolve() checks HasSignature() first so this is only reached if a function is misused.
+				ECHO_LOG_ERROR("Function " << GetName() << " does not support direct invocation. The return value has not been constructed.");
+			}
 			
 			/**
 			 * Overload to allow you to call this function more naturally.
@@ -724,6 +771,88 @@ namespace Echo
 			}
 		};
 
+		//! \brief Class used to invoke functions and construct the return value in caller provided storage.
+		template<typename Function, class ParameterSequence, typename ReturnType>
+		class SequenceInvoker
+		{
+		public:
+			void operator()(Function& funct, ParameterSequence& parameters, void* returnValue)
+			{
+				typedef typename std::decay<ReturnType>::type ValueType;
+				new (returnValue) ValueType(boost::fusion::invoke(funct,parameters));
+			}
+		};
+
+		//! \brief Specialisation for functions with a void return type.
+		template<typename Function, class ParameterSequence>
+		class SequenceInvoker<Function,ParameterSequence,void>
+		{
+		public:
+			void operator()(Function& funct, ParameterSequence& parameters, void*)
+			{
+				boost::fusion::invoke(funct,parameters);
+			}
+		};
+
+		/**
+		 * A handle to a bound function that is called with native arguments, created by Resolve().
+		 * Calling a TypedFunction costs a virtual call and copying the arguments into a parameter sequence. There
+		 * is no parsing, conversion, heap allocation of the return value or function look up.
+		 * The handle keeps the function it resolved even if the function is later deregistered.
+		 */
+		template<typename Signature>
+		class TypedFunction;
+
+		template<typename ReturnType, typename ...Parameters>
+		class TypedFunction<ReturnType(Parameters...)>
+		{
+		public:
+			static_assert(!std::is_reference<ReturnType>::value, "TypedFunction return types must be values.");
+			typedef ReturnType ResultType;
+			typedef boost::fusion::vector<Parameters...> ParameterSequence;
+
+			TypedFunction(){}
+
+			/**
+			 * Check whether the handle is valid. Calling an invalid handle is undefined.
+			 */
+			explicit operator bool() const
+			{
+				return mFunction!=nullptr;
+			}
+
+			ReturnType operator()(Parameters... parameters) const
+			{
+				ParameterSequence sequence(parameters...);
+				return Invoke(sequence, std::is_void<ReturnType>());
+			}
+
+			const shared_ptr<BoundFunction>& GetFunction() const
+			{
+				return mFunction;
+			}
+		private:
+			friend class FunctionBinder;
+			explicit TypedFunction(shared_ptr<BoundFunction> function) : mFunction(function){}
+
+			ReturnType Invoke(ParameterSequence& sequence, std::true_type) const
+			{
+				mFunction->Invoke(&sequence, nullptr);
+			}
+
+			ReturnType Invoke(ParameterSequence& sequence, std::false_type) const
+			{
+				typename std::aligned_storage<sizeof(ReturnType), alignof(ReturnType)>::type storage;
+				mFunction->Invoke(&sequence, &storage);
+				ReturnType& returned = *reinterpret_cast<ReturnType*>(&storage);
+				ReturnType result(std::move(returned));
+				returned.~ReturnType();
+				return result;
+			}
+
+			shared_ptr<BoundFunction> mFunction;
+		};
+
 		template< typename Function, typename ParameterSequence>
 		class StringFunction : public BoundFunction
 		{
@@ -820,6 +949,52 @@ namespace Echo
 				return CallResult(CallStatuses::SUCCESS, invoker(mFunction,parameters));
 			}
 
+			shared_ptr<PreparedCall> Prepare(FunctionBinder& binder, const std::vector< std::pair<std::string, bool> >& inputParameters) override
+			{
+				using namespace boost;
+
+				if(!mAllowedDefaultParameters)
+				{
+					size_t numParams = fusion::size(mParameters);
+					if(inputParameters.size()<numParams)
+					{
+						return shared_ptr<PreparedCall>();
+					}
+				}
+
+				// Nested calls have to be made each time.
+				if(mNestedCalls)
+				{
+					for(size_t p = 0; p < inputParameters.size(); ++p)
+					{
+						if(inputParameters[p].second)
+						{
+							return shared_ptr<PreparedCall>();
+						}
+					}
+				}
+
+				ParameterSequence parameters = mParameters;
+				Converter converter(binder, mNestedCalls, inputParameters);
+				fusion::for_each(parameters,std::ref(converter));
+				if(converter.Failed())
+				{
+					return shared_ptr<PreparedCall>();
+				}
+				return Echo::make_shared<Prepared>(*this, parameters);
+			}
+
+			bool HasSignature(const std::type_info& returnType, const std::type_info& parameterSequence) const override
+			{
+				return returnType==typeid(ReturnType) && parameterSequence==typeid(ParameterSequence);
+			}
+
+			void Invoke(void* parameters, void* returnValue) override
+			{
+				SequenceInvoker<Function, ParameterSequence, ReturnType> invoker;
+				invoker(mFunction, *static_cast<ParameterSequence*>(parameters), returnValue);
+			}
+
 			std::string GetReturnType() const override
 			{
 				return typeid(ReturnType).name();
@@ -856,6 +1031,20 @@ namespace Echo
 				return mNestedCalls;
 			}
 		private:
+			class Prepared : public PreparedCall
+			{
+			public:
+				Prepared(StringFunction& function, const ParameterSequence& parameters) : mFunction(function), mParameters(parameters){}
+				CallResult operator()() override
+				{
+					Invoker<Function, ParameterSequence, ReturnType> invoker;
+					return CallResult(CallStatuses::SUCCESS, invoker(mFunction.mFunction,mParameters));
+				}
+			private:
+				StringFunction& mFunction;			//!< Kept alive by the CompiledCall that owns this object.
+				ParameterSequence mParameters;
+			};
+
 			std::string mName;
 			Function mFunction;
 			ParameterSequence mParameters;
@@ -863,6 +1052,36 @@ namespace Echo
 			bool mNestedCalls;
 		};
 
+		/**
+		 * A call string that has been split and resolved to a bound function by Compile().
+		 * Calling a CompiledCall skips the regular expression, the lookup and, unless a parameter is a nested call,
+		 * the parameter conversions. The call is compiled again automatically when a binding that could affect
+		 * it changes, such as a function being registered or deregistered on the binder or one of its fallbacks.
+		 * @note Changing BoundFunction::SetNestedCalls() does not cause a recompile.
+		 */
+		class CompiledCall
+		{
+		public:
+			CompiledCall() : mCompiledBy(nullptr), mOwner(nullptr), mRevision(0){}
+			CompiledCall(const std::string& function) : mFunction(function), mCompiledBy(nullptr), mOwner(nullptr), mRevision(0){}
+
+			const std::string& GetFunction() const {return mFunction;}
+
+			/**
+			 * Get whether the function was found when the call was last compiled.
+			 */
+			bool GetResolved() const {return mBoundFunction!=nullptr;}
+		private:
+			friend class FunctionBinder;
+			std::string mFunction;
+			FunctionBinder* mCompiledBy;			//!< The binder the call was compiled with.
+			FunctionBinder* mOwner;					//!< The binder in the fallback chain the function was found in.
+			Size mRevision;							//!< The revision of mCompiledBy when the call was compiled.
+			shared_ptr<BoundFunction> mBoundFunction;
+			std::vector< std::pair<std::string, bool> > mParameters;
+			shared_ptr<PreparedCall> mPreparedCall;
+		};
+
 		template<typename Function, class ParameterSequence >
 		bool Register(const std::string& name, Function funct, bool allowedDefaults = false, ParameterSequence defaultParameters = ParameterSequence())
 		{
@@ -873,6 +1092,7 @@ namespace Echo
 
 			shared_ptr< StringFunction<Function, ParameterSequence> > f = Echo::make_shared< StringFunction<Function, ParameterSequence> >(name,funct,allowedDefaults,defaultParameters);
 			mBindings.insert(std::make_pair(name,f));
+			mRevision = NextRevision();
 			return true;
 		}
 
@@ -895,6 +1115,7 @@ namespace Echo
 				return false;
 			}
 			mBindings.insert(std::make_pair(name,funct));
+			mRevision = NextRevision();
 			return true;
 		}
 
@@ -906,6 +1127,7 @@ namespace Echo
 				return false;
 			}
 			mBindings.erase(it);
+			mRevision = NextRevision();
 			return true;
 		}
 		
@@ -942,6 +1164,138 @@ namespace Echo
 			return funct(*this,parameters);
 		}
 
+		/**
+		 * Compile a call string so it can be called repeatedly with Call(CompiledCall&) without being parsed each time.
+		 * @param function The call string, in the same format as Call(const std::string&).
+		 * @return The compiled call. If the function could not be found the call will fail with FUNCTION_NOT_FOUND
+		 * until a binding change allows it to be found.
+		 */
+		CompiledCall Compile(const std::string& function)
+		{
+			CompiledCall call(function);
+			Link(call);
+			return call;
+		}
+
+		/**
+		 * Make a compiled call.
+		 * The call is compiled again first if it was compiled by a different binder or the bindings have changed.
+		 */
+		CallResult Call(CompiledCall& call)
+		{
+			if(call.mCompiledBy!=this || call.mRevision!=GetRevision())
+			{
+				Link(call);
+			}
+			if(!call.mBoundFunction)
+			{
+				return CallResult(CallStatuses::FUNCTION_NOT_FOUND);
+			}
+			if(call.mPreparedCall)
+			{
+				return (*call.mPreparedCall)();
+			}
+			return (*call.mBoundFunction)(*call.mOwner, call.mParameters);
+		}
+
+		/**
+		 * Get the revision of the bindings.
+		 * The revision changes whenever something that affects how a call string is processed changes on this
+		 * binder or its fallback chain.
+		 */
+		Size GetRevision() const
+		{
+			if(mFallbackBinder)
+			{
+				return std::max(mRevision, mFallbackBinder->GetRevision());
+			}
+			return mRevision;
+		}
+
+		/**
+		 * Resolve a function to a handle that can be called with native arguments.
+		 * For example:
+		 *
+		 *		binder.Register("See",bind(&See,placeholders::_1,placeholders::_2),false,boost::fusion::vector<int,std::string>());
+		 *		FunctionBinder::TypedFunction<std::string(int,std::string)> see = binder.Resolve<std::string(int,std::string)>("See");
+		 *		if(see)
+		 *		{
+		 *			std::string result = see(6,"six");
+		 *		}
+		 *
+		 * @param name The name of the function, the fallback binder is searched if it isn't found.
+		 * @return The handle, which is invalid if the function wasn't found or the return type and parameter types
+		 * don't exactly match the types the function was registered with.
+		 */
+		template<typename Signature>
+		TypedFunction<Signature> Resolve(const std::string& name) const
+		{
+			typedef typename TypedFunction<Signature>::ResultType ResultType;
+			typedef typename TypedFunction<Signature>::ParameterSequence ParameterSequence;
+			shared_ptr<BoundFunction> function = GetFunction(name);
+			if(!function)
+			{
+				return TypedFunction<Signature>();
+			}
+			if(!function->HasSignature(typeid(ResultType),typeid(ParameterSequence)))
+			{
+				ECHO_LOG_ERROR("Unable to resolve \"" << name << "\" as " << DemangleName(typeid(Signature).name()) << ". Return type is "
+							<< DemangleName(function->GetReturnType()) << " and parameters are " << function->GetParameters());
+				return TypedFunction<Signature>();
+			}
+			return TypedFunction<Signature>(function);
+		}
+
+		typedef std::vector<CompiledCall> CompiledScript;
+
+		/**
+		 * Compile a script of calls, one per line, so it can be run with Call(CompiledScript&).
+		 * Empty lines are skipped.
+		 */
+		CompiledScript CompileScript(const std::string& script)
+		{
+			std::vector<std::string> lines;
+			boost::algorithm::split(lines, script, boost::is_any_of("\n"));
+			return CompileScript(lines);
+		}
+
+		CompiledScript CompileScript(const std::vector<std::string>& lines)
+		{
+			CompiledScript compiled;
+			compiled.reserve(lines.size());
+			for(size_t l = 0; l < lines.size(); ++l)
+			{
+				std::string line = boost::algorithm::trim_copy(lines[l]);
+				if(!line.empty())
+				{
+					compiled.push_back(Compile(line));
+				}
+			}
+			return compiled;
+		}
+
+		/**
+		 * Run a compiled script.
+		 * @return The number of calls that succeeded.
+		 */
+		Size Call(CompiledScript& script)
+		{
+			Size successful = 0;
+			for(size_t c = 0; c < script.size(); ++c)
+			{
+				CallStatus status = Call(script[c]).mStatus;
+				if(status==CallStatuses::SUCCESS)
+				{
+					successful++;
+				}else
+				if(status==CallStatuses::FUNCTION_NOT_FOUND)
+				{
+					ECHO_LOG_ERROR("Function not found for script call: " << script[c].GetFunction());
+				}
+			}
+			return successful;
+		}
+
 		template<typename ReturnType>
 		CallResult Call(const std::string& function, ReturnType* returnValue)
 		{
@@ -1038,7 +1392,9 @@ namespace Echo
 
 		//!\ brief Default constructor
 		FunctionBinder() :	mFunctionRegEx(R"EOF(([^\(]*)\s*\(\s*([\S+\n\r\s]*)\))EOF"),	//Basic normal function usage, Function(parameters).
+				mFunctionExpression(mFunctionRegEx),
 				mStreamPrecision(16),
+				mRevision(NextRevision()),
 				OPEN_PARENTHESIS('('),
 				CLOSE_PARENTHESIS(')'),
 				QUOTATION_MARK( '"'),
@@ -1060,6 +1416,8 @@ namespace Echo
 		void SetFunctionRegEx(const std::string& regex)
 		{
 			mFunctionRegEx = regex;
+			mFunctionExpression = regex;
+			mRevision = NextRevision();
 		}
 
 		const std::string& GetFunctionRegEx() const
@@ -1075,6 +1433,7 @@ namespace Echo
 		void AddEscapedCharacter(char escapeCharacter, char replacedWith)
 		{
 			mEscapeCharacters.insert(std::make_pair(escapeCharacter,replacedWith));
+			mRevision = NextRevision();
 		}
 
 		/**
@@ -1086,6 +1445,7 @@ namespace Echo
 		void SetFallback(shared_ptr<FunctionBinder> fallbackBinder)
 		{
 			mFallbackBinder = fallbackBinder;
+			mRevision = NextRevision();
 		}
 		
 		/**
@@ -1096,6 +1456,7 @@ namespace Echo
 		void SetStreamPrecision(Size streamPrecision)
 		{
 			mStreamPrecision = streamPrecision;
+			mRevision = NextRevision();
 		}
 
 		/**
@@ -1148,15 +1509,51 @@ namespace Echo
 			Register("Colour",[](f32 r, f32 g, f32 b, f32 a){return Colour(r,g,b,a);},false,boost::fusion::vector<f32,f32,f32,f32>());
 		}
 	private:
-		std::string SplitLine(const std::string& line, std::vector< std::pair<std::string, bool> > & parameters) const
+		/**
+		 * Revisions are unique across all binders so the maximum revision in a fallback chain changes when any
+		 * binder in the chain changes, including when a fallback is replaced.
+		 */
+		static Size NextRevision()
 		{
-			boost::regex functionExpression(mFunctionRegEx);
+			static std::atomic<Size> revision(0);
+			return ++revision;
+		}
 
+		void Link(CompiledCall& call)
+		{
+			call.mCompiledBy = this;
+			call.mRevision = GetRevision();
+			call.mOwner = nullptr;
+			call.mBoundFunction.reset();
+			call.mParameters.clear();
+			call.mPreparedCall.reset();
+
+			// Follow the fallback chain in the same way as Call(const std::string&).
+			FunctionBinder* binder = this;
+			while(binder)
+			{
+				std::vector< std::pair<std::string, bool> > parameters;
+				std::string functionName = binder->SplitLine(call.mFunction,parameters);
+				BindingIterator it = binder->mBindings.find(functionName);
+				if(it!=binder->mBindings.end())
+				{
+					call.mOwner = binder;
+					call.mBoundFunction = it->second;
+					call.mPreparedCall = it->second->Prepare(*binder, parameters);
+					call.mParameters.swap(parameters);
+					return;
+				}
+				binder = binder->mFallbackBinder.get();
+			}
+		}
+
+		std::string SplitLine(const std::string& line, std::vector< std::pair<std::string, bool> > & parameters) const
+		{
 			boost::cmatch matches;
 			std::string functionName;
 
 			//Split up the line into function and parameters.
-			if(boost::regex_match(line.c_str(), matches, functionExpression))
+			if(boost::regex_match(line.c_str(), matches, mFunctionExpression))
 			{
 				// what[0] contains the whole string 
 				// what[1] contains the function name
@@ -1265,7 +1662,9 @@ namespace Echo
 		}
 
 		std::string mFunctionRegEx;				//!< Regular expression used to extract function name and the parameter block from the calling string.
+		boost::regex mFunctionExpression;		//!< mFunctionRegEx compiled, so it isn't compiled for every call.
 		Size mStreamPrecision;					//!< The precision used for value conversions with streams.
+		Size mRevision;							//!< Changes when bindings or parsing settings change, see GetRevision().
 		typedef std::map<std::string, shared_ptr<BoundFunction> >::iterator BindingIterator;
 		typedef std::map<std::string, shared_ptr<BoundFunction> >::const_iterator ConstBindingIterator;
 		std::map<std::string, shared_ptr<BoundFunction> > mBindings;
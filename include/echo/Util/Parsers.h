@@ -11,6 +11,7 @@
 #include <echo/cpp/functional>
 
 #include <vector>
+#include <map>
 
 namespace Echo
 {
@@ -184,6 +185,70 @@ namespace Echo
 			qi::rule<std::string::const_iterator, double(), ascii::space_type> expression, term, factor, variable;
 		};
 
+		/**
+		 * A conditional expression compiled by ConditionalEvaluator::Compile().
+		 * The expression is stored as instructions for a small stack machine so evaluating it doesn't involve any
+		 * parsing. Variables registered with the evaluator are read through slots shared with the evaluator, so
+		 * registering or deregistering a variable after compiling takes effect without compiling again. Other
+		 * symbols are looked up through the evaluator's FunctionBinder each time, as Parse() does.
+		 */
+		class CompiledConditional
+		{
+		public:
+			/**
+			 * Evaluate the expression.
+			 * @return The result, or none if a symbol look up failed.
+			 */
+			optional<bool> Evaluate() const;
+
+			const std::string& GetExpression() const {return mExpression;}
+		private:
+			friend struct ConditionalEvaluator;
+			struct OpCodes
+			{
+				enum _
+				{
+					PUSH_CONSTANT,
+					PUSH_VARIABLE,
+					NEGATE,
+					ADD,
+					SUBTRACT,
+					MULTIPLY,
+					DIVIDE,
+					MODULUS,
+					GREATER,
+					LESS,
+					EQUAL,
+					NOT_EQUAL,
+					GREATER_EQUAL,
+					LESS_EQUAL,
+					AND,
+					OR
+				};
+			};
+			typedef OpCodes::_ OpCode;
+
+			struct Instruction
+			{
+				Instruction(OpCode opCode, double constant = 0, Size variable = 0) : mOpCode(opCode), mConstant(constant), mVariable(variable){}
+				OpCode mOpCode;
+				double mConstant;
+				Size mVariable;			//!< Index into mVariables.
+			};
+
+			struct Variable
+			{
+				std::string mSymbol;
+				function<double()> mGetter;	//!< Empty if the symbol isn't a registered variable.
+			};
+
+			std::string mExpression;
+			std::vector<Instruction> mInstructions;
+			std::vector< shared_ptr<Variable> > mVariables;
+			shared_ptr<FunctionBinder> mBinder;
+			mutable std::vector<double> mStack;
+		};
+
 		/**
 		 * Evaluates statements into true or false.
 		 * Supports && and ||.
@@ -287,6 +352,23 @@ namespace Echo
 			 * returned will be false when converted to a bool.
 			 */
 			optional<bool> Parse(const std::string& expression) const;
+
+			/**
+			 * Compile an expression so it can be evaluated repeatedly without parsing.
+			 * The expression is compiled with the same rules as Parse().
+			 * @param expression The expression to compile.
+			 * @return The compiled expression or null if the expression could not be parsed.
+			 */
+			shared_ptr<CompiledConditional> Compile(const std::string& expression) const;
+
+			/**
+			 * Evaluate an expression, compiling it the first time it is seen.
+			 * This gives the same results as Parse() but each expression is only parsed once.
+			 * @param expression The expression to evaluate.
+			 * @return If the expression is successfully evaluated the result, otherwise the object
+			 * returned will be false when converted to a bool.
+			 */
+			optional<bool> Evaluate(const std::string& expression) const;
 			
 			/**
 			 * Get the function binder.
@@ -295,6 +377,13 @@ namespace Echo
 			shared_ptr<FunctionBinder> GetFunctionBinder() { return mBinder; }
 
 		private:
+			class Compiler;
+
+			/**
+			 * Get the slot for a symbol, creating it if needed.
+			 */
+			shared_ptr<CompiledConditional::Variable> GetVariable(const std::string& symbol) const;
+
 			/**
 			 * Internal method called to get a value via the function binder.
 			 * The symbol used in an expression is used as the function.
@@ -317,6 +406,8 @@ namespace Echo
 			qi::rule<std::string::const_iterator, double(), ascii::space_type> expression, term, factor, variable;
 			qi::rule<std::string::const_iterator, bool(), qi::locals<double>, ascii::space_type> condition;
 			qi::rule<std::string::const_iterator, bool(), qi::locals<bool>, ascii::space_type> compoundCondition;
+			mutable std::map< std::string, shared_ptr<CompiledConditional::Variable> > mVariables;
+			mutable std::map< std::string, shared_ptr<CompiledConditional> > mCompiledConditionals;
 		};
 		
 		/**
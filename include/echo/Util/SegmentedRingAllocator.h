@@ -0,0 +1,117 @@
+#ifndef _ECHOSEGMENTEDRINGALLOCATOR_H_
+#define _ECHOSEGMENTEDRINGALLOCATOR_H_
+
+#include <echo/Types.h>
+
+namespace Echo
+{
+	/**
+	 * SegmentedRingAllocator allocates aligned ranges from a ring buffer that is divided into segments.
+	 *
+	 * Ranges are allocated one after another within the current segment. When a range doesn't fit in the
+	 * remainder of the current segment allocation moves to the start of the next segment, wrapping around to the
+	 * first segment after the last. Moving to a segment reuses it, so every range previously allocated from
+	 * that segment is overwritten from then on. The owner of the memory is expected to synchronise when a
+	 * segment is started, for example by waiting for a fence.
+	 *
+	 * Every segment that is started is given a sequence number, which increases for the life of the allocator.
+	 * Users keep the sequence number of their allocation and use IsCurrent() to find out whether the range
+	 * still holds their data.
+	 *
+	 * This class only manages offsets, it does not own any memory. See GLUniformRingBuffer.
+	 */
+	class SegmentedRingAllocator
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param size The size of the ring. It is rounded down so each segment is a multiple of the alignment.
+		 * @param numberOfSegments The number of segments, at least one.
+		 * @param alignment The alignment of each range, at least one.
+		 */
+		SegmentedRingAllocator(Size size, Size numberOfSegments, Size alignment) :
+			mNumberOfSegments(numberOfSegments > 0 ? numberOfSegments : 1),
+			mAlignment(alignment > 0 ? alignment : 1),
+			mHead(0),
+			mSequence(0)
+		{
+			mSegmentSize = (size / mNumberOfSegments) / mAlignment * mAlignment;
+		}
+
+		/**
+		 * Allocate a range.
+		 * @param size The size of the range, which must not be larger than the segment size.
+		 * @param offsetOut The offset of the range from the start of the ring.
+		 * @param startedSegmentOut Set to true if the allocation started a new segment, otherwise false.
+		 * @return false if the range is larger than a segment.
+		 */
+		bool Allocate(Size size, Size& offsetOut, bool& startedSegmentOut)
+		{
+			startedSegmentOut = false;
+			if(size > mSegmentSize)
+			{
+				return false;
+			}
+			Size offset = (mHead + mAlignment - 1) / mAlignment * mAlignment;
+			if(offset + size > (GetSegment() + 1) * mSegmentSize)
+			{
+				++mSequence;
+				offset = GetSegment() * mSegmentSize;
+				startedSegmentOut = true;
+			}
+			mHead = offset + size;
+			offsetOut = offset;
+			return true;
+		}
+
+		/**
+		 * Get the index of the segment that ranges are currently allocated from.
+		 */
+		Size GetSegment() const
+		{
+			return static_cast<Size>(mSequence % mNumberOfSegments);
+		}
+
+		/**
+		 * Get the sequence number of the segment that ranges are currently allocated from.
+		 */
+		u64 GetSequence() const
+		{
+			return mSequence;
+		}
+
+		/**
+		 * Get whether ranges allocated while the sequence number was the specified value are still intact.
+		 * A range is overwritten once its segment is started again, which is NumberOfSegments sequence numbers later.
+		 */
+		bool IsCurrent(u64 sequence) const
+		{
+			return sequence <= mSequence && mSequence - sequence < mNumberOfSegments;
+		}
+
+		Size GetSegmentSize() const
+		{
+			return mSegmentSize;
+		}
+
+		Size GetNumberOfSegments() const
+		{
+			return mNumberOfSegments;
+		}
+
+		/**
+		 * Get the usable size of the ring, which is the segment size multiplied by the number of segments.
+		 */
+		Size GetSize() const
+		{
+			return mSegmentSize * mNumberOfSegments;
+		}
+	private:
+		Size mNumberOfSegments;
+		Size mAlignment;
+		Size mSegmentSize;
+		Size mHead;
+		u64 mSequence;
+	};
+}
+#endif
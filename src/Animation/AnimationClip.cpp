@@ -0,0 +1,434 @@
+#include <echo/Animation/AnimationClip.h>
+#include <echo/Animation/SkeletonAnimation.h>
+#include <echo/Animation/AnimationTrack.h>
+#include <echo/Animation/BoneKeyFrame.h>
+#include <echo/Animation/Skeleton.h>
+#include <echo/Animation/Bone.h>
+#include <echo/Maths/EchoMaths.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Echo
+{
+	namespace
+	{
+		const f32 QUANTISED_ORIENTATION_SCALE = 32767.f;
+
+		/**
+		 * Select the keys needed to reproduce a channel within a tolerance using linear interpolation.
+		 * The first and last keys are always kept and a channel with all equal keys is reduced to one key.
+		 * @param error Function that returns the error of key i when interpolating between keys a and b.
+		 * @param equal Function that returns whether keys a and b are equal.
+		 */
+		template< class Key, class ErrorFunction, class EqualFunction >
+		std::vector<Size> SelectKeys(const std::vector<Key>& keys, f32 tolerance, ErrorFunction error, EqualFunction equal)
+		{
+			std::vector<Size> selected;
+			selected.push_back(0);
+			bool constant = true;
+			for(Size k = 1; k < keys.size() && constant; ++k)
+			{
+				constant = equal(0, k);
+			}
+			if(constant)
+			{
+				return selected;
+			}
+			if(tolerance <= 0.f)
+			{
+				for(Size k = 1; k < keys.size(); ++k)
+				{
+					selected.push_back(k);
+				}
+				return selected;
+			}
+			Size anchor = 0;
+			for(Size end = 2; end < keys.size(); ++end)
+			{
+				for(Size k = anchor + 1; k < end; ++k)
+				{
+					if(error(anchor, end, k) > tolerance)
+					{
+						// The previous key is needed.
+						anchor = end - 1;
+						selected.push_back(anchor);
+						break;
+					}
+				}
+			}
+			selected.push_back(keys.size() - 1);
+			return selected;
+		}
+
+		template< class Key >
+		f32 Fraction(const std::vector<Key>& keys, Size a, Size b, Size k)
+		{
+			f32 length = keys[b].mTime - keys[a].mTime;
+			return (length > 0.f) ? (keys[k].mTime - keys[a].mTime) / length : 0.f;
+		}
+	}
+
+	AnimationClip::AnimationClip(const SkeletonAnimation& animation, const CompressionOptions& options) :
+		mName(animation.GetName()),
+		mLength(static_cast<f32>(animation.GetLength().count())),
+		mOptions(options)
+	{
+		std::vector<Key> keys;
+		typedef std::pair< const size_t, shared_ptr<AnimationTrack> > IndexTrackPair;
+		for(const IndexTrackPair& indexTrack : animation.GetAnimationTracks())
+		{
+			const std::vector< shared_ptr<KeyFrame> >& keyFrames = indexTrack.second->GetKeyFrames();
+			if(keyFrames.empty())
+			{
+				continue;
+			}
+			keys.clear();
+			for(const shared_ptr<KeyFrame>& keyFrame : keyFrames)
+			{
+				const BoneKeyFrame& boneKeyFrame = static_cast<const BoneKeyFrame&>(*keyFrame);
+				Key key = {static_cast<f32>(boneKeyFrame.mTime.count()), boneKeyFrame.mPosition, boneKeyFrame.mOrientation, boneKeyFrame.mScale};
+				keys.push_back(key);
+			}
+			std::stable_sort(keys.begin(), keys.end(), [](const Key& a, const Key& b){return a.mTime < b.mTime;});
+
+			if(options.mSampleRate > 0.f && keys.size() > 1)
+			{
+				// Resample between the first and last key so every channel has evenly spaced keys.
+				std::vector<Key> source;
+				source.swap(keys);
+				f32 startTime = source.front().mTime;
+				f32 length = source.back().mTime - startTime;
+				Size numberOfIntervals = std::max<Size>(1, static_cast<Size>(std::ceil(length * options.mSampleRate)));
+				Size s = 0;
+				for(Size i = 0; i <= numberOfIntervals; ++i)
+				{
+					f32 time = startTime + length * (static_cast<f32>(i) / numberOfIntervals);
+					while(s + 2 < source.size() && source[s + 1].mTime <= time)
+					{
+						++s;
+					}
+					const Key& a = source[s];
+					const Key& b = source[s + 1];
+					f32 fraction = (b.mTime > a.mTime) ? Maths::Clamp((time - a.mTime) / (b.mTime - a.mTime), 0.f, 1.f) : 0.f;
+					Key key = {time,
+								Maths::LinearInterpolate(a.mPosition, b.mPosition, fraction),
+								a.mOrientation.Nlerp(b.mOrientation, fraction, true),
+								Maths::LinearInterpolate(a.mScale, b.mScale, fraction)};
+					keys.push_back(key);
+				}
+			}
+
+			Track track;
+			track.mBoneIndex = indexTrack.first;
+			AddVectorChannel(track.mPosition, keys, &Key::mPosition, options.mPositionTolerance, mPositionTimes, mPositions, mQuantisedPositions);
+			AddOrientationChannel(track.mOrientation, keys, options.mOrientationTolerance);
+			AddVectorChannel(track.mScale, keys, &Key::mScale, options.mScaleTolerance, mScaleTimes, mScales, mQuantisedScales);
+			mTracks.push_back(track);
+		}
+		mTracks.shrink_to_fit();
+		mPositionTimes.shrink_to_fit();
+		mOrientationTimes.shrink_to_fit();
+		mScaleTimes.shrink_to_fit();
+		mPositions.shrink_to_fit();
+		mOrientations.shrink_to_fit();
+		mScales.shrink_to_fit();
+		mQuantisedPositions.shrink_to_fit();
+		mQuantisedOrientations.shrink_to_fit();
+		mQuantisedScales.shrink_to_fit();
+	}
+
+	AnimationClip::~AnimationClip()
+	{
+	}
+
+	void AnimationClip::AddVectorChannel(Channel& channel, const std::vector<Key>& keys, Vector3 Key::* member, f32 tolerance,
+							std::vector<f32>& times, std::vector<Vector3>& values, std::vector<u16>& quantisedValues)
+	{
+		std::vector<Size> selected = SelectKeys(keys, tolerance,
+			[&keys, member](Size a, Size b, Size k)
+			{
+				Vector3 interpolated = Maths::LinearInterpolate(keys[a].*member, keys[b].*member, Fraction(keys, a, b, k));
+				return interpolated.Distance(keys[k].*member);
+			},
+			[&keys, member](Size a, Size b)
+			{
+				return (keys[a].*member)==(keys[b].*member);
+			});
+
+		channel.mFirstKey = static_cast<u32>(times.size());
+		channel.mNumberOfKeys = static_cast<u32>(selected.size());
+		channel.mMinimum = Vector3::ZERO;
+		channel.mStep = Vector3::ZERO;
+		for(Size k : selected)
+		{
+			times.push_back(keys[k].mTime);
+		}
+		SetTiming(channel, times);
+
+		if(!mOptions.mQuantise)
+		{
+			for(Size k : selected)
+			{
+				values.push_back(keys[k].*member);
+			}
+			return;
+		}
+
+		Vector3 minimum = keys[selected.front()].*member;
+		Vector3 maximum = minimum;
+		for(Size k : selected)
+		{
+			minimum.MakeFloor(keys[k].*member);
+			maximum.MakeCeil(keys[k].*member);
+		}
+		channel.mMinimum = minimum;
+		channel.mStep = (maximum - minimum) / 65535.f;
+		for(Size k : selected)
+		{
+			const Vector3& value = keys[k].*member;
+			const f32 components[3] = {value.x - minimum.x, value.y - minimum.y, value.z - minimum.z};
+			const f32 steps[3] = {channel.mStep.x, channel.mStep.y, channel.mStep.z};
+			for(Size c = 0; c < 3; ++c)
+			{
+				quantisedValues.push_back((steps[c] > 0.f) ? static_cast<u16>(Maths::Clamp(std::round(components[c] / steps[c]), 0.f, 65535.f)) : 0);
+			}
+		}
+	}
+
+	void AnimationClip::AddOrientationChannel(Channel& channel, const std::vector<Key>& keys, f32 tolerance)
+	{
+		std::vector<Size> selected = SelectKeys(keys, tolerance,
+			[&keys](Size a, Size b, Size k)
+			{
+				Quaternion interpolated = keys[a].mOrientation.Nlerp(keys[b].mOrientation, Fraction(keys, a, b, k), true);
+				f32 dot = std::min(std::abs(interpolated.Dot(keys[k].mOrientation.Normalised())), 1.f);
+				return 2.f * std::acos(dot);
+			},
+			[&keys](Size a, Size b)
+			{
+				return keys[a].mOrientation==keys[b].mOrientation;
+			});
+
+		channel.mFirstKey = static_cast<u32>(mOrientationTimes.size());
+		channel.mNumberOfKeys = static_cast<u32>(selected.size());
+		channel.mMinimum = Vector3::ZERO;
+		channel.mStep = Vector3::ZERO;
+		for(Size k : selected)
+		{
+			mOrientationTimes.push_back(keys[k].mTime);
+			Quaternion orientation = keys[k].mOrientation.Normalised();
+			if(mOptions.mQuantise)
+			{
+				mQuantisedOrientations.push_back(static_cast<s16>(std::round(orientation.w * QUANTISED_ORIENTATION_SCALE)));
+				mQuantisedOrientations.push_back(static_cast<s16>(std::round(orientation.x * QUANTISED_ORIENTATION_SCALE)));
+				mQuantisedOrientations.push_back(static_cast<s16>(std::round(orientation.y * QUANTISED_ORIENTATION_SCALE)));
+				mQuantisedOrientations.push_back(static_cast<s16>(std::round(orientation.z * QUANTISED_ORIENTATION_SCALE)));
+			}else
+			{
+				mOrientations.push_back(orientation);
+			}
+		}
+		SetTiming(channel, mOrientationTimes);
+	}
+
+	void AnimationClip::SetTiming(Channel& channel, const std::vector<f32>& times)
+	{
+		const f32* channelTimes = &times[channel.mFirstKey];
+		channel.mStartTime = channelTimes[0];
+		channel.mInverseInterval = 0.f;
+		if(channel.mNumberOfKeys < 2)
+		{
+			return;
+		}
+		u32 last = channel.mNumberOfKeys - 1;
+		f32 interval = (channelTimes[last] - channelTimes[0]) / last;
+		if(interval <= 0.f)
+		{
+			return;
+		}
+		for(u32 k = 1; k < last; ++k)
+		{
+			if(std::abs(channelTimes[k] - (channel.mStartTime + interval * k)) > interval * 0.1f)
+			{
+				return;
+			}
+		}
+		channel.mInverseInterval = 1.f / interval;
+	}
+
+	inline u32 AnimationClip::FindKey(const Channel& channel, const std::vector<f32>& times, f32 time, f32& fraction) const
+	{
+		fraction = 0.f;
+		u32 last = channel.mNumberOfKeys - 1;
+		if(last==0 || time <= channel.mStartTime)
+		{
+			return channel.mFirstKey;
+		}
+		const f32* begin = &times[channel.mFirstKey];
+		const f32* end = begin + channel.mNumberOfKeys;
+		if(time >= end[-1])
+		{
+			return channel.mFirstKey + last;
+		}
+		u32 key;
+		if(channel.mInverseInterval > 0.f)
+		{
+			// The keys are only approximately evenly spaced so the estimate is corrected.
+			key = std::min(static_cast<u32>((time - channel.mStartTime) * channel.mInverseInterval), last - 1);
+			while(key + 1 < last && begin[key + 1] <= time)
+			{
+				++key;
+			}
+			while(key > 0 && begin[key] > time)
+			{
+				--key;
+			}
+		}else
+		{
+			key = static_cast<u32>(std::upper_bound(begin + 1, end, time) - begin) - 1;
+		}
+		f32 length = begin[key + 1] - begin[key];
+		fraction = (length > 0.f) ? (time - begin[key]) / length : 0.f;
+		return channel.mFirstKey + key;
+	}
+
+	inline Vector3 AnimationClip::GetVector(const Channel& channel, const std::vector<Vector3>& values, const std::vector<u16>& quantisedValues, u32 key) const
+	{
+		if(!mOptions.mQuantise)
+		{
+			return values[key];
+		}
+		const u16* value = &quantisedValues[key * 3];
+		return Vector3(channel.mMinimum.x + channel.mStep.x * value[0],
+						channel.mMinimum.y + channel.mStep.y * value[1],
+						channel.mMinimum.z + channel.mStep.z * value[2]);
+	}
+
+	inline Quaternion AnimationClip::GetOrientation(u32 key) const
+	{
+		if(!mOptions.mQuantise)
+		{
+			return mOrientations[key];
+		}
+		const s16* value = &mQuantisedOrientations[key * 4];
+		const f32 scale = 1.f / QUANTISED_ORIENTATION_SCALE;
+		Quaternion orientation(value[1] * scale, value[2] * scale, value[3] * scale, value[0] * scale);
+		orientation.Normalise();
+		return orientation;
+	}
+
+	Vector3 AnimationClip::SamplePosition(Size track, f32 time) const
+	{
+		const Channel& channel = mTracks[track].mPosition;
+		f32 fraction;
+		u32 key = FindKey(channel, mPositionTimes, time, fraction);
+		Vector3 position = GetVector(channel, mPositions, mQuantisedPositions, key);
+		if(fraction > 0.f)
+		{
+			position = Maths::LinearInterpolate(position, GetVector(channel, mPositions, mQuantisedPositions, key + 1), fraction);
+		}
+		return position;
+	}
+
+	Quaternion AnimationClip::SampleOrientation(Size track, f32 time) const
+	{
+		const Channel& channel = mTracks[track].mOrientation;
+		f32 fraction;
+		u32 key = FindKey(channel, mOrientationTimes, time, fraction);
+		Quaternion orientation = GetOrientation(key);
+		if(fraction > 0.f)
+		{
+			orientation = orientation.Nlerp(GetOrientation(key + 1), fraction, true);
+		}
+		return orientation;
+	}
+
+	Vector3 AnimationClip::SampleScale(Size track, f32 time) const
+	{
+		const Channel& channel = mTracks[track].mScale;
+		f32 fraction;
+		u32 key = FindKey(channel, mScaleTimes, time, fraction);
+		Vector3 scale = GetVector(channel, mScales, mQuantisedScales, key);
+		if(fraction > 0.f)
+		{
+			scale = Maths::LinearInterpolate(scale, GetVector(channel, mScales, mQuantisedScales, key + 1), fraction);
+		}
+		return scale;
+	}
+
+	Size AnimationClip::GetNumberOfKeys() const
+	{
+		return mPositionTimes.size() + mOrientationTimes.size() + mScaleTimes.size();
+	}
+
+	Size AnimationClip::GetMemoryUsage() const
+	{
+		return sizeof(AnimationClip) + mName.capacity() +
+			mTracks.capacity() * sizeof(Track) +
+			(mPositionTimes.capacity() + mOrientationTimes.capacity() + mScaleTimes.capacity()) * sizeof(f32) +
+			(mPositions.capacity() + mScales.capacity()) * sizeof(Vector3) +
+			mOrientations.capacity() * sizeof(Quaternion) +
+			(mQuantisedPositions.capacity() + mQuantisedScales.capacity()) * sizeof(u16) +
+			mQuantisedOrientations.capacity() * sizeof(s16);
+	}
+
+	AnimationClipSampler::AnimationClipSampler()
+	{
+	}
+
+	AnimationClipSampler::~AnimationClipSampler()
+	{
+	}
+
+	void AnimationClipSampler::Clear()
+	{
+		mLayers.clear();
+	}
+
+	void AnimationClipSampler::AddLayer(const AnimationClip& clip, Seconds time, f32 weight)
+	{
+		Layer layer = {&clip, static_cast<f32>(time.count()), weight};
+		mLayers.push_back(layer);
+	}
+
+	void AnimationClipSampler::Apply(Skeleton& skeleton)
+	{
+		Skeleton::BoneMap& bones = skeleton.GetBoneMap();
+		Size numberOfBones = bones.empty() ? 0 : (bones.rbegin()->first + 1);
+		mPositions.resize(numberOfBones);
+		mOrientations.resize(numberOfBones);
+		for(Skeleton::IndexBonePair& indexBone : bones)
+		{
+			mPositions[indexBone.first] = indexBone.second->GetInitialPosition();
+			mOrientations[indexBone.first] = indexBone.second->GetInitialOrientation();
+		}
+
+		for(const Layer& layer : mLayers)
+		{
+			// A layer with no weight would add nothing.
+			if(layer.mWeight==0.f)
+			{
+				continue;
+			}
+			const AnimationClip& clip = *layer.mClip;
+			const Size numberOfTracks = clip.GetNumberOfTracks();
+			for(Size t = 0; t < numberOfTracks; ++t)
+			{
+				Size boneIndex = clip.GetTrackBoneIndex(t);
+				if(boneIndex >= numberOfBones)
+				{
+					continue;
+				}
+				mPositions[boneIndex] += clip.SamplePosition(t, layer.mTime) * layer.mWeight;
+				Quaternion orientation = clip.SampleOrientation(t, layer.mTime);
+				if(layer.mWeight!=1.f)
+				{
+					orientation = Quaternion::IDENTITY.Nlerp(orientation, layer.mWeight, true);
+				}
+				mOrientations[boneIndex] = mOrientations[boneIndex] * orientation;
+			}
+		}
+
+		skeleton.SetPose(mPositions, mOrientations);
+	}
+}
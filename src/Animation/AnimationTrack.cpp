@@ -20,6 +20,7 @@ namespace Echo
 			mAnimationLength = keyframe->mTime;
 			mAnimation.AnimationLengthAdjusted(mAnimationLength);
 		}
+		mAnimation.KeyFramesChanged();
 
 		if(mKeyFrames.empty())
 		{
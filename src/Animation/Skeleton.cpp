@@ -2,12 +2,15 @@
 #include <echo/Animation/Skeleton.h>
 #include <echo/Animation/SkeletonAnimation.h>
 #include <echo/Animation/SkeletonAnimationState.h>
+#include <echo/Kernel/ScopedLock.h>
 #include <boost/foreach.hpp>
 #include <iostream>
 
 namespace Echo
 {
-	Skeleton::Skeleton() : Resource<Skeleton>(true), mRootBone(), mTransformsOutOfDate(false)
+	Skeleton::Skeleton() : Resource<Skeleton>(true), mRootBone(), mTransformsOutOfDate(false),
+		mPoseVersion(0),
+		mSkinningPaletteVersion(std::numeric_limits<Size>::max())
 	{
 	}
 
@@ -223,10 +226,35 @@ namespace Echo
 		{
 			return;
 		}
-		Reset();
+		bool useClips = true;
 		BOOST_FOREACH(shared_ptr<SkeletonAnimationState>& animationState, mAnimationStates)
 		{
-			animationState->Apply();
+			if(animationState->GetEnabled() && !static_pointer_cast<SkeletonAnimation>(animationState->GetAnimation())->GetClip())
+			{
+				useClips = false;
+				break;
+			}
+		}
+		if(useClips)
+		{
+			mAnimationSampler.Clear();
+			BOOST_FOREACH(shared_ptr<SkeletonAnimationState>& animationState, mAnimationStates)
+			{
+				if(animationState->GetEnabled())
+				{
+					shared_ptr<AnimationClip> clip = static_pointer_cast<SkeletonAnimation>(animationState->GetAnimation())->GetClip();
+					mAnimationSampler.AddLayer(*clip, animationState->GetTimePosition(), animationState->GetWeight());
+				}
+			}
+			// The sampler sets every bone so the pose doesn't need to be reset.
+			mAnimationSampler.Apply(*this);
+		}else
+		{
+			Reset();
+			BOOST_FOREACH(shared_ptr<SkeletonAnimationState>& animationState, mAnimationStates)
+			{
+				animationState->Apply();
+			}
 		}
 		BOOST_FOREACH(const IndexBonePair& bonePair, mBones)
 		{
@@ -251,6 +279,30 @@ namespace Echo
 		{
 			bonePair.second->SetBindingPose();
 		}
+		MarkPoseChanged();
+	}
+
+	const std::vector<Matrix4>& Skeleton::GetSkinningPalette()
+	{
+		ScopedLock lock(mSkinningPaletteMutex);
+		if(mSkinningPaletteVersion==mPoseVersion)
+		{
+			return mSkinningPalette;
+		}
+		Size numberOfEntries = mBones.empty() ? 0 : (mBones.rbegin()->first + 1);
+		mSkinningPalette.assign(numberOfEntries, Matrix4::IDENTITY);
+		BOOST_FOREACH(const IndexBonePair& bonePair, mBones)
+		{
+			mSkinningPalette[bonePair.first] = bonePair.second->GetOffsetTransform();
+		}
+		mSkinningPaletteVersion = mPoseVersion;
+		return mSkinningPalette;
+	}
+
+	void Bone::NeedUpdate(bool forceParent) const
+	{
+		mSkeleton.MarkPoseChanged();
+		Node::NeedUpdate(forceParent);
 	}
 
 	Size Skeleton::GetNumberOfAnimations()
@@ -263,6 +315,28 @@ namespace Echo
 		mTransformsOutOfDate = true;
 	}
 
+	void Skeleton::SetPose(const std::vector<Vector3>& positions, const std::vector<Quaternion>& orientations)
+	{
+		BOOST_FOREACH(const IndexBonePair& bonePair, mBones)
+		{
+			Bone& bone = *bonePair.second;
+			bone.mPosition = positions[bonePair.first];
+			bone.mOrientation = orientations[bonePair.first];
+			bone.mOrientation.Normalise();
+			bone.mScale = bone.mInitialScale;
+		}
+		// Node::NeedUpdate() marks all descendants so only bones without a parent bone need it. Nodes in a
+		// TransformHierarchy only mark themselves.
+		BOOST_FOREACH(const IndexBonePair& bonePair, mBones)
+		{
+			Bone& bone = *bonePair.second;
+			if(bone.GetTransformHierarchy() || !dynamic_cast<Bone*>(bone.GetParent()))
+			{
+				bone.NeedUpdate();
+			}
+		}
+	}
+
 	bool Skeleton::_Unload()
 	{
 		return false;
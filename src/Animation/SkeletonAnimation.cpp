@@ -48,6 +48,8 @@ namespace Echo
 				clonedAnimation->mTracks[cloneBone->GetIndex()] = shared_ptr<BoneAnimationTrack>(new BoneAnimationTrack(*boneTrack,cloneBone,*clonedAnimation));
 			}
 		}
+		// Cloned skeletons create their bones in the same order so the bone indices match and the clip can be shared.
+		clonedAnimation->mClip = mClip;
 		return clonedAnimation;
 	}
 
@@ -71,4 +73,16 @@ namespace Echo
 		bone->Translate(pos);
 		mSkeleton.MarkTransformsOutOfDate();
 	}
+
+	shared_ptr<AnimationClip> SkeletonAnimation::Bake(const AnimationClip::CompressionOptions& options)
+	{
+		mClip = make_shared<AnimationClip>(*this, options);
+		mSkeleton.MarkTransformsOutOfDate();
+		return mClip;
+	}
+
+	void SkeletonAnimation::KeyFramesChanged()
+	{
+		mClip.reset();
+	}
 }
@@ -0,0 +1,128 @@
+#include <echo/Animation/AnimationClip.h>
+#include <echo/Animation/Skeleton.h>
+#include <echo/Animation/SkeletonAnimation.h>
+#include <echo/Animation/SkeletonAnimationState.h>
+#include <echo/Animation/BoneAnimationTrack.h>
+#include <echo/Animation/BoneKeyFrame.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares updating the pose of a crowd of skeletons, each blending two animations, by interpolating key frames
+ * and by sampling baked AnimationClips. The memory used by the key frames and by clips with and without
+ * compression is also reported.
+ */
+namespace
+{
+	const Size NUMBER_OF_CHARACTERS = 500;
+	const Size NUMBER_OF_BONES = 60;
+	const Size NUMBER_OF_FRAMES = 20;
+	const f32 KEYS_PER_SECOND = 30.f;
+	const f32 ANIMATION_LENGTH = 4.f;
+
+	void CreateAnimation(Skeleton& skeleton, const std::string& name, f32 phase)
+	{
+		shared_ptr<SkeletonAnimation> animation = skeleton.CreateAnimation(name);
+		for(Size b = 0; b < NUMBER_OF_BONES; ++b)
+		{
+			shared_ptr<BoneAnimationTrack> track = animation->GetAnimationTrack(skeleton.GetBone(b));
+			for(f32 time = 0.f; time <= ANIMATION_LENGTH; time += 1.f / KEYS_PER_SECOND)
+			{
+				BoneKeyFrame& keyFrame = static_cast<BoneKeyFrame&>(*track->CreateKeyFrame(Seconds(time)));
+				f32 angle = 0.3f * std::sin(time * 3.f + phase + b);
+				keyFrame.mPosition = Vector3(0.f, 0.05f * std::cos(time * 2.f + b), 0.f);
+				keyFrame.mOrientation = Quaternion(Radian(angle), Vector3::UNIT_X);
+			}
+		}
+	}
+
+	shared_ptr<Skeleton> CreateSkeleton()
+	{
+		shared_ptr<Skeleton> skeleton(new Skeleton());
+		skeleton->CreateBone("0");
+		for(Size b = 1; b < NUMBER_OF_BONES; ++b)
+		{
+			skeleton->CreateBone(std::to_string(b), std::to_string((b - 1) / 3), Vector3(0.f, 0.2f, 0.f));
+		}
+		CreateAnimation(*skeleton, "Walk", 0.f);
+		CreateAnimation(*skeleton, "Wave", 1.f);
+		skeleton->SetInitialState();
+		return skeleton;
+	}
+
+	struct Character
+	{
+		shared_ptr<Skeleton> mSkeleton;
+		shared_ptr<SkeletonAnimationState> mWalk;
+		shared_ptr<SkeletonAnimationState> mWave;
+	};
+
+	f64 Measure(std::vector<Character>& characters)
+	{
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			for(Character& character : characters)
+			{
+				character.mWalk->AddTime(Seconds(1. / 60.));
+				character.mWave->AddTime(Seconds(1. / 60.));
+				character.mSkeleton->UpdateTransforms();
+			}
+		}
+		return timer.Stop().count() / NUMBER_OF_FRAMES / 1000000.0;
+	}
+}
+
+int main(int, char**)
+{
+	shared_ptr<Skeleton> source = CreateSkeleton();
+	std::vector<Character> characters(NUMBER_OF_CHARACTERS);
+	for(Character& character : characters)
+	{
+		character.mSkeleton = source->Clone();
+		character.mWalk = character.mSkeleton->CreateAnimationState("Walk", false);
+		character.mWave = character.mSkeleton->CreateAnimationState("Wave", false);
+		character.mWave->SetWeight(0.5f);
+	}
+	f64 keyFrameTime = Measure(characters);
+
+	for(Character& character : characters)
+	{
+		character.mSkeleton->GetAnimation("Walk")->Bake();
+		character.mSkeleton->GetAnimation("Wave")->Bake();
+	}
+	f64 clipTime = Measure(characters);
+
+	std::cout << "Characters: " << NUMBER_OF_CHARACTERS << ", bones: " << NUMBER_OF_BONES << ", animations: 2" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "Key frames ms/frame: " << keyFrameTime << std::endl;
+	std::cout << "Clips ms/frame:      " << clipTime << std::endl;
+
+	// Each key frame is a separate allocation referenced by a shared_ptr with its own control block.
+	shared_ptr<SkeletonAnimation> walk = source->GetAnimation("Walk");
+	Size numberOfKeyFrames = 0;
+	typedef std::pair< const size_t, shared_ptr<AnimationTrack> > IndexTrackPair;
+	for(const IndexTrackPair& indexTrack : walk->GetAnimationTracks())
+	{
+		numberOfKeyFrames += indexTrack.second->GetKeyFrames().size();
+	}
+	Size keyFrameBytes = numberOfKeyFrames * (sizeof(BoneKeyFrame) + sizeof(shared_ptr<KeyFrame>) + 4 * sizeof(void*));
+
+	AnimationClip clip(*walk);
+	AnimationClip::CompressionOptions options;
+	options.mPositionTolerance = 0.001f;
+	options.mOrientationTolerance = 0.001f;
+	options.mScaleTolerance = 0.001f;
+	options.mQuantise = true;
+	AnimationClip compressed(*walk, options);
+	std::cout << "Key frame bytes per animation:        " << keyFrameBytes << std::endl;
+	std::cout << "Clip bytes per animation:             " << clip.GetMemoryUsage() << std::endl;
+	std::cout << "Compressed clip bytes per animation:  " << compressed.GetMemoryUsage() << std::endl;
+	return 0;
+}
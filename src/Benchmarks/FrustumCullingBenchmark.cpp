@@ -0,0 +1,129 @@
+#include <echo/Graphics/Frustum.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares testing boxes one at a time with Frustum::IsVisible() against testing a packed array of boxes.
+ *
+ * The packed test uses SIMD when the build sets ECHO_SIMD_MATHS. Boxes are spread around the frustum so roughly
+ * a third are visible. The plane cache is filled by the first pass and reused by the others, as it would be
+ * from frame to frame. The boxes are measured in a random order and in grid order, where neighbouring boxes
+ * are usually culled by the same plane as they would be in a tile map or a spatially sorted scene.
+ */
+namespace
+{
+	// A grid of cells covering CELLS * CELL_SIZE units on each axis in front of the frustum with one box in each.
+	const Size CELLS = 100;
+	const f32 CELL_SIZE = 4.f;
+	const Size NUMBER_OF_PASSES = 10;
+
+	template< typename Function >
+	f64 Measure(Function function)
+	{
+		f64 best = 0.;
+		for(Size pass = 0; pass < NUMBER_OF_PASSES; ++pass)
+		{
+			Timer::CPUTimer timer;
+			timer.Start();
+			function();
+			f64 milliseconds = timer.Stop().count() / 1000000.;
+			if(pass==0 || milliseconds < best)
+			{
+				best = milliseconds;
+			}
+		}
+		return best;
+	}
+
+	void Print(const std::string& name, f64 milliseconds, Size visible)
+	{
+		std::cout << std::setw(36) << name
+				<< std::setw(12) << std::fixed << std::setprecision(3) << milliseconds
+				<< std::setw(12) << visible << std::endl;
+	}
+
+	void MeasureBoxes(const std::string& layout, const Frustum& frustum, const std::vector<AxisAlignedBox>& boxes)
+	{
+		PackedAxisAlignedBoxes packed;
+		packed.Reserve(boxes.size());
+		for(const AxisAlignedBox& box : boxes)
+		{
+			packed.Add(box);
+		}
+
+		Size visible = 0;
+		f64 milliseconds = Measure([&]()
+		{
+			visible = 0;
+			for(const AxisAlignedBox& box : boxes)
+			{
+				if(frustum.IsVisible(box))
+				{
+					++visible;
+				}
+			}
+		});
+		Print(layout + " IsVisible() per box", milliseconds, visible);
+
+		std::vector<u32> visibility;
+		milliseconds = Measure([&]()
+		{
+			visible = frustum.IsVisible(packed, visibility);
+		});
+		Print(layout + " packed", milliseconds, visible);
+
+		std::vector<u8> culledBy;
+		milliseconds = Measure([&]()
+		{
+			visible = frustum.IsVisible(packed, visibility, &culledBy);
+		});
+		Print(layout + " packed with plane cache", milliseconds, visible);
+	}
+}
+
+int main(int, char**)
+{
+	std::mt19937 generator(5);
+	std::uniform_real_distribution<f32> size(0.5f, 4.f);
+
+	Frustum frustum;
+	frustum.SetNearPlane(1.f);
+	frustum.SetFarPlane(400.f);
+
+	std::vector<AxisAlignedBox> boxes;
+	boxes.reserve(CELLS * CELLS * CELLS);
+	for(Size z = 0; z < CELLS; ++z)
+	{
+		for(Size y = 0; y < CELLS; ++y)
+		{
+			for(Size x = 0; x < CELLS; ++x)
+			{
+				Vector3 minimum((f32(x) - CELLS / 2) * CELL_SIZE, (f32(y) - CELLS / 2) * CELL_SIZE, f32(z) * -CELL_SIZE);
+				boxes.push_back(AxisAlignedBox(minimum, minimum + Vector3(size(generator), size(generator), size(generator))));
+			}
+		}
+	}
+
+#if defined(ECHO_MATHS_SIMD_SSE)
+	std::cout << "Maths implementation: SSE" << std::endl;
+#elif defined(ECHO_MATHS_SIMD_NEON)
+	std::cout << "Maths implementation: NEON" << std::endl;
+#else
+	std::cout << "Maths implementation: scalar" << std::endl;
+#endif
+	std::cout << boxes.size() << " boxes, best of " << NUMBER_OF_PASSES << " passes" << std::endl;
+	std::cout << std::setw(36) << "Method"
+			<< std::setw(12) << "ms"
+			<< std::setw(12) << "Visible" << std::endl;
+
+	MeasureBoxes("Grid", frustum, boxes);
+	std::shuffle(boxes.begin(), boxes.end(), generator);
+	MeasureBoxes("Random", frustum, boxes);
+	return 0;
+}
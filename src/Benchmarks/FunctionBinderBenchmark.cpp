@@ -0,0 +1,153 @@
+#include <echo/Util/FunctionBinder.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+using namespace Echo;
+
+/**
+ * Compares the ways of calling a function through a FunctionBinder.
+ *
+ * Single calls are made with a call string, a compiled call, a TypedFunction from Resolve() and directly. A
+ * configuration style script of SCRIPT_LINES calls is run line by line with call strings, compiled and run as a
+ * batch, then run again from the compiled form.
+ */
+namespace
+{
+	const Size NUMBER_OF_CALLS = 100000;
+	const Size SCRIPT_LINES = 10000;
+	const Size NUMBER_OF_PASSES = 5;
+
+	Size gCounter = 0;
+
+	void SetValue(int value, std::string name)
+	{
+		gCounter += value + name.size();
+	}
+
+	std::string GetName()
+	{
+		return "name";
+	}
+
+	template< typename Function >
+	f64 Measure(Function function)
+	{
+		f64 best = 0.;
+		for(Size pass = 0; pass < NUMBER_OF_PASSES; ++pass)
+		{
+			Timer::CPUTimer timer;
+			timer.Start();
+			function();
+			f64 milliseconds = timer.Stop().count() / 1000000.;
+			if(pass==0 || milliseconds < best)
+			{
+				best = milliseconds;
+			}
+		}
+		return best;
+	}
+
+	void Print(const std::string& name, f64 milliseconds, Size calls)
+	{
+		std::cout << std::setw(40) << name
+				<< std::setw(12) << std::fixed << std::setprecision(3) << milliseconds
+				<< std::setw(12) << std::setprecision(1) << (milliseconds * 1000000. / calls) << std::endl;
+	}
+}
+
+int main(int, char**)
+{
+	FunctionBinder binder;
+	binder.Register("SetValue",bind(&SetValue,placeholders::_1,placeholders::_2),false,boost::fusion::vector<int,std::string>());
+	binder.RegisterVoid("GetName",bind(&GetName));
+
+	std::cout << std::setw(40) << "Method"
+			<< std::setw(12) << "ms"
+			<< std::setw(12) << "ns/call" << std::endl;
+
+	f64 milliseconds = Measure([&]()
+	{
+		for(Size c = 0; c < NUMBER_OF_CALLS; ++c)
+		{
+			binder.Call("SetValue(3,Hello)");
+		}
+	});
+	Print("Call(\"SetValue(3,Hello)\")", milliseconds, NUMBER_OF_CALLS);
+
+	FunctionBinder::CompiledCall compiledCall = binder.Compile("SetValue(3,Hello)");
+	milliseconds = Measure([&]()
+	{
+		for(Size c = 0; c < NUMBER_OF_CALLS; ++c)
+		{
+			binder.Call(compiledCall);
+		}
+	});
+	Print("Compiled SetValue(3,Hello)", milliseconds, NUMBER_OF_CALLS);
+
+	FunctionBinder::CompiledCall nestedCall = binder.Compile("SetValue(3,GetName())");
+	milliseconds = Measure([&]()
+	{
+		for(Size c = 0; c < NUMBER_OF_CALLS; ++c)
+		{
+			binder.Call(nestedCall);
+		}
+	});
+	Print("Compiled SetValue(3,GetName())", milliseconds, NUMBER_OF_CALLS);
+
+	FunctionBinder::TypedFunction<void(int,std::string)> setValue = binder.Resolve<void(int,std::string)>("SetValue");
+	const std::string hello("Hello");
+	milliseconds = Measure([&]()
+	{
+		for(Size c = 0; c < NUMBER_OF_CALLS; ++c)
+		{
+			setValue(3,hello);
+		}
+	});
+	Print("Resolve() SetValue(3,Hello)", milliseconds, NUMBER_OF_CALLS);
+
+	milliseconds = Measure([&]()
+	{
+		for(Size c = 0; c < NUMBER_OF_CALLS; ++c)
+		{
+			SetValue(3,hello);
+		}
+	});
+	Print("Direct SetValue(3,Hello)", milliseconds, NUMBER_OF_CALLS);
+
+	std::stringstream script;
+	for(Size l = 0; l < SCRIPT_LINES; ++l)
+	{
+		script << "SetValue(" << l << ",Value" << l << ")\n";
+	}
+	std::vector<std::string> lines;
+	boost::algorithm::split(lines, script.str(), boost::is_any_of("\n"));
+
+	milliseconds = Measure([&]()
+	{
+		for(const std::string& line : lines)
+		{
+			if(!line.empty())
+			{
+				binder.Call(line);
+			}
+		}
+	});
+	Print("Script line by line", milliseconds, SCRIPT_LINES);
+
+	milliseconds = Measure([&]()
+	{
+		FunctionBinder::CompiledScript compiledScript = binder.CompileScript(script.str());
+		binder.Call(compiledScript);
+	});
+	Print("Script compiled and run", milliseconds, SCRIPT_LINES);
+
+	FunctionBinder::CompiledScript compiledScript = binder.CompileScript(script.str());
+	milliseconds = Measure([&]()
+	{
+		binder.Call(compiledScript);
+	});
+	Print("Script run again", milliseconds, SCRIPT_LINES);
+	return gCounter==0 ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+#include <echo/Logging/Logging.h>
+#include <echo/Kernel/Thread.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <iomanip>
+#include <streambuf>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Measures the cost of ECHO_LOG_* calls when multiple threads are logging at once. The result is the time for all of the
+ * threads to finish divided by the total number of calls.
+ * Output is formatted then discarded so the result isn't dominated by the speed of a terminal or disk. In asynchronous
+ * mode the time spent formatting and writing on the background thread is not included, that is the point of the mode.
+ */
+namespace
+{
+	const Size MESSAGES_PER_THREAD = 20000;
+
+	class DiscardBuffer : public std::streambuf
+	{
+	protected:
+		int overflow(int c) override
+		{
+			return c;
+		}
+		std::streamsize xsputn(const char*, std::streamsize count) override
+		{
+			return count;
+		}
+	};
+
+	f64 Measure(Size numberOfThreads)
+	{
+		std::vector< shared_ptr<Thread> > threads;
+		for(Size t=0; t < numberOfThreads; ++t)
+		{
+			threads.push_back(make_shared<Thread>("Logger" + std::to_string(t), [t]()
+			{
+				for(Size m=0; m < MESSAGES_PER_THREAD; ++m)
+				{
+					ECHO_LOG_INFO("Thread " << t << " message " << m);
+				}
+			}));
+		}
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(shared_ptr<Thread>& thread : threads)
+		{
+			thread->Execute();
+		}
+		for(shared_ptr<Thread>& thread : threads)
+		{
+			thread->Join();
+		}
+		f64 elapsed = timer.Stop().count();
+		gDefaultLogger.Flush();
+		return elapsed / (numberOfThreads * MESSAGES_PER_THREAD);
+	}
+}
+
+int main(int, char**)
+{
+	DiscardBuffer discardBuffer;
+	std::ostream discard(&discardBuffer);
+	gDefaultLogger.RemoveLogOutputStream("stdout");
+	gDefaultLogger.SetLogOutputStream("discard", &discard);
+	gDefaultLogger.SetLogMask(Logger::LogLevels::ERROR | Logger::LogLevels::WARNING | Logger::LogLevels::INFO);
+
+	std::cout << "Logger ns per ECHO_LOG_INFO call (" << MESSAGES_PER_THREAD << " messages per thread)" << std::endl;
+	std::cout << std::setw(8) << "Threads" << std::setw(14) << "Synchronous" << std::setw(14) << "Async(Drop)"
+				<< std::setw(14) << "Async(Block)" << std::setw(10) << "Dropped" << std::endl;
+	const Size threadCounts[] = {1, 2, 4, 8, 16};
+	for(Size numberOfThreads : threadCounts)
+	{
+		gDefaultLogger.SetAsynchronous(false);
+		f64 synchronous = Measure(numberOfThreads);
+
+		gDefaultLogger.SetAsynchronous(true, 4096, Logger::OverflowPolicies::DROP);
+		Size droppedBefore = gDefaultLogger.GetNumberOfDroppedMessages();
+		f64 asynchronousDrop = Measure(numberOfThreads);
+		Size dropped = gDefaultLogger.GetNumberOfDroppedMessages() - droppedBefore;
+
+		gDefaultLogger.SetAsynchronous(true, 4096, Logger::OverflowPolicies::BLOCK);
+		f64 asynchronousBlock = Measure(numberOfThreads);
+
+		std::cout << std::setw(8) << numberOfThreads << std::fixed << std::setprecision(1)
+					<< std::setw(14) << synchronous
+					<< std::setw(14) << asynchronousDrop
+					<< std::setw(14) << asynchronousBlock
+					<< std::setw(10) << dropped << std::endl;
+	}
+	gDefaultLogger.SetAsynchronous(false);
+	gDefaultLogger.RemoveLogOutputStream("discard");
+	return 0;
+}
@@ -0,0 +1,260 @@
+#include <echo/Maths/Matrix4.h>
+#include <echo/Maths/Quaternion.h>
+#include <echo/Maths/AxisAlignedBox.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares the maths types against scalar versions of the same operations.
+ *
+ * The maths types use SIMD when the build sets ECHO_SIMD_MATHS, otherwise both columns measure scalar code and
+ * the speed up should be close to 1. The data fits in the cache and is processed NUMBER_OF_REPEATS times so the
+ * results measure the arithmetic rather than memory bandwidth.
+ */
+namespace
+{
+	const Size NUMBER_OF_ITEMS = 4096;
+	const Size NUMBER_OF_REPEATS = 250;
+	const Size NUMBER_OF_PASSES = 5;
+
+	Matrix4 ScalarConcatenate(const Matrix4& a, const Matrix4& b)
+	{
+		Matrix4 r;
+		for(Size i = 0; i < 4; ++i)
+		{
+			r[i][0] = a[i][0] * b[0][0] + a[i][1] * b[1][0] + a[i][2] * b[2][0] + a[i][3] * b[3][0];
+			r[i][1] = a[i][0] * b[0][1] + a[i][1] * b[1][1] + a[i][2] * b[2][1] + a[i][3] * b[3][1];
+			r[i][2] = a[i][0] * b[0][2] + a[i][1] * b[1][2] + a[i][2] * b[2][2] + a[i][3] * b[3][2];
+			r[i][3] = a[i][0] * b[0][3] + a[i][1] * b[1][3] + a[i][2] * b[2][3] + a[i][3] * b[3][3];
+		}
+		return r;
+	}
+
+	Matrix4 ScalarInverseAffine(const Matrix4& m)
+	{
+		f32 m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+		f32 m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+		f32 t00 = m22 * m11 - m21 * m12;
+		f32 t10 = m20 * m12 - m22 * m10;
+		f32 t20 = m21 * m10 - m20 * m11;
+		f32 m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+		f32 invDet = 1 / (m00 * t00 + m01 * t10 + m02 * t20);
+		t00 *= invDet; t10 *= invDet; t20 *= invDet;
+		m00 *= invDet; m01 *= invDet; m02 *= invDet;
+		f32 r01 = m02 * m21 - m01 * m22, r02 = m01 * m12 - m02 * m11;
+		f32 r11 = m00 * m22 - m02 * m20, r12 = m02 * m10 - m00 * m12;
+		f32 r21 = m01 * m20 - m00 * m21, r22 = m00 * m11 - m01 * m10;
+		f32 m03 = m[0][3], m13 = m[1][3], m23 = m[2][3];
+		return Matrix4(
+			t00, r01, r02, -(t00 * m03 + r01 * m13 + r02 * m23),
+			t10, r11, r12, -(t10 * m03 + r11 * m13 + r12 * m23),
+			t20, r21, r22, -(t20 * m03 + r21 * m13 + r22 * m23),
+			0, 0, 0, 1);
+	}
+
+	Quaternion ScalarMultiply(const Quaternion& p, const Quaternion& q)
+	{
+		return Quaternion(
+			p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y,
+			p.w * q.y + p.y * q.w + p.z * q.x - p.x * q.z,
+			p.w * q.z + p.z * q.w + p.x * q.y - p.y * q.x,
+			p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z);
+	}
+
+	Quaternion ScalarSlerp(f32 t, const Quaternion& p, const Quaternion& q)
+	{
+		f32 cosine = p.Dot(q);
+		Quaternion target = q;
+		if(cosine < 0.f)
+		{
+			cosine = -cosine;
+			target = -q;
+		}
+		if(Maths::Abs(cosine) < 1 - Quaternion::ms_fEpsilon)
+		{
+			f32 sine = Maths::Sqrt(1 - Maths::Sqr(cosine));
+			Radian angle = Maths::ATan2(sine, cosine);
+			f32 invSine = 1.0f / sine;
+			return (Maths::Sin<f32>((1.0f - t) * angle) * invSine) * p + (Maths::Sin<f32>(t * angle) * invSine) * target;
+		}
+		Quaternion r = (1.0f - t) * p + t * target;
+		r.Normalise();
+		return r;
+	}
+
+	void ScalarTransformBox(const Matrix4& m, const AxisAlignedBox& input, AxisAlignedBox& output)
+	{
+		Vector3 centre = input.GetCentre();
+		Vector3 halfSize = input.GetHalfSize();
+		Vector3 newCentre = m.TransformAffine(centre);
+		Vector3 newHalfSize(
+			Maths::Abs(m[0][0]) * halfSize.x + Maths::Abs(m[0][1]) * halfSize.y + Maths::Abs(m[0][2]) * halfSize.z,
+			Maths::Abs(m[1][0]) * halfSize.x + Maths::Abs(m[1][1]) * halfSize.y + Maths::Abs(m[1][2]) * halfSize.z,
+			Maths::Abs(m[2][0]) * halfSize.x + Maths::Abs(m[2][1]) * halfSize.y + Maths::Abs(m[2][2]) * halfSize.z);
+		output.SetExtents(newCentre - newHalfSize, newCentre + newHalfSize);
+	}
+
+	template< typename Function >
+	f64 Measure(Function function)
+	{
+		f64 best = 0.;
+		for(Size pass = 0; pass < NUMBER_OF_PASSES; ++pass)
+		{
+			Timer::CPUTimer timer;
+			timer.Start();
+			for(Size repeat = 0; repeat < NUMBER_OF_REPEATS; ++repeat)
+			{
+				function();
+			}
+			f64 milliseconds = timer.Stop().count() / 1000000.;
+			if(pass==0 || milliseconds < best)
+			{
+				best = milliseconds;
+			}
+		}
+		return best;
+	}
+
+	void Print(const std::string& name, f64 scalar, f64 maths, f32 checksum)
+	{
+		// Printing the checksum keeps the results from being optimised away.
+		std::cout << std::setw(24) << name
+				<< std::setw(12) << std::fixed << std::setprecision(2) << scalar
+				<< std::setw(12) << maths
+				<< std::setw(11) << std::setprecision(1) << (maths > 0. ? scalar / maths : 0.) << "x"
+				<< std::setw(14) << std::setprecision(3) << checksum << std::endl;
+	}
+}
+
+int main(int, char**)
+{
+	std::mt19937 generator(99);
+	std::uniform_real_distribution<f32> value(-1.f, 1.f);
+	std::vector<Matrix4> matrices(NUMBER_OF_ITEMS);
+	std::vector<Quaternion> quaternions(NUMBER_OF_ITEMS);
+	std::vector<Vector3> vectors(NUMBER_OF_ITEMS);
+	std::vector<AxisAlignedBox> boxes;
+	boxes.reserve(NUMBER_OF_ITEMS);
+	for(Size i = 0; i < NUMBER_OF_ITEMS; ++i)
+	{
+		quaternions[i] = Quaternion(Radian(value(generator) * 3.f), Vector3(value(generator), value(generator), 1.f).NormalisedCopy());
+		vectors[i] = Vector3(value(generator), value(generator), value(generator));
+		matrices[i].MakeTransform(vectors[i], Vector3(1.f + value(generator) * 0.5f, 1.f, 1.f), quaternions[i]);
+		boxes.push_back(AxisAlignedBox(vectors[i], vectors[i] + Vector3::UNIT_SCALE));
+	}
+	std::vector<Matrix4> matrixResults(NUMBER_OF_ITEMS);
+	std::vector<Quaternion> quaternionResults(NUMBER_OF_ITEMS);
+	std::vector<Vector3> vectorResults(NUMBER_OF_ITEMS);
+	std::vector<AxisAlignedBox> boxResults(NUMBER_OF_ITEMS);
+	const Matrix4& transform = matrices[0];
+
+#if defined(ECHO_MATHS_SIMD_SSE)
+	std::cout << "Maths implementation: SSE" << std::endl;
+#elif defined(ECHO_MATHS_SIMD_NEON)
+	std::cout << "Maths implementation: NEON" << std::endl;
+#else
+	std::cout << "Maths implementation: scalar" << std::endl;
+#endif
+	std::cout << NUMBER_OF_ITEMS << " items processed " << NUMBER_OF_REPEATS << " times" << std::endl;
+	std::cout << std::setw(24) << "Operation"
+			<< std::setw(12) << "Scalar ms"
+			<< std::setw(12) << "Maths ms"
+			<< std::setw(12) << "Speed up"
+			<< std::setw(14) << "Checksum" << std::endl;
+
+	f64 scalar = Measure([&]()
+	{
+		for(Size i = 0; i + 1 < NUMBER_OF_ITEMS; ++i)
+		{
+			matrixResults[i] = ScalarConcatenate(matrices[i], matrices[i + 1]);
+		}
+	});
+	f64 maths = Measure([&]()
+	{
+		for(Size i = 0; i + 1 < NUMBER_OF_ITEMS; ++i)
+		{
+			matrixResults[i] = matrices[i] * matrices[i + 1];
+		}
+	});
+	Print("Matrix4 concatenate", scalar, maths, matrixResults[NUMBER_OF_ITEMS / 2][0][3]);
+
+	scalar = Measure([&]()
+	{
+		for(Size i = 0; i < NUMBER_OF_ITEMS; ++i)
+		{
+			matrixResults[i] = ScalarInverseAffine(matrices[i]);
+		}
+	});
+	maths = Measure([&]()
+	{
+		for(Size i = 0; i < NUMBER_OF_ITEMS; ++i)
+		{
+			matrixResults[i] = matrices[i].InverseAffine();
+		}
+	});
+	Print("Matrix4 inverse affine", scalar, maths, matrixResults[NUMBER_OF_ITEMS / 2][0][3]);
+
+	scalar = Measure([&]()
+	{
+		for(Size i = 0; i + 1 < NUMBER_OF_ITEMS; ++i)
+		{
+			quaternionResults[i] = ScalarMultiply(quaternions[i], quaternions[i + 1]);
+		}
+	});
+	maths = Measure([&]()
+	{
+		for(Size i = 0; i + 1 < NUMBER_OF_ITEMS; ++i)
+		{
+			quaternionResults[i] = quaternions[i] * quaternions[i + 1];
+		}
+	});
+	Print("Quaternion multiply", scalar, maths, quaternionResults[NUMBER_OF_ITEMS / 2].x);
+
+	scalar = Measure([&]()
+	{
+		for(Size i = 0; i + 1 < NUMBER_OF_ITEMS; ++i)
+		{
+			quaternionResults[i] = ScalarSlerp(0.3f, quaternions[i], quaternions[i + 1]);
+		}
+	});
+	maths = Measure([&]()
+	{
+		for(Size i = 0; i + 1 < NUMBER_OF_ITEMS; ++i)
+		{
+			quaternionResults[i] = Quaternion::Slerp(0.3f, quaternions[i], quaternions[i + 1], true);
+		}
+	});
+	Print("Quaternion slerp", scalar, maths, quaternionResults[NUMBER_OF_ITEMS / 2].x);
+
+	scalar = Measure([&]()
+	{
+		for(Size i = 0; i < NUMBER_OF_ITEMS; ++i)
+		{
+			vectorResults[i] = transform.TransformAffine(vectors[i]);
+		}
+	});
+	maths = Measure([&]()
+	{
+		transform.TransformAffine(vectors.data(), vectorResults.data(), NUMBER_OF_ITEMS);
+	});
+	Print("Vector3 array transform", scalar, maths, vectorResults[NUMBER_OF_ITEMS / 2].y);
+
+	scalar = Measure([&]()
+	{
+		for(Size i = 0; i < NUMBER_OF_ITEMS; ++i)
+		{
+			ScalarTransformBox(transform, boxes[i], boxResults[i]);
+		}
+	});
+	maths = Measure([&]()
+	{
+		AxisAlignedBox::TransformAffine(transform, boxes.data(), boxResults.data(), NUMBER_OF_ITEMS);
+	});
+	Print("Box array transform", scalar, maths, boxResults[NUMBER_OF_ITEMS / 2].GetMaximum().z);
+	return 0;
+}
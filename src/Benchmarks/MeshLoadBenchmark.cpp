@@ -0,0 +1,230 @@
+#include <echo/Platform.h>
+#include <echo/Platforms/Ogre/OgreMeshFileFormat.h>
+#include <echo/FileSystem/FileSystem.h>
+#include <echo/FileSystem/FileSystemSourceMemory.h>
+#include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Resource/BinaryMeshFile.h>
+#include <echo/Resource/MaterialManager.h>
+#include <echo/Resource/MeshReader.h>
+#include <echo/Resource/ShaderManager.h>
+#include <echo/Resource/SkeletonManager.h>
+#include <echo/Resource/TextureManager.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares loading a large static mesh from a .mesh file against the same mesh in an .emesh file.
+ *
+ * The mesh is a grid of vertices with a position, normal and texture coordinate, indexed with 32 bit indices.
+ * Both files are loaded from memory so the result measures parsing rather than disk access. The .emesh file is
+ * also loaded from disk, where it is read with a single Read().
+ */
+namespace
+{
+	const u32 GRID_SIZE = 1000;
+	const Size NUMBER_OF_PASSES = 3;
+	const std::string MATERIAL_NAME = "BenchmarkMaterial";
+	const std::string BINARY_MESH_FILE = "MeshLoadBenchmark.emesh";
+
+	/**
+	 * Writes the parts of the Ogre format that MeshReader supports.
+	 */
+	class OgreMeshWriter
+	{
+	public:
+		template< typename T >
+		void Write(const T& value)
+		{
+			Write(&value, sizeof(T));
+		}
+		void Write(const void* data, Size size)
+		{
+			const u8* bytes = reinterpret_cast<const u8*>(data);
+			mData.insert(mData.end(), bytes, bytes + size);
+		}
+		void WriteString(const std::string& s)
+		{
+			Write(s.data(), s.size());
+			mData.push_back('\n');
+		}
+		Size BeginChunk(u16 id)
+		{
+			Size start = mData.size();
+			Write(id);
+			Write(u32(0));
+			return start;
+		}
+		void EndChunk(Size start)
+		{
+			u32 length = static_cast<u32>(mData.size() - start);
+			std::memcpy(&mData[start + sizeof(u16)], &length, sizeof(u32));
+		}
+		void WriteVertexElement(u16 type, u16 semantic, u16 offset)
+		{
+			Size element = BeginChunk(Ogre::M_GEOMETRY_VERTEX_ELEMENT);
+			Write(u16(0));
+			Write(type);
+			Write(semantic);
+			Write(offset);
+			Write(u16(0));
+			EndChunk(element);
+		}
+		std::vector<u8> mData;
+	};
+
+	struct GridVertex
+	{
+		f32 mPosition[3];
+		f32 mNormal[3];
+		f32 mUV[2];
+	};
+
+	std::vector<u8> CreateOgreMesh()
+	{
+		std::vector<GridVertex> vertices;
+		vertices.reserve(GRID_SIZE * GRID_SIZE);
+		for(u32 y = 0; y < GRID_SIZE; ++y)
+		{
+			for(u32 x = 0; x < GRID_SIZE; ++x)
+			{
+				GridVertex vertex = {{f32(x), 0.f, f32(y)}, {0.f, 1.f, 0.f}, {f32(x) / GRID_SIZE, f32(y) / GRID_SIZE}};
+				vertices.push_back(vertex);
+			}
+		}
+		std::vector<u32> indices;
+		indices.reserve((GRID_SIZE - 1) * (GRID_SIZE - 1) * 6);
+		for(u32 y = 0; y + 1 < GRID_SIZE; ++y)
+		{
+			for(u32 x = 0; x + 1 < GRID_SIZE; ++x)
+			{
+				u32 i = y * GRID_SIZE + x;
+				u32 quad[6] = {i, i + GRID_SIZE, i + 1, i + 1, i + GRID_SIZE, i + GRID_SIZE + 1};
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+
+		// Element types and semantics from Ogre, VET_FLOAT3 = 2, VET_FLOAT2 = 1, VES_POSITION = 1, VES_NORMAL = 4
+		// and VES_TEXTURE_COORDINATES = 7.
+		OgreMeshWriter writer;
+		writer.Write(u16(Ogre::M_HEADER));
+		writer.WriteString("[MeshSerializer_v1.40]");
+		Size mesh = writer.BeginChunk(Ogre::M_MESH);
+		writer.Write(u8(0));
+		Size geometry = writer.BeginChunk(Ogre::M_GEOMETRY);
+		writer.Write(u32(vertices.size()));
+		Size declaration = writer.BeginChunk(Ogre::M_GEOMETRY_VERTEX_DECLARATION);
+		writer.WriteVertexElement(2, 1, 0);
+		writer.WriteVertexElement(2, 4, 12);
+		writer.WriteVertexElement(1, 7, 24);
+		writer.EndChunk(declaration);
+		Size vertexBuffer = writer.BeginChunk(Ogre::M_GEOMETRY_VERTEX_BUFFER);
+		writer.Write(u16(0));
+		writer.Write(u16(sizeof(GridVertex)));
+		Size vertexData = writer.BeginChunk(Ogre::M_GEOMETRY_VERTEX_BUFFER_DATA);
+		writer.Write(vertices.data(), vertices.size() * sizeof(GridVertex));
+		writer.EndChunk(vertexData);
+		writer.EndChunk(vertexBuffer);
+		writer.EndChunk(geometry);
+		Size subMesh = writer.BeginChunk(Ogre::M_SUBMESH);
+		writer.WriteString(MATERIAL_NAME);
+		writer.Write(u8(1));
+		writer.Write(u32(indices.size()));
+		writer.Write(u8(1));
+		writer.Write(indices.data(), indices.size() * sizeof(u32));
+		Size operation = writer.BeginChunk(Ogre::M_SUBMESH_OPERATION);
+		writer.Write(u16(4));
+		writer.EndChunk(operation);
+		writer.EndChunk(subMesh);
+		writer.EndChunk(mesh);
+		return writer.mData;
+	}
+
+	template< typename LoadFunction >
+	f64 Measure(LoadFunction loadFunction)
+	{
+		f64 best = 0.;
+		for(Size pass = 0; pass < NUMBER_OF_PASSES; ++pass)
+		{
+			Mesh mesh;
+			Timer::CPUTimer timer;
+			timer.Start();
+			if(!loadFunction(mesh) || mesh.GetNumberOfSubMeshes()!=1)
+			{
+				std::cout << "Load failed" << std::endl;
+				return 0.;
+			}
+			f64 milliseconds = timer.Stop().count() / 1000000.;
+			if(pass==0 || milliseconds < best)
+			{
+				best = milliseconds;
+			}
+		}
+		return best;
+	}
+
+	void Print(const std::string& name, f64 milliseconds, f64 baseline)
+	{
+		std::cout << std::setw(20) << name
+				<< std::setw(16) << std::fixed << std::setprecision(2) << milliseconds
+				<< std::setw(12) << std::setprecision(1) << (milliseconds > 0. ? baseline / milliseconds : 0.) << "x" << std::endl;
+	}
+}
+
+int main(int, char**)
+{
+	shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("MeshLoadBenchmark");
+	TextureManager textureManager(*fileSystem);
+	ShaderManager geometryShaderManager("geometry", *fileSystem);
+	ShaderManager vertexShaderManager("vertex", *fileSystem);
+	ShaderManager fragmentShaderManager("fragment", *fileSystem);
+	MaterialManager materialManager(*fileSystem, textureManager, geometryShaderManager, vertexShaderManager, fragmentShaderManager);
+	SkeletonManager skeletonManager(*fileSystem);
+	materialManager.CreateMaterial(MATERIAL_NAME);
+
+	std::vector<u8> ogreMesh = CreateOgreMesh();
+	{
+		Mesh mesh;
+		File file = FileSystemSourceMemory::OpenDirect(ogreMesh.data(), ogreMesh.size());
+		File output = fileSystem->Open(BINARY_MESH_FILE, File::OpenModes::WRITE);
+		if(!ReadMeshFile(file, materialManager, skeletonManager, mesh) || !WriteBinaryMeshFile(output, mesh))
+		{
+			std::cout << "Failed to create " << BINARY_MESH_FILE << std::endl;
+			return 1;
+		}
+	}
+	File binaryFile = fileSystem->Open(BINARY_MESH_FILE);
+	std::vector<u8> binaryMesh(binaryFile.GetSize());
+	binaryFile.Read(binaryMesh.data(), binaryMesh.size());
+	binaryFile.Close();
+
+	// Only errors are of interest while measuring.
+	gDefaultLogger.SetLogMask("ERROR");
+	std::cout << GRID_SIZE * GRID_SIZE << " vertices, " << (GRID_SIZE - 1) * (GRID_SIZE - 1) * 2 << " triangles" << std::endl;
+	std::cout << std::setw(20) << "Format"
+			<< std::setw(16) << "Load ms"
+			<< std::setw(13) << "Speed up" << std::endl;
+
+	f64 ogre = Measure([&](Mesh& mesh)
+	{
+		File file = FileSystemSourceMemory::OpenDirect(ogreMesh.data(), ogreMesh.size());
+		return ReadMeshFile(file, materialManager, skeletonManager, mesh);
+	});
+	Print(".mesh (memory)", ogre, ogre);
+	Print(".emesh (memory)", Measure([&](Mesh& mesh)
+	{
+		File file = FileSystemSourceMemory::OpenDirect(binaryMesh.data(), binaryMesh.size());
+		return ReadBinaryMeshFile(file, materialManager, mesh);
+	}), ogre);
+	Print(".emesh (file)", Measure([&](Mesh& mesh)
+	{
+		File file = fileSystem->Open(BINARY_MESH_FILE);
+		return ReadBinaryMeshFile(file, materialManager, mesh);
+	}), ogre);
+	return 0;
+}
@@ -0,0 +1,181 @@
+#include <echo/Network/NetworkManager.h>
+#include <echo/Network/SocketNetworkSystem.h>
+#include <echo/Network/IncomingConnectionListener.h>
+#include <echo/Network/NetworkEventListener.h>
+#include <echo/Network/Connection.h>
+#include <echo/Kernel/TaskThread.h>
+#include <echo/Kernel/Thread.h>
+#include <echo/Kernel/Mutex.h>
+#include <echo/Kernel/ScopedLock.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#ifdef ECHO_PLATFORM_LINUX
+#include <sys/resource.h>
+#endif
+
+using namespace Echo;
+
+/**
+ * Load test for SocketNetworkSystem over loopback.
+ * A server and a client NetworkManager, each running in their own thread, are created for each backend. The client
+ * opens a number of connections to the server then every connection sends a burst of packets. The time taken to
+ * establish the connections and the rate the server receives packets are reported as the number of connections
+ * increases.
+ */
+namespace
+{
+	const Size MESSAGES_PER_CONNECTION = 50;
+	const Seconds PHASE_TIMEOUT(60);
+	const Size BUFFER_SIZE = 16 * 1024;
+
+	class LoadServer : public IncomingConnectionListener, public NetworkEventListener
+	{
+	public:
+		LoadServer() : mNumberOfConnections(0), mNumberOfPackets(0) {}
+
+		void IncomingConnection(shared_ptr<Connection> connection) override
+		{
+			ScopedLock locky(mConnectionsMutex);
+			mConnections.push_back(connection);
+			mNumberOfConnections++;
+		}
+
+		void OnNetworkEvent(NetworkEventType eventType) override
+		{
+			if(eventType==NetworkEventTypes::PACKET_RECEIVED)
+			{
+				mNumberOfPackets.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		std::atomic<Size> mNumberOfConnections;
+		std::atomic<Size> mNumberOfPackets;
+	private:
+		Mutex mConnectionsMutex;
+		std::vector< shared_ptr<Connection> > mConnections;
+	};
+
+	bool WaitFor(const std::atomic<Size>& value, Size target)
+	{
+		Timer::CPUTimer timer;
+		timer.Start();
+		while(value.load() < target)
+		{
+			if(timer.GetElapsed() > PHASE_TIMEOUT)
+			{
+				return false;
+			}
+			Thread::Sleep(Seconds(0.001));
+		}
+		return true;
+	}
+
+	void Run(SocketNetworkSystem::Backend backend, Size numberOfConnections, u16 port)
+	{
+		NetworkManager serverManager;
+		NetworkManager clientManager;
+		serverManager.InstallSystem(make_shared<SocketNetworkSystem>(serverManager, 0, 100, backend), true);
+		clientManager.InstallSystem(make_shared<SocketNetworkSystem>(clientManager, 0, 100, backend), true);
+		// The default 5MB buffer per connection would dominate the results and exhaust memory at high connection counts.
+		serverManager.SetNewConnectionBufferSize(BUFFER_SIZE);
+		clientManager.SetNewConnectionBufferSize(BUFFER_SIZE);
+		shared_ptr<LoadServer> server = make_shared<LoadServer>();
+		serverManager.AddNetworkEventListener(server);
+
+		TaskThread serverThread("LoadServer");
+		TaskThread clientThread("LoadClient");
+		serverThread.AddTask(serverManager);
+		clientThread.AddTask(clientManager);
+		serverThread.Execute();
+		clientThread.Execute();
+
+		std::stringstream listenDetails;
+		listenDetails << "direct:ANY:" << port;
+		if(!serverManager.Listen(server.get(), listenDetails.str()))
+		{
+			std::cout << "Unable to listen on port " << port << std::endl;
+			return;
+		}
+
+		std::stringstream connectDetails;
+		connectDetails << "direct:127.0.0.1:" << port;
+		std::vector< shared_ptr<Connection> > clients;
+		clients.reserve(numberOfConnections);
+
+		Timer::CPUTimer connectTimer;
+		connectTimer.Start();
+		for(Size c=0; c < numberOfConnections; ++c)
+		{
+			shared_ptr<Connection> connection = clientManager.Connect(connectDetails.str());
+			if(connection)
+			{
+				clients.push_back(connection);
+			}
+		}
+		bool connected = WaitFor(server->mNumberOfConnections, clients.size());
+		f64 connectTime = connectTimer.Stop().count() / 1000000.0;
+
+		Timer::CPUTimer sendTimer;
+		sendTimer.Start();
+		for(Size m=0; m < MESSAGES_PER_CONNECTION; ++m)
+		{
+			for(shared_ptr<Connection>& connection : clients)
+			{
+				connection->SendControlPacket(1);
+			}
+		}
+		const Size numberOfMessages = clients.size() * MESSAGES_PER_CONNECTION;
+		bool received = WaitFor(server->mNumberOfPackets, numberOfMessages);
+		f64 sendTime = sendTimer.Stop().count() / 1000000000.0;
+
+		std::cout << std::setw(8) << (backend==SocketNetworkSystem::Backends::EPOLL ? "epoll" : "poll")
+				<< std::setw(14) << server->mNumberOfConnections.load() << "/" << std::left << std::setw(8) << numberOfConnections << std::right
+				<< std::setw(16) << std::fixed << std::setprecision(1) << (connected ? connectTime : -1.0)
+				<< std::setw(18) << std::setprecision(0) << (received ? (numberOfMessages / sendTime) : 0.0) << std::endl;
+
+		for(shared_ptr<Connection>& connection : clients)
+		{
+			connection->Disconnect();
+		}
+		serverThread.Terminate(true);
+		clientThread.Terminate(true);
+	}
+}
+
+int main(int, char**)
+{
+	gDefaultLogger.SetLogMask(Logger::LogLevels::ERROR);
+
+	#ifdef ECHO_PLATFORM_LINUX
+	// Each connection uses two descriptors in this process, one for each end, so 20000 connections needs a hard
+	// limit above 40000.
+	rlimit limit;
+	if(getrlimit(RLIMIT_NOFILE, &limit)==0)
+	{
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+		std::cout << "File descriptor limit: " << limit.rlim_cur << std::endl;
+	}
+	#endif
+
+	std::cout << std::setw(8) << "Backend"
+			<< std::setw(23) << "Connections"
+			<< std::setw(16) << "Connect ms"
+			<< std::setw(18) << "Messages/s" << std::endl;
+	u16 port = 43310;
+	const Size connectionCounts[] = {100, 1000, 5000, 20000};
+	for(Size numberOfConnections : connectionCounts)
+	{
+		// The POLL backend creates a thread per FD_SETSIZE sockets so it is only compared at lower counts.
+		if(numberOfConnections <= 5000)
+		{
+			Run(SocketNetworkSystem::Backends::POLL, numberOfConnections, port++);
+		}
+		Run(SocketNetworkSystem::Backends::EPOLL, numberOfConnections, port++);
+	}
+	return 0;
+}
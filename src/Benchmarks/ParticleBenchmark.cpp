@@ -0,0 +1,98 @@
+#include <echo/Graphics/ParticleArrays.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares the time to update and build the visual for a frame of SimpleStandardParticleSystem and
+ * ArrayStandardParticleSystem, with and without a WorkerPool, as the number of particles increases.
+ * Particles live longer than the benchmark so the number of particles stays constant.
+ */
+namespace
+{
+	const Size NUMBER_OF_FRAMES = 20;
+
+	std::vector<StandardParticle> CreateParticles(Size numberOfParticles)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<f32> value(-1.f, 1.f);
+		std::vector<StandardParticle> particles;
+		particles.reserve(numberOfParticles);
+		for(Size i=0; i < numberOfParticles; ++i)
+		{
+			StandardParticle p;
+			p.SetPosition(Vector3(value(generator), value(generator), value(generator)) * 10.f)
+				.SetVelocity(Vector3(value(generator), value(generator), value(generator)))
+				.SetAcceleration(Vector3(0.f, -9.8f, 0.f))
+				.SetLinearDamping(Vector3(0.1f, 0.1f, 0.1f))
+				.SetAngularVelocity(Vector3(value(generator), value(generator), value(generator)))
+				.SetInitialColour(Colours::WHITE)
+				.SetFinalColour(Colours::RED)
+				.SetTime(Seconds(100));
+			p.mInitialTime = p.mTimeLeft;
+			particles.push_back(p);
+		}
+		return particles;
+	}
+
+	template< class ParticleSystemType >
+	f64 Measure(ParticleSystemType& particleSystem, const std::vector<StandardParticle>& particles)
+	{
+		particleSystem.Emit(particles);
+		// Warm up so buffers are allocated.
+		particleSystem.Update(Seconds(1.f / 60.f));
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size frame=0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			particleSystem.Update(Seconds(1.f / 60.f));
+		}
+		return timer.Stop().count() / NUMBER_OF_FRAMES / 1000000.0;
+	}
+}
+
+int main(int, char**)
+{
+	Size numberOfWorkers = std::max<Size>(1, std::thread::hardware_concurrency() - 1);
+	shared_ptr<WorkerPool> workerPool(new WorkerPool(numberOfWorkers));
+	Vector2 particleSize(1.f, 1.f);
+
+	std::cout << "Workers: " << numberOfWorkers << std::endl;
+	std::cout << std::setw(12) << "Particles"
+			<< std::setw(18) << "Simple ms/frame"
+			<< std::setw(18) << "Array ms/frame"
+			<< std::setw(22) << "Array+pool ms/frame" << std::endl;
+	for(Size numberOfParticles = 20000; numberOfParticles <= 1000000; numberOfParticles *= 7)
+	{
+		std::vector<StandardParticle> particles = CreateParticles(numberOfParticles);
+		f64 simpleTime;
+		{
+			SimpleStandardParticleProcessor processor;
+			SimpleStandardParticleSystem particleSystem(processor, StandardParticleQuadMeshBuilder(particleSize));
+			simpleTime = Measure(particleSystem, particles);
+		}
+		f64 arrayTime;
+		{
+			StandardParticleArrayProcessor processor;
+			ArrayStandardParticleSystem particleSystem(processor, StandardParticleArrayQuadBuilder(particleSize));
+			arrayTime = Measure(particleSystem, particles);
+		}
+		f64 pooledTime;
+		{
+			StandardParticleArrayProcessor processor(workerPool);
+			ArrayStandardParticleSystem particleSystem(processor, StandardParticleArrayQuadBuilder(particleSize, workerPool));
+			pooledTime = Measure(particleSystem, particles);
+		}
+		std::cout << std::setw(12) << numberOfParticles
+				<< std::setw(18) << std::fixed << std::setprecision(2) << simpleTime
+				<< std::setw(18) << arrayTime
+				<< std::setw(22) << pooledTime << std::endl;
+	}
+	return 0;
+}
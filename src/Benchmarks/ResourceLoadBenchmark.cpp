@@ -0,0 +1,129 @@
+#include <echo/Platform.h>
+#include <echo/FileSystem/FileSystem.h>
+#include <echo/Resource/TextureManager.h>
+#include <echo/Resource/BitmapLoader.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Measures loading a list of textures with GetResource() one at a time against prefetching the list on a
+ * WorkerPool with GetResourceAsync() and waiting for the loads to finish.
+ *
+ * The textures are bitmaps so the result isn't dominated by a particular image library. They are loaded once
+ * before measuring so the operating system has them cached.
+ */
+namespace
+{
+	const Size NUMBER_OF_TEXTURES = 500;
+	const u32 TEXTURE_SIZE = 256;
+	const Size NUMBER_OF_PASSES = 3;
+	const std::string LIST_FILE = "ResourceLoadBenchmark/Textures.list";
+
+	std::string GetTextureName(Size index)
+	{
+		std::stringstream name;
+		name << "Texture" << index;
+		return name.str();
+	}
+
+	void WriteBitmap(FileSystem& fileSystem, const std::string& fileName, u32 width, u32 height, u8 value)
+	{
+		const u32 headerSize = 54;
+		const u32 dataSize = width * height * 4;
+		File file = fileSystem.Open(fileName, File::OpenModes::WRITE);
+		file.SetEndianMode(File::EndianModes::LITTLE);
+		file.SetEndianConversionEnabled(true);
+		file.Write("BM");
+		file.Write(u32(headerSize + dataSize));
+		file.Write(u32(0));
+		file.Write(headerSize);
+		file.Write(u32(40));
+		file.Write(width);
+		file.Write(height);
+		file.Write(u16(1));
+		file.Write(u16(32));
+		file.Write(u32(0));
+		file.Write(dataSize);
+		file.Write(u32(0));
+		file.Write(u32(0));
+		file.Write(u32(0));
+		file.Write(u32(0));
+		std::vector<u8> data(dataSize, value);
+		file.Write(data.data(), data.size());
+	}
+
+	f64 Measure(FileSystem& fileSystem, shared_ptr<WorkerPool> workerPool)
+	{
+		f64 best = 0.;
+		for(Size pass = 0; pass < NUMBER_OF_PASSES; ++pass)
+		{
+			TextureManager textureManager(fileSystem);
+			textureManager.RegisterLoader(make_shared<BitmapLoader>());
+			textureManager.SetWorkerPool(workerPool, true);
+
+			Timer::CPUTimer timer;
+			timer.Start();
+			textureManager.LoadList(fileSystem.Open(LIST_FILE));
+			if(workerPool)
+			{
+				textureManager.WaitForAsyncLoads();
+			}else
+			{
+				for(Size i = 0; i < NUMBER_OF_TEXTURES; ++i)
+				{
+					textureManager.GetResource(GetTextureName(i));
+				}
+			}
+			f64 milliseconds = timer.Stop().count() / 1000000.;
+			best = (pass==0) ? milliseconds : std::min(best, milliseconds);
+		}
+		return best;
+	}
+}
+
+int main(int, char**)
+{
+	gDefaultLogger.SetLogMask(Logger::LogLevels::ERROR);
+	shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("ResourceLoadBenchmark");
+	fileSystem->CreateDirectories("ResourceLoadBenchmark");
+	{
+		File listFile = fileSystem->Open(LIST_FILE, File::OpenModes::WRITE);
+		for(Size i = 0; i < NUMBER_OF_TEXTURES; ++i)
+		{
+			// Files in the list are relative to the list.
+			WriteBitmap(*fileSystem, "ResourceLoadBenchmark/" + GetTextureName(i) + ".bmp", TEXTURE_SIZE, TEXTURE_SIZE, static_cast<u8>(i));
+			listFile.Write("texture=" + GetTextureName(i) + ".bmp," + GetTextureName(i) + "\n");
+		}
+	}
+
+	const Size hardwareThreads = std::max<Size>(std::thread::hardware_concurrency(), 1);
+	std::cout << NUMBER_OF_TEXTURES << " textures of " << TEXTURE_SIZE << "x" << TEXTURE_SIZE << std::endl;
+	std::cout << std::setw(24) << "Method" << std::setw(16) << "Threads" << std::setw(16) << "ms" << std::endl;
+
+	Measure(*fileSystem, nullptr);
+	std::cout << std::setw(24) << "GetResource" << std::setw(16) << 1
+			<< std::setw(16) << std::fixed << std::setprecision(2) << Measure(*fileSystem, nullptr) << std::endl;
+	for(Size threads = 2; threads <= hardwareThreads * 2; threads *= 2)
+	{
+		// The thread that waits helps the workers.
+		shared_ptr<WorkerPool> workerPool = make_shared<WorkerPool>(threads - 1);
+		std::cout << std::setw(24) << "GetResourceAsync" << std::setw(16) << threads
+				<< std::setw(16) << std::fixed << std::setprecision(2) << Measure(*fileSystem, workerPool) << std::endl;
+	}
+
+	for(Size i = 0; i < NUMBER_OF_TEXTURES; ++i)
+	{
+		fileSystem->DeleteFile("ResourceLoadBenchmark/" + GetTextureName(i) + ".bmp");
+	}
+	fileSystem->DeleteFile(LIST_FILE);
+	fileSystem->DeleteFile("ResourceLoadBenchmark");
+	return 0;
+}
@@ -0,0 +1,157 @@
+#include <echo/Graphics/Scene.h>
+#include <echo/Graphics/SceneEntity.h>
+#include <echo/Graphics/Camera.h>
+#include <echo/Maths/Ray.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares the Scene's linear culling and picking against the spatial index and cached render queues as the number
+ * of renderables increases. Renderables are spread over a large area so the camera can only see a small portion of
+ * them. The camera moves each frame and, in the dynamic scene, a fraction of the renderables move each frame to
+ * include the cost of keeping the index and caches up to date.
+ */
+namespace
+{
+	const Size NUMBER_OF_FRAMES = 100;
+	const Size NUMBER_OF_PICKS = 1000;
+	const f32 WORLD_SIZE = 2000.f;
+
+	struct Modes
+	{
+		enum _
+		{
+			LINEAR,
+			SPATIAL_INDEX,
+			CACHED
+		};
+	};
+	typedef Modes::_ Mode;
+
+	/**
+	 * Exposes the cached render queue that Render() uses.
+	 */
+	class BenchmarkScene : public Scene
+	{
+	public:
+		using Scene::GetCachedRenderQueue;
+	};
+
+	struct Result
+	{
+		f64 mFrameTime;
+		f64 mPickTime;
+		Size mVisible;
+	};
+
+	Result Measure(Size numberOfRenderables, Mode mode, bool moveRenderables)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<f32> position(-WORLD_SIZE / 2.f, WORLD_SIZE / 2.f);
+		std::uniform_real_distribution<f32> offset(-1.f, 1.f);
+
+		BenchmarkScene scene;
+		scene.SetSpatialIndexEnabled(mode==Modes::SPATIAL_INDEX);
+		scene.SetRenderQueueCachingEnabled(mode==Modes::CACHED);
+		shared_ptr<Camera> camera = scene.CreateCamera("Camera");
+		camera->SetNearPlane(1.f);
+		camera->SetFarPlane(500.f);
+		camera->SetPosition(0.f, 0.f, 0.f);
+		camera->LookAt(0.f, 0.f, -100.f);
+
+		std::vector< shared_ptr<SceneEntity> > entities;
+		entities.reserve(numberOfRenderables);
+		for(Size i=0; i < numberOfRenderables; ++i)
+		{
+			shared_ptr<SceneEntity> entity = make_shared<SceneEntity>(Vector3(position(generator), position(generator), position(generator)));
+			entity->SetAxisAlignedBox(AxisAlignedBox(Vector3(-1.f, -1.f, -1.f), Vector3(1.f, 1.f, 1.f)));
+			scene.AddRenderable(entity);
+			entities.push_back(entity);
+		}
+
+		Result result;
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size frame=0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			camera->Translate(Vector3(0.f, 0.f, -0.5f));
+			camera->Yaw(Radian(0.002f));
+			if(moveRenderables)
+			{
+				// Move roughly 1% of the renderables a small amount.
+				for(Size i=frame % 100; i < numberOfRenderables; i+=100)
+				{
+					entities[i]->Translate(Vector3(offset(generator), offset(generator), offset(generator)));
+				}
+			}
+			if(mode==Modes::CACHED)
+			{
+				scene.GetCachedRenderQueue(*camera);
+			}else
+			{
+				scene.BuildRenderQueue(*camera);
+			}
+		}
+		result.mFrameTime = timer.Stop().count() / NUMBER_OF_FRAMES;
+
+		// Pick along rays spread around the view direction.
+		timer.Start();
+		Size hits = 0;
+		for(Size i=0; i < NUMBER_OF_PICKS; ++i)
+		{
+			Vector3 target(offset(generator) * 100.f, offset(generator) * 100.f, -500.f);
+			if(scene.Pick(*camera, Ray(camera->GetPosition(), (camera->GetOrientation() * target).NormalisedCopy())))
+			{
+				++hits;
+			}
+		}
+		result.mPickTime = timer.Stop().count() / NUMBER_OF_PICKS;
+		result.mVisible = hits;
+		return result;
+	}
+
+	bool MeasureScene(bool moveRenderables)
+	{
+		std::cout << (moveRenderables ? "Dynamic scene" : "Static scene") << std::endl;
+		std::cout << std::setw(12) << "Renderables"
+				<< std::setw(20) << "Linear ns/frame"
+				<< std::setw(20) << "Index ns/frame"
+				<< std::setw(20) << "Cached ns/frame"
+				<< std::setw(20) << "Linear ns/pick"
+				<< std::setw(20) << "Index ns/pick"
+				<< std::setw(12) << "Hits" << std::endl;
+		for(Size numberOfRenderables = 1000; numberOfRenderables <= 100000; numberOfRenderables *= 10)
+		{
+			Result linear = Measure(numberOfRenderables, Modes::LINEAR, moveRenderables);
+			Result indexed = Measure(numberOfRenderables, Modes::SPATIAL_INDEX, moveRenderables);
+			Result cached = Measure(numberOfRenderables, Modes::CACHED, moveRenderables);
+			if(linear.mVisible!=indexed.mVisible)
+			{
+				std::cout << "Mismatched pick results " << linear.mVisible << " and " << indexed.mVisible << std::endl;
+				return false;
+			}
+			std::cout << std::setw(12) << numberOfRenderables
+					<< std::setw(20) << std::fixed << std::setprecision(0) << linear.mFrameTime
+					<< std::setw(20) << indexed.mFrameTime
+					<< std::setw(20) << cached.mFrameTime
+					<< std::setw(20) << linear.mPickTime
+					<< std::setw(20) << indexed.mPickTime
+					<< std::setw(12) << indexed.mVisible << std::endl;
+		}
+		return true;
+	}
+}
+
+int main(int, char**)
+{
+	if(!MeasureScene(true) || !MeasureScene(false))
+	{
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,155 @@
+#include <echo/Graphics/Skinning.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares skinning a crowd of characters using per vertex maps of bone weights, the way SubMesh used to, with
+ * SkinWeights and SkinningEngine::SkinPositions on one thread and across a WorkerPool.
+ */
+namespace
+{
+	const Size NUMBER_OF_FRAMES = 10;
+	const Size VERTICES_PER_CHARACTER = 5000;
+	const Size BONES_PER_CHARACTER = 60;
+	const Size VERTICES_PER_JOB = 4096;
+
+	struct Character
+	{
+		std::map< Size, Matrix4 > mBones;
+		std::vector<Matrix4> mPalette;
+		std::vector< std::map< Size, f32 > > mInfluences;
+		SkinWeights mWeights;
+		std::vector<Vector3> mOriginal;
+		shared_ptr<VertexBuffer> mVertices;
+	};
+
+	void CreateCharacter(Character& character, std::mt19937& generator)
+	{
+		std::uniform_real_distribution<f32> value(-1.f, 1.f);
+		std::uniform_int_distribution<Size> bone(0, BONES_PER_CHARACTER - 1);
+		character.mPalette.resize(BONES_PER_CHARACTER);
+		for(Size b = 0; b < BONES_PER_CHARACTER; ++b)
+		{
+			character.mPalette[b].MakeTransform(Vector3(value(generator), value(generator), value(generator)),
+												Vector3::UNIT_SCALE, Quaternion(Radian(value(generator)), Vector3::UNIT_Y));
+			character.mBones[b] = character.mPalette[b];
+		}
+		std::map< u32, std::map< Size, f32 > > influences;
+		character.mInfluences.resize(VERTICES_PER_CHARACTER);
+		for(Size v = 0; v < VERTICES_PER_CHARACTER; ++v)
+		{
+			character.mOriginal.push_back(Vector3(value(generator), value(generator), value(generator)));
+			for(Size i = 0; i < 4; ++i)
+			{
+				character.mInfluences[v][bone(generator)] = 0.25f;
+			}
+			influences[static_cast<u32>(v)] = character.mInfluences[v];
+		}
+		character.mWeights.Build(influences, VERTICES_PER_CHARACTER);
+		character.mVertices = make_shared<VertexBuffer>(VertexBuffer::Types::STATIC);
+		character.mVertices->AddVertexAttribute("Position", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR3));
+		character.mVertices->Allocate(VERTICES_PER_CHARACTER);
+	}
+
+	void SkinWithMaps(Character& character)
+	{
+		VertexBuffer::Accessor<Vector3> vertices = character.mVertices->GetAccessor<Vector3>("Position");
+		for(Size v = 0; v < VERTICES_PER_CHARACTER; ++v)
+		{
+			Vector3 result = Vector3::ZERO;
+			for(const std::pair<const Size, f32>& influence : character.mInfluences[v])
+			{
+				result += (character.mBones[influence.first] * character.mOriginal[v]) * influence.second;
+			}
+			vertices[v] = result;
+		}
+	}
+
+	void SkinRange(Character& character, Size begin, Size end)
+	{
+		VertexBuffer::Accessor<Vector3> vertices = character.mVertices->GetAccessor<Vector3>("Position");
+		SkinningEngine::SkinPositions(character.mPalette.data(), character.mWeights, character.mOriginal.data(), vertices, begin, end);
+	}
+
+	template< class SkinFunction >
+	f64 Measure(std::vector<Character>& characters, SkinFunction skin)
+	{
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size frame=0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			skin();
+		}
+		f64 milliseconds = timer.Stop().count() / NUMBER_OF_FRAMES / 1000000.0;
+		// Use the result so the loop is not optimised away.
+		if(characters.back().mVertices->GetAccessor<Vector3>("Position")[0].x==12345.f)
+		{
+			std::cout << "";
+		}
+		return milliseconds;
+	}
+}
+
+int main(int, char**)
+{
+	Size numberOfWorkers = std::max<Size>(1, std::thread::hardware_concurrency() - 1);
+	shared_ptr<WorkerPool> workerPool(new WorkerPool(numberOfWorkers));
+
+	std::cout << "Workers: " << numberOfWorkers << ", vertices per character: " << VERTICES_PER_CHARACTER << std::endl;
+	std::cout << std::setw(12) << "Characters"
+			<< std::setw(16) << "Maps ms/frame"
+			<< std::setw(20) << "Palette ms/frame"
+			<< std::setw(25) << "Palette+pool ms/frame" << std::endl;
+	std::mt19937 generator(99);
+	for(Size numberOfCharacters = 50; numberOfCharacters <= 500; numberOfCharacters *= 10)
+	{
+		std::vector<Character> characters(numberOfCharacters);
+		for(Character& character : characters)
+		{
+			CreateCharacter(character, generator);
+		}
+
+		f64 mapTime = Measure(characters, [&characters]()
+		{
+			for(Character& character : characters)
+			{
+				SkinWithMaps(character);
+			}
+		});
+
+		f64 paletteTime = Measure(characters, [&characters]()
+		{
+			for(Character& character : characters)
+			{
+				SkinRange(character, 0, VERTICES_PER_CHARACTER);
+			}
+		});
+
+		// Split each character into jobs like SkinningEngine does.
+		const Size jobsPerCharacter = (VERTICES_PER_CHARACTER + VERTICES_PER_JOB - 1) / VERTICES_PER_JOB;
+		f64 pooledTime = Measure(characters, [&characters, &workerPool, jobsPerCharacter]()
+		{
+			workerPool->ParallelFor(0, characters.size() * jobsPerCharacter, 1, [&characters, jobsPerCharacter](Size begin, Size end)
+			{
+				for(Size j = begin; j < end; ++j)
+				{
+					Size first = (j % jobsPerCharacter) * VERTICES_PER_JOB;
+					SkinRange(characters[j / jobsPerCharacter], first, std::min(first + VERTICES_PER_JOB, VERTICES_PER_CHARACTER));
+				}
+			});
+		});
+
+		std::cout << std::setw(12) << numberOfCharacters
+				<< std::setw(16) << std::fixed << std::setprecision(2) << mapTime
+				<< std::setw(20) << paletteTime
+				<< std::setw(25) << pooledTime << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,192 @@
+#include <echo/Graphics/Sprite.h>
+#include <echo/Graphics/SpriteBatch.h>
+#include <echo/Graphics/SpriteAtlas.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Graphics/Scene.h>
+#include <echo/Graphics/Camera.h>
+#include <echo/Resource/TextureManager.h>
+#include <echo/FileSystem/FileSystem.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares animating and preparing 100k individual Sprites for rendering against a SpriteBatch, with and without
+ * the animation frames packed into a SpriteAtlas.
+ *
+ * This runs without a render target. Each renderable visited by the camera is counted as one draw call per
+ * visible sub mesh, which is what Mesh::Render() would issue. For Sprites the visit includes facing the camera
+ * and calculating the transform as rendering does. For the batch it includes writing the quads.
+ */
+namespace
+{
+	const Size NUMBER_OF_SPRITES = 100000;
+	const Size NUMBER_OF_FRAMES = 10;
+	const Size NUMBER_OF_ANIMATIONS = 4;
+	const Size FRAMES_PER_ANIMATION = 8;
+	const Seconds FRAME_TIME(1. / 60.);
+
+	class CountingVisitor : public SceneRenderableVisitor
+	{
+	public:
+		CountingVisitor(const Camera& camera) : mCamera(camera), mDrawCalls(0) {}
+		void SceneRenderableVisit(SceneRenderable& renderable) override
+		{
+			renderable.GetTransform();
+			SceneEntity* entity = dynamic_cast<SceneEntity*>(&renderable);
+			if(entity && entity->GetMesh())
+			{
+				shared_ptr<Mesh> mesh = entity->GetMesh();
+				for(u32 i = 0; i < mesh->GetNumberOfSubMeshes(); ++i)
+				{
+					if(mesh->GetSubMesh(i)->GetVisible())
+					{
+						++mDrawCalls;
+					}
+				}
+			}
+		}
+		const Camera* GetCurrentCamera() override {return &mCamera;}
+		const RenderTarget* GetCurrentRenderTarget() override {return nullptr;}
+		const Camera& mCamera;
+		Size mDrawCalls;
+	};
+
+	struct Result
+	{
+		f64 mUpdateTime;
+		f64 mVisitTime;
+		Size mDrawCalls;
+	};
+
+	std::vector< shared_ptr<SpriteAnimation> > CreateAnimations(TextureManager& textureManager)
+	{
+		std::vector< shared_ptr<SpriteAnimation> > animations;
+		for(Size a = 0; a < NUMBER_OF_ANIMATIONS; ++a)
+		{
+			shared_ptr<SpriteAnimation> animation(new SpriteAnimation(textureManager, "Animation"));
+			for(Size f = 0; f < FRAMES_PER_ANIMATION; ++f)
+			{
+				shared_ptr<Texture> texture(new Texture(64, 64, Texture::Formats::R8G8B8A8));
+				animation->AddFrame("Frame", Seconds(0.05 + 0.01 * f)).texture(texture).width(64.f).height(64.f);
+			}
+			animations.push_back(animation);
+		}
+		return animations;
+	}
+
+	Result MeasureSprites(const std::vector< shared_ptr<SpriteAnimation> >& animations, Camera& camera)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<f32> position(-100.f, 100.f);
+		std::vector< shared_ptr<Sprite> > sprites;
+		sprites.reserve(NUMBER_OF_SPRITES);
+		for(Size i = 0; i < NUMBER_OF_SPRITES; ++i)
+		{
+			shared_ptr<Sprite> sprite = make_shared<Sprite>(Vector3(position(generator), position(generator), position(generator)));
+			sprite->SetAnimation(animations[i % animations.size()]);
+			sprites.push_back(sprite);
+		}
+
+		Result result;
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			for(shared_ptr<Sprite>& sprite : sprites)
+			{
+				sprite->Update(FRAME_TIME);
+			}
+		}
+		result.mUpdateTime = timer.Stop().count() / 1000000. / NUMBER_OF_FRAMES;
+
+		CountingVisitor visitor(camera);
+		timer.Start();
+		for(Size frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			visitor.mDrawCalls = 0;
+			for(shared_ptr<Sprite>& sprite : sprites)
+			{
+				sprite->Accept(visitor);
+			}
+		}
+		result.mVisitTime = timer.Stop().count() / 1000000. / NUMBER_OF_FRAMES;
+		result.mDrawCalls = visitor.mDrawCalls;
+		return result;
+	}
+
+	Result MeasureBatch(const std::vector< shared_ptr<SpriteAnimation> >& animations, Camera& camera)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<f32> position(-100.f, 100.f);
+		SpriteBatch batch;
+		for(Size i = 0; i < NUMBER_OF_SPRITES; ++i)
+		{
+			SpriteBatch::Instance sprite;
+			sprite.mPosition = Vector3(position(generator), position(generator), position(generator));
+			batch.SetAnimation(batch.AddSprite(sprite), animations[i % animations.size()]);
+		}
+
+		Result result;
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			batch.Update(FRAME_TIME);
+		}
+		result.mUpdateTime = timer.Stop().count() / 1000000. / NUMBER_OF_FRAMES;
+
+		CountingVisitor visitor(camera);
+		timer.Start();
+		for(Size frame = 0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			visitor.mDrawCalls = 0;
+			batch.Build(camera.GetDerivedOrientation());
+			batch.Accept(visitor);
+		}
+		result.mVisitTime = timer.Stop().count() / 1000000. / NUMBER_OF_FRAMES;
+		result.mDrawCalls = visitor.mDrawCalls;
+		return result;
+	}
+
+	void Print(const std::string& name, const Result& result)
+	{
+		std::cout << std::setw(20) << name
+				<< std::setw(20) << std::fixed << std::setprecision(2) << result.mUpdateTime
+				<< std::setw(20) << result.mVisitTime
+				<< std::setw(12) << result.mDrawCalls << std::endl;
+	}
+}
+
+int main(int, char**)
+{
+	FileSystem fileSystem;
+	TextureManager textureManager(fileSystem);
+	Scene scene;
+	shared_ptr<Camera> camera = scene.CreateCamera("Camera");
+	camera->SetPosition(0.f, 0.f, 200.f);
+	camera->LookAt(0.f, 0.f, 0.f);
+
+	std::cout << NUMBER_OF_SPRITES << " sprites" << std::endl;
+	std::cout << std::setw(20) << "Method"
+			<< std::setw(20) << "Update ms/frame"
+			<< std::setw(20) << "Visit ms/frame"
+			<< std::setw(12) << "Draw calls" << std::endl;
+
+	std::vector< shared_ptr<SpriteAnimation> > animations = CreateAnimations(textureManager);
+	Print("Sprite", MeasureSprites(animations, *camera));
+	Print("SpriteBatch", MeasureBatch(animations, *camera));
+
+	SpriteAtlas atlas;
+	for(shared_ptr<SpriteAnimation>& animation : animations)
+	{
+		atlas.AddAnimation(animation);
+	}
+	atlas.Build();
+	Print("SpriteBatch+atlas", MeasureBatch(animations, *camera));
+	return 0;
+}
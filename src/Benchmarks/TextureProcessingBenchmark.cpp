@@ -0,0 +1,114 @@
+#include <echo/Graphics/TextureProcessor.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+using namespace Echo;
+
+/**
+ * Measures TextureProcessor conversions, mipmap generation and resizing over common texture sizes, with and
+ * without a WorkerPool. A byte at a time RGBA to BGRA conversion is included as a reference for the conversions.
+ */
+namespace
+{
+	const u32 SIZES[] = {256, 1024, 2048};
+	const Size NUMBER_OF_PASSES = 3;
+
+	template<typename F>
+	f64 Measure(F function)
+	{
+		f64 best = 0.;
+		for(Size pass = 0; pass < NUMBER_OF_PASSES; ++pass)
+		{
+			Timer::CPUTimer timer;
+			timer.Start();
+			function();
+			f64 milliseconds = timer.Stop().count() / 1000000.;
+			best = (pass==0) ? milliseconds : std::min(best, milliseconds);
+		}
+		return best;
+	}
+
+	void Print(const std::string& name, u32 size, f64 serial, f64 parallel)
+	{
+		const f64 megapixels = static_cast<f64>(size) * size / 1000000.;
+		std::cout << std::setw(28) << name
+				<< std::setw(8) << size
+				<< std::setw(14) << std::fixed << std::setprecision(2) << serial
+				<< std::setw(14) << parallel
+				<< std::setw(14) << std::setprecision(1) << megapixels / (std::min(serial, parallel) / 1000.) << std::endl;
+	}
+
+	void ConvertReference(const Texture& source, Texture& destination)
+	{
+		const u8* in = source.GetBuffer().get();
+		u8* out = destination.GetBuffer().get();
+		const Size size = source.GetDataSize();
+		for(Size i = 0; i < size; i += 4)
+		{
+			out[i] = in[i + 2];
+			out[i + 1] = in[i + 1];
+			out[i + 2] = in[i];
+			out[i + 3] = in[i + 3];
+		}
+	}
+}
+
+int main(int, char**)
+{
+	const Size hardwareThreads = std::max<Size>(std::thread::hardware_concurrency(), 1);
+	TextureProcessor serial;
+	// The calling thread helps the workers.
+	TextureProcessor parallel(make_shared<WorkerPool>(std::max<Size>(hardwareThreads, 2) - 1));
+
+	std::cout << std::setw(28) << "Operation"
+			<< std::setw(8) << "Size"
+			<< std::setw(14) << "Serial ms"
+			<< std::setw(14) << "Pool ms"
+			<< std::setw(14) << "MPixels/s" << std::endl;
+
+	std::mt19937 generator(1234);
+	for(u32 size : SIZES)
+	{
+		shared_ptr<Texture> rgba(new Texture(size, size, Texture::Formats::R8G8B8A8));
+		u8* pixels = rgba->GetBuffer().get();
+		for(Size i = 0; i < rgba->GetDataSize(); ++i)
+		{
+			pixels[i] = static_cast<u8>(generator());
+		}
+		shared_ptr<Texture> rgb = serial.Convert(*rgba, Texture::Formats::R8G8B8);
+		Texture reference(size, size, Texture::Formats::B8G8R8A8);
+
+		f64 referenceTime = Measure([&](){ConvertReference(*rgba, reference);});
+		Print("RGBA8->BGRA8 (reference)", size, referenceTime, referenceTime);
+		Print("RGBA8->BGRA8", size,
+			Measure([&](){serial.Convert(*rgba, Texture::Formats::B8G8R8A8);}),
+			Measure([&](){parallel.Convert(*rgba, Texture::Formats::B8G8R8A8);}));
+		Print("RGB8->RGBA8", size,
+			Measure([&](){serial.Convert(*rgb, Texture::Formats::R8G8B8A8);}),
+			Measure([&](){parallel.Convert(*rgb, Texture::Formats::R8G8B8A8);}));
+		Print("RGBA8->R5G6B5", size,
+			Measure([&](){serial.Convert(*rgba, Texture::Formats::R5G6B5);}),
+			Measure([&](){parallel.Convert(*rgba, Texture::Formats::R5G6B5);}));
+		Print("RGBA8->RGBA_F32", size,
+			Measure([&](){serial.Convert(*rgba, Texture::Formats::RGBA_F32);}),
+			Measure([&](){parallel.Convert(*rgba, Texture::Formats::RGBA_F32);}));
+		Print("Mipmaps box", size,
+			Measure([&](){serial.GenerateMipmaps(*rgba, TextureProcessor::Filters::BOX);}),
+			Measure([&](){parallel.GenerateMipmaps(*rgba, TextureProcessor::Filters::BOX);}));
+		Print("Mipmaps box sRGB", size,
+			Measure([&](){serial.GenerateMipmaps(*rgba, TextureProcessor::Filters::BOX, true);}),
+			Measure([&](){parallel.GenerateMipmaps(*rgba, TextureProcessor::Filters::BOX, true);}));
+		Print("Mipmaps Kaiser sRGB", size,
+			Measure([&](){serial.GenerateMipmaps(*rgba, TextureProcessor::Filters::KAISER, true);}),
+			Measure([&](){parallel.GenerateMipmaps(*rgba, TextureProcessor::Filters::KAISER, true);}));
+		Print("Resize 75% triangle", size,
+			Measure([&](){serial.Resize(*rgba, size * 3 / 4, size * 3 / 4);}),
+			Measure([&](){parallel.Resize(*rgba, size * 3 / 4, size * 3 / 4);}));
+	}
+	return 0;
+}
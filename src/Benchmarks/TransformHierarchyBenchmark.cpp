@@ -0,0 +1,113 @@
+#include <echo/Graphics/TransformHierarchy.h>
+#include <echo/Graphics/Node.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Compares the time to move every root of a forest of Node trees and then get the transform of every node,
+ * using Node's on demand updates, a TransformHierarchy and a TransformHierarchy with a WorkerPool.
+ */
+namespace
+{
+	const Size NUMBER_OF_FRAMES = 20;
+	const Size NODES_PER_TREE = 100;
+
+	std::vector< shared_ptr<Node> > CreateForest(Size numberOfNodes)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<f32> value(-1.f, 1.f);
+		std::vector< shared_ptr<Node> > nodes;
+		nodes.reserve(numberOfNodes);
+		for(Size i=0; i < numberOfNodes; ++i)
+		{
+			nodes.push_back(make_shared<Node>(Vector3(value(generator), value(generator), value(generator)),
+											Quaternion(Radian(value(generator)), Vector3::UNIT_Y)));
+			Size treeIndex = i % NODES_PER_TREE;
+			if(treeIndex!=0)
+			{
+				// Each node's parent is one of the previous few nodes in the same tree.
+				Size parent = i - 1 - std::uniform_int_distribution<Size>(0, std::min<Size>(treeIndex - 1, 4))(generator);
+				nodes[parent]->AddChild(*nodes[i]);
+			}
+		}
+		return nodes;
+	}
+
+	template< class UpdateFunction >
+	f64 Measure(std::vector< shared_ptr<Node> >& nodes, UpdateFunction update)
+	{
+		f32 sum = 0.f;
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size frame=0; frame < NUMBER_OF_FRAMES; ++frame)
+		{
+			for(Size i=0; i < nodes.size(); i+=NODES_PER_TREE)
+			{
+				nodes[i]->Translate(Vector3(0.01f, 0.f, 0.f));
+			}
+			update();
+			for(shared_ptr<Node>& node : nodes)
+			{
+				sum += node->GetTransform()[0][3];
+			}
+		}
+		f64 milliseconds = timer.Stop().count() / NUMBER_OF_FRAMES / 1000000.0;
+		// Use the result so the loop is not optimised away.
+		if(sum==0.f)
+		{
+			std::cout << "";
+		}
+		return milliseconds;
+	}
+}
+
+int main(int, char**)
+{
+	Size numberOfWorkers = std::max<Size>(1, std::thread::hardware_concurrency() - 1);
+	shared_ptr<WorkerPool> workerPool(new WorkerPool(numberOfWorkers));
+
+	std::cout << "Workers: " << numberOfWorkers << std::endl;
+	std::cout << std::setw(12) << "Nodes"
+			<< std::setw(18) << "Node ms/frame"
+			<< std::setw(22) << "Hierarchy ms/frame"
+			<< std::setw(27) << "Hierarchy+pool ms/frame" << std::endl;
+	for(Size numberOfNodes = 10000; numberOfNodes <= 1000000; numberOfNodes *= 10)
+	{
+		std::vector< shared_ptr<Node> > nodes = CreateForest(numberOfNodes);
+		f64 nodeTime = Measure(nodes, [](){});
+
+		f64 hierarchyTime;
+		{
+			TransformHierarchy hierarchy;
+			for(Size i=0; i < nodes.size(); i+=NODES_PER_TREE)
+			{
+				hierarchy.AddRoot(*nodes[i]);
+			}
+			hierarchy.Update();
+			hierarchyTime = Measure(nodes, [&hierarchy](){hierarchy.Update();});
+		}
+
+		f64 pooledTime;
+		{
+			TransformHierarchy hierarchy(workerPool);
+			for(Size i=0; i < nodes.size(); i+=NODES_PER_TREE)
+			{
+				hierarchy.AddRoot(*nodes[i]);
+			}
+			hierarchy.Update();
+			pooledTime = Measure(nodes, [&hierarchy](){hierarchy.Update();});
+		}
+		std::cout << std::setw(12) << numberOfNodes
+				<< std::setw(18) << std::fixed << std::setprecision(2) << nodeTime
+				<< std::setw(22) << hierarchyTime
+				<< std::setw(27) << pooledTime << std::endl;
+	}
+	return 0;
+}
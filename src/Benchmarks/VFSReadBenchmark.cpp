@@ -0,0 +1,207 @@
+#include <echo/Platform.h>
+#include <echo/FileSystem/FileSystem.h>
+#include <echo/FileSystem/FileSystemSourceVFS.h>
+#include <echo/FileSystem/FileSystemSourceMemory.h>
+#include <echo/Kernel/Thread.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * Measures reading every file in a VFS archive from multiple threads, with the archive read through the file and
+ * with it memory mapped. Each thread reads its share of the files in chunks, which is how loaders stream data.
+ * The archive is written once and read several times before measuring so the operating system has it cached,
+ * the result is the cost of getting the data to the loaders rather than disk speed.
+ *
+ * The formats are then compared using an archive that also contains many small files. Save is the time to write
+ * the archive, compressing on a worker pool. Load is the time to load the archive and open every file.
+ */
+namespace
+{
+	const Size NUMBER_OF_FILES = 64;
+	const Size FILE_SIZE = 1024 * 1024;
+	const Size NUMBER_OF_SMALL_FILES = 20000;
+	const Size SMALL_FILE_SIZE = 256;
+	const Size CHUNK_SIZE = 16 * 1024;
+	const Size NUMBER_OF_PASSES = 5;
+
+	f64 Measure(FileSystem& fileSystem, Size numberOfThreads)
+	{
+		std::vector< shared_ptr<Thread> > threads;
+		for(Size t=0; t < numberOfThreads; ++t)
+		{
+			threads.push_back(make_shared<Thread>("Reader" + std::to_string(t), [&fileSystem, t, numberOfThreads]()
+			{
+				std::vector<u8> buffer(CHUNK_SIZE);
+				for(Size f = t; f < NUMBER_OF_FILES; f += numberOfThreads)
+				{
+					File file = fileSystem.Open("vfs://file" + std::to_string(f));
+					while(file.Read(buffer.data(), 1, CHUNK_SIZE) > 0)
+					{
+					}
+				}
+			}));
+		}
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(shared_ptr<Thread>& thread : threads)
+		{
+			thread->Execute();
+		}
+		for(shared_ptr<Thread>& thread : threads)
+		{
+			thread->Join();
+		}
+		return timer.Stop().count() / 1000000.;
+	}
+
+	f64 MeasurePasses(FileSystem& fileSystem, const std::string& archive, bool memoryMap, Size numberOfThreads)
+	{
+		shared_ptr<FileSystemSourceVFS> vfs = make_shared<FileSystemSourceVFS>(fileSystem);
+		if(!vfs->LoadVFS(archive, memoryMap) || !fileSystem.InstallSource("vfs", vfs))
+		{
+			return 0.;
+		}
+		Measure(fileSystem, numberOfThreads);
+		f64 best = Measure(fileSystem, numberOfThreads);
+		for(Size p = 1; p < NUMBER_OF_PASSES; ++p)
+		{
+			best = std::min(best, Measure(fileSystem, numberOfThreads));
+		}
+		fileSystem.UninstallSource("vfs");
+		return best;
+	}
+
+	f64 MeasureLoad(FileSystem& fileSystem, const std::string& archive)
+	{
+		Timer::CPUTimer timer;
+		timer.Start();
+		shared_ptr<FileSystemSourceVFS> vfs = make_shared<FileSystemSourceVFS>(fileSystem);
+		if(!vfs->LoadVFS(archive) || !fileSystem.InstallSource("vfs", vfs))
+		{
+			return 0.;
+		}
+		for(Size f = 0; f < NUMBER_OF_SMALL_FILES; ++f)
+		{
+			fileSystem.Open("vfs://small" + std::to_string(f));
+		}
+		f64 elapsed = timer.Stop().count() / 1000000.;
+		fileSystem.UninstallSource("vfs");
+		return elapsed;
+	}
+
+	/**
+	 * Text like data that compresses by a realistic amount.
+	 */
+	void FillWithWords(std::vector<u8>& data, u32 seed)
+	{
+		const char* words[] = {"vertex ", "texture ", "position ", "normal ", "0.125 ", "-1.5 ", "material ", "\n", "{ ", "} ", "3 ", "mesh "};
+		Size i = 0;
+		while(i < data.size())
+		{
+			seed = seed * 1664525 + 1013904223;
+			const char* word = words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+			for(; *word && i < data.size(); ++word, ++i)
+			{
+				data[i] = static_cast<u8>(*word);
+			}
+		}
+	}
+}
+
+int main(int, char**)
+{
+	gDefaultLogger.SetLogMask(Logger::LogLevels::ERROR | Logger::LogLevels::WARNING);
+	shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("VFSReadBenchmark");
+	shared_ptr<FileSystemSourceVFS> vfsOut = make_shared<FileSystemSourceVFS>(*fileSystem);
+	fileSystem->InstallSource("vfsout", vfsOut);
+
+	std::vector< std::vector<u8> > contents(NUMBER_OF_FILES);
+	for(Size f = 0; f < NUMBER_OF_FILES; ++f)
+	{
+		contents[f].resize(FILE_SIZE);
+		FillWithWords(contents[f], static_cast<u32>(f));
+		vfsOut->AddFile("file" + std::to_string(f), "memory://" + FileSystemSourceMemory::MakeMemoryFileName(contents[f].data(), contents[f].size()));
+	}
+	if(!vfsOut->SaveVFS("vfsreadbenchmark.vfs", FileSystemSourceVFS::VFSEndianModes::DEFAULT))
+	{
+		std::cout << "Failed to write the archive" << std::endl;
+		return 1;
+	}
+
+	std::cout << "VFS read ms for " << NUMBER_OF_FILES << " files of " << FILE_SIZE << " bytes in " << CHUNK_SIZE << " byte chunks" << std::endl;
+	std::cout << std::setw(8) << "Threads" << std::setw(14) << "File" << std::setw(14) << "Mapped" << std::endl;
+	const Size threadCounts[] = {1, 2, 4, 8};
+	for(Size numberOfThreads : threadCounts)
+	{
+		f64 file = MeasurePasses(*fileSystem, "vfsreadbenchmark.vfs", false, numberOfThreads);
+		f64 mapped = MeasurePasses(*fileSystem, "vfsreadbenchmark.vfs", true, numberOfThreads);
+		std::cout << std::setw(8) << numberOfThreads << std::fixed << std::setprecision(2)
+					<< std::setw(14) << file
+					<< std::setw(14) << mapped << std::endl;
+	}
+
+	std::vector< std::vector<u8> > smallContents(NUMBER_OF_SMALL_FILES);
+	for(Size f = 0; f < NUMBER_OF_SMALL_FILES; ++f)
+	{
+		smallContents[f].resize(SMALL_FILE_SIZE);
+		FillWithWords(smallContents[f], static_cast<u32>(f + NUMBER_OF_FILES));
+		vfsOut->AddFile("small" + std::to_string(f), "memory://" + FileSystemSourceMemory::MakeMemoryFileName(smallContents[f].data(), smallContents[f].size()));
+	}
+
+	struct Format
+	{
+		std::string mName;
+		bool mIndexed;
+		FileSystemSourceVFS::VFSCompression mCompression;
+	};
+	std::vector<Format> formats = {{"Original", false, FileSystemSourceVFS::VFSCompressions::NONE},
+									{"Indexed", true, FileSystemSourceVFS::VFSCompressions::NONE},
+									{"Indexed LZ4", true, FileSystemSourceVFS::VFSCompressions::LZ4},
+									{"Indexed ZSTD", true, FileSystemSourceVFS::VFSCompressions::ZSTD}};
+	shared_ptr<WorkerPool> workerPool = make_shared<WorkerPool>(std::max<Size>(1, std::thread::hardware_concurrency() - 1));
+
+	std::cout << std::endl << "VFS formats with " << NUMBER_OF_SMALL_FILES << " additional files of " << SMALL_FILE_SIZE << " bytes" << std::endl;
+	std::cout << std::setw(14) << "Format" << std::setw(12) << "Size MB" << std::setw(12) << "Save ms"
+				<< std::setw(12) << "Load ms" << std::setw(14) << "Read ms(1)" << std::setw(14) << "Read ms(4)" << std::endl;
+	for(const Format& format : formats)
+	{
+		if(!FileSystemSourceVFS::GetCompressionSupported(format.mCompression))
+		{
+			std::cout << std::setw(14) << format.mName << "  not supported by this build" << std::endl;
+			continue;
+		}
+		Timer::CPUTimer timer;
+		timer.Start();
+		bool saved = format.mIndexed ?
+			vfsOut->SaveIndexedVFS("vfsformat.vfs", FileSystemSourceVFS::VFSEndianModes::DEFAULT, FileSystemSourceVFS::VFSEntryNameModes::FULL, format.mCompression, workerPool) :
+			vfsOut->SaveVFS("vfsformat.vfs", FileSystemSourceVFS::VFSEndianModes::DEFAULT);
+		f64 saveTime = timer.Stop().count() / 1000000.;
+		if(!saved)
+		{
+			std::cout << std::setw(14) << format.mName << "  failed to save" << std::endl;
+			continue;
+		}
+		f64 size = fileSystem->Open("vfsformat.vfs").GetSize() / (1024. * 1024.);
+		f64 load = MeasureLoad(*fileSystem, "vfsformat.vfs");
+		for(Size p = 1; p < NUMBER_OF_PASSES; ++p)
+		{
+			load = std::min(load, MeasureLoad(*fileSystem, "vfsformat.vfs"));
+		}
+		std::cout << std::setw(14) << format.mName << std::fixed << std::setprecision(2)
+					<< std::setw(12) << size
+					<< std::setw(12) << saveTime
+					<< std::setw(12) << load
+					<< std::setw(14) << MeasurePasses(*fileSystem, "vfsformat.vfs", true, 1)
+					<< std::setw(14) << MeasurePasses(*fileSystem, "vfsformat.vfs", true, 4) << std::endl;
+	}
+	fileSystem->DeleteFile("vfsformat.vfs");
+	fileSystem->DeleteFile("vfsreadbenchmark.vfs");
+	return 0;
+}
@@ -0,0 +1,112 @@
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Kernel/JobGraph.h>
+#include <echo/Chrono/CPUTimer.h>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace Echo;
+
+/**
+ * Measures the per job scheduling overhead of WorkerPool as the number of workers increases.
+ * Jobs are empty so the time is almost entirely scheduling, stealing and completion tracking.
+ */
+namespace
+{
+	const Size NUMBER_OF_JOBS = 200000;
+
+	f64 MeasureFlatJobs(WorkerPool& pool)
+	{
+		std::atomic<Size> executed(0);
+		WorkerPool::Counter counter;
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size i=0; i < NUMBER_OF_JOBS; ++i)
+		{
+			pool.Schedule([&executed](){executed.fetch_add(1, std::memory_order_relaxed);}, counter);
+		}
+		pool.Wait(counter);
+		return timer.Stop().count() / NUMBER_OF_JOBS;
+	}
+
+	f64 MeasureForkedJobs(WorkerPool& pool)
+	{
+		// Jobs are forked from within jobs so they land on worker deques and need to be stolen.
+		const Size numberOfParents = 1000;
+		const Size childrenPerParent = NUMBER_OF_JOBS / numberOfParents;
+		std::atomic<Size> executed(0);
+		WorkerPool::Counter counter;
+		Timer::CPUTimer timer;
+		timer.Start();
+		for(Size i=0; i < numberOfParents; ++i)
+		{
+			pool.Schedule([&pool,&executed,childrenPerParent]()
+			{
+				WorkerPool::Counter childCounter;
+				for(Size j=0; j < childrenPerParent; ++j)
+				{
+					pool.Schedule([&executed](){executed.fetch_add(1, std::memory_order_relaxed);}, childCounter);
+				}
+				pool.Wait(childCounter);
+			}, counter);
+		}
+		pool.Wait(counter);
+		return timer.Stop().count() / NUMBER_OF_JOBS;
+	}
+
+	f64 MeasureParallelFor(WorkerPool& pool)
+	{
+		std::atomic<Size> executed(0);
+		Timer::CPUTimer timer;
+		timer.Start();
+		pool.ParallelFor(0, NUMBER_OF_JOBS, 1, [&executed](Size, Size){executed.fetch_add(1, std::memory_order_relaxed);});
+		return timer.Stop().count() / NUMBER_OF_JOBS;
+	}
+
+	f64 MeasureJobGraph(WorkerPool& pool)
+	{
+		// A chain of fan-out/fan-in stages.
+		const Size stages = 100;
+		const Size jobsPerStage = NUMBER_OF_JOBS / stages;
+		std::atomic<Size> executed(0);
+		JobGraph graph;
+		JobGraph::JobID previousJoin = graph.AddJob([](){});
+		for(Size s=0; s < stages; ++s)
+		{
+			JobGraph::JobID join = graph.AddJob([](){});
+			for(Size j=0; j < jobsPerStage; ++j)
+			{
+				JobGraph::JobID job = graph.AddJob([&executed](){executed.fetch_add(1, std::memory_order_relaxed);});
+				graph.AddDependency(job, previousJoin);
+				graph.AddDependency(join, job);
+			}
+			previousJoin = join;
+		}
+		// Validate outside of the timed section.
+		graph.Execute(pool);
+		Timer::CPUTimer timer;
+		timer.Start();
+		graph.Execute(pool);
+		return timer.Stop().count() / graph.GetNumberOfJobs();
+	}
+}
+
+int main(int, char**)
+{
+	Size maxWorkers = std::thread::hardware_concurrency();
+	maxWorkers = (maxWorkers > 1) ? maxWorkers - 1 : 1;
+	std::cout << "WorkerPool scheduling overhead in ns per job (" << NUMBER_OF_JOBS << " jobs)" << std::endl;
+	std::cout << std::setw(8) << "Workers" << std::setw(12) << "Flat" << std::setw(12) << "Forked"
+				<< std::setw(14) << "ParallelFor" << std::setw(12) << "JobGraph" << std::endl;
+	for(Size workers = 0; workers <= maxWorkers; workers = (workers==0) ? 1 : workers * 2)
+	{
+		WorkerPool pool(workers);
+		std::cout << std::setw(8) << workers << std::fixed << std::setprecision(1)
+					<< std::setw(12) << MeasureFlatJobs(pool)
+					<< std::setw(12) << MeasureForkedJobs(pool)
+					<< std::setw(14) << MeasureParallelFor(pool)
+					<< std::setw(12) << MeasureJobGraph(pool) << std::endl;
+	}
+	return 0;
+}
@@ -166,6 +166,15 @@ namespace Echo
 		return 0;
 	}
 
+	const u8* File::GetData() const
+	{
+		if(mFileReference)
+		{
+			return mFileReference->GetData();
+		}
+		return nullptr;
+	}
+
 	File::File(const File& rhs)
 	{
 		mRequestedFileName = rhs.mRequestedFileName;
@@ -1,21 +1,20 @@
 #include <echo/FileSystem/FileSystemSourceVFS.h>
 #include <echo/FileSystem/FileReferenceVFS.h>
 #include <echo/FileSystem/FileSystem.h>
+#include <echo/Kernel/ScopedLock.h>
 #include <boost/foreach.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 namespace Echo
 {
 	size_t FileReferenceVFS::Read(void* buffer, size_t typeSize, size_t numToRead)
 	{
-//		if(!mFileMutex.Lock())
-//		{
-//			ECHO_LOG_ERROR("Unable to lock file mutex for VFS: " << GetVFSFileName());
-//			return 0;
-//		}
-		size_t seekPosition=mPosition + mFileEntry.mMainOffset;
-		static_cast<FileSystemSourceVFS*>(mSource)->mVFSFile.Seek(seekPosition);
-
+		if(typeSize==0 || mPosition>=mFileSize)
+		{
+			return 0;
+		}
 		size_t bytesTotal=typeSize*numToRead;
 		size_t bytesRemaining=mFileSize-mPosition;
 		if(bytesTotal>bytesRemaining)
@@ -23,16 +22,111 @@ namespace Echo
 			numToRead = bytesRemaining / typeSize;
 		}
 
-		size_t bytesRead=static_cast<FileSystemSourceVFS*>(mSource)->mVFSFile.Read(buffer,typeSize,numToRead);
+		FileSystemSourceVFS* source = static_cast<FileSystemSourceVFS*>(mSource);
+		size_t bytesRead=0;
+		if(mFileEntry.mCompression!=FileSystemSourceVFS::VFSCompressions::NONE)
+		{
+			bytesRead=ReadCompressed(reinterpret_cast<u8*>(buffer),typeSize*numToRead);
+		}else
+		if(source->mData)
+		{
+			// The archive is in memory so no shared state is modified and no lock is needed.
+			bytesRead=typeSize*numToRead;
+			std::memcpy(buffer,GetData()+mPosition,bytesRead);
+		}else
+		{
+			// All files share the archive file so the seek and read need to happen together.
+			ScopedLock lock(source->mFileMutex);
+			source->mVFSFile.Seek(mPosition + mFileEntry.mMainOffset);
+			bytesRead=source->mVFSFile.Read(buffer,typeSize,numToRead);
+		}
 		mPosition+=bytesRead;
-//		if(!mFileMutex.Release())
-//			if(!mFileMutex.Release())		//Try twice
-//			{
-//				ECHO_LOG_ERROR("Unable to release file mutex for VFS: " << GetVFSFileName());
-//			}
 		return bytesRead;
 	}
 
+	size_t FileReferenceVFS::ReadCompressed(u8* buffer, size_t bytesToRead)
+	{
+		const size_t blockSize = static_cast<FileSystemSourceVFS*>(mSource)->mIndexedHeader.mBlockSize;
+		size_t bytesRead=0;
+		while(bytesRead<bytesToRead)
+		{
+			const u32 block = static_cast<u32>(mPosition / blockSize);
+			if(!CacheBlock(block))
+			{
+				break;
+			}
+			const size_t offsetInBlock = mPosition - block * blockSize;
+			const size_t bytesToCopy = std::min(bytesToRead - bytesRead, mBlock.size() - offsetInBlock);
+			std::memcpy(buffer + bytesRead, mBlock.data() + offsetInBlock, bytesToCopy);
+			bytesRead+=bytesToCopy;
+			mPosition+=bytesToCopy;
+		}
+		return bytesRead;
+	}
+
+	bool FileReferenceVFS::CacheBlock(u32 block)
+	{
+		if(mBlockCached && mCachedBlock==block)
+		{
+			return true;
+		}
+		if(block>=mFileEntry.mNumberOfBlocks)
+		{
+			return false;
+		}
+		FileSystemSourceVFS* source = static_cast<FileSystemSourceVFS*>(mSource);
+		const FileSystemSourceVFS::IndexedBlock& indexedBlock = source->GetIndexedBlock(mFileEntry.mFirstBlock + block);
+		const size_t blockSize = source->mIndexedHeader.mBlockSize;
+		mBlock.resize(std::min(blockSize, mFileSize - block * blockSize));
+		mBlockCached = false;
+
+		const u8* stored = nullptr;
+		if(source->mData)
+		{
+			stored = source->mData + indexedBlock.mOffset;
+		}else
+		{
+			mStoredBlock.resize(indexedBlock.mStoredSize);
+			ScopedLock lock(source->mFileMutex);
+			source->mVFSFile.Seek(indexedBlock.mOffset);
+			if(source->mVFSFile.Read(mStoredBlock.data(),1,indexedBlock.mStoredSize)!=indexedBlock.mStoredSize)
+			{
+				ECHO_LOG_ERROR("Failed to read block " << block << " of a VFS entry in " << source->GetVFSFileName());
+				return false;
+			}
+			stored = mStoredBlock.data();
+		}
+
+		FileSystemSourceVFS::VFSCompression compression = static_cast<FileSystemSourceVFS::VFSCompression>(indexedBlock.mCompression);
+		if(compression==FileSystemSourceVFS::VFSCompressions::NONE)
+		{
+			if(indexedBlock.mStoredSize!=mBlock.size())
+			{
+				ECHO_LOG_ERROR("Uncompressed block " << block << " of a VFS entry in " << source->GetVFSFileName() << " is the wrong size");
+				return false;
+			}
+			std::memcpy(mBlock.data(), stored, mBlock.size());
+		}else
+		if(!FileSystemSourceVFS::Decompress(compression, stored, indexedBlock.mStoredSize, mBlock.data(), mBlock.size()))
+		{
+			ECHO_LOG_ERROR("Failed to decompress block " << block << " of a VFS entry in " << source->GetVFSFileName());
+			return false;
+		}
+		mCachedBlock = block;
+		mBlockCached = true;
+		return true;
+	}
+
+	const u8* FileReferenceVFS::GetData() const
+	{
+		const u8* data = static_cast<FileSystemSourceVFS*>(mSource)->mData;
+		if(data && mFileEntry.mCompression==FileSystemSourceVFS::VFSCompressions::NONE)
+		{
+			return data + mFileEntry.mMainOffset;
+		}
+		return nullptr;
+	}
+
 	size_t FileReferenceVFS::Write(const void* /*buffer*/, size_t /*typeSize*/, size_t /*numToWrite*/)
 	{
 		//buffer;typeSize;numToWrite;reference;
@@ -4,6 +4,7 @@
 #include <echo/FileSystem/FileSystemSource.h>
 #include <echo/FileSystem/FileReference.h>
 #include <echo/Util/StringUtils.h>
+#include <echo/Kernel/ScopedLock.h>
 
 namespace Echo
 {
@@ -22,6 +23,7 @@ namespace Echo
 	void FileSystem::FileClosed(FileReference& fileReference)
 	{
 		//notification that a file has closed.
+		ScopedLock lock(mOpenFilesMutex);
 		std::list<FileReference*>::iterator it=std::find(mOpenFiles.begin(),mOpenFiles.end(),&fileReference);
 		if(it==mOpenFiles.end())
 		{
@@ -40,6 +42,7 @@ namespace Echo
 
 	void FileSystem::FileOpened(FileReference& fileReference)
 	{
+		ScopedLock lock(mOpenFilesMutex);
 		mOpenFiles.push_back(&fileReference);
 	}
 
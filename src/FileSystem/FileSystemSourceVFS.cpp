@@ -1,18 +1,114 @@
 #include <echo/FileSystem/FileSystemSourceVFS.h>
 #include <echo/FileSystem/FileReferenceVFS.h>
+#include <echo/FileSystem/FileReferenceFile.h>
 #include <echo/FileSystem/FileSystem.h>
+#include <echo/Kernel/WorkerPool.h>
 #include <boost/foreach.hpp>
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 
+#ifdef ECHO_LZ4_SUPPORT_ENABLED
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#ifdef ECHO_ZSTD_SUPPORT_ENABLED
+#include <zstd.h>
+#endif
+
+#if defined(ECHO_PLATFORM_LINUX) || defined(ECHO_PLATFORM_MAC)
+#define ECHO_VFS_MEMORY_MAP_SUPPORTED
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace Echo
 {
 	#define SWAP_ENDIAN_4(x) ( ((x&0xFF000000)>>24) | ((x&0x00FF0000)>>8) | ((x&0x0000FF00)<<8) | ((x&0x000000FF)<<24))
 
+	namespace
+	{
+		void SwapBytes(u32& value)
+		{
+			value = SWAP_ENDIAN_4(value);
+		}
+
+		void SwapBytes(u64& value)
+		{
+			u32 low = static_cast<u32>(value);
+			u32 high = static_cast<u32>(value >> 32);
+			SwapBytes(low);
+			SwapBytes(high);
+			value = (static_cast<u64>(low) << 32) | high;
+		}
+
+		u64 AlignUp(u64 value, u64 alignment)
+		{
+			return ((value + alignment - 1) / alignment) * alignment;
+		}
+
+		/**
+		 * Compress a block for the indexed format.
+		 * @return false if the block couldn't be compressed or wasn't made smaller.
+		 */
+		bool CompressBlock(FileSystemSourceVFS::VFSCompression compression, const u8* source, size_t sourceSize, std::vector<u8>& destination)
+		{
+	#if !defined(ECHO_LZ4_SUPPORT_ENABLED) && !defined(ECHO_ZSTD_SUPPORT_ENABLED)
+			(void)source;
+	#endif
+			switch(compression)
+			{
+	#ifdef ECHO_LZ4_SUPPORT_ENABLED
+				case FileSystemSourceVFS::VFSCompressions::LZ4:
+				{
+					destination.resize(LZ4_compressBound(static_cast<int>(sourceSize)));
+					int compressedSize = LZ4_compress_HC(reinterpret_cast<const char*>(source), reinterpret_cast<char*>(destination.data()),
+														static_cast<int>(sourceSize), static_cast<int>(destination.size()), LZ4HC_CLEVEL_DEFAULT);
+					if(compressedSize<=0)
+					{
+						return false;
+					}
+					destination.resize(compressedSize);
+				}
+				break;
+	#endif
+	#ifdef ECHO_ZSTD_SUPPORT_ENABLED
+				case FileSystemSourceVFS::VFSCompressions::ZSTD:
+				{
+					// Contexts are expensive to create so each thread keeps one.
+					static thread_local unique_ptr<ZSTD_CCtx, size_t(*)(ZSTD_CCtx*)> context(ZSTD_createCCtx(), ZSTD_freeCCtx);
+					destination.resize(ZSTD_compressBound(sourceSize));
+					size_t compressedSize = ZSTD_compressCCtx(context.get(), destination.data(), destination.size(), source, sourceSize, 12);
+					if(ZSTD_isError(compressedSize))
+					{
+						return false;
+					}
+					destination.resize(compressedSize);
+				}
+				break;
+	#endif
+				default:
+					return false;
+			}
+			return destination.size() < sourceSize;
+		}
+	}
+
 	FileSystemSourceVFS::FileSystemSourceVFS(FileSystem& vfsLoaderFileSystem) : FileSystemSource("vfs"),
 			EVFS_VERSION(0xEC400002),
 			EVFS_VERSION_SWITCH(SWAP_ENDIAN_4(EVFS_VERSION)),
-			mVFSLoaderFileSystem(vfsLoaderFileSystem)
+			EVFS_INDEXED_VERSION(0xEC400003),
+			EVFS_INDEXED_VERSION_SWITCH(SWAP_ENDIAN_4(EVFS_INDEXED_VERSION)),
+			mIndexedHeader(),
+			mIndexedEntries(nullptr),
+			mIndexedBlocks(nullptr),
+			mIndexedNames(nullptr),
+			mVFSLoaderFileSystem(vfsLoaderFileSystem),
+			mData(nullptr),
+			mMapping(nullptr),
+			mMappingSize(0)
 	{
 	}
 
@@ -23,8 +119,13 @@ namespace Echo
 
 	//////////////////////////////////////////////////////////////////////////
 	//VFS Source functionality
-	bool FileSystemSourceVFS::LoadVFS(const std::string& vfsFile)
+	bool FileSystemSourceVFS::LoadVFS(const std::string& vfsFile, bool memoryMap)
 	{
+		UnmapVFS();
+		mIndexedEntries = nullptr;
+		mIndexedBlocks = nullptr;
+		mIndexedNames = nullptr;
+		mIndex.clear();
 		mVFSFile = mVFSLoaderFileSystem.Open(vfsFile);
 		if(!mVFSFile.IsOpen())
 		{
@@ -32,8 +133,20 @@ namespace Echo
 			return false;
 		}
 
+		// An archive that is already in memory can be used directly, otherwise try to map it.
+		mData = mVFSFile.GetData();
+		if(!mData && memoryMap)
+		{
+			MapVFS();
+		}
+
 		mVFSFile.Read(&mVFSVersion,4,1);
 
+		if(mVFSVersion==EVFS_INDEXED_VERSION || mVFSVersion==EVFS_INDEXED_VERSION_SWITCH)
+		{
+			return LoadIndexedVFS(mVFSVersion==EVFS_INDEXED_VERSION_SWITCH);
+		}
+
 		if(mVFSVersion==EVFS_VERSION)
 		{
 			ECHO_LOG_INFO("VFS Version: 0x" << std::hex << mVFSVersion << std::dec << " Native to build" );
@@ -73,10 +186,17 @@ namespace Echo
 				nameBuffer[entryNameSize]=0;
 				std::string entryName;
 				entryName=(char*)nameBuffer;
+				delete [] nameBuffer;
 
 				//12 bytes before name + name length
 				entrySearchPosition+=12+entryNameSize;
 				ECHO_LOG_DEBUG("Entry: " << entryName << " " << fse.mDataSize << " bytes at " << std::hex << fse.mMainOffset << std::dec);
+				if(mData && fse.mMainOffset + fse.mDataSize > mVFSFile.GetSize())
+				{
+					// Reads from memory aren't bounded by the file so the entry needs to be within the archive.
+					ECHO_LOG_ERROR("VFS entry " << entryName << " extends past the end of the archive. The entry will not be available.");
+					continue;
+				}
 				mDirectory[entryName]=fse;
 			}
 			//delete [] vfsHeader;
@@ -89,15 +209,72 @@ namespace Echo
 
 	void FileSystemSourceVFS::UnloadVFS()
 	{
+		UnmapVFS();
 		mVFSFile.Close();
 		mDirectory.clear();
+		mIndexedEntries = nullptr;
+		mIndexedBlocks = nullptr;
+		mIndexedNames = nullptr;
+		mIndex.clear();
 	}
 
-	bool FileSystemSourceVFS::AddFile(std::string targetName, const std::string& source)
+	bool FileSystemSourceVFS::MapVFS()
+	{
+#ifdef ECHO_VFS_MEMORY_MAP_SUPPORTED
+		// Only files on disk can be mapped, other sources are read through the file.
+		if(!dynamic_pointer_cast<FileReferenceFile>(mVFSFile.GetReference()) || mVFSFile.GetSize()==0)
+		{
+			return false;
+		}
+		int fileDescriptor = open(mVFSFile.GetActualFileName().c_str(), O_RDONLY);
+		if(fileDescriptor<0)
+		{
+			ECHO_LOG_WARNING("VFS unable to open " << mVFSFile.GetActualFileName() << " for mapping. Reads will go through the file.");
+			return false;
+		}
+		struct stat fileStat;
+		if(fstat(fileDescriptor,&fileStat)!=0 || static_cast<size_t>(fileStat.st_size)!=mVFSFile.GetSize())
+		{
+			close(fileDescriptor);
+			ECHO_LOG_WARNING("VFS unable to determine the size of " << mVFSFile.GetActualFileName() << " for mapping. Reads will go through the file.");
+			return false;
+		}
+		void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		// The mapping remains valid after the descriptor is closed.
+		close(fileDescriptor);
+		if(mapping==MAP_FAILED)
+		{
+			ECHO_LOG_WARNING("VFS failed to map " << mVFSFile.GetActualFileName() << ". Reads will go through the file.");
+			return false;
+		}
+		mMapping = mapping;
+		mMappingSize = fileStat.st_size;
+		mData = reinterpret_cast<const u8*>(mapping);
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void FileSystemSourceVFS::UnmapVFS()
+	{
+#ifdef ECHO_VFS_MEMORY_MAP_SUPPORTED
+		if(mMapping)
+		{
+			munmap(mMapping, mMappingSize);
+		}
+#endif
+		mMapping = nullptr;
+		mMappingSize = 0;
+		mData = nullptr;
+	}
+
+	bool FileSystemSourceVFS::AddFile(std::string targetName, const std::string& source, VFSCompression compression)
 	{
 		if(mOutDirectory.find(targetName)==mOutDirectory.end())
 		{
 			mOutDirectory[targetName] = source;
+			mOutCompression[targetName] = compression;
 			return true;
 		}
 		return false;
@@ -111,6 +288,7 @@ namespace Echo
 	void FileSystemSourceVFS::ClearOutDirectory()
 	{
 		mOutDirectory.clear();
+		mOutCompression.clear();
 	}
 
 	bool FileSystemSourceVFS::SaveVFS(const std::string& vfsFile, VFSEndianMode endianMode, VFSEntryNameMode entryNameMode)
@@ -339,6 +517,539 @@ namespace Echo
 		return true;
 	}
 
+	bool FileSystemSourceVFS::GetCompressionSupported(VFSCompression compression)
+	{
+		switch(compression)
+		{
+			case VFSCompressions::NONE:
+				return true;
+	#ifdef ECHO_LZ4_SUPPORT_ENABLED
+			case VFSCompressions::LZ4:
+				return true;
+	#endif
+	#ifdef ECHO_ZSTD_SUPPORT_ENABLED
+			case VFSCompressions::ZSTD:
+				return true;
+	#endif
+			default:
+				return false;
+		}
+	}
+
+	bool FileSystemSourceVFS::Decompress(VFSCompression compression, const u8* source, size_t sourceSize, u8* destination, size_t destinationSize)
+	{
+	#if !defined(ECHO_LZ4_SUPPORT_ENABLED) && !defined(ECHO_ZSTD_SUPPORT_ENABLED)
+		(void)source;
+		(void)sourceSize;
+		(void)destination;
+		(void)destinationSize;
+	#endif
+		switch(compression)
+		{
+	#ifdef ECHO_LZ4_SUPPORT_ENABLED
+			case VFSCompressions::LZ4:
+				return LZ4_decompress_safe(reinterpret_cast<const char*>(source), reinterpret_cast<char*>(destination),
+											static_cast<int>(sourceSize), static_cast<int>(destinationSize))==static_cast<int>(destinationSize);
+	#endif
+	#ifdef ECHO_ZSTD_SUPPORT_ENABLED
+			case VFSCompressions::ZSTD:
+			{
+				static thread_local unique_ptr<ZSTD_DCtx, size_t(*)(ZSTD_DCtx*)> context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+				return ZSTD_decompressDCtx(context.get(), destination, destinationSize, source, sourceSize)==destinationSize;
+			}
+	#endif
+			default:
+				return false;
+		}
+	}
+
+	u64 FileSystemSourceVFS::HashName(const char* name, size_t length)
+	{
+		// FNV-1a
+		u64 hash = 14695981039346656037ULL;
+		for(size_t i = 0; i < length; ++i)
+		{
+			hash ^= static_cast<u8>(name[i]);
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	void FileSystemSourceVFS::SwapEndian(IndexedHeader& header)
+	{
+		SwapBytes(header.mVersion);
+		SwapBytes(header.mNumberOfEntries);
+		SwapBytes(header.mNumberOfBlocks);
+		SwapBytes(header.mBlockSize);
+		SwapBytes(header.mEntriesOffset);
+		SwapBytes(header.mNamesOffset);
+		SwapBytes(header.mNamesSize);
+		SwapBytes(header.mBlocksOffset);
+	}
+
+	void FileSystemSourceVFS::SwapEndian(IndexedEntry& entry)
+	{
+		SwapBytes(entry.mNameHash);
+		SwapBytes(entry.mDataOffset);
+		SwapBytes(entry.mDataSize);
+		SwapBytes(entry.mNameOffset);
+		SwapBytes(entry.mNameLength);
+		SwapBytes(entry.mFirstBlock);
+		SwapBytes(entry.mNumberOfBlocks);
+		SwapBytes(entry.mCompression);
+		SwapBytes(entry.mReserved);
+	}
+
+	void FileSystemSourceVFS::SwapEndian(IndexedBlock& block)
+	{
+		SwapBytes(block.mOffset);
+		SwapBytes(block.mStoredSize);
+		SwapBytes(block.mCompression);
+	}
+
+	bool FileSystemSourceVFS::LoadIndexedVFS(bool swapEndian)
+	{
+		static_assert(sizeof(IndexedHeader)==48, "The indexed VFS header must match the file format");
+		static_assert(sizeof(IndexedEntry)==48, "Indexed VFS entries must match the file format");
+		static_assert(sizeof(IndexedBlock)==16, "Indexed VFS blocks must match the file format");
+
+		IndexedHeader header;
+		mVFSFile.Seek(0);
+		if(mVFSFile.Read(&header,1,sizeof(IndexedHeader))!=sizeof(IndexedHeader))
+		{
+			ECHO_LOG_ERROR("VFS indexed header is incomplete");
+			return false;
+		}
+		if(swapEndian)
+		{
+			ECHO_LOG_INFO("VFS Version: 0x" << std::hex << mVFSVersion << std::dec << " Indexed. Opposite Endian format. Converting index.");
+			SwapEndian(header);
+		}else
+		{
+			ECHO_LOG_INFO("VFS Version: 0x" << std::hex << mVFSVersion << std::dec << " Indexed. Native to build");
+		}
+
+		// The tables are contiguous, entries then names then blocks.
+		const u64 archiveSize = mVFSFile.GetSize();
+		const u64 entriesSize = static_cast<u64>(header.mNumberOfEntries) * sizeof(IndexedEntry);
+		const u64 blocksSize = static_cast<u64>(header.mNumberOfBlocks) * sizeof(IndexedBlock);
+		if(header.mBlockSize==0 || header.mEntriesOffset!=sizeof(IndexedHeader) ||
+			header.mNamesOffset!=header.mEntriesOffset + entriesSize ||
+			header.mBlocksOffset<header.mNamesOffset + header.mNamesSize || header.mBlocksOffset%8!=0 ||
+			header.mBlocksOffset>archiveSize || blocksSize>archiveSize - header.mBlocksOffset)
+		{
+			ECHO_LOG_ERROR("VFS indexed header is invalid");
+			return false;
+		}
+
+		const u64 indexSize = header.mBlocksOffset + blocksSize - header.mEntriesOffset;
+		const u8* index = nullptr;
+		if(mData && !swapEndian && (reinterpret_cast<uintptr_t>(mData) % alignof(u64))==0)
+		{
+			index = mData + header.mEntriesOffset;
+		}else
+		{
+			mIndex.resize((indexSize + sizeof(u64) - 1) / sizeof(u64));
+			u8* indexCopy = reinterpret_cast<u8*>(mIndex.data());
+			if(mVFSFile.Read(indexCopy,1,indexSize)!=indexSize)
+			{
+				ECHO_LOG_ERROR("VFS index is incomplete");
+				mIndex.clear();
+				return false;
+			}
+			if(swapEndian)
+			{
+				IndexedEntry* entries = reinterpret_cast<IndexedEntry*>(indexCopy);
+				for(u32 e = 0; e < header.mNumberOfEntries; ++e)
+				{
+					SwapEndian(entries[e]);
+				}
+				IndexedBlock* blocks = reinterpret_cast<IndexedBlock*>(indexCopy + (header.mBlocksOffset - header.mEntriesOffset));
+				for(u32 b = 0; b < header.mNumberOfBlocks; ++b)
+				{
+					SwapEndian(blocks[b]);
+				}
+			}
+			index = indexCopy;
+		}
+		mIndexedHeader = header;
+		mIndexedEntries = reinterpret_cast<const IndexedEntry*>(index);
+		mIndexedNames = reinterpret_cast<const char*>(index + (header.mNamesOffset - header.mEntriesOffset));
+		mIndexedBlocks = reinterpret_cast<const IndexedBlock*>(index + (header.mBlocksOffset - header.mEntriesOffset));
+		ECHO_LOG_DEBUG("VFS Entries: " << header.mNumberOfEntries << " Blocks: " << header.mNumberOfBlocks);
+		return true;
+	}
+
+	const FileSystemSourceVFS::IndexedEntry* FileSystemSourceVFS::FindIndexedEntry(const std::string& fileName) const
+	{
+		const u64 hash = HashName(fileName.data(), fileName.length());
+		const IndexedEntry* end = mIndexedEntries + mIndexedHeader.mNumberOfEntries;
+		const IndexedEntry* it = std::lower_bound(mIndexedEntries, end, hash, [](const IndexedEntry& entry, u64 h){return entry.mNameHash < h;});
+		for(; it!=end && it->mNameHash==hash; ++it)
+		{
+			if(it->mNameLength==fileName.length() && static_cast<u64>(it->mNameOffset) + it->mNameLength <= mIndexedHeader.mNamesSize &&
+				std::memcmp(mIndexedNames + it->mNameOffset, fileName.data(), it->mNameLength)==0)
+			{
+				return it;
+			}
+		}
+		return nullptr;
+	}
+
+	std::vector<std::string> FileSystemSourceVFS::GetFileNames() const
+	{
+		std::vector<std::string> names;
+		if(mIndexedEntries)
+		{
+			for(u32 e = 0; e < mIndexedHeader.mNumberOfEntries; ++e)
+			{
+				const IndexedEntry& entry = mIndexedEntries[e];
+				if(static_cast<u64>(entry.mNameOffset) + entry.mNameLength <= mIndexedHeader.mNamesSize)
+				{
+					names.push_back(std::string(mIndexedNames + entry.mNameOffset, entry.mNameLength));
+				}
+			}
+			std::sort(names.begin(), names.end());
+		}else
+		{
+			for(auto& it : mDirectory)
+			{
+				names.push_back(it.first);
+			}
+		}
+		return names;
+	}
+
+	bool FileSystemSourceVFS::SaveIndexedVFS(const std::string& vfsFile, VFSEndianMode endianMode, VFSEntryNameMode entryNameMode, VFSCompression compression, shared_ptr<WorkerPool> workerPool)
+	{
+		if(!GetFileSystem())
+		{
+			ECHO_LOG_ERROR("VFS source must be installed to a FileSystem before it can write. The FileSystem is used as the source of files when writing.");
+			return false;
+		}
+		if(compression==VFSCompressions::DEFAULT)
+		{
+			compression = VFSCompressions::NONE;
+		}
+
+		// Find the files to write.
+		std::vector< VFSOutEntry > files;
+		u32 numErrors=0;
+		for(auto& it : mOutDirectory)
+		{
+			const std::string& targetName = it.first;
+			const std::string& sourceName = it.second;
+			File touch = mVFSLoaderFileSystem.Open(sourceName);
+			if(!touch.IsOpen())
+			{
+				ECHO_LOG_ERROR("Cannot open " << sourceName);
+				numErrors++;
+				continue;
+			}
+			VFSOutEntry entry;
+			entry.mFileIncSource=sourceName;
+			if(targetName!=sourceName)
+			{
+				entry.mTargetFileName = targetName;
+			}else
+			{
+				// The source and target are the same so we have to make sure we remove "source://"
+				GetFileSystem()->ResolveSource(sourceName,entry.mTargetFileName);
+			}
+			entry.mDataSize=touch.GetSize();
+			std::map< std::string, VFSCompression >::iterator compressionIt = mOutCompression.find(targetName);
+			entry.mCompression = (compressionIt!=mOutCompression.end()) ? compressionIt->second : VFSCompressions::DEFAULT;
+			if(entry.mCompression==VFSCompressions::DEFAULT)
+			{
+				entry.mCompression = compression;
+			}
+			if(!GetCompressionSupported(entry.mCompression))
+			{
+				ECHO_LOG_ERROR("Compression " << entry.mCompression << " requested for " << sourceName << " is not supported in this build");
+				return false;
+			}
+			files.push_back(entry);
+		}
+
+		// Create the entries. Files can have an entry for their full name and their file name.
+		std::vector<IndexedEntry> entries;
+		std::vector<Size> entryFiles;
+		std::string names;
+		for(Size f = 0; f < files.size(); ++f)
+		{
+			std::vector<std::string> entryNames;
+			if(entryNameMode&VFSEntryNameModes::FULL)
+			{
+				entryNames.push_back(files[f].mTargetFileName);
+			}
+			if(entryNameMode&VFSEntryNameModes::FILE_NAME)
+			{
+				std::string name=files[f].mTargetFileName;
+				size_t i=name.find_last_of('/');
+				if (i!=std::string::npos)
+				{
+					name=name.substr(i+1, name.size()-i-1);
+				}
+				if(entryNames.empty() || entryNames.back()!=name)
+				{
+					entryNames.push_back(name);
+				}
+			}
+			for(const std::string& name : entryNames)
+			{
+				IndexedEntry entry = IndexedEntry();
+				entry.mNameHash = HashName(name.data(), name.length());
+				entry.mNameOffset = static_cast<u32>(names.length());
+				entry.mNameLength = static_cast<u32>(name.length());
+				names+=name;
+				entries.push_back(entry);
+				entryFiles.push_back(f);
+			}
+		}
+
+		// Blocks are reserved for every compressed file. Files that don't compress are stored without blocks.
+		const u64 blockSize = INDEXED_BLOCK_SIZE;
+		u64 maximumBlocks = 0;
+		for(const VFSOutEntry& file : files)
+		{
+			if(file.mCompression!=VFSCompressions::NONE)
+			{
+				maximumBlocks += (file.mDataSize + blockSize - 1) / blockSize;
+			}
+		}
+		IndexedHeader header = IndexedHeader();
+		header.mVersion = EVFS_INDEXED_VERSION;
+		header.mNumberOfEntries = static_cast<u32>(entries.size());
+		header.mBlockSize = INDEXED_BLOCK_SIZE;
+		header.mEntriesOffset = sizeof(IndexedHeader);
+		header.mNamesOffset = header.mEntriesOffset + entries.size() * sizeof(IndexedEntry);
+		header.mNamesSize = names.length();
+		header.mBlocksOffset = AlignUp(header.mNamesOffset + header.mNamesSize, 8);
+		const u64 dataOffset = AlignUp(header.mBlocksOffset + maximumBlocks * sizeof(IndexedBlock), INDEXED_ALIGNMENT);
+
+		File vfsOut = mVFSLoaderFileSystem.Open(vfsFile, File::OpenModes::WRITE);
+		if(!vfsOut.IsOpen())
+		{
+			ECHO_LOG_ERROR("Unable to open " << vfsFile);
+			return false;
+		}
+
+		// The index is written once the data has been written.
+		std::vector<u8> padding(std::max<u64>(dataOffset, INDEXED_ALIGNMENT), 0);
+		if(vfsOut.Write(padding.data(),1,dataOffset)!=dataOffset)
+		{
+			numErrors++;
+		}
+		u64 position = dataOffset;
+
+		struct FileResult
+		{
+			u64 mDataOffset;
+			u32 mFirstBlock;
+			u32 mNumberOfBlocks;
+			VFSCompression mCompression;
+		};
+		struct BlockJob
+		{
+			Size mFile;
+			size_t mOffset;
+			size_t mSize;
+			std::vector<u8> mCompressed;
+			bool mCompressedSmaller;
+		};
+		std::vector<FileResult> results(files.size());
+		std::vector<IndexedBlock> blocks;
+
+		// Files are read and compressed in batches to limit memory use.
+		const u64 batchSize = 64 * 1024 * 1024;
+		Size f = 0;
+		while(f < files.size())
+		{
+			std::vector< std::vector<u8> > data;
+			Size batchEnd = f;
+			u64 batchBytes = 0;
+			while(batchEnd < files.size() && (batchEnd==f || batchBytes + files[batchEnd].mDataSize <= batchSize))
+			{
+				data.push_back(std::vector<u8>(files[batchEnd].mDataSize));
+				File dataFile = mVFSLoaderFileSystem.Open(files[batchEnd].mFileIncSource);
+				size_t bytesRead = dataFile.Read(data.back().data(),1,data.back().size());
+				if(bytesRead<data.back().size())
+				{
+					ECHO_LOG_ERROR(bytesRead << " bytes read of " << data.back().size() << " from " << files[batchEnd].mFileIncSource << ". It will be invalid.");
+					numErrors++;
+				}
+				batchBytes += files[batchEnd].mDataSize;
+				++batchEnd;
+			}
+
+			std::vector<BlockJob> jobs;
+			for(Size b = f; b < batchEnd; ++b)
+			{
+				if(files[b].mCompression==VFSCompressions::NONE)
+				{
+					continue;
+				}
+				for(size_t offset = 0; offset < files[b].mDataSize; offset += blockSize)
+				{
+					BlockJob job;
+					job.mFile = b;
+					job.mOffset = offset;
+					job.mSize = std::min<size_t>(blockSize, files[b].mDataSize - offset);
+					job.mCompressedSmaller = false;
+					jobs.push_back(job);
+				}
+			}
+			auto compressJobs = [&jobs, &data, &files, f](Size begin, Size end)
+			{
+				for(Size j = begin; j < end; ++j)
+				{
+					BlockJob& job = jobs[j];
+					job.mCompressedSmaller = CompressBlock(files[job.mFile].mCompression, data[job.mFile - f].data() + job.mOffset, job.mSize, job.mCompressed);
+				}
+			};
+			if(workerPool)
+			{
+				workerPool->ParallelFor(0, jobs.size(), 1, compressJobs);
+			}else
+			{
+				compressJobs(0, jobs.size());
+			}
+
+			Size job = 0;
+			for(Size b = f; b < batchEnd; ++b)
+			{
+				const std::vector<u8>& fileData = data[b - f];
+				FileResult& result = results[b];
+				result.mCompression = files[b].mCompression;
+				result.mFirstBlock = 0;
+				result.mNumberOfBlocks = 0;
+				if(result.mCompression!=VFSCompressions::NONE)
+				{
+					Size firstJob = job;
+					while(job < jobs.size() && jobs[job].mFile==b)
+					{
+						++job;
+					}
+					bool anyCompressed = false;
+					for(Size j = firstJob; j < job; ++j)
+					{
+						anyCompressed = anyCompressed || jobs[j].mCompressedSmaller;
+					}
+					if(anyCompressed)
+					{
+						result.mFirstBlock = static_cast<u32>(blocks.size());
+						result.mNumberOfBlocks = static_cast<u32>(job - firstJob);
+						result.mDataOffset = position;
+						for(Size j = firstJob; j < job; ++j)
+						{
+							IndexedBlock block = IndexedBlock();
+							block.mOffset = position;
+							const u8* stored = fileData.data() + jobs[j].mOffset;
+							size_t storedSize = jobs[j].mSize;
+							block.mCompression = VFSCompressions::NONE;
+							if(jobs[j].mCompressedSmaller)
+							{
+								stored = jobs[j].mCompressed.data();
+								storedSize = jobs[j].mCompressed.size();
+								block.mCompression = result.mCompression;
+							}
+							block.mStoredSize = static_cast<u32>(storedSize);
+							if(vfsOut.Write(stored,1,storedSize)!=storedSize)
+							{
+								numErrors++;
+							}
+							position += storedSize;
+							blocks.push_back(block);
+						}
+						continue;
+					}
+					result.mCompression = VFSCompressions::NONE;
+				}
+
+				const u64 alignedPosition = AlignUp(position, INDEXED_ALIGNMENT);
+				if(alignedPosition!=position)
+				{
+					vfsOut.Write(padding.data(),1,alignedPosition - position);
+					position = alignedPosition;
+				}
+				result.mDataOffset = position;
+				if(vfsOut.Write(fileData.data(),1,fileData.size())!=fileData.size())
+				{
+					numErrors++;
+				}
+				position += fileData.size();
+			}
+			f = batchEnd;
+		}
+
+		for(Size e = 0; e < entries.size(); ++e)
+		{
+			const FileResult& result = results[entryFiles[e]];
+			entries[e].mDataOffset = result.mDataOffset;
+			entries[e].mDataSize = files[entryFiles[e]].mDataSize;
+			entries[e].mFirstBlock = result.mFirstBlock;
+			entries[e].mNumberOfBlocks = result.mNumberOfBlocks;
+			entries[e].mCompression = result.mCompression;
+		}
+		const std::string& allNames = names;
+		std::sort(entries.begin(), entries.end(), [&allNames](const IndexedEntry& a, const IndexedEntry& b)
+		{
+			if(a.mNameHash!=b.mNameHash)
+			{
+				return a.mNameHash < b.mNameHash;
+			}
+			return allNames.compare(a.mNameOffset, a.mNameLength, allNames, b.mNameOffset, b.mNameLength) < 0;
+		});
+		header.mNumberOfBlocks = static_cast<u32>(blocks.size());
+
+		bool swapEndian = false;
+		switch(endianMode)
+		{
+			case VFSEndianModes::DEFAULT:
+			case VFSEndianModes::LITTLE:
+	#ifdef ECHO_BIG_ENDIAN
+				swapEndian = true;
+	#endif
+			break;
+			case VFSEndianModes::BIG:
+	#ifdef ECHO_LITTLE_ENDIAN
+				swapEndian = true;
+	#endif
+			break;
+		}
+		if(swapEndian)
+		{
+			SwapEndian(header);
+			for(IndexedEntry& entry : entries)
+			{
+				SwapEndian(entry);
+			}
+			for(IndexedBlock& block : blocks)
+			{
+				SwapEndian(block);
+			}
+		}
+
+		const u64 namesEnd = sizeof(IndexedHeader) + entries.size() * sizeof(IndexedEntry) + names.length();
+		vfsOut.Seek(0);
+		if(vfsOut.Write(&header,1,sizeof(IndexedHeader))!=sizeof(IndexedHeader) ||
+			(!entries.empty() && vfsOut.Write(entries.data(),1,entries.size() * sizeof(IndexedEntry))!=entries.size() * sizeof(IndexedEntry)) ||
+			vfsOut.Write(names.data(),1,names.length())!=names.length() ||
+			vfsOut.Write(padding.data(),1,AlignUp(namesEnd, 8) - namesEnd)!=AlignUp(namesEnd, 8) - namesEnd ||
+			(!blocks.empty() && vfsOut.Write(blocks.data(),1,blocks.size() * sizeof(IndexedBlock))!=blocks.size() * sizeof(IndexedBlock)))
+		{
+			numErrors++;
+		}
+		vfsOut.Close();
+
+		ECHO_LOG_DEBUG("Added " << files.size() << " files. " << position << " bytes.");
+		if(numErrors)
+		{
+			ECHO_LOG_ERROR("VFS has "<< numErrors << " error" << ((numErrors>1) ? "s" : ""));
+		}
+		return true;
+	}
+
 	File FileSystemSourceVFS::_Open(const std::string& originalFileName, const std::string& modifiedFileName, File::OpenMode openMode)
 	{
 		if(!mVFSFile.IsOpen() || openMode!=File::OpenModes::READ)
@@ -346,6 +1057,50 @@ namespace Echo
 			return CreateFile(originalFileName,modifiedFileName);
 		}
 
+		if(mIndexedEntries)
+		{
+			const IndexedEntry* indexedEntry = FindIndexedEntry(modifiedFileName);
+			if(!indexedEntry)
+			{
+				return CreateFile(originalFileName,modifiedFileName);
+			}
+			VFSEntry entry;
+			entry.mMainOffset = indexedEntry->mDataOffset;
+			entry.mDataSize = indexedEntry->mDataSize;
+			entry.mCompression = static_cast<VFSCompression>(indexedEntry->mCompression);
+			entry.mFirstBlock = indexedEntry->mFirstBlock;
+			entry.mNumberOfBlocks = indexedEntry->mNumberOfBlocks;
+
+			// The tables are used as they are in the file so the entry is checked before use.
+			const u64 archiveSize = mVFSFile.GetSize();
+			bool valid = true;
+			if(entry.mCompression==VFSCompressions::NONE)
+			{
+				valid = (indexedEntry->mDataOffset <= archiveSize && indexedEntry->mDataSize <= archiveSize - indexedEntry->mDataOffset);
+			}else
+			{
+				if(!GetCompressionSupported(entry.mCompression))
+				{
+					ECHO_LOG_ERROR("VFS entry " << modifiedFileName << " uses compression " << entry.mCompression << " which is not supported in this build");
+					return CreateFile(originalFileName,modifiedFileName);
+				}
+				const u64 blockSize = mIndexedHeader.mBlockSize;
+				valid = (static_cast<u64>(entry.mFirstBlock) + entry.mNumberOfBlocks <= mIndexedHeader.mNumberOfBlocks &&
+						entry.mNumberOfBlocks == (indexedEntry->mDataSize + blockSize - 1) / blockSize);
+				for(u32 b = 0; valid && b < entry.mNumberOfBlocks; ++b)
+				{
+					const IndexedBlock& block = mIndexedBlocks[entry.mFirstBlock + b];
+					valid = (block.mOffset <= archiveSize && block.mStoredSize <= archiveSize - block.mOffset);
+				}
+			}
+			if(!valid)
+			{
+				ECHO_LOG_ERROR("VFS entry " << modifiedFileName << " is outside of the archive");
+				return CreateFile(originalFileName,modifiedFileName);
+			}
+			return CreateFile(originalFileName,modifiedFileName,shared_ptr<FileReferenceVFS>(new FileReferenceVFS(this,entry)));
+		}
+
 		std::map< std::string, VFSEntry >::iterator it=mDirectory.find(modifiedFileName);
 		if(it==mDirectory.end())
 		{
@@ -7,6 +7,15 @@ namespace Echo
 {
 	namespace GUI
 	{
+		/**
+		 * The compiled condition and calls for a conditional so evaluating them doesn't involve any parsing.
+		 */
+		struct Element::ConditionalFunctions
+		{
+			shared_ptr<Parser::CompiledConditional> mCondition;
+			std::list<FunctionBinder::CompiledCall> mFunctions;
+		};
+
 		Element::Element() :
 			mTargetable(true),
 			mSetWidth(),
@@ -1190,13 +1199,18 @@ namespace Echo
 			}
 			BOOST_FOREACH(const ConditionalFunctionMap::value_type& conditionPair, mConditionalFunctions)
 			{
-				optional<bool> result = mConditionalEvaluator->Parse(conditionPair.first);
+				ConditionalFunctions& conditional = *conditionPair.second;
+				optional<bool> result;
+				if(conditional.mCondition)
+				{
+					result = conditional.mCondition->Evaluate();
+				}
 				if(result)
 				{
 					//What did the expression evaluate to?
 					if(*result)
 					{
-						BOOST_FOREACH(const std::string& function, conditionPair.second)
+						BOOST_FOREACH(FunctionBinder::CompiledCall& function, conditional.mFunctions)
 						{
 							mFunctionBinder->Call(function);
 						}
@@ -1253,7 +1267,7 @@ namespace Echo
 			ConditionalFunctionMap::iterator it = mConditionalFunctions.find(condition);
 			if(it==mConditionalFunctions.end())
 			{
-				std::pair<ConditionalFunctionMap::iterator, bool> insertResult = mConditionalFunctions.insert(std::make_pair(condition, std::list<std::string>()));
+				std::pair<ConditionalFunctionMap::iterator, bool> insertResult = mConditionalFunctions.insert(std::make_pair(condition, make_shared<ConditionalFunctions>()));
 				if(!insertResult.second)
 				{
 					ECHO_LOG_ERROR("Element::AddConditionalFunction() There was an error inserting the condition \"" << condition << "\" into the conditional functions lookup.");
@@ -1262,10 +1276,14 @@ namespace Echo
 				it = insertResult.first;
 			}
 			//Add the function
-			it->second.push_back(function);
+			it->second->mFunctions.push_back(FunctionBinder::CompiledCall(function));
 			
 			//Make sure the ConditionalEvaluator is setup.
 			SetupConditionalEvaluatorParser();
+			if(!it->second->mCondition)
+			{
+				it->second->mCondition = mConditionalEvaluator->Compile(condition);
+			}
 		}
 
 		void Element::AddConditionalFunctions(const std::string& condition, const std::list<std::string>& functions)
@@ -1273,7 +1291,7 @@ namespace Echo
 			ConditionalFunctionMap::iterator it = mConditionalFunctions.find(condition);
 			if(it==mConditionalFunctions.end())
 			{
-				std::pair<ConditionalFunctionMap::iterator, bool> insertResult = mConditionalFunctions.insert(std::make_pair(condition, std::list<std::string>()));
+				std::pair<ConditionalFunctionMap::iterator, bool> insertResult = mConditionalFunctions.insert(std::make_pair(condition, make_shared<ConditionalFunctions>()));
 				if(!insertResult.second)
 				{
 					ECHO_LOG_ERROR("Element::AddConditionalFunctions() There was an error inserting the condition \"" << condition << "\" into the conditional functions lookup.");
@@ -1282,10 +1300,14 @@ namespace Echo
 				it = insertResult.first;
 			}
 			//Add the function
-			it->second.insert(it->second.end(), functions.begin(), functions.end());
+			it->second->mFunctions.insert(it->second->mFunctions.end(), functions.begin(), functions.end());
 
 			//Make sure the ConditionalEvaluator is setup.
 			SetupConditionalEvaluatorParser();
+			if(!it->second->mCondition)
+			{
+				it->second->mCondition = mConditionalEvaluator->Compile(condition);
+			}
 		}
 		
 		void Element::SetParentElement(Element* parent)
@@ -649,6 +649,17 @@ namespace Echo
 		}
 	}
 
+	Size Camera::IsVisible(const PackedAxisAlignedBoxes& boxes, std::vector<u32>& visibilityOut, std::vector<u8>* culledBy) const
+	{
+		if(mCullFrustum)
+		{
+			return mCullFrustum->IsVisible(boxes, visibilityOut, culledBy);
+		} else
+		{
+			return Frustum::IsVisible(boxes, visibilityOut, culledBy);
+		}
+	}
+
 	const Frustum::WorldSpaceCorners& Camera::GetWorldSpaceCorners(void) const
 	{
 		if(mCullFrustum)
@@ -2,6 +2,7 @@
 #include <echo/Maths/EchoMaths.h>
 #include <echo/Maths/Matrix3.h>
 #include <echo/Maths/Sphere.h>
+#include <echo/Maths/SIMD.h>
 #include <echo/Graphics/Mesh.h>
 #include <echo/Graphics/SubMesh.h>
 
@@ -210,6 +211,152 @@ namespace Echo
 		return true;
 	}
 
+	Size Frustum::IsVisible(const PackedAxisAlignedBoxes& boxes, std::vector<u32>& visibilityOut, std::vector<u8>* culledBy) const
+	{
+		// Make any pending updates to the calculated frustum planes once for all of the boxes
+		UpdateFrustumPlanes();
+
+		u8 planes[6];
+		bool planeEnabled[6];
+		Size numberOfPlanes = 0;
+		for (u8 plane = 0; plane < 6; ++plane)
+		{
+			// Skip far plane if infinite view frustum
+			planeEnabled[plane] = !(plane == FrustumPlanes::FAR && mFarDist == 0);
+			if (planeEnabled[plane])
+				planes[numberOfPlanes++] = plane;
+		}
+
+		const Size count = boxes.GetSize();
+		visibilityOut.assign((count + 31) / 32, 0);
+		if (culledBy && culledBy->size() != count)
+			culledBy->resize(count, FrustumPlanes::NEAR);
+		u8* lastCulledBy = culledBy ? culledBy->data() : 0;
+		Size numberVisible = 0;
+
+#ifdef ECHO_MATHS_SIMD
+		// Four boxes are tested against a plane at a time. Box i is outside if n.c + d + |n|.h < 0, which is the
+		// same test as Plane::GetSide(). The arrays are padded so the last group can be read in full and the
+		// padding boxes are null so they are always outside.
+		SIMD::f32x4 nx[6], ny[6], nz[6], ax[6], ay[6], az[6], d[6];
+		for (Size plane = 0; plane < 6; ++plane)
+		{
+			const Plane& p = mFrustumPlanes[plane];
+			nx[plane] = SIMD::Splat(p.normal.x);
+			ny[plane] = SIMD::Splat(p.normal.y);
+			nz[plane] = SIMD::Splat(p.normal.z);
+			ax[plane] = SIMD::Splat(Maths::Abs(p.normal.x));
+			ay[plane] = SIMD::Splat(Maths::Abs(p.normal.y));
+			az[plane] = SIMD::Splat(Maths::Abs(p.normal.z));
+			d[plane] = SIMD::Splat(p.d);
+		}
+		const SIMD::f32x4 zero = SIMD::Splat(0.f);
+		const u32 BIT_COUNTS[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+		const f32* centreX = boxes.GetCentres(0);
+		const f32* centreY = boxes.GetCentres(1);
+		const f32* centreZ = boxes.GetCentres(2);
+		const f32* halfSizeX = boxes.GetHalfSizes(0);
+		const f32* halfSizeY = boxes.GetHalfSizes(1);
+		const f32* halfSizeZ = boxes.GetHalfSizes(2);
+		for (Size i = 0; i < count; i += 4)
+		{
+			SIMD::f32x4 cx = SIMD::Load(centreX + i);
+			SIMD::f32x4 cy = SIMD::Load(centreY + i);
+			SIMD::f32x4 cz = SIMD::Load(centreZ + i);
+			SIMD::f32x4 hx = SIMD::Load(halfSizeX + i);
+			SIMD::f32x4 hy = SIMD::Load(halfSizeY + i);
+			SIMD::f32x4 hz = SIMD::Load(halfSizeZ + i);
+			auto outsideMask = [&](u8 plane) -> u32
+			{
+				SIMD::f32x4 s = SIMD::MultiplyAdd(nx[plane], cx, d[plane]);
+				s = SIMD::MultiplyAdd(ny[plane], cy, s);
+				s = SIMD::MultiplyAdd(nz[plane], cz, s);
+				s = SIMD::MultiplyAdd(ax[plane], hx, s);
+				s = SIMD::MultiplyAdd(ay[plane], hy, s);
+				s = SIMD::MultiplyAdd(az[plane], hz, s);
+				return SIMD::LessMask(s, zero);
+			};
+			const Size lanes = std::min<Size>(4, count - i);
+			u32 outside = 0;
+			if (lastCulledBy)
+			{
+				// The group is tested against the plane that culled it last time first. If that culls the whole
+				// group the other planes aren't tested.
+				u8 plane = lastCulledBy[i];
+				if (plane < 6 && planeEnabled[plane])
+					outside = outsideMask(plane);
+			}
+			if (outside != 0xF)
+			{
+				// Testing every plane avoids branches that are hard to predict.
+				u32 planeMasks[6];
+				for (Size n = 0; n < numberOfPlanes; ++n)
+				{
+					planeMasks[n] = outsideMask(planes[n]);
+					outside |= planeMasks[n];
+				}
+				if (lastCulledBy)
+				{
+					// Only a plane that culls the whole group allows the others to be skipped so that is what is
+					// recorded, in the entry for the group's first box.
+					u8 plane = lastCulledBy[i];
+					for (Size n = numberOfPlanes; n-- > 0;)
+					{
+						plane = (planeMasks[n] == 0xF) ? planes[n] : plane;
+					}
+					lastCulledBy[i] = plane;
+				}
+			}
+			u32 visible = ~outside & ((1u << lanes) - 1);
+			visibilityOut[i / 32] |= visible << (i % 32);
+			numberVisible += BIT_COUNTS[visible];
+		}
+#else
+		// This is the same test as Plane::GetSide() except the absolute normal is used rather than the absolute
+		// products, which keeps the negative half size of null boxes negative.
+		Vector3 absNormals[6];
+		for (Size plane = 0; plane < 6; ++plane)
+		{
+			const Vector3& normal = mFrustumPlanes[plane].normal;
+			absNormals[plane] = Vector3(Maths::Abs(normal.x), Maths::Abs(normal.y), Maths::Abs(normal.z));
+		}
+		for (Size i = 0; i < count; ++i)
+		{
+			Vector3 centre = boxes.GetCentre(i);
+			Vector3 halfSize = boxes.GetHalfSize(i);
+			auto isOutside = [&](u8 plane)
+			{
+				return mFrustumPlanes[plane].GetDistance(centre) < -absNormals[plane].Dot(halfSize);
+			};
+			u8 firstPlane = planes[0];
+			if (lastCulledBy && lastCulledBy[i] < 6 && planeEnabled[lastCulledBy[i]])
+				firstPlane = lastCulledBy[i];
+
+			// Test the plane that culled the box last time first.
+			bool outside = isOutside(firstPlane);
+			u8 culledByPlane = firstPlane;
+			for (Size n = 0; n < numberOfPlanes && !outside; ++n)
+			{
+				if (planes[n] != firstPlane && isOutside(planes[n]))
+				{
+					outside = true;
+					culledByPlane = planes[n];
+				}
+			}
+			if (outside)
+			{
+				if (lastCulledBy)
+					lastCulledBy[i] = culledByPlane;
+			}else
+			{
+				visibilityOut[i / 32] |= 1u << (i % 32);
+				++numberVisible;
+			}
+		}
+#endif
+		return numberVisible;
+	}
+
 	bool Frustum::IsVisible(const Sphere& sphere, FrustumPlane* culledBy) const
 	{
 		// Make any pending updates to the calculated frustum planes
@@ -1,6 +1,8 @@
 #include <echo/Graphics/Material.h>
 #include <echo/Graphics/RenderPass.h>
 #include <echo/Graphics/MultipassRenderable.h>
+#include <echo/Graphics/RenderBucket.h>
+#include <echo/Graphics/RenderContext.h>
 #include <echo/Graphics/Texture.h>
 
 namespace Echo
@@ -71,6 +73,18 @@ namespace Echo
 	{
 		//Loop through the passes and apply each material followed by executing the render
 		size_t numPasses = mPasses.size();
+		if(renderContext.mRenderBucket)
+		{
+			for(size_t p = 0; p < numPasses; ++p)
+			{
+				RenderPass& pass = mPasses[p];
+				if(pass.GetActive())
+				{
+					renderContext.mRenderBucket->Submit(pass, renderable, world, worldView, compoundDiffuse, renderContext.mLights);
+				}
+			}
+			return;
+		}
 		for(size_t p = 0; p < numPasses; ++p)
 		{
 			RenderPass& pass = mPasses[p];
@@ -1,4 +1,5 @@
 #include <echo/Graphics/Node.h>
+#include <echo/Graphics/TransformHierarchy.h>
 #include <echo/Kernel/ScopedLock.h>
 #include <boost/foreach.hpp>
 
@@ -17,11 +18,18 @@ namespace Echo
 		{
 			mParent->RemoveChild(*this);
 		}
+		
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->RemoveRoot(*this);
+		}
 	}
 	
 	Node::Node(const Node& other)
 	{
 		mParent = 0;
+		mTransformHierarchy = nullptr;
+		mTransformHierarchyIndex = 0;
 		*this = other;
 	}
 
@@ -35,6 +43,7 @@ namespace Echo
 		//mChildrenToUpdate // Leave.
 		//mSharedChildren	// Leave.
 		//mParent			// Leave.
+		//mTransformHierarchy // Leave.
 
 		mOrientation = rhs.mOrientation;
 		mDerivedOrientation = mOrientation;		//This will be properly calculated later.
@@ -56,6 +65,10 @@ namespace Echo
 		mTransformOutOfDate=true;
 		mLocalTransformOutOfDate = true;
 		mName = rhs.mName;
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->NodeChanged(*this);
+		}
 		return *this;
 	}
 	
@@ -80,6 +93,8 @@ namespace Echo
 		mNeedChildUpdate=true;
 		mTransformOutOfDate=true;
 		mLocalTransformOutOfDate = true;
+		mTransformHierarchy = nullptr;
+		mTransformHierarchyIndex = 0;
 	}
 
 	const std::string& Node::GetName() const
@@ -99,6 +114,11 @@ namespace Echo
 
 	const Quaternion& Node::GetDerivedOrientation() const
 	{
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->EnsureUpdated();
+			return mTransformHierarchy->mDerivedOrientations[mTransformHierarchyIndex];
+		}
 		UpdateDerivedProperties();
 		return mDerivedOrientation;
 	}
@@ -110,6 +130,11 @@ namespace Echo
 
 	const Vector3& Node::GetDerivedPosition() const
 	{
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->EnsureUpdated();
+			return mTransformHierarchy->mDerivedPositions[mTransformHierarchyIndex];
+		}
 		UpdateDerivedProperties();
 		return mDerivedPosition;
 	}
@@ -121,6 +146,11 @@ namespace Echo
 
 	const Vector3& Node::GetDerivedScale() const
 	{
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->EnsureUpdated();
+			return mTransformHierarchy->mDerivedScales[mTransformHierarchyIndex];
+		}
 		UpdateDerivedProperties();
 		return mDerivedScale;
 	}
@@ -160,6 +190,11 @@ namespace Echo
 
 	const Matrix4& Node::GetTransform() const
 	{
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->EnsureUpdated();
+			return mTransformHierarchy->mTransforms[mTransformHierarchyIndex];
+		}
 		ScopedLock lock(mTransformMutex);
 		if(mTransformOutOfDate)
 		{
@@ -260,11 +295,19 @@ namespace Echo
 	void Node::SetInheritOrientation( bool val )
 	{
 		mInheritOrientation = val;
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->NodeChanged(*this);
+		}
 	}
 
 	void Node::SetInheritScale( bool val )
 	{
 		mInheritScale = val;
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->NodeChanged(*this);
+		}
 	}
 
 	void Node::Scale( const Vector3& s )
@@ -348,6 +391,8 @@ namespace Echo
 			mParent->RemoveChild(*this);
 		}
 		mParent=node;
+		// The derived properties depend on the parent.
+		NeedUpdate();
 		OnParentSet(mParent);
 		if(mParent)
 		{
@@ -379,6 +424,10 @@ namespace Echo
 			{
 				mSharedChildren.insert(shared_ptr<Node>(node));
 			}
+			if(mTransformHierarchy)
+			{
+				mTransformHierarchy->AttachSubtree(*node);
+			}
 			ChildAdded(*node);
 		}
 	}
@@ -394,6 +443,10 @@ namespace Echo
 			node->SetParent(this);
 			mChildNodes.insert(node.get());
 			mSharedChildren.insert(node);
+			if(mTransformHierarchy)
+			{
+				mTransformHierarchy->AttachSubtree(*node);
+			}
 			ChildAdded(*node);
 		}
 	}	
@@ -504,6 +557,10 @@ namespace Echo
 		}
 		mChildNodes.erase(it);
 		node.SetParent(0);
+		if(mTransformHierarchy && node.mTransformHierarchy==mTransformHierarchy)
+		{
+			mTransformHierarchy->DetachSubtree(node);
+		}
 		ChildRemoved(node);
 
 		
@@ -530,6 +587,11 @@ namespace Echo
 
 	void Node::UpdateDerivedProperties() const
 	{
+		if(mTransformHierarchy)
+		{
+			mTransformHierarchy->EnsureUpdated();
+			return;
+		}
 		ScopedLock lock1(mDerivedPropertiesMutex);
 		
 		//Do we need to update?
@@ -611,6 +673,14 @@ namespace Echo
 
 	void Node::NeedUpdate(bool forceParent) const
 	{
+		if(mTransformHierarchy)
+		{
+			// The hierarchy propagates changes to descendants when it updates.
+			mTransformOutOfDate=true;
+			mLocalTransformOutOfDate=true;
+			mTransformHierarchy->NodeChanged(*this);
+			return;
+		}
 		mNeedChildUpdate=true;
 		mDerivedPropertiesOutOfDate=true;
 		mTransformOutOfDate=true;
@@ -0,0 +1,394 @@
+#include <echo/Graphics/ParticleArrays.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <algorithm>
+
+namespace Echo
+{
+	namespace
+	{
+		typedef StandardParticleArrays::Streams S;
+
+		/**
+		 * The number of particles processed at a time when building quads.
+		 * The corners of a block are calculated into arrays on the stack so the calculation can be vectorised.
+		 */
+		const Size QUAD_BLOCK_SIZE = 256;
+
+		/**
+		 * Sine approximation that the compiler can vectorise, unlike std::sin.
+		 * The absolute error is less than 4e-6 which is more than enough for positioning particle corners.
+		 */
+		inline f32 FastSin(f32 x)
+		{
+			const f32 INVERSE_TWO_PI = 0.159154943f;
+			const f32 TWO_PI = 6.283185307f;
+			const f32 PI = 3.141592654f;
+			const f32 HALF_PI = 1.570796327f;
+
+			// Reduce to [-pi,pi] then fold into [-pi/2,pi/2] using sin(x) = sin(pi-x).
+			f32 turns = x * INVERSE_TWO_PI;
+			turns = static_cast<f32>(static_cast<s32>(turns + (turns >= 0.f ? 0.5f : -0.5f)));
+			x -= turns * TWO_PI;
+			x = (x > HALF_PI) ? (PI - x) : x;
+			x = (x < -HALF_PI) ? (-PI - x) : x;
+
+			const f32 x2 = x * x;
+			return x * (1.f + x2 * (-1.f / 6.f + x2 * (1.f / 120.f + x2 * (-1.f / 5040.f + x2 * (1.f / 362880.f)))));
+		}
+
+		inline f32 FastCos(f32 x)
+		{
+			return FastSin(x + 1.570796327f);
+		}
+
+		inline u8 ToColourComponent(f32 value)
+		{
+			value = std::min(std::max(value, 0.f), 1.f);
+			return static_cast<u8>(value * 255.f);
+		}
+	}
+
+	StandardParticleArrays::StandardParticleArrays() : mSize(0)
+	{
+	}
+
+	StandardParticleArrays::~StandardParticleArrays()
+	{
+	}
+
+	void StandardParticleArrays::reserve(Size numberOfParticles)
+	{
+		for(Size s = 0; s < S::NUMBER_OF_STREAMS; ++s)
+		{
+			mStreams[s].reserve(numberOfParticles);
+		}
+	}
+
+	void StandardParticleArrays::push_back(const StandardParticle& particle)
+	{
+		if(mSize==mStreams[0].size())
+		{
+			for(Size s = 0; s < S::NUMBER_OF_STREAMS; ++s)
+			{
+				mStreams[s].resize(mSize + 1);
+			}
+		}
+		const Size i = mSize++;
+		const Vector3* vectors[] = {	&particle.mPosition, &particle.mVelocity, &particle.mAcceleration, &particle.mLinearDamping,
+										&particle.mScale, &particle.mScaleVelocity, &particle.mScaleAcceleration, &particle.mScaleDamping,
+										&particle.mAngle, &particle.mAngularVelocity, &particle.mAngularAcceleration, &particle.mAngularDamping};
+		for(Size v = 0; v < 12; ++v)
+		{
+			mStreams[v * 3][i] = vectors[v]->x;
+			mStreams[v * 3 + 1][i] = vectors[v]->y;
+			mStreams[v * 3 + 2][i] = vectors[v]->z;
+		}
+		mStreams[S::INITIAL_COLOUR_R][i] = particle.mInitialColour.mRed;
+		mStreams[S::INITIAL_COLOUR_G][i] = particle.mInitialColour.mGreen;
+		mStreams[S::INITIAL_COLOUR_B][i] = particle.mInitialColour.mBlue;
+		mStreams[S::INITIAL_COLOUR_A][i] = particle.mInitialColour.mAlpha;
+		mStreams[S::FINAL_COLOUR_R][i] = particle.mFinalColour.mRed;
+		mStreams[S::FINAL_COLOUR_G][i] = particle.mFinalColour.mGreen;
+		mStreams[S::FINAL_COLOUR_B][i] = particle.mFinalColour.mBlue;
+		mStreams[S::FINAL_COLOUR_A][i] = particle.mFinalColour.mAlpha;
+		mStreams[S::TIME_LEFT][i] = particle.mTimeLeft.count();
+		mStreams[S::INVERSE_INITIAL_TIME][i] = 1.f / particle.mInitialTime.count();
+	}
+
+	StandardParticle StandardParticleArrays::Get(Size index) const
+	{
+		StandardParticle particle;
+		Vector3* vectors[] = {	&particle.mPosition, &particle.mVelocity, &particle.mAcceleration, &particle.mLinearDamping,
+								&particle.mScale, &particle.mScaleVelocity, &particle.mScaleAcceleration, &particle.mScaleDamping,
+								&particle.mAngle, &particle.mAngularVelocity, &particle.mAngularAcceleration, &particle.mAngularDamping};
+		for(Size v = 0; v < 12; ++v)
+		{
+			vectors[v]->x = mStreams[v * 3][index];
+			vectors[v]->y = mStreams[v * 3 + 1][index];
+			vectors[v]->z = mStreams[v * 3 + 2][index];
+		}
+		particle.mInitialColour = Colour(mStreams[S::INITIAL_COLOUR_R][index], mStreams[S::INITIAL_COLOUR_G][index], mStreams[S::INITIAL_COLOUR_B][index], mStreams[S::INITIAL_COLOUR_A][index]);
+		particle.mFinalColour = Colour(mStreams[S::FINAL_COLOUR_R][index], mStreams[S::FINAL_COLOUR_G][index], mStreams[S::FINAL_COLOUR_B][index], mStreams[S::FINAL_COLOUR_A][index]);
+		particle.mTimeLeft = Seconds(mStreams[S::TIME_LEFT][index]);
+		particle.mInitialTime = Seconds(1.f / mStreams[S::INVERSE_INITIAL_TIME][index]);
+		f32 percentTransition = particle.mTimeLeft.count() * mStreams[S::INVERSE_INITIAL_TIME][index];
+		particle.mColour = Maths::LinearInterpolate(particle.mInitialColour, particle.mFinalColour, 1.f - percentTransition);
+		return particle;
+	}
+
+	void StandardParticleArrays::Integrate(Size begin, Size end, Seconds lastFrameTime)
+	{
+		const f32 t = static_cast<f32>(lastFrameTime.count());
+		f32* timeLeft = GetStream(S::TIME_LEFT);
+		for(Size i = begin; i < end; ++i)
+		{
+			timeLeft[i] -= t;
+		}
+
+		// Each group is a value, its velocity, acceleration and damping for x, y and z. Position, scale and angle
+		// are integrated the same way.
+		const Stream groups[] = {S::POSITION_X, S::SCALE_X, S::ANGLE_X};
+		for(Stream group : groups)
+		{
+			for(Size axis = 0; axis < 3; ++axis)
+			{
+				f32* value = GetStream(static_cast<Stream>(group + axis));
+				f32* velocity = GetStream(static_cast<Stream>(group + 3 + axis));
+				const f32* acceleration = GetStream(static_cast<Stream>(group + 6 + axis));
+				const f32* damping = GetStream(static_cast<Stream>(group + 9 + axis));
+				for(Size i = begin; i < end; ++i)
+				{
+					f32 v = velocity[i];
+					value[i] += v * t;
+					v += acceleration[i] * t;
+					v -= v * damping[i] * t;
+					velocity[i] = v;
+				}
+			}
+		}
+	}
+
+	void StandardParticleArrays::RemoveExpired()
+	{
+		f32* timeLeft = GetStream(S::TIME_LEFT);
+		Size i = 0;
+		while(i < mSize)
+		{
+			if(timeLeft[i] > 0.f)
+			{
+				++i;
+				continue;
+			}
+			--mSize;
+			for(Size s = 0; s < S::NUMBER_OF_STREAMS; ++s)
+			{
+				mStreams[s][i] = mStreams[s][mSize];
+			}
+		}
+	}
+
+	StandardParticleArrayProcessor::StandardParticleArrayProcessor(shared_ptr<WorkerPool> workerPool, Size particlesPerJob) :
+		mWorkerPool(workerPool),
+		mParticlesPerJob(particlesPerJob)
+	{
+	}
+
+	void StandardParticleArrayProcessor::ProcessParticles(StandardParticleArrays& particles, Seconds lastFrameTime)
+	{
+		const Size numberOfParticles = particles.size();
+		if(mWorkerPool && numberOfParticles > mParticlesPerJob)
+		{
+			mWorkerPool->ParallelFor(0, numberOfParticles, mParticlesPerJob, [&particles, lastFrameTime](Size begin, Size end)
+			{
+				particles.Integrate(begin, end, lastFrameTime);
+			});
+		}else
+		{
+			particles.Integrate(0, numberOfParticles, lastFrameTime);
+		}
+		particles.RemoveExpired();
+	}
+
+	StandardParticleArrayQuadBuilder::StandardParticleArrayQuadBuilder(Vector2 particleSize, shared_ptr<WorkerPool> workerPool, Size particlesPerJob) :
+		mParticleHalfSize(particleSize.x * 0.5f, particleSize.y * 0.5f),
+		mWorkerPool(workerPool),
+		mParticlesPerJob(particlesPerJob),
+		mIndexedData(nullptr),
+		mNumberOfIndexedParticles(0)
+	{
+	}
+
+	void StandardParticleArrayQuadBuilder::BuildVisual(StandardParticleArrays& particles, SceneEntity& entity)
+	{
+		assert(entity.GetMesh() && "SceneEntity needs a mesh");
+		assert(entity.GetMesh()->GetSubMesh(0) && "SceneEntity's mesh needs at least one sub mesh");
+		shared_ptr<SubMesh> subMesh = entity.GetMesh()->GetSubMesh(0);
+		shared_ptr<VertexBuffer> vertexBuffer = subMesh->GetVertexBuffer();
+
+		const Size VERTICES_PER_PARTICLE = 4;
+		const Size TRIANGLES_PER_PARTICLE = 2;
+		const Size numberOfParticles = particles.size();
+		const Size numberOfVertices = numberOfParticles * VERTICES_PER_PARTICLE;
+		const Size numberOfTriangles = numberOfParticles * TRIANGLES_PER_PARTICLE;
+
+		// As with StandardParticleQuadMeshBuilder at least one vertex needs to be allocated. Grow geometrically to
+		// avoid reallocating every frame while the number of particles increases.
+		if(vertexBuffer->GetCapacity() < numberOfVertices + 1)
+		{
+			vertexBuffer->Allocate(std::max(numberOfVertices + 1, vertexBuffer->GetCapacity() * 2));
+		}
+
+		subMesh->Clear(false);
+		if(particles.empty())
+		{
+			return;
+		}
+
+		shared_ptr<ElementBuffer> elementBuffer = subMesh->GetElementBuffer();
+		if(!elementBuffer)
+		{
+			if(!subMesh->SetElementBuffer(ElementBuffer::Types::STATIC, ElementBuffer::IndexTypes::UNSIGNED_32BIT, ElementBuffer::ElementTypes::TRIANGLE, numberOfTriangles * 2))
+			{
+				ECHO_LOG_ERROR("Unable to setup Element Buffer for StandardParticleArrayQuadBuilder");
+				return;
+			}
+			elementBuffer = subMesh->GetElementBuffer();
+		}else
+		if(elementBuffer->GetCapacity() < numberOfTriangles)
+		{
+			if(!elementBuffer->Allocate(numberOfTriangles * 2))
+			{
+				ECHO_LOG_ERROR("Reallocation of Element Buffer data failed for StandardParticleArrayQuadBuilder");
+				return;
+			}
+		}
+
+		// The indices are the same every frame so only new quads need to be indexed.
+		if(elementBuffer->GetDataPointer()!=mIndexedData)
+		{
+			mIndexedData = elementBuffer->GetDataPointer();
+			mNumberOfIndexedParticles = 0;
+		}
+		elementBuffer->SetNumberOfElements(numberOfTriangles);
+		if(numberOfParticles > mNumberOfIndexedParticles)
+		{
+			ElementBuffer::Accessor<ElementBuffer::Triangle< u32 > > triangles = elementBuffer->GetAccessor<ElementBuffer::Triangle<u32> >();
+			for(Size p = mNumberOfIndexedParticles; p < numberOfParticles; ++p)
+			{
+				u32 vBase = static_cast<u32>(p * VERTICES_PER_PARTICLE);
+				auto& triangle1 = triangles[p * TRIANGLES_PER_PARTICLE];
+				triangle1.mA = vBase+2;		// 0-1
+				triangle1.mB = vBase+1;		// |/
+				triangle1.mC = vBase;		// 2 3
+				auto& triangle2 = triangles[p * TRIANGLES_PER_PARTICLE + 1];
+				triangle2.mA = vBase+3;		// 0 1
+				triangle2.mB = vBase+1;		//  /|
+				triangle2.mC = vBase+2;		// 2-3
+			}
+			mNumberOfIndexedParticles = numberOfParticles;
+		}
+
+		const VertexLayout& layout = *vertexBuffer->GetLayout();
+		if(!layout.GetPositionSlot().IsValid() || !layout.GetNormalSlot().IsValid() || !layout.GetColourSlot().IsValid() || !layout.GetTextureCoordinateSlot(0).IsValid())
+		{
+			ECHO_LOG_ERROR("StandardParticleArrayQuadBuilder requires Position, Normal, Colour and UV0 vertex attributes");
+			return;
+		}
+		VertexAccessors vertices;
+		vertices.mPositions = vertexBuffer->GetAccessor<Vector3>(layout.GetPositionSlot().mIndex);
+		vertices.mNormals = vertexBuffer->GetAccessor<Vector3>(layout.GetNormalSlot().mIndex);
+		vertices.mColours = vertexBuffer->GetAccessor<VertexColour>(layout.GetColourSlot().mIndex);
+		vertices.mTextureCoordinates = vertexBuffer->GetAccessor<TextureUV>(layout.GetTextureCoordinateSlot(0).mIndex);
+		vertexBuffer->SetNumberOfElements(numberOfVertices);
+
+		if(mWorkerPool && numberOfParticles > mParticlesPerJob)
+		{
+			mWorkerPool->ParallelFor(0, numberOfParticles, mParticlesPerJob, [this, &particles, &vertices](Size begin, Size end)
+			{
+				BuildQuads(particles, begin, end, vertices);
+			});
+		}else
+		{
+			BuildQuads(particles, 0, numberOfParticles, vertices);
+		}
+		vertexBuffer->IncrementVersion();
+		subMesh->Finalise();
+	}
+
+	void StandardParticleArrayQuadBuilder::BuildQuads(const StandardParticleArrays& particles, Size begin, Size end, VertexAccessors& vertices) const
+	{
+		const f32* positionX = particles.GetStream(S::POSITION_X);
+		const f32* positionY = particles.GetStream(S::POSITION_Y);
+		const f32* positionZ = particles.GetStream(S::POSITION_Z);
+		const f32* scaleX = particles.GetStream(S::SCALE_X);
+		const f32* scaleY = particles.GetStream(S::SCALE_Y);
+		const f32* angleX = particles.GetStream(S::ANGLE_X);
+		const f32* angleY = particles.GetStream(S::ANGLE_Y);
+		const f32* angleZ = particles.GetStream(S::ANGLE_Z);
+		const f32* timeLeft = particles.GetStream(S::TIME_LEFT);
+		const f32* inverseInitialTime = particles.GetStream(S::INVERSE_INITIAL_TIME);
+		const f32* initialColour[4] = {	particles.GetStream(S::INITIAL_COLOUR_R), particles.GetStream(S::INITIAL_COLOUR_G),
+										particles.GetStream(S::INITIAL_COLOUR_B), particles.GetStream(S::INITIAL_COLOUR_A)};
+		const f32* finalColour[4] = {	particles.GetStream(S::FINAL_COLOUR_R), particles.GetStream(S::FINAL_COLOUR_G),
+										particles.GetStream(S::FINAL_COLOUR_B), particles.GetStream(S::FINAL_COLOUR_A)};
+
+		// The half extents of a quad along its rotated x and y axes.
+		f32 rightX[QUAD_BLOCK_SIZE], rightY[QUAD_BLOCK_SIZE], rightZ[QUAD_BLOCK_SIZE];
+		f32 upX[QUAD_BLOCK_SIZE], upY[QUAD_BLOCK_SIZE], upZ[QUAD_BLOCK_SIZE];
+		f32 colour[4][QUAD_BLOCK_SIZE];
+
+		for(Size blockBegin = begin; blockBegin < end; blockBegin += QUAD_BLOCK_SIZE)
+		{
+			const Size blockSize = std::min(QUAD_BLOCK_SIZE, end - blockBegin);
+			const Size b = blockBegin;
+
+			// Euler angles to the quaternion's x and y axes, this is the same as Quaternion::SetEuler() with the
+			// angle in x, y, z as yaw, pitch and roll followed by rotating the unit x and y vectors.
+			for(Size i = 0; i < blockSize; ++i)
+			{
+				const f32 halfYaw = angleX[b + i] * 0.5f;
+				const f32 halfPitch = angleY[b + i] * 0.5f;
+				const f32 halfRoll = angleZ[b + i] * 0.5f;
+				const f32 cosYaw = FastCos(halfYaw);
+				const f32 sinYaw = FastSin(halfYaw);
+				const f32 cosPitch = FastCos(halfPitch);
+				const f32 sinPitch = FastSin(halfPitch);
+				const f32 cosRoll = FastCos(halfRoll);
+				const f32 sinRoll = FastSin(halfRoll);
+				const f32 x = cosRoll * sinPitch * cosYaw + sinRoll * cosPitch * sinYaw;
+				const f32 y = cosRoll * cosPitch * sinYaw - sinRoll * sinPitch * cosYaw;
+				const f32 z = sinRoll * cosPitch * cosYaw - cosRoll * sinPitch * sinYaw;
+				const f32 w = cosRoll * cosPitch * cosYaw + sinRoll * sinPitch * sinYaw;
+
+				const f32 halfWidth = mParticleHalfSize.x * scaleX[b + i];
+				const f32 halfHeight = mParticleHalfSize.y * scaleY[b + i];
+				rightX[i] = (1.f - 2.f * (y * y + z * z)) * halfWidth;
+				rightY[i] = 2.f * (x * y + w * z) * halfWidth;
+				rightZ[i] = 2.f * (x * z - w * y) * halfWidth;
+				upX[i] = 2.f * (x * y - w * z) * halfHeight;
+				upY[i] = (1.f - 2.f * (x * x + z * z)) * halfHeight;
+				upZ[i] = 2.f * (y * z + w * x) * halfHeight;
+			}
+
+			for(Size c = 0; c < 4; ++c)
+			{
+				const f32* initial = initialColour[c];
+				const f32* target = finalColour[c];
+				f32* out = colour[c];
+				for(Size i = 0; i < blockSize; ++i)
+				{
+					const f32 transition = 1.f - timeLeft[b + i] * inverseInitialTime[b + i];
+					out[i] = initial[b + i] + (target[b + i] - initial[b + i]) * transition;
+				}
+			}
+
+			// Write the interleaved vertices.
+			for(Size i = 0; i < blockSize; ++i)
+			{
+				const Size vBase = (b + i) * 4;
+				const Vector3 position(positionX[b + i], positionY[b + i], positionZ[b + i]);
+				const Vector3 right(rightX[i], rightY[i], rightZ[i]);
+				const Vector3 up(upX[i], upY[i], upZ[i]);
+				vertices.mNormals[vBase  ] = vertices.mPositions[vBase  ] = position - right + up;
+				vertices.mNormals[vBase+1] = vertices.mPositions[vBase+1] = position + right + up;
+				vertices.mNormals[vBase+2] = vertices.mPositions[vBase+2] = position - right - up;
+				vertices.mNormals[vBase+3] = vertices.mPositions[vBase+3] = position + right - up;
+
+				vertices.mTextureCoordinates[vBase  ] = TextureUV(0.f, 0.f);
+				vertices.mTextureCoordinates[vBase+1] = TextureUV(1.f, 0.f);
+				vertices.mTextureCoordinates[vBase+2] = TextureUV(0.f, 1.f);
+				vertices.mTextureCoordinates[vBase+3] = TextureUV(1.f, 1.f);
+
+				VertexColour vertexColour;
+				vertexColour._RGBA.r = ToColourComponent(colour[0][i]);
+				vertexColour._RGBA.g = ToColourComponent(colour[1][i]);
+				vertexColour._RGBA.b = ToColourComponent(colour[2][i]);
+				vertexColour._RGBA.a = ToColourComponent(colour[3][i]);
+				vertices.mColours[vBase  ] = vertexColour;
+				vertices.mColours[vBase+1] = vertexColour;
+				vertices.mColours[vBase+2] = vertexColour;
+				vertices.mColours[vBase+3] = vertexColour;
+			}
+		}
+	}
+}
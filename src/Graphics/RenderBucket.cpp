@@ -0,0 +1,193 @@
+#include <echo/Graphics/RenderBucket.h>
+#include <echo/Graphics/RenderContext.h>
+#include <echo/Graphics/RenderPass.h>
+#include <echo/Graphics/RenderTarget.h>
+#include <echo/Graphics/MultipassRenderable.h>
+#include <cstring>
+
+namespace Echo
+{
+	namespace
+	{
+		/**
+		 * Get the bits of a non-negative float, which sort in the same order as the value.
+		 */
+		inline u32 GetDepthBits(f32 depth)
+		{
+			if(!(depth > 0.f))
+			{
+				// Behind the camera or NaN.
+				return 0;
+			}
+			u32 bits;
+			std::memcpy(&bits, &depth, sizeof(bits));
+			return bits;
+		}
+
+		inline u64 Field(u32 value, u32 bits, u32 shift)
+		{
+			// IDs that don't fit wrap around which only costs some grouping.
+			return (static_cast<u64>(value) & ((u64(1) << bits) - 1)) << shift;
+		}
+	}
+
+	RenderBucket::RenderBucket() : mNumberOfLightLists(0)
+	{
+	}
+
+	RenderBucket::~RenderBucket()
+	{
+	}
+
+	void RenderBucket::Clear()
+	{
+		mCommands.resize(0);
+		mSortItems.resize(0);
+		mNumberOfLightLists = 0;
+		mProgramIDs.clear();
+		mPassIDs.clear();
+		mTextureIDs.clear();
+		mGeometryIDs.clear();
+	}
+
+	u32 RenderBucket::GetID(std::unordered_map< const void*, u32 >& ids, const void* object)
+	{
+		auto it = ids.find(object);
+		if(it!=ids.end())
+		{
+			return it->second;
+		}
+		u32 id = static_cast<u32>(ids.size());
+		ids.insert(std::make_pair(object, id));
+		return id;
+	}
+
+	u64 RenderBucket::MakeKey(const RenderPass& pass, const MultipassRenderable& renderable, f32 depth)
+	{
+		const void* texture = nullptr;
+		if(pass.GetNumTextureUnits() > 0)
+		{
+			texture = pass.GetTextureUnit(0)->GetTexture().get();
+		}
+		u32 programID = GetID(mProgramIDs, pass.mProgram.get());
+		u32 passID = GetID(mPassIDs, &pass);
+		u32 textureID = GetID(mTextureIDs, texture);
+		u32 depthBits = GetDepthBits(depth);
+
+		if(pass.GetBlendMode()!=BlendModes::NONE)
+		{
+			// | 1 | ~depth:32 | program:10 | pass:11 | texture:10 |
+			return (u64(1) << 63) |
+				Field(~depthBits, 32, 31) |
+				Field(programID, 10, 21) |
+				Field(passID, 11, 10) |
+				Field(textureID, 10, 0);
+		}
+
+		// | 0 | program:10 | pass:13 | texture:13 | geometry:13 | depth:14 |
+		// The sign bit of the depth is always 0 so the next 14 bits are the exponent and top of the mantissa.
+		u32 geometryID = GetID(mGeometryIDs, renderable.GetGeometryIdentifier());
+		return Field(programID, 10, 53) |
+			Field(passID, 13, 40) |
+			Field(textureID, 13, 27) |
+			Field(geometryID, 13, 14) |
+			Field(depthBits >> 17, 14, 0);
+	}
+
+	void RenderBucket::Submit(RenderPass& pass, MultipassRenderable& renderable, const Matrix4& world, const Matrix4& worldView, Colour compoundDiffuse, const std::vector< Light* >& lights)
+	{
+		// Consecutive renderables usually have the same lights, particularly when lights are clustered.
+		if(mNumberOfLightLists==0 || mLightLists[mNumberOfLightLists-1]!=lights)
+		{
+			if(mNumberOfLightLists==mLightLists.size())
+			{
+				mLightLists.push_back(lights);
+			}else
+			{
+				mLightLists[mNumberOfLightLists] = lights;
+			}
+			++mNumberOfLightLists;
+		}
+
+		// The view looks down -z.
+		f32 depth = -worldView.GetTranslation().z;
+
+		SortItem item;
+		item.mKey = MakeKey(pass, renderable, depth);
+		item.mIndex = static_cast<u32>(mCommands.size());
+		mSortItems.push_back(item);
+
+		Command command;
+		command.mPass = &pass;
+		command.mRenderable = &renderable;
+		command.mWorld = world;
+		command.mWorldView = worldView;
+		command.mCompoundDiffuse = compoundDiffuse;
+		command.mLightList = mNumberOfLightLists - 1;
+		mCommands.push_back(command);
+	}
+
+	void RenderBucket::Sort()
+	{
+		const Size count = mSortItems.size();
+		if(count < 2)
+		{
+			return;
+		}
+		mSortScratch.resize(count);
+
+		// LSD radix sort on bytes. All histograms are built in one pass and bytes that are the same for
+		// every key are skipped, which is common for the high bytes of the IDs.
+		Size histograms[8][256];
+		std::memset(histograms, 0, sizeof(histograms));
+		for(const SortItem& item : mSortItems)
+		{
+			for(u32 digit = 0; digit < 8; ++digit)
+			{
+				++histograms[digit][(item.mKey >> (digit * 8)) & 0xFF];
+			}
+		}
+
+		for(u32 digit = 0; digit < 8; ++digit)
+		{
+			const u32 shift = digit * 8;
+			Size* histogram = histograms[digit];
+			if(histogram[(mSortItems[0].mKey >> shift) & 0xFF]==count)
+			{
+				continue;
+			}
+			Size offset = 0;
+			for(Size i = 0; i < 256; ++i)
+			{
+				Size bucketSize = histogram[i];
+				histogram[i] = offset;
+				offset += bucketSize;
+			}
+			for(const SortItem& item : mSortItems)
+			{
+				mSortScratch[histogram[(item.mKey >> shift) & 0xFF]++] = item;
+			}
+			mSortItems.swap(mSortScratch);
+		}
+	}
+
+	void RenderBucket::Execute(RenderContext& renderContext)
+	{
+		RenderTarget& renderTarget = renderContext.mRenderTarget;
+		renderTarget.BeginBatch();
+		for(const SortItem& item : mSortItems)
+		{
+			Command& command = mCommands[item.mIndex];
+			RenderContext commandContext(renderTarget,
+				renderContext.mViewMatrix,
+				renderContext.mProjectionMatrix,
+				renderContext.mViewProjectionMatrix,
+				renderContext.mCamera,
+				mLightLists[command.mLightList]);
+			renderTarget.SetModelViewMatrix(command.mWorldView);
+			command.mPass->Apply(commandContext, command.mWorld, command.mWorldView, command.mCompoundDiffuse);
+			command.mRenderable->Render(commandContext, *command.mPass, command.mCompoundDiffuse);
+		}
+		renderTarget.EndBatch();
+	}
+}
@@ -23,6 +23,8 @@ namespace Echo
 		mShininess = 0.0f;
 		mPointAndLineSize = 1.f;
 		mProgramCacheVersion = std::numeric_limits<Size>::max();
+		mProgramBoneMatrixCacheVersion = std::numeric_limits<Size>::max();
+		mProgramBoneMatrixCacheProgram = nullptr;
 	}
 
 	RenderPass::RenderPass(const RenderPass& pass)
@@ -52,6 +54,9 @@ namespace Echo
 		mProgramLightColourCache = pass.mProgramLightColourCache;
 		mProgramLightPowerCache = pass.mProgramLightPowerCache;
 		mNumberOfLightsCached = pass.mNumberOfLightsCached;
+		mProgramBoneMatrixCache = pass.mProgramBoneMatrixCache;
+		mProgramBoneMatrixCacheVersion = pass.mProgramBoneMatrixCacheVersion;
+		mProgramBoneMatrixCacheProgram = pass.mProgramBoneMatrixCacheProgram;
 	}
 
 	RenderPass& RenderPass::operator=(const RenderPass& pass)
@@ -84,6 +89,9 @@ namespace Echo
 		mProgramLightColourCache = pass.mProgramLightColourCache;
 		mProgramLightPowerCache = pass.mProgramLightPowerCache;
 		mNumberOfLightsCached = pass.mNumberOfLightsCached;
+		mProgramBoneMatrixCache = pass.mProgramBoneMatrixCache;
+		mProgramBoneMatrixCacheVersion = pass.mProgramBoneMatrixCacheVersion;
+		mProgramBoneMatrixCacheProgram = pass.mProgramBoneMatrixCacheProgram;
 
 		return *this;
 	}
@@ -276,6 +284,29 @@ namespace Echo
 		return numLights;
 	}
 
+	Size RenderPass::CacheProgramBoneMatrices(Size numberOfBones) const
+	{
+		Size programVersion = mProgram->GetVersion();
+		// An empty cache means the program has no bone matrices. The uniforms aren't available until the program
+		// is built, which increments the version, so the lookup is only repeated when the version changes.
+		if(mProgramBoneMatrixCacheProgram!=mProgram.get() || mProgramBoneMatrixCacheVersion!=programVersion)
+		{
+			mProgramBoneMatrixCache.resize(0);
+			mProgramBoneMatrixCacheProgram = mProgram.get();
+			mProgramBoneMatrixCacheVersion = programVersion;
+			for(Size i = 0; ; ++i)
+			{
+				shared_ptr<Matrix4> boneMatrix = mProgram->GetUniformVariable<Matrix4>("boneMatrices[" + std::to_string(i) + "]");
+				if(!boneMatrix)
+				{
+					break;
+				}
+				mProgramBoneMatrixCache.push_back(boneMatrix);
+			}
+		}
+		return std::min(numberOfBones, mProgramBoneMatrixCache.size());
+	}
+
 	size_t RenderPass::GetNumTextureUnits() const
 	{
 		return mTextureUnits.size();
@@ -102,6 +102,7 @@ namespace Echo
 		}
 		
 		mCamera->UpdateAspectForViewport(*mViewport,*mRenderTarget);
+		const RenderTarget::Statistics statisticsBefore = mRenderTarget->GetStatistics();
 		
 		if(mClear)
 		{
@@ -111,6 +112,7 @@ namespace Echo
 			mRenderTarget->Clear();
 		}
 		mCamera->RenderScene(*mRenderTarget);
+		mFrameStatistics = mRenderTarget->GetStatistics() - statisticsBefore;
 		if(mSwapBuffers)
 		{
 			mRenderTarget->SwapBuffers();
@@ -4,26 +4,128 @@
 #include <echo/Graphics/Light.h>
 #include <echo/Graphics/RenderTarget.h>
 #include <echo/Graphics/SceneRenderable.h>
+#include <echo/Kernel/ScopedLock.h>
+#include <echo/Maths/Plane.h>
+#include <echo/Resource/TextureResidencyManager.h>
 #include <echo/cpp/functional>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <unordered_set>
 
 #include <sstream>
 
 namespace Echo
 {
-	Scene::Scene() : TaskGroup("Scene"), mCurrentCamera(0), mCurrentRenderTarget(0)
+	namespace
+	{
+		/**
+		 * Containment test for spatial index queries against a camera's culling frustum.
+		 */
+		class FrustumContainmentTest
+		{
+		public:
+			FrustumContainmentTest(const Camera& camera) : mNumberOfPlanes(0)
+			{
+				for(unsigned short plane = 0; plane < 6; ++plane)
+				{
+					// Skip far plane if infinite view frustum
+					if(plane == FrustumPlanes::FAR && camera.GetFarPlane() == 0)
+						continue;
+					mPlanes[mNumberOfPlanes++] = camera.GetFrustumPlane(plane);
+				}
+			}
+
+			Containment operator()(const Vector3& minimum, const Vector3& maximum) const
+			{
+				Vector3 centre = (minimum + maximum) * 0.5f;
+				Vector3 halfSize = (maximum - minimum) * 0.5f;
+				Containment containment = Containments::INSIDE;
+				for(Size plane = 0; plane < mNumberOfPlanes; ++plane)
+				{
+					Plane::Side side = mPlanes[plane].GetSide(centre, halfSize);
+					if(side == Plane::Sides::NEGATIVE)
+					{
+						return Containments::OUTSIDE;
+					}
+					if(side == Plane::Sides::BOTH)
+					{
+						containment = Containments::PARTIAL;
+					}
+				}
+				return containment;
+			}
+		private:
+			Plane mPlanes[6];
+			Size mNumberOfPlanes;
+		};
+
+		/**
+		 * Insertion sort, which is linear for input that is already mostly sorted.
+		 */
+		template< typename Iterator, typename Compare >
+		void InsertionSort(Iterator begin, Iterator end, Compare compare)
+		{
+			if(begin==end)
+			{
+				return;
+			}
+			for(Iterator it = begin + 1; it != end; ++it)
+			{
+				typename std::iterator_traits<Iterator>::value_type value = *it;
+				Iterator hole = it;
+				while(hole != begin && compare(value, *(hole - 1)))
+				{
+					*hole = *(hole - 1);
+					--hole;
+				}
+				*hole = value;
+			}
+		}
+
+		// The cluster map is cleared when it grows beyond this to avoid unbounded growth as renderables move.
+		const Size MAXIMUM_LIGHT_CLUSTERS = 4096;
+	}
+
+	Scene::SpatialIndexEntry::SpatialIndexEntry(Scene& scene, shared_ptr<SceneRenderable> renderable, bool pickable) :
+		mScene(scene),
+		mRenderable(renderable),
+		mProxy(SpatialIndex::INVALID_PROXY),
+		mPickable(pickable),
+		mDirty(false)
+	{
+		mRenderable->AddListener(this);
+	}
+
+	Scene::SpatialIndexEntry::~SpatialIndexEntry()
+	{
+		mRenderable->RemoveListener(this);
+	}
+
+	void Scene::SpatialIndexEntry::OnSceneBoundsChanged(const SceneRenderable&)
+	{
+		mScene.QueueSpatialIndexUpdate(*this);
+	}
+
+	Scene::Scene() : TaskGroup("Scene"), mCurrentCamera(0), mCurrentRenderTarget(0), mVisitedCameraDependent(false),
+		mSpatialIndexEnabled(false), mRenderQueueCachingEnabled(false), mSceneVersion(0), mLightClusterSize(0.f),
+		mRenderBucketEnabled(false)
 	{
 		SetUseOnlyZForDistanceCalculations(false);
 	}
 
-	Scene::Scene(const std::string& name) : TaskGroup(name)
+	Scene::Scene(const std::string& name) : TaskGroup(name), mVisitedCameraDependent(false),
+		mSpatialIndexEnabled(false), mRenderQueueCachingEnabled(false), mSceneVersion(0), mLightClusterSize(0.f),
+		mRenderBucketEnabled(false)
 	{
 	}
 
 	Scene::~Scene()
 	{
+		// Renderables can outlive the Scene.
+		SetRenderQueueCachingEnabled(false);
 	}
 	
 	void Scene::SetSkyBox(shared_ptr< SceneRenderable > skyBox)
@@ -68,6 +170,7 @@ namespace Echo
 		{
 			return false;
 		}
+		mRenderQueueCache.erase(cit->second.get());
 		mCameras.erase(cit);
 		return true;
 	}
@@ -138,52 +241,231 @@ namespace Echo
 		{
 			mPickableRenderables.push_back(sceneRenderable);
 		}
+
+		if(mSpatialIndexEnabled)
+		{
+			AddToSpatialIndex(sceneRenderable, pickable);
+		}
+
+		if(mRenderQueueCachingEnabled)
+		{
+			sceneRenderable->AddListener(this);
+		}
+		mSceneVersion.fetch_add(1, std::memory_order_relaxed);
 	}
 	
 	void Scene::RemoveRenderable(shared_ptr<SceneRenderable> sceneRenderable)
 	{
 		mRenderables.remove(sceneRenderable);
 		mPickableRenderables.remove(sceneRenderable);
+		if(mSpatialIndexEnabled && sceneRenderable)
+		{
+			RemoveFromSpatialIndex(*sceneRenderable);
+		}
+		if(mRenderQueueCachingEnabled && sceneRenderable)
+		{
+			sceneRenderable->RemoveListener(this);
+		}
+		mSceneVersion.fetch_add(1, std::memory_order_relaxed);
 	}
-	
-	optional< PickResult > Scene::Pick(const Camera& camera, const Ray& ray)
+
+	void Scene::SetRenderQueueCachingEnabled(bool enabled)
 	{
-		typedef std::pair< AxisAlignedBox, shared_ptr< SceneRenderable > > BoxRenderablePair;
-		std::vector< BoxRenderablePair > visibleCameraBoxes;
-		visibleCameraBoxes.reserve(mPickableRenderables.size());
-		
-		// Transform each SceneRenderable scene AABB into camera space.
-		BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mPickableRenderables)
+		if(mRenderQueueCachingEnabled==enabled)
 		{
-			AxisAlignedBox sceneAABB=renderable->GetSceneAxisAlignedBox();
-			if (camera.IsVisible(sceneAABB))
+			return;
+		}
+		mRenderQueueCachingEnabled = enabled;
+		BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mRenderables)
+		{
+			if(enabled)
+			{
+				renderable->AddListener(this);
+			}else
 			{
-				visibleCameraBoxes.push_back(std::make_pair(sceneAABB, renderable));
+				renderable->RemoveListener(this);
 			}
 		}
+		mRenderQueueCache.clear();
+	}
+
+	void Scene::OnSceneBoundsChanged(const SceneRenderable&)
+	{
+		mSceneVersion.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void Scene::SetLightClusterSize(f32 size)
+	{
+		mLightClusterSize = std::max(size, 0.f);
+		mLightClusters.clear();
+	}
 
+	void Scene::SetSpatialIndexEnabled(bool enabled)
+	{
+		if(mSpatialIndexEnabled==enabled)
+		{
+			return;
+		}
+		mSpatialIndexEnabled = enabled;
+		if(enabled)
+		{
+			std::unordered_set< SceneRenderable* > pickableRenderables;
+			BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mPickableRenderables)
+			{
+				pickableRenderables.insert(renderable.get());
+			}
+			BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mRenderables)
+			{
+				AddToSpatialIndex(renderable, pickableRenderables.find(renderable.get())!=pickableRenderables.end());
+			}
+		}else
+		{
+			{
+				ScopedLock lock(mSpatialIndexUpdatesMutex);
+				mSpatialIndexUpdates.clear();
+			}
+			mSpatialIndexEntries.clear();
+			mUnindexedEntries.clear();
+			mSpatialIndex.Clear();
+		}
+	}
+
+	void Scene::AddToSpatialIndex(shared_ptr<SceneRenderable> sceneRenderable, bool pickable)
+	{
+		if(mSpatialIndexEntries.find(sceneRenderable.get())!=mSpatialIndexEntries.end())
+		{
+			// Already indexed.
+			return;
+		}
+		SpatialIndexEntry* entry = new SpatialIndexEntry(*this, sceneRenderable, pickable);
+		mSpatialIndexEntries[sceneRenderable.get()] = unique_ptr<SpatialIndexEntry>(entry);
+		// Entries start unindexed until their bounds are known.
+		mUnindexedEntries.push_back(entry);
+		UpdateSpatialIndexEntry(*entry);
+	}
+
+	void Scene::RemoveFromSpatialIndex(SceneRenderable& sceneRenderable)
+	{
+		auto it = mSpatialIndexEntries.find(&sceneRenderable);
+		if(it==mSpatialIndexEntries.end())
+		{
+			return;
+		}
+		SpatialIndexEntry* entry = it->second.get();
+		if(entry->mProxy!=SpatialIndex::INVALID_PROXY)
+		{
+			mSpatialIndex.Remove(entry->mProxy);
+		}else
+		{
+			mUnindexedEntries.erase(std::remove(mUnindexedEntries.begin(), mUnindexedEntries.end(), entry), mUnindexedEntries.end());
+		}
+		{
+			ScopedLock lock(mSpatialIndexUpdatesMutex);
+			mSpatialIndexUpdates.erase(std::remove(mSpatialIndexUpdates.begin(), mSpatialIndexUpdates.end(), entry), mSpatialIndexUpdates.end());
+		}
+		mSpatialIndexEntries.erase(it);
+	}
+
+	void Scene::QueueSpatialIndexUpdate(SpatialIndexEntry& entry)
+	{
+		// Renderables can be modified from multiple threads. Only the first change since the last update queues the entry.
+		if(!entry.mDirty.exchange(true))
+		{
+			ScopedLock lock(mSpatialIndexUpdatesMutex);
+			mSpatialIndexUpdates.push_back(&entry);
+		}
+	}
+
+	void Scene::UpdateSpatialIndex()
+	{
+		std::vector< SpatialIndexEntry* > updates;
+		{
+			ScopedLock lock(mSpatialIndexUpdatesMutex);
+			updates.swap(mSpatialIndexUpdates);
+		}
+		for(SpatialIndexEntry* entry : updates)
+		{
+			// Clear the flag first so changes made while calculating the bounds queue the entry again.
+			entry->mDirty.store(false);
+			UpdateSpatialIndexEntry(*entry);
+		}
+	}
+
+	void Scene::UpdateSpatialIndexEntry(SpatialIndexEntry& entry)
+	{
+		AxisAlignedBox bounds;
+		bool indexable = !entry.mRenderable->GetBoundsDependOnCamera();
+		if(indexable)
+		{
+			bounds = entry.mRenderable->GetSceneHierarchyAxisAlignedBox();
+			indexable = bounds.IsFinite();
+		}
+		if(!indexable)
+		{
+			if(entry.mProxy!=SpatialIndex::INVALID_PROXY)
+			{
+				mSpatialIndex.Remove(entry.mProxy);
+				entry.mProxy = SpatialIndex::INVALID_PROXY;
+				mUnindexedEntries.push_back(&entry);
+			}
+			return;
+		}
+		if(entry.mProxy==SpatialIndex::INVALID_PROXY)
+		{
+			entry.mProxy = mSpatialIndex.Insert(bounds, &entry);
+			mUnindexedEntries.erase(std::remove(mUnindexedEntries.begin(), mUnindexedEntries.end(), &entry), mUnindexedEntries.end());
+		}else
+		{
+			mSpatialIndex.Move(entry.mProxy, bounds);
+		}
+	}
+	
+	optional< PickResult > Scene::Pick(const Camera& camera, const Ray& ray)
+	{
 		// Check if the ray intersects the visible objects' AABB. If so then check the
-		// intersect distance and return the closest.
+		// intersect distance and keep the closest.
 		shared_ptr<SceneRenderable> closestRenderable;
 		f32 closestDistance = 0.f;
-		BOOST_FOREACH(const BoxRenderablePair& boxRenderablePair, visibleCameraBoxes)
+		auto pickTest = [&](const shared_ptr< SceneRenderable >& renderable)
+		{
+			AxisAlignedBox sceneAABB=renderable->GetSceneAxisAlignedBox();
+			if (!camera.IsVisible(sceneAABB))
+			{
+				return;
+			}
+			std::pair<bool, f32> intersection = ray.Intersects(sceneAABB);
+			if(intersection.first && (!closestRenderable || intersection.second < closestDistance))
+			{
+				closestDistance = intersection.second;
+				closestRenderable = renderable;
+			}
+		};
+
+		if(mSpatialIndexEnabled)
 		{
-			std::pair<bool, f32> intersection = ray.Intersects(boxRenderablePair.first);
-			if(intersection.first)
+			UpdateSpatialIndex();
+			mSpatialIndex.RayCast(ray, std::numeric_limits<f32>::max(), [&](SpatialIndexEntry* entry, f32 maxDistance)
 			{
-				if(!closestRenderable)
+				if(entry->mPickable)
 				{
-					closestDistance = intersection.second;
-					closestRenderable = boxRenderablePair.second;
-				}else
+					pickTest(entry->mRenderable);
+				}
+				// Nodes further than the closest hit cannot contain a closer hit.
+				return closestRenderable ? std::min(maxDistance, closestDistance) : maxDistance;
+			});
+			for(SpatialIndexEntry* entry : mUnindexedEntries)
+			{
+				if(entry->mPickable)
 				{
-					if(intersection.second < closestDistance)
-					{
-						closestDistance = intersection.second;
-						closestRenderable = boxRenderablePair.second;
-					}
+					pickTest(entry->mRenderable);
 				}
 			}
+		}else
+		{
+			BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mPickableRenderables)
+			{
+				pickTest(renderable);
+			}
 		}
 		if(!closestRenderable)
 		{
@@ -198,14 +480,60 @@ namespace Echo
 		return result;
 	}
 
+	void Scene::QueryRenderables(const AxisAlignedBox& region, std::vector< shared_ptr<SceneRenderable> >& renderablesOut)
+	{
+		auto regionTest = [&](const shared_ptr< SceneRenderable >& renderable)
+		{
+			if(renderable->GetSceneAxisAlignedBox().Intersects(region))
+			{
+				renderablesOut.push_back(renderable);
+			}
+		};
+		if(mSpatialIndexEnabled)
+		{
+			UpdateSpatialIndex();
+			mSpatialIndex.Query(region, [&](SpatialIndexEntry* entry)
+			{
+				regionTest(entry->mRenderable);
+			});
+			for(SpatialIndexEntry* entry : mUnindexedEntries)
+			{
+				regionTest(entry->mRenderable);
+			}
+		}else
+		{
+			BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mRenderables)
+			{
+				regionTest(renderable);
+			}
+		}
+	}
+
 	void Scene::BuildRenderQueue(const Camera& camera)
 	{
 		mRenderQueue.resize(0);
 		mCurrentCamera = &camera;
+		mVisitedCameraDependent = false;
 
-		BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mRenderables)
+		if(mSpatialIndexEnabled)
 		{
-			renderable->Accept(*this);
+			// Only renderables that could be in view are visited. The distance function still tests each renderable
+			// and child that is visited.
+			UpdateSpatialIndex();
+			mSpatialIndex.Query(FrustumContainmentTest(camera), [this](SpatialIndexEntry* entry)
+			{
+				entry->mRenderable->Accept(*this);
+			});
+			for(SpatialIndexEntry* entry : mUnindexedEntries)
+			{
+				entry->mRenderable->Accept(*this);
+			}
+		}else
+		{
+			BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mRenderables)
+			{
+				renderable->Accept(*this);
+			}
 		}
 
 		std::sort(mRenderQueue.begin(),mRenderQueue.end(),DistanceCompare);
@@ -215,6 +543,7 @@ namespace Echo
 	
 	void Scene::SceneRenderableVisit(SceneRenderable& renderable)
 	{
+		mVisitedCameraDependent = mVisitedCameraDependent || renderable.GetBoundsDependOnCamera();
 		mDistanceFunction(renderable,mCurrentCamera,mRenderQueue);
 	}
 
@@ -228,49 +557,210 @@ namespace Echo
 		return mCurrentRenderTarget;
 	}
 
+	std::vector< Scene::DistanceRenderablePair >& Scene::GetCachedRenderQueue(const Camera& camera)
+	{
+		// Cameras that share a culling frustum share visibility.
+		const Frustum* cullFrustum = camera.GetCullingFrustum();
+		if(!cullFrustum)
+		{
+			cullFrustum = &camera;
+		}
+		CachedRenderQueue& cache = mRenderQueueCache[cullFrustum];
+
+		const bool sceneUnchanged = cache.mValid && cache.mSceneVersion==mSceneVersion.load(std::memory_order_relaxed);
+		bool visibilityValid = sceneUnchanged;
+		for(unsigned short plane = 0; visibilityValid && plane < 6; ++plane)
+		{
+			visibilityValid = (cache.mCullPlanes[plane]==camera.GetFrustumPlane(plane));
+		}
+		if(visibilityValid && cache.mCameraDependent)
+		{
+			// Some renderables need to be visited again to update themselves for a new view.
+			visibilityValid = (cache.mCameraPosition==camera.GetDerivedPosition() && cache.mCameraOrientation==camera.GetDerivedOrientation());
+		}
+
+		if(!visibilityValid && sceneUnchanged && !cache.mCameraDependent && !mSpatialIndexEnabled)
+		{
+			// Only the culling frustum moved. The bounds are gathered the first time this happens and stay correct
+			// until the scene changes.
+			if(!cache.mBoundsValid)
+			{
+				GatherCullBounds(cache);
+			}
+			BuildRenderQueue(camera, cache);
+			cache.mRenderQueue.swap(mRenderQueue);
+			for(unsigned short plane = 0; plane < 6; ++plane)
+			{
+				cache.mCullPlanes[plane] = camera.GetFrustumPlane(plane);
+			}
+			cache.mCameraPosition = camera.GetDerivedPosition();
+			cache.mCameraOrientation = camera.GetDerivedOrientation();
+			cache.mSceneVersion = mSceneVersion.load(std::memory_order_relaxed);
+		}else
+		if(!visibilityValid)
+		{
+			BuildRenderQueue(camera);
+			cache.mBoundsValid = false;
+			// The old queue's memory is reused next time the queue is built.
+			cache.mRenderQueue.swap(mRenderQueue);
+			for(unsigned short plane = 0; plane < 6; ++plane)
+			{
+				cache.mCullPlanes[plane] = camera.GetFrustumPlane(plane);
+			}
+			cache.mCameraPosition = camera.GetDerivedPosition();
+			cache.mCameraOrientation = camera.GetDerivedOrientation();
+			// Renderables that depend on the camera are never culled before being visited so they are all seen here.
+			cache.mCameraDependent = mVisitedCameraDependent;
+			// Read after building since Accept() can modify renderables.
+			cache.mSceneVersion = mSceneVersion.load(std::memory_order_relaxed);
+			cache.mValid = true;
+		}else
+		if(cache.mCameraPosition!=camera.GetDerivedPosition())
+		{
+			// Only the camera position changed. Recalculate the distances and re-sort what is already visible.
+			mRenderQueue.resize(0);
+			mCurrentCamera = &camera;
+			BOOST_FOREACH(DistanceRenderablePair& renderable, cache.mRenderQueue)
+			{
+				mDistanceFunction(*renderable.second,mCurrentCamera,mRenderQueue);
+			}
+			mCurrentCamera = 0;
+			InsertionSort(mRenderQueue.begin(),mRenderQueue.end(),DistanceCompare);
+			cache.mRenderQueue.swap(mRenderQueue);
+			cache.mCameraPosition = camera.GetDerivedPosition();
+		}
+		return cache.mRenderQueue;
+	}
+
+	void Scene::GatherCullBounds(CachedRenderQueue& cache)
+	{
+		// Renderables that can't be culled by their bounds are given infinite boxes so they are always visited.
+		cache.mRenderables.resize(0);
+		cache.mBounds.Resize(mRenderables.size());
+		Size index = 0;
+		BOOST_FOREACH(shared_ptr< SceneRenderable >& renderable, mRenderables)
+		{
+			cache.mRenderables.push_back(renderable.get());
+			if(renderable->GetBoundsDependOnCamera())
+			{
+				cache.mBounds.Set(index++, AxisAlignedBox::BOX_INFINITE);
+			}else
+			{
+				AxisAlignedBox bounds = renderable->GetSceneHierarchyAxisAlignedBox();
+				cache.mBounds.Set(index++, bounds.IsNull() ? AxisAlignedBox::BOX_INFINITE : bounds);
+			}
+		}
+		cache.mBoundsValid = true;
+	}
+
+	void Scene::BuildRenderQueue(const Camera& camera, CachedRenderQueue& cache)
+	{
+		mRenderQueue.resize(0);
+		mCurrentCamera = &camera;
+		mVisitedCameraDependent = false;
+		camera.IsVisible(cache.mBounds, cache.mVisibility, &cache.mPlaneCache);
+		for(Size index = 0; index < cache.mRenderables.size(); ++index)
+		{
+			if(cache.mVisibility[index / 32] & (1u << (index % 32)))
+			{
+				cache.mRenderables[index]->Accept(*this);
+			}
+		}
+		// Renderables added during a visit weren't culled.
+		if(mRenderables.size() > cache.mRenderables.size())
+		{
+			std::list< shared_ptr< SceneRenderable > >::iterator it = mRenderables.begin();
+			std::advance(it, cache.mRenderables.size());
+			for(; it!=mRenderables.end(); ++it)
+			{
+				(*it)->Accept(*this);
+			}
+		}
+		std::sort(mRenderQueue.begin(),mRenderQueue.end(),DistanceCompare);
+		mCurrentCamera = 0;
+		mCurrentRenderTarget = 0;
+	}
+
 	void Scene::Render(RenderTarget& renderTarget, const Camera& camera)
 	{
-		// There is room for optimisation here by caching the results so if you want
-		// render the same scene twice you don't need to build it every time.
 		mCurrentRenderTarget = &renderTarget;
 
-		BuildRenderQueue(camera);
+		std::vector< DistanceRenderablePair >* renderQueue = &mRenderQueue;
+		if(mRenderQueueCachingEnabled)
+		{
+			renderQueue = &GetCachedRenderQueue(camera);
+		}else
+		{
+			BuildRenderQueue(camera);
+		}
 		renderTarget.SetModelViewMatrix(camera.GetViewMatrix());
 
 		ApplyLights(renderTarget,camera);
+		UpdateLightClusters();
 		
 		const Matrix4& viewMatrix = camera.GetViewMatrix();
+		const Matrix4& projectionMatrix = renderTarget.GetProjectionMatrix();
+		const Matrix4 viewProjectionMatrix = viewMatrix * projectionMatrix;
+		if(mSkyBox)
 		{
-			std::vector< Light* > lights = BuildLightList(camera);
 			RenderContext renderContext(renderTarget,
 				viewMatrix,
-				renderTarget.GetProjectionMatrix(),
-				viewMatrix * renderTarget.GetProjectionMatrix(),
+				projectionMatrix,
+				viewProjectionMatrix,
 				camera,
-				lights);
+				GetLightList(camera));
 
-			if(mSkyBox)
-			{
-				mSkyBox->SetPosition(camera.GetPosition());
-				mSkyBox->Render(renderContext, Colours::WHITE);
-			}
+			mSkyBox->SetPosition(camera.GetPosition());
+			mSkyBox->Render(renderContext, Colours::WHITE);
+		}
+
+		RenderBucket* renderBucket = nullptr;
+		if(mRenderBucketEnabled)
+		{
+			renderBucket = &mRenderBucket;
+			renderBucket->Clear();
+		}
+
+		u32 viewportHeight = renderTarget.GetHeight();
+		if(mTextureResidencyManager && renderTarget.GetCurrentViewport())
+		{
+			Viewport::Rectangle viewportRectangle = renderTarget.GetCurrentViewport()->GetRectangle(renderTarget.GetAspectRatio());
+			viewportHeight = static_cast<u32>(viewportRectangle.GetHeight() * viewportHeight);
 		}
 
 		//Need to sort the renderables.
-		BOOST_REVERSE_FOREACH(DistanceRenderablePair& renderable, mRenderQueue)
+		BOOST_REVERSE_FOREACH(DistanceRenderablePair& renderable, *renderQueue)
 		{
-			std::vector< Light* > lights = BuildLightList(*renderable.second);
+			if(mTextureResidencyManager)
+			{
+				mTextureResidencyManager->RenderableUsed(*renderable.second, camera, viewportHeight);
+			}
+
 			RenderContext renderContext(renderTarget,
 				viewMatrix,
-				renderTarget.GetProjectionMatrix(),
-				viewMatrix * renderTarget.GetProjectionMatrix(),
+				projectionMatrix,
+				viewProjectionMatrix,
 				camera,
-				lights);
+				GetLightList(*renderable.second),
+				renderBucket);
 
 			renderable.second->Render(renderContext, Colours::WHITE);
 		}
+
+		if(renderBucket)
+		{
+			// Each command has its own lights.
+			RenderContext renderContext(renderTarget,
+				viewMatrix,
+				projectionMatrix,
+				viewProjectionMatrix,
+				camera,
+				mLightList);
+			renderBucket->Sort();
+			renderBucket->Execute(renderContext);
+		}
 		
-		BOOST_FOREACH(DistanceRenderablePair& renderable, mRenderQueue)
+		BOOST_FOREACH(DistanceRenderablePair& renderable, *renderQueue)
 		{
 			renderable.second->Leave(*this);
 		}
@@ -284,6 +774,7 @@ namespace Echo
 	
 	void Scene::SetUseOnlyZForDistanceCalculations(bool zOnly)
 	{
+		mSceneVersion.fetch_add(1, std::memory_order_relaxed);
 		if(zOnly)
 		{
 			mDistanceFunction = bind(&Scene::SceneAABBCentreZOnlyDistanceCalculate, this, placeholders::_1, placeholders::_2, placeholders::_3);
@@ -319,20 +810,89 @@ namespace Echo
 	std::vector< Light* > Scene::BuildLightList(const Node& node)
 	{
 		std::vector< Light* > lights;
-		lights.reserve(mLights.size());
+		BuildLightList(node.GetDerivedPosition(), lights);
+		return lights;
+	}
+
+	void Scene::BuildLightList(const Vector3& position, std::vector< Light* >& lightsOut)
+	{
+		lightsOut.resize(0);
+		lightsOut.reserve(mLights.size());
 		for(auto& lightPair : mLights)
 		{
-			lights.push_back(lightPair.second.get());
+			lightsOut.push_back(lightPair.second.get());
 		}
-		Vector3 position = node.GetDerivedPosition();
-		std::sort(lights.begin(),lights.end(),[position](const Light* l, const Light* r)
+		std::sort(lightsOut.begin(),lightsOut.end(),[position](const Light* l, const Light* r)
 		{
 			auto distanceL = (l->GetDerivedPosition() - position).LengthSquared();
 			auto distanceR = (r->GetDerivedPosition() - position).LengthSquared();
 			return distanceL < distanceR;
 		});
+	}
+
+	const std::vector< Light* >& Scene::GetLightList(const Node& node)
+	{
+		if(mLightClusterSize<=0.f)
+		{
+			BuildLightList(node.GetDerivedPosition(), mLightList);
+			return mLightList;
+		}
+
+		// Pack the cell coordinates into a key, 21 bits per axis.
+		const Vector3 position = node.GetDerivedPosition();
+		const s64 x = static_cast<s64>(Maths::Floor(position.x / mLightClusterSize));
+		const s64 y = static_cast<s64>(Maths::Floor(position.y / mLightClusterSize));
+		const s64 z = static_cast<s64>(Maths::Floor(position.z / mLightClusterSize));
+		const u64 mask = (1 << 21) - 1;
+		const u64 key = (static_cast<u64>(x) & mask) | ((static_cast<u64>(y) & mask) << 21) | ((static_cast<u64>(z) & mask) << 42);
+
+		auto it = mLightClusters.find(key);
+		if(it!=mLightClusters.end())
+		{
+			return it->second;
+		}
+		if(mLightClusters.size() >= MAXIMUM_LIGHT_CLUSTERS)
+		{
+			// Lists previously returned are no longer in use at this point.
+			mLightClusters.clear();
+		}
+		std::vector< Light* >& lights = mLightClusters[key];
+		Vector3 cellCentre(x + 0.5f, y + 0.5f, z + 0.5f);
+		BuildLightList(cellCentre * mLightClusterSize, lights);
 		return lights;
 	}
+
+	void Scene::UpdateLightClusters()
+	{
+		if(mLightClusterSize<=0.f)
+		{
+			return;
+		}
+		bool lightsChanged = (mLightClusterLights.size()!=mLights.size());
+		if(!lightsChanged)
+		{
+			Size i = 0;
+			for(auto& lightPair : mLights)
+			{
+				const std::pair< Light*, Vector3 >& clusterLight = mLightClusterLights[i];
+				if(clusterLight.first!=lightPair.second.get() || clusterLight.second!=lightPair.second->GetDerivedPosition())
+				{
+					lightsChanged = true;
+					break;
+				}
+				++i;
+			}
+		}
+		if(lightsChanged)
+		{
+			mLightClusterLights.resize(0);
+			for(auto& lightPair : mLights)
+			{
+				mLightClusterLights.push_back(std::make_pair(lightPair.second.get(), lightPair.second->GetDerivedPosition()));
+			}
+			mLightClusters.clear();
+		}
+	}
 	
 	void Scene::ApplyLights(RenderTarget& renderTarget, const Camera& camera)
 	{
@@ -59,11 +59,13 @@ namespace Echo
 	void SceneEntity::SetAxisAlignedBox(AxisAlignedBox localAxisAlignedBox)
 	{
 		mManualAxisAlignedBox = localAxisAlignedBox;
+		NotifyBoundsChanged();
 	}
 
 	void SceneEntity::RemoveManualAxisAlignedBox()
 	{
 		mManualAxisAlignedBox = none;
+		NotifyBoundsChanged();
 	}
 	
 	AxisAlignedBox SceneEntity::GetAxisAlignedBox(bool applyLocalTransform) const
@@ -112,6 +114,7 @@ namespace Echo
 		{
 			mMesh->AddListener(this);
 		}
+		NotifyBoundsChanged();
 	}
 	
 	
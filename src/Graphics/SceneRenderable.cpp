@@ -43,6 +43,20 @@ namespace Echo
 		localAABB.Transform(Node::GetTransform());
 		return localAABB;
 	}
+
+	AxisAlignedBox SceneRenderable::GetSceneHierarchyAxisAlignedBox() const
+	{
+		AxisAlignedBox hierarchyAABB = GetSceneAxisAlignedBox();
+		for(const Node* child : mChildNodes)
+		{
+			const SceneRenderable* childRenderable = dynamic_cast<const SceneRenderable*>(child);
+			if(childRenderable)
+			{
+				hierarchyAABB.Merge(childRenderable->GetSceneHierarchyAxisAlignedBox());
+			}
+		}
+		return hierarchyAABB;
+	}
 	
 	void SceneRenderable::Accept(SceneRenderableVisitor& visitor)
 	{
@@ -69,5 +83,41 @@ namespace Echo
 	void SceneRenderable::OnParentSet(Node* node)
 	{
 		mParentSceneRenderable = dynamic_cast<SceneRenderable*>(node);
+		// Our bounds now contribute to a different hierarchy.
+		NotifyBoundsChanged();
+	}
+
+	void SceneRenderable::NeedUpdate(bool forceParent) const
+	{
+		NotifyBoundsChanged();
+		Node::NeedUpdate(forceParent);
+	}
+
+	void SceneRenderable::NotifyBoundsChanged() const
+	{
+		// Node only notifies parents the first time a child changes so listeners on ancestors are notified
+		// directly rather than relying on ChildRequestUpdate().
+		const SceneRenderable* renderable = this;
+		while(renderable)
+		{
+			for(Listener* listener : renderable->mListeners)
+			{
+				listener->OnSceneBoundsChanged(*renderable);
+			}
+			renderable = renderable->mParentSceneRenderable;
+		}
+	}
+
+	void SceneRenderable::AddListener(Listener* listener)
+	{
+		if(listener)
+		{
+			mListeners.push_back(listener);
+		}
+	}
+
+	void SceneRenderable::RemoveListener(Listener* listener)
+	{
+		mListeners.remove(listener);
 	}
 }
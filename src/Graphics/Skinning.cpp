@@ -0,0 +1,296 @@
+#include <echo/Graphics/Skinning.h>
+#include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Maths/Vector4.h>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ECHO_SKINNING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Echo
+{
+	namespace
+	{
+		// Matches the layout of the "BoneIndices" attribute.
+		struct BoneIndices4
+		{
+			u16 mIndices[4];
+		};
+
+		template< Size N >
+		void SkinPositionsN(const Matrix4* palette, const u16* boneIndices, const f32* weights, const Vector3* source,
+							VertexBuffer::Accessor<Vector3>& destination, Size begin, Size end)
+		{
+			for(Size v = begin; v < end; ++v)
+			{
+				const u16* indices = boneIndices + v * N;
+				const f32* w = weights + v * N;
+				const Vector3& p = source[v];
+				// Blend the top three rows of the matrices then transform the position once. Weights are sorted so
+				// we can stop at the first zero.
+#ifdef ECHO_SKINNING_SSE
+				__m128 row0 = _mm_setzero_ps();
+				__m128 row1 = _mm_setzero_ps();
+				__m128 row2 = _mm_setzero_ps();
+				for(Size i = 0; i < N && w[i] > 0.f; ++i)
+				{
+					const Matrix4& m = palette[indices[i]];
+					__m128 weight = _mm_set1_ps(w[i]);
+					row0 = _mm_add_ps(row0, _mm_mul_ps(weight, _mm_loadu_ps(m[0])));
+					row1 = _mm_add_ps(row1, _mm_mul_ps(weight, _mm_loadu_ps(m[1])));
+					row2 = _mm_add_ps(row2, _mm_mul_ps(weight, _mm_loadu_ps(m[2])));
+				}
+				__m128 position = _mm_set_ps(1.f, p.z, p.y, p.x);
+				__m128 x = _mm_mul_ps(row0, position);
+				__m128 y = _mm_mul_ps(row1, position);
+				__m128 z = _mm_mul_ps(row2, position);
+				__m128 unused = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(x, y, z, unused);
+				f32 result[4];
+				_mm_storeu_ps(result, _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, unused)));
+				destination[v] = Vector3(result[0], result[1], result[2]);
+#else
+				f32 blended[12] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+				for(Size i = 0; i < N && w[i] > 0.f; ++i)
+				{
+					// The first three rows are contiguous.
+					const f32* m = palette[indices[i]][0];
+					for(Size j = 0; j < 12; ++j)
+					{
+						blended[j] += w[i] * m[j];
+					}
+				}
+				destination[v] = Vector3(blended[0] * p.x + blended[1] * p.y + blended[2] * p.z + blended[3],
+										blended[4] * p.x + blended[5] * p.y + blended[6] * p.z + blended[7],
+										blended[8] * p.x + blended[9] * p.y + blended[10] * p.z + blended[11]);
+#endif
+			}
+		}
+	}
+
+	SkinWeights::SkinWeights() :
+		mNumberOfVertices(0),
+		mInfluencesPerVertex(4),
+		mMaximumBoneIndex(0)
+	{
+	}
+
+	SkinWeights::~SkinWeights()
+	{
+	}
+
+	template< class InfluenceFunction >
+	void SkinWeights::Build(Size numberOfVertices, InfluenceFunction getInfluences)
+	{
+		Size maximumInfluences = 0;
+		for(Size v = 0; v < numberOfVertices; ++v)
+		{
+			const std::map< Size, f32 >* influences = getInfluences(v);
+			if(influences)
+			{
+				maximumInfluences = std::max(maximumInfluences, influences->size());
+			}
+		}
+		if(maximumInfluences > MAXIMUM_INFLUENCES)
+		{
+			ECHO_LOG_WARNING("SkinWeights: Vertices have up to " << maximumInfluences << " bone influences. Only the largest " << MAXIMUM_INFLUENCES << " will be used.");
+		}
+
+		mNumberOfVertices = numberOfVertices;
+		mInfluencesPerVertex = (maximumInfluences > 4) ? 8 : 4;
+		mMaximumBoneIndex = 0;
+		mBoneIndices.assign(numberOfVertices * mInfluencesPerVertex, 0);
+		mWeights.assign(numberOfVertices * mInfluencesPerVertex, 0.f);
+
+		std::vector< std::pair<f32, Size> > sorted;
+		for(Size v = 0; v < numberOfVertices; ++v)
+		{
+			const std::map< Size, f32 >* influences = getInfluences(v);
+			if(!influences)
+			{
+				continue;
+			}
+			sorted.clear();
+			for(const std::pair<const Size, f32>& influence : *influences)
+			{
+				if(influence.second <= 0.f)
+				{
+					continue;
+				}
+				if(influence.first > std::numeric_limits<u16>::max())
+				{
+					ECHO_LOG_ERROR("SkinWeights: Bone index " << influence.first << " is out of range. Ignoring influence.");
+					continue;
+				}
+				sorted.push_back(std::make_pair(influence.second, influence.first));
+			}
+			std::sort(sorted.begin(), sorted.end(), [](const std::pair<f32, Size>& a, const std::pair<f32, Size>& b)
+			{
+				return a.first > b.first;
+			});
+			Size numberOfInfluences = std::min(sorted.size(), mInfluencesPerVertex);
+			f32 total = 0.f;
+			for(Size i = 0; i < numberOfInfluences; ++i)
+			{
+				total += sorted[i].first;
+			}
+			Size base = v * mInfluencesPerVertex;
+			for(Size i = 0; i < numberOfInfluences; ++i)
+			{
+				mBoneIndices[base + i] = static_cast<u16>(sorted[i].second);
+				mWeights[base + i] = sorted[i].first / total;
+				mMaximumBoneIndex = std::max(mMaximumBoneIndex, sorted[i].second);
+			}
+		}
+	}
+
+	void SkinWeights::Build(const std::vector<BoneBinding*>& bindings)
+	{
+		Build(bindings.size(), [&bindings](Size v) -> const std::map< Size, f32 >*
+		{
+			return bindings[v] ? &(bindings[v]->mBoneWeights) : nullptr;
+		});
+	}
+
+	void SkinWeights::Build(const std::map< u32, std::map< Size, f32 > >& influences, Size numberOfVertices)
+	{
+		Build(numberOfVertices, [&influences](Size v) -> const std::map< Size, f32 >*
+		{
+			std::map< u32, std::map< Size, f32 > >::const_iterator it = influences.find(static_cast<u32>(v));
+			return (it!=influences.end()) ? &(it->second) : nullptr;
+		});
+	}
+
+	void SkinWeights::AddVertexAttributes(VertexBuffer& vertexBuffer) const
+	{
+		vertexBuffer.AddVertexAttribute("BoneIndices", VertexAttribute(VertexAttribute::ComponentTypes::UNSIGNED16, 4));
+		vertexBuffer.AddVertexAttribute("BoneWeights", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR4, 1));
+		if(mInfluencesPerVertex > 4)
+		{
+			vertexBuffer.AddVertexAttribute("BoneIndices1", VertexAttribute(VertexAttribute::ComponentTypes::UNSIGNED16, 4));
+			vertexBuffer.AddVertexAttribute("BoneWeights1", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR4, 1));
+		}
+	}
+
+	bool SkinWeights::WriteVertexAttributes(VertexBuffer& vertexBuffer) const
+	{
+		if(vertexBuffer.GetNumberOfElements() < mNumberOfVertices)
+		{
+			return false;
+		}
+		for(Size set = 0; set < mInfluencesPerVertex / 4; ++set)
+		{
+			std::string suffix = (set==0) ? "" : std::to_string(set);
+			VertexBuffer::Accessor<BoneIndices4> indices = vertexBuffer.GetAccessor<BoneIndices4>("BoneIndices" + suffix);
+			VertexBuffer::Accessor<Vector4> weights = vertexBuffer.GetAccessor<Vector4>("BoneWeights" + suffix);
+			if(!indices || !weights)
+			{
+				return false;
+			}
+			for(Size v = 0; v < mNumberOfVertices; ++v)
+			{
+				Size base = v * mInfluencesPerVertex + set * 4;
+				for(Size i = 0; i < 4; ++i)
+				{
+					indices[v].mIndices[i] = mBoneIndices[base + i];
+				}
+				weights[v] = Vector4(mWeights[base], mWeights[base + 1], mWeights[base + 2], mWeights[base + 3]);
+			}
+		}
+		vertexBuffer.IncrementVersion();
+		return true;
+	}
+
+	SkinningEngine::SkinningEngine(shared_ptr<WorkerPool> workerPool, Size verticesPerJob) :
+		mWorkerPool(workerPool),
+		mVerticesPerJob(std::max<Size>(verticesPerJob, 1))
+	{
+	}
+
+	SkinningEngine::~SkinningEngine()
+	{
+	}
+
+	void SkinningEngine::Skin(const std::vector< shared_ptr<Mesh> >& meshes)
+	{
+		mJobs.clear();
+		mSubMeshes.clear();
+		mPoseVersions.clear();
+		std::vector<const VertexBuffer*> vertexBuffers;
+
+		// Palettes and per SubMesh preparation aren't thread safe, they are done before the parallel section.
+		for(const shared_ptr<Mesh>& mesh : meshes)
+		{
+			if(!mesh || !mesh->GetUseSkeleton() || !mesh->GetSkeleton())
+			{
+				continue;
+			}
+			Skeleton& skeleton = *mesh->GetSkeleton();
+			const std::vector<Matrix4>& palette = skeleton.GetSkinningPalette();
+			Size poseVersion = skeleton.GetPoseVersion();
+			for(Size s = 0; s < mesh->GetNumberOfSubMeshes(); ++s)
+			{
+				SubMesh* subMesh = mesh->GetSubMesh(static_cast<u32>(s)).get();
+				if(!subMesh->PrepareCPUSkinning(palette, poseVersion))
+				{
+					continue;
+				}
+				mSubMeshes.push_back(subMesh);
+				mPoseVersions.push_back(poseVersion);
+
+				// SubMeshes can share a vertex buffer, only skin it once.
+				const VertexBuffer* vertexBuffer = subMesh->mVertexBuffer.get();
+				if(std::find(vertexBuffers.begin(), vertexBuffers.end(), vertexBuffer)!=vertexBuffers.end())
+				{
+					continue;
+				}
+				vertexBuffers.push_back(vertexBuffer);
+				Size numberOfVertices = vertexBuffer->GetNumberOfElements();
+				for(Size begin = 0; begin < numberOfVertices; begin += mVerticesPerJob)
+				{
+					Job job = {subMesh, &palette, begin, std::min(begin + mVerticesPerJob, numberOfVertices)};
+					mJobs.push_back(job);
+				}
+			}
+		}
+
+		if(mWorkerPool && mJobs.size() > 1)
+		{
+			mWorkerPool->ParallelFor(0, mJobs.size(), 1, [this](Size begin, Size end)
+			{
+				for(Size j = begin; j < end; ++j)
+				{
+					const Job& job = mJobs[j];
+					job.mSubMesh->SkinVertices(*job.mPalette, job.mBegin, job.mEnd);
+				}
+			});
+		}else
+		{
+			for(const Job& job : mJobs)
+			{
+				job.mSubMesh->SkinVertices(*job.mPalette, job.mBegin, job.mEnd);
+			}
+		}
+
+		for(Size i = 0; i < mSubMeshes.size(); ++i)
+		{
+			mSubMeshes[i]->FinishCPUSkinning(mPoseVersions[i]);
+		}
+	}
+
+	void SkinningEngine::SkinPositions(const Matrix4* palette, const SkinWeights& weights, const Vector3* source,
+									VertexBuffer::Accessor<Vector3>& destination, Size begin, Size end)
+	{
+		end = std::min(end, weights.GetNumberOfVertices());
+		if(weights.GetInfluencesPerVertex()==8)
+		{
+			SkinPositionsN<8>(palette, weights.GetBoneIndices(), weights.GetWeights(), source, destination, begin, end);
+		}else
+		{
+			SkinPositionsN<4>(palette, weights.GetBoneIndices(), weights.GetWeights(), source, destination, begin, end);
+		}
+	}
+}
@@ -0,0 +1,236 @@
+#include <echo/Graphics/SpriteAtlas.h>
+#include <echo/Animation/SpriteAnimation.h>
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+namespace Echo
+{
+	namespace
+	{
+		u32 NextPowerOfTwo(u32 value)
+		{
+			u32 result = 1;
+			while(result < value)
+			{
+				result <<= 1;
+			}
+			return result;
+		}
+	}
+
+	SpriteAtlas::SpriteAtlas(u32 pageWidth, u32 pageHeight, u32 padding, Texture::Format format) :
+		mPageWidth(pageWidth),
+		mPageHeight(pageHeight),
+		mPadding(padding),
+		mFormat(format)
+	{
+	}
+
+	SpriteAtlas::~SpriteAtlas()
+	{
+	}
+
+	void SpriteAtlas::AddAnimation(shared_ptr<SpriteAnimation> animation)
+	{
+		if(animation)
+		{
+			mAnimations.push_back(animation);
+		}
+	}
+
+	bool SpriteAtlas::GetRegion(const Texture& source, Region& region) const
+	{
+		std::map<const Texture*, Region>::const_iterator it = mRegions.find(&source);
+		if(it==mRegions.end())
+		{
+			return false;
+		}
+		region = it->second;
+		return true;
+	}
+
+	Size SpriteAtlas::Build()
+	{
+		std::set<const Texture*> pages;
+		for(const shared_ptr<Texture>& page : mPages)
+		{
+			pages.insert(page.get());
+		}
+
+		// Find the textures that haven't been packed, in the order they are first used.
+		std::vector<Placement> placements;
+		std::set<const Texture*> found;
+		Size numberOfSkipped = 0;
+		for(const shared_ptr<SpriteAnimation>& animation : mAnimations)
+		{
+			for(SpriteAnimation::Frame& frame : animation->mFrames)
+			{
+				if(!frame.texture())
+				{
+					frame.texture(animation->AcquireTexture(frame.resource()));
+				}
+				shared_ptr<Texture> texture = frame.texture();
+				if(!texture || pages.count(texture.get()) || mRegions.count(texture.get()) || !found.insert(texture.get()).second)
+				{
+					continue;
+				}
+				if(!texture->GetBuffer() || texture->GetFormat()!=mFormat || texture->GetWidth()==0 || texture->GetHeight()==0 ||
+					texture->GetWidth() + mPadding * 2 > mPageWidth || texture->GetHeight() + mPadding * 2 > mPageHeight)
+				{
+					++numberOfSkipped;
+					continue;
+				}
+				Placement placement;
+				placement.mSource = texture;
+				placements.push_back(placement);
+			}
+		}
+		if(numberOfSkipped > 0)
+		{
+			ECHO_LOG_WARNING("SpriteAtlas: " << numberOfSkipped << " textures could not be packed because they are not loaded, are not in the atlas format or are too large");
+		}
+		if(placements.empty())
+		{
+			return 0;
+		}
+
+		// Taller textures first so each shelf is filled with textures of a similar height.
+		std::stable_sort(placements.begin(), placements.end(), [](const Placement& a, const Placement& b)
+		{
+			if(a.mSource->GetHeight()!=b.mSource->GetHeight())
+			{
+				return a.mSource->GetHeight() > b.mSource->GetHeight();
+			}
+			return a.mSource->GetWidth() > b.mSource->GetWidth();
+		});
+
+		std::vector<PageLayout> layouts;
+		for(Placement& placement : placements)
+		{
+			u32 x;
+			u32 y;
+			Place(layouts, placement.mSource->GetWidth() + mPadding * 2, placement.mSource->GetHeight() + mPadding * 2, placement.mPage, x, y);
+			placement.mX = x + mPadding;
+			placement.mY = y + mPadding;
+		}
+
+		// Create the pages for this build, trimmed to the height used.
+		const Size firstPage = mPages.size();
+		for(const PageLayout& layout : layouts)
+		{
+			const u32 height = std::min(NextPowerOfTwo(layout.mHeightUsed), mPageHeight);
+			shared_ptr<Texture> page(new Texture(mPageWidth, height, mFormat));
+			std::memset(page->GetBuffer().get(), 0, page->GetDataSize());
+			mPages.push_back(page);
+		}
+
+		for(const Placement& placement : placements)
+		{
+			Texture& page = *mPages[firstPage + placement.mPage];
+			const Texture& source = *placement.mSource;
+			CopyTexture(source, page, placement.mX, placement.mY);
+
+			const f32 pageWidth = static_cast<f32>(page.GetWidth());
+			const f32 pageHeight = static_cast<f32>(page.GetHeight());
+			Region region;
+			region.mPage = mPages[firstPage + placement.mPage];
+			region.mUV1 = TextureUV(placement.mX / pageWidth, placement.mY / pageHeight);
+			region.mUV2 = TextureUV((placement.mX + source.GetWidth()) / pageWidth, (placement.mY + source.GetHeight()) / pageHeight);
+			mRegions[&source] = region;
+			mSources.push_back(placement.mSource);
+		}
+
+		// Point the frames at the pages. The frame coordinates are relative to the source texture, which is
+		// how sprite sheet frames continue to reference their part of the sheet.
+		for(const shared_ptr<SpriteAnimation>& animation : mAnimations)
+		{
+			for(SpriteAnimation::Frame& frame : animation->mFrames)
+			{
+				shared_ptr<Texture> texture = frame.texture();
+				if(!texture)
+				{
+					continue;
+				}
+				std::map<const Texture*, Region>::const_iterator it = mRegions.find(texture.get());
+				if(it==mRegions.end())
+				{
+					continue;
+				}
+				const Region& region = it->second;
+				const f32 uScale = region.mUV2.u - region.mUV1.u;
+				const f32 vScale = region.mUV2.v - region.mUV1.v;
+				const TextureUV uv1 = frame.uv1();
+				const TextureUV uv2 = frame.uv2();
+				frame.texture(region.mPage)
+					.uv1(TextureUV(region.mUV1.u + uv1.u * uScale, region.mUV1.v + uv1.v * vScale))
+					.uv2(TextureUV(region.mUV1.u + uv2.u * uScale, region.mUV1.v + uv2.v * vScale));
+			}
+		}
+		return placements.size();
+	}
+
+	void SpriteAtlas::Place(std::vector<PageLayout>& layouts, u32 width, u32 height, Size& page, u32& x, u32& y) const
+	{
+		for(Size p = 0; p < layouts.size(); ++p)
+		{
+			PageLayout& layout = layouts[p];
+			for(Shelf& shelf : layout.mShelves)
+			{
+				if(height <= shelf.mHeight && shelf.mWidthUsed + width <= mPageWidth)
+				{
+					page = p;
+					x = shelf.mWidthUsed;
+					y = shelf.mY;
+					shelf.mWidthUsed += width;
+					return;
+				}
+			}
+			if(layout.mHeightUsed + height <= mPageHeight)
+			{
+				Shelf shelf = {layout.mHeightUsed, height, width};
+				layout.mShelves.push_back(shelf);
+				layout.mHeightUsed += height;
+				page = p;
+				x = 0;
+				y = shelf.mY;
+				return;
+			}
+		}
+
+		// The caller has checked the texture fits on an empty page.
+		PageLayout layout;
+		Shelf shelf = {0, height, width};
+		layout.mShelves.push_back(shelf);
+		layout.mHeightUsed = height;
+		layouts.push_back(layout);
+		page = layouts.size() - 1;
+		x = 0;
+		y = 0;
+	}
+
+	void SpriteAtlas::CopyTexture(const Texture& source, Texture& page, u32 x, u32 y) const
+	{
+		const Size bytesPerPixel = Texture::Formats::GetBytesPerPixel(mFormat);
+		const u8* sourceBuffer = source.GetBuffer().get();
+		u8* pageBuffer = page.GetBuffer().get();
+		const Size sourceStride = source.GetWidth() * bytesPerPixel;
+		const Size pageStride = page.GetWidth() * bytesPerPixel;
+		const s32 padding = static_cast<s32>(mPadding);
+		const s32 height = static_cast<s32>(source.GetHeight());
+
+		for(s32 row = -padding; row < height + padding; ++row)
+		{
+			// Rows in the padding repeat the first or last row.
+			const s32 sourceRow = std::min(std::max(row, 0), height - 1);
+			const u8* sourceLine = sourceBuffer + sourceRow * sourceStride;
+			u8* pageLine = pageBuffer + static_cast<Size>(static_cast<s32>(y) + row) * pageStride + x * bytesPerPixel;
+			std::memcpy(pageLine, sourceLine, sourceStride);
+			for(u32 p = 1; p <= mPadding; ++p)
+			{
+				std::memcpy(pageLine - p * bytesPerPixel, sourceLine, bytesPerPixel);
+				std::memcpy(pageLine + sourceStride + (p - 1) * bytesPerPixel, sourceLine + sourceStride - bytesPerPixel, bytesPerPixel);
+			}
+		}
+	}
+}
@@ -0,0 +1,469 @@
+#include <echo/Graphics/SpriteBatch.h>
+#include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Graphics/Camera.h>
+#include <echo/Graphics/Material.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Echo
+{
+	namespace
+	{
+		const Size VERTICES_PER_SPRITE = 4;
+		const Size TRIANGLES_PER_SPRITE = 2;
+	}
+
+	SpriteBatch::SpriteBatch(shared_ptr<Material> material, shared_ptr<WorkerPool> workerPool, Size spritesPerJob) :
+		mMaterial(material),
+		mWorkerPool(workerPool),
+		mSpritesPerJob(spritesPerJob),
+		mNumberOfBatches(0),
+		mPixelToWorldUnitRatio(100.f),
+		mAlwaysFaceCamera(true),
+		mBoundsOutOfDate(true)
+	{
+		if(!mMaterial)
+		{
+			mMaterial = make_shared<Material>();
+			mMaterial->SetToDefaultMaterial();
+			mMaterial->GetPass(0)->SetVertexColouringEnabled(true);
+		}
+		SetMesh(make_shared<Mesh>());
+	}
+
+	SpriteBatch::~SpriteBatch()
+	{
+	}
+
+	Size SpriteBatch::AddSprite(const Instance& instance)
+	{
+		Size id;
+		if(!mFreeSlots.empty())
+		{
+			id = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		}else
+		{
+			id = mSlots.size();
+			mSlots.push_back(Slot());
+		}
+		Slot& slot = mSlots[id];
+		slot.mInstance = instance;
+		slot.mInUse = true;
+		slot.mGroup = mGroups.size();
+		mBoundsOutOfDate = true;
+		return id;
+	}
+
+	void SpriteBatch::RemoveSprite(Size id)
+	{
+		if(id >= mSlots.size() || !mSlots[id].mInUse)
+		{
+			ECHO_LOG_ERROR("Invalid sprite id " << id);
+			return;
+		}
+		Slot& slot = mSlots[id];
+		slot.mInUse = false;
+		// Release the resources now rather than when the slot is reused.
+		slot.mInstance = Instance();
+		mFreeSlots.push_back(id);
+		mBoundsOutOfDate = true;
+	}
+
+	void SpriteBatch::ClearSprites()
+	{
+		mSlots.clear();
+		mFreeSlots.clear();
+		mBoundsOutOfDate = true;
+	}
+
+	SpriteBatch::Instance& SpriteBatch::GetSprite(Size id)
+	{
+		assert(id < mSlots.size() && mSlots[id].mInUse);
+		// The caller may change anything so the bounds need to be recalculated.
+		mBoundsOutOfDate = true;
+		return mSlots[id].mInstance;
+	}
+
+	const SpriteBatch::Instance& SpriteBatch::GetSprite(Size id) const
+	{
+		assert(id < mSlots.size() && mSlots[id].mInUse);
+		return mSlots[id].mInstance;
+	}
+
+	void SpriteBatch::SetAnimation(Size id, shared_ptr<SpriteAnimation> animation)
+	{
+		Instance& instance = GetSprite(id);
+		instance.mAnimation = animation;
+		instance.mFrameIndex = 0;
+		instance.mFrameTime = Seconds(0.);
+		if(animation && animation->GetNumberOfFrames() > 0)
+		{
+			ProcessFrame(instance);
+		}
+	}
+
+	void SpriteBatch::Update(Seconds lastFrameTime)
+	{
+		for(Slot& slot : mSlots)
+		{
+			Instance& instance = slot.mInstance;
+			if(!slot.mInUse || !instance.mAnimation || !instance.mVisible)
+			{
+				continue;
+			}
+			const Size numberOfFrames = instance.mAnimation->GetNumberOfFrames();
+			if(numberOfFrames==0)
+			{
+				continue;
+			}
+			if(instance.mFrameIndex >= numberOfFrames)
+			{
+				instance.mFrameIndex = 0;
+			}
+
+			// The same logic as Sprite::Update() except that a stopped animation is indicated by the frame time
+			// being negative rather than by pausing a Task.
+			if(instance.mFrameTime < Seconds(0.))
+			{
+				continue;
+			}
+			instance.mFrameTime += lastFrameTime;
+			if(instance.mFrameTime >= instance.mAnimation->GetFrame(instance.mFrameIndex).frameTime())
+			{
+				instance.mFrameTime = Seconds(0.);
+				instance.mFrameIndex++;
+				if(instance.mFrameIndex >= numberOfFrames)
+				{
+					ProcessAnimationEnd(instance);
+				}
+				ProcessFrame(instance);
+				mBoundsOutOfDate = true;
+			}
+		}
+	}
+
+	void SpriteBatch::ProcessFrame(Instance& instance)
+	{
+		//NOTE: This is an internal method that expects the animation to be valid and the frame index to be in range.
+		SpriteAnimation& animation = *instance.mAnimation;
+		SpriteAnimation::Frame& frame = animation.GetFrame(instance.mFrameIndex);
+		if(!frame.texture())
+		{
+			frame.texture(animation.AcquireTexture(frame.resource()));
+		}
+		if(frame.texture())
+		{
+			instance.mTexture = frame.texture();
+		}
+		if(instance.mUseAnimationSize)
+		{
+			f32 width = (frame.width() != 0) ? frame.width() : animation.mWidthInPixels;
+			f32 height = (frame.height() != 0) ? frame.height() : animation.mHeightInPixels;
+			instance.mSize = Vector2(width / mPixelToWorldUnitRatio, height / mPixelToWorldUnitRatio);
+		}
+		instance.mUV1 = frame.uv1();
+		instance.mUV2 = frame.uv2();
+		instance.mFrameOffset = frame.offset();
+		instance.mFrameScale = frame.scale();
+	}
+
+	void SpriteBatch::ProcessAnimationEnd(Instance& instance)
+	{
+		SpriteAnimation::Mode mode = instance.mAnimationMode;
+		if(mode==SpriteAnimation::Modes::NOT_SET)
+		{
+			mode = instance.mAnimation->GetMode();
+		}
+		const Seconds STOPPED(-1.);
+		switch(mode)
+		{
+			case SpriteAnimation::Modes::PLAY_ONCE_HIDE_AND_RESTART:
+				instance.mVisible = false;
+				instance.mFrameIndex = 0;
+				instance.mFrameTime = STOPPED;
+				break;
+			case SpriteAnimation::Modes::PLAY_ONCE_AND_RESTART:
+				instance.mFrameIndex = 0;
+				instance.mFrameTime = STOPPED;
+				break;
+			case SpriteAnimation::Modes::PLAY_ONCE_AND_HIDE:
+				instance.mVisible = false;
+				instance.mFrameIndex = instance.mAnimation->GetNumberOfFrames() - 1;
+				instance.mFrameTime = STOPPED;
+				break;
+			case SpriteAnimation::Modes::PLAY_ONCE:
+				instance.mFrameIndex = instance.mAnimation->GetNumberOfFrames() - 1;
+				instance.mFrameTime = STOPPED;
+				break;
+			case SpriteAnimation::Modes::LOOP:
+			default:
+				instance.mFrameIndex = 0;
+				break;
+		}
+	}
+
+	Size SpriteBatch::GetGroup(const Instance& instance, Size cachedGroup)
+	{
+		const shared_ptr<Material>& material = instance.mMaterial ? instance.mMaterial : mMaterial;
+		if(cachedGroup < mGroups.size())
+		{
+			const Group& group = mGroups[cachedGroup];
+			if(group.mBaseMaterial==material && group.mTexture==instance.mTexture)
+			{
+				return cachedGroup;
+			}
+		}
+
+		GroupKey key(material.get(), instance.mTexture.get());
+		std::map<GroupKey, Size>::iterator it = mGroupLookup.find(key);
+		if(it!=mGroupLookup.end())
+		{
+			return it->second;
+		}
+
+		Group group;
+		group.mBaseMaterial = material;
+		group.mTexture = instance.mTexture;
+		group.mSubMesh = GetMesh()->CreateCommonSubMesh();
+		group.mIndexedData = nullptr;
+		group.mNumberOfIndexedSprites = 0;
+
+		// Sprites with a texture that differs from the material's are drawn with a copy of the material.
+		if(instance.mTexture && material->GetTexture()!=instance.mTexture)
+		{
+			shared_ptr<Material> texturedMaterial = material->Clone();
+			texturedMaterial->SetTexture(instance.mTexture);
+			group.mSubMesh->SetMaterial(texturedMaterial);
+		}else
+		{
+			group.mSubMesh->SetMaterial(material);
+		}
+		mGroups.push_back(group);
+		mGroupLookup[key] = mGroups.size() - 1;
+		return mGroups.size() - 1;
+	}
+
+	bool SpriteBatch::PrepareGroup(Group& group, VertexAccessors& vertices)
+	{
+		shared_ptr<SubMesh> subMesh = group.mSubMesh;
+		shared_ptr<VertexBuffer> vertexBuffer = subMesh->GetVertexBuffer();
+		const Size numberOfSprites = group.mSprites.size();
+		const Size numberOfVertices = numberOfSprites * VERTICES_PER_SPRITE;
+		const Size numberOfTriangles = numberOfSprites * TRIANGLES_PER_SPRITE;
+
+		// Grow geometrically to avoid reallocating every frame while the number of sprites increases.
+		if(vertexBuffer->GetCapacity() < numberOfVertices)
+		{
+			vertexBuffer->Allocate(std::max(numberOfVertices, vertexBuffer->GetCapacity() * 2));
+		}
+
+		shared_ptr<ElementBuffer> elementBuffer = subMesh->GetElementBuffer();
+		if(!elementBuffer)
+		{
+			if(!subMesh->SetElementBuffer(ElementBuffer::Types::STATIC, ElementBuffer::IndexTypes::UNSIGNED_32BIT, ElementBuffer::ElementTypes::TRIANGLE, numberOfTriangles * 2))
+			{
+				ECHO_LOG_ERROR("Unable to setup Element Buffer for SpriteBatch");
+				return false;
+			}
+			elementBuffer = subMesh->GetElementBuffer();
+		}else
+		if(elementBuffer->GetCapacity() < numberOfTriangles)
+		{
+			if(!elementBuffer->Allocate(numberOfTriangles * 2))
+			{
+				ECHO_LOG_ERROR("Reallocation of Element Buffer data failed for SpriteBatch");
+				return false;
+			}
+		}
+
+		// The indices are the same every frame so only new quads need to be indexed.
+		if(elementBuffer->GetDataPointer()!=group.mIndexedData)
+		{
+			group.mIndexedData = elementBuffer->GetDataPointer();
+			group.mNumberOfIndexedSprites = 0;
+		}
+		elementBuffer->SetNumberOfElements(numberOfTriangles);
+		if(numberOfSprites > group.mNumberOfIndexedSprites)
+		{
+			ElementBuffer::Accessor<ElementBuffer::Triangle< u32 > > triangles = elementBuffer->GetAccessor<ElementBuffer::Triangle<u32> >();
+			for(Size s = group.mNumberOfIndexedSprites; s < numberOfSprites; ++s)
+			{
+				u32 vBase = static_cast<u32>(s * VERTICES_PER_SPRITE);
+				auto& triangle1 = triangles[s * TRIANGLES_PER_SPRITE];
+				triangle1.mA = vBase+2;		// 0-1
+				triangle1.mB = vBase+1;		// |/
+				triangle1.mC = vBase;		// 2 3
+				auto& triangle2 = triangles[s * TRIANGLES_PER_SPRITE + 1];
+				triangle2.mA = vBase+3;		// 0 1
+				triangle2.mB = vBase+1;		//  /|
+				triangle2.mC = vBase+2;		// 2-3
+			}
+			group.mNumberOfIndexedSprites = numberOfSprites;
+		}
+
+		const VertexLayout& layout = *vertexBuffer->GetLayout();
+		vertices.mPositions = vertexBuffer->GetAccessor<Vector3>(layout.GetPositionSlot().mIndex);
+		vertices.mNormals = vertexBuffer->GetAccessor<Vector3>(layout.GetNormalSlot().mIndex);
+		vertices.mColours = vertexBuffer->GetAccessor<VertexColour>(layout.GetColourSlot().mIndex);
+		vertices.mTextureCoordinates = vertexBuffer->GetAccessor<TextureUV>(layout.GetTextureCoordinateSlot(0).mIndex);
+		vertexBuffer->SetNumberOfElements(numberOfVertices);
+		return true;
+	}
+
+	void SpriteBatch::Build(const Quaternion& cameraOrientation)
+	{
+		// Assign the visible sprites to groups.
+		for(Group& group : mGroups)
+		{
+			group.mSprites.clear();
+		}
+		for(Size s = 0; s < mSlots.size(); ++s)
+		{
+			Slot& slot = mSlots[s];
+			if(!slot.mInUse || !slot.mInstance.mVisible)
+			{
+				continue;
+			}
+			slot.mGroup = GetGroup(slot.mInstance, slot.mGroup);
+			mGroups[slot.mGroup].mSprites.push_back(static_cast<u32>(s));
+		}
+
+		// The quad axes in the local space of the batch.
+		Vector3 right = Vector3::UNIT_X;
+		Vector3 up = Vector3::UNIT_Y;
+		Vector3 back = Vector3::UNIT_Z;
+		if(mAlwaysFaceCamera)
+		{
+			Quaternion localOrientation = GetDerivedOrientation().UnitInverse() * cameraOrientation;
+			right = localOrientation * Vector3::UNIT_X;
+			up = localOrientation * Vector3::UNIT_Y;
+			back = localOrientation * Vector3::UNIT_Z;
+		}
+
+		mNumberOfBatches = 0;
+		for(Group& group : mGroups)
+		{
+			shared_ptr<SubMesh> subMesh = group.mSubMesh;
+			const Size numberOfSprites = group.mSprites.size();
+			VertexAccessors vertices;
+			if(numberOfSprites==0 || !PrepareGroup(group, vertices))
+			{
+				subMesh->SetVisible(false);
+				continue;
+			}
+			subMesh->SetVisible(true);
+			++mNumberOfBatches;
+
+			if(mWorkerPool && numberOfSprites > mSpritesPerJob)
+			{
+				mWorkerPool->ParallelFor(0, numberOfSprites, mSpritesPerJob, [this, &group, &right, &up, &back, &vertices](Size begin, Size end)
+				{
+					BuildQuads(group, begin, end, right, up, back, vertices);
+				});
+			}else
+			{
+				BuildQuads(group, 0, numberOfSprites, right, up, back, vertices);
+			}
+			subMesh->GetVertexBuffer()->IncrementVersion();
+			subMesh->Finalise();
+		}
+	}
+
+	void SpriteBatch::BuildQuads(const Group& group, Size begin, Size end, const Vector3& right, const Vector3& up, const Vector3& back, VertexAccessors& vertices) const
+	{
+		for(Size i = begin; i < end; ++i)
+		{
+			const Instance& instance = mSlots[group.mSprites[i]].mInstance;
+			const Vector3& offset = instance.mFrameOffset;
+			const Vector3 centre = instance.mPosition + right * offset.x + up * offset.y + back * offset.z;
+			const f32 halfWidth = instance.mSize.x * instance.mFrameScale.x * 0.5f;
+			const f32 halfHeight = instance.mSize.y * instance.mFrameScale.y * 0.5f;
+
+			Vector3 quadRight = right * halfWidth;
+			Vector3 quadUp = up * halfHeight;
+			if(instance.mRotation!=0.f)
+			{
+				const f32 c = std::cos(instance.mRotation);
+				const f32 s = std::sin(instance.mRotation);
+				quadRight = (right * c + up * s) * halfWidth;
+				quadUp = (up * c - right * s) * halfHeight;
+			}
+
+			const Size vBase = i * VERTICES_PER_SPRITE;
+			vertices.mPositions[vBase  ] = centre - quadRight + quadUp;
+			vertices.mPositions[vBase+1] = centre + quadRight + quadUp;
+			vertices.mPositions[vBase+2] = centre - quadRight - quadUp;
+			vertices.mPositions[vBase+3] = centre + quadRight - quadUp;
+			vertices.mNormals[vBase  ] = back;
+			vertices.mNormals[vBase+1] = back;
+			vertices.mNormals[vBase+2] = back;
+			vertices.mNormals[vBase+3] = back;
+
+			// The same layout as Sprite::SetTextureCoordinates().
+			const f32 uLeft = instance.mFlippedHorizontally ? instance.mUV2.u : instance.mUV1.u;
+			const f32 uRight = instance.mFlippedHorizontally ? instance.mUV1.u : instance.mUV2.u;
+			const f32 vTop = instance.mFlippedVertically ? instance.mUV2.v : instance.mUV1.v;
+			const f32 vBottom = instance.mFlippedVertically ? instance.mUV1.v : instance.mUV2.v;
+			vertices.mTextureCoordinates[vBase  ] = TextureUV(uLeft, vTop);
+			vertices.mTextureCoordinates[vBase+1] = TextureUV(uRight, vTop);
+			vertices.mTextureCoordinates[vBase+2] = TextureUV(uLeft, vBottom);
+			vertices.mTextureCoordinates[vBase+3] = TextureUV(uRight, vBottom);
+
+			const VertexColour colour = instance.mColour;
+			vertices.mColours[vBase  ] = colour;
+			vertices.mColours[vBase+1] = colour;
+			vertices.mColours[vBase+2] = colour;
+			vertices.mColours[vBase+3] = colour;
+		}
+	}
+
+	void SpriteBatch::UpdateBounds()
+	{
+		// The quads can face any direction so each sprite is bounded by a sphere around its position.
+		bool empty = true;
+		Vector3 minimum = Vector3::ZERO;
+		Vector3 maximum = Vector3::ZERO;
+		for(const Slot& slot : mSlots)
+		{
+			const Instance& instance = slot.mInstance;
+			if(!slot.mInUse || !instance.mVisible)
+			{
+				continue;
+			}
+			const f32 halfWidth = instance.mSize.x * instance.mFrameScale.x * 0.5f;
+			const f32 halfHeight = instance.mSize.y * instance.mFrameScale.y * 0.5f;
+			const f32 radius = std::sqrt(halfWidth * halfWidth + halfHeight * halfHeight) + instance.mFrameOffset.Length();
+			const Vector3 extent(radius, radius, radius);
+			if(empty)
+			{
+				minimum = instance.mPosition - extent;
+				maximum = instance.mPosition + extent;
+				empty = false;
+			}else
+			{
+				minimum.MakeFloor(instance.mPosition - extent);
+				maximum.MakeCeil(instance.mPosition + extent);
+			}
+		}
+		SetAxisAlignedBox(AxisAlignedBox(minimum, maximum));
+		mBoundsOutOfDate = false;
+	}
+
+	void SpriteBatch::Accept(SceneRenderableVisitor& visitor)
+	{
+		if(mBoundsOutOfDate)
+		{
+			UpdateBounds();
+		}
+		SceneEntity::Accept(visitor);
+	}
+
+	void SpriteBatch::Render(RenderContext& renderContext, Colour compoundDiffuse)
+	{
+		Build(renderContext.mCamera.GetDerivedOrientation());
+		SceneEntity::Render(renderContext, compoundDiffuse);
+	}
+}
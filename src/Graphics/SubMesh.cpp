@@ -1,5 +1,6 @@
 #include <echo/Graphics/SubMesh.h>
 #include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/Skinning.h>
 #include <echo/Kernel/ScopedLock.h>
 #include <iostream>
 
@@ -15,6 +16,8 @@ namespace Echo
 		mAxisAlignedBoxOutOfDate(true),
 		mType(MeshTypes::TRIANGLES)
 	{
+		mSkinnedPoseVersion = std::numeric_limits<Size>::max();
+		mSkinnedOnGPU = false;
 	}
 
 	Vector3 SubMesh::GetDimensions() const
@@ -75,6 +78,8 @@ namespace Echo
 		{
 			newMesh->mBoneWeights = shared_ptr< std::vector<BoneBinding*> >(new std::vector<BoneBinding*>(*mBoneWeights));
 		}
+		// Skin weights aren't modified after they are built so they can be shared.
+		newMesh->mSkinWeights = mSkinWeights;
 		if(mVertexBuffer)
 		{
 			newMesh->mVertexBuffer.reset(new VertexBuffer(*mVertexBuffer));
@@ -422,55 +427,122 @@ namespace Echo
 
 	void SubMesh::ApplyVertexBoneTransforms()
 	{
-		if(!mVertexBuffer || !mBoneWeights)
+		shared_ptr<Skeleton> skeleton = mParent.GetSkeleton();
+		if(!skeleton)
 		{
 			return;
 		}
+		const std::vector<Matrix4>& palette = skeleton->GetSkinningPalette();
+		Size poseVersion = skeleton->GetPoseVersion();
+		if(PrepareCPUSkinning(palette, poseVersion))
+		{
+			SkinVertices(palette, 0, mVertexBuffer->GetNumberOfElements());
+			FinishCPUSkinning(poseVersion);
+		}
+	}
+
+	bool SubMesh::PrepareCPUSkinning(const std::vector<Matrix4>& palette, Size poseVersion)
+	{
+		if(!mVertexBuffer || (!mBoneWeights && !mSkinWeights))
+		{
+			return false;
+		}
+		if(!mSkinWeights)
+		{
+			mSkinWeights = make_shared<SkinWeights>();
+			mSkinWeights->Build(*mBoneWeights);
+		}
+
+		if(CanSkinOnGPU(palette.size()))
+		{
+			RestoreUnskinnedVertices();
+			mSkinnedOnGPU = true;
+			return false;
+		}
+		mSkinnedOnGPU = false;
+
+		if(mSkinnedPoseVersion==poseVersion)
+		{
+			return false;
+		}
+
+		Size numberOfVertices = mVertexBuffer->GetNumberOfElements();
+		if(mSkinWeights->GetNumberOfVertices()!=numberOfVertices ||
+			(numberOfVertices > 0 && mSkinWeights->GetMaximumBoneIndex() >= palette.size()))
+		{
+			ECHO_LOG_ERROR("SubMesh \"" << mName << "\" skin weights do not match the vertices or skeleton. Not skinning.");
+			// Don't try again until the pose changes.
+			mSkinnedPoseVersion = poseVersion;
+			return false;
+		}
 
 		// Before applying transforms make sure we have preserved the original
 		if(!mOriginalVertices)
 		{
 			GenerateTransformBuffers();
 		}
-		
+		return (mOriginalVertices && mOriginalVertices->size()==numberOfVertices);
+	}
+
+	void SubMesh::SkinVertices(const std::vector<Matrix4>& palette, Size begin, Size end)
+	{
 		VertexBuffer::Accessor<Vector3> vertices = GetComponents<Vector3>("Position");
 		if(!vertices)
 		{
 			return;
 		}
-		std::vector<Vector3>& originalVerts = *mOriginalVertices;
-		Size numVerts = mVertexBuffer->GetNumberOfElements();
-		assert(originalVerts.size() == numVerts);
-		for(Size v = 0; v < numVerts; ++v)
+		SkinningEngine::SkinPositions(palette.data(), *mSkinWeights, mOriginalVertices->data(), vertices, begin, end);
+	}
+
+	void SubMesh::FinishCPUSkinning(Size poseVersion)
+	{
+		mSkinnedPoseVersion = poseVersion;
+		mVertexBuffer->IncrementVersion();
+		mAxisAlignedBoxOutOfDate = true;
+		mParent.MarkExtentsOutOfDate();
+	}
+
+	bool SubMesh::CanSkinOnGPU(Size numberOfBones)
+	{
+		if(!mMaterial || numberOfBones==0 || !mVertexBuffer->GetVertexAttribute("BoneWeights"))
 		{
-			BoneBinding& binding = *(*mBoneWeights)[v];
-			vertices[v].SetZero();
-			std::map< size_t, f32 >::iterator it = binding.mBoneWeights.begin();
-			std::map< size_t, f32 >::iterator itEnd = binding.mBoneWeights.end();
-			while(it != itEnd)
+			return false;
+		}
+		bool activePass = false;
+		for(Size p = 0; p < mMaterial->GetNumberOfPasses(); ++p)
+		{
+			RenderPass* pass = mMaterial->GetPass(static_cast<u32>(p));
+			if(!pass->GetActive())
 			{
-				const Matrix4& trans = mParent.GetSkeleton()->GetBone(it->first)->GetOffsetTransform();
-
-				f32& weight = it->second;
-
-				vertices[v].x += (trans[0][0] * originalVerts[v].x +
-								trans[0][1] * originalVerts[v].y +
-								trans[0][2] * originalVerts[v].z +
-								trans[0][3])
-						* weight;
-				vertices[v].y += (trans[1][0] * originalVerts[v].x +
-								trans[1][1] * originalVerts[v].y +
-								trans[1][2] * originalVerts[v].z +
-								trans[1][3])
-						* weight;
-				vertices[v].z += (trans[2][0] * originalVerts[v].x +
-								trans[2][1] * originalVerts[v].y +
-								trans[2][2] * originalVerts[v].z +
-								trans[2][3])
-						* weight;
-				++it;
+				continue;
 			}
+			if(!pass->mProgram || pass->CacheProgramBoneMatrices(numberOfBones) < numberOfBones)
+			{
+				return false;
+			}
+			activePass = true;
 		}
+		return activePass;
+	}
+
+	void SubMesh::RestoreUnskinnedVertices()
+	{
+		if(!mOriginalVertices || mSkinnedPoseVersion==std::numeric_limits<Size>::max())
+		{
+			return;
+		}
+		VertexBuffer::Accessor<Vector3> vertices = GetComponents<Vector3>("Position");
+		if(vertices)
+		{
+			const std::vector<Vector3>& originalVertices = *mOriginalVertices;
+			Size numberOfVertices = std::min(originalVertices.size(), vertices.GetCapacity());
+			for(Size v = 0; v < numberOfVertices; ++v)
+			{
+				vertices[v] = originalVertices[v];
+			}
+		}
+		mSkinnedPoseVersion = std::numeric_limits<Size>::max();
+		mVertexBuffer->IncrementVersion();
 		mAxisAlignedBoxOutOfDate = true;
 		mParent.MarkExtentsOutOfDate();
 	}
@@ -496,6 +568,16 @@ namespace Echo
 		renderTarget.ClearSources();
 		if(pass.mProgram)
 		{
+			if(mSkinnedOnGPU && mParent.GetUseSkeleton() && mParent.GetSkeleton())
+			{
+				// The variables are uploaded when the program is activated.
+				const std::vector<Matrix4>& palette = mParent.GetSkeleton()->GetSkinningPalette();
+				Size numberOfBones = pass.CacheProgramBoneMatrices(palette.size());
+				for(Size b = 0; b < numberOfBones; ++b)
+				{
+					*pass.mProgramBoneMatrixCache[b] = palette[b];
+				}
+			}
 			//Make sure the program is built
 			renderTarget.BuildProgram(pass.mProgram);
 			renderTarget.ActivateProgram(pass.mProgram);
@@ -531,7 +613,9 @@ namespace Echo
 		mAxisAlignedBoxOutOfDate = true;
 		mParent.MarkExtentsOutOfDate();
 
-		if(mBoneWeights)
+		// The vertices are considered unskinned after they are modified.
+		mSkinnedPoseVersion = std::numeric_limits<Size>::max();
+		if(mBoneWeights || mSkinWeights)
 		{
 			GenerateTransformBuffers();
 		}else
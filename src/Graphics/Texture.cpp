@@ -1,6 +1,7 @@
 #include <echo/Graphics/Texture.h>
 #include <echo/Resource/TextureManager.h>
 #include <echo/Util/Utils.h>
+#include <cstring>
 
 namespace Echo
 {
@@ -211,6 +212,21 @@ namespace Echo
 		return *this;
 	}
 
+	void Texture::ReplaceBuffer(const Texture& source)
+	{
+		if(this == &source)
+		{
+			return;
+		}
+		mWidth = source.mWidth;
+		mHeight = source.mHeight;
+		mBuffer = source.mBuffer;
+		mBufferOption = source.mBufferOption;
+		mBufferSize = source.mBufferSize;
+		mFormat = source.mFormat;
+		IncrementVersion();
+	}
+
 	bool Texture::HasAlpha() const
 	{
 		return Texture::Formats::HasAlpha(mFormat);
@@ -260,16 +276,9 @@ namespace Echo
 		const Size stride = bytesPerPixel * mWidth;
 		const Size targetStride = bytesPerPixel * extractedSize.x;
 		const Size bytesXStart = minimum.x * bytesPerPixel;
-		const Size bytesXEnd = (maximum.x+1) * bytesPerPixel;
 		for(Size srcY = minimum.y; srcY <= maximum.y; ++srcY)
 		{
-			Size targetX = 0;
-			Size yBase = srcY * stride;
-			for(Size srcX = bytesXStart; srcX < bytesXEnd; ++srcX)
-			{
-				targetBuffer[targetX + targetY] = sourceBuffer[srcX + yBase];
-				++targetX;
-			}
+			std::memcpy(&targetBuffer[targetY], &sourceBuffer[bytesXStart + srcY * stride], targetStride);
 			targetY+=targetStride;
 		}
 		return texture;
@@ -0,0 +1,982 @@
+#include <echo/Graphics/TextureProcessor.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ECHO_TEXTUREPROCESSOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Echo
+{
+	namespace
+	{
+		// Conversions that go through float RGBA are done in blocks of this many pixels.
+		const Size BLOCK_SIZE = 256;
+
+		inline u32 Quantise(f32 value, u32 maximum)
+		{
+			value = std::min(std::max(value, 0.f), 1.f);
+			return static_cast<u32>(value * static_cast<f32>(maximum) + 0.5f);
+		}
+
+		inline f32 Luminance(const f32* rgba)
+		{
+			return rgba[0] * 0.2126f + rgba[1] * 0.7152f + rgba[2] * 0.0722f;
+		}
+
+		inline u16 LoadU16(const u8* p)
+		{
+			u16 value;
+			std::memcpy(&value, p, sizeof(u16));
+			return value;
+		}
+
+		inline u32 LoadU32(const u8* p)
+		{
+			u32 value;
+			std::memcpy(&value, p, sizeof(u32));
+			return value;
+		}
+
+		inline void StoreU16(u8* p, u32 value)
+		{
+			u16 v = static_cast<u16>(value);
+			std::memcpy(p, &v, sizeof(u16));
+		}
+
+		inline void StoreU32(u8* p, u32 value)
+		{
+			std::memcpy(p, &value, sizeof(u32));
+		}
+
+		bool IsEightBitPerChannel(Texture::Format format)
+		{
+			switch(format)
+			{
+				case Texture::Formats::R8G8B8X8:
+				case Texture::Formats::R8G8B8A8:
+				case Texture::Formats::R8G8B8:
+				case Texture::Formats::B8G8R8:
+				case Texture::Formats::B8G8R8A8:
+				case Texture::Formats::LUMINANCE8:
+				case Texture::Formats::LUMINANCE8_ALPHA8:
+				case Texture::Formats::GREYSCALE8:
+					return true;
+				default:
+					break;
+			}
+			return false;
+		}
+
+		/**
+		 * Decode pixels to float RGBA. Packed formats are in native endian with the first channel in the most
+		 * significant bits, matching the GL packed types.
+		 */
+		void DecodePixels(const u8* source, Texture::Format format, f32* rgba, Size count)
+		{
+			const f32 scale8 = 1.f / 255.f;
+			switch(format)
+			{
+				case Texture::Formats::R8G8B8A8:
+					for(Size i = 0; i < count * 4; ++i)
+					{
+						rgba[i] = source[i] * scale8;
+					}
+				break;
+				case Texture::Formats::R8G8B8X8:
+				case Texture::Formats::R8G8B8:
+				case Texture::Formats::B8G8R8:
+				case Texture::Formats::B8G8R8A8:
+				{
+					const Size stride = Texture::Formats::GetBytesPerPixel(format);
+					const bool bgr = (format==Texture::Formats::B8G8R8 || format==Texture::Formats::B8G8R8A8);
+					const bool alpha = (format==Texture::Formats::B8G8R8A8);
+					const Size r = bgr ? 2 : 0;
+					const Size b = bgr ? 0 : 2;
+					for(Size i = 0; i < count; ++i)
+					{
+						const u8* p = source + i * stride;
+						f32* out = rgba + i * 4;
+						out[0] = p[r] * scale8;
+						out[1] = p[1] * scale8;
+						out[2] = p[b] * scale8;
+						out[3] = alpha ? p[3] * scale8 : 1.f;
+					}
+				}
+				break;
+				case Texture::Formats::R5G6B5:
+					for(Size i = 0; i < count; ++i)
+					{
+						const u16 p = LoadU16(source + i * 2);
+						f32* out = rgba + i * 4;
+						out[0] = ((p >> 11) & 31) / 31.f;
+						out[1] = ((p >> 5) & 63) / 63.f;
+						out[2] = (p & 31) / 31.f;
+						out[3] = 1.f;
+					}
+				break;
+				case Texture::Formats::R5G5B5A1:
+					for(Size i = 0; i < count; ++i)
+					{
+						const u16 p = LoadU16(source + i * 2);
+						f32* out = rgba + i * 4;
+						out[0] = ((p >> 11) & 31) / 31.f;
+						out[1] = ((p >> 6) & 31) / 31.f;
+						out[2] = ((p >> 1) & 31) / 31.f;
+						out[3] = static_cast<f32>(p & 1);
+					}
+				break;
+				case Texture::Formats::R4G4B4A4:
+					for(Size i = 0; i < count; ++i)
+					{
+						const u16 p = LoadU16(source + i * 2);
+						f32* out = rgba + i * 4;
+						out[0] = ((p >> 12) & 15) / 15.f;
+						out[1] = ((p >> 8) & 15) / 15.f;
+						out[2] = ((p >> 4) & 15) / 15.f;
+						out[3] = (p & 15) / 15.f;
+					}
+				break;
+				case Texture::Formats::R10G10B10X2:
+				case Texture::Formats::R10G10B10A2:
+				{
+					const bool alpha = (format==Texture::Formats::R10G10B10A2);
+					for(Size i = 0; i < count; ++i)
+					{
+						const u32 p = LoadU32(source + i * 4);
+						f32* out = rgba + i * 4;
+						out[0] = ((p >> 22) & 1023) / 1023.f;
+						out[1] = ((p >> 12) & 1023) / 1023.f;
+						out[2] = ((p >> 2) & 1023) / 1023.f;
+						out[3] = alpha ? (p & 3) / 3.f : 1.f;
+					}
+				}
+				break;
+				case Texture::Formats::LUMINANCE8:
+				case Texture::Formats::GREYSCALE8:
+					for(Size i = 0; i < count; ++i)
+					{
+						f32* out = rgba + i * 4;
+						out[0] = out[1] = out[2] = source[i] * scale8;
+						out[3] = 1.f;
+					}
+				break;
+				case Texture::Formats::LUMINANCE8_ALPHA8:
+					for(Size i = 0; i < count; ++i)
+					{
+						f32* out = rgba + i * 4;
+						out[0] = out[1] = out[2] = source[i * 2] * scale8;
+						out[3] = source[i * 2 + 1] * scale8;
+					}
+				break;
+				case Texture::Formats::GREYSCALE16:
+					for(Size i = 0; i < count; ++i)
+					{
+						f32* out = rgba + i * 4;
+						out[0] = out[1] = out[2] = LoadU16(source + i * 2) / 65535.f;
+						out[3] = 1.f;
+					}
+				break;
+				case Texture::Formats::RGB_F32:
+					for(Size i = 0; i < count; ++i)
+					{
+						f32* out = rgba + i * 4;
+						std::memcpy(out, source + i * sizeof(f32) * 3, sizeof(f32) * 3);
+						out[3] = 1.f;
+					}
+				break;
+				case Texture::Formats::RGBA_F32:
+					std::memcpy(rgba, source, count * sizeof(f32) * 4);
+				break;
+				case Texture::Formats::LUMINANCE32:
+				case Texture::Formats::LUMINANCE32_ALPHA32:
+				{
+					const bool alpha = (format==Texture::Formats::LUMINANCE32_ALPHA32);
+					const Size stride = alpha ? 2 : 1;
+					for(Size i = 0; i < count; ++i)
+					{
+						f32 values[2] = {0.f, 1.f};
+						std::memcpy(values, source + i * stride * sizeof(f32), stride * sizeof(f32));
+						f32* out = rgba + i * 4;
+						out[0] = out[1] = out[2] = values[0];
+						out[3] = values[1];
+					}
+				}
+				break;
+				default:
+					std::fill(rgba, rgba + count * 4, 0.f);
+				break;
+			}
+		}
+
+		void EncodePixels(const f32* rgba, Texture::Format format, u8* destination, Size count)
+		{
+			switch(format)
+			{
+				case Texture::Formats::R8G8B8A8:
+					for(Size i = 0; i < count * 4; ++i)
+					{
+						destination[i] = static_cast<u8>(Quantise(rgba[i], 255));
+					}
+				break;
+				case Texture::Formats::R8G8B8X8:
+				case Texture::Formats::R8G8B8:
+				case Texture::Formats::B8G8R8:
+				case Texture::Formats::B8G8R8A8:
+				{
+					const Size stride = Texture::Formats::GetBytesPerPixel(format);
+					const bool bgr = (format==Texture::Formats::B8G8R8 || format==Texture::Formats::B8G8R8A8);
+					const Size r = bgr ? 2 : 0;
+					const Size b = bgr ? 0 : 2;
+					for(Size i = 0; i < count; ++i)
+					{
+						const f32* in = rgba + i * 4;
+						u8* p = destination + i * stride;
+						p[r] = static_cast<u8>(Quantise(in[0], 255));
+						p[1] = static_cast<u8>(Quantise(in[1], 255));
+						p[b] = static_cast<u8>(Quantise(in[2], 255));
+						if(stride==4)
+						{
+							p[3] = (format==Texture::Formats::B8G8R8A8) ? static_cast<u8>(Quantise(in[3], 255)) : 255;
+						}
+					}
+				}
+				break;
+				case Texture::Formats::R5G6B5:
+					for(Size i = 0; i < count; ++i)
+					{
+						const f32* in = rgba + i * 4;
+						StoreU16(destination + i * 2, (Quantise(in[0], 31) << 11) | (Quantise(in[1], 63) << 5) | Quantise(in[2], 31));
+					}
+				break;
+				case Texture::Formats::R5G5B5A1:
+					for(Size i = 0; i < count; ++i)
+					{
+						const f32* in = rgba + i * 4;
+						StoreU16(destination + i * 2, (Quantise(in[0], 31) << 11) | (Quantise(in[1], 31) << 6) | (Quantise(in[2], 31) << 1) | Quantise(in[3], 1));
+					}
+				break;
+				case Texture::Formats::R4G4B4A4:
+					for(Size i = 0; i < count; ++i)
+					{
+						const f32* in = rgba + i * 4;
+						StoreU16(destination + i * 2, (Quantise(in[0], 15) << 12) | (Quantise(in[1], 15) << 8) | (Quantise(in[2], 15) << 4) | Quantise(in[3], 15));
+					}
+				break;
+				case Texture::Formats::R10G10B10X2:
+				case Texture::Formats::R10G10B10A2:
+				{
+					const bool alpha = (format==Texture::Formats::R10G10B10A2);
+					for(Size i = 0; i < count; ++i)
+					{
+						const f32* in = rgba + i * 4;
+						StoreU32(destination + i * 4, (Quantise(in[0], 1023) << 22) | (Quantise(in[1], 1023) << 12) | (Quantise(in[2], 1023) << 2) | (alpha ? Quantise(in[3], 3) : 3));
+					}
+				}
+				break;
+				case Texture::Formats::LUMINANCE8:
+				case Texture::Formats::GREYSCALE8:
+					for(Size i = 0; i < count; ++i)
+					{
+						destination[i] = static_cast<u8>(Quantise(Luminance(rgba + i * 4), 255));
+					}
+				break;
+				case Texture::Formats::LUMINANCE8_ALPHA8:
+					for(Size i = 0; i < count; ++i)
+					{
+						destination[i * 2] = static_cast<u8>(Quantise(Luminance(rgba + i * 4), 255));
+						destination[i * 2 + 1] = static_cast<u8>(Quantise(rgba[i * 4 + 3], 255));
+					}
+				break;
+				case Texture::Formats::GREYSCALE16:
+					for(Size i = 0; i < count; ++i)
+					{
+						StoreU16(destination + i * 2, Quantise(Luminance(rgba + i * 4), 65535));
+					}
+				break;
+				case Texture::Formats::RGB_F32:
+					for(Size i = 0; i < count; ++i)
+					{
+						std::memcpy(destination + i * sizeof(f32) * 3, rgba + i * 4, sizeof(f32) * 3);
+					}
+				break;
+				case Texture::Formats::RGBA_F32:
+					std::memcpy(destination, rgba, count * sizeof(f32) * 4);
+				break;
+				case Texture::Formats::LUMINANCE32:
+				case Texture::Formats::LUMINANCE32_ALPHA32:
+				{
+					const bool alpha = (format==Texture::Formats::LUMINANCE32_ALPHA32);
+					const Size stride = alpha ? 2 : 1;
+					for(Size i = 0; i < count; ++i)
+					{
+						const f32 values[2] = {Luminance(rgba + i * 4), rgba[i * 4 + 3]};
+						std::memcpy(destination + i * stride * sizeof(f32), values, stride * sizeof(f32));
+					}
+				}
+				break;
+				default:
+				break;
+			}
+		}
+
+		/**
+		 * Swap the first and third bytes of each four byte pixel, optionally forcing the fourth byte to 255.
+		 */
+		void SwizzleRB32(const u8* source, u8* destination, Size count, bool opaque)
+		{
+			Size i = 0;
+#ifdef ECHO_TEXTUREPROCESSOR_SSE2
+			const __m128i greenAlphaMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+			const __m128i redBlueMask = _mm_set1_epi32(0x00FF00FF);
+			const __m128i alphaBits = _mm_set1_epi32(opaque ? static_cast<int>(0xFF000000u) : 0);
+			for(; i + 4 <= count; i += 4)
+			{
+				__m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+				__m128i ga = _mm_and_si128(p, greenAlphaMask);
+				__m128i rb = _mm_and_si128(p, redBlueMask);
+				rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), _mm_or_si128(_mm_or_si128(ga, rb), alphaBits));
+			}
+#endif
+			for(; i < count; ++i)
+			{
+				const u8* p = source + i * 4;
+				u8* out = destination + i * 4;
+				out[0] = p[2];
+				out[1] = p[1];
+				out[2] = p[0];
+				out[3] = opaque ? 255 : p[3];
+			}
+		}
+
+		void SetOpaque32(const u8* source, u8* destination, Size count)
+		{
+			Size i = 0;
+#ifdef ECHO_TEXTUREPROCESSOR_SSE2
+			const __m128i alphaBits = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+			for(; i + 4 <= count; i += 4)
+			{
+				__m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), _mm_or_si128(p, alphaBits));
+			}
+#endif
+			for(; i < count; ++i)
+			{
+				std::memcpy(destination + i * 4, source + i * 4, 3);
+				destination[i * 4 + 3] = 255;
+			}
+		}
+
+		void Expand24To32(const u8* source, u8* destination, Size count, bool swap)
+		{
+			const Size r = swap ? 2 : 0;
+			const Size b = swap ? 0 : 2;
+			for(Size i = 0; i < count; ++i)
+			{
+				const u8* p = source + i * 3;
+				u8* out = destination + i * 4;
+				out[0] = p[r];
+				out[1] = p[1];
+				out[2] = p[b];
+				out[3] = 255;
+			}
+		}
+
+		void Pack32To24(const u8* source, u8* destination, Size count, bool swap)
+		{
+			const Size r = swap ? 2 : 0;
+			const Size b = swap ? 0 : 2;
+			for(Size i = 0; i < count; ++i)
+			{
+				const u8* p = source + i * 4;
+				u8* out = destination + i * 3;
+				out[0] = p[r];
+				out[1] = p[1];
+				out[2] = p[b];
+			}
+		}
+
+		/**
+		 * Conversions between 8 bit RGB(A) formats that don't need to go through float.
+		 * @return false if there isn't a direct conversion.
+		 */
+		bool ConvertDirect(const u8* source, Texture::Format sourceFormat, u8* destination, Texture::Format destinationFormat, Size count)
+		{
+			typedef Texture::Formats F;
+			const bool sourceRGBA = (sourceFormat==F::R8G8B8A8 || sourceFormat==F::R8G8B8X8);
+			const bool destinationRGBA = (destinationFormat==F::R8G8B8A8 || destinationFormat==F::R8G8B8X8);
+			const bool sourceOpaque = (sourceFormat==F::R8G8B8X8);
+			const bool destinationOpaque = (destinationFormat==F::R8G8B8X8);
+			if(sourceRGBA && destinationRGBA)
+			{
+				if(destinationOpaque && !sourceOpaque)
+				{
+					SetOpaque32(source, destination, count);
+				}else
+				{
+					std::memcpy(destination, source, count * 4);
+				}
+				return true;
+			}
+			if((sourceRGBA && destinationFormat==F::B8G8R8A8) || (sourceFormat==F::B8G8R8A8 && destinationRGBA))
+			{
+				SwizzleRB32(source, destination, count, destinationOpaque || sourceOpaque);
+				return true;
+			}
+			if((sourceFormat==F::R8G8B8 || sourceFormat==F::B8G8R8) && (destinationRGBA || destinationFormat==F::B8G8R8A8))
+			{
+				const bool sourceBGR = (sourceFormat==F::B8G8R8);
+				const bool destinationBGR = (destinationFormat==F::B8G8R8A8);
+				Expand24To32(source, destination, count, sourceBGR!=destinationBGR);
+				return true;
+			}
+			if((sourceRGBA || sourceFormat==F::B8G8R8A8) && (destinationFormat==F::R8G8B8 || destinationFormat==F::B8G8R8))
+			{
+				const bool sourceBGR = (sourceFormat==F::B8G8R8A8);
+				const bool destinationBGR = (destinationFormat==F::B8G8R8);
+				Pack32To24(source, destination, count, sourceBGR!=destinationBGR);
+				return true;
+			}
+			if((sourceFormat==F::R8G8B8 && destinationFormat==F::B8G8R8) || (sourceFormat==F::B8G8R8 && destinationFormat==F::R8G8B8))
+			{
+				for(Size i = 0; i < count; ++i)
+				{
+					destination[i * 3] = source[i * 3 + 2];
+					destination[i * 3 + 1] = source[i * 3 + 1];
+					destination[i * 3 + 2] = source[i * 3];
+				}
+				return true;
+			}
+			return false;
+		}
+
+		f32 SRGBToLinear(f32 value)
+		{
+			return (value <= 0.04045f) ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		f32 LinearToSRGB(f32 value)
+		{
+			value = std::min(std::max(value, 0.f), 1.f);
+			return (value <= 0.0031308f) ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+		}
+
+		struct SRGBTables
+		{
+			static const Size ENCODE_SIZE = 4096;
+			f32 mDecode[256];
+			u8 mEncode[ENCODE_SIZE];
+			SRGBTables()
+			{
+				for(Size i = 0; i < 256; ++i)
+				{
+					mDecode[i] = SRGBToLinear(i / 255.f);
+				}
+				for(Size i = 0; i < ENCODE_SIZE; ++i)
+				{
+					mEncode[i] = static_cast<u8>(Quantise(LinearToSRGB(i / static_cast<f32>(ENCODE_SIZE - 1)), 255));
+				}
+			}
+			inline u8 Encode(f32 linear) const
+			{
+				return mEncode[Quantise(linear, ENCODE_SIZE - 1)];
+			}
+		};
+
+		const SRGBTables& GetSRGBTables()
+		{
+			static SRGBTables tables;
+			return tables;
+		}
+
+		/**
+		 * Convert the colour channels of float RGBA pixels that were decoded from format to linear.
+		 */
+		void DecodeSRGB(f32* rgba, Size count, Texture::Format format)
+		{
+			if(IsEightBitPerChannel(format))
+			{
+				// The values are exact multiples of 1/255 so the table can be used.
+				const SRGBTables& tables = GetSRGBTables();
+				for(Size i = 0; i < count; ++i)
+				{
+					for(Size c = 0; c < 3; ++c)
+					{
+						f32& value = rgba[i * 4 + c];
+						value = tables.mDecode[Quantise(value, 255)];
+					}
+				}
+				return;
+			}
+			for(Size i = 0; i < count; ++i)
+			{
+				for(Size c = 0; c < 3; ++c)
+				{
+					f32& value = rgba[i * 4 + c];
+					value = SRGBToLinear(value);
+				}
+			}
+		}
+
+		void EncodeSRGB(f32* rgba, Size count, Texture::Format format)
+		{
+			if(IsEightBitPerChannel(format))
+			{
+				const SRGBTables& tables = GetSRGBTables();
+				for(Size i = 0; i < count; ++i)
+				{
+					for(Size c = 0; c < 3; ++c)
+					{
+						f32& value = rgba[i * 4 + c];
+						value = tables.Encode(value) / 255.f;
+					}
+				}
+				return;
+			}
+			for(Size i = 0; i < count; ++i)
+			{
+				for(Size c = 0; c < 3; ++c)
+				{
+					f32& value = rgba[i * 4 + c];
+					value = LinearToSRGB(value);
+				}
+			}
+		}
+
+		f64 BesselI0(f64 x)
+		{
+			// Power series, converges quickly for the range the Kaiser window uses.
+			f64 sum = 1.;
+			f64 term = 1.;
+			const f64 halfX = x * 0.5;
+			for(Size k = 1; k < 32; ++k)
+			{
+				term *= (halfX / static_cast<f64>(k)) * (halfX / static_cast<f64>(k));
+				sum += term;
+				if(term < sum * 1e-12)
+				{
+					break;
+				}
+			}
+			return sum;
+		}
+
+		f64 GetFilterSupport(TextureProcessor::Filter filter)
+		{
+			switch(filter)
+			{
+				case TextureProcessor::Filters::BOX:		return 0.5;
+				case TextureProcessor::Filters::TRIANGLE:	return 1.;
+				case TextureProcessor::Filters::KAISER:		return 3.;
+			}
+			return 1.;
+		}
+
+		f64 EvaluateFilter(TextureProcessor::Filter filter, f64 x)
+		{
+			switch(filter)
+			{
+				case TextureProcessor::Filters::BOX:
+					return (x >= -0.5 && x < 0.5) ? 1. : 0.;
+				case TextureProcessor::Filters::TRIANGLE:
+					return std::max(0., 1. - std::abs(x));
+				case TextureProcessor::Filters::KAISER:
+				{
+					const f64 width = 3.;
+					const f64 alpha = 4.;
+					const f64 t = x / width;
+					if(std::abs(t) >= 1.)
+					{
+						return 0.;
+					}
+					const f64 pi = 3.14159265358979323846;
+					const f64 sinc = (std::abs(x) < 1e-6) ? 1. : std::sin(pi * x) / (pi * x);
+					return sinc * BesselI0(alpha * std::sqrt(1. - t * t)) / BesselI0(alpha);
+				}
+			}
+			return 0.;
+		}
+
+		/**
+		 * The source pixels and weights that make up each destination pixel along one axis.
+		 */
+		struct FilterKernel
+		{
+			struct Contribution
+			{
+				Size mFirst;
+				Size mCount;
+				Size mWeights;
+			};
+			std::vector<Contribution> mContributions;
+			std::vector<f32> mWeights;
+
+			FilterKernel(Size sourceSize, Size destinationSize, TextureProcessor::Filter filter)
+			{
+				const f64 scale = static_cast<f64>(sourceSize) / static_cast<f64>(destinationSize);
+				const f64 filterScale = std::max(scale, 1.);
+				const f64 support = GetFilterSupport(filter) * filterScale;
+				mContributions.resize(destinationSize);
+				std::vector<f64> weights;
+				for(Size d = 0; d < destinationSize; ++d)
+				{
+					// Pixel centres are at +0.5.
+					const f64 centre = (static_cast<f64>(d) + 0.5) * scale;
+					const s64 first = std::max<s64>(static_cast<s64>(std::floor(centre - support - 0.5)), 0);
+					const s64 last = std::min<s64>(static_cast<s64>(std::ceil(centre + support - 0.5)), static_cast<s64>(sourceSize) - 1);
+					weights.clear();
+					f64 total = 0.;
+					for(s64 s = first; s <= last; ++s)
+					{
+						const f64 weight = EvaluateFilter(filter, (static_cast<f64>(s) + 0.5 - centre) / filterScale);
+						weights.push_back(weight);
+						total += weight;
+					}
+
+					Contribution& contribution = mContributions[d];
+					contribution.mWeights = mWeights.size();
+					if(total==0.)
+					{
+						// Can happen with the box filter when enlarging, take the nearest pixel.
+						contribution.mFirst = std::min(static_cast<Size>(centre), sourceSize - 1);
+						contribution.mCount = 1;
+						mWeights.push_back(1.f);
+						continue;
+					}
+
+					// Trim the zero weights at either end.
+					Size begin = 0;
+					Size end = weights.size();
+					while(begin < end && weights[begin]==0.)
+					{
+						++begin;
+					}
+					while(end > begin && weights[end - 1]==0.)
+					{
+						--end;
+					}
+					contribution.mFirst = static_cast<Size>(first) + begin;
+					contribution.mCount = end - begin;
+					for(Size w = begin; w < end; ++w)
+					{
+						mWeights.push_back(static_cast<f32>(weights[w] / total));
+					}
+				}
+			}
+		};
+
+		/**
+		 * Average 2x2 blocks of four byte pixels.
+		 */
+		void HalveRow32(const u8* row0, const u8* row1, u8* destination, Size destinationWidth)
+		{
+			Size x = 0;
+#ifdef ECHO_TEXTUREPROCESSOR_SSE2
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i rounding = _mm_set1_epi16(2);
+			for(; x + 4 <= destinationWidth; x += 4)
+			{
+				const u8* a = row0 + x * 8;
+				const u8* b = row1 + x * 8;
+				__m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+				__m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 16));
+				__m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+				__m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 16));
+
+				// Sum the rows in 16 bit, each register holds two pixels.
+				__m128i p01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+				__m128i p23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+				__m128i p45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+				__m128i p67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+				// Sum horizontal neighbours.
+				__m128i s0 = _mm_add_epi16(_mm_unpacklo_epi64(p01, p23), _mm_unpackhi_epi64(p01, p23));
+				__m128i s1 = _mm_add_epi16(_mm_unpacklo_epi64(p45, p67), _mm_unpackhi_epi64(p45, p67));
+				s0 = _mm_srli_epi16(_mm_add_epi16(s0, rounding), 2);
+				s1 = _mm_srli_epi16(_mm_add_epi16(s1, rounding), 2);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + x * 4), _mm_packus_epi16(s0, s1));
+			}
+#endif
+			for(; x < destinationWidth; ++x)
+			{
+				const u8* a = row0 + x * 8;
+				const u8* b = row1 + x * 8;
+				for(Size c = 0; c < 4; ++c)
+				{
+					destination[x * 4 + c] = static_cast<u8>((a[c] + a[c + 4] + b[c] + b[c + 4] + 2) >> 2);
+				}
+			}
+		}
+
+		/**
+		 * Average 2x2 blocks of four byte pixels in linear space. The colour channels are treated the same so this
+		 * works for RGBA and BGRA.
+		 */
+		void HalveRow32SRGB(const u8* row0, const u8* row1, u8* destination, Size destinationWidth)
+		{
+			const SRGBTables& tables = GetSRGBTables();
+			for(Size x = 0; x < destinationWidth; ++x)
+			{
+				const u8* a = row0 + x * 8;
+				const u8* b = row1 + x * 8;
+				for(Size c = 0; c < 3; ++c)
+				{
+					const f32 linear = (tables.mDecode[a[c]] + tables.mDecode[a[c + 4]] + tables.mDecode[b[c]] + tables.mDecode[b[c + 4]]) * 0.25f;
+					destination[x * 4 + c] = tables.Encode(linear);
+				}
+				destination[x * 4 + 3] = static_cast<u8>((a[3] + a[7] + b[3] + b[7] + 2) >> 2);
+			}
+		}
+	}
+
+	TextureProcessor::TextureProcessor(shared_ptr<WorkerPool> workerPool, Size rowsPerJob) :
+		mWorkerPool(workerPool),
+		mRowsPerJob(std::max<Size>(rowsPerJob, 1))
+	{
+	}
+
+	TextureProcessor::~TextureProcessor()
+	{
+	}
+
+	bool TextureProcessor::GetFormatSupported(Texture::Format format)
+	{
+		switch(format)
+		{
+			case Texture::Formats::UNKNOWN:
+			case Texture::Formats::DEPTH16:
+			case Texture::Formats::DEPTH24:
+			case Texture::Formats::DEPTH32:
+			case Texture::Formats::DEPTH24_STENCIL8:
+				return false;
+			default:
+				break;
+		}
+		return true;
+	}
+
+	void TextureProcessor::ForEach(Size count, Size grainSize, RangeFunction rangeFunction) const
+	{
+		if(mWorkerPool && count > grainSize)
+		{
+			mWorkerPool->ParallelFor(0, count, grainSize, rangeFunction);
+		}else
+		{
+			rangeFunction(0, count);
+		}
+	}
+
+	bool TextureProcessor::ConvertPixels(const u8* source, Texture::Format sourceFormat, u8* destination, Texture::Format destinationFormat, Size numberOfPixels)
+	{
+		if(!GetFormatSupported(sourceFormat) || !GetFormatSupported(destinationFormat))
+		{
+			return false;
+		}
+		if(sourceFormat==destinationFormat)
+		{
+			std::memcpy(destination, source, numberOfPixels * Texture::Formats::GetBytesPerPixel(sourceFormat));
+			return true;
+		}
+		if(ConvertDirect(source, sourceFormat, destination, destinationFormat, numberOfPixels))
+		{
+			return true;
+		}
+
+		const Size sourceBytesPerPixel = Texture::Formats::GetBytesPerPixel(sourceFormat);
+		const Size destinationBytesPerPixel = Texture::Formats::GetBytesPerPixel(destinationFormat);
+		f32 rgba[BLOCK_SIZE * 4];
+		for(Size i = 0; i < numberOfPixels; i += BLOCK_SIZE)
+		{
+			const Size count = std::min(BLOCK_SIZE, numberOfPixels - i);
+			DecodePixels(source + i * sourceBytesPerPixel, sourceFormat, rgba, count);
+			EncodePixels(rgba, destinationFormat, destination + i * destinationBytesPerPixel, count);
+		}
+		return true;
+	}
+
+	shared_ptr<Texture> TextureProcessor::Convert(const Texture& source, Texture::Format format) const
+	{
+		if(!source.GetBuffer() || !GetFormatSupported(source.GetFormat()) || !GetFormatSupported(format))
+		{
+			ECHO_LOG_ERROR("TextureProcessor: Cannot convert from " << source.GetFormat() << " to " << format);
+			return nullptr;
+		}
+		shared_ptr<Texture> destination(new Texture(source.GetWidth(), source.GetHeight(), format));
+		const u8* sourceBuffer = source.GetBuffer().get();
+		u8* destinationBuffer = destination->GetBuffer().get();
+		const Size sourceStride = source.GetWidth() * source.GetBytesPerPixel();
+		const Size destinationStride = destination->GetWidth() * destination->GetBytesPerPixel();
+		const Size width = source.GetWidth();
+		const Texture::Format sourceFormat = source.GetFormat();
+		ForEach(source.GetHeight(), mRowsPerJob, [=](Size begin, Size end)
+		{
+			// Rows are contiguous so each range can be converted in one go.
+			ConvertPixels(sourceBuffer + begin * sourceStride, sourceFormat, destinationBuffer + begin * destinationStride, format, (end - begin) * width);
+		});
+		return destination;
+	}
+
+	shared_ptr<Texture> TextureProcessor::Resize(const Texture& source, u32 width, u32 height, Filter filter, bool sRGB) const
+	{
+		if(!source.GetBuffer() || !GetFormatSupported(source.GetFormat()) || width==0 || height==0 || source.GetWidth()==0 || source.GetHeight()==0)
+		{
+			ECHO_LOG_ERROR("TextureProcessor: Cannot resize " << source.GetWidth() << "x" << source.GetHeight() << " " << source.GetFormat() << " to " << width << "x" << height);
+			return nullptr;
+		}
+		if(width==source.GetWidth() && height==source.GetHeight())
+		{
+			return source.Clone();
+		}
+
+		const Texture::Format format = source.GetFormat();
+		const Size sourceWidth = source.GetWidth();
+		const Size sourceHeight = source.GetHeight();
+		const Size bytesPerPixel = source.GetBytesPerPixel();
+		const FilterKernel horizontalKernel(sourceWidth, width, filter);
+		const FilterKernel verticalKernel(sourceHeight, height, filter);
+
+		// Filter horizontally into float RGBA then vertically into the destination.
+		std::vector<f32> intermediate(static_cast<Size>(width) * sourceHeight * 4);
+		const u8* sourceBuffer = source.GetBuffer().get();
+		ForEach(sourceHeight, mRowsPerJob, [&](Size begin, Size end)
+		{
+			std::vector<f32> row(sourceWidth * 4);
+			for(Size y = begin; y < end; ++y)
+			{
+				DecodePixels(sourceBuffer + y * sourceWidth * bytesPerPixel, format, row.data(), sourceWidth);
+				if(sRGB)
+				{
+					DecodeSRGB(row.data(), sourceWidth, format);
+				}
+				f32* out = &intermediate[y * width * 4];
+				for(Size x = 0; x < width; ++x)
+				{
+					const FilterKernel::Contribution& contribution = horizontalKernel.mContributions[x];
+					const f32* weights = &horizontalKernel.mWeights[contribution.mWeights];
+					const f32* in = &row[contribution.mFirst * 4];
+					f32 sum[4] = {0.f, 0.f, 0.f, 0.f};
+					for(Size i = 0; i < contribution.mCount; ++i)
+					{
+						for(Size c = 0; c < 4; ++c)
+						{
+							sum[c] += in[i * 4 + c] * weights[i];
+						}
+					}
+					std::memcpy(out + x * 4, sum, sizeof(sum));
+				}
+			}
+		});
+
+		shared_ptr<Texture> destination(new Texture(width, height, format));
+		u8* destinationBuffer = destination->GetBuffer().get();
+		ForEach(height, mRowsPerJob, [&](Size begin, Size end)
+		{
+			std::vector<f32> row(width * 4);
+			for(Size y = begin; y < end; ++y)
+			{
+				const FilterKernel::Contribution& contribution = verticalKernel.mContributions[y];
+				const f32* weights = &verticalKernel.mWeights[contribution.mWeights];
+				std::fill(row.begin(), row.end(), 0.f);
+				for(Size i = 0; i < contribution.mCount; ++i)
+				{
+					const f32* in = &intermediate[(contribution.mFirst + i) * width * 4];
+					const f32 weight = weights[i];
+					for(Size v = 0; v < width * 4; ++v)
+					{
+						row[v] += in[v] * weight;
+					}
+				}
+				if(sRGB)
+				{
+					EncodeSRGB(row.data(), width, format);
+				}
+				EncodePixels(row.data(), format, destinationBuffer + y * width * bytesPerPixel, width);
+			}
+		});
+		return destination;
+	}
+
+	shared_ptr<Texture> TextureProcessor::HalveBox(const Texture& source, bool sRGB) const
+	{
+		const Texture::Format format = source.GetFormat();
+		const bool fourByte = (format==Texture::Formats::R8G8B8A8 || format==Texture::Formats::R8G8B8X8 || format==Texture::Formats::B8G8R8A8);
+		const u32 width = std::max<u32>(source.GetWidth() / 2, 1);
+		const u32 height = std::max<u32>(source.GetHeight() / 2, 1);
+		if(!fourByte || (source.GetWidth() % 2)!=0 || (source.GetHeight() % 2)!=0)
+		{
+			return Resize(source, width, height, Filters::BOX, sRGB);
+		}
+
+		shared_ptr<Texture> destination(new Texture(width, height, format));
+		const u8* sourceBuffer = source.GetBuffer().get();
+		u8* destinationBuffer = destination->GetBuffer().get();
+		const Size sourceStride = source.GetWidth() * 4;
+		const Size destinationStride = static_cast<Size>(width) * 4;
+		ForEach(height, mRowsPerJob, [=](Size begin, Size end)
+		{
+			for(Size y = begin; y < end; ++y)
+			{
+				const u8* row0 = sourceBuffer + y * 2 * sourceStride;
+				const u8* row1 = row0 + sourceStride;
+				if(sRGB)
+				{
+					HalveRow32SRGB(row0, row1, destinationBuffer + y * destinationStride, width);
+				}else
+				{
+					HalveRow32(row0, row1, destinationBuffer + y * destinationStride, width);
+				}
+			}
+		});
+		return destination;
+	}
+
+	Size TextureProcessor::GetNumberOfMipmapLevels(u32 width, u32 height)
+	{
+		Size levels = 1;
+		u32 size = std::max(width, height);
+		while(size > 1)
+		{
+			size /= 2;
+			++levels;
+		}
+		return levels;
+	}
+
+	std::vector< shared_ptr<Texture> > TextureProcessor::GenerateMipmaps(const Texture& source, Filter filter, bool sRGB, Size maximumLevels) const
+	{
+		std::vector< shared_ptr<Texture> > levels;
+		if(!source.GetBuffer() || !GetFormatSupported(source.GetFormat()) || source.GetWidth()==0 || source.GetHeight()==0)
+		{
+			ECHO_LOG_ERROR("TextureProcessor: Cannot generate mipmaps for " << source.GetWidth() << "x" << source.GetHeight() << " " << source.GetFormat());
+			return levels;
+		}
+		Size numberOfLevels = GetNumberOfMipmapLevels(source.GetWidth(), source.GetHeight()) - 1;
+		if(maximumLevels > 0)
+		{
+			numberOfLevels = std::min(numberOfLevels, maximumLevels);
+		}
+		levels.resize(numberOfLevels);
+
+		// Filtering each level from the source would need a kernel twice as wide for each level, so each level is
+		// filtered from the previous one.
+		const Texture* previous = &source;
+		for(Size level = 0; level < numberOfLevels; ++level)
+		{
+			if(filter==Filters::BOX)
+			{
+				levels[level] = HalveBox(*previous, sRGB);
+			}else
+			{
+				const u32 width = std::max<u32>(previous->GetWidth() / 2, 1);
+				const u32 height = std::max<u32>(previous->GetHeight() / 2, 1);
+				levels[level] = Resize(*previous, width, height, filter, sRGB);
+			}
+			previous = levels[level].get();
+		}
+		return levels;
+	}
+}
@@ -0,0 +1,251 @@
+#include <echo/Graphics/TransformHierarchy.h>
+#include <echo/Graphics/Node.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Kernel/ScopedLock.h>
+#include <algorithm>
+
+namespace Echo
+{
+	TransformHierarchy::TransformHierarchy(shared_ptr<WorkerPool> workerPool, Size nodesPerJob) :
+		mWorkerPool(workerPool),
+		mNodesPerJob(std::max<Size>(nodesPerJob, 1)),
+		mStructureOutOfDate(false),
+		mOutOfDate(false)
+	{
+	}
+
+	TransformHierarchy::~TransformHierarchy()
+	{
+		for(Node* root : mRoots)
+		{
+			SetHierarchy(*root, nullptr);
+		}
+	}
+
+	void TransformHierarchy::AddRoot(Node& node)
+	{
+		if(node.mTransformHierarchy==this)
+		{
+			return;
+		}
+		if(node.mTransformHierarchy)
+		{
+			if(!node.mTransformHierarchy->RemoveRoot(node))
+			{
+				// The node has a parent in another hierarchy.
+				node.SetParent(0);
+			}
+		}
+		ScopedLock lock(mMutex);
+		mRoots.push_back(&node);
+		SetHierarchy(node, this);
+		mStructureOutOfDate = true;
+		mOutOfDate.store(true, std::memory_order_release);
+	}
+
+	bool TransformHierarchy::RemoveRoot(Node& node)
+	{
+		ScopedLock lock(mMutex);
+		std::vector<Node*>::iterator it = std::find(mRoots.begin(), mRoots.end(), &node);
+		if(it==mRoots.end())
+		{
+			return false;
+		}
+		mRoots.erase(it);
+		SetHierarchy(node, nullptr);
+		mStructureOutOfDate = true;
+		mOutOfDate.store(true, std::memory_order_release);
+		return true;
+	}
+
+	void TransformHierarchy::AttachSubtree(Node& node)
+	{
+		if(node.mTransformHierarchy && node.mTransformHierarchy!=this)
+		{
+			node.mTransformHierarchy->RemoveRoot(node);
+		}
+		ScopedLock lock(mMutex);
+		// A root of this hierarchy can become a child of another node in the hierarchy.
+		std::vector<Node*>::iterator it = std::find(mRoots.begin(), mRoots.end(), &node);
+		if(it!=mRoots.end())
+		{
+			mRoots.erase(it);
+		}
+		SetHierarchy(node, this);
+		mStructureOutOfDate = true;
+		mOutOfDate.store(true, std::memory_order_release);
+	}
+
+	void TransformHierarchy::DetachSubtree(Node& node)
+	{
+		ScopedLock lock(mMutex);
+		SetHierarchy(node, nullptr);
+		mStructureOutOfDate = true;
+		mOutOfDate.store(true, std::memory_order_release);
+	}
+
+	void TransformHierarchy::SetHierarchy(Node& node, TransformHierarchy* hierarchy)
+	{
+		node.mTransformHierarchy = hierarchy;
+		node.mTransformHierarchyIndex = 0;
+		// The node's own cached values were not maintained while it was in a hierarchy.
+		node.mDerivedPropertiesOutOfDate = true;
+		node.mTransformOutOfDate = true;
+		node.mNeedChildUpdate = true;
+		for(Node* child : node.mChildNodes)
+		{
+			SetHierarchy(*child, hierarchy);
+		}
+	}
+
+	void TransformHierarchy::NodeChanged(const Node& node)
+	{
+		// Waits for an update in progress so the arrays aren't modified while they are being read.
+		ScopedLock lock(mMutex);
+		if(!mStructureOutOfDate)
+		{
+			Size index = node.mTransformHierarchyIndex;
+			CopyLocalProperties(index);
+			mDirty[index] = 1;
+		}
+		mOutOfDate.store(true, std::memory_order_release);
+	}
+
+	void TransformHierarchy::CopyLocalProperties(Size index)
+	{
+		const Node& node = *mNodes[index];
+		mPositions[index] = node.mPosition;
+		mOrientations[index] = node.mOrientation;
+		mScales[index] = node.mScale;
+		mInheritFlags[index] = (node.mInheritOrientation ? INHERIT_ORIENTATION : 0) | (node.mInheritScale ? INHERIT_SCALE : 0);
+	}
+
+	void TransformHierarchy::Rebuild()
+	{
+		mNodes.clear();
+		mParents.clear();
+		mLevelStarts.clear();
+
+		// Breadth first traversal so each level is contiguous and parents are always before their children.
+		for(Node* root : mRoots)
+		{
+			mParents.push_back(mNodes.size());
+			mNodes.push_back(root);
+		}
+		Size levelBegin = 0;
+		while(levelBegin < mNodes.size())
+		{
+			mLevelStarts.push_back(levelBegin);
+			Size levelEnd = mNodes.size();
+			for(Size i = levelBegin; i < levelEnd; ++i)
+			{
+				for(Node* child : mNodes[i]->mChildNodes)
+				{
+					mParents.push_back(i);
+					mNodes.push_back(child);
+				}
+			}
+			levelBegin = levelEnd;
+		}
+		mLevelStarts.push_back(mNodes.size());
+
+		Size numberOfNodes = mNodes.size();
+		mPositions.resize(numberOfNodes);
+		mOrientations.resize(numberOfNodes);
+		mScales.resize(numberOfNodes);
+		mInheritFlags.resize(numberOfNodes);
+		mDerivedPositions.resize(numberOfNodes);
+		mDerivedOrientations.resize(numberOfNodes);
+		mDerivedScales.resize(numberOfNodes);
+		mTransforms.resize(numberOfNodes);
+		mDirty.assign(numberOfNodes, 1);
+		for(Size i = 0; i < numberOfNodes; ++i)
+		{
+			mNodes[i]->mTransformHierarchyIndex = i;
+			CopyLocalProperties(i);
+		}
+		mStructureOutOfDate = false;
+	}
+
+	void TransformHierarchy::Update()
+	{
+		ScopedLock lock(mMutex);
+		if(mStructureOutOfDate)
+		{
+			Rebuild();
+		}
+		if(!mOutOfDate.load(std::memory_order_acquire))
+		{
+			// Another thread updated while we were waiting.
+			return;
+		}
+
+		// The root level is level 0.
+		Size numberOfLevels = mLevelStarts.empty() ? 0 : mLevelStarts.size() - 1;
+		for(Size level = 0; level < numberOfLevels; ++level)
+		{
+			Size begin = mLevelStarts[level];
+			Size end = mLevelStarts[level + 1];
+			if(mWorkerPool && (end - begin) > mNodesPerJob)
+			{
+				mWorkerPool->ParallelFor(begin, end, mNodesPerJob, [this](Size rangeBegin, Size rangeEnd)
+				{
+					UpdateRange(rangeBegin, rangeEnd);
+				});
+			}else
+			{
+				UpdateRange(begin, end);
+			}
+		}
+		// The flags can't be cleared during the level passes because children read their parent's flag.
+		std::fill(mDirty.begin(), mDirty.end(), 0);
+		mOutOfDate.store(false, std::memory_order_release);
+	}
+
+	void TransformHierarchy::UpdateRange(Size begin, Size end)
+	{
+		for(Size i = begin; i < end; ++i)
+		{
+			const Size parent = mParents[i];
+			mDirty[i] |= mDirty[parent];
+			if(!mDirty[i])
+			{
+				continue;
+			}
+			if(parent==i)
+			{
+				mDerivedOrientations[i] = mOrientations[i];
+				mDerivedPositions[i] = mPositions[i];
+				mDerivedScales[i] = mScales[i];
+			}else
+			{
+				const Quaternion& parentOrientation = mDerivedOrientations[parent];
+				const Vector3& parentScale = mDerivedScales[parent];
+				mDerivedOrientations[i] = (mInheritFlags[i] & INHERIT_ORIENTATION) ? parentOrientation * mOrientations[i] : mOrientations[i];
+				mDerivedScales[i] = (mInheritFlags[i] & INHERIT_SCALE) ? parentScale * mScales[i] : mScales[i];
+				mDerivedPositions[i] = parentOrientation * (mPositions[i] * parentScale) + mDerivedPositions[parent];
+			}
+			mTransforms[i].MakeTransform(mDerivedPositions[i], mDerivedScales[i], mDerivedOrientations[i]);
+		}
+	}
+
+	Size TransformHierarchy::GetNumberOfNodes()
+	{
+		ScopedLock lock(mMutex);
+		if(mStructureOutOfDate)
+		{
+			Rebuild();
+		}
+		return mNodes.size();
+	}
+
+	Size TransformHierarchy::GetNumberOfLevels()
+	{
+		ScopedLock lock(mMutex);
+		if(mStructureOutOfDate)
+		{
+			Rebuild();
+		}
+		return mLevelStarts.empty() ? 0 : mLevelStarts.size() - 1;
+	}
+}
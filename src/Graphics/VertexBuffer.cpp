@@ -10,6 +10,7 @@ namespace Echo
 		mNumberOfElements(0),
 		mCapacity(0)
 	{
+		mLayout = VertexLayout::Create(mVertexAttributes, mNamedAttributes);
 	}
 
 	VertexBuffer::~VertexBuffer()
@@ -23,6 +24,7 @@ namespace Echo
 		mStride = rhs.mStride;
 		mVertexAttributes = rhs.mVertexAttributes;
 		mNamedAttributes = rhs.mNamedAttributes;
+		mLayout = rhs.mLayout;
 		mNumberOfElements = rhs.mNumberOfElements;
 		mCapacity = rhs.mCapacity;
 		if(rhs.mDataSize!=0)
@@ -43,6 +45,7 @@ namespace Echo
 		mStride = rhs.mStride;
 		mVertexAttributes = rhs.mVertexAttributes;
 		mNamedAttributes = rhs.mNamedAttributes;
+		mLayout = rhs.mLayout;
 		mNumberOfElements = rhs.mNumberOfElements;
 		mCapacity = rhs.mCapacity;
 		mDataSize = rhs.mDataSize;
@@ -61,6 +64,7 @@ namespace Echo
 		mStride = rhs.mStride;
 		mVertexAttributes = rhs.mVertexAttributes;
 		mNamedAttributes = rhs.mNamedAttributes;
+		mLayout = rhs.mLayout;
 		mNumberOfElements = rhs.mNumberOfElements;
 		mCapacity = rhs.mCapacity;
 		delete [] mData;
@@ -87,6 +91,7 @@ namespace Echo
 		mStride = rhs.mStride;
 		mVertexAttributes = rhs.mVertexAttributes;
 		mNamedAttributes = rhs.mNamedAttributes;
+		mLayout = rhs.mLayout;
 		mNumberOfElements = rhs.mNumberOfElements;
 		mCapacity = rhs.mCapacity;
 		delete [] mData;
@@ -108,14 +113,16 @@ namespace Echo
 		mStride+=vertexAttribute.GetWidth();
 		Size position = mVertexAttributes.size();
 		mVertexAttributes.push_back(vertexAttribute);
+		// Built here rather than on demand so GetLayout() doesn't modify the buffer.
+		mLayout = VertexLayout::Create(mVertexAttributes, mNamedAttributes);
 		return position;
 	}
 
 	Size VertexBuffer::AddVertexAttribute(std::string name, VertexAttribute vertexAttribute)
 	{
-		Size position = AddVertexAttribute(std::move(vertexAttribute));
-		mNamedAttributes.insert(std::make_pair(std::move(name), position));
-		return position;
+		// The name is added first so the layout is only built once.
+		mNamedAttributes.insert(std::make_pair(std::move(name), mVertexAttributes.size()));
+		return AddVertexAttribute(std::move(vertexAttribute));
 	}
 	
 	bool VertexBuffer::Allocate(Size numberOfVertices)
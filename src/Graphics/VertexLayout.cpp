@@ -0,0 +1,165 @@
+#include <echo/Graphics/VertexLayout.h>
+#include <echo/Kernel/Mutex.h>
+#include <echo/Kernel/ScopedLock.h>
+#include <unordered_map>
+#include <functional>
+#include <cctype>
+#include <cstdlib>
+
+namespace Echo
+{
+	namespace
+	{
+		inline void CombineHash(Size& seed, Size value)
+		{
+			seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		}
+
+		/**
+		 * Get the texture coordinate set from an attribute name in the form "UV<set>".
+		 * @return true if the name is a texture coordinate set name.
+		 */
+		bool GetTextureCoordinateSet(const std::string& name, Size& set)
+		{
+			if(name.size() < 3 || name[0]!='U' || name[1]!='V')
+			{
+				return false;
+			}
+			for(Size i = 2; i < name.size(); ++i)
+			{
+				if(!std::isdigit(static_cast<unsigned char>(name[i])))
+				{
+					return false;
+				}
+			}
+			set = std::strtoul(name.c_str() + 2, nullptr, 10);
+			return true;
+		}
+
+		/**
+		 * Layouts that are in use, keyed by hash.
+		 * The registry does not keep layouts alive, expired entries are removed as they are found.
+		 */
+		struct LayoutRegistry
+		{
+			Mutex mMutex;
+			std::unordered_multimap< Size, weak_ptr<const VertexLayout> > mLayouts;
+		};
+
+		LayoutRegistry& GetRegistry()
+		{
+			static LayoutRegistry registry;
+			return registry;
+		}
+	}
+
+	shared_ptr<const VertexLayout> VertexLayout::Create(const std::vector< VertexAttribute >& attributes, const std::map< std::string, Size >& namedAttributes)
+	{
+		shared_ptr<const VertexLayout> layout(new VertexLayout(attributes, namedAttributes));
+		LayoutRegistry& registry = GetRegistry();
+		ScopedLock lock(registry.mMutex);
+		auto range = registry.mLayouts.equal_range(layout->GetHash());
+		auto it = range.first;
+		while(it!=range.second)
+		{
+			shared_ptr<const VertexLayout> existing = it->second.lock();
+			if(!existing)
+			{
+				it = registry.mLayouts.erase(it);
+				continue;
+			}
+			if(*existing==*layout)
+			{
+				return existing;
+			}
+			++it;
+		}
+		registry.mLayouts.insert(std::make_pair(layout->GetHash(), weak_ptr<const VertexLayout>(layout)));
+		return layout;
+	}
+
+	VertexLayout::VertexLayout(const std::vector< VertexAttribute >& attributes, const std::map< std::string, Size >& namedAttributes) :
+		mAttributes(attributes),
+		mNamedAttributes(namedAttributes),
+		mStride(0),
+		mHash(0)
+	{
+		for(const VertexAttribute& attribute : mAttributes)
+		{
+			mStride += attribute.GetWidth();
+			CombineHash(mHash, attribute.GetComponentType());
+			CombineHash(mHash, attribute.GetNumberOfComponents());
+			CombineHash(mHash, attribute.GetOffset());
+			CombineHash(mHash, attribute.GetNormalise() ? 1 : 0);
+		}
+
+		std::hash<std::string> hashString;
+		for(auto& namedAttribute : mNamedAttributes)
+		{
+			CombineHash(mHash, hashString(namedAttribute.first));
+			CombineHash(mHash, namedAttribute.second);
+			if(namedAttribute.second >= mAttributes.size())
+			{
+				ECHO_LOG_ERROR("VertexLayout attribute \"" << namedAttribute.first << "\" index out of range " << namedAttribute.second << " >= " << mAttributes.size());
+				continue;
+			}
+			Slot slot(static_cast<s32>(namedAttribute.second), mAttributes[namedAttribute.second].GetOffset());
+			Size set;
+			if(namedAttribute.first=="Position")
+			{
+				mPosition = slot;
+			}else
+			if(namedAttribute.first=="Normal")
+			{
+				mNormal = slot;
+			}else
+			if(namedAttribute.first=="Colour")
+			{
+				mColour = slot;
+			}else
+			if(GetTextureCoordinateSet(namedAttribute.first, set))
+			{
+				if(set >= mTextureCoordinates.size())
+				{
+					mTextureCoordinates.resize(set + 1);
+				}
+				mTextureCoordinates[set] = slot;
+			}
+		}
+	}
+
+	VertexLayout::~VertexLayout()
+	{
+	}
+
+	VertexLayout::Slot VertexLayout::FindSlot(const std::string& name) const
+	{
+		std::map< std::string, Size >::const_iterator it = mNamedAttributes.find(name);
+		if(it==mNamedAttributes.end() || it->second >= mAttributes.size())
+		{
+			return Slot();
+		}
+		return Slot(static_cast<s32>(it->second), mAttributes[it->second].GetOffset());
+	}
+
+	bool VertexLayout::operator==(const VertexLayout& rhs) const
+	{
+		if(mHash!=rhs.mHash || mStride!=rhs.mStride || mAttributes.size()!=rhs.mAttributes.size() || mNamedAttributes!=rhs.mNamedAttributes)
+		{
+			return false;
+		}
+		for(Size i = 0; i < mAttributes.size(); ++i)
+		{
+			const VertexAttribute& a = mAttributes[i];
+			const VertexAttribute& b = rhs.mAttributes[i];
+			if(a.GetComponentType()!=b.GetComponentType() ||
+				a.GetNumberOfComponents()!=b.GetNumberOfComponents() ||
+				a.GetOffset()!=b.GetOffset() ||
+				a.GetNormalise()!=b.GetNormalise())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,111 @@
+#include <echo/Kernel/JobGraph.h>
+
+namespace Echo
+{
+	JobGraph::JobGraph() : mValidated(true)
+	{
+	}
+
+	JobGraph::~JobGraph()
+	{
+	}
+
+	JobGraph::JobID JobGraph::AddJob(WorkerPool::Job job)
+	{
+		mNodes.push_back(unique_ptr<Node>(new Node(job)));
+		return mNodes.size()-1;
+	}
+
+	bool JobGraph::AddDependency(JobID job, JobID dependency)
+	{
+		if(job >= mNodes.size() || dependency >= mNodes.size() || job==dependency)
+		{
+			ECHO_LOG_ERROR("Invalid dependency " << job << " on " << dependency);
+			return false;
+		}
+		mNodes[dependency]->mDependents.push_back(job);
+		mNodes[job]->mNumberOfDependencies++;
+		mValidated = false;
+		return true;
+	}
+
+	void JobGraph::Clear()
+	{
+		mNodes.clear();
+		mValidated = true;
+	}
+
+	bool JobGraph::HasCycle() const
+	{
+		// Kahn's algorithm, if not every node can be visited then there is a cycle.
+		std::vector<Size> remaining(mNodes.size());
+		std::vector<JobID> ready;
+		for(JobID id = 0; id < mNodes.size(); ++id)
+		{
+			remaining[id] = mNodes[id]->mNumberOfDependencies;
+			if(remaining[id]==0)
+			{
+				ready.push_back(id);
+			}
+		}
+		Size visited = 0;
+		while(!ready.empty())
+		{
+			JobID id = ready.back();
+			ready.pop_back();
+			++visited;
+			for(JobID dependent : mNodes[id]->mDependents)
+			{
+				if(--remaining[dependent]==0)
+				{
+					ready.push_back(dependent);
+				}
+			}
+		}
+		return visited!=mNodes.size();
+	}
+
+	bool JobGraph::Execute(WorkerPool& workerPool)
+	{
+		if(!mValidated)
+		{
+			if(HasCycle())
+			{
+				ECHO_LOG_ERROR("JobGraph contains a dependency cycle and cannot be executed");
+				return false;
+			}
+			mValidated = true;
+		}
+		for(unique_ptr<Node>& node : mNodes)
+		{
+			node->mRemainingDependencies.store(node->mNumberOfDependencies, std::memory_order_relaxed);
+		}
+		WorkerPool::Counter counter;
+		for(JobID id = 0; id < mNodes.size(); ++id)
+		{
+			if(mNodes[id]->mNumberOfDependencies==0)
+			{
+				ScheduleJob(workerPool, id, counter);
+			}
+		}
+		workerPool.Wait(counter);
+		return true;
+	}
+
+	void JobGraph::ScheduleJob(WorkerPool& workerPool, JobID job, WorkerPool::Counter& counter)
+	{
+		workerPool.Schedule([this,&workerPool,job,&counter]()
+		{
+			Node& node = *mNodes[job];
+			node.mJob();
+			// Dependents are scheduled before this job is marked as complete so the counter can't reach zero early.
+			for(JobID dependent : node.mDependents)
+			{
+				if(mNodes[dependent]->mRemainingDependencies.fetch_sub(1, std::memory_order_acq_rel)==1)
+				{
+					ScheduleJob(workerPool, dependent, counter);
+				}
+			}
+		}, counter);
+	}
+}
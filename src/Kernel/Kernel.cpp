@@ -1,6 +1,7 @@
 #include <echo/Kernel/Kernel.h>
 #include <echo/Kernel/TaskThread.h>
 #include <echo/Kernel/ExecutionModel.h>
+#include <echo/Kernel/WorkerPool.h>
 
 #include <iostream>
 #include <algorithm>
@@ -141,6 +142,16 @@ namespace Echo
 		}
 	}
 	
+	void Kernel::SetNumberOfWorkerThreads(Size numberOfWorkerThreads)
+	{
+		if(numberOfWorkerThreads==0)
+		{
+			SetWorkerPool(nullptr);
+			return;
+		}
+		SetWorkerPool(make_shared<WorkerPool>(numberOfWorkerThreads, GetTaskManagerName() + "Worker"));
+	}
+
 	void Kernel::Stop()
 	{
 		TaskManager::RemoveAllTasks();
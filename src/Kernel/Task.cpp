@@ -10,6 +10,7 @@ namespace Echo
 		mHasStarted(false),
 		mPausable(true),
 		mPaused(false),
+		mParallelSafe(false),
 		mPriority(priority),
 		mTaskName(""),
 		mManagers()
@@ -20,6 +21,7 @@ namespace Echo
 		mHasStarted(false),
 		mPausable(true),
 		mPaused(false),
+		mParallelSafe(false),
 		mPriority(priority),
 		mTaskName(taskName),
 		mManagers()
@@ -31,6 +33,7 @@ namespace Echo
 		mHasStarted(other.mHasStarted),
 		mPausable(other.mPausable),
 		mPaused(other.mPaused),
+		mParallelSafe(other.mParallelSafe),
 		mPriority(other.mPriority),
 		mTaskName(other.mTaskName),
 		mManagers(other.mManagers)
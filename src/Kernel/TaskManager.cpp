@@ -1,7 +1,10 @@
 #include <echo/Kernel/TaskManager.h>
 #include <echo/Kernel/Task.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Kernel/ScopedLock.h>
 #include <boost/foreach.hpp>
 #include <iostream>
+#include <sstream>
 #include <algorithm>
 
 namespace Echo
@@ -463,6 +466,20 @@ namespace Echo
 			Task* task = taskInfo.GetTask();
 			if(task)
 			{
+				if(mWorkerPool && task->GetParallelSafe())
+				{
+					// Parallel safe tasks are collected until the priority changes.
+					if(!mParallelTasks.empty() && mParallelTasks.front()->GetPriority()!=task->GetPriority())
+					{
+						UpdateParallelTasks(mParallelTasks, lastFrameTime);
+					}
+					mParallelTasks.push_back(task);
+					continue;
+				}
+				if(!mParallelTasks.empty())
+				{
+					UpdateParallelTasks(mParallelTasks, lastFrameTime);
+				}
 				task->Update(lastFrameTime);
 				if(mProfilingEnabled)
 				{
@@ -470,6 +487,10 @@ namespace Echo
 				}
 			}
 		}
+		if(!mParallelTasks.empty())
+		{
+			UpdateParallelTasks(mParallelTasks, lastFrameTime);
+		}
 		mUpdating = false;
 		if(mProfilingEnabled)
 		{
@@ -481,9 +502,14 @@ namespace Echo
 				mProfilerAveragerCurrentTime = Seconds(0);
 			}
 		}
-		if(!mPostUpdateActions.empty())
+		std::vector<Action> actions;
+		{
+			ScopedLock lock(mPostUpdateActionsMutex);
+			actions = std::move(mPostUpdateActions);
+			mPostUpdateActions.clear();
+		}
+		if(!actions.empty())
 		{
-			std::vector<Action> actions = std::move(mPostUpdateActions);
 			for(Action& action : actions)
 			{
 				action();
@@ -492,6 +518,38 @@ namespace Echo
 		UpdateLists();
 	}
 
+	void TaskManager::UpdateParallelTasks(std::vector<Task*>& tasks, Seconds lastFrameTime)
+	{
+		if(tasks.size()==1)
+		{
+			tasks.front()->Update(lastFrameTime);
+		}else
+		{
+			WorkerPool::Counter counter;
+			for(Size i=1; i < tasks.size(); ++i)
+			{
+				Task* task = tasks[i];
+				mWorkerPool->Schedule([task,lastFrameTime](){task->Update(lastFrameTime);}, counter);
+			}
+			// The calling thread takes the first task then helps out until all have completed.
+			tasks.front()->Update(lastFrameTime);
+			mWorkerPool->Wait(counter);
+		}
+		if(mProfilingEnabled)
+		{
+			if(tasks.size()==1)
+			{
+				mProfiler.SaveCheckpoint(tasks.front()->GetTaskName());
+			}else
+			{
+				std::stringstream checkpointName;
+				checkpointName << "Parallel(" << tasks.size() << ") priority " << tasks.front()->GetPriority();
+				mProfiler.SaveCheckpoint(checkpointName.str());
+			}
+		}
+		tasks.clear();
+	}
+
 	void TaskManager::UpdateLists()
 	{
 		TaskListIterator it = mTaskList.begin();
@@ -609,6 +667,7 @@ namespace Echo
 	void TaskManager::QueuePostUpdateAction(Action action)
 	{
 		assert(action && "Action must not be null");
+		ScopedLock lock(mPostUpdateActionsMutex);
 		mPostUpdateActions.push_back(action);
 	}
 	
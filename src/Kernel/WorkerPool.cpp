@@ -0,0 +1,229 @@
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Kernel/Thread.h>
+#include <echo/Kernel/ScopedLock.h>
+#include <echo/cpp/thread>
+#include <algorithm>
+#include <sstream>
+
+namespace Echo
+{
+	namespace
+	{
+		// Used to determine whether the current thread is a worker and which one.
+		thread_local const WorkerPool* gCurrentWorkerPool = nullptr;
+		thread_local Size gCurrentWorkerIndex = 0;
+	}
+
+	WorkerPool::WorkerPool(Size numberOfWorkers, const std::string& name) :
+		mNumberOfSharedJobs(0),
+		mNextWorker(0),
+		mSleepingWorkers(0),
+		mShutdown(false)
+	{
+		mWorkers.reserve(numberOfWorkers);
+		for(Size i=0; i < numberOfWorkers; ++i)
+		{
+			mWorkers.push_back(unique_ptr<Worker>(new Worker()));
+		}
+		// All workers need to exist before any of them start since they will attempt to steal from each other.
+		for(Size i=0; i < numberOfWorkers; ++i)
+		{
+			std::stringstream threadName;
+			threadName << name << i;
+			mWorkers[i]->mThread.reset(new Thread(threadName.str(), bind(&WorkerPool::WorkerMain, this, i)));
+			mWorkers[i]->mThread->Execute();
+		}
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		mShutdown.store(true);
+		for(unique_ptr<Worker>& worker : mWorkers)
+		{
+			worker->mThread->Notify();
+		}
+		for(unique_ptr<Worker>& worker : mWorkers)
+		{
+			worker->mThread->Join();
+		}
+		// Clean up anything that wasn't executed.
+		Entry* entry = nullptr;
+		for(unique_ptr<Worker>& worker : mWorkers)
+		{
+			while(worker->mJobs.Pop(entry))
+			{
+				delete entry;
+			}
+		}
+		for(Entry* sharedEntry : mSharedJobs)
+		{
+			delete sharedEntry;
+		}
+	}
+
+	Size WorkerPool::GetCurrentWorkerIndex() const
+	{
+		if(gCurrentWorkerPool==this)
+		{
+			return gCurrentWorkerIndex;
+		}
+		return mWorkers.size();
+	}
+
+	void WorkerPool::Schedule(Job job, Counter& counter)
+	{
+		counter.mPending.fetch_add(1, std::memory_order_relaxed);
+		if(mWorkers.empty())
+		{
+			// No workers, execute on the calling thread.
+			job();
+			counter.mPending.fetch_sub(1, std::memory_order_release);
+			return;
+		}
+
+		Entry* entry = new Entry();
+		entry->mJob = std::move(job);
+		entry->mCounter = &counter;
+
+		const Size workerIndex = GetCurrentWorkerIndex();
+		if(workerIndex < mWorkers.size())
+		{
+			// Only the owner can push onto a worker's deque.
+			mWorkers[workerIndex]->mJobs.Push(entry);
+		}else
+		{
+			ScopedLock lock(mSharedJobsMutex);
+			mSharedJobs.push_back(entry);
+			mNumberOfSharedJobs.fetch_add(1, std::memory_order_seq_cst);
+		}
+		// Pairs with the check in WorkerMain() so a worker going to sleep either sees the job or is woken.
+		if(mSleepingWorkers.load(std::memory_order_seq_cst)>0)
+		{
+			WakeWorker();
+		}
+	}
+
+	void WorkerPool::WakeWorker()
+	{
+		Size workerIndex = mNextWorker.fetch_add(1, std::memory_order_relaxed) % mWorkers.size();
+		mWorkers[workerIndex]->mThread->Notify();
+	}
+
+	void WorkerPool::Wait(Counter& counter)
+	{
+		Size workerIndex = GetCurrentWorkerIndex();
+		while(!counter.IsComplete())
+		{
+			if(!ExecuteNextJob(workerIndex))
+			{
+				this_thread::yield();
+			}
+		}
+	}
+
+	void WorkerPool::ParallelFor(Size begin, Size end, Size grainSize, RangeFunction rangeFunction)
+	{
+		if(end <= begin)
+		{
+			return;
+		}
+		const Size rangeSize = end - begin;
+		if(grainSize==0)
+		{
+			// A few chunks per thread helps balance uneven work.
+			const Size numberOfChunks = (mWorkers.size() + 1) * 4;
+			grainSize = std::max<Size>(1, (rangeSize + numberOfChunks - 1) / numberOfChunks);
+		}
+		if(mWorkers.empty() || rangeSize <= grainSize)
+		{
+			rangeFunction(begin, end);
+			return;
+		}
+
+		Counter counter;
+		// Keep the first chunk for the calling thread.
+		for(Size chunkBegin = begin + grainSize; chunkBegin < end; chunkBegin += grainSize)
+		{
+			Size chunkEnd = std::min(end, chunkBegin + grainSize);
+			Schedule([&rangeFunction,chunkBegin,chunkEnd](){rangeFunction(chunkBegin,chunkEnd);}, counter);
+		}
+		rangeFunction(begin, begin + grainSize);
+		Wait(counter);
+	}
+
+	bool WorkerPool::TakeSharedJob(Entry*& entryOut)
+	{
+		if(mNumberOfSharedJobs.load(std::memory_order_acquire)==0)
+		{
+			return false;
+		}
+		ScopedLock lock(mSharedJobsMutex);
+		if(mSharedJobs.empty())
+		{
+			return false;
+		}
+		entryOut = mSharedJobs.front();
+		mSharedJobs.pop_front();
+		mNumberOfSharedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool WorkerPool::StealJob(Size workerIndex, Entry*& entryOut)
+	{
+		// When the caller isn't a worker workerIndex is numberOfWorkers so every worker is a candidate.
+		const Size numberOfWorkers = mWorkers.size();
+		for(Size i=0; i < numberOfWorkers; ++i)
+		{
+			Size victimIndex = (workerIndex + 1 + i) % numberOfWorkers;
+			if(victimIndex==workerIndex)
+			{
+				continue;
+			}
+			if(mWorkers[victimIndex]->mJobs.Steal(entryOut))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool WorkerPool::ExecuteNextJob(Size workerIndex)
+	{
+		if(mWorkers.empty())
+		{
+			return false;
+		}
+		Entry* entry = nullptr;
+		if((workerIndex < mWorkers.size() && mWorkers[workerIndex]->mJobs.Pop(entry)) ||
+			TakeSharedJob(entry) ||
+			StealJob(workerIndex, entry))
+		{
+			entry->mJob();
+			entry->mCounter->mPending.fetch_sub(1, std::memory_order_release);
+			delete entry;
+			return true;
+		}
+		return false;
+	}
+
+	void WorkerPool::WorkerMain(Size workerIndex)
+	{
+		gCurrentWorkerPool = this;
+		gCurrentWorkerIndex = workerIndex;
+		Thread& thread = *mWorkers[workerIndex]->mThread;
+		while(!mShutdown.load())
+		{
+			if(!ExecuteNextJob(workerIndex))
+			{
+				// Nothing to do. Wait until more work is scheduled.
+				mSleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+				if(mNumberOfSharedJobs.load(std::memory_order_seq_cst)==0)
+				{
+					thread.Wait();
+				}
+				mSleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+		gCurrentWorkerPool = nullptr;
+	}
+}
@@ -3,6 +3,8 @@
 #include <echo/Util/StringUtils.h>
 #include <echo/Kernel/ScopedLock.h>
 #include <echo/Kernel/Mutex.h>
+#include <echo/Kernel/Thread.h>
+#include <echo/cpp/thread>
 #include <boost/format.hpp>
 #include <boost/utility/string_ref.hpp>
 
@@ -17,9 +19,322 @@ namespace Echo
 		}
 	};
 	
+	/**
+	 * Queues messages from each logging thread and writes them on a background thread.
+	 * Each thread that logs gets its own single producer, single consumer ring buffer so logging threads never contend
+	 * with each other. The background thread is the only consumer. It takes the Logger's mutex while writing a batch
+	 * so output streams can still be changed safely from any thread.
+	 */
+	class Logger::AsynchronousBackend
+	{
+	public:
+		struct Entry
+		{
+			LogMask mLevel;					// 0 if the message was logged with a label.
+			std::string mLabel;
+			const char* mFile;
+			int mLine;
+			MillisecondsInt mTime;
+			std::string mMessage;
+		};
+
+		class ThreadBuffer
+		{
+		public:
+			ThreadBuffer(Size capacity, thread::id owner) : mOwner(owner), mHead(0), mTail(0), mAbandoned(false)
+			{
+				// The capacity needs to be a power of two.
+				Size powerOfTwo = 1;
+				while(powerOfTwo < capacity)
+				{
+					powerOfTwo <<= 1;
+				}
+				mEntries.resize(powerOfTwo);
+				mMask = powerOfTwo - 1;
+			}
+
+			/**
+			 * Producer only.
+			 */
+			bool Push(Entry& entry)
+			{
+				Size tail = mTail.load(std::memory_order_relaxed);
+				if(tail - mHead.load(std::memory_order_acquire) > mMask)
+				{
+					return false;
+				}
+				mEntries[tail & mMask] = std::move(entry);
+				mTail.store(tail + 1, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * Consumer only.
+			 */
+			bool Pop(Entry& entry)
+			{
+				Size head = mHead.load(std::memory_order_relaxed);
+				if(head == mTail.load(std::memory_order_acquire))
+				{
+					return false;
+				}
+				entry = std::move(mEntries[head & mMask]);
+				mHead.store(head + 1, std::memory_order_release);
+				return true;
+			}
+
+			bool IsEmpty() const
+			{
+				return mHead.load(std::memory_order_acquire)==mTail.load(std::memory_order_acquire);
+			}
+
+			const thread::id mOwner;
+			std::vector<Entry> mEntries;
+			Size mMask;
+			std::atomic<Size> mHead;
+			std::atomic<Size> mTail;
+			std::atomic<bool> mAbandoned;	// Set when the owning thread exits.
+		};
+
+		AsynchronousBackend(const Logger& logger) :
+			mID(mNextID.fetch_add(1)),
+			mLogger(logger),
+			mMessagesPerThread(4096),
+			mOverflowPolicy(OverflowPolicies::DROP),
+			mShutdown(false),
+			mSleeping(false),
+			mDrainCount(0),
+			mDropped(0),
+			mDroppedReported(0),
+			mThreadID(thread::id()),
+			mThread("Logger", bind(&AsynchronousBackend::ThreadMain, this))
+		{
+			mThread.Execute();
+		}
+
+		~AsynchronousBackend()
+		{
+			mShutdown.store(true);
+			mThread.Notify();
+			mThread.Join();
+			// Anything logged while shutting down.
+			WriteQueued();
+		}
+
+		void Configure(Size messagesPerThread, OverflowPolicy overflowPolicy)
+		{
+			mMessagesPerThread.store(std::max<Size>(messagesPerThread, 1));
+			mOverflowPolicy.store(overflowPolicy);
+		}
+
+		void Push(Entry& entry)
+		{
+			ThreadBuffer& buffer = GetThreadBuffer();
+			if(!buffer.Push(entry))
+			{
+				if(mOverflowPolicy.load(std::memory_order_relaxed)==OverflowPolicies::DROP)
+				{
+					mDropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				do
+				{
+					mThread.Notify();
+					this_thread::yield();
+				}while(!buffer.Push(entry));
+			}
+			// Pairs with the check in ThreadMain() so the background thread either sees the entry or is woken.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(mSleeping.load(std::memory_order_relaxed))
+			{
+				mThread.Notify();
+			}
+		}
+
+		void Flush()
+		{
+			if(this_thread::get_id()==mThreadID.load())
+			{
+				// Called while writing, waiting would deadlock.
+				return;
+			}
+			// A full pass that finds nothing to write has to start after this point, the first pass to finish may
+			// have started before.
+			Size target = mDrainCount.load() + 2;
+			while(mDrainCount.load() < target)
+			{
+				mThread.Notify();
+				this_thread::yield();
+			}
+		}
+
+		Size GetNumberOfDropped() const
+		{
+			return mDropped.load(std::memory_order_relaxed);
+		}
+	private:
+		// Identifies the backend in ThreadBufferCache. An address could be reused by a later backend.
+		static std::atomic<u64> mNextID;
+		const u64 mID;
+		const Logger& mLogger;
+		std::atomic<Size> mMessagesPerThread;
+		std::atomic<OverflowPolicy> mOverflowPolicy;
+		std::atomic<bool> mShutdown;
+		std::atomic<bool> mSleeping;
+		std::atomic<Size> mDrainCount;
+		std::atomic<Size> mDropped;
+		Size mDroppedReported;
+		std::atomic<thread::id> mThreadID;
+		Mutex mBuffersMutex;
+		std::vector< shared_ptr<ThreadBuffer> > mBuffers;
+		Thread mThread;
+
+		/**
+		 * Marks the calling thread's buffer as abandoned when the thread exits so it can be cleaned up.
+		 */
+		struct ThreadBufferCache
+		{
+			u64 mBackendID = 0;
+			shared_ptr<ThreadBuffer> mBuffer;
+			~ThreadBufferCache()
+			{
+				if(mBuffer)
+				{
+					mBuffer->mAbandoned.store(true);
+				}
+			}
+		};
+		static thread_local ThreadBufferCache mThreadBufferCache;
+
+		ThreadBuffer& GetThreadBuffer()
+		{
+			if(mThreadBufferCache.mBackendID==mID)
+			{
+				return *mThreadBufferCache.mBuffer;
+			}
+
+			// First time this thread has logged to this backend, or it has been logging to another Logger.
+			thread::id threadID = this_thread::get_id();
+			ScopedLock lock(mBuffersMutex);
+			shared_ptr<ThreadBuffer> buffer;
+			for(shared_ptr<ThreadBuffer>& b : mBuffers)
+			{
+				if(b->mOwner==threadID && !b->mAbandoned.load())
+				{
+					buffer = b;
+					break;
+				}
+			}
+			if(!buffer)
+			{
+				buffer = make_shared<ThreadBuffer>(mMessagesPerThread.load(), threadID);
+				mBuffers.push_back(buffer);
+			}
+			// Only the cached buffer is marked as abandoned when the thread exits. A thread that alternates between
+			// asynchronous Loggers finds its other buffers again by thread ID.
+			mThreadBufferCache.mBackendID = mID;
+			mThreadBufferCache.mBuffer = buffer;
+			return *buffer;
+		}
+
+		/**
+		 * Write everything currently queued.
+		 * @return true if anything was written.
+		 */
+		bool WriteQueued()
+		{
+			std::vector< shared_ptr<ThreadBuffer> > buffers;
+			{
+				ScopedLock lock(mBuffersMutex);
+				// Remove buffers for threads that have exited once they have been drained.
+				mBuffers.erase(std::remove_if(mBuffers.begin(), mBuffers.end(), [](const shared_ptr<ThreadBuffer>& b)
+				{
+					return b->mAbandoned.load() && b->IsEmpty();
+				}), mBuffers.end());
+				buffers = mBuffers;
+			}
+
+			bool wroteAny = false;
+			Entry entry;
+			ScopedLock lock(*mLogger.mMutex);
+			for(shared_ptr<ThreadBuffer>& buffer : buffers)
+			{
+				// Limit how much is taken from one thread at a time so one busy thread doesn't starve the others.
+				Size budget = buffer->mEntries.size();
+				while(budget > 0 && buffer->Pop(entry))
+				{
+					budget--;
+					wroteAny = true;
+					if(entry.mLevel!=0)
+					{
+						if(mLogger.mLogMask & entry.mLevel)
+						{
+							mLogger.LocklessLog(mLogger.LocklessGetLogLevelLabel(static_cast<LogLevel>(entry.mLevel)), entry.mFile, entry.mLine, entry.mMessage, Chrono::FormatIOS8601(entry.mTime));
+						}
+					}else
+					{
+						auto it = mLogger.mLogLevels.find(entry.mLabel);
+						if(it!=mLogger.mLogLevels.end() && (mLogger.mLogMask & it->second))
+						{
+							mLogger.LocklessLog(entry.mLabel, entry.mFile, entry.mLine, entry.mMessage, Chrono::FormatIOS8601(entry.mTime));
+						}
+					}
+				}
+			}
+
+			Size dropped = mDropped.load(std::memory_order_relaxed);
+			if(dropped!=mDroppedReported)
+			{
+				std::stringstream ss;
+				ss << (dropped - mDroppedReported) << " log messages were dropped because a thread's log buffer was full.";
+				mLogger.LocklessLog(mLogger.LocklessGetLogLevelLabel(LogLevels::WARNING), __FILE__, __LINE__, ss.str(), Chrono::GetIOS8601());
+				mDroppedReported = dropped;
+			}
+			return wroteAny;
+		}
+
+		bool HasQueued()
+		{
+			ScopedLock lock(mBuffersMutex);
+			for(shared_ptr<ThreadBuffer>& buffer : mBuffers)
+			{
+				if(!buffer->IsEmpty())
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void ThreadMain()
+		{
+			mThreadID.store(this_thread::get_id());
+			while(!mShutdown.load())
+			{
+				if(WriteQueued())
+				{
+					continue;
+				}
+				mDrainCount.fetch_add(1);
+				// Nothing to do. Wait until more is logged.
+				mSleeping.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if(!HasQueued() && !mShutdown.load())
+				{
+					mThread.Wait();
+				}
+				mSleeping.store(false, std::memory_order_relaxed);
+			}
+			mThreadID.store(thread::id());
+		}
+	};
+
+	std::atomic<u64> Logger::AsynchronousBackend::mNextID(1);
+	thread_local Logger::AsynchronousBackend::ThreadBufferCache Logger::AsynchronousBackend::mThreadBufferCache;
+
 	Logger gDefaultLogger;
 
-	Logger::Logger()
+	Logger::Logger() : mAsynchronous(false)
 	{
 		mMutex = std::unique_ptr<Mutex>(new Mutex());
 		mLogMask = LogLevels::WARNING | LogLevels::ERROR | LogLevels::INFO;
@@ -37,6 +352,54 @@ namespace Echo
 		mRemoveFilePath = true;
 		SetFormat("%1$-23s : %2$=8s : %3$30.30s : %4$=4s : %5$s");
 	}
+
+	Logger::~Logger()
+	{
+		mAsynchronous.store(false);
+		mAsynchronousBackend.reset();
+	}
+
+	void Logger::SetAsynchronous(bool asynchronous, Size messagesPerThread, OverflowPolicy overflowPolicy)
+	{
+		if(asynchronous)
+		{
+			// The backend starts a Thread which may log so it is created without holding mMutex.
+			if(!mAsynchronousBackend)
+			{
+				mAsynchronousBackend.reset(new AsynchronousBackend(*this));
+			}
+			mAsynchronousBackend->Configure(messagesPerThread, overflowPolicy);
+			// Release so a thread that sees the flag also sees the configured backend.
+			mAsynchronous.store(true, std::memory_order_release);
+		}else
+		{
+			// The backend is kept so anything a thread was in the middle of queuing is still written.
+			mAsynchronous.store(false);
+			Flush();
+		}
+	}
+
+	bool Logger::GetAsynchronous() const
+	{
+		return mAsynchronous.load();
+	}
+
+	void Logger::Flush() const
+	{
+		if(mAsynchronousBackend)
+		{
+			mAsynchronousBackend->Flush();
+		}
+	}
+
+	Size Logger::GetNumberOfDroppedMessages() const
+	{
+		if(mAsynchronousBackend)
+		{
+			return mAsynchronousBackend->GetNumberOfDropped();
+		}
+		return 0;
+	}
 	
 	void Logger::SetFormat(std::string format)
 	{
@@ -199,17 +562,30 @@ namespace Echo
 		return nullptr;
 	}
 
-	void Logger::Log(LogLevel level, const char* file, int line, const std::string& message) const
+	void Logger::Log(LogLevel level, const char* file, int line, std::string message) const
 	{
 		if(mLogMask & level)
 		{
+			if(mAsynchronous.load(std::memory_order_acquire))
+			{
+				AsynchronousBackend::Entry entry{static_cast<LogMask>(level), std::string(), file, line, Chrono::GetMillisecondsSinceEpoch(), std::move(message)};
+				mAsynchronousBackend->Push(entry);
+				return;
+			}
 			ScopedLock lock(*mMutex);
-			LocklessLog(LocklessGetLogLevelLabel(level),file,line,message);
+			LocklessLog(LocklessGetLogLevelLabel(level),file,line,message,Chrono::GetIOS8601());
 		}
 	}
 
-	void Logger::Log(const std::string& label, const char* file, int line, const std::string& message) const
+	void Logger::Log(const std::string& label, const char* file, int line, std::string message) const
 	{
+		if(mAsynchronous.load(std::memory_order_acquire))
+		{
+			// The label is resolved on the background thread to avoid taking the lock here.
+			AsynchronousBackend::Entry entry{0, label, file, line, Chrono::GetMillisecondsSinceEpoch(), std::move(message)};
+			mAsynchronousBackend->Push(entry);
+			return;
+		}
 		ScopedLock lock(*mMutex);
 		auto it = mLogLevels.find(label);
 		if(it==mLogLevels.end())
@@ -218,11 +594,11 @@ namespace Echo
 		}
 		if(mLogMask & (it->second))
 		{
-			LocklessLog(label,file,line,message);
+			LocklessLog(label,file,line,message,Chrono::GetIOS8601());
 		}
 	}
 
-	void Logger::LocklessLog(const std::string& label, const char* file, int line, const std::string& message) const
+	void Logger::LocklessLog(const std::string& label, const char* file, int line, const std::string& message, const std::string& timestamp) const
 	{
 		if(mRemoveFilePath)
 		{
@@ -238,13 +614,13 @@ namespace Echo
 			}
 			for(std::ostream* stream : mOutputStreams)
 			{
-				(*stream) << (boost::format(*mFormatter) % Chrono::GetIOS8601() % label % filePartRef % line % message) << std::endl;
+				(*stream) << (boost::format(*mFormatter) % timestamp % label % filePartRef % line % message) << std::endl;
 			}
 		}else
 		{
 			for(std::ostream* stream : mOutputStreams)
 			{
-				(*stream) << (boost::format(*mFormatter) % Chrono::GetIOS8601() % label % file % line % message) << std::endl;
+				(*stream) << (boost::format(*mFormatter) % timestamp % label % file % line % message) << std::endl;
 			}
 		}
 	}
@@ -1,8 +1,58 @@
 
 #include <echo/Maths/AxisAlignedBox.h>
+#include <echo/Maths/SIMD.h>
 
 namespace Echo
 {
 	const AxisAlignedBox AxisAlignedBox::BOX_NULL = AxisAlignedBox(AxisAlignedBox::Extents::NULL_EXTENT);
 	const AxisAlignedBox AxisAlignedBox::BOX_INFINITE = AxisAlignedBox(AxisAlignedBox::Extents::INFINITE);
+
+	void AxisAlignedBox::TransformAffine(const Matrix4& m, const AxisAlignedBox* input, AxisAlignedBox* output, Size count)
+	{
+		assert(m.IsAffine());
+
+#ifdef ECHO_MATHS_SIMD
+		// The columns of the matrix, the absolute values of the columns map the half size.
+		SIMD::f32x4 column0 = SIMD::Set(m[0][0], m[1][0], m[2][0], 0);
+		SIMD::f32x4 column1 = SIMD::Set(m[0][1], m[1][1], m[2][1], 0);
+		SIMD::f32x4 column2 = SIMD::Set(m[0][2], m[1][2], m[2][2], 0);
+		SIMD::f32x4 translation = SIMD::Set(m[0][3], m[1][3], m[2][3], 0);
+		SIMD::f32x4 absColumn0 = SIMD::Abs(column0);
+		SIMD::f32x4 absColumn1 = SIMD::Abs(column1);
+		SIMD::f32x4 absColumn2 = SIMD::Abs(column2);
+		SIMD::f32x4 half = SIMD::Splat(0.5f);
+		for(Size b = 0; b < count; ++b)
+		{
+			const AxisAlignedBox& box = input[b];
+			if(box.mExtent != Extents::FINITE)
+			{
+				output[b] = box;
+				continue;
+			}
+			SIMD::f32x4 minimum = SIMD::Set(box.mMinimum.x, box.mMinimum.y, box.mMinimum.z, 0);
+			SIMD::f32x4 maximum = SIMD::Set(box.mMaximum.x, box.mMaximum.y, box.mMaximum.z, 0);
+			SIMD::f32x4 centre = SIMD::Multiply(SIMD::Add(maximum, minimum), half);
+			SIMD::f32x4 halfSize = SIMD::Multiply(SIMD::Subtract(maximum, minimum), half);
+
+			SIMD::f32x4 newCentre = SIMD::MultiplyAdd(column0, SIMD::Shuffle<0, 0, 0, 0>(centre), translation);
+			newCentre = SIMD::MultiplyAdd(column1, SIMD::Shuffle<1, 1, 1, 1>(centre), newCentre);
+			newCentre = SIMD::MultiplyAdd(column2, SIMD::Shuffle<2, 2, 2, 2>(centre), newCentre);
+			SIMD::f32x4 newHalfSize = SIMD::Multiply(absColumn0, SIMD::Shuffle<0, 0, 0, 0>(halfSize));
+			newHalfSize = SIMD::MultiplyAdd(absColumn1, SIMD::Shuffle<1, 1, 1, 1>(halfSize), newHalfSize);
+			newHalfSize = SIMD::MultiplyAdd(absColumn2, SIMD::Shuffle<2, 2, 2, 2>(halfSize), newHalfSize);
+
+			f32 newMinimum[4];
+			f32 newMaximum[4];
+			SIMD::Store(newMinimum, SIMD::Subtract(newCentre, newHalfSize));
+			SIMD::Store(newMaximum, SIMD::Add(newCentre, newHalfSize));
+			output[b].SetExtents(newMinimum[0], newMinimum[1], newMinimum[2], newMaximum[0], newMaximum[1], newMaximum[2]);
+		}
+#else
+		for(Size b = 0; b < count; ++b)
+		{
+			output[b] = input[b];
+			output[b].TransformAffine(m);
+		}
+#endif
+	}
 }
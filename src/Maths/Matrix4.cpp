@@ -20,6 +20,15 @@ namespace Echo
 		  0,	0,  1,   0,
 		  0,	0,  0,   1);
 
+#ifdef ECHO_MATHS_SIMD
+	//-----------------------------------------------------------------------
+	inline static SIMD::f32x4 Cross(SIMD::f32x4 a, SIMD::f32x4 b)
+	{
+		return SIMD::Subtract(
+			SIMD::Multiply(SIMD::Shuffle<1, 2, 0, 3>(a), SIMD::Shuffle<2, 0, 1, 3>(b)),
+			SIMD::Multiply(SIMD::Shuffle<2, 0, 1, 3>(a), SIMD::Shuffle<1, 2, 0, 3>(b)));
+	}
+#endif
 	//-----------------------------------------------------------------------
 	inline static f32
 	MINOR(const Matrix4& m, const size_t r0, const size_t r1, const size_t r2,
@@ -127,6 +136,31 @@ namespace Echo
 	{
 		assert(IsAffine());
 
+#ifdef ECHO_MATHS_SIMD
+		// The columns of the inverse of the 3x3 part are the cross products of its rows divided by the
+		// determinant. The cross products ignore the translation in the fourth component.
+		SIMD::f32x4 a = SIMD::Load(m[0]);
+		SIMD::f32x4 b = SIMD::Load(m[1]);
+		SIMD::f32x4 c = SIMD::Load(m[2]);
+		SIMD::f32x4 column0 = Cross(b, c);
+		SIMD::f32x4 column1 = Cross(c, a);
+		SIMD::f32x4 column2 = Cross(a, b);
+		SIMD::f32x4 invDet = SIMD::Splat(1 / SIMD::Dot4(SIMD::Set(m[0][0], m[0][1], m[0][2], 0), column0));
+		column0 = SIMD::Multiply(column0, invDet);
+		column1 = SIMD::Multiply(column1, invDet);
+		column2 = SIMD::Multiply(column2, invDet);
+		SIMD::f32x4 translation = SIMD::Multiply(column0, SIMD::Splat(-m[0][3]));
+		translation = SIMD::MultiplyAdd(column1, SIMD::Splat(-m[1][3]), translation);
+		translation = SIMD::MultiplyAdd(column2, SIMD::Splat(-m[2][3]), translation);
+		SIMD::Transpose(column0, column1, column2, translation);
+
+		Matrix4 r;
+		SIMD::Store(r.m[0], column0);
+		SIMD::Store(r.m[1], column1);
+		SIMD::Store(r.m[2], column2);
+		r.m[3][0] = 0; r.m[3][1] = 0; r.m[3][2] = 0; r.m[3][3] = 1;
+		return r;
+#else
 		f32 m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
 		f32 m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
 
@@ -165,6 +199,38 @@ namespace Echo
 			r10, r11, r12, r13,
 			r20, r21, r22, r23,
 			  0,   0,   0,   1);
+#endif
+	}
+	//-----------------------------------------------------------------------
+	void Matrix4::TransformAffine(const Vector3* input, Vector3* output, Size count) const
+	{
+		assert(IsAffine());
+
+		Size v = 0;
+#ifdef ECHO_MATHS_SIMD
+		static_assert(sizeof(Vector3)==sizeof(f32) * 3, "Vector3 arrays are accessed as packed f32 triples");
+
+		SIMD::f32x4 m00 = SIMD::Splat(m[0][0]), m01 = SIMD::Splat(m[0][1]), m02 = SIMD::Splat(m[0][2]), m03 = SIMD::Splat(m[0][3]);
+		SIMD::f32x4 m10 = SIMD::Splat(m[1][0]), m11 = SIMD::Splat(m[1][1]), m12 = SIMD::Splat(m[1][2]), m13 = SIMD::Splat(m[1][3]);
+		SIMD::f32x4 m20 = SIMD::Splat(m[2][0]), m21 = SIMD::Splat(m[2][1]), m22 = SIMD::Splat(m[2][2]), m23 = SIMD::Splat(m[2][3]);
+
+		// Four vectors are loaded before any are stored so input and output can be the same array.
+		for(; v + 4 <= count; v += 4)
+		{
+			SIMD::f32x4 x, y, z;
+			SIMD::LoadVector3x4(&input[v].x, x, y, z);
+			SIMD::f32x4 rx = SIMD::MultiplyAdd(m00, x, SIMD::MultiplyAdd(m01, y, SIMD::MultiplyAdd(m02, z, m03)));
+			SIMD::f32x4 ry = SIMD::MultiplyAdd(m10, x, SIMD::MultiplyAdd(m11, y, SIMD::MultiplyAdd(m12, z, m13)));
+			SIMD::f32x4 rz = SIMD::MultiplyAdd(m20, x, SIMD::MultiplyAdd(m21, y, SIMD::MultiplyAdd(m22, z, m23)));
+			SIMD::StoreVector3x4(&output[v].x, rx, ry, rz);
+		}
+#endif
+		// A copy of the matrix is used because the compiler has to assume writing to output could modify this.
+		const Matrix4 matrix = *this;
+		for(; v < count; ++v)
+		{
+			output[v] = matrix.TransformAffine(input[v]);
+		}
 	}
 	//-----------------------------------------------------------------------
 	void Matrix4::MakeTransform(const Vector3& position, const Vector3& scale, const Quaternion& orientation)
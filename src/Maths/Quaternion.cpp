@@ -237,20 +237,6 @@ namespace Echo
 		return Quaternion(x - rkQ.x, y - rkQ.y, z - rkQ.z, w - rkQ.w);
 	}
 	//-----------------------------------------------------------------------
-	Quaternion Quaternion::operator*(const Quaternion& rkQ) const
-	{
-		// NOTE:  Multiplication is not generally commutative, so in most
-		// cases p*q != q*p.
-
-		return Quaternion
-		(
-			w * rkQ.x + x * rkQ.w + y * rkQ.z - z * rkQ.y,
-			w * rkQ.y + y * rkQ.w + z * rkQ.x - x * rkQ.z,
-			w * rkQ.z + z * rkQ.w + x * rkQ.y - y * rkQ.x,
-			w * rkQ.w - x * rkQ.x - y * rkQ.y - z * rkQ.z
-		);
-	}
-	//-----------------------------------------------------------------------
 	Quaternion Quaternion::operator*(f32 fScalar) const
 	{
 		return Quaternion(fScalar*x, fScalar*y, fScalar*z, fScalar * w);
@@ -386,28 +372,26 @@ namespace Echo
 								 const Quaternion& rkQ, bool shortestPath)
 	{
 		f32 fCos = rkP.Dot(rkQ);
-		Quaternion rkT;
 
-		// Do we need to invert rotation?
+		// Do we need to invert rotation? Rather than negating rkQ its coefficient is negated.
+		f32 fSign = 1.0f;
 		if (fCos < 0.0f && shortestPath)
 		{
 			fCos = -fCos;
-			rkT = -rkQ;
-		}
-		else
-		{
-			rkT = rkQ;
+			fSign = -1.0f;
 		}
 
+		f32 fCoeff0;
+		f32 fCoeff1;
+		bool normalise = false;
 		if(Maths::Abs(fCos) < 1 - ms_fEpsilon)
 		{
 			// Standard case (slerp)
 			f32 fSin = Maths::Sqrt(1 - Maths::Sqr(fCos));
 			Radian fAngle = Maths::ATan2(fSin, fCos);
 			f32 fInvSin = 1.0f / fSin;
-			f32 fCoeff0 = Maths::Sin<f32>((1.0f - fT) * fAngle) * fInvSin;
-			f32 fCoeff1 = Maths::Sin<f32>(fT * fAngle) * fInvSin;
-			return fCoeff0 * rkP + fCoeff1 * rkT;
+			fCoeff0 = Maths::Sin<f32>((1.0f - fT) * fAngle) * fInvSin;
+			fCoeff1 = Maths::Sin<f32>(fT * fAngle) * fInvSin;
 		}
 		else
 		{
@@ -417,11 +401,26 @@ namespace Echo
 			// 2. "rkP" and "rkQ" are almost inverse of each other (fCos ~= -1), there
 			//	are an infinite number of possibilities interpolation. but we haven't
 			//	have method to fix this case, so just use linear interpolation here.
-			Quaternion t = (1.0f - fT) * rkP + fT * rkT;
+			fCoeff0 = 1.0f - fT;
+			fCoeff1 = fT;
 			// taking the complement requires renormalisation
+			normalise = true;
+		}
+		fCoeff1 *= fSign;
+
+		Quaternion t;
+#ifdef ECHO_MATHS_SIMD
+		SIMD::f32x4 p = SIMD::Load(&rkP.w);
+		SIMD::f32x4 q = SIMD::Load(&rkQ.w);
+		SIMD::Store(&t.w, SIMD::MultiplyAdd(SIMD::Splat(fCoeff0), p, SIMD::Multiply(SIMD::Splat(fCoeff1), q)));
+#else
+		t = fCoeff0 * rkP + fCoeff1 * rkQ;
+#endif
+		if(normalise)
+		{
 			t.Normalise();
-			return t;
 		}
+		return t;
 	}
 	//-----------------------------------------------------------------------
 	Quaternion Quaternion::SlerpExtraSpins(f32 fT,
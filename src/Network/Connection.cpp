@@ -10,6 +10,7 @@
 #include <boost/scope_exit.hpp>
 #include <echo/cpp/functional>
 #include <iostream>
+#include <algorithm>
 
 namespace Echo
 {
@@ -210,9 +211,15 @@ namespace Echo
 		return false;
 	}
 
-	void Connection::UpdateReceive()
+	void Connection::UpdateReceive(bool drain)
 	{
+		Size bytesReceived = mBytesReceived;
 		ReceiveStatus status = ReceivePackets();
+		while(drain && status==ReceiveStatuses::SUCCESS && mBytesReceived!=bytesReceived)
+		{
+			bytesReceived = mBytesReceived;
+			status = ReceivePackets();
+		}
 		if(status==ReceiveStatuses::DISCONNECT)
 		{
 			_Disconnect();
@@ -242,6 +249,23 @@ namespace Echo
 			//ECHO_LOG_DEBUG("bufferStart: " << bufferStart << ":" << receiveResult.mBytesReceived);
 			u32 headerBytes=0;
 			//ECHO_LOG_DEBUG(receiveResult.mBytesReceived << " bytes");
+			// Fast path: when a whole header is available in the buffer and there isn't a partial header waiting
+			// it is read in place rather than being copied into mHeaderPacket first.
+			if(mHeaderPacket->mReceived==0 && receiveResult.mBytesReceived>=mHeaderPacket->mSize)
+			{
+				DataPacketHeader header;
+				header.BuildFromData(bufferStart, mHeaderPacket->IsBigEndian());
+				if(header.GetDataLength()>mUnreasonableDataSize)
+				{
+					ECHO_LOG_ERROR("DataPacket length was too large: " << header.GetDataLength() << " when maximum is " << mUnreasonableDataSize);
+					return ReceiveStatuses::DISCONNECT;
+				}
+				mCurrentPacket=NewDataPacket();
+				mCurrentPacket->Configure(header);
+				mHeaderPacket->mReceived=mHeaderPacket->mSize;
+				receiveResult.mBytesReceived-=mHeaderPacket->mSize;
+				bufferStart+=mHeaderPacket->mSize;
+			}else
 			if(!(mHeaderPacket->HasReceivedAllData()))				//We have a valid header
 			{
 				//ECHO_LOG_DEBUG("I'll try and make a header for you");
@@ -348,99 +372,146 @@ namespace Echo
 		} BOOST_SCOPE_EXIT_END
 
 		mCanSend=false;
-		//ECHO_LOG_DEBUG(mQueuedPackets.size());
-		//if(!mSendingData)
-		
+
+		DataPacketHeader headers[MAXIMUM_PACKETS_PER_SEND];
+		SendBuffer buffers[MAXIMUM_PACKETS_PER_SEND*2];
+		std::pair< shared_ptr<DataPacket>, bool > batch[MAXIMUM_PACKETS_PER_SEND];
+
 		while(!(mQueuedPackets.empty()) || mCurrentSendPacket.first)
 		{
-			shared_ptr<DataPacket> packet = mCurrentSendPacket.first;
-			if(!packet)
+			// Gather the current packet and as many queued packets as will fit so their headers and data can be
+			// sent with a single call. The current packet may have been partially sent previously.
+			Size numberOfPackets = 0;
+			Size numberOfBuffers = 0;
+			while(numberOfPackets < MAXIMUM_PACKETS_PER_SEND && (numberOfPackets==0 || !mQueuedPackets.empty()))
 			{
-				// This means mQueuedPackets is not empty(), otherwise we would have exited the loop
-				mCurrentSendPacket = mQueuedPackets.front();
-				mQueuedPackets.pop_front();
-				packet = mCurrentSendPacket.first;
+				std::pair< shared_ptr<DataPacket>, bool >& entry = batch[numberOfPackets];
+				if(numberOfPackets==0 && mCurrentSendPacket.first)
+				{
+					entry = mCurrentSendPacket;
+				}else
+				{
+					entry = mQueuedPackets.front();
+					mQueuedPackets.pop_front();
+				}
+				DataPacket& packet = *entry.first;
+
+				// Only the first packet in a batch can have partially sent state.
+				if(numberOfPackets!=0 || !mHeaderSent)
+				{
+					DataPacketHeader& header = headers[numberOfPackets];
+					header.BuildForPacket(packet);
+					Size headerOffset = (numberOfPackets==0) ? mHeaderBytesSent : 0;
+					buffers[numberOfBuffers].mData = header.GetHeaderData() + headerOffset;
+					buffers[numberOfBuffers].mSize = header.GetHeaderDataSizeInBytes() - headerOffset;
+					numberOfBuffers++;
+				}
+				if(!packet.SendHeaderOnly())
+				{
+					buffers[numberOfBuffers].mData = &(packet.mData[packet.mSize-packet.mReceived]);
+					buffers[numberOfBuffers].mSize = packet.mReceived;
+					numberOfBuffers++;
+				}
+				numberOfPackets++;
+
+				// Nothing should be sent after a packet that requests a disconnect.
+				if(entry.second)
+				{
+					break;
+				}
+			}
+
+			//ECHO_LOG_DEBUG("0x" << std::hex << this << std::dec << ": Send " << numberOfPackets << " packets");
+			SendResult sendResult=SendVectored(buffers,numberOfBuffers);
+			mNetworkManager.ReportSentData(sendResult.mBytesSent);
+			{
+				ScopedLock accountingLock(mAccountingMutex);
+				mBytesQueuedToSend-=sendResult.mBytesSent;
+				mBytesSent+=sendResult.mBytesSent;
 			}
-			if(packet)
+
+			// Walk the batch to account for what was sent.
+			Size bytesRemaining = sendResult.mBytesSent;
+			Size p = 0;
+			for(; p < numberOfPackets; ++p)
 			{
-				//ECHO_LOG_DEBUG(packet->GetData());
-				//ECHO_LOG_DEBUG("Connection::UpdateWrite() - mCanSend==true");
-				//ECHO_LOG_DEBUG("Connection::UpdateWrite():Packet:0x" << std::hex << packet->GetPacketTypeID() << std::dec);
+				DataPacket& packet = *batch[p].first;
 				if(!mHeaderSent)
 				{
-					DataPacketHeader header;
-					header.BuildForPacket(*packet);
-
-					//ECHO_LOG_DEBUG("0x" << std::hex << this << std::dec << ": Send Header");
-					SendResult sendResult=Send(header.GetHeaderData()+mHeaderBytesSent,header.GetHeaderDataSizeInBytes()-mHeaderBytesSent);
-					//ECHO_LOG_DEBUG("0x" << std::hex << socketNum << std::dec);
-					mNetworkManager.ReportSentData(sendResult.mBytesSent);
-					{
-						ScopedLock accountingLock(mAccountingMutex);
-						mBytesQueuedToSend-=sendResult.mBytesSent;
-						mBytesSent+=sendResult.mBytesSent;
-					}
-
-					if(sendResult.mStatus!=SendStatuses::SUCCESS)
+					Size headerSize = headers[p].GetHeaderDataSizeInBytes();
+					Size headerBytes = std::min(bytesRemaining, headerSize - mHeaderBytesSent);
+					mHeaderBytesSent += headerBytes;
+					bytesRemaining -= headerBytes;
+					if(mHeaderBytesSent < headerSize)
 					{
-						//ECHO_LOG_DEBUG("mCanSend=false; for header");
-						mHeaderBytesSent+=sendResult.mBytesSent;
-						return sendResult.mStatus;
+						break;
 					}
-
-					//ECHO_LOG_DEBUG("Sent: Header");
 					mHeaderSent=true;
 					mHeaderBytesSent=0; // Reset for the next packet
-					//See if this is just a control packet - If the data packet is not the same as the header
-					if(packet->SendHeaderOnly())
+				}
+				if(!packet.SendHeaderOnly())
+				{
+					Size dataBytes = std::min<Size>(bytesRemaining, packet.mReceived);
+					packet.mReceived -= dataBytes;
+					bytesRemaining -= dataBytes;
+					if(packet.mReceived!=0)
 					{
-						packet.reset();
-						mHeaderSent=false;
-						mCurrentSendPacket.first.reset();
-						if(mCurrentSendPacket.second)
-						{
-							return SendStatuses::DISCONNECT_REQUESTED;
-						}
-						continue;
+						break;
 					}
 				}
 
-				const u8* data=&(packet->mData[packet->mSize-packet->mReceived]);
-				//ECHO_LOG_DEBUG("0x" << std::hex << this << std::dec << ": Send Data");
-				SendResult sendResult=Send(data,packet->mReceived);
-
-				packet->mReceived-=sendResult.mBytesSent;
-
-				mNetworkManager.ReportSentData(sendResult.mBytesSent);
-				{
-					ScopedLock accountingLock(mAccountingMutex);
-					mBytesQueuedToSend-=sendResult.mBytesSent;
-					mBytesSent+=sendResult.mBytesSent;
-				}
-				
-				if(sendResult.mStatus!=SendStatuses::SUCCESS)
+				//All our data was sent
+				mHeaderSent=false;
+				if(batch[p].second)
 				{
-					//ECHO_LOG_DEBUG("mCanSend=false; for packet");
-					return sendResult.mStatus;
+					// Only the last packet in a batch can request a disconnect so there is nothing to requeue.
+					mCurrentSendPacket.first.reset();
+					return SendStatuses::DISCONNECT_REQUESTED;
 				}
-				
-				//ECHO_LOG_DEBUG("Sent: " << packet->mSize-packet->mReceived << " of " << packet->mSize << " bytes");
-				if(packet->mReceived==0)			//All our data was sent
+				batch[p].first.reset();
+			}
+
+			// Whatever wasn't sent goes back to the front of the queue in the same order.
+			if(p < numberOfPackets)
+			{
+				mCurrentSendPacket = batch[p];
+				batch[p].first.reset();
+				for(Size r = numberOfPackets; r > p + 1; --r)
 				{
-					packet.reset();
-					mHeaderSent=false;
-					mCurrentSendPacket.first.reset();
-					if(mCurrentSendPacket.second)
-					{
-						return SendStatuses::DISCONNECT_REQUESTED;
-					}
+					mQueuedPackets.push_front(batch[r-1]);
+					batch[r-1].first.reset();
 				}
+			}else
+			{
+				mCurrentSendPacket.first.reset();
 			}
-		}	
+
+			if(sendResult.mStatus!=SendStatuses::SUCCESS)
+			{
+				//ECHO_LOG_DEBUG("mCanSend=false;");
+				return sendResult.mStatus;
+			}
+		}
 		mCanSend=true;
 		return SendStatuses::SUCCESS;
 	}
 
+	Connection::SendResult Connection::SendVectored(const SendBuffer* buffers, Size numberOfBuffers)
+	{
+		SendResult result{0, SendStatuses::SUCCESS};
+		for(Size b = 0; b < numberOfBuffers; ++b)
+		{
+			SendResult sendResult = Send(buffers[b].mData, static_cast<int>(buffers[b].mSize));
+			result.mBytesSent += sendResult.mBytesSent;
+			result.mStatus = sendResult.mStatus;
+			if(sendResult.mStatus!=SendStatuses::SUCCESS || sendResult.mBytesSent!=buffers[b].mSize)
+			{
+				break;
+			}
+		}
+		return result;
+	}
+
 	void Connection::SendDataPacket(shared_ptr<DataPacket> packet, PacketCallback responseCallback, bool prioritise, bool disconnectAfterSend, bool isResponsePacket)
 	{
 		// In the CONNECTING or CONNECTED states we should treat it as connected.
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <stdlib.h>
 #include <stdio.h>
+#include <cstring>
 
 namespace Echo
 {
@@ -28,15 +29,18 @@ namespace Echo
 			return false;
 		}
 
-		mData[0]=packet.Get<u32>(0,0);
-		mData[1]=packet.Get<u32>(1,0);
-		mData[2]=packet.Get<u32>(2,0);
-		mIsBigEndian = packet.IsBigEndian();
+		BuildFromData(packet.GetData(), packet.IsBigEndian());
+		return true;
+	}
+
+	void DataPacketHeader::BuildFromData(const u8* data, bool isBigEndian)
+	{
+		std::memcpy(mData, data, sizeof(mData));
+		mIsBigEndian = isBigEndian;
 		if(mIsBigEndian)
 		{
 			Reorder();
 		}
-		return true;
 	}
 
 	void DataPacketHeader::BuildForPacket(const DataPacket& packet)
@@ -20,9 +20,9 @@ namespace Echo
 		}
 	}
 
-	void NetworkSystem::UpdateReceive( shared_ptr<Connection> connection )
+	void NetworkSystem::UpdateReceive( shared_ptr<Connection> connection, bool drain )
 	{
-		connection->UpdateReceive();
+		connection->UpdateReceive(drain);
 	}
 
 	void NetworkSystem::UpdateSend( shared_ptr<Connection> connection )
@@ -23,6 +23,14 @@
 #include <errno.h>
 #include <unistd.h>
 #include <algorithm>
+#include <limits>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#ifdef ECHO_PLATFORM_LINUX
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
 namespace Echo
 {
@@ -43,7 +51,21 @@ namespace Echo
 		mCount = 0;
 	}
 
-	bool SocketNetworkSystem::SocketThreadTask::AddSocket(Socket s)
+	//////////////////////////////////////////////////////////////////////////
+	//SocketNetworkSystem::PollSocketThreadTask
+	//////////////////////////////////////////////////////////////////////////
+
+	SocketNetworkSystem::PollSocketThreadTask::PollSocketThreadTask(SocketNetworkSystem& s, Size maximumSockets, int pollTimeInMS) :
+		SocketThreadTask(s, maximumSockets, pollTimeInMS),
+		mPollUpdateRequired(false)
+	{
+	}
+
+	SocketNetworkSystem::PollSocketThreadTask::~PollSocketThreadTask()
+	{
+	}
+
+	bool SocketNetworkSystem::PollSocketThreadTask::AddSocket(Socket s)
 	{
 		ScopedLock locky(mPendingSocketsMutex);
 		if(mCount == mMaximumSockets)
@@ -65,7 +87,7 @@ namespace Echo
 		return true;
 	}
 
-	bool SocketNetworkSystem::SocketThreadTask::RemoveSocket(Socket s)
+	bool SocketNetworkSystem::PollSocketThreadTask::RemoveSocket(Socket s)
 	{
 		ScopedLock locky(mPendingSocketsMutex);
 		if( mSocketToPollFDMap.find(s)==mSocketToPollFDMap.end() ||
@@ -82,7 +104,7 @@ namespace Echo
 		return true;
 	}
 
-	void SocketNetworkSystem::SocketThreadTask::EnableWriteCheck(Socket s)
+	void SocketNetworkSystem::PollSocketThreadTask::EnableWriteCheck(Socket s)
 	{
 		ScopedLock locky(mPendingSocketsMutex);
 
@@ -105,7 +127,7 @@ namespace Echo
 		}
 	}
 
-	void SocketNetworkSystem::SocketThreadTask::DisableWriteCheck(Socket s)
+	void SocketNetworkSystem::PollSocketThreadTask::DisableWriteCheck(Socket s)
 	{
 		ScopedLock locky(mPendingSocketsMutex);
 		
@@ -129,7 +151,7 @@ namespace Echo
 		}
 	}
 	
-	void SocketNetworkSystem::SocketThreadTask::InternalAddSocket(Socket s)
+	void SocketNetworkSystem::PollSocketThreadTask::InternalAddSocket(Socket s)
 	{
 		auto it = mSocketToPollFDMap.find(s);
 		if(it!=mSocketToPollFDMap.end())
@@ -151,7 +173,7 @@ namespace Echo
 		mSocketToPollFDMap[s] = mPollFDs.size()-1;
 	}
 	
-	void SocketNetworkSystem::SocketThreadTask::InternalRemoveSocket(Socket s)
+	void SocketNetworkSystem::PollSocketThreadTask::InternalRemoveSocket(Socket s)
 	{
 		auto it = mSocketToPollFDMap.find(s);
 		if(it==mSocketToPollFDMap.end())
@@ -186,7 +208,7 @@ namespace Echo
 		}
 	}
 
-	void SocketNetworkSystem::SocketThreadTask::InternalWriteDisable(Socket s)
+	void SocketNetworkSystem::PollSocketThreadTask::InternalWriteDisable(Socket s)
 	{
 		auto it = mSocketToPollFDMap.find(s);
 		if(it==mSocketToPollFDMap.end())
@@ -206,7 +228,7 @@ namespace Echo
 		pfd.events = pfd.events & ~POLLOUT;
 	}
 	
-	void SocketNetworkSystem::SocketThreadTask::InternalWriteEnable(Socket s)
+	void SocketNetworkSystem::PollSocketThreadTask::InternalWriteEnable(Socket s)
 	{
 		auto it = mSocketToPollFDMap.find(s);
 		if(it==mSocketToPollFDMap.end())
@@ -225,7 +247,7 @@ namespace Echo
 		pfd.events = pfd.events | POLLOUT;
 	}
 
-	void SocketNetworkSystem::SocketThreadTask::Update(Seconds lastFrameTime)
+	void SocketNetworkSystem::PollSocketThreadTask::Update(Seconds lastFrameTime)
 	{
 		if(!mPollFDs.empty())
 		{
@@ -342,19 +364,268 @@ namespace Echo
 		}
 	}
 
+#ifdef ECHO_PLATFORM_LINUX
+	//////////////////////////////////////////////////////////////////////////
+	//SocketNetworkSystem::EpollSocketThreadTask
 	//////////////////////////////////////////////////////////////////////////
-	SocketNetworkSystem::SocketNetworkSystem(NetworkManager& networkManager, Size maximumSocketsPerThread, int pollTimeInMS) : NetworkSystem("Socket", networkManager)
+
+	/**
+	 * Waits on an epoll instance for socket readiness.
+	 * Connection sockets are registered edge-triggered for read and write so each readiness change is reported once
+	 * and the connection is drained until it would block. Listening sockets are registered level-triggered so each
+	 * wake accepts one connection, the same as the POLL backend, and remaining connections are reported again on
+	 * the next wait. Sockets are added and removed with epoll_ctl() directly so there is no pending state to process
+	 * and no per-socket work when nothing is ready.
+	 */
+	class SocketNetworkSystem::EpollSocketThreadTask : public SocketThreadTask
+	{
+	public:
+		EpollSocketThreadTask(SocketNetworkSystem& s, Size maximumSockets, int pollTimeInMS) :
+			SocketThreadTask(s, maximumSockets, pollTimeInMS),
+			mEvents(MAXIMUM_EVENTS_PER_WAIT)
+		{
+			mEpollFD = epoll_create1(EPOLL_CLOEXEC);
+			if(mEpollFD < 0)
+			{
+				ECHO_LOG_ERROR("epoll_create1 failed. errno: " << errno);
+			}
+			mWakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+			if(mWakeFD < 0)
+			{
+				ECHO_LOG_ERROR("eventfd failed. errno: " << errno);
+			}else
+			{
+				epoll_event event;
+				event.events = EPOLLIN;
+				event.data.fd = mWakeFD;
+				epoll_ctl(mEpollFD, EPOLL_CTL_ADD, mWakeFD, &event);
+			}
+		}
+
+		~EpollSocketThreadTask()
+		{
+			if(mWakeFD >= 0)
+			{
+				close(mWakeFD);
+			}
+			if(mEpollFD >= 0)
+			{
+				close(mEpollFD);
+			}
+		}
+
+		bool AddSocket(Socket s) override
+		{
+			if(mEpollFD < 0)
+			{
+				return false;
+			}
+			// Determined before locking to avoid holding both the connection and socket locks.
+			bool edgeTriggered = !mSystem.IsListeningSocket(s);
+			ScopedLock locky(mSocketsMutex);
+			if(mCount == mMaximumSockets)
+			{
+				return false;
+			}
+			if(mSockets.find(s)!=mSockets.end())
+			{
+				ECHO_LOG_ERROR("Socket already added");
+				return false;
+			}
+			SocketState state;
+			state.mEdgeTriggered = edgeTriggered;
+			state.mEvents = edgeTriggered ? (EPOLLIN | EPOLLOUT | EPOLLPRI | EPOLLRDHUP | EPOLLET) : (EPOLLIN | EPOLLPRI);
+			epoll_event event;
+			event.events = state.mEvents;
+			event.data.fd = s;
+			if(epoll_ctl(mEpollFD, EPOLL_CTL_ADD, s, &event)!=0)
+			{
+				ECHO_LOG_ERROR("Unable to add socket to epoll. errno: " << errno);
+				return false;
+			}
+			mSockets[s] = state;
+			mCount++;
+			return true;
+		}
+
+		bool RemoveSocket(Socket s) override
+		{
+			ScopedLock locky(mSocketsMutex);
+			auto it = mSockets.find(s);
+			if(it==mSockets.end())
+			{
+				ECHO_LOG_INFO("Socket already removed");
+				return false;
+			}
+			// Closed sockets are removed from the epoll set automatically so failure here is expected in that case.
+			epoll_ctl(mEpollFD, EPOLL_CTL_DEL, s, nullptr);
+			mSockets.erase(it);
+			mCount--;
+			return true;
+		}
+
+		void EnableWriteCheck(Socket s) override
+		{
+			ScopedLock locky(mSocketsMutex);
+			auto it = mSockets.find(s);
+			if(it==mSockets.end())
+			{
+				ECHO_LOG_ERROR("Cannot enable write check on socket - not added to worker");
+				return;
+			}
+			// Modifying an edge-triggered registration re-arms it, so a socket that became writable before the
+			// connection asked to be notified is still reported.
+			it->second.mEvents |= EPOLLOUT;
+			Modify(s, it->second);
+		}
+
+		void DisableWriteCheck(Socket s) override
+		{
+			ScopedLock locky(mSocketsMutex);
+			auto it = mSockets.find(s);
+			if(it==mSockets.end())
+			{
+				ECHO_LOG_ERROR("Cannot disable write check on socket - not added to worker");
+				return;
+			}
+			// Edge-triggered sockets only report the transition to writable so there is nothing to disable.
+			if(!it->second.mEdgeTriggered)
+			{
+				it->second.mEvents &= ~EPOLLOUT;
+				Modify(s, it->second);
+			}
+		}
+
+		void Wake() override
+		{
+			if(mWakeFD >= 0)
+			{
+				u64 one = 1;
+				if(write(mWakeFD, &one, sizeof(one))!=sizeof(one))
+				{
+					ECHO_LOG_WARNING("Unable to wake socket thread. errno: " << errno);
+				}
+			}
+		}
+
+		void Update(Seconds lastFrameTime) override
+		{
+			int numberOfEvents = epoll_wait(mEpollFD, mEvents.data(), static_cast<int>(mEvents.size()), mPollTimeInMS);
+			if(numberOfEvents < 0)
+			{
+				if(errno!=EINTR)
+				{
+					ECHO_LOG_ERROR("epoll_wait failed. errno: " << errno);
+				}
+				return;
+			}
+
+			for(int e = 0; e < numberOfEvents; ++e)
+			{
+				const epoll_event& event = mEvents[e];
+				Socket s = event.data.fd;
+				if(s==mWakeFD)
+				{
+					u64 value;
+					if(read(mWakeFD, &value, sizeof(value)) < 0)
+					{
+						ECHO_LOG_WARNING("Unable to reset socket thread wake event. errno: " << errno);
+					}
+					continue;
+				}
+
+				bool edgeTriggered;
+				{
+					// The socket may have been removed since epoll_wait() returned.
+					ScopedLock locky(mSocketsMutex);
+					auto it = mSockets.find(s);
+					if(it==mSockets.end())
+					{
+						continue;
+					}
+					edgeTriggered = it->second.mEdgeTriggered;
+				}
+
+				//We'll process read first as this will allow us to detect bad connections.
+				if(event.events & (EPOLLIN | EPOLLPRI | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+				{
+					mSystem.ReadNotify(s, edgeTriggered);
+				}
+
+				if(event.events & EPOLLOUT)
+				{
+					if(!edgeTriggered)
+					{
+						//it is re-enabled in connection write error
+						DisableWriteCheck(s);
+					}
+					mSystem.WriteNotify(s);
+				}
+				//Check for any connecting timeouts.
+				mSystem.CheckForTimeout(s);
+			}
+
+			// A full buffer means more events may be ready, grow so they can be collected in one wait next time.
+			if(static_cast<Size>(numberOfEvents)==mEvents.size() && mEvents.size() < mCount)
+			{
+				mEvents.resize(mEvents.size() * 2);
+			}
+		}
+	private:
+		static const Size MAXIMUM_EVENTS_PER_WAIT = 256;
+
+		struct SocketState
+		{
+			u32 mEvents;
+			bool mEdgeTriggered;
+		};
+
+		// mSocketsMutex must be locked
+		void Modify(Socket s, const SocketState& state)
+		{
+			epoll_event event;
+			event.events = state.mEvents;
+			event.data.fd = s;
+			if(epoll_ctl(mEpollFD, EPOLL_CTL_MOD, s, &event)!=0)
+			{
+				ECHO_LOG_ERROR("Unable to modify socket epoll events. errno: " << errno);
+			}
+		}
+
+		int mEpollFD;
+		int mWakeFD;
+		Mutex mSocketsMutex;
+		std::unordered_map< Socket, SocketState > mSockets;
+		std::vector< epoll_event > mEvents;
+	};
+#endif
+
+	//////////////////////////////////////////////////////////////////////////
+	SocketNetworkSystem::SocketNetworkSystem(NetworkManager& networkManager, Size maximumSocketsPerThread, int pollTimeInMS, Backend backend, Size numberOfIOThreads) : NetworkSystem("Socket", networkManager)
 	{
 		mStarted = false;
+		#ifndef ECHO_PLATFORM_LINUX
+		if(backend==Backends::EPOLL)
+		{
+			ECHO_LOG_WARNING("The EPOLL SocketNetworkSystem backend is not available on this platform. Falling back to POLL.");
+			backend = Backends::POLL;
+		}
+		#endif
+		mBackend = backend;
 		// Use system maximum.
 		if(maximumSocketsPerThread==0)
 		{
-			mMaximumSocketsPerThread = FD_SETSIZE;
+			mMaximumSocketsPerThread = (mBackend==Backends::POLL) ? FD_SETSIZE : std::numeric_limits<Size>::max();
 		}else
 		{
 			mMaximumSocketsPerThread = maximumSocketsPerThread;
 		}
 		mPollTimeInMS = pollTimeInMS;
+		if(numberOfIOThreads==0)
+		{
+			numberOfIOThreads = std::max<Size>(1, std::thread::hardware_concurrency());
+		}
+		mNumberOfIOThreads = numberOfIOThreads;
 	}
 
 	SocketNetworkSystem::~SocketNetworkSystem()
@@ -365,7 +636,21 @@ namespace Echo
 	bool SocketNetworkSystem::Initialise()
 	{
 		mPlatformDetail = SocketNetworkPlatformDetail::Create();
-		return (mPlatformDetail!=nullptr);
+		if(!mPlatformDetail)
+		{
+			return false;
+		}
+		if(mBackend==Backends::EPOLL && mSocketThreadShards.empty())
+		{
+			ScopedLock locky(mSocketThreadTasksMutex);
+			for(Size t = 0; t < mNumberOfIOThreads; ++t)
+			{
+				shared_ptr<ThreadTaskPair> taskPair = CreateThreadTask();
+				mSocketThreadShards.push_back(taskPair);
+				mSocketThreadTasks.push_back(taskPair);
+			}
+		}
+		return true;
 	}
 
 	bool SocketNetworkSystem::Start()
@@ -406,8 +691,14 @@ namespace Echo
 		for(auto t : threads)
 		{
 			t->mThread->SetThreadCompleteCallback(Thread::ThreadCompleteCallback());
+			t->mThread->Terminate();
+			t->mSocketThreadTask->Wake();
+		}
+		for(auto t : threads)
+		{
 			t->mThread->Terminate(true);
 		}
+		mSocketThreadShards.clear();
 		mStarted = false;
 		mPlatformDetail.reset();
 	}
@@ -558,7 +849,7 @@ namespace Echo
 		return false;
 	}
 	
-	void SocketNetworkSystem::ReadNotify(Socket s)
+	void SocketNetworkSystem::ReadNotify(Socket s, bool drain)
 	{
 		mConnectionsMutex.Lock();
 		std::map< Socket, shared_ptr<Connection> >::iterator it = mConnections.find(s);
@@ -578,7 +869,7 @@ namespace Echo
 				return;
 			}
 		}
-		UpdateReceive(connection);
+		UpdateReceive(connection, drain);
 	}
 
 	void SocketNetworkSystem::WriteNotify(Socket s)
@@ -826,6 +1117,15 @@ namespace Echo
 
 	void SocketNetworkSystem::EnableSocketWriteCheck(Socket s)
 	{
+		if(mBackend==Backends::EPOLL)
+		{
+			shared_ptr<ThreadTaskPair> shard = GetSocketThreadShard(s);
+			if(shard)
+			{
+				shard->mSocketThreadTask->EnableWriteCheck(s);
+			}
+			return;
+		}
 		std::map< Socket, shared_ptr<ThreadTaskPair> >::iterator sttit = mSocketThreadTaskConnectionLookup.find(s);
 		if(sttit != mSocketThreadTaskConnectionLookup.end())
 		{
@@ -835,6 +1135,15 @@ namespace Echo
 
 	void SocketNetworkSystem::DisableSocketWriteCheck(Socket s)
 	{
+		if(mBackend==Backends::EPOLL)
+		{
+			shared_ptr<ThreadTaskPair> shard = GetSocketThreadShard(s);
+			if(shard)
+			{
+				shard->mSocketThreadTask->DisableWriteCheck(s);
+			}
+			return;
+		}
 		std::map< Socket, shared_ptr<ThreadTaskPair> >::iterator sttit = mSocketThreadTaskConnectionLookup.find(s);
 		if(sttit != mSocketThreadTaskConnectionLookup.end())
 		{
@@ -869,7 +1178,19 @@ namespace Echo
 		{
 			return false;
 		}
-		
+
+		// The I/O threads don't change after initialisation so a lock isn't needed.
+		if(mBackend==Backends::EPOLL)
+		{
+			shared_ptr<ThreadTaskPair> shard = GetSocketThreadShard(s);
+			if(!shard || !shard->mSocketThreadTask->AddSocket(s))
+			{
+				ECHO_LOG_ERROR("Unable to assign socket to I/O thread");
+				return false;
+			}
+			return true;
+		}
+
 		ScopedLock locky(mSocketThreadTasksMutex);
 
 		// Clean up from any previous tasks
@@ -890,17 +1211,13 @@ namespace Echo
 			// Did it lie to us?
 			if(taskPair->mSocketThreadTask->AddSocket(s))
 			{
+				mSocketThreadTaskConnectionLookup[s] = taskPair;
 				return true;
 			}
 			ECHO_LOG_WARNING("FindAvailableSocketThreadTask() returned a task that is not available. This shouldn't happen. I will start up a new task.");
 		}
 		
-		taskPair.reset(new ThreadTaskPair());
-		taskPair->mSocketThreadTask.reset(new SocketThreadTask(*this, mMaximumSocketsPerThread, mPollTimeInMS));
-		taskPair->mThread.reset(new TaskThread("SocketNetworkSystem worker"));
-			
-		taskPair->mThread->AddTask(taskPair->mSocketThreadTask);
-		taskPair->mThread->SetThreadCompleteCallback(std::bind(&SocketNetworkSystem::OnThreadTaskComplete,this,taskPair));
+		taskPair = CreateThreadTask();
 		if(!taskPair->mSocketThreadTask->AddSocket(s))
 		{
 			ECHO_LOG_ERROR("Unable to assign socket to new worker thread");
@@ -1010,7 +1327,7 @@ namespace Echo
 				return false;
 			}
 
-			if(!HandleError(echo_listen(s, 0)))
+			if(!HandleError(echo_listen(s, SOMAXCONN)))
 			{
 				ECHO_LOG_ERROR("setting socket for listening.");
 				return false;
@@ -1099,6 +1416,49 @@ namespace Echo
 		return connection;
 	}
 	
+	shared_ptr<SocketNetworkSystem::ThreadTaskPair> SocketNetworkSystem::CreateThreadTask()
+	{
+		shared_ptr<ThreadTaskPair> taskPair(new ThreadTaskPair());
+		#ifdef ECHO_PLATFORM_LINUX
+		if(mBackend==Backends::EPOLL)
+		{
+			taskPair->mSocketThreadTask.reset(new EpollSocketThreadTask(*this, mMaximumSocketsPerThread, mPollTimeInMS));
+		}else
+		#endif
+		{
+			taskPair->mSocketThreadTask.reset(new PollSocketThreadTask(*this, mMaximumSocketsPerThread, mPollTimeInMS));
+		}
+		taskPair->mThread.reset(new TaskThread("SocketNetworkSystem worker"));
+		taskPair->mThread->AddTask(taskPair->mSocketThreadTask);
+		// The EPOLL I/O threads run until CleanUp() so they don't need to be cleaned up when they complete.
+		if(mBackend==Backends::POLL)
+		{
+			taskPair->mThread->SetThreadCompleteCallback(std::bind(&SocketNetworkSystem::OnThreadTaskComplete,this,taskPair));
+		}
+		return taskPair;
+	}
+
+	shared_ptr<SocketNetworkSystem::ThreadTaskPair> SocketNetworkSystem::GetSocketThreadShard(Socket s) const
+	{
+		if(mSocketThreadShards.empty())
+		{
+			ECHO_LOG_ERROR("SocketNetworkSystem has no I/O threads. Has it been initialised?");
+			return nullptr;
+		}
+		// Mix the bits so sequentially allocated sockets spread evenly when the number of threads is a power of two.
+		u32 hash = static_cast<u32>(s);
+		hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
+		hash = ((hash >> 16) ^ hash) * 0x45d9f3b;
+		hash = (hash >> 16) ^ hash;
+		return mSocketThreadShards[hash % mSocketThreadShards.size()];
+	}
+
+	bool SocketNetworkSystem::IsListeningSocket(Socket s)
+	{
+		ScopedLock locky(mConnectionsMutex);
+		return mIncomingConnectionListeners.find(s)!=mIncomingConnectionListeners.end();
+	}
+
 	shared_ptr<SocketNetworkSystem::ThreadTaskPair> SocketNetworkSystem::FindAvailableSocketThreadTask()
 	{
 		for(auto& it : mSocketThreadTasks)
@@ -1134,6 +1494,29 @@ namespace Echo
 		}
 		mConnectionsMutex.Unlock();
 
+		if(mBackend==Backends::EPOLL)
+		{
+			// Sockets map directly to an I/O thread so there is no lookup to maintain.
+			if(originalSocket != -1)
+			{
+				shared_ptr<ThreadTaskPair> shard = GetSocketThreadShard(originalSocket);
+				if(shard)
+				{
+					shard->mSocketThreadTask->RemoveSocket(originalSocket);
+				}
+			}
+			if(s == -1)
+			{
+				return true;
+			}
+			if(!AssignThreadTask(s))
+			{
+				ECHO_LOG_ERROR("Failed to add the socket to the socket task. This socket will not be readable or writable.");
+				return false;
+			}
+			return true;
+		}
+
 		//Find Thread Task that has the connection and update it
 		std::map< Socket, shared_ptr<ThreadTaskPair> >::iterator sttit = mSocketThreadTaskConnectionLookup.find(originalSocket);
 		if(sttit != mSocketThreadTaskConnectionLookup.end())
@@ -7,6 +7,10 @@
 #include <iostream>
 #include <errno.h>
 #include <unistd.h>
+#include <algorithm>
+#ifdef ECHO_POSIX_NETWORKING
+#include <sys/uio.h>
+#endif
 namespace Echo
 {
 	TCPConnection::TCPConnection(SocketNetworkSystem& manager, const std::string& address, u16 port, Socket s) :
@@ -781,4 +785,44 @@ namespace Echo
 		return SendResult{0,SendStatuses::DISCONNECT};
 	#endif
 	}
+
+#ifdef ECHO_POSIX_NETWORKING
+	Connection::SendResult TCPConnection::SendVectored(const SendBuffer* buffers, Size numberOfBuffers)
+	{
+		iovec iov[MAXIMUM_PACKETS_PER_SEND*2];
+		Size numberOfIOVectors = std::min<Size>(numberOfBuffers, SizeOfArray(iov));
+		for(Size b = 0; b < numberOfIOVectors; ++b)
+		{
+			iov[b].iov_base = const_cast<u8*>(buffers[b].mData);
+			iov[b].iov_len = buffers[b].mSize;
+		}
+		msghdr message;
+		memset(&message, 0, sizeof(msghdr));
+		message.msg_iov = iov;
+		message.msg_iovlen = numberOfIOVectors;
+
+		ssize_t code = sendmsg(mSocket, &message, ECHO_SOCKET_SEND_NO_SIG_FLAGS);
+		if(code >= 0)
+		{
+			return SendResult{Size(code),SendStatuses::SUCCESS};
+		}
+
+		switch(errno)
+		{
+		//case EAGAIN:
+		case EWOULDBLOCK:
+		case ENOBUFS:
+			//This is ok, we'll just try again when write becomes available.
+			mManager.EnableSocketWriteCheck(mSocket);
+			return SendResult{0,SendStatuses::WAIT};
+		case EINTR:
+			// Nothing was sent, treat it as a zero byte send so the caller tries again.
+			return SendResult{0,SendStatuses::SUCCESS};
+		default:
+			ECHO_LOG_ERROR("sendmsg failed. errno: " << errno);
+			break;
+		}
+		return SendResult{0,SendStatuses::DISCONNECT};
+	}
+#endif
 }
@@ -26,7 +26,18 @@
 #endif
 namespace Echo
 {
-	GLRenderTarget::GLRenderTarget(shared_ptr<GLContext> context) : mContext(context)
+	namespace
+	{
+		// Texture reference used when the bound texture is unknown.
+		const GLuint UNKNOWN_TEXTURE = ~GLuint(0);
+	}
+
+	GLRenderTarget::GLRenderTarget(shared_ptr<GLContext> context) :
+		mContext(context),
+		mBatching(false),
+		mProgramDeactivatePending(false),
+		mVertexBufferResetPending(false),
+		mTextureStagesToReset(0)
 	{
 		mWidth = 0;
 		mHeight = 0;
@@ -39,6 +50,7 @@ namespace Echo
 		mTextureDelegate = ResourceDelegate<Texture>::Create();
 		mCubeMapTextureDelegate = ResourceDelegate<CubeMapTexture>::Create();
 		mVertexBufferDelegate = ResourceDelegate<VertexBuffer>::Create();
+		mTextureStagesSetInBatch.resize(mMaxTextureStages, false);
 		//std::string glVersion(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
 		//ECHO_LOG_INFO("Open GL version: " << glVersion);
 	}
@@ -86,7 +98,18 @@ namespace Echo
 		mContext->mTextureCoordinateArrayEnabled = new bool[mMaxTextureStages];
 		mContext->mTexture2DEnabled = new bool[mMaxTextureStages];
 		mContext->mTextureCoordinateArrayIndex = new Size[mMaxTextureStages];
-		
+		delete [] mContext->mBoundTextures;
+		mContext->mBoundTextures = new GLuint[mMaxTextureStages];
+		InvalidateTextureBindings();
+		mTextureStagesSetInBatch.assign(mMaxTextureStages, false);
+	}
+
+	void GLRenderTarget::InvalidateTextureBindings()
+	{
+		if(mContext->mBoundTextures)
+		{
+			std::fill(mContext->mBoundTextures, mContext->mBoundTextures + mMaxTextureStages, UNKNOWN_TEXTURE);
+		}
 	}
 
 	bool GLRenderTarget::Activate()
@@ -127,6 +150,9 @@ namespace Echo
 	void GLRenderTarget::ContextLost()
 	{
 		mContext->mContextReady = false;
+		InvalidateTextureBindings();
+		mContext->mBlendModeKnown = false;
+		mContext->mCullModeKnown = false;
 		{
 			ScopedLock lock(mContext->mTextureLookupMutex);
 			mContext->mTextureLookup.clear();
@@ -313,6 +339,21 @@ namespace Echo
 	
 	void GLRenderTarget::ResetTextureUnits()
 	{
+		if(mBatching)
+		{
+			// Unbinding is deferred until the next draw so stages that are set again don't need to be rebound.
+			// Texture coordinate arrays are still disabled since SetVertexBuffer() enables the ones in use.
+			for(u32 i=0; i<mContext->mMaxTextureStagesUsed;++i)
+			{
+				glActiveTexture(GL_TEXTURE0 + i);
+				glClientActiveTexture(GL_TEXTURE0 + i);
+				glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+			}
+			mTextureStagesToReset = std::max(mTextureStagesToReset, mContext->mMaxTextureStagesUsed);
+			std::fill(mTextureStagesSetInBatch.begin(), mTextureStagesSetInBatch.begin() + mTextureStagesToReset, false);
+			mContext->mMaxTextureStagesUsed=0;
+			return;
+		}
 		for(u32 i=0; i<mContext->mMaxTextureStagesUsed;++i)
 		{
 			glActiveTexture(GL_TEXTURE0 + i);
@@ -323,6 +364,7 @@ namespace Echo
 				glBindTexture(GL_TEXTURE_2D, 0);
 				glDisable(GL_TEXTURE_2D);
 				mContext->mTexture2DEnabled[i] = false;
+				mContext->mBoundTextures[i] = 0;
 			}
 		}
 		mContext->mMaxTextureStagesUsed=0;
@@ -335,9 +377,49 @@ namespace Echo
 
 	void GLRenderTarget::SetVertexBuffer(shared_ptr<VertexBuffer> vertexBuffer)
 	{
+		if(mBatching)
+		{
+			if(!vertexBuffer && mProgramDeactivatePending)
+			{
+				// The next draw will likely use a program as well, wait to see if the buffer changes.
+				mVertexBufferResetPending = true;
+				return;
+			}
+			if(vertexBuffer && mContext->mActiveProgram && !mProgramDeactivatePending)
+			{
+				// The pending reset would only unbind the buffer this call replaces.
+				mVertexBufferResetPending = false;
+				shared_ptr<GLVertexBuffer> vertexBufferGL = GetGLVertexBuffer(vertexBuffer.get());
+				if(vertexBufferGL && vertexBufferGL==mContext->mActiveVertexBuffer)
+				{
+					mStatistics.mRedundantBindsSkipped++;
+					return;
+				}
+				if(mContext->mActiveVertexBuffer)
+				{
+					mContext->mActiveVertexBuffer->Unbind();
+				}
+				mContext->mActiveVertexBuffer = vertexBufferGL;
+				if(vertexBufferGL)
+				{
+					vertexBufferGL->Bind();
+					mStatistics.mVertexBufferBinds++;
+				}
+				return;
+			}
+			ApplyDeferredState();
+		}
+
+		if(!vertexBuffer)
+		{
+			ResetVertexBuffer();
+			return;
+		}
+
 		if(mContext->mActiveVertexBuffer)
 		{
 			mContext->mActiveVertexBuffer->Unbind();
+			mContext->mActiveVertexBuffer.reset();
 		}
 
 		if(mContext->mActiveProgram)
@@ -346,53 +428,28 @@ namespace Echo
 			if(mContext->mActiveVertexBuffer)
 			{
 				mContext->mActiveVertexBuffer->Bind();
+				mStatistics.mVertexBufferBinds++;
 			}
 		}else
 		{
-			if(!vertexBuffer)
+			// The layout has the attribute offsets resolved so there are no name lookups here.
+			const VertexLayout& layout = *vertexBuffer->GetLayout();
+			const char* data = vertexBuffer->GetDataPointer();
+			GLsizei stride = static_cast<GLsizei>(layout.GetStride());
+			const VertexLayout::Slot& vertices = layout.GetPositionSlot();
+			if(vertices.IsValid())
 			{
-				if(mContext->mVertexArrayEnabled)
-				{
-					glDisableClientState(GL_VERTEX_ARRAY);
-					mContext->mVertexArrayEnabled = false;
-				}
-				if(mContext->mNormalArrayEnabled)
-				{
-					glDisableClientState(GL_NORMAL_ARRAY);
-					mContext->mNormalArrayEnabled = false;
-				}
-				if(mContext->mColourArrayEnabled)
-				{
-					glDisableClientState(GL_COLOR_ARRAY);
-					mContext->mColourArrayEnabled = false;
-				}
-				for(Size i=0;i<mContext->mMaxTextureStagesUsed; ++i)
-				{
-					mContext->mActiveTextureStage = i;
-					glActiveTexture(GL_TEXTURE0 + i);
-					glClientActiveTexture(GL_TEXTURE0 + i);
-					if(mContext->mTextureCoordinateArrayEnabled[i])
-					{
-						glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-						mContext->mTextureCoordinateArrayEnabled[i] = false;
-					}
-				}
-				return;
-			}
-			VertexBuffer::Accessor<Vector3> vertices = vertexBuffer->GetAccessor<Vector3>("Position");
-			if(vertices)
-			{
-				glVertexPointer(3, GL_FLOAT, vertexBuffer->GetStride(), &(vertices[0]));
+				glVertexPointer(3, GL_FLOAT, stride, data + vertices.mOffset);
 				if(!mContext->mVertexArrayEnabled)
 				{
 					glEnableClientState(GL_VERTEX_ARRAY);
 					mContext->mVertexArrayEnabled = true;
 				}
 			}
-			VertexBuffer::Accessor<Vector3> normals = vertexBuffer->GetAccessor<Vector3>("Normal");
-			if(normals)
+			const VertexLayout::Slot& normals = layout.GetNormalSlot();
+			if(normals.IsValid())
 			{
-				glNormalPointer(GL_FLOAT, vertexBuffer->GetStride(), &(normals[0]));
+				glNormalPointer(GL_FLOAT, stride, data + normals.mOffset);
 				if(!mContext->mNormalArrayEnabled)
 				{
 					glEnableClientState(GL_NORMAL_ARRAY);
@@ -401,10 +458,10 @@ namespace Echo
 			}
 			if(mContext->mVertexColourEnabled)
 			{
-				VertexBuffer::Accessor<VertexColour> colours = vertexBuffer->GetAccessor<VertexColour>("Colour");
-				if(colours)
+				const VertexLayout::Slot& colours = layout.GetColourSlot();
+				if(colours.IsValid())
 				{
-					glColorPointer(4, GL_UNSIGNED_BYTE, vertexBuffer->GetStride(), &(colours[0]));
+					glColorPointer(4, GL_UNSIGNED_BYTE, stride, data + colours.mOffset);
 					if(!mContext->mColourArrayEnabled)
 					{
 						glEnableClientState(GL_COLOR_ARRAY);
@@ -414,15 +471,13 @@ namespace Echo
 			}
 			for(Size i=0;i<mContext->mMaxTextureStagesUsed; ++i)
 			{
-				std::stringstream ss;
-				ss << "UV" << mContext->mTextureCoordinateArrayIndex[i];
-				VertexBuffer::Accessor<TextureUV> uvs = vertexBuffer->GetAccessor<TextureUV>(ss.str());
-				if(uvs)
+				const VertexLayout::Slot& uvs = layout.GetTextureCoordinateSlot(mContext->mTextureCoordinateArrayIndex[i]);
+				if(uvs.IsValid())
 				{
 					mContext->mActiveTextureStage = i;
 					glActiveTexture(GL_TEXTURE0 + i);
 					glClientActiveTexture(GL_TEXTURE0 + i);
-					glTexCoordPointer(2, GL_FLOAT, vertexBuffer->GetStride(), &(uvs[0]));
+					glTexCoordPointer(2, GL_FLOAT, stride, data + uvs.mOffset);
 					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 					SetTexture2DEnabled(true,i);
 					mContext->mTextureCoordinateArrayEnabled[i] = true;
@@ -432,6 +487,45 @@ namespace Echo
 
 	}
 	
+	void GLRenderTarget::ResetVertexBuffer()
+	{
+		if(mContext->mActiveVertexBuffer)
+		{
+			mContext->mActiveVertexBuffer->Unbind();
+			mContext->mActiveVertexBuffer.reset();
+		}
+		if(mContext->mActiveProgram)
+		{
+			return;
+		}
+		if(mContext->mVertexArrayEnabled)
+		{
+			glDisableClientState(GL_VERTEX_ARRAY);
+			mContext->mVertexArrayEnabled = false;
+		}
+		if(mContext->mNormalArrayEnabled)
+		{
+			glDisableClientState(GL_NORMAL_ARRAY);
+			mContext->mNormalArrayEnabled = false;
+		}
+		if(mContext->mColourArrayEnabled)
+		{
+			glDisableClientState(GL_COLOR_ARRAY);
+			mContext->mColourArrayEnabled = false;
+		}
+		for(Size i=0;i<mContext->mMaxTextureStagesUsed; ++i)
+		{
+			mContext->mActiveTextureStage = i;
+			glActiveTexture(GL_TEXTURE0 + i);
+			glClientActiveTexture(GL_TEXTURE0 + i);
+			if(mContext->mTextureCoordinateArrayEnabled[i])
+			{
+				glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+				mContext->mTextureCoordinateArrayEnabled[i] = false;
+			}
+		}
+	}
+
 	void GLRenderTarget::SetVertexSource(Vector2* source)
 	{
 		if(source)
@@ -571,6 +665,10 @@ namespace Echo
 	
 	void GLRenderTarget::DrawElements(const ElementBuffer& elementBuffer)
 	{
+		if(mBatching)
+		{
+			ApplyDeferredState();
+		}
 		GLint indexType = elementBuffer.GetIndexType()==ElementBuffer::IndexTypes::UNSIGNED_16BIT ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 		GLenum elementType;
 		switch(elementBuffer.GetElementType())
@@ -597,30 +695,56 @@ namespace Echo
 		}
 		glDrawElements(elementType, (GLsizei)(elementBuffer.GetNumberOfIndices()), indexType, elementBuffer.GetDataPointer());
 		EchoCheckOpenGLError();
+		mStatistics.mDrawCalls++;
 	}
 	
 	void GLRenderTarget::DrawTriangles(std::vector<u16>& indices)
 	{
+		if(mBatching)
+		{
+			ApplyDeferredState();
+		}
 		glDrawElements(GL_TRIANGLES, (GLsizei)(indices.size()), GL_UNSIGNED_SHORT, &indices[0]);
+		mStatistics.mDrawCalls++;
 	}
 
 	void GLRenderTarget::DrawTriangleStrip(std::vector<u16>& indices)
 	{
+		if(mBatching)
+		{
+			ApplyDeferredState();
+		}
 		glDrawElements(GL_TRIANGLE_STRIP, (GLsizei)(indices.size()), GL_UNSIGNED_SHORT, &indices[0]);
+		mStatistics.mDrawCalls++;
 	}
 	
 	void GLRenderTarget::DrawLines(std::vector<u16>& indices, f32 lineWidth)
 	{
+		if(mBatching)
+		{
+			ApplyDeferredState();
+		}
 		glDrawElements(GL_LINES, (GLsizei)(indices.size()), GL_UNSIGNED_SHORT, &indices[0]);
+		mStatistics.mDrawCalls++;
 	}
 
 	void GLRenderTarget::DrawLineStrip(std::vector<u16>& indices, f32 lineWidth)
 	{
+		if(mBatching)
+		{
+			ApplyDeferredState();
+		}
 		glDrawElements(GL_LINE_STRIP, (GLsizei)(indices.size()), GL_UNSIGNED_SHORT, &indices[0]);
+		mStatistics.mDrawCalls++;
 	}
 
 	void GLRenderTarget::DrawPoints(std::vector<u16>& indices, f32 pointSize)
 	{
+		if(mBatching)
+		{
+			ApplyDeferredState();
+		}
+		mStatistics.mDrawCalls++;
 #ifndef ECHO_GLES_SUPPORT
 		glEnable(GL_POINT_SPRITE);
 		glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_TRUE);
@@ -723,6 +847,8 @@ namespace Echo
 
 		if(createTexture)
 		{
+			// Creating the texture binds it and may reuse the name of a deleted texture.
+			InvalidateTextureBindings();
 			textureGL.reset(new GLTexture(*texture));
 			mContext->mTextureLookup[texture] = textureGL;
 
@@ -793,7 +919,7 @@ namespace Echo
 		if(buildIfNotFound)
 		{
 			shared_ptr<GLShaderProgram> shaderProgramGL(new GLShaderProgram());
-			if(!shaderProgramGL->CompileAndLink(*shaderProgram))
+			if(!shaderProgramGL->CompileAndLink(*shaderProgram, *mContext))
 			{
 				ECHO_LOG_ERROR("Failed to build shader program:" << shaderProgramGL->GetErrors());
 				return shared_ptr<GLShaderProgram>();
@@ -813,7 +939,7 @@ namespace Echo
 		shared_ptr<GLVertexBuffer> vertexBufferGL;
 		{
 			ScopedLock lock(mContext->mVertexBufferLookupMutex);
-			std::map<VertexBuffer*, shared_ptr<GLVertexBuffer> >::iterator it = mContext->mVertexBufferLookup.find(vertexBuffer);
+			std::unordered_map<VertexBuffer*, shared_ptr<GLVertexBuffer> >::iterator it = mContext->mVertexBufferLookup.find(vertexBuffer);
 			
 			if(it!=mContext->mVertexBufferLookup.end())
 			{
@@ -844,10 +970,23 @@ namespace Echo
 			return;
 		}
 		
+		if(mBatching)
+		{
+			mTextureStagesSetInBatch[stage] = true;
+		}
+		
 		shared_ptr<GLTexture> textureGL = GetGLTexture(texture);
+		const GLuint reference = textureGL->GetGLReference();
+		if(mContext->mBoundTextures[stage]==reference)
+		{
+			mStatistics.mRedundantBindsSkipped++;
+			return;
+		}
 
-		glBindTexture(GL_TEXTURE_2D, textureGL->GetGLReference());
+		glBindTexture(GL_TEXTURE_2D, reference);
 		EchoCheckOpenGLError();
+		mContext->mBoundTextures[stage] = reference;
+		mStatistics.mTextureBinds++;
 	}
 
 	void GLRenderTarget::SetCubeMap(CubeMapTexture* cubeMapTexture, u32 stage)
@@ -874,8 +1013,19 @@ namespace Echo
 		shared_ptr<GLShaderProgram> glShader = GetGLShaderProgram(shaderProgram.get(),true);
 		if(glShader)
 		{
-			glShader->Activate();
+			if(mBatching && glShader==mContext->mActiveProgram)
+			{
+				// Still active from the previous draw so only the variables need to be set.
+				mProgramDeactivatePending = false;
+				mStatistics.mUniformUploads += glShader->SetVariables();
+				mStatistics.mRedundantBindsSkipped++;
+				return true;
+			}
+			// Activating a different program replaces any that is pending deactivation.
+			mProgramDeactivatePending = false;
+			mStatistics.mUniformUploads += glShader->Activate();
 			mContext->mActiveProgram = glShader;
+			mStatistics.mProgramBinds++;
 			return true;
 		}
 		return false;
@@ -883,6 +1033,11 @@ namespace Echo
 
 	void GLRenderTarget::DeactivateProgram(shared_ptr<ShaderProgram> shaderProgram)
 	{
+		if(mBatching && mContext->mActiveProgram)
+		{
+			mProgramDeactivatePending = true;
+			return;
+		}
 		shared_ptr<GLShaderProgram> glShader = GetGLShaderProgram(shaderProgram.get(),false);
 		if(glShader)
 		{
@@ -896,6 +1051,47 @@ namespace Echo
 		return (GetGLShaderProgram(shaderProgram.get(),true) != nullptr);
 	}
 
+	void GLRenderTarget::BeginBatch()
+	{
+		mBatching = true;
+	}
+
+	void GLRenderTarget::EndBatch()
+	{
+		ApplyDeferredState();
+		mBatching = false;
+	}
+
+	void GLRenderTarget::ApplyDeferredState()
+	{
+		if(mProgramDeactivatePending)
+		{
+			mProgramDeactivatePending = false;
+			if(mContext->mActiveProgram)
+			{
+				mContext->mActiveProgram->Deactivate();
+				mContext->mActiveProgram = nullptr;
+			}
+		}
+		if(mVertexBufferResetPending)
+		{
+			mVertexBufferResetPending = false;
+			ResetVertexBuffer();
+		}
+		for(u32 i=0; i<mTextureStagesToReset; ++i)
+		{
+			if(!mTextureStagesSetInBatch[i] && mContext->mTexture2DEnabled[i])
+			{
+				glActiveTexture(GL_TEXTURE0 + i);
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glDisable(GL_TEXTURE_2D);
+				mContext->mTexture2DEnabled[i] = false;
+				mContext->mBoundTextures[i] = 0;
+			}
+		}
+		mTextureStagesToReset = 0;
+	}
+
 	void GLRenderTarget::SetTexGen(const TextureUnit::TextureGenerationModeSet& texGen, u32 stage)
 	{
 		if(!_SetActiveTextureStage(stage))
@@ -979,6 +1175,12 @@ namespace Echo
 
 	void GLRenderTarget::SetBlendMode(const BlendMode& val)
 	{
+		if(mContext->mBlendModeKnown && mContext->mBlendMode==val)
+		{
+			return;
+		}
+		mContext->mBlendMode = val;
+		mContext->mBlendModeKnown = true;
 		switch(val)
 		{
 			case BlendModes::TRANSPARENT:
@@ -1329,6 +1531,12 @@ namespace Echo
 
 	void GLRenderTarget::SetCullMode(const RenderPass::CullMode& val)
 	{
+		if(mContext->mCullModeKnown && mContext->mCullMode==val)
+		{
+			return;
+		}
+		mContext->mCullMode = val;
+		mContext->mCullModeKnown = true;
 		if(val == RenderPass::CullModes::NONE)
 			glDisable(GL_CULL_FACE);
 		else
@@ -1569,7 +1777,7 @@ namespace Echo
 	void GLRenderTarget::OnResourceDestroyed(VertexBuffer* vertexBuffer)
 	{
 		ScopedLock lock(mContext->mVertexBufferLookupMutex);
-		std::map<VertexBuffer*, shared_ptr<GLVertexBuffer> >::iterator it = mContext->mVertexBufferLookup.find(vertexBuffer);
+		std::unordered_map<VertexBuffer*, shared_ptr<GLVertexBuffer> >::iterator it = mContext->mVertexBufferLookup.find(vertexBuffer);
 		if(it!=mContext->mVertexBufferLookup.end())
 		{
 			mContext->mVertexBuffersToClean.Insert(it->second);
@@ -2,6 +2,9 @@
 #include <echo/Platforms/GL/GLShaderProgram.h>
 #include <echo/Graphics/Shader.h>
 #include <echo/Platforms/GL/GLShader.h>
+#include <echo/Platforms/GL/GLContext.h>
+#include <echo/Platforms/GL/GLUniformRingBuffer.h>
+#include <echo/Kernel/ScopedLock.h>
 #include <echo/Maths/Vector2.h>
 #include <echo/Maths/Matrix4.h>
 #include <iostream>
@@ -21,7 +24,7 @@ namespace Echo
 	{
 	}
 
-	bool GLShaderProgram::CompileAndLink(ShaderProgram& shaderProgram)
+	bool GLShaderProgram::CompileAndLink(ShaderProgram& shaderProgram, GLContext& context)
 	{
 #ifdef ECHO_GL_SUPPORTS_SHADER
 		//Compile all of the shaders.
@@ -56,6 +59,7 @@ namespace Echo
 		{
 			glDeleteProgram(mProgramHandle);
 			mTargetVariables.clear();
+			mUniformBlocks.clear();
 		}
 		mProgramHandle = glCreateProgram();
 
@@ -71,6 +75,62 @@ namespace Echo
 		glGetObjectParameterivARB(mProgramHandle, GL_OBJECT_LINK_STATUS_ARB, &linked);
 		if (linked) 
 		{
+#ifdef ECHO_GL_SUPPORTS_UNIFORM_BUFFER
+			// Find the program's uniform blocks, indexed by block index. Blocks are shared with other programs
+			// by name and each has its own binding point.
+			std::vector< shared_ptr<GLUniformBlock> > blocks;
+			GLint numBlocks = 0;
+			glGetProgramiv(mProgramHandle, GL_ACTIVE_UNIFORM_BLOCKS, &numBlocks);
+			if(numBlocks > 0)
+			{
+				GLint maxBlockNameLength = 0;
+				GLint maxBindings = 0;
+				glGetProgramiv(mProgramHandle, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockNameLength);
+				glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings);
+				std::vector<char> blockName(maxBlockNameLength + 1);
+				blocks.resize(numBlocks);
+
+				ScopedLock lock(context.mUniformBlockLookupMutex);
+				if(!context.mUniformRingBuffer)
+				{
+					context.mUniformRingBuffer = make_shared<GLUniformRingBuffer>();
+				}
+				mUniformRingBuffer = context.mUniformRingBuffer;
+				for(GLint b = 0; b < numBlocks; ++b)
+				{
+					glGetActiveUniformBlockName(mProgramHandle, b, maxBlockNameLength + 1, 0, blockName.data());
+					GLint dataSize = 0;
+					glGetActiveUniformBlockiv(mProgramHandle, b, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+					std::string name = blockName.data();
+
+					shared_ptr<GLUniformBlock> block;
+					std::map< std::string, shared_ptr<GLUniformBlock> >::iterator it = context.mUniformBlockLookup.find(name);
+					if(it!=context.mUniformBlockLookup.end())
+					{
+						block = it->second;
+						if(block->GetSize()!=static_cast<Size>(dataSize))
+						{
+							ECHO_LOG_ERROR("GLShaderProgram: Uniform block \"" << name << "\" is " << dataSize << " bytes but another program's is " << block->GetSize() << " bytes. Use the std140 layout and the same declaration. Ignoring block.");
+							continue;
+						}
+					}else
+					{
+						Size bindingPoint = context.mUniformBlockLookup.size();
+						if(bindingPoint >= static_cast<Size>(maxBindings))
+						{
+							ECHO_LOG_ERROR("GLShaderProgram: Too many uniform blocks, \"" << name << "\" needs binding point " << bindingPoint << " of " << maxBindings << ". Ignoring block.");
+							continue;
+						}
+						block = make_shared<GLUniformBlock>(name, dataSize, bindingPoint);
+						context.mUniformBlockLookup[name] = block;
+					}
+					glUniformBlockBinding(mProgramHandle, b, block->GetBindingPoint());
+					EchoCheckOpenGLErrorInfo(name);
+					blocks[b] = block;
+					mUniformBlocks.push_back(block);
+				}
+			}
+#endif
 			//Get a list of variables
 			GLint numUniforms = 0;
 			GLint maxNameLength = 0;
@@ -85,6 +145,24 @@ namespace Echo
 				GLenum variableType = 0;
 
 				glGetActiveUniform(mProgramHandle, v, maxNameLength+1, 0, &numElements, &variableType, nameBuffer);
+
+#ifdef ECHO_GL_SUPPORTS_UNIFORM_BUFFER
+				// Variables in uniform blocks are written to the block at the offsets GL reports.
+				GLuint uniformIndex = v;
+				GLint blockIndex = -1;
+				GLint offset = 0;
+				GLint arrayStride = 0;
+				GLint matrixStride = 0;
+				GLint rowMajor = 0;
+				glGetActiveUniformsiv(mProgramHandle, 1, &uniformIndex, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+				if(blockIndex!=-1)
+				{
+					glGetActiveUniformsiv(mProgramHandle, 1, &uniformIndex, GL_UNIFORM_OFFSET, &offset);
+					glGetActiveUniformsiv(mProgramHandle, 1, &uniformIndex, GL_UNIFORM_ARRAY_STRIDE, &arrayStride);
+					glGetActiveUniformsiv(mProgramHandle, 1, &uniformIndex, GL_UNIFORM_MATRIX_STRIDE, &matrixStride);
+					glGetActiveUniformsiv(mProgramHandle, 1, &uniformIndex, GL_UNIFORM_IS_ROW_MAJOR, &rowMajor);
+				}
+#endif
 				
 				std::string uniformBaseName;
 				//Find the base name
@@ -106,6 +184,16 @@ namespace Echo
 					{
 						uniformName = nameBuffer;
 					}
+#ifdef ECHO_GL_SUPPORTS_UNIFORM_BUFFER
+					if(blockIndex!=-1)
+					{
+						if(static_cast<Size>(blockIndex) < blocks.size() && blocks[blockIndex])
+						{
+							AddBlockVariable(shaderProgram, blocks[blockIndex], uniformName, variableType, offset + i * arrayStride, matrixStride, rowMajor!=0);
+						}
+						continue;
+					}
+#endif
 					GLint location = glGetUniformLocation(mProgramHandle, uniformName.c_str());
 
 					GLenum e=glGetError();
@@ -222,6 +310,8 @@ namespace Echo
 			delete [] nameBuffer;
 
 			mLinked = true;
+			// The program's variables have changed so anything that looked them up by version needs to look again.
+			shaderProgram.IncrementVersion();
 			mVersion = shaderProgram.GetVersion();
 			return true;
 		}
@@ -229,23 +319,37 @@ namespace Echo
 		return false;
 	}
 
-	void GLShaderProgram::Activate()
+	Size GLShaderProgram::Activate()
 	{
 #ifdef ECHO_GL_SUPPORTS_SHADER
 		if(!mProgramHandle)
 		{
 			ECHO_LOG_ERROR("GLShaderProgram::Activate(): Could not activate shader program. Not built.");
-			return;
+			return 0;
 		}
 		glUseProgram(mProgramHandle);
 		if (glGetError() != GL_NO_ERROR)
 		{
-			return;
+			return 0;
 		}
-		
+		return SetVariables();
+#else
+		return 0;
+#endif
+	}
+
+	Size GLShaderProgram::SetVariables()
+	{
+		Size uploads = 0;
+#ifdef ECHO_GL_SUPPORTS_SHADER
 		BOOST_FOREACH(shared_ptr<TargetVariable>& target, mTargetVariables)
 		{
-			target->Set();
+			// Errors are only checked when the GL API was called.
+			if(!target->Set())
+			{
+				continue;
+			}
+			++uploads;
 			GLenum e=glGetError();
 			if(e!=GL_NO_ERROR)
 			{
@@ -261,6 +365,102 @@ namespace Echo
 				}
 			}
 		}
+#ifdef ECHO_GL_SUPPORTS_UNIFORM_BUFFER
+		// Uploading a block can move the ring buffer to a segment that a block checked earlier in the loop was
+		// uploaded to, so check again until a pass finishes without moving. The number of passes is limited in
+		// case the blocks don't fit in the buffer together.
+		Size passes = 0;
+		u64 sequence;
+		do
+		{
+			sequence = mUniformRingBuffer->GetSequence();
+			BOOST_FOREACH(shared_ptr<GLUniformBlock>& block, mUniformBlocks)
+			{
+				if(mUniformRingBuffer->NeedsUpload(*block) && mUniformRingBuffer->Upload(*block))
+				{
+					++uploads;
+				}
+			}
+		}while(sequence!=mUniformRingBuffer->GetSequence() && ++passes < GLUniformRingBuffer::NUMBER_OF_SEGMENTS);
+#endif
+#endif
+		return uploads;
+	}
+
+	void GLShaderProgram::AddBlockVariable(ShaderProgram& shaderProgram, shared_ptr<GLUniformBlock> block, const std::string& uniformName, u32 variableType, Size offset, Size matrixStride, bool rowMajor)
+	{
+#ifdef ECHO_GL_SUPPORTS_UNIFORM_BUFFER
+		switch(variableType)
+		{
+			case GL_FLOAT:
+			{
+				shared_ptr<float> variable = shaderProgram.GetUniformVariable<float>(uniformName,true);
+				if(variable)
+				{
+					mTargetVariables.push_back(make_shared<TargetBlockVariable< float > >(block,offset,variable));
+				}
+			}break;
+			case GL_INT:
+			{
+				shared_ptr<s32> variable = shaderProgram.GetUniformVariable<s32>(uniformName,true);
+				if(variable)
+				{
+					mTargetVariables.push_back(make_shared<TargetBlockVariable< s32 > >(block,offset,variable));
+				}
+			}break;
+			case GL_BOOL:
+			{
+				shared_ptr<bool> variable = shaderProgram.GetUniformVariable<bool>(uniformName,true);
+				if(variable)
+				{
+					mTargetVariables.push_back(make_shared<TargetBlockVariable< bool > >(block,offset,variable));
+				}
+			}break;
+			case GL_FLOAT_VEC2:
+			{
+				shared_ptr<Vector2> variable = shaderProgram.GetUniformVariable<Vector2>(uniformName,true);
+				if(variable)
+				{
+					mTargetVariables.push_back(make_shared<TargetBlockVariable< Vector2 > >(block,offset,variable));
+				}
+			}break;
+			case GL_FLOAT_VEC3:
+			{
+				shared_ptr<Vector3> variable = shaderProgram.GetUniformVariable<Vector3>(uniformName,true);
+				if(variable)
+				{
+					mTargetVariables.push_back(make_shared<TargetBlockVariable< Vector3 > >(block,offset,variable));
+				}
+			}break;
+			case GL_FLOAT_VEC4:
+			{
+				shared_ptr<Vector4> variable = shaderProgram.GetUniformVariable<Vector4>(uniformName,true);
+				if(variable)
+				{
+					mTargetVariables.push_back(make_shared<TargetBlockVariable< Vector4 > >(block,offset,variable));
+				}
+			}break;
+			case GL_FLOAT_MAT3:
+			{
+				shared_ptr<Matrix3> variable = shaderProgram.GetUniformVariable<Matrix3>(uniformName,true);
+				if(variable)
+				{
+					mTargetVariables.push_back(make_shared<TargetBlockMatrixVariable< Matrix3 > >(block,offset,matrixStride,rowMajor,variable));
+				}
+			}break;
+			case GL_FLOAT_MAT4:
+			{
+				shared_ptr<Matrix4> variable = shaderProgram.GetUniformVariable<Matrix4>(uniformName,true);
+				if(variable)
+				{
+					mTargetVariables.push_back(make_shared<TargetBlockMatrixVariable< Matrix4 > >(block,offset,matrixStride,rowMajor,variable));
+				}
+			}break;
+			default:
+			{
+				ECHO_LOG_ERROR("Uniform block \"" << block->GetName() << "\" contains variable \"" << uniformName << "\" of unsupported type: " << variableType);
+			}break;
+		}
 #endif
 	}
 	
@@ -0,0 +1,103 @@
+#include <echo/Platforms/GL/GLUniformBlock.h>
+#include <cstring>
+
+namespace Echo
+{
+	GLUniformBlock::GLUniformBlock(const std::string& name, Size size, u32 bindingPoint) :
+		mName(name),
+		mBindingPoint(bindingPoint),
+		mData(size, 0),
+		mDirty(true),
+		mUploadedSequence(0)
+	{
+	}
+
+	GLUniformBlock::~GLUniformBlock()
+	{
+	}
+
+	bool GLUniformBlock::Write(Size offset, const void* data, Size size)
+	{
+		if(offset + size > mData.size())
+		{
+			return false;
+		}
+		if(std::memcmp(&mData[offset], data, size)!=0)
+		{
+			std::memcpy(&mData[offset], data, size);
+			mDirty = true;
+		}
+		return true;
+	}
+
+	bool GLUniformBlock::Write(Size offset, f32 value)
+	{
+		return Write(offset, &value, sizeof(f32));
+	}
+
+	bool GLUniformBlock::Write(Size offset, s32 value)
+	{
+		return Write(offset, &value, sizeof(s32));
+	}
+
+	bool GLUniformBlock::Write(Size offset, bool value)
+	{
+		// std140 bools are four bytes.
+		s32 asInt = value ? 1 : 0;
+		return Write(offset, &asInt, sizeof(s32));
+	}
+
+	bool GLUniformBlock::Write(Size offset, const Vector2& value)
+	{
+		const f32 values[2] = {value.x, value.y};
+		return Write(offset, values, sizeof(values));
+	}
+
+	bool GLUniformBlock::Write(Size offset, const Vector3& value)
+	{
+		const f32 values[3] = {value.x, value.y, value.z};
+		return Write(offset, values, sizeof(values));
+	}
+
+	bool GLUniformBlock::Write(Size offset, const Vector4& value)
+	{
+		const f32 values[4] = {value.x, value.y, value.z, value.w};
+		return Write(offset, values, sizeof(values));
+	}
+
+	bool GLUniformBlock::Write(Size offset, const Matrix3& value, Size matrixStride, bool rowMajor)
+	{
+		// Our matrices are row major so column major blocks are written transposed, which is what
+		// glUniformMatrix3fv() does when transpose is GL_TRUE.
+		for(Size i = 0; i < 3; ++i)
+		{
+			f32 vector[3];
+			for(Size j = 0; j < 3; ++j)
+			{
+				vector[j] = rowMajor ? value[i][j] : value[j][i];
+			}
+			if(!Write(offset + i * matrixStride, vector, sizeof(vector)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool GLUniformBlock::Write(Size offset, const Matrix4& value, Size matrixStride, bool rowMajor)
+	{
+		for(Size i = 0; i < 4; ++i)
+		{
+			f32 vector[4];
+			for(Size j = 0; j < 4; ++j)
+			{
+				vector[j] = rowMajor ? value[i][j] : value[j][i];
+			}
+			if(!Write(offset + i * matrixStride, vector, sizeof(vector)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
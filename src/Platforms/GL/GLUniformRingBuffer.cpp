@@ -0,0 +1,123 @@
+#include <echo/Platforms/GL/GLUniformRingBuffer.h>
+#include <echo/Platforms/GL/GLUniformBlock.h>
+#include <cstring>
+
+#ifdef ECHO_GL_SUPPORTS_UNIFORM_BUFFER
+namespace Echo
+{
+	namespace
+	{
+		Size GetUniformBufferOffsetAlignment()
+		{
+			GLint alignment = 0;
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			EchoCheckOpenGLError();
+			return (alignment > 0) ? static_cast<Size>(alignment) : 256;
+		}
+	}
+
+	GLUniformRingBuffer::GLUniformRingBuffer(Size size) :
+		mBuffer(0),
+		mMappedData(nullptr),
+		mAllocator(size, NUMBER_OF_SEGMENTS, GetUniformBufferOffsetAlignment())
+	{
+		for(Size s = 0; s < NUMBER_OF_SEGMENTS; ++s)
+		{
+			mFences[s] = 0;
+		}
+
+		// Segments start on an aligned offset so the usable size may be less than requested.
+		const Size bufferSize = mAllocator.GetSize();
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glGenBuffers(1, &mBuffer);
+		EchoCheckOpenGLError();
+		glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+		EchoCheckOpenGLError();
+		glBufferStorage(GL_UNIFORM_BUFFER, bufferSize, nullptr, flags);
+		EchoCheckOpenGLError();
+		mMappedData = reinterpret_cast<u8*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, bufferSize, flags));
+		EchoCheckOpenGLError();
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		if(!mMappedData)
+		{
+			ECHO_LOG_ERROR("GLUniformRingBuffer: Unable to map the uniform buffer. Uniform blocks will not be set.");
+		}
+	}
+
+	GLUniformRingBuffer::~GLUniformRingBuffer()
+	{
+		for(Size s = 0; s < NUMBER_OF_SEGMENTS; ++s)
+		{
+			if(mFences[s])
+			{
+				glDeleteSync(mFences[s]);
+			}
+		}
+		if(mMappedData)
+		{
+			glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+			glUnmapBuffer(GL_UNIFORM_BUFFER);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &mBuffer);
+		EchoCheckOpenGLError();
+	}
+
+	bool GLUniformRingBuffer::NeedsUpload(const GLUniformBlock& block) const
+	{
+		return block.GetDirty() || !mAllocator.IsCurrent(block.GetUploadedSequence());
+	}
+
+	bool GLUniformRingBuffer::Upload(GLUniformBlock& block)
+	{
+		if(!mMappedData)
+		{
+			return false;
+		}
+
+		const Size size = block.GetSize();
+		Size offset = 0;
+		bool startedSegment = false;
+		if(!mAllocator.Allocate(size, offset, startedSegment))
+		{
+			ECHO_LOG_ERROR("GLUniformRingBuffer: Uniform block \"" << block.GetName() << "\" is larger than a segment (" << size << " > " << mAllocator.GetSegmentSize() << ")");
+			return false;
+		}
+		if(startedSegment)
+		{
+			BeginSegment();
+		}
+
+		std::memcpy(mMappedData + offset, block.GetData(), size);
+		glBindBufferRange(GL_UNIFORM_BUFFER, block.GetBindingPoint(), mBuffer, offset, size);
+		block.SetUploaded(mAllocator.GetSequence());
+		return EchoCheckOpenGLError();
+	}
+
+	void GLUniformRingBuffer::BeginSegment()
+	{
+		// Fence the segment that is full and move to the next one once the GPU has finished with it.
+		const Size segment = mAllocator.GetSegment();
+		const Size previous = (segment + NUMBER_OF_SEGMENTS - 1) % NUMBER_OF_SEGMENTS;
+		mFences[previous] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		if(mFences[segment])
+		{
+			GLbitfield waitFlags = 0;
+			GLuint64 timeout = 0;
+			while(true)
+			{
+				GLenum result = glClientWaitSync(mFences[segment], waitFlags, timeout);
+				if(result==GL_ALREADY_SIGNALED || result==GL_CONDITION_SATISFIED || result==GL_WAIT_FAILED)
+				{
+					break;
+				}
+				// Flush so the fence can be signalled then wait for up to a millisecond at a time.
+				waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+				timeout = 1000000;
+			}
+			glDeleteSync(mFences[segment]);
+			mFences[segment] = 0;
+		}
+	}
+}
+#endif
@@ -23,7 +23,8 @@ namespace Echo
 	
 	void GLVertexBuffer::Update(const VertexBuffer& vertexBuffer)
 	{
-		if(mVersion==vertexBuffer.GetVersion())
+		shared_ptr<const VertexLayout> layout = vertexBuffer.GetLayout();
+		if(mVersion==vertexBuffer.GetVersion() && layout==mLayout)
 		{
 			return;
 		}
@@ -58,11 +59,21 @@ namespace Echo
 			}
 		}
 
-		Size numberOfAttributes = vertexBuffer.GetNumberOfVertexAttributes();
-		Size stride = vertexBuffer.GetStride();
+		if(layout!=mLayout)
+		{
+			SetAttributes(*layout);
+			mLayout = layout;
+		}
+		mVersion = vertexBuffer.GetVersion();
+	}
+
+	void GLVertexBuffer::SetAttributes(const VertexLayout& layout)
+	{
+		Size numberOfAttributes = layout.GetNumberOfAttributes();
+		Size stride = layout.GetStride();
 		for(Size i = 0; i < numberOfAttributes; ++i)
 		{
-			const VertexAttribute* attribute = vertexBuffer.GetVertexAttribute(i);
+			const VertexAttribute* attribute = &layout.GetAttribute(i);
 			GLenum type;
 			GLint size = attribute->GetNumberOfComponents();
 			GLboolean normalise = attribute->GetNormalise();
@@ -103,7 +114,6 @@ namespace Echo
 			glEnableVertexAttribArray(i);
 			EchoCheckOpenGLError();
 		}
-		mVersion = vertexBuffer.GetVersion();
 	}
 
 	void GLVertexBuffer::Bind()
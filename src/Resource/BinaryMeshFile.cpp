@@ -0,0 +1,492 @@
+#include <echo/Resource/BinaryMeshFile.h>
+#include <echo/Resource/MaterialManager.h>
+#include <echo/FileSystem/File.h>
+#include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Graphics/Material.h>
+#include <echo/Graphics/VertexBuffer.h>
+#include <echo/Graphics/ElementBuffer.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace Echo
+{
+	namespace
+	{
+		const u32 BINARY_MESH_MAGIC = 0x48534D45;			// "EMSH" when stored little endian
+		const u32 BINARY_MESH_ENDIAN_MARKER = 0x01020304;
+		const u64 DATA_ALIGNMENT = 16;
+
+		// The structures are written as is so every member is explicitly sized and padded.
+		struct FileHeader
+		{
+			u32 mMagic;
+			u32 mVersion;
+			u32 mEndianMarker;
+			u32 mNumberOfVertexBuffers;
+			u32 mNumberOfAttributes;
+			u32 mNumberOfSubMeshes;
+			u64 mStringTableOffset;
+			u64 mStringTableSize;
+		};
+
+		struct VertexBufferEntry
+		{
+			u32 mFirstAttribute;
+			u32 mNumberOfAttributes;
+			u32 mType;
+			u32 mStride;
+			u64 mCapacity;
+			u64 mNumberOfElements;
+			u64 mDataOffset;
+			u64 mDataSize;
+		};
+
+		struct AttributeEntry
+		{
+			u32 mNameOffset;			/// 0 for an unnamed attribute.
+			u16 mComponentType;
+			u16 mNumberOfComponents;
+			u32 mOffset;
+			u32 mNormalise;
+		};
+
+		struct SubMeshEntry
+		{
+			u32 mNameOffset;
+			u32 mMaterialNameOffset;	/// 0 if the sub mesh has no material.
+			u32 mVertexBufferIndex;
+			u8 mMeshType;
+			u8 mVisible;
+			u8 mElementBufferType;
+			u8 mIndexType;				/// UNDEFINED if the sub mesh has no element buffer.
+			u32 mElementType;
+			f32 mPointAndLineSize;
+			u64 mCapacity;
+			u64 mNumberOfElements;
+			u64 mIndexDataOffset;
+			u64 mIndexDataSize;
+		};
+
+		static_assert(sizeof(FileHeader)==40, "FileHeader has unexpected padding");
+		static_assert(sizeof(VertexBufferEntry)==48, "VertexBufferEntry has unexpected padding");
+		static_assert(sizeof(AttributeEntry)==16, "AttributeEntry has unexpected padding");
+		static_assert(sizeof(SubMeshEntry)==56, "SubMeshEntry has unexpected padding");
+
+		u64 AlignDataOffset(u64 offset)
+		{
+			return (offset + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+		}
+
+		bool GetRangeValid(u64 offset, u64 size, u64 fileSize)
+		{
+			return offset <= fileSize && size <= fileSize - offset;
+		}
+
+		/**
+		 * Strings are stored null terminated and referenced by offset. Offset 0 is the empty string.
+		 */
+		class StringTable
+		{
+		public:
+			StringTable() : mData(1, '\0') {}
+
+			u32 Add(const std::string& s)
+			{
+				if(s.empty())
+				{
+					return 0;
+				}
+				std::map< std::string, u32 >::iterator it = mOffsets.find(s);
+				if(it!=mOffsets.end())
+				{
+					return it->second;
+				}
+				u32 offset = static_cast<u32>(mData.size());
+				mData.insert(mData.end(), s.begin(), s.end());
+				mData.push_back('\0');
+				mOffsets[s] = offset;
+				return offset;
+			}
+			const std::vector<char>& GetData() const {return mData;}
+		private:
+			std::vector<char> mData;
+			std::map< std::string, u32 > mOffsets;
+		};
+
+		/**
+		 * Copy a block of the file to a destination, from the file's data if it is accessible, otherwise by
+		 * reading straight into the destination.
+		 */
+		bool ReadBlock(File& file, const u8* data, void* destination, u64 offset, u64 size)
+		{
+			if(data)
+			{
+				std::memcpy(destination, data + offset, size);
+				return true;
+			}
+			return file.Seek(offset)==offset && file.Read(destination, size)==size;
+		}
+
+		bool WritePadding(File& file, u64& position, u64 targetPosition)
+		{
+			const u8 zeros[DATA_ALIGNMENT] = {};
+			while(position < targetPosition)
+			{
+				Size bytes = static_cast<Size>(std::min<u64>(targetPosition - position, DATA_ALIGNMENT));
+				if(file.Write(zeros, bytes)!=bytes)
+				{
+					return false;
+				}
+				position += bytes;
+			}
+			return true;
+		}
+
+		bool WriteBlock(File& file, u64& position, const void* data, u64 size)
+		{
+			if(size==0)
+			{
+				return true;
+			}
+			if(file.Write(data, size)!=size)
+			{
+				return false;
+			}
+			position += size;
+			return true;
+		}
+	}
+
+	bool ReadBinaryMeshFile(File& file, MaterialManager& materialManager, Mesh& targetMesh)
+	{
+		const u64 fileSize = file.GetSize();
+		const u8* data = file.GetData();
+		FileHeader header;
+		if(fileSize < sizeof(FileHeader) || !ReadBlock(file, data, &header, 0, sizeof(FileHeader)))
+		{
+			ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" is too small to be a binary mesh file");
+			return false;
+		}
+		if(header.mMagic!=BINARY_MESH_MAGIC)
+		{
+			ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" is not a binary mesh file");
+			return false;
+		}
+		if(header.mEndianMarker!=BINARY_MESH_ENDIAN_MARKER)
+		{
+			ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" was written on a platform with a different byte order");
+			return false;
+		}
+		if(header.mVersion!=BinaryMeshFile::VERSION)
+		{
+			ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" is binary mesh version " << header.mVersion << " but version " << BinaryMeshFile::VERSION << " is supported");
+			return false;
+		}
+
+		const u64 vertexBuffersOffset = sizeof(FileHeader);
+		const u64 attributesOffset = vertexBuffersOffset + u64(header.mNumberOfVertexBuffers) * sizeof(VertexBufferEntry);
+		const u64 subMeshesOffset = attributesOffset + u64(header.mNumberOfAttributes) * sizeof(AttributeEntry);
+		const u64 tablesEnd = subMeshesOffset + u64(header.mNumberOfSubMeshes) * sizeof(SubMeshEntry);
+		if(tablesEnd > fileSize || !GetRangeValid(header.mStringTableOffset, header.mStringTableSize, fileSize) ||
+			header.mStringTableSize==0)
+		{
+			ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" is corrupt, the tables are out of range");
+			return false;
+		}
+
+		// If the data isn't accessible the tables and strings are read with one Read() and the vertex and index
+		// data is read straight into the buffers.
+		const u8* tables = data;
+		std::vector<u8> tablesData;
+		if(!tables)
+		{
+			tablesData.resize(std::max(tablesEnd, header.mStringTableOffset + header.mStringTableSize));
+			if(!ReadBlock(file, nullptr, tablesData.data(), 0, tablesData.size()))
+			{
+				ECHO_LOG_ERROR("Unable to read binary mesh file \"" << file.GetActualFileName() << "\"");
+				return false;
+			}
+			tables = tablesData.data();
+		}
+		const char* strings = reinterpret_cast<const char*>(tables + header.mStringTableOffset);
+		if(strings[header.mStringTableSize - 1]!='\0')
+		{
+			ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" is corrupt, the string table is not terminated");
+			return false;
+		}
+		const u64 stringsSize = header.mStringTableSize;
+
+		// The vertex buffers are created and filled before any sub meshes so most corrupt files are rejected
+		// before the mesh is changed.
+		std::vector< shared_ptr<VertexBuffer> > vertexBuffers;
+		vertexBuffers.reserve(header.mNumberOfVertexBuffers);
+		for(u32 b = 0; b < header.mNumberOfVertexBuffers; ++b)
+		{
+			VertexBufferEntry entry;
+			std::memcpy(&entry, tables + vertexBuffersOffset + b * sizeof(VertexBufferEntry), sizeof(VertexBufferEntry));
+			if(u64(entry.mFirstAttribute) + entry.mNumberOfAttributes > header.mNumberOfAttributes ||
+				entry.mType > VertexBuffer::Types::DYNAMIC ||
+				!GetRangeValid(entry.mDataOffset, entry.mDataSize, fileSize) ||
+				entry.mNumberOfElements > entry.mCapacity)
+			{
+				ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" is corrupt, vertex buffer " << b << " is not valid");
+				return false;
+			}
+
+			shared_ptr<VertexBuffer> vertexBuffer(new VertexBuffer(static_cast<VertexBuffer::Type>(entry.mType)));
+			for(u32 a = entry.mFirstAttribute; a < entry.mFirstAttribute + entry.mNumberOfAttributes; ++a)
+			{
+				AttributeEntry attributeEntry;
+				std::memcpy(&attributeEntry, tables + attributesOffset + a * sizeof(AttributeEntry), sizeof(AttributeEntry));
+				if(attributeEntry.mNameOffset >= stringsSize || attributeEntry.mComponentType > VertexAttribute::ComponentTypes::COLOUR_8)
+				{
+					ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" is corrupt, vertex attribute " << a << " is not valid");
+					return false;
+				}
+				VertexAttribute attribute(static_cast<VertexAttribute::ComponentType>(attributeEntry.mComponentType), attributeEntry.mNumberOfComponents);
+				attribute.SetNormalise(attributeEntry.mNormalise!=0);
+				Size index = attributeEntry.mNameOffset==0 ? vertexBuffer->AddVertexAttribute(attribute) :
+															vertexBuffer->AddVertexAttribute(std::string(strings + attributeEntry.mNameOffset), attribute);
+				// The offsets are calculated from the attribute widths, a mismatch means the file is incompatible.
+				if(vertexBuffer->GetVertexAttribute(index)->GetOffset()!=attributeEntry.mOffset)
+				{
+					ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" vertex attribute " << a << " does not have the expected layout");
+					return false;
+				}
+			}
+			if(vertexBuffer->GetStride()!=entry.mStride || u64(entry.mStride) * entry.mCapacity!=entry.mDataSize)
+			{
+				ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" vertex buffer " << b << " does not have the expected layout");
+				return false;
+			}
+			if(entry.mDataSize > 0)
+			{
+				if(!vertexBuffer->Allocate(entry.mCapacity) || !ReadBlock(file, data, vertexBuffer->GetDataPointer(), entry.mDataOffset, entry.mDataSize))
+				{
+					ECHO_LOG_ERROR("Unable to read vertex buffer " << b << " from \"" << file.GetActualFileName() << "\"");
+					return false;
+				}
+				vertexBuffer->SetNumberOfElements(entry.mNumberOfElements);
+			}
+			vertexBuffers.push_back(vertexBuffer);
+		}
+
+		std::vector<SubMeshEntry> subMeshEntries(header.mNumberOfSubMeshes);
+		for(u32 s = 0; s < header.mNumberOfSubMeshes; ++s)
+		{
+			SubMeshEntry& entry = subMeshEntries[s];
+			std::memcpy(&entry, tables + subMeshesOffset + s * sizeof(SubMeshEntry), sizeof(SubMeshEntry));
+			bool valid = entry.mNameOffset < stringsSize && entry.mMaterialNameOffset < stringsSize &&
+						entry.mVertexBufferIndex < vertexBuffers.size() &&
+						entry.mMeshType <= SubMesh::MeshTypes::LINE_STRIP &&
+						entry.mElementBufferType <= ElementBuffer::Types::DYNAMIC &&
+						entry.mIndexType <= ElementBuffer::IndexTypes::UNSIGNED_32BIT &&
+						entry.mElementType <= ElementBuffer::ElementTypes::TRIANGLE_FAN &&
+						entry.mNumberOfElements <= entry.mCapacity &&
+						GetRangeValid(entry.mIndexDataOffset, entry.mIndexDataSize, fileSize);
+			if(!valid)
+			{
+				ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" is corrupt, sub mesh " << s << " is not valid");
+				return false;
+			}
+		}
+
+		for(u32 s = 0; s < header.mNumberOfSubMeshes; ++s)
+		{
+			const SubMeshEntry& entry = subMeshEntries[s];
+			shared_ptr<SubMesh> subMesh = targetMesh.CreateSubMesh(std::string(strings + entry.mNameOffset));
+			if(!subMesh)
+			{
+				return false;
+			}
+			if(entry.mIndexType!=ElementBuffer::IndexTypes::UNDEFINED)
+			{
+				if(!subMesh->SetElementBuffer(static_cast<ElementBuffer::Type>(entry.mElementBufferType),
+											static_cast<ElementBuffer::IndexType>(entry.mIndexType),
+											static_cast<ElementBuffer::ElementType>(entry.mElementType), entry.mCapacity) ||
+					subMesh->GetElementBuffer()->GetBufferSize()!=entry.mIndexDataSize)
+				{
+					ECHO_LOG_ERROR("\"" << file.GetActualFileName() << "\" sub mesh " << s << " index data does not have the expected size");
+					return false;
+				}
+				shared_ptr<ElementBuffer> elementBuffer = subMesh->GetElementBuffer();
+				if(!ReadBlock(file, data, elementBuffer->GetDataPointer(), entry.mIndexDataOffset, entry.mIndexDataSize))
+				{
+					ECHO_LOG_ERROR("Unable to read sub mesh " << s << " index data from \"" << file.GetActualFileName() << "\"");
+					return false;
+				}
+				elementBuffer->SetNumberOfElements(entry.mNumberOfElements);
+			}
+			subMesh->SetVertexBuffer(vertexBuffers[entry.mVertexBufferIndex]);
+			if(entry.mMaterialNameOffset!=0)
+			{
+				subMesh->SetMaterial(materialManager.GetResource(std::string(strings + entry.mMaterialNameOffset), file.GetActualFileName()));
+			}
+			subMesh->SetType(static_cast<SubMesh::MeshType>(entry.mMeshType));
+			subMesh->SetVisible(entry.mVisible!=0);
+			subMesh->SetPointAndLineSize(entry.mPointAndLineSize);
+			subMesh->Finalise();
+		}
+		file.Close();
+
+		//This forces an update of the AABB.
+		targetMesh.GetAxisAlignedBox();
+		return true;
+	}
+
+	bool WriteBinaryMeshFile(File& file, const Mesh& mesh)
+	{
+		if(!file.IsOpen())
+		{
+			ECHO_LOG_ERROR("The file is not open");
+			return false;
+		}
+		if(mesh.GetSkeleton())
+		{
+			ECHO_LOG_ERROR("Skinned meshes cannot be written as binary mesh files");
+			return false;
+		}
+
+		StringTable strings;
+		std::vector< shared_ptr<VertexBuffer> > vertexBuffers;
+		std::map< const VertexBuffer*, u32 > vertexBufferIndices;
+		std::vector<VertexBufferEntry> vertexBufferEntries;
+		std::vector<AttributeEntry> attributeEntries;
+		std::vector< shared_ptr<ElementBuffer> > elementBuffers;
+		std::vector<SubMeshEntry> subMeshEntries;
+
+		for(u32 s = 0; s < mesh.GetNumberOfSubMeshes(); ++s)
+		{
+			shared_ptr<SubMesh> subMesh = mesh.GetSubMesh(s);
+			if(subMesh->GetBoneWeights() || subMesh->GetSkinWeights())
+			{
+				ECHO_LOG_ERROR("Skinned meshes cannot be written as binary mesh files");
+				return false;
+			}
+
+			SubMeshEntry entry = SubMeshEntry();
+			entry.mNameOffset = strings.Add(subMesh->GetName());
+			entry.mMaterialNameOffset = subMesh->GetMaterial() ? strings.Add(subMesh->GetMaterial()->GetName()) : 0;
+			entry.mMeshType = static_cast<u8>(subMesh->GetType());
+			entry.mVisible = subMesh->GetVisible() ? 1 : 0;
+			entry.mPointAndLineSize = subMesh->GetPointAndLineSize();
+			entry.mIndexType = ElementBuffer::IndexTypes::UNDEFINED;
+
+			shared_ptr<VertexBuffer> vertexBuffer = subMesh->GetVertexBuffer();
+			std::map< const VertexBuffer*, u32 >::iterator it = vertexBufferIndices.find(vertexBuffer.get());
+			if(it!=vertexBufferIndices.end())
+			{
+				entry.mVertexBufferIndex = it->second;
+			}else
+			{
+				entry.mVertexBufferIndex = static_cast<u32>(vertexBuffers.size());
+				vertexBufferIndices[vertexBuffer.get()] = entry.mVertexBufferIndex;
+				vertexBuffers.push_back(vertexBuffer);
+
+				std::vector<std::string> names(vertexBuffer->GetNumberOfVertexAttributes());
+				for(const std::pair<const std::string, Size>& namedAttribute : vertexBuffer->GetNamedAttributes())
+				{
+					names[namedAttribute.second] = namedAttribute.first;
+				}
+
+				VertexBufferEntry vertexBufferEntry = VertexBufferEntry();
+				vertexBufferEntry.mFirstAttribute = static_cast<u32>(attributeEntries.size());
+				vertexBufferEntry.mNumberOfAttributes = static_cast<u32>(vertexBuffer->GetNumberOfVertexAttributes());
+				vertexBufferEntry.mType = vertexBuffer->GetType();
+				vertexBufferEntry.mStride = static_cast<u32>(vertexBuffer->GetStride());
+				vertexBufferEntry.mCapacity = vertexBuffer->GetCapacity();
+				vertexBufferEntry.mNumberOfElements = vertexBuffer->GetNumberOfElements();
+				vertexBufferEntry.mDataSize = vertexBuffer->GetBufferSize();
+				vertexBufferEntries.push_back(vertexBufferEntry);
+
+				for(Size a = 0; a < vertexBuffer->GetNumberOfVertexAttributes(); ++a)
+				{
+					const VertexAttribute* attribute = vertexBuffer->GetVertexAttribute(a);
+					AttributeEntry attributeEntry = AttributeEntry();
+					attributeEntry.mNameOffset = strings.Add(names[a]);
+					attributeEntry.mComponentType = static_cast<u16>(attribute->GetComponentType());
+					attributeEntry.mNumberOfComponents = static_cast<u16>(attribute->GetNumberOfComponents());
+					attributeEntry.mOffset = static_cast<u32>(attribute->GetOffset());
+					attributeEntry.mNormalise = attribute->GetNormalise() ? 1 : 0;
+					attributeEntries.push_back(attributeEntry);
+				}
+			}
+
+			shared_ptr<ElementBuffer> elementBuffer = subMesh->GetElementBuffer();
+			if(elementBuffer && elementBuffer->GetBufferSize() > 0)
+			{
+				entry.mElementBufferType = static_cast<u8>(elementBuffer->GetType());
+				entry.mIndexType = static_cast<u8>(elementBuffer->GetIndexType());
+				entry.mElementType = elementBuffer->GetElementType();
+				entry.mCapacity = elementBuffer->GetCapacity();
+				entry.mNumberOfElements = elementBuffer->GetNumberOfElements();
+				entry.mIndexDataSize = elementBuffer->GetBufferSize();
+			}
+			elementBuffers.push_back(elementBuffer);
+			subMeshEntries.push_back(entry);
+		}
+
+		// Lay out the data blocks after the tables.
+		FileHeader header = FileHeader();
+		header.mMagic = BINARY_MESH_MAGIC;
+		header.mVersion = BinaryMeshFile::VERSION;
+		header.mEndianMarker = BINARY_MESH_ENDIAN_MARKER;
+		header.mNumberOfVertexBuffers = static_cast<u32>(vertexBufferEntries.size());
+		header.mNumberOfAttributes = static_cast<u32>(attributeEntries.size());
+		header.mNumberOfSubMeshes = static_cast<u32>(subMeshEntries.size());
+		header.mStringTableOffset = sizeof(FileHeader) + vertexBufferEntries.size() * sizeof(VertexBufferEntry) +
+									attributeEntries.size() * sizeof(AttributeEntry) + subMeshEntries.size() * sizeof(SubMeshEntry);
+		header.mStringTableSize = strings.GetData().size();
+
+		u64 dataOffset = header.mStringTableOffset + header.mStringTableSize;
+		for(VertexBufferEntry& entry : vertexBufferEntries)
+		{
+			if(entry.mDataSize > 0)
+			{
+				dataOffset = AlignDataOffset(dataOffset);
+				entry.mDataOffset = dataOffset;
+				dataOffset += entry.mDataSize;
+			}
+		}
+		for(SubMeshEntry& entry : subMeshEntries)
+		{
+			if(entry.mIndexDataSize > 0)
+			{
+				dataOffset = AlignDataOffset(dataOffset);
+				entry.mIndexDataOffset = dataOffset;
+				dataOffset += entry.mIndexDataSize;
+			}
+		}
+
+		u64 position = 0;
+		bool written = WriteBlock(file, position, &header, sizeof(FileHeader)) &&
+						WriteBlock(file, position, vertexBufferEntries.data(), vertexBufferEntries.size() * sizeof(VertexBufferEntry)) &&
+						WriteBlock(file, position, attributeEntries.data(), attributeEntries.size() * sizeof(AttributeEntry)) &&
+						WriteBlock(file, position, subMeshEntries.data(), subMeshEntries.size() * sizeof(SubMeshEntry)) &&
+						WriteBlock(file, position, strings.GetData().data(), strings.GetData().size());
+		for(Size b = 0; written && b < vertexBuffers.size(); ++b)
+		{
+			if(vertexBufferEntries[b].mDataSize > 0)
+			{
+				written = WritePadding(file, position, vertexBufferEntries[b].mDataOffset) &&
+						WriteBlock(file, position, vertexBuffers[b]->GetDataPointer(), vertexBufferEntries[b].mDataSize);
+			}
+		}
+		for(Size s = 0; written && s < elementBuffers.size(); ++s)
+		{
+			if(subMeshEntries[s].mIndexDataSize > 0)
+			{
+				written = WritePadding(file, position, subMeshEntries[s].mIndexDataOffset) &&
+						WriteBlock(file, position, elementBuffers[s]->GetDataPointer(), subMeshEntries[s].mIndexDataSize);
+			}
+		}
+		if(!written)
+		{
+			ECHO_LOG_ERROR("Failed to write binary mesh file \"" << file.GetActualFileName() << "\"");
+		}
+		return written;
+	}
+}
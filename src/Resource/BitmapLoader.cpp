@@ -38,6 +38,11 @@ namespace Echo
 	{
 		CleanUp();
 	}
+
+	shared_ptr<TextureLoader> BitmapLoader::CreateInstance() const
+	{
+		return make_shared<BitmapLoader>();
+	}
 		
 	bool BitmapLoader::ProcessFile(File& textureFile)
 	{
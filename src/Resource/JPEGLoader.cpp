@@ -262,6 +262,11 @@ namespace Echo
 	JPEGLoader::~JPEGLoader()
 	{}
 
+	shared_ptr<TextureLoader> JPEGLoader::CreateInstance() const
+	{
+		return make_shared<JPEGLoader>();
+	}
+
 	void JPEGErrorExit(j_common_ptr cinfo)
 	{
 		//ErrorManager* myerr = reinterpret_cast<ErrorManager*>(cinfo->err);
@@ -1,6 +1,7 @@
 #include <echo/Resource/3dsReader.h>
 #include <echo/Resource/MeshManager.h>
 #include <echo/Resource/MeshReader.h>
+#include <echo/Resource/BinaryMeshFile.h>
 #include <echo/Util/StringUtils.h>
 #include <echo/Graphics/SubMesh.h>
 #include <echo/Graphics/Mesh.h>
@@ -18,6 +19,7 @@ namespace Echo
 	{
 		RegisterLoader("3ds", bind(&Load3DS,placeholders::_1,placeholders::_2,placeholders::_3));
 		RegisterLoader("mesh", bind(&LoadMesh,placeholders::_1,placeholders::_2, ref(mMaterialManager),ref(mSkeletonManager),placeholders::_3));
+		RegisterLoader("emesh", bind(&LoadBinaryMesh,placeholders::_1,placeholders::_2, ref(mMaterialManager),placeholders::_3));
 	}
 
 	MeshManager::~MeshManager()
@@ -191,6 +193,16 @@ namespace Echo
 		return ReadMeshFile(file, materialManager,skeletonManager, mesh);
 	}
 
+	bool MeshManager::LoadBinaryMesh(const std::string& resourceFile, FileSystem& fileSystem, MaterialManager& materialManager, Mesh& mesh)
+	{
+		File file = fileSystem.Open(resourceFile);
+		if(!file.IsOpen())
+		{
+			return false;
+		}
+		return ReadBinaryMeshFile(file, materialManager, mesh);
+	}
+
 	FileSystem* MeshManager::GetFileSystem() const
 	{
 		return &mFileSystem;
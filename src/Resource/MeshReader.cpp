@@ -5,6 +5,7 @@
 #include <echo/Graphics/Mesh.h>
 #include <echo/Resource/MaterialManager.h>
 #include <echo/Graphics/SubMesh.h>
+#include <echo/Graphics/Skinning.h>
 #include <echo/Resource/SkeletonManager.h>
 #include <iostream>
 #include <vector>
@@ -191,7 +192,7 @@ namespace Echo
 		return true;
 	}
 
-	void ExtractMesh(Geometry* geometry, shared_ptr<SubMesh> subMesh, SubMeshData* subMeshData, MaterialManager& materialManager, std::string meshFileName)
+	void ExtractMesh(Geometry* geometry, shared_ptr<SubMesh> subMesh, SubMeshData* subMeshData, MaterialManager& materialManager, std::string meshFileName, const SkinWeights* skinWeights = nullptr)
 	{	
 		{
 			if(subMeshData->mOperationType!=OT_TRIANGLE_LIST)
@@ -282,6 +283,12 @@ namespace Echo
 				}
 			}			
 
+			// Skinning attributes are added last so the attribute indices above match the element indices.
+			if(skinWeights)
+			{
+				skinWeights->AddVertexAttributes(*vertexBuffer);
+			}
+
 			//Allocate buffers now we have our vertex buffer attributes set
 			if(!vertexBuffer->Allocate(geometry->mVertexCount))
 			{
@@ -387,6 +394,11 @@ namespace Echo
 						break;
 				}
 			}
+
+			if(skinWeights && !skinWeights->WriteVertexAttributes(*vertexBuffer))
+			{
+				ECHO_LOG_ERROR("Failed to write skinning vertex attributes");
+			}
 		}
 		subMesh->Finalise();
 	}
@@ -749,6 +761,7 @@ namespace Echo
 		shared_ptr< VertexBuffer > sharedVertices;
 		shared_ptr< std::vector<u16> > sharedIndices;
 		shared_ptr< std::vector< BoneBinding* > > sharedBoneWeights;
+		shared_ptr< SkinWeights > sharedSkinWeights;
 
 		shared_ptr< Skeleton > skeleton;
 		if(!mesh->mSkeletonFile.empty())
@@ -771,26 +784,35 @@ namespace Echo
 			{
 				if(!extractedShared)
 				{
-					ExtractMesh(mesh->mGeometry, subMesh, subMeshData,materialManager, inFile.GetActualFileName());
+					// Bone weights are extracted first so the skinning attributes can be added to the vertex buffer.
 					if(skeleton)
 					{
 						sharedBoneWeights=ExtractBoneWeights(targetMesh, *skeleton, *subMesh, mesh->mGeometry->mVertexCount, subMeshData->mBoneAssignments);
+						sharedSkinWeights = make_shared<SkinWeights>();
+						sharedSkinWeights->Build(*sharedBoneWeights);
 						subMesh->SetBoneWeights(sharedBoneWeights);
+						subMesh->SetSkinWeights(sharedSkinWeights);
 					}
+					ExtractMesh(mesh->mGeometry, subMesh, subMeshData,materialManager, inFile.GetActualFileName(), sharedSkinWeights.get());
 					sharedVertices = subMesh->GetVertexBuffer();
 				}else
 				{
 					subMesh->SetVertexBuffer(sharedVertices);
 					subMesh->SetBoneWeights(sharedBoneWeights);
+					subMesh->SetSkinWeights(sharedSkinWeights);
 				}
 			}else
 			{
-				ExtractMesh(subMeshData->mGeometry, subMesh, subMeshData, materialManager, inFile.GetActualFileName());
+				shared_ptr< SkinWeights > skinWeights;
 				if(skeleton)
 				{
 					shared_ptr< std::vector< BoneBinding* > > boneWeights=ExtractBoneWeights(targetMesh, *skeleton, *subMesh, subMeshData->mGeometry->mVertexCount, subMeshData->mBoneAssignments);
+					skinWeights = make_shared<SkinWeights>();
+					skinWeights->Build(*boneWeights);
 					subMesh->SetBoneWeights(boneWeights);
+					subMesh->SetSkinWeights(skinWeights);
 				}
+				ExtractMesh(subMeshData->mGeometry, subMesh, subMeshData, materialManager, inFile.GetActualFileName(), skinWeights.get());
 			}
 			subMesh->Finalise();
 		}
@@ -70,6 +70,11 @@ namespace Echo
 	
 	PNGLoader::~PNGLoader()
 	{}
+
+	shared_ptr<TextureLoader> PNGLoader::CreateInstance() const
+	{
+		return make_shared<PNGLoader>();
+	}
 		
 	bool PNGLoader::ProcessFile(File& textureFile)
 	{
@@ -347,6 +347,7 @@ namespace Echo
 				}
 				++bkfIt;
 			}
+			animation->Bake();
 		}
 		targetSkeleton.SetInitialState();
 		targetSkeleton.SetBindingPose();
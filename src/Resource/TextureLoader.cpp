@@ -1,6 +1,8 @@
 #include <echo/Resource/TextureLoader.h>
 #include <echo/FileSystem/File.h>
+#include <echo/Kernel/ScopedLock.h>
 #include <echo/Util/Utils.h>
+#include <cstring>
 
 namespace Echo
 {
@@ -11,6 +13,7 @@ namespace Echo
 
 	Texture* TextureLoader::LoadTexture(File& file, bool forcePowerOfTwoTextures, Texture* textureToLoadInto)
 	{
+		ScopedLock lock(mLoadMutex);
 		if(!file.IsOpen())
 		{
 			CleanUp();
@@ -50,6 +53,11 @@ namespace Echo
 		}
 		u32 bytesPerPixel = Texture::Formats::GetBytesPerPixel(GetFormat());
 		shared_ptr<u8> buffer = resource->GetBuffer();
+		if(width!=GetWidth() || height!=imageHeight)
+		{
+			// Clear the power of two padding.
+			std::memset(buffer.get(), 0, bytesPerPixel*width*height);
+		}
 		if(GetLoadInverted())
 		{
 			for(u32 y = imageHeight; y>0; --y)
@@ -19,6 +19,7 @@ namespace Echo
 
 	TextureManager::~TextureManager()
 	{
+		WaitForAsyncLoads();
 	}
 
 	void TextureManager::SetLowMemoryMode(bool lowMemoryMode)
@@ -55,7 +56,7 @@ namespace Echo
 
 	shared_ptr<Texture> TextureManager::LoadResource(const std::string& resourceFile, const std::string& resourceName)
 	{
-		if (Texture* texture = _LoadResource(resourceFile, nullptr))
+		if (Texture* texture = LoadTextureFile(resourceFile, nullptr))
 		{
 			texture->SetName(resourceName);
 			texture->SetResourceDelegate(mTextureDelegate);
@@ -78,7 +79,16 @@ namespace Echo
 		{
 			resourceFileName=resourceNameOrFile;
 		}
-		
+		return LoadTextureFile(resourceFileName, textureToLoadInto);
+	}
+
+	shared_ptr<Texture> TextureManager::LoadTextureFromFile(const std::string& fileName)
+	{
+		return shared_ptr<Texture>(LoadTextureFile(fileName, nullptr));
+	}
+
+	Texture* TextureManager::LoadTextureFile(const std::string& resourceFileName, Texture* textureToLoadInto)
+	{
 		size_t lastDot = 0;
 		std::string extension;
 		lastDot = resourceFileName.find_last_of(".");
@@ -106,9 +116,16 @@ namespace Echo
 			return nullptr;
 		}
 		
+		//Use a loader of our own if we can so other files can be loaded at the same time.
+		shared_ptr<TextureLoader> loader = eit->second->CreateInstance();
+		if(!loader)
+		{
+			loader = eit->second;
+		}
+
 		//Attempt to open the file.
 		File file = mFileSystem.Open(resourceFileName);
-		return eit->second->LoadTexture(file, mForcePowerOfTwoTextures, textureToLoadInto);
+		return loader->LoadTexture(file, mForcePowerOfTwoTextures, textureToLoadInto);
 	}
 	
 	shared_ptr<Texture> TextureManager::CreateTexture(const std::string& resourceName, u32 width, u32 height, Texture::Format format)
@@ -216,4 +233,9 @@ namespace Echo
 	{
 		return CreateErrorTexture();
 	}
+
+	bool TextureManager::GetConcurrentLoadingSupported() const
+	{
+		return true;
+	}
 }
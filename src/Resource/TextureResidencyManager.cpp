@@ -0,0 +1,472 @@
+#include <echo/Resource/TextureResidencyManager.h>
+#include <echo/Resource/TextureManager.h>
+#include <echo/Graphics/Camera.h>
+#include <echo/Graphics/Material.h>
+#include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/RenderPass.h>
+#include <echo/Graphics/SceneEntity.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Graphics/TextureUnit.h>
+#include <echo/Maths/AxisAlignedBox.h>
+#include <algorithm>
+
+namespace Echo
+{
+	TextureResidencyManager::TextureResidencyManager(TextureManager& textureManager, Size budget, shared_ptr<WorkerPool> workerPool) :
+		mTextureManager(textureManager),
+		mWorkerPool(workerPool),
+		mProcessor(workerPool),
+		mBudget(budget),
+		mMinimumSize(32),
+		mUnusedFrames(120),
+		mMaximumPendingLoads(8),
+		mFrame(0)
+	{
+	}
+
+	TextureResidencyManager::~TextureResidencyManager()
+	{
+		WaitForPendingLoads();
+	}
+
+	void TextureResidencyManager::SetBudget(Size budget)
+	{
+		ScopedLock lock(mMutex);
+		mBudget = budget;
+	}
+
+	void TextureResidencyManager::SetMinimumSize(u32 minimumSize)
+	{
+		ScopedLock lock(mMutex);
+		mMinimumSize = std::max(minimumSize, 1u);
+		for(EntryMap::value_type& it : mEntries)
+		{
+			it.second.mLowestLevel = CalculateLowestLevel(it.second);
+		}
+	}
+
+	bool TextureResidencyManager::AddTexture(shared_ptr<Texture> texture)
+	{
+		if(!texture)
+		{
+			return false;
+		}
+		if(texture->GetWidth()==0 || texture->GetHeight()==0 || !TextureProcessor::GetFormatSupported(texture->GetFormat()))
+		{
+			ECHO_LOG_ERROR("Unable to track \"" << texture->GetName() << "\", textures with the format " << texture->GetFormat() << " can't be resized.");
+			return false;
+		}
+		std::string fileName = mTextureManager.GetResourceFileName(texture->GetName());
+		if(fileName.empty())
+		{
+			ECHO_LOG_ERROR("Unable to track \"" << texture->GetName() << "\", it was not loaded from a file by the TextureManager.");
+			return false;
+		}
+
+		ScopedLock lock(mMutex);
+		if(mEntries.find(texture.get())!=mEntries.end())
+		{
+			return false;
+		}
+		Entry& entry = mEntries[texture.get()];
+		entry.mTexture = texture;
+		entry.mFileName = fileName;
+		entry.mWidth = texture->GetWidth();
+		entry.mHeight = texture->GetHeight();
+		entry.mBytesPerPixel = texture->GetBytesPerPixel();
+		entry.mLowestLevel = CalculateLowestLevel(entry);
+		entry.mLevel = 0;
+		entry.mTargetLevel = 0;
+		entry.mOverBudget = false;
+		// Treat new textures as if they were just used at full size so they aren't reduced before they are seen.
+		entry.mUsed = false;
+		entry.mLastUsedFrame = mFrame;
+		entry.mScreenSize = static_cast<f32>(std::max(entry.mWidth, entry.mHeight));
+		return true;
+	}
+
+	bool TextureResidencyManager::RemoveTexture(const Texture& texture)
+	{
+		ScopedLock lock(mMutex);
+		EntryMap::iterator it = mEntries.find(&texture);
+		if(it==mEntries.end())
+		{
+			return false;
+		}
+		if(it->second.mPendingLoad)
+		{
+			mWorkerPool->Wait(it->second.mPendingLoad->mCounter);
+			FinishLoad(it->second);
+		}
+		mEntries.erase(it);
+		return true;
+	}
+
+	void TextureResidencyManager::TextureUsed(const Texture& texture, f32 screenSize)
+	{
+		ScopedLock lock(mMutex);
+		EntryMap::iterator it = mEntries.find(&texture);
+		if(it==mEntries.end())
+		{
+			return;
+		}
+		Entry& entry = it->second;
+		if(entry.mLastUsedFrame!=mFrame || !entry.mUsed)
+		{
+			entry.mUsed = true;
+			entry.mLastUsedFrame = mFrame;
+			entry.mScreenSize = screenSize;
+		}else
+		{
+			entry.mScreenSize = std::max(entry.mScreenSize, screenSize);
+		}
+	}
+
+	void TextureResidencyManager::MaterialUsed(Material& material, f32 screenSize)
+	{
+		for(u32 p = 0; p < material.GetNumberOfPasses(); ++p)
+		{
+			RenderPass* pass = material.GetPass(p);
+			for(u32 t = 0; t < pass->GetNumTextureUnits(); ++t)
+			{
+				shared_ptr<Texture> texture = pass->GetTextureUnit(t)->GetTexture();
+				if(texture)
+				{
+					TextureUsed(*texture, screenSize);
+				}
+			}
+		}
+	}
+
+	void TextureResidencyManager::RenderableUsed(SceneRenderable& renderable, const Camera& camera, u32 viewportHeight)
+	{
+		SceneEntity* entity = dynamic_cast<SceneEntity*>(&renderable);
+		if(!entity)
+		{
+			return;
+		}
+		shared_ptr<Mesh> mesh = entity->GetMesh();
+		if(!mesh)
+		{
+			return;
+		}
+		f32 screenSize = CalculateScreenSize(renderable.GetSceneAxisAlignedBox(), camera, viewportHeight);
+		for(u32 i = 0; i < mesh->GetNumberOfSubMeshes(); ++i)
+		{
+			shared_ptr<SubMesh> subMesh = mesh->GetSubMesh(i);
+			shared_ptr<Material> material = subMesh->GetMaterial();
+			if(material && subMesh->GetVisible())
+			{
+				MaterialUsed(*material, screenSize);
+			}
+		}
+	}
+
+	void TextureResidencyManager::Update()
+	{
+		ScopedLock lock(mMutex);
+
+		std::vector<Entry*> entries;
+		entries.reserve(mEntries.size());
+		Size totalBytes = 0;
+		for(EntryMap::value_type& it : mEntries)
+		{
+			Entry& entry = it.second;
+			if(entry.mPendingLoad && entry.mPendingLoad->mCounter.IsComplete())
+			{
+				FinishLoad(entry);
+			}
+			if(!entry.mPendingLoad)
+			{
+				SynchroniseLevel(entry);
+			}
+			entry.mTargetLevel = CalculateTargetLevel(entry);
+			entry.mOverBudget = false;
+			totalBytes += GetLevelBytes(entry, entry.mTargetLevel);
+			entries.push_back(&entry);
+		}
+
+		// Least important first.
+		std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b)
+		{
+			if(a->mLastUsedFrame!=b->mLastUsedFrame)
+			{
+				return a->mLastUsedFrame < b->mLastUsedFrame;
+			}
+			return a->mScreenSize < b->mScreenSize;
+		});
+
+		// Reduce the least important textures by a level at a time until the targets fit.
+		bool reduced = true;
+		while(totalBytes > mBudget && reduced)
+		{
+			reduced = false;
+			for(Entry* entry : entries)
+			{
+				if(totalBytes <= mBudget)
+				{
+					break;
+				}
+				if(entry->mTargetLevel < entry->mLowestLevel)
+				{
+					totalBytes -= GetLevelBytes(*entry, entry->mTargetLevel) - GetLevelBytes(*entry, entry->mTargetLevel + 1);
+					entry->mTargetLevel++;
+					entry->mOverBudget = true;
+					reduced = true;
+				}
+			}
+		}
+
+		// Memory that is resident or will be once the pending loads complete.
+		Size residentBytes = 0;
+		Size pendingLoads = 0;
+		for(Entry* entry : entries)
+		{
+			Size bytes = GetLevelBytes(*entry, entry->mLevel);
+			if(entry->mPendingLoad)
+			{
+				bytes = std::max(bytes, GetLevelBytes(*entry, entry->mPendingLoad->mLevel));
+				pendingLoads++;
+			}
+			residentBytes += bytes;
+		}
+
+		// Reductions free memory so start those first.
+		for(Entry* entry : entries)
+		{
+			if(pendingLoads >= mMaximumPendingLoads)
+			{
+				break;
+			}
+			if(!entry->mPendingLoad && entry->mTargetLevel > entry->mLevel)
+			{
+				if(entry->mOverBudget)
+				{
+					mStatistics.mEvictions++;
+				}
+				StartLoad(*entry, entry->mTargetLevel);
+				pendingLoads++;
+			}
+		}
+
+		// Then increase the most important textures that fit within the budget as it stands.
+		for(std::vector<Entry*>::reverse_iterator it = entries.rbegin(); it != entries.rend(); ++it)
+		{
+			if(pendingLoads >= mMaximumPendingLoads)
+			{
+				break;
+			}
+			Entry& entry = **it;
+			if(!entry.mPendingLoad && entry.mTargetLevel < entry.mLevel)
+			{
+				Size additionalBytes = GetLevelBytes(entry, entry.mTargetLevel) - GetLevelBytes(entry, entry.mLevel);
+				if(residentBytes + additionalBytes <= mBudget)
+				{
+					residentBytes += additionalBytes;
+					StartLoad(entry, entry.mTargetLevel);
+					pendingLoads++;
+				}
+			}
+		}
+		mFrame++;
+	}
+
+	void TextureResidencyManager::WaitForPendingLoads()
+	{
+		ScopedLock lock(mMutex);
+		for(EntryMap::value_type& it : mEntries)
+		{
+			if(it.second.mPendingLoad)
+			{
+				mWorkerPool->Wait(it.second.mPendingLoad->mCounter);
+				FinishLoad(it.second);
+			}
+		}
+	}
+
+	Size TextureResidencyManager::GetResidentLevel(const Texture& texture) const
+	{
+		ScopedLock lock(mMutex);
+		EntryMap::const_iterator it = mEntries.find(&texture);
+		if(it==mEntries.end())
+		{
+			return 0;
+		}
+		return it->second.mLevel;
+	}
+
+	TextureResidencyManager::Statistics TextureResidencyManager::GetStatistics() const
+	{
+		ScopedLock lock(mMutex);
+		Statistics statistics = mStatistics;
+		statistics.mTrackedTextures = mEntries.size();
+		statistics.mBudget = mBudget;
+		for(const EntryMap::value_type& it : mEntries)
+		{
+			const Entry& entry = it.second;
+			statistics.mResidentBytes += GetLevelBytes(entry, entry.mLevel);
+			statistics.mFullResolutionBytes += GetLevelBytes(entry, 0);
+			if(entry.mPendingLoad)
+			{
+				statistics.mPendingLoads++;
+			}
+		}
+		return statistics;
+	}
+
+	f32 TextureResidencyManager::CalculateScreenSize(const AxisAlignedBox& box, const Camera& camera, u32 viewportHeight)
+	{
+		if(box.IsNull())
+		{
+			return 0.f;
+		}
+		if(box.IsInfinite())
+		{
+			return static_cast<f32>(viewportHeight);
+		}
+		f32 radius = box.GetHalfSize().Length();
+		if(camera.GetProjectionType()==ProjectionTypes::ORTHOGRAPHIC)
+		{
+			f32 windowHeight = camera.GetOrthoWindowHeight();
+			if(windowHeight <= 0.f)
+			{
+				return static_cast<f32>(viewportHeight);
+			}
+			return (radius * 2.f / windowHeight) * viewportHeight;
+		}
+		f32 distance = box.GetCentre().Distance(camera.GetDerivedPosition());
+		f32 tanHalfFOVy = Maths::Tan<f32>(camera.GetFOVy() / 2);
+		if(distance <= radius || tanHalfFOVy <= 0.f)
+		{
+			return static_cast<f32>(viewportHeight);
+		}
+		// The visible height at the distance is 2*distance*tanHalfFOVy.
+		return (radius / (distance * tanHalfFOVy)) * viewportHeight;
+	}
+
+	Size TextureResidencyManager::GetLevelBytes(const Entry& entry, Size level) const
+	{
+		Size width = std::max<Size>(entry.mWidth >> level, 1);
+		Size height = std::max<Size>(entry.mHeight >> level, 1);
+		return width * height * entry.mBytesPerPixel;
+	}
+
+	Size TextureResidencyManager::CalculateLowestLevel(const Entry& entry) const
+	{
+		u32 size = std::max(entry.mWidth, entry.mHeight);
+		Size level = 0;
+		while((size >> (level + 1)) >= mMinimumSize)
+		{
+			level++;
+		}
+		return level;
+	}
+
+	Size TextureResidencyManager::CalculateTargetLevel(const Entry& entry) const
+	{
+		if(mFrame - entry.mLastUsedFrame > mUnusedFrames)
+		{
+			return entry.mLowestLevel;
+		}
+		// The lowest resolution that still covers the size on screen.
+		u32 size = std::max(entry.mWidth, entry.mHeight);
+		Size level = 0;
+		while(level < entry.mLowestLevel && static_cast<f32>(size >> (level + 1)) >= entry.mScreenSize)
+		{
+			level++;
+		}
+		return level;
+	}
+
+	void TextureResidencyManager::SynchroniseLevel(Entry& entry)
+	{
+		const Texture& texture = *entry.mTexture;
+		if(texture.GetWidth()==std::max<u32>(entry.mWidth >> entry.mLevel, 1) &&
+			texture.GetHeight()==std::max<u32>(entry.mHeight >> entry.mLevel, 1))
+		{
+			return;
+		}
+		// The texture was changed elsewhere, such as being reloaded, so it is treated as full resolution again.
+		entry.mWidth = texture.GetWidth();
+		entry.mHeight = texture.GetHeight();
+		entry.mBytesPerPixel = texture.GetBytesPerPixel();
+		entry.mLowestLevel = CalculateLowestLevel(entry);
+		entry.mLevel = 0;
+	}
+
+	void TextureResidencyManager::FinishLoad(Entry& entry)
+	{
+		shared_ptr<PendingLoad> pendingLoad = entry.mPendingLoad;
+		entry.mPendingLoad.reset();
+		if(!pendingLoad->mResult)
+		{
+			ECHO_LOG_ERROR("Failed to change the resolution of \"" << entry.mTexture->GetName() << "\" using \"" << entry.mFileName << "\"");
+			mStatistics.mFailedLoads++;
+			return;
+		}
+		if(entry.mTexture->GetVersion()!=pendingLoad->mVersion)
+		{
+			// The texture changed while loading so the result is out of date.
+			return;
+		}
+		entry.mTexture->ReplaceBuffer(*pendingLoad->mResult);
+		if(pendingLoad->mLevel > entry.mLevel)
+		{
+			mStatistics.mReductions++;
+		}else
+		{
+			mStatistics.mRestorations++;
+		}
+		entry.mLevel = pendingLoad->mLevel;
+	}
+
+	void TextureResidencyManager::StartLoad(Entry& entry, Size level)
+	{
+		shared_ptr<PendingLoad> pendingLoad = make_shared<PendingLoad>();
+		pendingLoad->mLevel = level;
+		pendingLoad->mVersion = entry.mTexture->GetVersion();
+		entry.mPendingLoad = pendingLoad;
+
+		// Reductions can filter the data the texture already has.
+		shared_ptr<Texture> source;
+		const Texture& texture = *entry.mTexture;
+		if(level > entry.mLevel && texture.GetBuffer())
+		{
+			source = make_shared<Texture>(texture.GetBuffer(), texture.GetWidth(), texture.GetHeight(), texture.GetFormat());
+		}
+		u32 width = std::max<u32>(entry.mWidth >> level, 1);
+		u32 height = std::max<u32>(entry.mHeight >> level, 1);
+		if(!mWorkerPool)
+		{
+			pendingLoad->mResult = LoadLevel(mTextureManager, mProcessor, entry.mFileName, source, width, height);
+			FinishLoad(entry);
+			return;
+		}
+
+		TextureManager& textureManager = mTextureManager;
+		const TextureProcessor& processor = mProcessor;
+		std::string fileName = entry.mFileName;
+		mWorkerPool->Schedule([&textureManager, &processor, pendingLoad, fileName, source, width, height]()
+		{
+			pendingLoad->mResult = LoadLevel(textureManager, processor, fileName, source, width, height);
+		}, pendingLoad->mCounter);
+	}
+
+	shared_ptr<Texture> TextureResidencyManager::LoadLevel(TextureManager& textureManager, const TextureProcessor& processor,
+														const std::string& fileName, shared_ptr<Texture> source, u32 width, u32 height)
+	{
+		if(!source)
+		{
+			source = textureManager.LoadTextureFromFile(fileName);
+			if(!source)
+			{
+				return shared_ptr<Texture>();
+			}
+		}
+		if(source->GetWidth()==width && source->GetHeight()==height)
+		{
+			return source;
+		}
+		return processor.Resize(*source, width, height, TextureProcessor::Filters::BOX);
+	}
+}
@@ -0,0 +1,183 @@
+#include <echo/Animation/AnimationClip.h>
+#include <echo/Animation/Skeleton.h>
+#include <echo/Animation/SkeletonAnimation.h>
+#include <echo/Animation/SkeletonAnimationState.h>
+#include <echo/Animation/BoneAnimationTrack.h>
+#include <echo/Animation/BoneKeyFrame.h>
+#include <doctest/doctest.h>
+#include <cmath>
+#include <random>
+#undef INFO
+
+using namespace Echo;
+
+namespace
+{
+	const Size NUMBER_OF_BONES = 20;
+
+	void CreateSkeleton(Skeleton& skeleton)
+	{
+		std::mt19937 generator(5);
+		std::uniform_real_distribution<f32> value(-1.f, 1.f);
+		skeleton.CreateBone("0", Vector3(0.f, 1.f, 0.f));
+		for(Size b = 1; b < NUMBER_OF_BONES; ++b)
+		{
+			Size parent = b - 1 - std::uniform_int_distribution<Size>(0, std::min<Size>(b - 1, 2))(generator);
+			skeleton.CreateBone(std::to_string(b), std::to_string(parent), Vector3(value(generator), 1.f, value(generator)),
+								Quaternion(Radian(value(generator)), Vector3::UNIT_Z));
+		}
+	}
+
+	/**
+	 * Add smooth key frames at an irregular rate. Some bones are left without keys and every scale is constant.
+	 */
+	void CreateAnimation(Skeleton& skeleton, const std::string& name, f32 phase)
+	{
+		shared_ptr<SkeletonAnimation> animation = skeleton.CreateAnimation(name);
+		for(Size b = 0; b < NUMBER_OF_BONES; ++b)
+		{
+			if(b % 7==3)
+			{
+				continue;
+			}
+			shared_ptr<BoneAnimationTrack> track = animation->GetAnimationTrack(skeleton.GetBone(b));
+			f32 time = 0.f;
+			for(Size k = 0; k < 40; ++k)
+			{
+				BoneKeyFrame& keyFrame = static_cast<BoneKeyFrame&>(*track->CreateKeyFrame(Seconds(time)));
+				f32 angle = std::sin(time * 2.f + phase + b);
+				keyFrame.mPosition = Vector3(std::cos(time + b), 0.5f * angle, 0.f);
+				keyFrame.mOrientation = Quaternion(Radian(angle), Vector3(0.f, 1.f, 0.5f).NormalisedCopy());
+				time += (k % 3==0) ? 0.05f : 0.03f;
+			}
+		}
+	}
+
+	void GetPose(Skeleton& skeleton, std::vector<Vector3>& positions, std::vector<Quaternion>& orientations)
+	{
+		positions.clear();
+		orientations.clear();
+		for(Size b = 0; b < NUMBER_OF_BONES; ++b)
+		{
+			positions.push_back(skeleton.GetBone(b)->GetPosition());
+			orientations.push_back(skeleton.GetBone(b)->GetOrientation());
+		}
+	}
+
+	bool OrientationsMatch(const Quaternion& a, const Quaternion& b, f32 tolerance)
+	{
+		return std::abs(a.Dot(b)) > 1.f - tolerance;
+	}
+}
+
+TEST_CASE("AnimationClip")
+{
+	Skeleton skeleton;
+	CreateSkeleton(skeleton);
+	CreateAnimation(skeleton, "Walk", 0.f);
+	CreateAnimation(skeleton, "Wave", 1.f);
+	skeleton.SetInitialState();
+	shared_ptr<SkeletonAnimation> walk = skeleton.GetAnimation("Walk");
+	shared_ptr<SkeletonAnimation> wave = skeleton.GetAnimation("Wave");
+
+	SUBCASE("BakedPoseMatchesKeyFrames")
+	{
+		shared_ptr<SkeletonAnimationState> walkState = skeleton.CreateAnimationState("Walk", false);
+		shared_ptr<SkeletonAnimationState> waveState = skeleton.CreateAnimationState("Wave", false);
+		walkState->SetWeight(0.7f);
+		waveState->SetWeight(0.4f);
+
+		std::vector<Vector3> expectedPositions, positions;
+		std::vector<Quaternion> expectedOrientations, orientations;
+		Size mismatches = 0;
+		for(Size frame = 0; frame < 50; ++frame)
+		{
+			walkState->AddTime(Seconds(0.037));
+			waveState->AddTime(Seconds(0.021));
+
+			walk->ClearClip();
+			wave->ClearClip();
+			skeleton.MarkTransformsOutOfDate();
+			skeleton.UpdateTransforms();
+			GetPose(skeleton, expectedPositions, expectedOrientations);
+
+			walk->Bake();
+			wave->Bake();
+			skeleton.UpdateTransforms();
+			GetPose(skeleton, positions, orientations);
+			for(Size b = 0; b < NUMBER_OF_BONES; ++b)
+			{
+				if(!positions[b].PositionEquals(expectedPositions[b], 0.0001f) ||
+					!OrientationsMatch(orientations[b], expectedOrientations[b], 0.00001f))
+				{
+					++mismatches;
+				}
+			}
+		}
+		CHECK(mismatches==0);
+	}
+
+	SUBCASE("ConstantChannelsAndTracksWithoutKeys")
+	{
+		shared_ptr<AnimationClip> clip = walk->Bake();
+		// Bones 3, 10 and 17 have no keys.
+		CHECK(clip->GetNumberOfTracks()==NUMBER_OF_BONES - 3);
+		// Scales are constant so each track has one scale key.
+		CHECK(clip->GetNumberOfKeys()==clip->GetNumberOfTracks() * (40 + 40 + 1));
+		CHECK(clip->SampleScale(0, 0.5f)==Vector3(1.f, 1.f, 1.f));
+	}
+
+	SUBCASE("Compression")
+	{
+		shared_ptr<AnimationClip> reference = walk->Bake();
+		AnimationClip::CompressionOptions options;
+		options.mPositionTolerance = 0.01f;
+		options.mOrientationTolerance = 0.01f;
+		options.mScaleTolerance = 0.001f;
+		options.mQuantise = true;
+		AnimationClip compressed(*walk, options);
+		CHECK(compressed.GetNumberOfKeys() < reference->GetNumberOfKeys());
+		CHECK(compressed.GetMemoryUsage() * 2 < reference->GetMemoryUsage());
+
+		f32 maximumPositionError = 0.f;
+		f32 maximumAngleError = 0.f;
+		for(Size t = 0; t < compressed.GetNumberOfTracks(); ++t)
+		{
+			REQUIRE(compressed.GetTrackBoneIndex(t)==reference->GetTrackBoneIndex(t));
+			for(f32 time = 0.f; time < 1.5f; time += 0.01f)
+			{
+				maximumPositionError = std::max(maximumPositionError, compressed.SamplePosition(t, time).Distance(reference->SamplePosition(t, time)));
+				f32 dot = std::min(1.f, std::abs(compressed.SampleOrientation(t, time).Dot(reference->SampleOrientation(t, time))));
+				maximumAngleError = std::max(maximumAngleError, 2.f * std::acos(dot));
+			}
+		}
+		// Interpolating between the reduced keys can add a little more than the tolerance between original keys.
+		CHECK(maximumPositionError < 0.02f);
+		CHECK(maximumAngleError < 0.02f);
+	}
+
+	SUBCASE("UniformResampling")
+	{
+		AnimationClip::CompressionOptions options;
+		options.mSampleRate = 30.f;
+		AnimationClip resampled(*walk, options);
+		shared_ptr<AnimationClip> reference = walk->Bake();
+		f32 maximumPositionError = 0.f;
+		for(Size t = 0; t < resampled.GetNumberOfTracks(); ++t)
+		{
+			for(f32 time = 0.f; time < 1.5f; time += 0.01f)
+			{
+				maximumPositionError = std::max(maximumPositionError, resampled.SamplePosition(t, time).Distance(reference->SamplePosition(t, time)));
+			}
+		}
+		CHECK(maximumPositionError < 0.05f);
+	}
+
+	SUBCASE("AddingKeyFramesDiscardsClip")
+	{
+		walk->Bake();
+		REQUIRE(walk->GetClip());
+		walk->GetAnimationTrack(skeleton.GetBone(0))->CreateKeyFrame(Seconds(5.));
+		CHECK(!walk->GetClip());
+	}
+}
@@ -0,0 +1,203 @@
+#include <echo/Resource/BinaryMeshFile.h>
+#include <echo/Resource/MaterialManager.h>
+#include <echo/Resource/ShaderManager.h>
+#include <echo/Resource/TextureManager.h>
+#include <echo/Platform.h>
+#include <echo/FileSystem/FileSystem.h>
+#include <echo/FileSystem/FileSystemSourceMemory.h>
+#include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Graphics/VertexBuffer.h>
+#include <echo/Graphics/ElementBuffer.h>
+#include <echo/Graphics/PrimitiveTypes.h>
+#include <echo/Graphics/Colour.h>
+#include <cstring>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+using namespace Echo;
+
+namespace
+{
+	void CreateTestMesh(Mesh& mesh, shared_ptr<Material> material)
+	{
+		shared_ptr<SubMesh> a = mesh.CreateSubMesh("A");
+		shared_ptr<VertexBuffer> vertexBuffer = a->GetVertexBuffer(VertexBuffer::Types::STATIC);
+		vertexBuffer->AddVertexAttribute("Position", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR3));
+		vertexBuffer->AddVertexAttribute("Normal", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR3));
+		vertexBuffer->AddVertexAttribute("UV0", VertexAttribute(VertexAttribute::ComponentTypes::TEXTUREUV));
+		VertexAttribute colour(VertexAttribute::ComponentTypes::COLOUR_8);
+		colour.SetNormalise(true);
+		vertexBuffer->AddVertexAttribute("Colour", colour);
+		REQUIRE(vertexBuffer->Allocate(100));
+		vertexBuffer->SetNumberOfElements(90);
+		auto positions = vertexBuffer->GetAccessor<Vector3>("Position");
+		auto normals = vertexBuffer->GetAccessor<Vector3>("Normal");
+		auto uvs = vertexBuffer->GetAccessor<TextureUV>("UV0");
+		auto colours = vertexBuffer->GetAccessor<VertexColour>("Colour");
+		for(Size v = 0; v < 100; ++v)
+		{
+			positions[v] = Vector3(f32(v), f32(v) * 2.f, -f32(v));
+			normals[v] = Vector3::UNIT_Y;
+			uvs[v] = TextureUV(f32(v) / 100.f, 1.f);
+			VertexColour vertexColour;
+			vertexColour.mRGBA = u32(v) * 0x01010101u;
+			colours[v] = vertexColour;
+		}
+		REQUIRE(a->SetElementBuffer(ElementBuffer::Types::STATIC, ElementBuffer::IndexTypes::UNSIGNED_32BIT, ElementBuffer::ElementTypes::TRIANGLE, 30));
+		auto triangles = a->GetElementBuffer()->GetAccessor< ElementBuffer::Triangle<u32> >();
+		for(Size t = 0; t < 30; ++t)
+		{
+			triangles[t].mA = t * 3;
+			triangles[t].mB = t * 3 + 1;
+			triangles[t].mC = t * 3 + 2;
+		}
+		a->SetMaterial(material);
+		a->Finalise();
+
+		// B shares A's vertices.
+		shared_ptr<SubMesh> b = mesh.CreateSubMesh("B");
+		b->SetVertexBuffer(vertexBuffer);
+		REQUIRE(b->SetElementBuffer(ElementBuffer::Types::DYNAMIC, ElementBuffer::IndexTypes::UNSIGNED_16BIT, ElementBuffer::ElementTypes::LINES, 10));
+		auto lines = b->GetElementBuffer()->GetAccessor< ElementBuffer::Line<u16> >();
+		for(u16 l = 0; l < 10; ++l)
+		{
+			lines[l].mA = l;
+			lines[l].mB = l + 50;
+		}
+		b->GetElementBuffer()->SetNumberOfElements(7);
+		b->SetType(SubMesh::MeshTypes::LINES);
+		b->SetVisible(false);
+		b->SetPointAndLineSize(3.f);
+
+		// C has its own unnamed attribute and no element buffer.
+		shared_ptr<SubMesh> c = mesh.CreateSubMesh("C");
+		shared_ptr<VertexBuffer> points = c->GetVertexBuffer();
+		points->AddVertexAttribute(VertexAttribute(VertexAttribute::ComponentTypes::VECTOR3));
+		REQUIRE(points->Allocate(5));
+		auto pointPositions = points->GetAccessor<Vector3>(0);
+		for(Size v = 0; v < 5; ++v)
+		{
+			pointPositions[v] = Vector3(1.f, f32(v), 2.f);
+		}
+		c->SetType(SubMesh::MeshTypes::POINTS);
+		c->Finalise();
+	}
+
+	void CheckVertexBuffersEqual(const VertexBuffer& loaded, const VertexBuffer& original)
+	{
+		CHECK(loaded.GetType()==original.GetType());
+		CHECK(loaded.GetStride()==original.GetStride());
+		CHECK(loaded.GetCapacity()==original.GetCapacity());
+		CHECK(loaded.GetNumberOfElements()==original.GetNumberOfElements());
+		CHECK(loaded.GetNamedAttributes()==original.GetNamedAttributes());
+		REQUIRE(loaded.GetNumberOfVertexAttributes()==original.GetNumberOfVertexAttributes());
+		for(Size a = 0; a < original.GetNumberOfVertexAttributes(); ++a)
+		{
+			CHECK(loaded.GetVertexAttribute(a)->GetComponentType()==original.GetVertexAttribute(a)->GetComponentType());
+			CHECK(loaded.GetVertexAttribute(a)->GetOffset()==original.GetVertexAttribute(a)->GetOffset());
+			CHECK(loaded.GetVertexAttribute(a)->GetNormalise()==original.GetVertexAttribute(a)->GetNormalise());
+		}
+		REQUIRE(loaded.GetBufferSize()==original.GetBufferSize());
+		CHECK(std::memcmp(loaded.GetDataPointer(), original.GetDataPointer(), original.GetBufferSize())==0);
+	}
+
+	void CheckMeshesEqual(Mesh& loaded, const Mesh& original)
+	{
+		REQUIRE(loaded.GetNumberOfSubMeshes()==original.GetNumberOfSubMeshes());
+		for(u32 s = 0; s < original.GetNumberOfSubMeshes(); ++s)
+		{
+			shared_ptr<SubMesh> loadedSubMesh = loaded.GetSubMesh(s);
+			shared_ptr<SubMesh> originalSubMesh = original.GetSubMesh(s);
+			CHECK(loadedSubMesh->GetName()==originalSubMesh->GetName());
+			CHECK(loadedSubMesh->GetMaterial()==originalSubMesh->GetMaterial());
+			CHECK(loadedSubMesh->GetType()==originalSubMesh->GetType());
+			CHECK(loadedSubMesh->GetVisible()==originalSubMesh->GetVisible());
+			CHECK(loadedSubMesh->GetPointAndLineSize()==originalSubMesh->GetPointAndLineSize());
+			CheckVertexBuffersEqual(*loadedSubMesh->GetVertexBuffer(), *originalSubMesh->GetVertexBuffer());
+
+			shared_ptr<ElementBuffer> loadedElements = loadedSubMesh->GetElementBuffer();
+			shared_ptr<ElementBuffer> originalElements = originalSubMesh->GetElementBuffer();
+			REQUIRE((loadedElements!=nullptr)==(originalElements!=nullptr));
+			if(originalElements)
+			{
+				CHECK(loadedElements->GetType()==originalElements->GetType());
+				CHECK(loadedElements->GetIndexType()==originalElements->GetIndexType());
+				CHECK(loadedElements->GetElementType()==originalElements->GetElementType());
+				CHECK(loadedElements->GetCapacity()==originalElements->GetCapacity());
+				CHECK(loadedElements->GetNumberOfElements()==originalElements->GetNumberOfElements());
+				REQUIRE(loadedElements->GetBufferSize()==originalElements->GetBufferSize());
+				CHECK(std::memcmp(loadedElements->GetDataPointer(), originalElements->GetDataPointer(), originalElements->GetBufferSize())==0);
+			}
+		}
+		// Shared vertex buffers stay shared.
+		CHECK(loaded.GetSubMesh(0u)->GetVertexBuffer()==loaded.GetSubMesh(1u)->GetVertexBuffer());
+		CHECK(loaded.GetSubMesh(0u)->GetVertexBuffer()!=loaded.GetSubMesh(2u)->GetVertexBuffer());
+		CHECK(loaded.GetAxisAlignedBox().GetMinimum()==original.GetAxisAlignedBox().GetMinimum());
+		CHECK(loaded.GetAxisAlignedBox().GetMaximum()==original.GetAxisAlignedBox().GetMaximum());
+	}
+}
+
+TEST_CASE("BinaryMeshFile")
+{
+	shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("");
+	TextureManager textureManager(*fileSystem);
+	ShaderManager geometryShaderManager("geometry", *fileSystem);
+	ShaderManager vertexShaderManager("vertex", *fileSystem);
+	ShaderManager fragmentShaderManager("fragment", *fileSystem);
+	MaterialManager materialManager(*fileSystem, textureManager, geometryShaderManager, vertexShaderManager, fragmentShaderManager);
+	shared_ptr<Material> material = materialManager.CreateMaterial("TestMaterial");
+
+	Mesh mesh;
+	CreateTestMesh(mesh, material);
+	{
+		File file = fileSystem->Open("BinaryMeshFileTest.emesh", File::OpenModes::WRITE);
+		REQUIRE(file.IsOpen());
+		REQUIRE(WriteBinaryMeshFile(file, mesh));
+	}
+
+	SUBCASE("Read")
+	{
+		File file = fileSystem->Open("BinaryMeshFileTest.emesh");
+		REQUIRE(file.IsOpen());
+		Mesh loaded;
+		REQUIRE(ReadBinaryMeshFile(file, materialManager, loaded));
+		CheckMeshesEqual(loaded, mesh);
+	}
+
+	File file = fileSystem->Open("BinaryMeshFileTest.emesh");
+	REQUIRE(file.IsOpen());
+	std::vector<u8> fileData(file.GetSize());
+	REQUIRE(file.Read(fileData.data(), fileData.size())==fileData.size());
+
+	SUBCASE("InPlace")
+	{
+		// Memory files are used in place.
+		File memoryFile = FileSystemSourceMemory::OpenDirect(fileData.data(), fileData.size());
+		REQUIRE(memoryFile.GetData()!=nullptr);
+		Mesh loaded;
+		REQUIRE(ReadBinaryMeshFile(memoryFile, materialManager, loaded));
+		CheckMeshesEqual(loaded, mesh);
+	}
+
+	SUBCASE("Invalid")
+	{
+		Mesh loaded;
+		File truncated = FileSystemSourceMemory::OpenDirect(fileData.data(), fileData.size() - 1);
+		CHECK(!ReadBinaryMeshFile(truncated, materialManager, loaded));
+		File header = FileSystemSourceMemory::OpenDirect(fileData.data(), 16);
+		CHECK(!ReadBinaryMeshFile(header, materialManager, loaded));
+		fileData[0] = 'X';
+		File badMagic = FileSystemSourceMemory::OpenDirect(fileData.data(), fileData.size());
+		CHECK(!ReadBinaryMeshFile(badMagic, materialManager, loaded));
+		CHECK(loaded.GetNumberOfSubMeshes()==0);
+	}
+
+	SUBCASE("Skinned")
+	{
+		mesh.GetSubMesh(0u)->SetBoneWeights(make_shared< std::vector<BoneBinding*> >());
+		File skinned = fileSystem->Open("BinaryMeshFileTest.emesh", File::OpenModes::WRITE);
+		CHECK(!WriteBinaryMeshFile(skinned, mesh));
+	}
+}
@@ -0,0 +1,118 @@
+#include <echo/Maths/BoundingVolumeHierarchy.h>
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+#undef INFO
+
+using namespace Echo;
+
+namespace
+{
+	AxisAlignedBox CreateBox(std::mt19937& generator)
+	{
+		std::uniform_real_distribution<f32> position(-100.f, 100.f);
+		std::uniform_real_distribution<f32> size(0.5f, 5.f);
+		Vector3 minimum(position(generator), position(generator), position(generator));
+		return AxisAlignedBox(minimum, minimum + Vector3(size(generator), size(generator), size(generator)));
+	}
+
+	std::vector<Size> QueryRegion(const BoundingVolumeHierarchy<Size>& hierarchy, const std::vector<AxisAlignedBox>& boxes, const AxisAlignedBox& region)
+	{
+		// The hierarchy is conservative so filter the results with the real boxes.
+		std::vector<Size> results;
+		hierarchy.Query(region, [&](Size item)
+		{
+			if(boxes[item].Intersects(region))
+			{
+				results.push_back(item);
+			}
+		});
+		std::sort(results.begin(), results.end());
+		return results;
+	}
+
+	std::vector<Size> BruteForceRegion(const std::vector<AxisAlignedBox>& boxes, const std::vector<bool>& present, const AxisAlignedBox& region)
+	{
+		std::vector<Size> results;
+		for(Size i=0; i < boxes.size(); ++i)
+		{
+			if(present[i] && boxes[i].Intersects(region))
+			{
+				results.push_back(i);
+			}
+		}
+		return results;
+	}
+}
+
+TEST_CASE("BoundingVolumeHierarchy")
+{
+	std::mt19937 generator(1234);
+	const Size numberOfItems = 500;
+	BoundingVolumeHierarchy<Size> hierarchy;
+	std::vector<AxisAlignedBox> boxes;
+	std::vector<bool> present(numberOfItems, true);
+	std::vector<BoundingVolumeHierarchy<Size>::ProxyID> proxies;
+	for(Size i=0; i < numberOfItems; ++i)
+	{
+		boxes.push_back(CreateBox(generator));
+		proxies.push_back(hierarchy.Insert(boxes.back(), i));
+	}
+	CHECK(hierarchy.GetNumberOfItems()==numberOfItems);
+	// A balanced tree should be far shallower than the number of items.
+	CHECK(hierarchy.GetHeight() < 32);
+	CHECK(hierarchy.Insert(AxisAlignedBox(AxisAlignedBox::Extents::INFINITE), 0)==BoundingVolumeHierarchy<Size>::INVALID_PROXY);
+
+	// Small moves stay within the fat boxes, large moves restructure the tree.
+	CHECK(!hierarchy.Move(proxies[0], boxes[0]));
+	for(Size i=0; i < numberOfItems; i+=3)
+	{
+		boxes[i] = CreateBox(generator);
+		hierarchy.Move(proxies[i], boxes[i]);
+	}
+	for(Size i=1; i < numberOfItems; i+=7)
+	{
+		hierarchy.Remove(proxies[i]);
+		present[i] = false;
+	}
+
+	for(Size q=0; q < 50; ++q)
+	{
+		AxisAlignedBox box = CreateBox(generator);
+		AxisAlignedBox region(box.GetMinimum() - Vector3(20.f, 20.f, 20.f), box.GetMaximum() + Vector3(20.f, 20.f, 20.f));
+		CHECK(QueryRegion(hierarchy, boxes, region)==BruteForceRegion(boxes, present, region));
+	}
+
+	// Closest hit ray cast.
+	for(Size q=0; q < 50; ++q)
+	{
+		AxisAlignedBox target = CreateBox(generator);
+		Ray ray(Vector3(-200.f, 0.f, 0.f), (target.GetCentre() - Vector3(-200.f, 0.f, 0.f)).NormalisedCopy());
+		f32 expectedDistance = std::numeric_limits<f32>::max();
+		for(Size i=0; i < numberOfItems; ++i)
+		{
+			std::pair<bool, f32> intersection = ray.Intersects(boxes[i]);
+			if(present[i] && intersection.first)
+			{
+				expectedDistance = std::min(expectedDistance, intersection.second);
+			}
+		}
+		f32 closestDistance = std::numeric_limits<f32>::max();
+		hierarchy.RayCast(ray, closestDistance, [&](Size item, f32 maxDistance)
+		{
+			std::pair<bool, f32> intersection = ray.Intersects(boxes[item]);
+			if(intersection.first && intersection.second < closestDistance)
+			{
+				closestDistance = intersection.second;
+			}
+			return std::min(maxDistance, closestDistance);
+		});
+		CHECK(closestDistance==expectedDistance);
+	}
+
+	hierarchy.Clear();
+	CHECK(hierarchy.GetNumberOfItems()==0);
+	CHECK(hierarchy.GetHeight()==0);
+}
@@ -2,7 +2,10 @@
 #include <echo/FileSystem/FileSystem.h>
 #include <echo/FileSystem/FileSystemSourceVFS.h>
 #include <echo/FileSystem/FileSystemSourceMemory.h>
+#include <echo/Kernel/Thread.h>
 #include <doctest/doctest.h>
+#include <atomic>
+#include <cstring>
 #undef INFO
 
 using namespace Echo;
@@ -66,6 +69,207 @@ TEST_CASE("VFS")
 	fileSystem->DeleteFile("vfstest.vfs");
 }
 
+TEST_CASE("VFSConcurrentReads")
+{
+	shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("evfsc");
+	shared_ptr<FileSystemSourceVFS> vfs = make_shared<FileSystemSourceVFS>(*fileSystem);
+	REQUIRE(fileSystem->InstallSource("vfsout",vfs));
+
+	// Each file is filled with a byte that identifies it so reads from the wrong location are detected.
+	const Size numberOfFiles = 8;
+	const Size fileSize = 100000;
+	std::vector<std::string> contents;
+	for(Size i = 0; i < numberOfFiles; ++i)
+	{
+		contents.push_back(std::string(fileSize + i, static_cast<char>('a' + i)));
+	}
+	for(Size i = 0; i < numberOfFiles; ++i)
+	{
+		CHECK(vfs->AddFile("file" + std::to_string(i),"memory://"+FileSystemSourceMemory::MakeMemoryFileName(contents[i].c_str(),contents[i].length())));
+	}
+	REQUIRE(vfs->SaveVFS("vfsconcurrent.vfs",FileSystemSourceVFS::VFSEndianModes::DEFAULT,FileSystemSourceVFS::VFSEntryNameModes::FULL)==true);
+
+	for(bool memoryMap : {true, false})
+	{
+		shared_ptr<FileSystemSourceVFS> vfsLoad = make_shared<FileSystemSourceVFS>(*fileSystem);
+		REQUIRE(vfsLoad->LoadVFS("vfsconcurrent.vfs",memoryMap));
+		REQUIRE(fileSystem->InstallSource("vfs",vfsLoad));
+	#if defined(ECHO_PLATFORM_LINUX)
+		CHECK(vfsLoad->GetInMemory()==memoryMap);
+	#endif
+
+		// Open all of the files first then read them in small chunks from many threads.
+		std::vector<File> files;
+		for(Size i = 0; i < numberOfFiles; ++i)
+		{
+			files.push_back(fileSystem->Open("vfs://file" + std::to_string(i)));
+			REQUIRE(files.back().IsOpen());
+		}
+		std::atomic<Size> numberOfMismatches(0);
+		std::vector< shared_ptr<Thread> > threads;
+		for(Size i = 0; i < numberOfFiles; ++i)
+		{
+			threads.push_back(make_shared<Thread>("VFSReader"+std::to_string(i),[&files,&contents,&numberOfMismatches,i]()
+			{
+				std::string read;
+				char buffer[1000];
+				while(!files[i].EndOfFile())
+				{
+					size_t bytesRead = files[i].Read(buffer,1,sizeof(buffer));
+					if(bytesRead==0)
+					{
+						break;
+					}
+					read.append(buffer,bytesRead);
+				}
+				if(read!=contents[i])
+				{
+					++numberOfMismatches;
+				}
+			}));
+			threads.back()->Execute();
+		}
+		for(shared_ptr<Thread>& thread : threads)
+		{
+			thread->Join();
+		}
+		CHECK(numberOfMismatches==0);
+
+		// The data is available without copying when the archive is in memory.
+		for(Size i = 0; i < numberOfFiles; ++i)
+		{
+			const u8* data = files[i].GetData();
+			if(vfsLoad->GetInMemory())
+			{
+				REQUIRE(data);
+				CHECK(std::string(reinterpret_cast<const char*>(data),files[i].GetSize())==contents[i]);
+			}else
+			{
+				CHECK(data==nullptr);
+			}
+		}
+		files.clear();
+		fileSystem->UninstallSource("vfs");
+	}
+	fileSystem->DeleteFile("vfsconcurrent.vfs");
+}
+
+TEST_CASE("IndexedVFS")
+{
+	shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("evfsc");
+	shared_ptr<FileSystemSourceVFS> vfs = make_shared<FileSystemSourceVFS>(*fileSystem);
+	REQUIRE(fileSystem->InstallSource("vfsout",vfs));
+
+	// A small file, a compressible file spanning several blocks and a file that doesn't compress.
+	std::string small = "Echo VFS";
+	std::string compressible;
+	while(compressible.size() < FileSystemSourceVFS::INDEXED_BLOCK_SIZE * 3 + 123)
+	{
+		compressible += "Line " + std::to_string(compressible.size() % 1000) + " of a compressible file\n";
+	}
+	std::string random(FileSystemSourceVFS::INDEXED_BLOCK_SIZE + 7, 0);
+	u32 seed = 1234;
+	for(char& c : random)
+	{
+		seed = seed * 1664525 + 1013904223;
+		c = static_cast<char>(seed >> 24);
+	}
+	std::string empty;
+	std::vector< std::pair<std::string, std::string* > > files =
+	{
+		{"small.txt", &small},
+		{"data/compressible.txt", &compressible},
+		{"data/random.bin", &random},
+		{"empty", &empty}
+	};
+
+	std::vector<FileSystemSourceVFS::VFSCompression> compressions = {FileSystemSourceVFS::VFSCompressions::NONE};
+	#ifdef ECHO_LZ4_SUPPORT_ENABLED
+	compressions.push_back(FileSystemSourceVFS::VFSCompressions::LZ4);
+	#endif
+	#ifdef ECHO_ZSTD_SUPPORT_ENABLED
+	compressions.push_back(FileSystemSourceVFS::VFSCompressions::ZSTD);
+	#endif
+
+	Size uncompressedArchiveSize = 0;
+	for(FileSystemSourceVFS::VFSCompression compression : compressions)
+	{
+		for(FileSystemSourceVFS::VFSEndianMode endianMode : {FileSystemSourceVFS::VFSEndianModes::LITTLE, FileSystemSourceVFS::VFSEndianModes::BIG})
+		{
+			vfs->ClearOutDirectory();
+			for(auto& file : files)
+			{
+				// The small file is always stored uncompressed.
+				FileSystemSourceVFS::VFSCompression fileCompression = (file.second==&small) ? FileSystemSourceVFS::VFSCompressions::NONE : FileSystemSourceVFS::VFSCompressions::DEFAULT;
+				CHECK(vfs->AddFile(file.first,"memory://"+FileSystemSourceMemory::MakeMemoryFileName(file.second->c_str(),file.second->length()),fileCompression));
+			}
+			REQUIRE(vfs->SaveIndexedVFS("vfsindexed.vfs",endianMode,FileSystemSourceVFS::VFSEntryNameModes::DUAL,compression));
+
+			for(bool memoryMap : {true, false})
+			{
+				shared_ptr<FileSystemSourceVFS> vfsLoad = make_shared<FileSystemSourceVFS>(*fileSystem);
+				REQUIRE(vfsLoad->LoadVFS("vfsindexed.vfs",memoryMap));
+				REQUIRE(vfsLoad->GetIndexed());
+				REQUIRE(fileSystem->InstallSource("vfs",vfsLoad));
+				if(compression==FileSystemSourceVFS::VFSCompressions::NONE)
+				{
+					uncompressedArchiveSize = vfsLoad->GetVFSSize();
+				}else
+				{
+					CHECK(vfsLoad->GetVFSSize() < uncompressedArchiveSize - compressible.size() / 2);
+				}
+
+				// DUAL creates entries for the full name and the file name.
+				std::vector<std::string> names = vfsLoad->GetFileNames();
+				CHECK(names.size()==6);
+				File byFileName = fileSystem->Open("vfs://random.bin");
+				CHECK(byFileName.IsOpen());
+				CHECK(!fileSystem->Open("vfs://missing").IsOpen());
+
+				for(auto& file : files)
+				{
+					File vfsFile = fileSystem->Open("vfs://"+file.first);
+					REQUIRE(vfsFile.IsOpen());
+					REQUIRE(vfsFile.GetSize()==file.second->size());
+					std::string wholeFile;
+					vfsFile.ReadFileIntoString(wholeFile);
+					CHECK(wholeFile==*file.second);
+
+					// Uncompressed entries are aligned and accessible in place when the archive is mapped.
+					const u8* data = vfsFile.GetData();
+					if(data && !file.second->empty())
+					{
+						CHECK((reinterpret_cast<uintptr_t>(data) % FileSystemSourceVFS::INDEXED_ALIGNMENT)==0);
+						CHECK(std::memcmp(data,file.second->data(),file.second->size())==0);
+					}
+				}
+
+				// Small and random data are always stored uncompressed.
+				CHECK((fileSystem->Open("vfs://small.txt").GetData()!=nullptr)==vfsLoad->GetInMemory());
+				CHECK((fileSystem->Open("vfs://data/random.bin").GetData()!=nullptr)==vfsLoad->GetInMemory());
+				if(compression!=FileSystemSourceVFS::VFSCompressions::NONE)
+				{
+					CHECK(fileSystem->Open("vfs://data/compressible.txt").GetData()==nullptr);
+				}
+
+				// Reads from any position, including across blocks.
+				File compressibleFile = fileSystem->Open("vfs://data/compressible.txt");
+				for(size_t position : {size_t(0), compressible.size() - 10, size_t(FileSystemSourceVFS::INDEXED_BLOCK_SIZE - 5), size_t(100), size_t(FileSystemSourceVFS::INDEXED_BLOCK_SIZE * 2 + 1)})
+				{
+					std::string part(FileSystemSourceVFS::INDEXED_BLOCK_SIZE + 20, 0);
+					REQUIRE(compressibleFile.Seek(position)==position);
+					size_t bytesRead = compressibleFile.Read(&part[0],1,part.size());
+					CHECK(bytesRead==std::min(part.size(),compressible.size() - position));
+					part.resize(bytesRead);
+					CHECK(part==compressible.substr(position,bytesRead));
+				}
+				fileSystem->UninstallSource("vfs");
+			}
+		}
+	}
+	fileSystem->DeleteFile("vfsindexed.vfs");
+}
+
 #if defined(ECHO_PLATFORM_LINUX)
 TEST_CASE("CURLFS")
 {
@@ -0,0 +1,89 @@
+#include <echo/Graphics/Frustum.h>
+#include <doctest/doctest.h>
+#include <random>
+#include <vector>
+
+using namespace Echo;
+
+namespace
+{
+	bool IsSet(const std::vector<u32>& visibility, Size index)
+	{
+		return (visibility[index / 32] & (1u << (index % 32)))!=0;
+	}
+
+	void CheckMatchesIsVisible(const Frustum& frustum, const std::vector<AxisAlignedBox>& boxes)
+	{
+		PackedAxisAlignedBoxes packed;
+		for(const AxisAlignedBox& box : boxes)
+		{
+			packed.Add(box);
+		}
+		std::vector<u32> visibility;
+		std::vector<u8> culledBy;
+		Size expectedVisible = 0;
+		for(Size i = 0; i < boxes.size(); ++i)
+		{
+			if(frustum.IsVisible(boxes[i]))
+			{
+				++expectedVisible;
+			}
+		}
+
+		// The second pass uses the plane cache from the first.
+		for(Size pass = 0; pass < 2; ++pass)
+		{
+			CHECK(frustum.IsVisible(packed, visibility, &culledBy)==expectedVisible);
+			REQUIRE(visibility.size()==(boxes.size() + 31) / 32);
+			REQUIRE(culledBy.size()==boxes.size());
+			for(Size i = 0; i < boxes.size(); ++i)
+			{
+				CHECK(IsSet(visibility, i)==frustum.IsVisible(boxes[i]));
+			}
+		}
+		CHECK(frustum.IsVisible(packed, visibility)==expectedVisible);
+	}
+}
+
+TEST_CASE("FrustumPackedBoxes")
+{
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<f32> position(-150.f, 150.f);
+	std::uniform_real_distribution<f32> size(0.1f, 20.f);
+	std::vector<AxisAlignedBox> boxes;
+	// Not a multiple of the padding so the last partial group is covered.
+	for(Size i = 0; i < 1003; ++i)
+	{
+		Vector3 minimum(position(generator), position(generator), position(generator) - 50.f);
+		boxes.push_back(AxisAlignedBox(minimum, minimum + Vector3(size(generator), size(generator), size(generator))));
+	}
+	boxes[3] = AxisAlignedBox::BOX_NULL;
+	boxes[4] = AxisAlignedBox::BOX_INFINITE;
+
+	Frustum frustum;
+	frustum.SetNearPlane(1.f);
+	frustum.SetFarPlane(100.f);
+
+	SUBCASE("Perspective")
+	{
+		CheckMatchesIsVisible(frustum, boxes);
+	}
+
+	SUBCASE("InfiniteFarPlane")
+	{
+		frustum.SetFarPlane(0.f);
+		CheckMatchesIsVisible(frustum, boxes);
+	}
+
+	SUBCASE("Orthographic")
+	{
+		frustum.SetProjectionType(ProjectionTypes::ORTHOGRAPHIC);
+		frustum.SetOrthoWindow(80.f, 60.f);
+		CheckMatchesIsVisible(frustum, boxes);
+	}
+
+	SUBCASE("Empty")
+	{
+		CheckMatchesIsVisible(frustum, std::vector<AxisAlignedBox>());
+	}
+}
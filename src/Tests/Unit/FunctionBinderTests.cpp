@@ -131,6 +131,124 @@ void NestedCallTests()
 	CheckCallResult("Bar() 1000 \"GetString()\"");
 }
 
+void CompiledCallTests()
+{
+	using namespace Echo;
+	FunctionBinder binder;
+
+	binder.RegisterVoid("Foo", bind(&Foo));
+	binder.Register("Bar", bind(&Bar,placeholders::_1,placeholders::_2),false,boost::fusion::vector<size_t,std::string>());
+	binder.RegisterVoid("GetString", bind(&GetString));
+	binder.Register("See", bind(&See,placeholders::_1,placeholders::_2),false,boost::fusion::vector<int,std::string>());
+
+	std::vector< std::pair<std::string, std::string> > testCallsAndResults;
+	testCallsAndResults.push_back(std::make_pair("Foo()",						"Foo()"));
+	testCallsAndResults.push_back(std::make_pair("Bar(1,A string)",				"Bar() 1 A string"));
+	testCallsAndResults.push_back(std::make_pair("Bar(2,GetString())",			"GetString()Bar() 2 Here is a string"));
+	testCallsAndResults.push_back(std::make_pair("See(6,This \\(should\\) contain a bracket)", "See() 6 This (should) contain a bracket"));
+
+	// Compiled calls should behave the same each time they are called.
+	for(size_t i = 0; i < testCallsAndResults.size(); ++i)
+	{
+		FunctionBinder::CompiledCall call = binder.Compile(testCallsAndResults[i].first);
+		CHECK(call.GetResolved());
+		for(size_t c = 0; c < 2; ++c)
+		{
+			aGlobalStringStream.str("");
+			CHECK(binder.Call(call).mStatus==FunctionBinder::CallStatuses::SUCCESS);
+			CheckCallResult(testCallsAndResults[i].second);
+		}
+	}
+
+	FunctionBinder::CompiledCall seeCall = binder.Compile("See(7,seven)");
+	FunctionBinder::CallResult result = binder.Call(seeCall);
+	REQUIRE(result.GetValuePointerAs<std::string>());
+	CHECK(*result.GetValuePointerAs<std::string>()=="7 seven");
+	FunctionBinder::CompiledCall badCall = binder.Compile("See(seven,7)");
+	CHECK(binder.Call(badCall).mStatus==FunctionBinder::CallStatuses::PARAMETER_CONVERSION_FAILED);
+
+	// Binding changes cause calls to be compiled again.
+	FunctionBinder::CompiledCall sawCall = binder.Compile("Saw(5)");
+	CHECK(!sawCall.GetResolved());
+	CHECK(binder.Call(sawCall).mStatus==FunctionBinder::CallStatuses::FUNCTION_NOT_FOUND);
+	binder.Register("Saw", bind(&Saw,placeholders::_1),false,boost::fusion::vector<int>());
+	aGlobalStringStream.str("");
+	CHECK(binder.Call(sawCall).mStatus==FunctionBinder::CallStatuses::SUCCESS);
+	CheckCallResult("Saw() 5");
+	binder.Deregister("Saw");
+	CHECK(binder.Call(sawCall).mStatus==FunctionBinder::CallStatuses::FUNCTION_NOT_FOUND);
+
+	// Calls are resolved through the fallback binder and changes to it are picked up.
+	shared_ptr<FunctionBinder> fallback(new FunctionBinder());
+	binder.SetFallback(fallback);
+	fallback->Register("Saw", bind(&Saw,placeholders::_1),false,boost::fusion::vector<int>());
+	aGlobalStringStream.str("");
+	CHECK(binder.Call(sawCall).mStatus==FunctionBinder::CallStatuses::SUCCESS);
+	CheckCallResult("Saw() 5");
+	fallback->Deregister("Saw");
+	CHECK(binder.Call(sawCall).mStatus==FunctionBinder::CallStatuses::FUNCTION_NOT_FOUND);
+}
+
+void TypedFunctionTests()
+{
+	using namespace Echo;
+	FunctionBinder binder;
+	binder.RegisterVoid("Foo", bind(&Foo));
+	binder.Register("Bar", bind(&Bar,placeholders::_1,placeholders::_2),false,boost::fusion::vector<size_t,std::string>());
+	binder.Register("See", bind(&See,placeholders::_1,placeholders::_2),false,boost::fusion::vector<int,std::string>());
+	binder.EnableBuiltIn();
+
+	FunctionBinder::TypedFunction<void()> foo = binder.Resolve<void()>("Foo");
+	REQUIRE(foo);
+	aGlobalStringStream.str("");
+	foo();
+	CheckCallResult("Foo()");
+
+	FunctionBinder::TypedFunction<void(size_t,std::string)> bar = binder.Resolve<void(size_t,std::string)>("Bar");
+	REQUIRE(bar);
+	aGlobalStringStream.str("");
+	bar(5,"GetString()");
+	CheckCallResult("Bar() 5 GetString()");
+
+	FunctionBinder::TypedFunction<std::string(int,std::string)> see = binder.Resolve<std::string(int,std::string)>("See");
+	REQUIRE(see);
+	CHECK(see(6,"six")=="6 six");
+
+	FunctionBinder::TypedFunction<Vector3(f32,f32,f32)> vector3 = binder.Resolve<Vector3(f32,f32,f32)>("Vector3");
+	REQUIRE(vector3);
+	CHECK(vector3(1.f,2.f,3.f)==Vector3(1.f,2.f,3.f));
+
+	// The signature has to match the registration exactly.
+	CHECK(!binder.Resolve<std::string(int)>("See"));
+	CHECK(!binder.Resolve<void(int,std::string)>("See"));
+	CHECK(!binder.Resolve<void()>("Missing"));
+
+	// Functions are resolved through the fallback binder.
+	shared_ptr<FunctionBinder> fallback(new FunctionBinder());
+	fallback->Register("Saw", bind(&Saw,placeholders::_1),false,boost::fusion::vector<int>());
+	binder.SetFallback(fallback);
+	FunctionBinder::TypedFunction<std::string(int)> saw = binder.Resolve<std::string(int)>("Saw");
+	REQUIRE(saw);
+	CHECK(saw(9)=="9");
+}
+
+void ScriptTests()
+{
+	using namespace Echo;
+	FunctionBinder binder;
+	binder.RegisterVoid("Foo", bind(&Foo));
+	binder.Register("Bar", bind(&Bar,placeholders::_1,placeholders::_2),false,boost::fusion::vector<size_t,std::string>());
+	binder.RegisterVoid("GetString", bind(&GetString));
+
+	FunctionBinder::CompiledScript script = binder.CompileScript("Foo()\r\n\nBar(1,A string)\n  Bar(2,GetString())\nMissing()\n");
+	CHECK(script.size()==4);
+	for(size_t r = 0; r < 2; ++r)
+	{
+		aGlobalStringStream.str("");
+		CHECK(binder.Call(script)==3);
+		CheckCallResult("Foo()Bar() 1 A stringGetString()Bar() 2 Here is a string");
+	}
+}
 
 void CallOnly(int, std::string)
 {
@@ -255,6 +373,9 @@ TEST_CASE("FunctionBinder")
 	// Turn off log output, we will just use output from this test.
 	Echo::gDefaultLogger.SetLogMask(Echo::Logger::LogLevels::INFO);
 	NestedCallTests();
+	CompiledCallTests();
+	TypedFunctionTests();
+	ScriptTests();
 	
 #ifdef PROFILE_FUNCTIONBINDER
 	SpeedTest();
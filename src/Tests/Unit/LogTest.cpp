@@ -1,5 +1,8 @@
 #include <echo/Util/StringUtils.h>
 #include <echo/Util/Utils.h>
+#include <echo/Kernel/Thread.h>
+#include <algorithm>
+#include <vector>
 
 #include <doctest/doctest.h>
 #undef INFO
@@ -24,3 +27,86 @@ TEST_CASE("Logger")
 	gDefaultLogger.RemoveLogOutputStream("cout2");
 	ECHO_LOG("CUSTOM","This should not appear.");
 }
+
+TEST_CASE("AsynchronousLogger")
+{
+	using namespace Echo;
+	const Size numberOfThreads = 8;
+	const Size messagesPerThread = 1000;
+
+	shared_ptr<std::stringstream> output = make_shared<std::stringstream>();
+	Logger logger;
+	logger.RemoveLogOutputStream("stdout");
+	logger.SetLogOutputStream("test",output);
+
+	auto logFromThreads = [&logger,numberOfThreads,messagesPerThread]()
+	{
+		std::vector< shared_ptr<Thread> > threads;
+		for(Size t=0; t < numberOfThreads; ++t)
+		{
+			threads.push_back(make_shared<Thread>("Logger"+std::to_string(t),[&logger,t,messagesPerThread]()
+			{
+				for(Size m=0; m < messagesPerThread; ++m)
+				{
+					logger.Log(Logger::LogLevels::INFO,__FILE__,__LINE__,std::to_string(t) + ":" + std::to_string(m));
+				}
+			}));
+			threads.back()->Execute();
+		}
+		for(shared_ptr<Thread>& thread : threads)
+		{
+			thread->Join();
+		}
+	};
+
+	auto countLines = [&output](const std::string& containing)
+	{
+		std::string line;
+		Size count = 0;
+		std::stringstream lines(output->str());
+		while(std::getline(lines,line))
+		{
+			if(line.find(containing)!=std::string::npos)
+			{
+				count++;
+			}
+		}
+		return count;
+	};
+
+	SUBCASE("Block")
+	{
+		logger.SetAsynchronous(true,16,Logger::OverflowPolicies::BLOCK);
+		CHECK(logger.GetAsynchronous());
+		logFromThreads();
+		logger.Flush();
+		CHECK(countLines("INFO")==numberOfThreads*messagesPerThread);
+		CHECK(logger.GetNumberOfDroppedMessages()==0);
+
+		// Each thread's messages need to be written in order.
+		std::stringstream lines(output->str());
+		std::string line;
+		std::vector<s64> lastMessage(numberOfThreads,-1);
+		while(std::getline(lines,line))
+		{
+			Size colon = line.rfind(':');
+			Size space = line.rfind(' ',colon);
+			REQUIRE(colon!=std::string::npos);
+			REQUIRE(space!=std::string::npos);
+			Size t = std::stoul(line.substr(space+1,colon-space-1));
+			s64 m = std::stol(line.substr(colon+1));
+			REQUIRE(t < numberOfThreads);
+			CHECK(m==lastMessage[t]+1);
+			lastMessage[t] = m;
+		}
+	}
+
+	SUBCASE("Drop")
+	{
+		logger.SetAsynchronous(true,4,Logger::OverflowPolicies::DROP);
+		logFromThreads();
+		logger.SetAsynchronous(false);
+		CHECK(!logger.GetAsynchronous());
+		CHECK((countLines("INFO") + logger.GetNumberOfDroppedMessages())==numberOfThreads*messagesPerThread);
+	}
+}
@@ -0,0 +1,203 @@
+#include <echo/Maths/Matrix4.h>
+#include <echo/Maths/Quaternion.h>
+#include <echo/Maths/AxisAlignedBox.h>
+#include <doctest/doctest.h>
+#include <random>
+#include <vector>
+
+using namespace Echo;
+
+/**
+ * These tests compare the maths types against straightforward scalar versions so they cover whichever
+ * implementation the build selected.
+ */
+namespace
+{
+	const f32 TOLERANCE = 1e-4f;
+
+	/**
+	 * The implementations may use fused multiply adds or a different order of operations so results are
+	 * compared relative to their magnitude.
+	 */
+	bool Near(f32 a, f32 b)
+	{
+		return Maths::Abs(a - b) <= TOLERANCE * (1.f + Maths::Abs(b));
+	}
+
+	Matrix4 CreateAffine(std::mt19937& generator)
+	{
+		std::uniform_real_distribution<f32> value(-2.f, 2.f);
+		std::uniform_real_distribution<f32> scale(0.5f, 2.f);
+		Matrix4 m;
+		m.MakeTransform(Vector3(value(generator), value(generator), value(generator)),
+						Vector3(scale(generator), scale(generator), scale(generator)),
+						Quaternion(Radian(value(generator)), Vector3(value(generator), value(generator), 1.f).NormalisedCopy()));
+		return m;
+	}
+
+	Matrix4 CreateMatrix(std::mt19937& generator)
+	{
+		std::uniform_real_distribution<f32> value(-2.f, 2.f);
+		Matrix4 m;
+		for(Size r = 0; r < 4; ++r)
+		{
+			for(Size c = 0; c < 4; ++c)
+			{
+				m[r][c] = value(generator);
+			}
+		}
+		return m;
+	}
+
+	Matrix4 Multiply(const Matrix4& a, const Matrix4& b)
+	{
+		Matrix4 r = Matrix4::ZERO;
+		for(Size i = 0; i < 4; ++i)
+		{
+			for(Size j = 0; j < 4; ++j)
+			{
+				for(Size k = 0; k < 4; ++k)
+				{
+					r[i][j] += a[i][k] * b[k][j];
+				}
+			}
+		}
+		return r;
+	}
+
+	void CheckEqual(const Matrix4& a, const Matrix4& b)
+	{
+		for(Size r = 0; r < 4; ++r)
+		{
+			for(Size c = 0; c < 4; ++c)
+			{
+				CHECK(Near(a[r][c], b[r][c]));
+			}
+		}
+	}
+
+	void CheckEqual(const Vector3& a, const Vector3& b)
+	{
+		CHECK(Near(a.x, b.x));
+		CHECK(Near(a.y, b.y));
+		CHECK(Near(a.z, b.z));
+	}
+
+	void CheckEqual(const Quaternion& a, const Quaternion& b)
+	{
+		CHECK(Near(a.w, b.w));
+		CHECK(Near(a.x, b.x));
+		CHECK(Near(a.y, b.y));
+		CHECK(Near(a.z, b.z));
+	}
+}
+
+TEST_CASE("Maths")
+{
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<f32> value(-10.f, 10.f);
+
+	SUBCASE("Matrix4")
+	{
+		for(Size i = 0; i < 10; ++i)
+		{
+			Matrix4 a = CreateMatrix(generator);
+			Matrix4 b = CreateMatrix(generator);
+			CheckEqual(a * b, Multiply(a, b));
+
+			Matrix4 affineA = CreateAffine(generator);
+			Matrix4 affineB = CreateAffine(generator);
+			CheckEqual(affineA.ConcatenateAffine(affineB), Multiply(affineA, affineB));
+			CheckEqual(affineA.InverseAffine(), affineA.Inverse());
+			CheckEqual(affineA.InverseAffine() * affineA, Matrix4::IDENTITY);
+
+			Vector4 v(value(generator), value(generator), value(generator), value(generator));
+			Vector4 r = v * a;
+			CHECK(Near(r.x, v.x * a[0][0] + v.y * a[1][0] + v.z * a[2][0] + v.w * a[3][0]));
+			CHECK(Near(r.y, v.x * a[0][1] + v.y * a[1][1] + v.z * a[2][1] + v.w * a[3][1]));
+			CHECK(Near(r.z, v.x * a[0][2] + v.y * a[1][2] + v.z * a[2][2] + v.w * a[3][2]));
+			CHECK(Near(r.w, v.x * a[0][3] + v.y * a[1][3] + v.z * a[2][3] + v.w * a[3][3]));
+		}
+	}
+
+	SUBCASE("TransformAffineArray")
+	{
+		Matrix4 m = CreateAffine(generator);
+		// Not a multiple of four so the remaining vectors are covered.
+		std::vector<Vector3> input;
+		for(Size i = 0; i < 11; ++i)
+		{
+			input.push_back(Vector3(value(generator), value(generator), value(generator)));
+		}
+		std::vector<Vector3> output(input.size());
+		m.TransformAffine(input.data(), output.data(), input.size());
+		for(Size i = 0; i < input.size(); ++i)
+		{
+			CheckEqual(output[i], m.TransformAffine(input[i]));
+		}
+
+		std::vector<Vector3> inPlace = input;
+		m.TransformAffine(inPlace.data(), inPlace.data(), inPlace.size());
+		for(Size i = 0; i < input.size(); ++i)
+		{
+			CheckEqual(inPlace[i], output[i]);
+		}
+	}
+
+	SUBCASE("Quaternion")
+	{
+		for(Size i = 0; i < 10; ++i)
+		{
+			Quaternion p(Radian(value(generator)), Vector3(value(generator), value(generator), 1.f).NormalisedCopy());
+			Quaternion q(Radian(value(generator)), Vector3(1.f, value(generator), value(generator)).NormalisedCopy());
+			Quaternion expected(
+				p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y,
+				p.w * q.y + p.y * q.w + p.z * q.x - p.x * q.z,
+				p.w * q.z + p.z * q.w + p.x * q.y - p.y * q.x,
+				p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z);
+			CheckEqual(p * q, expected);
+
+			// Rotating by the product is the same as rotating by each in turn.
+			Vector3 v(value(generator), value(generator), value(generator));
+			CheckEqual((p * q) * v, p * (q * v));
+
+			CheckEqual(Quaternion::Slerp(0.f, p, q), p);
+			CheckEqual(Quaternion::Slerp(1.f, p, q), q);
+			Quaternion half = Quaternion::Slerp(0.5f, p, q, true);
+			CHECK(Near(half.LengthSquared(), 1.f));
+			CHECK(Near(half.Dot(p), half.Dot(p.Dot(q) < 0.f ? -q : q)));
+		}
+		// Nearly identical quaternions are linearly interpolated and normalised.
+		Quaternion p(Radian(0.5f), Vector3::UNIT_Y);
+		Quaternion q(Radian(0.5001f), Vector3::UNIT_Y);
+		CHECK(Near(Quaternion::Slerp(0.5f, p, q).LengthSquared(), 1.f));
+	}
+
+	SUBCASE("AxisAlignedBoxArray")
+	{
+		Matrix4 m = CreateAffine(generator);
+		std::vector<AxisAlignedBox> input;
+		for(Size i = 0; i < 6; ++i)
+		{
+			Vector3 minimum(value(generator), value(generator), value(generator));
+			input.push_back(AxisAlignedBox(minimum, minimum + Vector3(1.f, 2.f, 3.f) * f32(i + 1)));
+		}
+		input.push_back(AxisAlignedBox::BOX_NULL);
+		input.push_back(AxisAlignedBox::BOX_INFINITE);
+
+		std::vector<AxisAlignedBox> output(input.size());
+		AxisAlignedBox::TransformAffine(m, input.data(), output.data(), input.size());
+		for(Size i = 0; i < input.size(); ++i)
+		{
+			AxisAlignedBox expected = input[i];
+			expected.TransformAffine(m);
+			CHECK(output[i].IsNull()==expected.IsNull());
+			CHECK(output[i].IsInfinite()==expected.IsInfinite());
+			if(expected.IsFinite())
+			{
+				CheckEqual(output[i].GetMinimum(), expected.GetMinimum());
+				CheckEqual(output[i].GetMaximum(), expected.GetMaximum());
+			}
+		}
+	}
+}
@@ -11,6 +11,8 @@
 #include <echo/Kernel/Kernel.h>
 #include <echo/Platform.h>
 #include <echo/Kernel/SimpleExecutionModel.h>
+#include <cstring>
+#include <limits>
 
 #include <doctest/doctest.h>
 #undef INFO
@@ -516,6 +518,125 @@ TEST_CASE("ConnectionReceiveProcessSpeed")
 
 }
 
+TEST_CASE("ConnectionVectoredSend")
+{
+	// Collects everything sent so the stream can be checked. Each send is limited so packets are split across calls.
+	class CollectingConnection : public Connection
+	{
+	public:
+		CollectingConnection(NetworkManager& manager, Size maximumBytesPerSend) :
+			Connection(manager),
+			mMaximumBytesPerSend(maximumBytesPerSend),
+			mNumberOfSends(0)
+		{}
+		virtual ~CollectingConnection(){}
+
+		virtual bool _Disconnect() {return true;}
+		virtual bool _Connect() {return true;}
+
+		virtual Connection::SendResult Send(const u8*, int)
+		{
+			return Connection::SendResult{0,Connection::SendStatuses::DISCONNECT};
+		}
+
+		virtual Connection::SendResult SendVectored(const SendBuffer* buffers, Size numberOfBuffers) override
+		{
+			mNumberOfSends++;
+			Size sent = 0;
+			for(Size b = 0; b < numberOfBuffers && sent < mMaximumBytesPerSend; ++b)
+			{
+				Size bytes = std::min(buffers[b].mSize, mMaximumBytesPerSend - sent);
+				mStream.insert(mStream.end(), buffers[b].mData, buffers[b].mData + bytes);
+				sent += bytes;
+			}
+			if(sent==0)
+			{
+				return Connection::SendResult{0,Connection::SendStatuses::WAIT};
+			}
+			return Connection::SendResult{sent,Connection::SendStatuses::SUCCESS};
+		}
+
+		virtual ReceiveResult Receive(u8*, int)
+		{
+			return Connection::ReceiveResult{0,ReceiveStatuses::WAIT};
+		}
+
+		Size mMaximumBytesPerSend;
+		Size mNumberOfSends;
+		std::vector<u8> mStream;
+	};
+
+	NetworkManager networkManager;
+	const Size numberOfPackets = 200;
+
+	auto checkStream = [numberOfPackets](const std::vector<u8>& stream)
+	{
+		// The first packet is the host details packet.
+		Size offset = 0;
+		Size packetIndex = 0;
+		while(offset < stream.size())
+		{
+			DataPacketHeader header;
+			REQUIRE(offset + header.GetHeaderDataSizeInBytes() <= stream.size());
+			header.BuildFromData(&stream[offset], Connection::IsPlatformBigEndian());
+			offset += header.GetHeaderDataSizeInBytes();
+			REQUIRE(offset + header.GetDataLength() <= stream.size());
+			if(header.GetPacketTypeID()!=Connection::PacketTypes::REMOTE_DETAILS)
+			{
+				CHECK(header.GetPacketTypeID()==(packetIndex % 3)+1);
+				if(header.GetDataLength() > 0)
+				{
+					CHECK(header.GetDataLength()==sizeof(u32));
+					u32 value;
+					std::memcpy(&value, &stream[offset], sizeof(u32));
+					CHECK(value==packetIndex);
+				}
+				packetIndex++;
+			}
+			offset += header.GetDataLength();
+		}
+		CHECK(packetIndex==numberOfPackets);
+	};
+
+	auto sendPackets = [&networkManager,numberOfPackets](shared_ptr<CollectingConnection> connection)
+	{
+		for(u32 p = 0; p < numberOfPackets; ++p)
+		{
+			// Mix control packets in to make sure header only packets are handled in the middle of a batch.
+			if(p % 3 == 1)
+			{
+				connection->SendControlPacket((p % 3)+1);
+			}else
+			{
+				connection->SendData(reinterpret_cast<const u8*>(&p),sizeof(u32),(p % 3)+1);
+			}
+		}
+	};
+
+	SUBCASE("Batched")
+	{
+		shared_ptr<CollectingConnection> connection = make_shared<CollectingConnection>(networkManager, std::numeric_limits<Size>::max());
+		connection->SetState(Connection::States::CONNECTED);
+		Size sendsBefore = connection->mNumberOfSends;
+		connection->SetState(Connection::States::DISCONNECTED);
+		sendPackets(connection);
+		connection->SetState(Connection::States::CONNECTED);
+		CHECK(connection->GetBytesQueuedToSend()==0);
+		// Queued packets should be coalesced rather than needing a send per header and payload.
+		CHECK((connection->mNumberOfSends - sendsBefore) <= (numberOfPackets / Connection::MAXIMUM_PACKETS_PER_SEND) + 2);
+		checkStream(connection->mStream);
+	}
+
+	SUBCASE("PartialSends")
+	{
+		shared_ptr<CollectingConnection> connection = make_shared<CollectingConnection>(networkManager, 7);
+		connection->SetState(Connection::States::CONNECTED);
+		sendPackets(connection);
+		CHECK(connection->GetBytesQueuedToSend()==0);
+		checkStream(connection->mStream);
+	}
+}
+
 TEST_CASE("BoostASIOTCP")
 {
 	gDefaultLogger.SetLogMask(Echo::Logger::LogLevels::INFO | Echo::Logger::LogLevels::ERROR | Echo::Logger::LogLevels::WARNING);
@@ -120,6 +120,69 @@ void ConditionalTests()
 	}
 }
 
+void CompiledConditionalTests()
+{
+	ConditionalEvaluator parser;
+	Scalar mass = 120;
+	parser.RegisterVariable("mass",mass);
+
+	std::vector<std::string> expressions;
+	expressions.push_back("mass >= 100");
+	expressions.push_back("mass*2 == 240 && mass<121");
+	expressions.push_back("mass - 1 < mass");
+	expressions.push_back("(mass + 5) % 7 == 6");
+	expressions.push_back("1==2 && 100+1==1 || 11>=10");
+	expressions.push_back("1==2 && 11>=10 || 100+1==1");
+	expressions.push_back("mass/0 > 1");
+	expressions.push_back("2 <= 2 && +3 != -3");
+	expressions.push_back("0 || mass - 120");
+
+	// Compiled expressions should give the same results as parsing.
+	for(size_t i =0; i < expressions.size(); ++i)
+	{
+		shared_ptr<CompiledConditional> compiled = parser.Compile(expressions[i]);
+		CHECK_MESSAGE(bool(compiled),expressions[i]);
+		optional<bool> expected = parser.Parse(expressions[i]);
+		CHECK_MESSAGE(bool(expected),expressions[i]);
+		if(compiled && expected)
+		{
+			optional<bool> result = compiled->Evaluate();
+			CHECK_MESSAGE(bool(result),expressions[i]);
+			CHECK_MESSAGE(result==expected,expressions[i]);
+			CHECK_MESSAGE(parser.Evaluate(expressions[i])==expected,expressions[i]);
+		}
+	}
+
+	// Variables are read when evaluated.
+	shared_ptr<CompiledConditional> compiled = parser.Compile("mass > 100");
+	REQUIRE(compiled);
+	CHECK(compiled->Evaluate()==optional<bool>(true));
+	mass = 50;
+	CHECK(compiled->Evaluate()==optional<bool>(false));
+
+	// Symbols that aren't registered fail until they are registered.
+	compiled = parser.Compile("speed > 10");
+	REQUIRE(compiled);
+	CHECK(!compiled->Evaluate());
+	CHECK(!parser.Evaluate("speed > 10"));
+	parser.RegisterVariableViaGetter("speed",[](){return 20.;});
+	CHECK(compiled->Evaluate()==optional<bool>(true));
+	CHECK(parser.Evaluate("speed > 10")==optional<bool>(true));
+	parser.DeregisterVariable("speed");
+	CHECK(!compiled->Evaluate());
+
+	// Symbols can contain '-' so this is a look up of "mass-120" which fails in the same way as Parse().
+	compiled = parser.Compile("mass-120 > 0");
+	REQUIRE(compiled);
+	CHECK(!compiled->Evaluate());
+	CHECK(!parser.Parse("mass-120 > 0"));
+
+	CHECK(!parser.Compile("mass >"));
+	CHECK(!parser.Compile("(mass"));
+	CHECK(!parser.Compile("mass & 1"));
+	CHECK(!parser.Evaluate("mass >"));
+}
+
 void SubTests()
 {
 	VariableSubstitutor parser;
@@ -155,5 +218,6 @@ TEST_CASE("Parser")
 	VariableChangeTest();
 	OperatorTests();
 	ConditionalTests();
+	CompiledConditionalTests();
 	SubTests();
 }
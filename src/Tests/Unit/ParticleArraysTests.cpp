@@ -0,0 +1,110 @@
+#include <echo/Graphics/ParticleArrays.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <doctest/doctest.h>
+#include <random>
+#undef INFO
+
+using namespace Echo;
+
+namespace
+{
+	std::vector<StandardParticle> CreateParticles(Size numberOfParticles)
+	{
+		std::mt19937 generator(42);
+		std::uniform_real_distribution<f32> value(-2.f, 2.f);
+		std::uniform_real_distribution<f32> unit(0.f, 1.f);
+		std::vector<StandardParticle> particles;
+		for(Size i=0; i < numberOfParticles; ++i)
+		{
+			StandardParticle p;
+			p.SetPosition(Vector3(value(generator), value(generator), value(generator)))
+				.SetVelocity(Vector3(value(generator), value(generator), value(generator)))
+				.SetAcceleration(Vector3(value(generator), value(generator), value(generator)))
+				.SetLinearDamping(Vector3(unit(generator), unit(generator), unit(generator)))
+				.SetScale(Vector3(1.f + unit(generator), 1.f + unit(generator), 1.f))
+				.SetScaleVelocity(Vector3(unit(generator), unit(generator), 0.f))
+				.SetAngle(Vector3(value(generator) * 3.f, value(generator) * 3.f, value(generator) * 3.f))
+				.SetAngularVelocity(Vector3(value(generator), value(generator), value(generator)))
+				.SetInitialColour(Colour(unit(generator), unit(generator), unit(generator), 1.f))
+				.SetFinalColour(Colour(unit(generator), unit(generator), unit(generator), 0.f))
+				.SetTime(Seconds(0.05f + unit(generator)));
+			p.mInitialTime = p.mTimeLeft;
+			particles.push_back(p);
+		}
+		return particles;
+	}
+
+	bool Near(const Vector3& a, const Vector3& b)
+	{
+		return (a - b).Length() < 0.001f;
+	}
+}
+
+TEST_CASE("ParticleArrays")
+{
+	gDefaultLogger.SetLogMask(Logger::LogLevels::NONE);
+
+	const Size NUMBER_OF_PARTICLES = 1000;
+	std::vector<StandardParticle> emitted = CreateParticles(NUMBER_OF_PARTICLES);
+
+	SUBCASE("Storage round trip")
+	{
+		StandardParticleArrays arrays;
+		for(const StandardParticle& p : emitted)
+		{
+			arrays.push_back(p);
+		}
+		REQUIRE(arrays.size()==NUMBER_OF_PARTICLES);
+		StandardParticle p = arrays.Get(10);
+		CHECK(p.mPosition==emitted[10].mPosition);
+		CHECK(p.mAngularVelocity==emitted[10].mAngularVelocity);
+		CHECK(p.mFinalColour.mBlue==emitted[10].mFinalColour.mBlue);
+		arrays.clear();
+		CHECK(arrays.empty());
+		CHECK(arrays.capacity() >= NUMBER_OF_PARTICLES);
+		arrays.reserve(NUMBER_OF_PARTICLES * 2);
+		CHECK(arrays.capacity() >= NUMBER_OF_PARTICLES * 2);
+	}
+
+	SUBCASE("Matches SimpleStandardParticleSystem")
+	{
+		shared_ptr<WorkerPool> workerPool(new WorkerPool(3));
+		Vector2 size(2.f, 1.f);
+		SimpleStandardParticleProcessor referenceProcessor;
+		SimpleStandardParticleSystem reference(referenceProcessor, StandardParticleQuadMeshBuilder(size));
+		// A small job size so the parallel path is used.
+		ArrayStandardParticleSystem system(StandardParticleArrayProcessor(workerPool, 100), StandardParticleArrayQuadBuilder(size, workerPool, 100));
+		reference.Emit(emitted);
+		system.Emit(emitted);
+
+		for(Size frame=0; frame < 10; ++frame)
+		{
+			reference.Update(Seconds(0.016f));
+			system.Update(Seconds(0.016f));
+
+			shared_ptr<VertexBuffer> referenceVertices = reference.GetMesh()->GetSubMesh(0)->GetVertexBuffer();
+			shared_ptr<VertexBuffer> vertices = system.GetMesh()->GetSubMesh(0)->GetVertexBuffer();
+			REQUIRE(vertices->GetNumberOfElements()==referenceVertices->GetNumberOfElements());
+			CHECK(system.GetMesh()->GetSubMesh(0)->GetElementBuffer()->GetNumberOfElements()==vertices->GetNumberOfElements() / 2);
+
+			// Both processors remove particles by swapping with the last particle so the order is the same.
+			VertexBuffer::Accessor<Vector3> referencePositions = referenceVertices->GetAccessor<Vector3>("Position");
+			VertexBuffer::Accessor<Vector3> positions = vertices->GetAccessor<Vector3>("Position");
+			VertexBuffer::Accessor<VertexColour> referenceColours = referenceVertices->GetAccessor<VertexColour>("Colour");
+			VertexBuffer::Accessor<VertexColour> colours = vertices->GetAccessor<VertexColour>("Colour");
+			Size mismatches = 0;
+			for(Size v=0; v < vertices->GetNumberOfElements(); ++v)
+			{
+				if(!Near(positions[v], referencePositions[v]))
+				{
+					++mismatches;
+				}
+				if(std::abs(static_cast<int>(colours[v]._RGBA.g) - static_cast<int>(referenceColours[v]._RGBA.g)) > 1)
+				{
+					++mismatches;
+				}
+			}
+			CHECK(mismatches==0);
+		}
+	}
+}
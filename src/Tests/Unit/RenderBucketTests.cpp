@@ -0,0 +1,66 @@
+#include <echo/Graphics/RenderBucket.h>
+#include <echo/Graphics/RenderPass.h>
+#include <echo/Graphics/MultipassRenderable.h>
+#include <doctest/doctest.h>
+#include <vector>
+#undef INFO
+
+using namespace Echo;
+
+namespace
+{
+	class TestRenderable : public MultipassRenderable
+	{
+	public:
+		void Render(RenderContext&, const RenderPass&, Colour) override {}
+	};
+
+	Matrix4 AtDepth(f32 depth)
+	{
+		return Matrix4::GetTranslation(0.f, 0.f, -depth);
+	}
+}
+
+TEST_CASE("RenderBucket")
+{
+	RenderPass opaqueA;
+	RenderPass opaqueB;
+	RenderPass transparent;
+	opaqueA.SetBlendMode(BlendModes::NONE);
+	opaqueB.SetBlendMode(BlendModes::NONE);
+	transparent.SetBlendMode(BlendModes::TRANSPARENT);
+	TestRenderable renderable;
+	std::vector< Light* > lights;
+
+	RenderBucket bucket;
+	// Submitted in back to front order as Scene does.
+	bucket.Submit(transparent, renderable, Matrix4::IDENTITY, AtDepth(10.f), Colours::WHITE, lights);
+	bucket.Submit(opaqueA, renderable, Matrix4::IDENTITY, AtDepth(9.f), Colours::WHITE, lights);
+	bucket.Submit(opaqueB, renderable, Matrix4::IDENTITY, AtDepth(8.f), Colours::WHITE, lights);
+	bucket.Submit(transparent, renderable, Matrix4::IDENTITY, AtDepth(20.f), Colours::WHITE, lights);
+	bucket.Submit(opaqueA, renderable, Matrix4::IDENTITY, AtDepth(2.f), Colours::WHITE, lights);
+	bucket.Submit(opaqueB, renderable, Matrix4::IDENTITY, AtDepth(100.f), Colours::WHITE, lights);
+	bucket.Submit(transparent, renderable, Matrix4::IDENTITY, AtDepth(5.f), Colours::WHITE, lights);
+	bucket.Sort();
+	REQUIRE(bucket.GetNumberOfCommands()==7);
+
+	// Opaque passes are grouped and front to back within a group.
+	CHECK(bucket.GetCommand(0).mPass==&opaqueA);
+	CHECK(bucket.GetCommand(1).mPass==&opaqueA);
+	CHECK(bucket.GetCommand(0).mWorldView.GetTranslation().z > bucket.GetCommand(1).mWorldView.GetTranslation().z);
+	CHECK(bucket.GetCommand(2).mPass==&opaqueB);
+	CHECK(bucket.GetCommand(3).mPass==&opaqueB);
+	CHECK(bucket.GetCommand(2).mWorldView.GetTranslation().z > bucket.GetCommand(3).mWorldView.GetTranslation().z);
+
+	// Transparent passes are last and back to front.
+	for(Size i=0; i < 7; ++i)
+	{
+		CHECK(RenderBucket::IsTransparentKey(bucket.GetKey(i))==(i >= 4));
+	}
+	CHECK(bucket.GetCommand(4).mWorldView.GetTranslation().z==-20.f);
+	CHECK(bucket.GetCommand(5).mWorldView.GetTranslation().z==-10.f);
+	CHECK(bucket.GetCommand(6).mWorldView.GetTranslation().z==-5.f);
+
+	bucket.Clear();
+	CHECK(bucket.GetNumberOfCommands()==0);
+}
@@ -0,0 +1,182 @@
+#include <echo/Util/SegmentedRingAllocator.h>
+#include <doctest/doctest.h>
+#include <vector>
+#undef INFO
+
+using namespace Echo;
+
+namespace
+{
+	/**
+	 * A block as GLUniformRingBuffer sees it. Memory is simulated by recording which block last wrote each byte.
+	 */
+	struct TestBlock
+	{
+		Size id;
+		Size size;
+		bool dirty;
+		u64 uploadedSequence;
+		Size offset;
+	};
+
+	bool NeedsUpload(const SegmentedRingAllocator& allocator, const TestBlock& block)
+	{
+		return block.dirty || !allocator.IsCurrent(block.uploadedSequence);
+	}
+
+	void Upload(SegmentedRingAllocator& allocator, std::vector<Size>& memory, TestBlock& block)
+	{
+		Size offset = 0;
+		bool startedSegment = false;
+		REQUIRE(allocator.Allocate(block.size, offset, startedSegment));
+		for(Size i = 0; i < block.size; ++i)
+		{
+			memory[offset + i] = block.id;
+		}
+		block.dirty = false;
+		block.uploadedSequence = allocator.GetSequence();
+		block.offset = offset;
+	}
+
+	// Mirrors GLShaderProgram::SetVariables().
+	void SetVariables(SegmentedRingAllocator& allocator, std::vector<Size>& memory, std::vector<TestBlock>& blocks)
+	{
+		Size passes = 0;
+		u64 sequence;
+		do
+		{
+			sequence = allocator.GetSequence();
+			for(Size b = 0; b < blocks.size(); ++b)
+			{
+				if(NeedsUpload(allocator, blocks[b]))
+				{
+					Upload(allocator, memory, blocks[b]);
+				}
+			}
+		}while(sequence!=allocator.GetSequence() && ++passes < allocator.GetNumberOfSegments());
+	}
+
+	bool IsIntact(const std::vector<Size>& memory, const TestBlock& block)
+	{
+		for(Size i = 0; i < block.size; ++i)
+		{
+			if(memory[block.offset + i]!=block.id)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST_CASE("SegmentedRingAllocator")
+{
+	SUBCASE("Allocation")
+	{
+		SegmentedRingAllocator allocator(1000, 4, 64);
+		// Segments are rounded down to the alignment.
+		CHECK(allocator.GetSegmentSize()==192);
+		CHECK(allocator.GetSize()==768);
+
+		Size offset = 1;
+		bool startedSegment = true;
+		REQUIRE(allocator.Allocate(10, offset, startedSegment));
+		CHECK(offset==0);
+		CHECK(!startedSegment);
+		REQUIRE(allocator.Allocate(10, offset, startedSegment));
+		CHECK(offset==64);
+		CHECK(!startedSegment);
+		REQUIRE(allocator.Allocate(64, offset, startedSegment));
+		CHECK(offset==128);
+		CHECK(!startedSegment);
+
+		// The segment is full so the next allocation moves to the next one.
+		REQUIRE(allocator.Allocate(1, offset, startedSegment));
+		CHECK(offset==192);
+		CHECK(startedSegment);
+		CHECK(allocator.GetSegment()==1);
+		CHECK(allocator.GetSequence()==1);
+
+		CHECK(!allocator.Allocate(193, offset, startedSegment));
+		CHECK(allocator.GetSequence()==1);
+	}
+
+	SUBCASE("Wraparound")
+	{
+		SegmentedRingAllocator allocator(256, 4, 16);
+		Size offset = 0;
+		bool startedSegment = false;
+		REQUIRE(allocator.Allocate(64, offset, startedSegment));
+		const u64 first = allocator.GetSequence();
+		CHECK(allocator.IsCurrent(first));
+
+		// Filling each segment starts the next one. The first segment's data is intact until it is started again.
+		for(Size s = 1; s < 4; ++s)
+		{
+			REQUIRE(allocator.Allocate(64, offset, startedSegment));
+			CHECK(startedSegment);
+			CHECK(offset==s * 64);
+			CHECK(allocator.IsCurrent(first));
+		}
+		REQUIRE(allocator.Allocate(64, offset, startedSegment));
+		CHECK(startedSegment);
+		CHECK(offset==0);
+		CHECK(allocator.GetSegment()==0);
+		CHECK(allocator.GetSequence()==4);
+		CHECK(!allocator.IsCurrent(first));
+		CHECK(allocator.IsCurrent(first + 1));
+	}
+
+	SUBCASE("Clean blocks are uploaded again when their segment is reused")
+	{
+		SegmentedRingAllocator allocator(4 * 256, 4, 16);
+		std::vector<Size> memory(allocator.GetSize(), 0);
+
+		// A camera block that never changes and a per object block that changes every draw.
+		std::vector<TestBlock> blocks;
+		TestBlock camera = {1, 128, true, 0, 0};
+		TestBlock object = {2, 48, true, 0, 0};
+		blocks.push_back(camera);
+		blocks.push_back(object);
+
+		Size cameraUploads = 0;
+		for(Size draw = 0; draw < 100; ++draw)
+		{
+			const u64 cameraSequence = blocks[0].uploadedSequence;
+			blocks[1].dirty = true;
+			SetVariables(allocator, memory, blocks);
+			if(draw==0 || blocks[0].uploadedSequence!=cameraSequence)
+			{
+				++cameraUploads;
+			}
+			REQUIRE(IsIntact(memory, blocks[0]));
+			REQUIRE(IsIntact(memory, blocks[1]));
+		}
+		// The ring wrapped several times so the camera block was uploaded more than once, but not every draw.
+		CHECK(allocator.GetSequence() > 8);
+		CHECK(cameraUploads > 1);
+		CHECK(cameraUploads < 100);
+	}
+
+	SUBCASE("A block is uploaded again if a later block in the same pass reuses its segment")
+	{
+		SegmentedRingAllocator allocator(4 * 64, 4, 16);
+		std::vector<Size> memory(allocator.GetSize(), 0);
+
+		std::vector<TestBlock> blocks;
+		TestBlock first = {1, 64, true, 0, 0};
+		TestBlock second = {2, 64, true, 0, 0};
+		blocks.push_back(first);
+		blocks.push_back(second);
+
+		// Each upload fills a segment so every few draws the second block's upload reuses the segment the first
+		// block is in, after the first block has been checked.
+		for(Size draw = 0; draw < 10; ++draw)
+		{
+			blocks[1].dirty = true;
+			SetVariables(allocator, memory, blocks);
+			REQUIRE(IsIntact(memory, blocks[0]));
+			REQUIRE(IsIntact(memory, blocks[1]));
+		}
+	}
+}
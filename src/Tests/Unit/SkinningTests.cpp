@@ -0,0 +1,166 @@
+#include <echo/Graphics/Skinning.h>
+#include <echo/Graphics/RenderPass.h>
+#include <echo/Graphics/ShaderProgram.h>
+#include <echo/Maths/Quaternion.h>
+#include <doctest/doctest.h>
+#include <cmath>
+#include <random>
+#undef INFO
+
+using namespace Echo;
+
+namespace
+{
+	std::vector<Matrix4> CreatePalette(Size numberOfBones)
+	{
+		std::mt19937 generator(3);
+		std::uniform_real_distribution<f32> value(-1.f, 1.f);
+		std::vector<Matrix4> palette(numberOfBones);
+		for(Matrix4& m : palette)
+		{
+			Quaternion orientation(Radian(value(generator) * 3.f), Vector3(value(generator), value(generator), 1.f).NormalisedCopy());
+			m.MakeTransform(Vector3(value(generator), value(generator), value(generator)) * 10.f,
+							Vector3(1.f + value(generator) * 0.5f, 1.f, 1.f), orientation);
+		}
+		return palette;
+	}
+
+	/**
+	 * Skins the vertices the way SubMesh used to, transforming by each bone and summing the weighted results.
+	 */
+	Vector3 ReferenceSkin(const std::vector<Matrix4>& palette, const std::map< Size, f32 >& influences, const Vector3& position)
+	{
+		f32 total = 0.f;
+		for(const std::pair<const Size, f32>& influence : influences)
+		{
+			total += influence.second;
+		}
+		Vector3 result = Vector3::ZERO;
+		for(const std::pair<const Size, f32>& influence : influences)
+		{
+			result += (palette[influence.first] * position) * (influence.second / total);
+		}
+		return result;
+	}
+
+	void CheckSkinning(Size influencesPerVertex)
+	{
+		const Size numberOfVertices = 1000;
+		const Size numberOfBones = 40;
+		std::vector<Matrix4> palette = CreatePalette(numberOfBones);
+		std::mt19937 generator(11);
+		std::uniform_real_distribution<f32> value(-5.f, 5.f);
+		std::uniform_int_distribution<Size> bone(0, numberOfBones - 1);
+		std::uniform_int_distribution<Size> count(1, influencesPerVertex);
+
+		std::map< u32, std::map< Size, f32 > > influences;
+		std::vector<Vector3> positions;
+		for(Size v = 0; v < numberOfVertices; ++v)
+		{
+			positions.push_back(Vector3(value(generator), value(generator), value(generator)));
+			Size numberOfInfluences = count(generator);
+			for(Size i = 0; i < numberOfInfluences; ++i)
+			{
+				influences[static_cast<u32>(v)][bone(generator)] = std::abs(value(generator)) + 0.1f;
+			}
+		}
+
+		SkinWeights weights;
+		weights.Build(influences, numberOfVertices);
+		REQUIRE(weights.GetNumberOfVertices()==numberOfVertices);
+		CHECK(weights.GetInfluencesPerVertex()==influencesPerVertex);
+		CHECK(weights.GetMaximumBoneIndex() < numberOfBones);
+
+		VertexBuffer buffer(VertexBuffer::Types::STATIC);
+		buffer.AddVertexAttribute("Position", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR3));
+		weights.AddVertexAttributes(buffer);
+		REQUIRE(buffer.Allocate(numberOfVertices));
+		CHECK(weights.WriteVertexAttributes(buffer));
+
+		VertexBuffer::Accessor<Vector3> destination = buffer.GetAccessor<Vector3>("Position");
+		// Skin in two ranges to check the ranges are respected.
+		SkinningEngine::SkinPositions(palette.data(), weights, positions.data(), destination, 0, numberOfVertices / 3);
+		SkinningEngine::SkinPositions(palette.data(), weights, positions.data(), destination, numberOfVertices / 3, numberOfVertices);
+
+		VertexBuffer::Accessor<Vector4> weightAttribute = buffer.GetAccessor<Vector4>("BoneWeights");
+		Size mismatches = 0;
+		for(Size v = 0; v < numberOfVertices; ++v)
+		{
+			Vector3 expected = ReferenceSkin(palette, influences[static_cast<u32>(v)], positions[v]);
+			if(!expected.PositionEquals(destination[v], 0.001f))
+			{
+				++mismatches;
+			}
+			// Weights are sorted largest first.
+			CHECK(weightAttribute[v].x >= weightAttribute[v].y);
+		}
+		CHECK(mismatches==0);
+	}
+}
+
+TEST_CASE("Skinning")
+{
+	SUBCASE("FourInfluences")
+	{
+		CheckSkinning(4);
+	}
+
+	SUBCASE("EightInfluences")
+	{
+		CheckSkinning(8);
+	}
+
+	SUBCASE("WeightsAreNormalisedAndTruncated")
+	{
+		std::map< u32, std::map< Size, f32 > > influences;
+		for(Size b = 0; b < 10; ++b)
+		{
+			influences[0][b] = static_cast<f32>(b + 1);
+		}
+		// Vertex 1 has no influences.
+		influences[2][5] = 2.f;
+
+		SkinWeights weights;
+		weights.Build(influences, 3);
+		REQUIRE(weights.GetInfluencesPerVertex()==8);
+		const f32* w = weights.GetWeights();
+		const u16* indices = weights.GetBoneIndices();
+
+		// The two smallest influences are dropped and the rest normalised.
+		f32 total = 0.f;
+		for(Size i = 0; i < 8; ++i)
+		{
+			total += w[i];
+		}
+		CHECK(std::abs(total - 1.f) < 0.0001f);
+		CHECK(indices[0]==9);
+		CHECK(indices[7]==2);
+		CHECK(std::abs(w[0] - 10.f / 52.f) < 0.0001f);
+
+		for(Size i = 8; i < 16; ++i)
+		{
+			CHECK(w[i]==0.f);
+		}
+		CHECK(indices[16]==5);
+		CHECK(w[16]==1.f);
+		CHECK(weights.GetMaximumBoneIndex()==9);
+	}
+
+	SUBCASE("BoneMatricesAreLookedUpOncePerProgramVersion")
+	{
+		RenderPass pass;
+		shared_ptr<ShaderProgram> program = make_shared<ShaderProgram>();
+		pass.SetProgram(program);
+		CHECK(pass.CacheProgramBoneMatrices(2)==0);
+
+		// Variables added without a version change, as if the program was still being built, aren't seen.
+		program->GetUniformVariable<Matrix4>("boneMatrices[0]", true);
+		program->GetUniformVariable<Matrix4>("boneMatrices[1]", true);
+		CHECK(pass.CacheProgramBoneMatrices(2)==0);
+
+		// Building the program increments the version.
+		program->IncrementVersion();
+		CHECK(pass.CacheProgramBoneMatrices(2)==2);
+		CHECK(pass.CacheProgramBoneMatrices(4)==2);
+	}
+}
@@ -0,0 +1,282 @@
+#include <echo/Graphics/SpriteBatch.h>
+#include <echo/Graphics/SpriteAtlas.h>
+#include <echo/Graphics/Material.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Resource/TextureManager.h>
+#include <echo/FileSystem/FileSystem.h>
+#include <doctest/doctest.h>
+#undef INFO
+
+using namespace Echo;
+
+namespace
+{
+	bool Near(const Vector3& a, const Vector3& b)
+	{
+		return (a - b).Length() < 0.0001f;
+	}
+
+	bool Near(const TextureUV& a, const TextureUV& b)
+	{
+		return Maths::Abs(a.u - b.u) < 0.0001f && Maths::Abs(a.v - b.v) < 0.0001f;
+	}
+
+	/**
+	 * Get the sub meshes that would be drawn.
+	 */
+	std::vector< shared_ptr<SubMesh> > GetVisibleSubMeshes(SpriteBatch& batch)
+	{
+		std::vector< shared_ptr<SubMesh> > subMeshes;
+		for(u32 i = 0; i < batch.GetMesh()->GetNumberOfSubMeshes(); ++i)
+		{
+			shared_ptr<SubMesh> subMesh = batch.GetMesh()->GetSubMesh(i);
+			if(subMesh->GetVisible())
+			{
+				subMeshes.push_back(subMesh);
+			}
+		}
+		return subMeshes;
+	}
+
+	/**
+	 * Create a texture where each pixel is a different value.
+	 */
+	shared_ptr<Texture> CreateTexture(u32 width, u32 height, u32 seed)
+	{
+		shared_ptr<Texture> texture(new Texture(width, height, Texture::Formats::R8G8B8A8));
+		Texture::Accessor<u32> pixels = texture->GetAccessor<u32>();
+		for(Size i = 0; i < pixels.GetSize(); ++i)
+		{
+			pixels[i] = static_cast<u32>(seed * 100000 + i);
+		}
+		return texture;
+	}
+}
+
+TEST_CASE("SpriteBatch")
+{
+	shared_ptr<Material> materialA = make_shared<Material>();
+	materialA->SetToDefaultMaterial();
+	shared_ptr<Material> materialB = make_shared<Material>();
+	materialB->SetToDefaultMaterial();
+
+	SpriteBatch batch;
+	batch.SetAlwaysFaceCamera(false);
+	std::vector<Size> ids;
+	for(Size i = 0; i < 5; ++i)
+	{
+		SpriteBatch::Instance sprite;
+		sprite.mPosition = Vector3(static_cast<f32>(i), 0.f, 0.f);
+		sprite.mSize = Vector2(2.f, 1.f);
+		sprite.mMaterial = (i < 3) ? materialA : materialB;
+		ids.push_back(batch.AddSprite(sprite));
+	}
+	CHECK(batch.GetNumberOfSprites()==5);
+
+	SUBCASE("SpritesAreGroupedByMaterial")
+	{
+		batch.Build(Quaternion::IDENTITY);
+		CHECK(batch.GetNumberOfBatches()==2);
+		std::vector< shared_ptr<SubMesh> > subMeshes = GetVisibleSubMeshes(batch);
+		REQUIRE(subMeshes.size()==2);
+		CHECK(subMeshes[0]->GetMaterial()==materialA);
+		CHECK(subMeshes[0]->GetVertexBuffer()->GetNumberOfElements()==12);
+		CHECK(subMeshes[0]->GetElementBuffer()->GetNumberOfElements()==6);
+		CHECK(subMeshes[1]->GetMaterial()==materialB);
+		CHECK(subMeshes[1]->GetVertexBuffer()->GetNumberOfElements()==8);
+
+		// The second sprite of material A is at x=1.
+		VertexBuffer::Accessor<Vector3> positions = subMeshes[0]->GetComponents<Vector3>("Position");
+		CHECK(Near(positions[4], Vector3(0.f, 0.5f, 0.f)));
+		CHECK(Near(positions[5], Vector3(2.f, 0.5f, 0.f)));
+		CHECK(Near(positions[6], Vector3(0.f, -0.5f, 0.f)));
+		CHECK(Near(positions[7], Vector3(2.f, -0.5f, 0.f)));
+	}
+
+	SUBCASE("TexturesSplitBatches")
+	{
+		shared_ptr<Texture> texture = CreateTexture(4, 4, 1);
+		batch.GetSprite(ids[0]).mTexture = texture;
+		batch.GetSprite(ids[1]).mTexture = texture;
+		batch.Build(Quaternion::IDENTITY);
+		CHECK(batch.GetNumberOfBatches()==3);
+		std::vector< shared_ptr<SubMesh> > subMeshes = GetVisibleSubMeshes(batch);
+		REQUIRE(subMeshes.size()==3);
+		CHECK(subMeshes[0]->GetMaterial()!=materialA);
+		CHECK(subMeshes[0]->GetMaterial()->GetTexture()==texture);
+		CHECK(materialA->GetTexture()!=texture);
+
+		// Changing back reuses the existing groups and hides the unused one.
+		batch.GetSprite(ids[0]).mTexture.reset();
+		batch.GetSprite(ids[1]).mTexture.reset();
+		batch.Build(Quaternion::IDENTITY);
+		CHECK(batch.GetNumberOfBatches()==2);
+		CHECK(batch.GetMesh()->GetNumberOfSubMeshes()==3);
+	}
+
+	SUBCASE("RemovedSpritesAreNotDrawn")
+	{
+		batch.RemoveSprite(ids[3]);
+		batch.RemoveSprite(ids[4]);
+		CHECK(batch.GetNumberOfSprites()==3);
+		batch.GetSprite(ids[0]).mVisible = false;
+		batch.Build(Quaternion::IDENTITY);
+		CHECK(batch.GetNumberOfBatches()==1);
+		std::vector< shared_ptr<SubMesh> > subMeshes = GetVisibleSubMeshes(batch);
+		REQUIRE(subMeshes.size()==1);
+		CHECK(subMeshes[0]->GetVertexBuffer()->GetNumberOfElements()==8);
+
+		// The slot of a removed sprite is reused.
+		CHECK(batch.AddSprite()==ids[4]);
+	}
+
+	SUBCASE("FacesCamera")
+	{
+		batch.SetAlwaysFaceCamera(true);
+		Quaternion cameraOrientation(Degree(90.f), Vector3::UNIT_Y);
+		batch.Build(cameraOrientation);
+		std::vector< shared_ptr<SubMesh> > subMeshes = GetVisibleSubMeshes(batch);
+		REQUIRE(subMeshes.size()==2);
+		VertexBuffer::Accessor<Vector3> positions = subMeshes[0]->GetComponents<Vector3>("Position");
+		VertexBuffer::Accessor<Vector3> normals = subMeshes[0]->GetComponents<Vector3>("Normal");
+		// Rotated about y by 90 degrees the quad's right is -z and its normal is +x.
+		CHECK(Near(positions[0], Vector3(0.f, 0.5f, 1.f)));
+		CHECK(Near(positions[3], Vector3(0.f, -0.5f, -1.f)));
+		CHECK(Near(normals[0], Vector3::UNIT_X));
+	}
+
+	SUBCASE("TextureCoordinatesAndColour")
+	{
+		SpriteBatch::Instance& sprite = batch.GetSprite(ids[0]);
+		sprite.mUV1 = TextureUV(0.25f, 0.5f);
+		sprite.mUV2 = TextureUV(0.75f, 1.f);
+		sprite.mFlippedHorizontally = true;
+		sprite.mColour = Colours::RED;
+		batch.Build(Quaternion::IDENTITY);
+		std::vector< shared_ptr<SubMesh> > subMeshes = GetVisibleSubMeshes(batch);
+		REQUIRE(subMeshes.size()==2);
+		VertexBuffer::Accessor<TextureUV> uvs = subMeshes[0]->GetComponents<TextureUV>("UV0");
+		CHECK(Near(uvs[0], TextureUV(0.75f, 0.5f)));
+		CHECK(Near(uvs[1], TextureUV(0.25f, 0.5f)));
+		CHECK(Near(uvs[3], TextureUV(0.25f, 1.f)));
+		CHECK(Near(uvs[4], TextureUV(0.f, 0.f)));
+		VertexBuffer::Accessor<VertexColour> colours = subMeshes[0]->GetComponents<VertexColour>("Colour");
+		CHECK(colours[0]._RGBA.r==255);
+		CHECK(colours[0]._RGBA.g==0);
+		CHECK(colours[4]._RGBA.g==255);
+	}
+}
+
+TEST_CASE("SpriteBatchAnimation")
+{
+	FileSystem fileSystem;
+	TextureManager textureManager(fileSystem);
+	shared_ptr<Texture> texture1 = CreateTexture(8, 8, 1);
+	shared_ptr<Texture> texture2 = CreateTexture(8, 8, 2);
+	shared_ptr<SpriteAnimation> animation(new SpriteAnimation(textureManager, "Walk"));
+	animation->AddFrame("frame1", Seconds(0.1)).texture(texture1).width(50.f).height(100.f);
+	animation->AddFrame("frame2", Seconds(0.1)).texture(texture2).width(100.f).height(100.f);
+	animation->SetMode(SpriteAnimation::Modes::PLAY_ONCE_AND_HIDE);
+
+	SpriteBatch batch;
+	Size id = batch.AddSprite();
+	batch.SetAnimation(id, animation);
+	CHECK(batch.GetSprite(id).mTexture==texture1);
+	CHECK(Maths::Abs(batch.GetSprite(id).mSize.x - 0.5f) < 0.0001f);
+	CHECK(Maths::Abs(batch.GetSprite(id).mSize.y - 1.f) < 0.0001f);
+
+	batch.Update(Seconds(0.05));
+	CHECK(batch.GetSprite(id).mFrameIndex==0);
+	batch.Update(Seconds(0.06));
+	CHECK(batch.GetSprite(id).mFrameIndex==1);
+	CHECK(batch.GetSprite(id).mTexture==texture2);
+	CHECK(Maths::Abs(batch.GetSprite(id).mSize.x - 1.f) < 0.0001f);
+	batch.Update(Seconds(0.11));
+	CHECK(batch.GetSprite(id).mFrameIndex==1);
+	CHECK(!batch.GetSprite(id).mVisible);
+
+	// Restarting the animation shows the first frame again.
+	batch.GetSprite(id).mVisible = true;
+	batch.GetSprite(id).mAnimationMode = SpriteAnimation::Modes::LOOP;
+	batch.SetAnimation(id, animation);
+	batch.Update(Seconds(0.11));
+	batch.Update(Seconds(0.11));
+	CHECK(batch.GetSprite(id).mFrameIndex==0);
+	CHECK(batch.GetSprite(id).mVisible);
+}
+
+TEST_CASE("SpriteAtlas")
+{
+	FileSystem fileSystem;
+	TextureManager textureManager(fileSystem);
+	shared_ptr<Texture> sheet = CreateTexture(32, 16, 1);
+	shared_ptr<Texture> small = CreateTexture(8, 8, 2);
+	shared_ptr<Texture> large = CreateTexture(40, 20, 3);
+	shared_ptr<Texture> otherFormat(new Texture(4, 4, Texture::Formats::R8G8B8));
+
+	shared_ptr<SpriteAnimation> walk(new SpriteAnimation(textureManager, "Walk"));
+	walk->AddFrame("sheet", Seconds(0.1)).texture(sheet).uv1(TextureUV(0.f, 0.f)).uv2(TextureUV(0.5f, 1.f));
+	walk->AddFrame("sheet", Seconds(0.1)).texture(sheet).uv1(TextureUV(0.5f, 0.f)).uv2(TextureUV(1.f, 1.f));
+	walk->AddFrame("small", Seconds(0.1)).texture(small);
+	shared_ptr<SpriteAnimation> run(new SpriteAnimation(textureManager, "Run"));
+	run->AddFrame("large", Seconds(0.1)).texture(large);
+	run->AddFrame("small", Seconds(0.1)).texture(small);
+	run->AddFrame("other", Seconds(0.1)).texture(otherFormat);
+
+	SpriteAtlas atlas(64, 128, 1);
+	atlas.AddAnimation(walk);
+	atlas.AddAnimation(run);
+	CHECK(atlas.Build()==3);
+	REQUIRE(atlas.GetNumberOfPages()==1);
+	shared_ptr<Texture> page = atlas.GetPage(0);
+	CHECK(page->GetWidth()==64);
+	// The shelves use 40 pixels so the page is trimmed to 64.
+	CHECK(page->GetHeight()==64);
+
+	SpriteAtlas::Region sheetRegion;
+	REQUIRE(atlas.GetRegion(*sheet, sheetRegion));
+	CHECK(sheetRegion.mPage==page);
+	CHECK(!atlas.GetRegion(*otherFormat, sheetRegion));
+
+	// Each packed source's pixels are copied into its region along with a border of edge pixels.
+	const Texture* sources[] = {sheet.get(), small.get(), large.get()};
+	Texture::Accessor<u32> pagePixels = page->GetAccessor<u32>();
+	for(const Texture* source : sources)
+	{
+		SpriteAtlas::Region region;
+		REQUIRE(atlas.GetRegion(*source, region));
+		const Size x = static_cast<Size>(region.mUV1.u * 64.f + 0.5f);
+		const Size y = static_cast<Size>(region.mUV1.v * 64.f + 0.5f);
+		const Texture::Accessor<u32> sourcePixels = source->GetAccessor<u32>();
+		bool match = true;
+		for(Size row = 0; row < source->GetHeight(); ++row)
+		{
+			for(Size column = 0; column < source->GetWidth(); ++column)
+			{
+				match = match && pagePixels[(y + row) * 64 + x + column]==sourcePixels[row * source->GetWidth() + column];
+			}
+		}
+		CHECK(match);
+		CHECK(pagePixels[(y - 1) * 64 + x - 1]==sourcePixels[0]);
+		CHECK(pagePixels[(y + source->GetHeight()) * 64 + x + source->GetWidth()]==sourcePixels[source->GetWidth() * source->GetHeight() - 1]);
+	}
+
+	// The frames reference the page and the part of the sheet they used before packing.
+	SpriteBatch batch;
+	Size id = batch.AddSprite();
+	batch.SetAnimation(id, walk);
+	const SpriteBatch::Instance& sprite = batch.GetSprite(id);
+	CHECK(sprite.mTexture==page);
+	CHECK(Near(sprite.mUV1, sheetRegion.mUV1));
+	CHECK(Near(sprite.mUV2, TextureUV((sheetRegion.mUV1.u + sheetRegion.mUV2.u) * 0.5f, sheetRegion.mUV2.v)));
+
+	// Frames from different textures now share a group.
+	Size id2 = batch.AddSprite();
+	batch.SetAnimation(id2, run);
+	batch.Build(Quaternion::IDENTITY);
+	CHECK(batch.GetNumberOfBatches()==1);
+
+	// Nothing new to pack.
+	CHECK(atlas.Build()==0);
+	CHECK(atlas.GetNumberOfPages()==1);
+}
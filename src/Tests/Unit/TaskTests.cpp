@@ -1,5 +1,7 @@
 #include <echo/Kernel/TaskGroup.h>
+#include <echo/Kernel/WorkerPool.h>
 #include <doctest/doctest.h>
+#include <atomic>
 
 void AddRemoveTaskTest()
 {
@@ -115,6 +117,70 @@ void HierarchyTest()
 	CHECK(taskB2.GetUpdateCount()==1);
 }
 
+class ParallelCountingTask : public Echo::Task
+{
+public:
+	ParallelCountingTask(std::atomic<size_t>& counter, Echo::u32 priority) : Echo::Task("ParallelCountingTask", priority), mCounter(counter)
+	{
+		SetParallelSafe(true);
+	}
+private:
+	std::atomic<size_t>& mCounter;
+	void Update(Echo::Seconds lastFrameTime)
+	{
+		++mCounter;
+	}
+};
+
+class CounterCheckTask : public Echo::Task
+{
+public:
+	CounterCheckTask(std::atomic<size_t>& counter, Echo::u32 priority) : Echo::Task("CounterCheckTask", priority), mCounter(counter), mCountAtUpdate(0)
+	{
+	}
+	size_t GetCountAtUpdate() const {return mCountAtUpdate;}
+private:
+	std::atomic<size_t>& mCounter;
+	size_t mCountAtUpdate;
+	void Update(Echo::Seconds lastFrameTime)
+	{
+		mCountAtUpdate = mCounter;
+	}
+};
+
+void ParallelUpdateTasksTest()
+{
+	using namespace Echo;
+	TaskManager manager;
+	manager.SetWorkerPool(make_shared<WorkerPool>(4));
+
+	std::atomic<size_t> firstPhaseCounter(0);
+	std::atomic<size_t> secondPhaseCounter(0);
+	std::vector< shared_ptr<ParallelCountingTask> > tasks;
+	for(size_t i=0; i < 64; ++i)
+	{
+		tasks.push_back(make_shared<ParallelCountingTask>(firstPhaseCounter,10));
+		tasks.push_back(make_shared<ParallelCountingTask>(secondPhaseCounter,30));
+	}
+	for(auto& task : tasks)
+	{
+		manager.AddTask(task);
+	}
+	// The check task isn't parallel safe so all of the first phase tasks need to have completed before it updates.
+	CounterCheckTask checkTask(firstPhaseCounter,20);
+	manager.AddTask(checkTask);
+	manager.StartTasks();
+	manager.UpdateTasks(Seconds(1.0f));
+	CHECK(firstPhaseCounter==64);
+	CHECK(secondPhaseCounter==64);
+	CHECK(checkTask.GetCountAtUpdate()==64);
+	manager.UpdateTasks(Seconds(1.0f));
+	CHECK(firstPhaseCounter==128);
+	CHECK(secondPhaseCounter==128);
+	CHECK(checkTask.GetCountAtUpdate()==128);
+	manager.RemoveAllTasks();
+}
+
 TEST_CASE("Task")
 {
 	// Turn off log output, we will just use output from this test.
@@ -124,4 +190,5 @@ TEST_CASE("Task")
 	AddRemoveMultipleTaskTest();
 	UpdateTasksTest();
 	HierarchyTest();
+	ParallelUpdateTasksTest();
 }
@@ -1,5 +1,21 @@
 #include <echo/Graphics/Texture.h>
+#include <echo/Graphics/TextureProcessor.h>
+#include <echo/Graphics/Scene.h>
+#include <echo/Graphics/Camera.h>
+#include <echo/Graphics/SceneEntity.h>
+#include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/Material.h>
+#include <echo/Platform.h>
+#include <echo/FileSystem/FileSystem.h>
+#include <echo/Resource/TextureManager.h>
+#include <echo/Resource/BitmapLoader.h>
+#include <echo/Resource/TextureResidencyManager.h>
+#include <echo/Kernel/WorkerPool.h>
 #include <doctest/doctest.h>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#undef INFO
 
 using namespace Echo;
 
@@ -62,4 +78,537 @@ namespace TextureTest
 		CHECK(clonedTexture->GetHeight()==height);
 		CHECK(clonedTexture->GetFormat()==Texture::Formats::UNKNOWN);
 	}
-}
\ No newline at end of file
+
+	void WriteBitmap(FileSystem& fileSystem, const std::string& fileName, u32 width, u32 height, u8 value)
+	{
+		// 32 bit BI_RGB bitmap with every channel set to value.
+		const u32 headerSize = 54;
+		const u32 dataSize = width * height * 4;
+		File file = fileSystem.Open(fileName, File::OpenModes::WRITE);
+		REQUIRE(file.IsOpen());
+		file.SetEndianMode(File::EndianModes::LITTLE);
+		file.SetEndianConversionEnabled(true);
+		file.Write("BM");
+		file.Write(u32(headerSize + dataSize));
+		file.Write(u32(0));
+		file.Write(headerSize);
+		file.Write(u32(40));
+		file.Write(width);
+		file.Write(height);
+		file.Write(u16(1));
+		file.Write(u16(32));
+		file.Write(u32(0));
+		file.Write(dataSize);
+		file.Write(u32(0));
+		file.Write(u32(0));
+		file.Write(u32(0));
+		file.Write(u32(0));
+		std::vector<u8> data(dataSize, value);
+		file.Write(data.data(), data.size());
+	}
+
+	TEST_CASE("TextureManagerAsyncLoad")
+	{
+		gDefaultLogger.SetLogMask(Echo::Logger::LogLevels::NONE);
+		shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("");
+		REQUIRE(fileSystem);
+		const u32 numberOfTextures = 32;
+		{
+			std::stringstream list;
+			for(u32 i = 0; i < numberOfTextures; ++i)
+			{
+				std::stringstream fileName;
+				fileName << "AsyncTexture" << i << ".bmp";
+				WriteBitmap(*fileSystem, fileName.str(), 16, 8, static_cast<u8>(i * 4));
+				list << "texture=" << fileName.str() << ",Texture" << i << "\n";
+			}
+			File listFile = fileSystem->Open("AsyncTextures.list", File::OpenModes::WRITE);
+			REQUIRE(listFile.IsOpen());
+			listFile.Write(list.str());
+		}
+
+		{
+			TextureManager textureManager(*fileSystem);
+			REQUIRE(textureManager.RegisterLoader(make_shared<BitmapLoader>()));
+			textureManager.SetWorkerPool(make_shared<WorkerPool>(2), true);
+
+			// Prefetching starts loading everything in the list.
+			REQUIRE(textureManager.LoadList(fileSystem->Open("AsyncTextures.list")));
+			CHECK(textureManager.ResourceExists("Texture0"));
+
+			// Requests for a resource that is loading share the load.
+			TextureManager::AsyncResource first = textureManager.GetResourceAsync("Texture3");
+			TextureManager::AsyncResource second = textureManager.GetResourceAsync("Texture3");
+			shared_ptr<Texture> texture = first.Get();
+			REQUIRE(texture);
+			CHECK(first.IsReady());
+			CHECK(second.Get()==texture);
+			CHECK(textureManager.GetResource("Texture3")==texture);
+			CHECK(texture->GetName()=="Texture3");
+
+			textureManager.WaitForAsyncLoads();
+			CHECK(textureManager.UpdateAsyncLoads()==0);
+			for(u32 i = 0; i < numberOfTextures; ++i)
+			{
+				std::stringstream name;
+				name << "Texture" << i;
+				REQUIRE(textureManager.IsResourceLoaded(name.str()));
+				shared_ptr<Texture> loaded = textureManager.GetResource(name.str());
+				REQUIRE(loaded);
+				CHECK(loaded->GetWidth()==16);
+				CHECK(loaded->GetHeight()==8);
+				CHECK(loaded->GetFormat()==Texture::Formats::R8G8B8A8);
+				const u8* pixels = loaded->GetBuffer().get();
+				CHECK(pixels[0]==static_cast<u8>(i * 4));
+				CHECK(pixels[loaded->GetDataSize() - 2]==static_cast<u8>(i * 4));
+			}
+
+			// Files are added by their resolved name like GetResource().
+			TextureManager::AsyncResource byFile = textureManager.GetResourceAsync("AsyncTexture5.bmp");
+			shared_ptr<Texture> fileTexture = byFile.Get();
+			REQUIRE(fileTexture);
+			CHECK(fileTexture->GetWidth()==16);
+			CHECK(textureManager.ResourceExists(byFile.GetName()));
+
+			// Missing resources give the error texture straight away.
+			TextureManager::AsyncResource missing = textureManager.GetResourceAsync("NotATexture");
+			CHECK(missing.IsReady());
+			REQUIRE(missing.Get());
+			CHECK(missing.Get()->GetWidth()==8);
+
+			// Loads that have not finished when the manager is destroyed are waited for.
+			textureManager.RemoveResource("Texture7");
+			textureManager.AddResource("Texture7", "AsyncTexture7.bmp");
+			textureManager.GetResourceAsync("Texture7");
+		}
+
+		for(u32 i = 0; i < numberOfTextures; ++i)
+		{
+			std::stringstream fileName;
+			fileName << "AsyncTexture" << i << ".bmp";
+			CHECK(fileSystem->DeleteFile(fileName.str()));
+		}
+		CHECK(fileSystem->DeleteFile("AsyncTextures.list"));
+	}
+
+	shared_ptr<Texture> CreateTestPattern(u32 width, u32 height, Texture::Format format = Texture::Formats::R8G8B8A8)
+	{
+		shared_ptr<Texture> texture(new Texture(width, height, Texture::Formats::R8G8B8A8));
+		u8* pixels = texture->GetBuffer().get();
+		for(u32 i = 0; i < width * height; ++i)
+		{
+			pixels[i * 4] = static_cast<u8>(i * 7);
+			pixels[i * 4 + 1] = static_cast<u8>(i * 13 + 5);
+			pixels[i * 4 + 2] = static_cast<u8>(255 - i * 3);
+			pixels[i * 4 + 3] = (i % 3==0) ? 255 : 0;
+		}
+		if(format==Texture::Formats::R8G8B8A8)
+		{
+			return texture;
+		}
+		return TextureProcessor().Convert(*texture, format);
+	}
+
+	bool BuffersMatch(const Texture& a, const Texture& b, int tolerance)
+	{
+		if(a.GetWidth()!=b.GetWidth() || a.GetHeight()!=b.GetHeight() || a.GetFormat()!=b.GetFormat())
+		{
+			return false;
+		}
+		const u8* pa = a.GetBuffer().get();
+		const u8* pb = b.GetBuffer().get();
+		for(Size i = 0; i < a.GetDataSize(); ++i)
+		{
+			if(std::abs(static_cast<int>(pa[i]) - static_cast<int>(pb[i])) > tolerance)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	TEST_CASE("TextureSubTexture")
+	{
+		shared_ptr<Texture> texture = CreateTestPattern(16, 8);
+		shared_ptr<Texture> sub = texture->GetSubTexture(Vector2Generic<Size>(10, 6), Vector2Generic<Size>(3, 2));
+		REQUIRE(sub);
+		CHECK(sub->GetWidth()==8);
+		CHECK(sub->GetHeight()==5);
+		for(u32 y = 0; y < 5; ++y)
+		{
+			CHECK(std::memcmp(sub->GetBuffer().get() + y * 8 * 4, texture->GetBuffer().get() + ((y + 2) * 16 + 3) * 4, 8 * 4)==0);
+		}
+	}
+
+	TEST_CASE("TextureProcessorConvert")
+	{
+		const Texture::Format formats[] = {
+			Texture::Formats::R8G8B8X8, Texture::Formats::R8G8B8A8, Texture::Formats::R8G8B8, Texture::Formats::R5G6B5,
+			Texture::Formats::R5G5B5A1, Texture::Formats::R4G4B4A4, Texture::Formats::LUMINANCE8, Texture::Formats::LUMINANCE8_ALPHA8,
+			Texture::Formats::RGB_F32, Texture::Formats::RGBA_F32, Texture::Formats::LUMINANCE32, Texture::Formats::LUMINANCE32_ALPHA32,
+			Texture::Formats::B8G8R8, Texture::Formats::B8G8R8A8, Texture::Formats::GREYSCALE8, Texture::Formats::GREYSCALE16,
+			Texture::Formats::R10G10B10X2, Texture::Formats::R10G10B10A2};
+
+		TextureProcessor processor(make_shared<WorkerPool>(2), 4);
+		shared_ptr<Texture> source = CreateTestPattern(37, 19);
+		shared_ptr<Texture> opaque = processor.Convert(*source, Texture::Formats::R8G8B8X8);
+		REQUIRE(opaque);
+
+		SUBCASE("RoundTrip")
+		{
+			for(Texture::Format format : formats)
+			{
+				shared_ptr<Texture> converted = processor.Convert(*source, format);
+				REQUIRE(converted);
+				CHECK(converted->GetFormat()==format);
+				shared_ptr<Texture> back = processor.Convert(*converted, Texture::Formats::R8G8B8A8);
+				REQUIRE(back);
+
+				// Compare against the source with the channels the format can't hold removed.
+				const bool luminance = (Texture::Formats::GetNumberOfChannels(format) <= 2);
+				shared_ptr<Texture> expected = source;
+				if(luminance)
+				{
+					expected = processor.Convert(*processor.Convert(*source, Texture::Formats::LUMINANCE8_ALPHA8), Texture::Formats::R8G8B8A8);
+				}
+				if(!Texture::Formats::HasAlpha(format))
+				{
+					expected = processor.Convert(*processor.Convert(*expected, Texture::Formats::R8G8B8X8), Texture::Formats::R8G8B8A8);
+				}
+				int tolerance = 0;
+				switch(format)
+				{
+					case Texture::Formats::R5G6B5:
+					case Texture::Formats::R5G5B5A1:	tolerance = 5; break;
+					case Texture::Formats::R4G4B4A4:	tolerance = 9; break;
+					default:							tolerance = luminance ? 1 : 0; break;
+				}
+				CHECK_MESSAGE(BuffersMatch(*back, *expected, tolerance), "Format " << format);
+			}
+		}
+
+		SUBCASE("DirectMatchesGeneric")
+		{
+			// The 8 bit conversions don't go through float, the result should be the same as if they did.
+			const Texture::Format eightBit[] = {Texture::Formats::R8G8B8A8, Texture::Formats::R8G8B8X8, Texture::Formats::B8G8R8A8,
+												Texture::Formats::R8G8B8, Texture::Formats::B8G8R8};
+			shared_ptr<Texture> floats = processor.Convert(*source, Texture::Formats::RGBA_F32);
+			for(Texture::Format from : eightBit)
+			{
+				shared_ptr<Texture> input = processor.Convert(*floats, from);
+				for(Texture::Format to : eightBit)
+				{
+					shared_ptr<Texture> direct = processor.Convert(*input, to);
+					shared_ptr<Texture> generic = processor.Convert(*processor.Convert(*input, Texture::Formats::RGBA_F32), to);
+					CHECK_MESSAGE(BuffersMatch(*direct, *generic, 0), "From " << from << " to " << to);
+				}
+			}
+		}
+
+		SUBCASE("PackedLayout")
+		{
+			Texture red(1, 1, Texture::Formats::R8G8B8A8);
+			const u8 pixel[4] = {255, 0, 0, 255};
+			std::memcpy(red.GetBuffer().get(), pixel, 4);
+			u16 packed = 0;
+			REQUIRE(TextureProcessor::ConvertPixels(red.GetBuffer().get(), Texture::Formats::R8G8B8A8, reinterpret_cast<u8*>(&packed), Texture::Formats::R5G6B5, 1));
+			CHECK(packed==0xF800);
+			REQUIRE(TextureProcessor::ConvertPixels(red.GetBuffer().get(), Texture::Formats::R8G8B8A8, reinterpret_cast<u8*>(&packed), Texture::Formats::R4G4B4A4, 1));
+			CHECK(packed==0xF00F);
+			u32 packed32 = 0;
+			REQUIRE(TextureProcessor::ConvertPixels(red.GetBuffer().get(), Texture::Formats::R8G8B8A8, reinterpret_cast<u8*>(&packed32), Texture::Formats::R10G10B10A2, 1));
+			CHECK(packed32==0xFFC00003);
+		}
+
+		SUBCASE("Unsupported")
+		{
+			Texture depth(4, 4, Texture::Formats::DEPTH16);
+			CHECK(!processor.Convert(depth, Texture::Formats::R8G8B8A8));
+			CHECK(!processor.Convert(*source, Texture::Formats::DEPTH24));
+		}
+	}
+
+	TEST_CASE("TextureProcessorMipmaps")
+	{
+		gDefaultLogger.SetLogMask(Echo::Logger::LogLevels::NONE);
+		CHECK(TextureProcessor::GetNumberOfMipmapLevels(1, 1)==1);
+		CHECK(TextureProcessor::GetNumberOfMipmapLevels(256, 64)==9);
+		CHECK(TextureProcessor::GetNumberOfMipmapLevels(5, 3)==3);
+
+		// Black and white checkerboard.
+		shared_ptr<Texture> checker(new Texture(64, 32, Texture::Formats::R8G8B8A8));
+		u8* pixels = checker->GetBuffer().get();
+		for(u32 y = 0; y < 32; ++y)
+		{
+			for(u32 x = 0; x < 64; ++x)
+			{
+				const u8 value = ((x + y) % 2) ? 255 : 0;
+				std::memset(pixels + (y * 64 + x) * 4, value, 4);
+			}
+		}
+
+		TextureProcessor serial;
+		TextureProcessor parallel(make_shared<WorkerPool>(3), 2);
+
+		SUBCASE("Box")
+		{
+			std::vector< shared_ptr<Texture> > levels = parallel.GenerateMipmaps(*checker, TextureProcessor::Filters::BOX);
+			REQUIRE(levels.size()==6);
+			CHECK(levels[0]->GetWidth()==32);
+			CHECK(levels[0]->GetHeight()==16);
+			CHECK(levels[5]->GetWidth()==1);
+			CHECK(levels[5]->GetHeight()==1);
+			for(shared_ptr<Texture>& level : levels)
+			{
+				CHECK(level->GetFormat()==Texture::Formats::R8G8B8A8);
+				CHECK(level->GetBuffer().get()[0]==128);
+				CHECK(level->GetBuffer().get()[level->GetDataSize() - 1]==128);
+			}
+			CHECK(parallel.GenerateMipmaps(*checker, TextureProcessor::Filters::BOX, false, 2).size()==2);
+
+			// Formats without a fast path go through the float path.
+			shared_ptr<Texture> floats = serial.Convert(*checker, Texture::Formats::RGBA_F32);
+			std::vector< shared_ptr<Texture> > floatLevels = serial.GenerateMipmaps(*floats, TextureProcessor::Filters::BOX);
+			REQUIRE(floatLevels.size()==6);
+			CHECK(reinterpret_cast<const f32*>(floatLevels[0]->GetBuffer().get())[0]==0.5f);
+		}
+
+		SUBCASE("SRGB")
+		{
+			// Linear 0.5 is 188 in sRGB. The colour is averaged in linear space, alpha isn't.
+			std::vector< shared_ptr<Texture> > levels = serial.GenerateMipmaps(*checker, TextureProcessor::Filters::BOX, true, 1);
+			REQUIRE(levels.size()==1);
+			const u8* level = levels[0]->GetBuffer().get();
+			CHECK(level[0]==188);
+			CHECK(level[1]==188);
+			CHECK(level[2]==188);
+			CHECK(level[3]==128);
+
+			shared_ptr<Texture> bgr = serial.Convert(*checker, Texture::Formats::B8G8R8);
+			levels = serial.GenerateMipmaps(*bgr, TextureProcessor::Filters::BOX, true, 1);
+			REQUIRE(levels.size()==1);
+			CHECK(levels[0]->GetBuffer().get()[0]==188);
+		}
+
+		SUBCASE("Filtered")
+		{
+			const TextureProcessor::Filter filters[] = {TextureProcessor::Filters::TRIANGLE, TextureProcessor::Filters::KAISER};
+			for(TextureProcessor::Filter filter : filters)
+			{
+				std::vector< shared_ptr<Texture> > levels = parallel.GenerateMipmaps(*checker, filter);
+				std::vector< shared_ptr<Texture> > serialLevels = serial.GenerateMipmaps(*checker, filter);
+				REQUIRE(levels.size()==6);
+				REQUIRE(serialLevels.size()==6);
+				for(Size l = 0; l < levels.size(); ++l)
+				{
+					CHECK(BuffersMatch(*levels[l], *serialLevels[l], 0));
+					// The filters are normalised so the average is preserved.
+					const u8 centre = levels[l]->GetBuffer().get()[(levels[l]->GetHeight() / 2 * levels[l]->GetWidth() + levels[l]->GetWidth() / 2) * 4];
+					CHECK(std::abs(static_cast<int>(centre) - 128) <= 1);
+				}
+			}
+		}
+
+		SUBCASE("Resize")
+		{
+			shared_ptr<Texture> pattern = CreateTestPattern(37, 19, Texture::Formats::R5G6B5);
+			shared_ptr<Texture> odd = parallel.Resize(*pattern, 5, 3, TextureProcessor::Filters::BOX);
+			REQUIRE(odd);
+			CHECK(odd->GetWidth()==5);
+			CHECK(odd->GetHeight()==3);
+			CHECK(odd->GetFormat()==Texture::Formats::R5G6B5);
+			CHECK(BuffersMatch(*odd, *serial.Resize(*pattern, 5, 3, TextureProcessor::Filters::BOX), 0));
+
+			// Enlarging a constant colour keeps the colour.
+			shared_ptr<Texture> constant(new Texture(3, 2, Texture::Formats::R8G8B8A8));
+			std::memset(constant->GetBuffer().get(), 77, constant->GetDataSize());
+			const TextureProcessor::Filter filters[] = {TextureProcessor::Filters::BOX, TextureProcessor::Filters::TRIANGLE, TextureProcessor::Filters::KAISER};
+			for(TextureProcessor::Filter filter : filters)
+			{
+				shared_ptr<Texture> large = parallel.Resize(*constant, 40, 21, filter, true);
+				REQUIRE(large);
+				shared_ptr<Texture> expected(new Texture(40, 21, Texture::Formats::R8G8B8A8));
+				std::memset(expected->GetBuffer().get(), 77, expected->GetDataSize());
+				CHECK_MESSAGE(BuffersMatch(*large, *expected, 1), "Filter " << filter);
+			}
+			CHECK(!parallel.Resize(*constant, 0, 4));
+		}
+	}
+
+	TEST_CASE("TextureResidencyManager")
+	{
+		gDefaultLogger.SetLogMask(Echo::Logger::LogLevels::NONE);
+		shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("");
+		REQUIRE(fileSystem);
+		const u32 numberOfTextures = 4;
+		const Size fullBytes = 64 * 64 * 4;
+		for(u32 i = 0; i < numberOfTextures; ++i)
+		{
+			std::stringstream fileName;
+			fileName << "ResidencyTexture" << i << ".bmp";
+			WriteBitmap(*fileSystem, fileName.str(), 64, 64, static_cast<u8>(40 + i * 40));
+		}
+
+		shared_ptr<WorkerPool> workerPools[] = {shared_ptr<WorkerPool>(), make_shared<WorkerPool>(2)};
+		for(shared_ptr<WorkerPool>& workerPool : workerPools)
+		{
+			TextureManager textureManager(*fileSystem);
+			REQUIRE(textureManager.RegisterLoader(make_shared<BitmapLoader>()));
+			std::vector< shared_ptr<Texture> > textures;
+			for(u32 i = 0; i < numberOfTextures; ++i)
+			{
+				std::stringstream name;
+				std::stringstream fileName;
+				name << "Tile" << i;
+				fileName << "ResidencyTexture" << i << ".bmp";
+				textureManager.AddResource(name.str(), fileName.str());
+				textures.push_back(textureManager.GetResource(name.str()));
+				REQUIRE(textures.back());
+				REQUIRE(textures.back()->GetWidth()==64);
+			}
+
+			TextureResidencyManager residency(textureManager, fullBytes * numberOfTextures, workerPool);
+			residency.SetMinimumSize(8);
+			residency.SetUnusedFrames(2);
+			for(shared_ptr<Texture>& texture : textures)
+			{
+				CHECK(residency.AddTexture(texture));
+			}
+			CHECK(!residency.AddTexture(textures[0]));
+			CHECK(!residency.AddTexture(make_shared<Texture>(64, 64, Texture::Formats::R8G8B8A8)));
+
+			auto frame = [&](f32 s0, f32 s1, f32 s2, f32 s3)
+			{
+				const f32 sizes[] = {s0, s1, s2, s3};
+				for(u32 i = 0; i < numberOfTextures; ++i)
+				{
+					if(sizes[i] > 0.f)
+					{
+						residency.TextureUsed(*textures[i], sizes[i]);
+					}
+				}
+				residency.Update();
+				residency.WaitForPendingLoads();
+			};
+
+			// Everything fits at the size it is shown.
+			frame(64.f, 64.f, 64.f, 64.f);
+			TextureResidencyManager::Statistics statistics = residency.GetStatistics();
+			CHECK(statistics.mTrackedTextures==numberOfTextures);
+			CHECK(statistics.mResidentBytes==fullBytes * numberOfTextures);
+			CHECK(statistics.mFullResolutionBytes==fullBytes * numberOfTextures);
+			CHECK(statistics.mPendingLoads==0);
+			CHECK(residency.GetResidentLevel(*textures[0])==0);
+
+			// Textures that are small on screen are reduced.
+			Size version = textures[0]->GetVersion();
+			frame(16.f, 64.f, 64.f, 64.f);
+			CHECK(residency.GetResidentLevel(*textures[0])==2);
+			CHECK(textures[0]->GetWidth()==16);
+			CHECK(textures[0]->GetHeight()==16);
+			CHECK(textures[0]->GetVersion()!=version);
+			CHECK(textures[0]->IsLoaded());
+			CHECK(textures[0]->GetBuffer().get()[0]==40);
+			statistics = residency.GetStatistics();
+			CHECK(statistics.mReductions==1);
+			CHECK(statistics.mEvictions==0);
+			CHECK(statistics.mResidentBytes==fullBytes * 3 + fullBytes / 16);
+
+			// And restored from the file when they get larger.
+			frame(64.f, 64.f, 64.f, 64.f);
+			CHECK(residency.GetResidentLevel(*textures[0])==0);
+			CHECK(textures[0]->GetWidth()==64);
+			CHECK(textures[0]->GetBuffer().get()[0]==40);
+			CHECK(textures[0]->GetName()=="Tile0");
+			CHECK(residency.GetStatistics().mRestorations==1);
+
+			// Over budget the least important textures are reduced further until everything fits.
+			residency.SetBudget(fullBytes * numberOfTextures / 2);
+			frame(10.f, 20.f, 40.f, 64.f);
+			CHECK(residency.GetResidentLevel(*textures[0])==3);
+			CHECK(residency.GetResidentLevel(*textures[1])==2);
+			CHECK(residency.GetResidentLevel(*textures[2])==1);
+			CHECK(residency.GetResidentLevel(*textures[3])==0);
+			CHECK(textures[2]->GetWidth()==32);
+			CHECK(textures[2]->GetBuffer().get()[0]==120);
+			statistics = residency.GetStatistics();
+			CHECK(statistics.mEvictions==3);
+			CHECK(statistics.mResidentBytes<=statistics.mBudget);
+			CHECK(statistics.mBudget==fullBytes * numberOfTextures / 2);
+
+			// Unused textures drop to the minimum size, freeing memory for the others.
+			for(u32 f = 0; f < 4; ++f)
+			{
+				frame(10.f, 20.f, 40.f, 0.f);
+			}
+			CHECK(residency.GetResidentLevel(*textures[3])==3);
+			CHECK(textures[3]->GetWidth()==8);
+			CHECK(residency.GetResidentLevel(*textures[0])==2);
+			CHECK(residency.GetResidentLevel(*textures[1])==1);
+			CHECK(residency.GetResidentLevel(*textures[2])==0);
+			CHECK(residency.GetStatistics().mResidentBytes<=residency.GetStatistics().mBudget);
+
+			// A texture reloaded elsewhere is treated as full resolution again.
+			REQUIRE(textures[3]->Reload());
+			CHECK(textures[3]->GetWidth()==64);
+			frame(10.f, 20.f, 40.f, 64.f);
+			CHECK(residency.GetResidentLevel(*textures[3])==0);
+			CHECK(textures[3]->GetWidth()==64);
+
+			CHECK(residency.RemoveTexture(*textures[3]));
+			CHECK(!residency.RemoveTexture(*textures[3]));
+			CHECK(residency.GetStatistics().mTrackedTextures==numberOfTextures - 1);
+		}
+
+		SUBCASE("Scene")
+		{
+			TextureManager textureManager(*fileSystem);
+			REQUIRE(textureManager.RegisterLoader(make_shared<BitmapLoader>()));
+			textureManager.AddResource("Tile", "ResidencyTexture0.bmp");
+			shared_ptr<Texture> texture = textureManager.GetResource("Tile");
+			REQUIRE(texture);
+
+			Scene scene;
+			shared_ptr<Camera> camera = scene.CreateCamera("Camera");
+			camera->SetPosition(0.f, 0.f, 0.f);
+			camera->SetFOVy(Radian(Maths::PI / 2.f));
+
+			// With a 90 degree field of view the visible height at a distance d is 2d.
+			const f32 radius = Vector3(1.f, 1.f, 1.f).Length();
+			AxisAlignedBox box(Vector3(-1.f, -1.f, -101.f), Vector3(1.f, 1.f, -99.f));
+			CHECK(std::abs(TextureResidencyManager::CalculateScreenSize(box, *camera, 600) - radius * 6.f) < 0.01f);
+			CHECK(TextureResidencyManager::CalculateScreenSize(AxisAlignedBox(), *camera, 600)==0.f);
+			CHECK(TextureResidencyManager::CalculateScreenSize(AxisAlignedBox(Vector3(-1.f, -1.f, -1.f), Vector3(1.f, 1.f, 1.f)), *camera, 600)==600.f);
+			camera->SetProjectionType(ProjectionTypes::ORTHOGRAPHIC);
+			camera->SetOrthoWindowHeight(20.f);
+			CHECK(std::abs(TextureResidencyManager::CalculateScreenSize(box, *camera, 600) - radius * 60.f) < 0.01f);
+			camera->SetProjectionType(ProjectionTypes::PERSPECTIVE);
+
+			// A distant entity only needs a small level.
+			shared_ptr<Mesh> mesh(new Mesh());
+			mesh->CreateQuadSubMesh(2.f);
+			shared_ptr<Material> material(new Material());
+			material->SetTexture(texture);
+			mesh->SetMaterial(material);
+			SceneEntity entity;
+			entity.SetMesh(mesh);
+			entity.SetPosition(0.f, 0.f, -100.f);
+
+			TextureResidencyManager residency(textureManager, fullBytes);
+			residency.SetMinimumSize(4);
+			REQUIRE(residency.AddTexture(texture));
+			residency.RenderableUsed(entity, *camera, 600);
+			residency.Update();
+			// The quad spans about 8.5 pixels.
+			CHECK(residency.GetResidentLevel(*texture)==2);
+			CHECK(texture->GetWidth()==16);
+		}
+
+		for(u32 i = 0; i < numberOfTextures; ++i)
+		{
+			std::stringstream fileName;
+			fileName << "ResidencyTexture" << i << ".bmp";
+			CHECK(fileSystem->DeleteFile(fileName.str()));
+		}
+	}
+}
@@ -0,0 +1,195 @@
+#include <echo/Graphics/TransformHierarchy.h>
+#include <echo/Graphics/Node.h>
+#include <echo/Kernel/WorkerPool.h>
+#include <doctest/doctest.h>
+#include <atomic>
+#include <cmath>
+#include <random>
+#undef INFO
+
+using namespace Echo;
+
+namespace
+{
+	/**
+	 * Creates two identical random trees, one to be added to a hierarchy and one to compare against.
+	 */
+	void CreateTrees(std::vector< shared_ptr<Node> >& a, std::vector< shared_ptr<Node> >& b, Size numberOfNodes)
+	{
+		std::mt19937 generator(7);
+		std::uniform_real_distribution<f32> value(-1.f, 1.f);
+		std::uniform_real_distribution<f32> scale(0.5f, 1.5f);
+		for(Size i=0; i < numberOfNodes; ++i)
+		{
+			Vector3 position(value(generator), value(generator), value(generator));
+			Quaternion orientation(Radian(value(generator) * 3.f), Vector3(value(generator), value(generator), 1.f).NormalisedCopy());
+			Vector3 s(scale(generator), scale(generator), scale(generator));
+			bool inheritScale = (i % 5)!=0;
+			a.push_back(make_shared<Node>(position, orientation, s));
+			b.push_back(make_shared<Node>(position, orientation, s));
+			a.back()->SetInheritScale(inheritScale);
+			b.back()->SetInheritScale(inheritScale);
+			if(i > 0)
+			{
+				// Bias towards recent nodes so the trees are reasonably deep.
+				Size parent = i - 1 - std::uniform_int_distribution<Size>(0, std::min<Size>(i - 1, 3))(generator);
+				a[parent]->AddChild(*a.back());
+				b[parent]->AddChild(*b.back());
+			}
+		}
+	}
+
+	bool Near(const Vector3& a, const Vector3& b)
+	{
+		return (a - b).Length() < 0.001f;
+	}
+
+	bool Near(const Quaternion& a, const Quaternion& b)
+	{
+		// Quaternion::Equals() can fail for equal quaternions when the dot product rounds to just over 1.
+		return std::abs(a.Dot(b)) > 0.9999f;
+	}
+
+	bool Matches(const std::vector< shared_ptr<Node> >& a, const std::vector< shared_ptr<Node> >& b)
+	{
+		for(Size i=0; i < a.size(); ++i)
+		{
+			if(!Near(a[i]->GetDerivedPosition(), b[i]->GetDerivedPosition()) ||
+				!Near(a[i]->GetDerivedScale(), b[i]->GetDerivedScale()) ||
+				!Near(a[i]->GetDerivedOrientation(), b[i]->GetDerivedOrientation()) ||
+				!Near(a[i]->GetTransform() * Vector3::UNIT_SCALE, b[i]->GetTransform() * Vector3::UNIT_SCALE))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST_CASE("TransformHierarchy")
+{
+	const Size NUMBER_OF_NODES = 500;
+	std::vector< shared_ptr<Node> > nodes;
+	std::vector< shared_ptr<Node> > reference;
+	CreateTrees(nodes, reference, NUMBER_OF_NODES);
+
+	SUBCASE("Matches Node")
+	{
+		TransformHierarchy hierarchy;
+		hierarchy.AddRoot(*nodes[0]);
+		REQUIRE(hierarchy.GetNumberOfNodes()==NUMBER_OF_NODES);
+		CHECK(hierarchy.GetNumberOfLevels() > 10);
+		CHECK(nodes[10]->GetTransformHierarchy()==&hierarchy);
+		CHECK(Matches(nodes, reference));
+
+		// Modify some nodes part way down the tree.
+		for(Size i=3; i < NUMBER_OF_NODES; i+=37)
+		{
+			nodes[i]->Translate(Vector3(1.f, 2.f, 3.f));
+			nodes[i]->Yaw(Radian(0.5f));
+			reference[i]->Translate(Vector3(1.f, 2.f, 3.f));
+			reference[i]->Yaw(Radian(0.5f));
+		}
+		nodes[20]->SetInheritOrientation(false);
+		reference[20]->SetInheritOrientation(false);
+		reference[20]->Translate(Vector3::ZERO);		// Node doesn't update when inheritance changes.
+		hierarchy.Update();
+		CHECK(Matches(nodes, reference));
+	}
+
+	SUBCASE("Parallel update")
+	{
+		shared_ptr<WorkerPool> workerPool(new WorkerPool(3));
+		TransformHierarchy hierarchy(workerPool, 4);
+		hierarchy.AddRoot(*nodes[0]);
+		hierarchy.Update();
+		CHECK(Matches(nodes, reference));
+		nodes[0]->SetPosition(Vector3(10.f, 0.f, 0.f));
+		reference[0]->SetPosition(Vector3(10.f, 0.f, 0.f));
+		hierarchy.Update();
+		CHECK(Matches(nodes, reference));
+	}
+
+	SUBCASE("Modified while updating")
+	{
+		TransformHierarchy hierarchy;
+		hierarchy.AddRoot(*nodes[0]);
+		hierarchy.Update();
+
+		// Update continuously on a worker while nodes are modified on this thread.
+		WorkerPool workerPool(1);
+		WorkerPool::Counter counter;
+		std::atomic<bool> done(false);
+		workerPool.Schedule([&hierarchy, &done]()
+		{
+			while(!done.load())
+			{
+				hierarchy.Update();
+			}
+		}, counter);
+		for(Size i=1; i < NUMBER_OF_NODES; i+=7)
+		{
+			nodes[i]->Translate(Vector3(1.f, 2.f, 3.f));
+			reference[i]->Translate(Vector3(1.f, 2.f, 3.f));
+		}
+		done.store(true);
+		workerPool.Wait(counter);
+		hierarchy.Update();
+		CHECK(Matches(nodes, reference));
+	}
+
+	SUBCASE("Structural changes")
+	{
+		TransformHierarchy hierarchy;
+		hierarchy.AddRoot(*nodes[0]);
+		REQUIRE(Matches(nodes, reference));
+
+		// Move a subtree to a different parent.
+		nodes[100]->GetParent()->RemoveChild(*nodes[100]);
+		reference[100]->GetParent()->RemoveChild(*reference[100]);
+		CHECK(nodes[100]->GetTransformHierarchy()==nullptr);
+		CHECK(hierarchy.GetNumberOfNodes() < NUMBER_OF_NODES);
+		CHECK(Matches(nodes, reference));
+		nodes[5]->AddChild(*nodes[100]);
+		reference[5]->AddChild(*reference[100]);
+		CHECK(nodes[100]->GetTransformHierarchy()==&hierarchy);
+		CHECK(hierarchy.GetNumberOfNodes()==NUMBER_OF_NODES);
+		CHECK(Matches(nodes, reference));
+
+		// A new node added below a node in the hierarchy.
+		Node extra(Vector3(1.f, 1.f, 1.f));
+		Node extraReference(Vector3(1.f, 1.f, 1.f));
+		nodes[50]->AddChild(extra);
+		reference[50]->AddChild(extraReference);
+		CHECK(hierarchy.GetNumberOfNodes()==NUMBER_OF_NODES + 1);
+		CHECK(Near(extra.GetDerivedPosition(), extraReference.GetDerivedPosition()));
+
+		// Removing the root returns the nodes to calculating their own properties.
+		CHECK(hierarchy.RemoveRoot(*nodes[0]));
+		CHECK(hierarchy.GetNumberOfNodes()==0);
+		CHECK(nodes[10]->GetTransformHierarchy()==nullptr);
+		nodes[0]->SetScale(Vector3(2.f, 2.f, 2.f));
+		reference[0]->SetScale(Vector3(2.f, 2.f, 2.f));
+		CHECK(Matches(nodes, reference));
+	}
+
+	SUBCASE("Destruction")
+	{
+		{
+			TransformHierarchy hierarchy;
+			hierarchy.AddRoot(*nodes[0]);
+			hierarchy.Update();
+		}
+		CHECK(nodes[0]->GetTransformHierarchy()==nullptr);
+		CHECK(Matches(nodes, reference));
+
+		TransformHierarchy hierarchy;
+		hierarchy.AddRoot(*nodes[0]);
+		// Destroying nodes removes them from the hierarchy.
+		for(Size i=NUMBER_OF_NODES-1; i > 0; --i)
+		{
+			nodes[i].reset();
+		}
+		CHECK(hierarchy.GetNumberOfNodes()==1);
+	}
+}
@@ -1,6 +1,7 @@
 #include <echo/Graphics/VertexBuffer.h>
 #include <echo/Maths/Vector3.h>
 #include <echo/Graphics/PrimitiveTypes.h>
+#include <echo/Graphics/Colour.h>
 
 #include <doctest/doctest.h>
 
@@ -116,6 +117,48 @@ void AccessorTests()
 	CHECK(numberOfIncorrectValues==0);
 }
 
+void LayoutTests()
+{
+	using namespace Echo;
+
+	VertexBuffer a(VertexBuffer::Types::STATIC);
+	a.AddVertexAttribute("Position", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR3));
+	a.AddVertexAttribute("Colour", VertexAttribute(VertexAttribute::ComponentTypes::COLOUR_8));
+	a.AddVertexAttribute("UV1", VertexAttribute(VertexAttribute::ComponentTypes::TEXTUREUV));
+
+	shared_ptr<const VertexLayout> layout = a.GetLayout();
+	REQUIRE(layout);
+	CHECK(layout->GetStride()==a.GetStride());
+	CHECK(layout->GetPositionSlot().mIndex==0);
+	CHECK(layout->GetPositionSlot().mOffset==0);
+	CHECK(layout->GetColourSlot().mIndex==1);
+	CHECK(layout->GetColourSlot().mOffset==sizeof(Vector3));
+	CHECK(!layout->GetNormalSlot().IsValid());
+	CHECK(!layout->GetTextureCoordinateSlot(0).IsValid());
+	CHECK(layout->GetTextureCoordinateSlot(1).mIndex==2);
+	CHECK(layout->GetTextureCoordinateSlot(1).mOffset==sizeof(Vector3)+sizeof(VertexColour));
+	CHECK(!layout->GetTextureCoordinateSlot(5).IsValid());
+
+	// Buffers with the same attributes share a layout.
+	VertexBuffer b(VertexBuffer::Types::DYNAMIC);
+	b.AddVertexAttribute("Position", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR3));
+	b.AddVertexAttribute("Colour", VertexAttribute(VertexAttribute::ComponentTypes::COLOUR_8));
+	b.AddVertexAttribute("UV1", VertexAttribute(VertexAttribute::ComponentTypes::TEXTUREUV));
+	CHECK(b.GetLayout()==layout);
+
+	// Adding an attribute creates a new layout.
+	b.AddVertexAttribute("Normal", VertexAttribute(VertexAttribute::ComponentTypes::VECTOR3));
+	CHECK(b.GetLayout()!=layout);
+	CHECK(b.GetLayout()->GetNormalSlot().IsValid());
+	CHECK(a.GetLayout()==layout);
+
+	// A buffer without attributes still has a layout.
+	VertexBuffer empty(VertexBuffer::Types::STATIC);
+	REQUIRE(empty.GetLayout());
+	CHECK(empty.GetLayout()->GetStride()==0);
+	CHECK(!empty.GetLayout()->GetPositionSlot().IsValid());
+}
+
 TEST_CASE("VertexBuffer")
 {
 	// Turn off log output, we will just use output from this test.
@@ -123,4 +166,5 @@ TEST_CASE("VertexBuffer")
 
 	AllocateTests();
 	AccessorTests();
+	LayoutTests();
 }
@@ -0,0 +1,124 @@
+#include <echo/Kernel/WorkerPool.h>
+#include <echo/Kernel/JobGraph.h>
+#include <doctest/doctest.h>
+#include <atomic>
+#include <vector>
+#undef INFO
+
+using namespace Echo;
+
+TEST_CASE("WorkStealingDeque")
+{
+	WorkStealingDeque<Size> deque(4);
+	Size item = 0;
+	CHECK(!deque.Pop(item));
+	CHECK(!deque.Steal(item));
+
+	// Push beyond the initial capacity to force the buffer to grow.
+	for(Size i=0; i < 10; ++i)
+	{
+		deque.Push(i);
+	}
+	// Owner takes from the bottom, thieves from the top.
+	REQUIRE(deque.Pop(item));
+	CHECK(item==9);
+	REQUIRE(deque.Steal(item));
+	CHECK(item==0);
+	Size remaining = 0;
+	while(deque.Pop(item))
+	{
+		++remaining;
+	}
+	CHECK(remaining==8);
+	CHECK(deque.IsEmpty());
+}
+
+TEST_CASE("WorkerPoolForkJoin")
+{
+	gDefaultLogger.SetLogMask(Echo::Logger::LogLevels::NONE);
+
+	for(Size numberOfWorkers : {0, 1, 4})
+	{
+		WorkerPool pool(numberOfWorkers);
+		std::atomic<Size> executed(0);
+		WorkerPool::Counter counter;
+		for(Size i=0; i < 100; ++i)
+		{
+			pool.Schedule([&pool,&executed]()
+			{
+				// Nested fork/join from within a job.
+				WorkerPool::Counter nestedCounter;
+				for(Size j=0; j < 10; ++j)
+				{
+					pool.Schedule([&executed](){++executed;}, nestedCounter);
+				}
+				pool.Wait(nestedCounter);
+				++executed;
+			}, counter);
+		}
+		pool.Wait(counter);
+		CHECK(counter.IsComplete());
+		CHECK(executed==1100);
+	}
+}
+
+TEST_CASE("WorkerPoolParallelFor")
+{
+	WorkerPool pool(4);
+	std::vector<Size> values(10000, 0);
+	pool.ParallelFor(0, values.size(), 0, [&values](Size begin, Size end)
+	{
+		for(Size i=begin; i < end; ++i)
+		{
+			values[i] += i;
+		}
+	});
+	bool allCorrect = true;
+	for(Size i=0; i < values.size(); ++i)
+	{
+		allCorrect = allCorrect && (values[i]==i);
+	}
+	CHECK(allCorrect);
+
+	// Uneven grain size
+	std::atomic<Size> total(0);
+	pool.ParallelFor(5, 105, 7, [&total](Size begin, Size end){ total += (end - begin); });
+	CHECK(total==100);
+}
+
+TEST_CASE("JobGraph")
+{
+	gDefaultLogger.SetLogMask(Echo::Logger::LogLevels::NONE);
+
+	WorkerPool pool(4);
+	JobGraph graph;
+	std::atomic<Size> sequence(0);
+	Size aOrder = 0, bOrder = 0, cOrder = 0, dOrder = 0;
+	JobGraph::JobID a = graph.AddJob([&](){ aOrder = ++sequence; });
+	JobGraph::JobID b = graph.AddJob([&](){ bOrder = ++sequence; });
+	JobGraph::JobID c = graph.AddJob([&](){ cOrder = ++sequence; });
+	JobGraph::JobID d = graph.AddJob([&](){ dOrder = ++sequence; });
+	// Diamond: a before b and c, d after both
+	CHECK(graph.AddDependency(b, a));
+	CHECK(graph.AddDependency(c, a));
+	CHECK(graph.AddDependency(d, b));
+	CHECK(graph.AddDependency(d, c));
+	CHECK(!graph.AddDependency(d, d));
+
+	for(Size run=0; run < 10; ++run)
+	{
+		sequence = 0;
+		REQUIRE(graph.Execute(pool));
+		CHECK(sequence==4);
+		CHECK(aOrder < bOrder);
+		CHECK(aOrder < cOrder);
+		CHECK(bOrder < dOrder);
+		CHECK(cOrder < dOrder);
+	}
+
+	// Cycles are rejected.
+	CHECK(graph.AddDependency(a, d));
+	sequence = 0;
+	CHECK(!graph.Execute(pool));
+	CHECK(sequence==0);
+}
@@ -0,0 +1,89 @@
+#include <echo/Platform.h>
+#include <echo/FileSystem/FileSystem.h>
+#include <echo/Graphics/Mesh.h>
+#include <echo/Graphics/SubMesh.h>
+#include <echo/Resource/BinaryMeshFile.h>
+#include <echo/Resource/MaterialManager.h>
+#include <echo/Resource/MeshManager.h>
+#include <echo/Resource/ShaderManager.h>
+#include <echo/Resource/SkeletonManager.h>
+#include <echo/Resource/TextureManager.h>
+
+using namespace Echo;
+
+int main(int argc, const char* args[])
+{
+	// Set the format to only display the message
+	gDefaultLogger.SetLogMask("");
+	shared_ptr<FileSystem> fileSystem = Platform::CreateDefaultFileSystem("emeshc");
+	gDefaultLogger.SetLogMask("INFO|ERROR|WARNING");
+	gDefaultLogger.SetFormat("%5$s");
+
+	TextureManager textureManager(*fileSystem);
+	ShaderManager geometryShaderManager("geometry",*fileSystem);
+	ShaderManager vertexShaderManager("vertex",*fileSystem);
+	ShaderManager fragmentShaderManager("fragment",*fileSystem);
+	MaterialManager materialManager(*fileSystem, textureManager, geometryShaderManager, vertexShaderManager, fragmentShaderManager);
+	SkeletonManager skeletonManager(*fileSystem);
+	MeshManager meshManager(*fileSystem, materialManager, skeletonManager);
+
+	// Options come before the input file name.
+	int firstArgument = 1;
+	while(firstArgument + 1 < argc && args[firstArgument][0]=='-')
+	{
+		std::string option = args[firstArgument];
+		std::string value = args[firstArgument + 1];
+		if(option=="-l")
+		{
+			// Materials are stored by name so they need to be known when the mesh is loaded.
+			if(!materialManager.LoadList(fileSystem->Open(value)))
+			{
+				ECHO_LOG_ERROR("Unable to load material list " << value);
+				return 1;
+			}
+		}else
+		{
+			ECHO_LOG_ERROR("Unknown option " << option);
+			return 1;
+		}
+		firstArgument += 2;
+	}
+
+	if(argc - firstArgument != 2)
+	{
+		ECHO_LOG_INFO("Usage: " << args[0] << " [options] meshInput emeshOutput");
+		ECHO_LOG_INFO("Converts a mesh in any format the MeshManager can load to an Echo binary mesh file.");
+		ECHO_LOG_INFO("Options:");
+		ECHO_LOG_INFO("  -l materialList   Load a material resource list so sub mesh materials are found. Can be repeated.");
+		return 0;
+	}
+
+	shared_ptr<Mesh> mesh = meshManager.LoadResource(args[firstArgument], args[firstArgument]);
+	if(!mesh)
+	{
+		ECHO_LOG_ERROR("Unable to load " << args[firstArgument]);
+		return 1;
+	}
+	for(u32 s = 0; s < mesh->GetNumberOfSubMeshes(); ++s)
+	{
+		shared_ptr<SubMesh> subMesh = mesh->GetSubMesh(s);
+		if(!subMesh->GetMaterial())
+		{
+			ECHO_LOG_WARNING("Sub mesh \"" << subMesh->GetName() << "\" has no material and will be written without one");
+		}
+	}
+
+	File output = fileSystem->Open(args[firstArgument + 1], File::OpenModes::WRITE);
+	if(!output.IsOpen())
+	{
+		ECHO_LOG_ERROR("Unable to open " << args[firstArgument + 1] << " for writing");
+		return 1;
+	}
+	if(!WriteBinaryMeshFile(output, *mesh))
+	{
+		ECHO_LOG_ERROR("Failed to write " << args[firstArgument + 1]);
+		return 1;
+	}
+	ECHO_LOG_INFO("Wrote " << args[firstArgument + 1] << " with " << mesh->GetNumberOfSubMeshes() << " sub meshes");
+	return 0;
+}
@@ -2,7 +2,10 @@
 #include <echo/FileSystem/FileSystemSourceVFS.h>
 #include <echo/FileSystem/FileSystemSourceMemory.h>
 #include <echo/FileSystem/FileSystem.h>
+#include <echo/Kernel/WorkerPool.h>
 #include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <thread>
 
 using namespace Echo;
 
@@ -15,30 +18,78 @@ int main(int argc, const char* args[])
 	fileSystem->InstallSource("vfs",vfs);
 	gDefaultLogger.SetLogMask("INFO|ERROR|WARNING");
 	gDefaultLogger.SetFormat("%5$s");
-	if(argc < 2)
+
+	// Options come before the vfs file name.
+	bool indexed = false;
+	FileSystemSourceVFS::VFSCompression compression = FileSystemSourceVFS::VFSCompressions::NONE;
+	Size numberOfThreads = std::max<Size>(1, std::thread::hardware_concurrency());
+	int firstArgument = 1;
+	while(firstArgument + 1 < argc && args[firstArgument][0]=='-')
+	{
+		std::string option = args[firstArgument];
+		std::string value = args[firstArgument + 1];
+		if(option=="-c")
+		{
+			indexed = true;
+			if(value=="none")
+			{
+				compression = FileSystemSourceVFS::VFSCompressions::NONE;
+			}else
+			if(value=="lz4")
+			{
+				compression = FileSystemSourceVFS::VFSCompressions::LZ4;
+			}else
+			if(value=="zstd")
+			{
+				compression = FileSystemSourceVFS::VFSCompressions::ZSTD;
+			}else
+			{
+				ECHO_LOG_ERROR("Unknown compression " << value);
+				return 1;
+			}
+			if(!FileSystemSourceVFS::GetCompressionSupported(compression))
+			{
+				ECHO_LOG_ERROR("Compression " << value << " is not supported by this build");
+				return 1;
+			}
+		}else
+		if(option=="-j")
+		{
+			numberOfThreads = std::max<Size>(1, std::strtoul(value.c_str(), nullptr, 10));
+		}else
+		{
+			ECHO_LOG_ERROR("Unknown option " << option);
+			return 1;
+		}
+		firstArgument += 2;
+	}
+
+	if(argc - firstArgument < 1)
 	{
 		ECHO_LOG_INFO("Usage 1 - list contents of vfs file: " << args[0] << " vfsFile");
-		ECHO_LOG_INFO("Usage 2 - build vfs file from files or directory: " << args[0] << " vfsOutput fileOrDirectory [...fileOrDirectory]");
+		ECHO_LOG_INFO("Usage 2 - build vfs file from files or directory: " << args[0] << " [options] vfsOutput fileOrDirectory [...fileOrDirectory]");
+		ECHO_LOG_INFO("Options:");
+		ECHO_LOG_INFO("  -c none|lz4|zstd  Build an indexed vfs file with files compressed using the specified method.");
+		ECHO_LOG_INFO("  -j threads        Number of threads to compress with. Defaults to the number of hardware threads.");
 		return 0;
 	}
-	if(argc == 2)
+	if(argc - firstArgument == 1)
 	{
-		if(!vfs->LoadVFS(args[1]))
+		if(!vfs->LoadVFS(args[firstArgument]))
 		{
 			ECHO_LOG_ERROR("Unable to load VFS file");
 			return 1;
 		}
 		ECHO_LOG_INFO("Size: " << vfs->GetVFSSize());
-		const std::map< std::string, FileSystemSourceVFS::VFSEntry >& directory = vfs->GetDirectory();
-		for(auto& it : directory)
+		for(const std::string& name : vfs->GetFileNames())
 		{
-			ECHO_LOG_INFO(it.first);
+			ECHO_LOG_INFO(name);
 		}
 		return 1;
 	}
 	
 	// Build VFS file from input
-	for(Size i = 2; i < argc; ++i)
+	for(int i = firstArgument + 1; i < argc; ++i)
 	{
 		boost::filesystem::recursive_directory_iterator it(args[i]);
 		while(it!=boost::filesystem::recursive_directory_iterator())
@@ -57,8 +108,22 @@ int main(int argc, const char* args[])
 		}
 	}
 
-	// We'll make options available later
-	if(!vfs->SaveVFS(args[1],FileSystemSourceVFS::VFSEndianModes::DEFAULT,FileSystemSourceVFS::VFSEntryNameModes::FULL))
+	if(indexed)
+	{
+		shared_ptr<WorkerPool> workerPool;
+		if(numberOfThreads > 1)
+		{
+			// The main thread compresses too.
+			workerPool = make_shared<WorkerPool>(numberOfThreads - 1, "Compressor");
+		}
+		if(!vfs->SaveIndexedVFS(args[firstArgument],FileSystemSourceVFS::VFSEndianModes::DEFAULT,FileSystemSourceVFS::VFSEntryNameModes::FULL,compression,workerPool))
+		{
+			ECHO_LOG_ERROR("Failed to save VFS.");
+			return 1;
+		}
+		return 0;
+	}
+	if(!vfs->SaveVFS(args[firstArgument],FileSystemSourceVFS::VFSEndianModes::DEFAULT,FileSystemSourceVFS::VFSEntryNameModes::FULL))
 	{
 		ECHO_LOG_ERROR("Failed to save VFS.");
 		return 1;
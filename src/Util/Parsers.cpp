@@ -2,6 +2,9 @@
 #include <echo/Util/Parsers.h>
 #include <echo/Util/Utils.h>
 #include <echo/Util/FunctionBinder.h>
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <cctype>
 
 namespace Echo
 {
@@ -173,12 +176,20 @@ namespace Echo
 
 		void ConditionalEvaluator::RegisterVariableViaGetter(const std::string& name, function<double()> getterFunction)
 		{
-			mBinder->RegisterVoid(name,getterFunction);
+			if(mBinder->RegisterVoid(name,getterFunction))
+			{
+				GetVariable(name)->mGetter = getterFunction;
+			}
 		}
 
 		void ConditionalEvaluator::DeregisterVariable(const std::string& name)
 		{
 			mBinder->Deregister(name);
+			std::map< std::string, shared_ptr<CompiledConditional::Variable> >::iterator it = mVariables.find(name);
+			if(it!=mVariables.end())
+			{
+				it->second->mGetter = nullptr;
+			}
 		}
 
 		/**
@@ -298,6 +309,422 @@ namespace Echo
 				);
 		}
 		
+		/**
+		 * Compiles expressions for CompiledConditional.
+		 * This is a recursive descent version of the rules in ConditionalEvaluator::Initialise() and must be kept in
+		 * step with them. Alternatives are tried in the same order and a failed alternative restores the position and
+		 * the instructions so the result matches the backtracking of the Spirit rules.
+		 */
+		class ConditionalEvaluator::Compiler
+		{
+		public:
+			Compiler(const ConditionalEvaluator& evaluator, CompiledConditional& compiled) :
+				mEvaluator(evaluator),
+				mCompiled(compiled),
+				mIt(compiled.mExpression.begin()),
+				mEnd(compiled.mExpression.end())
+			{}
+
+			bool Compile()
+			{
+				if(!CompoundCondition())
+				{
+					return false;
+				}
+				SkipSpace();
+				if(mIt!=mEnd)
+				{
+					return false;
+				}
+
+				// Work out how deep the stack gets so evaluation doesn't need to allocate.
+				Size depth = 0;
+				Size maximumDepth = 0;
+				BOOST_FOREACH(const CompiledConditional::Instruction& instruction, mCompiled.mInstructions)
+				{
+					switch(instruction.mOpCode)
+					{
+						case CompiledConditional::OpCodes::PUSH_CONSTANT:
+						case CompiledConditional::OpCodes::PUSH_VARIABLE:
+							depth++;
+							maximumDepth = std::max(maximumDepth, depth);
+						break;
+						case CompiledConditional::OpCodes::NEGATE:
+						break;
+						default:
+							depth--;
+						break;
+					}
+				}
+				mCompiled.mStack.resize(maximumDepth);
+				return true;
+			}
+
+			std::string GetRemaining() const
+			{
+				return std::string(mIt, mEnd);
+			}
+		private:
+			typedef std::string::const_iterator Iterator;
+			struct State
+			{
+				Iterator mIt;
+				Size mInstructions;
+				Size mVariables;
+			};
+
+			State Save() const
+			{
+				State state;
+				state.mIt = mIt;
+				state.mInstructions = mCompiled.mInstructions.size();
+				state.mVariables = mCompiled.mVariables.size();
+				return state;
+			}
+
+			bool Restore(const State& state)
+			{
+				mIt = state.mIt;
+				mCompiled.mInstructions.resize(state.mInstructions, CompiledConditional::Instruction(CompiledConditional::OpCodes::PUSH_CONSTANT));
+				mCompiled.mVariables.resize(state.mVariables);
+				return false;
+			}
+
+			void SkipSpace()
+			{
+				while(mIt!=mEnd && std::isspace(static_cast<unsigned char>(*mIt)))
+				{
+					++mIt;
+				}
+			}
+
+			bool Literal(const char* literal)
+			{
+				SkipSpace();
+				Iterator it = mIt;
+				for(; *literal; ++literal, ++it)
+				{
+					if(it==mEnd || *it!=*literal)
+					{
+						return false;
+					}
+				}
+				mIt = it;
+				return true;
+			}
+
+			void Emit(CompiledConditional::OpCode opCode, double constant = 0, Size variable = 0)
+			{
+				mCompiled.mInstructions.push_back(CompiledConditional::Instruction(opCode, constant, variable));
+			}
+
+			bool CompoundCondition()
+			{
+				if(!Condition())
+				{
+					return false;
+				}
+				while(true)
+				{
+					State state = Save();
+					CompiledConditional::OpCode opCode;
+					if(Literal("&&"))
+					{
+						opCode = CompiledConditional::OpCodes::AND;
+					}else
+					if(Literal("||"))
+					{
+						opCode = CompiledConditional::OpCodes::OR;
+					}else
+					{
+						return true;
+					}
+					if(!Condition())
+					{
+						Restore(state);
+						return true;
+					}
+					Emit(opCode);
+				}
+			}
+
+			bool Condition()
+			{
+				if(!Expression())
+				{
+					return false;
+				}
+
+				// The operators are tried in the same order as the rule and each one re-parses the right hand side.
+				static const std::pair<const char*, CompiledConditional::OpCode> comparisons[] =
+				{
+					std::make_pair(">", CompiledConditional::OpCodes::GREATER),
+					std::make_pair("<", CompiledConditional::OpCodes::LESS),
+					std::make_pair("==", CompiledConditional::OpCodes::EQUAL),
+					std::make_pair("!=", CompiledConditional::OpCodes::NOT_EQUAL),
+					std::make_pair(">=", CompiledConditional::OpCodes::GREATER_EQUAL),
+					std::make_pair("<=", CompiledConditional::OpCodes::LESS_EQUAL)
+				};
+				State afterLeft = Save();
+				for(Size c = 0; c < sizeof(comparisons) / sizeof(comparisons[0]); ++c)
+				{
+					if(Literal(comparisons[c].first) && Expression())
+					{
+						Emit(comparisons[c].second);
+						return true;
+					}
+					Restore(afterLeft);
+				}
+
+				// No comparison so the expression is evaluated on its own.
+				return true;
+			}
+
+			bool Expression()
+			{
+				if(!Term())
+				{
+					return false;
+				}
+				while(true)
+				{
+					State state = Save();
+					CompiledConditional::OpCode opCode;
+					if(Literal("+"))
+					{
+						opCode = CompiledConditional::OpCodes::ADD;
+					}else
+					if(Literal("-"))
+					{
+						opCode = CompiledConditional::OpCodes::SUBTRACT;
+					}else
+					{
+						return true;
+					}
+					if(!Term())
+					{
+						Restore(state);
+						return true;
+					}
+					Emit(opCode);
+				}
+			}
+
+			bool Term()
+			{
+				if(!Factor())
+				{
+					return false;
+				}
+				while(true)
+				{
+					State state = Save();
+					CompiledConditional::OpCode opCode;
+					if(Literal("*"))
+					{
+						opCode = CompiledConditional::OpCodes::MULTIPLY;
+					}else
+					if(Literal("/"))
+					{
+						opCode = CompiledConditional::OpCodes::DIVIDE;
+					}else
+					if(Literal("%"))
+					{
+						opCode = CompiledConditional::OpCodes::MODULUS;
+					}else
+					{
+						return true;
+					}
+					if(!Factor())
+					{
+						Restore(state);
+						return true;
+					}
+					Emit(opCode);
+				}
+			}
+
+			bool Factor()
+			{
+				SkipSpace();
+				State state = Save();
+
+				double value;
+				if(qi::parse(mIt, mEnd, qi::double_, value))
+				{
+					Emit(CompiledConditional::OpCodes::PUSH_CONSTANT, value);
+					return true;
+				}
+				Restore(state);
+
+				if(Variable())
+				{
+					return true;
+				}
+				Restore(state);
+
+				if(Literal("("))
+				{
+					if(Expression() && Literal(")"))
+					{
+						return true;
+					}
+					Restore(state);
+				}
+
+				if(Literal("-"))
+				{
+					if(Factor())
+					{
+						Emit(CompiledConditional::OpCodes::NEGATE);
+						return true;
+					}
+					Restore(state);
+				}
+
+				if(Literal("+"))
+				{
+					if(Factor())
+					{
+						return true;
+					}
+					Restore(state);
+				}
+				return false;
+			}
+
+			bool Variable()
+			{
+				// Use the same character set as the variable rule.
+				using ascii::char_;
+				using ascii::space;
+				std::string symbol;
+				if(!qi::parse(mIt, mEnd, qi::as_string[+(char_ - char_("+-*/()%=><!|&") - space)], symbol))
+				{
+					return false;
+				}
+				mCompiled.mVariables.push_back(mEvaluator.GetVariable(symbol));
+				Emit(CompiledConditional::OpCodes::PUSH_VARIABLE, 0, mCompiled.mVariables.size() - 1);
+				return true;
+			}
+
+			const ConditionalEvaluator& mEvaluator;
+			CompiledConditional& mCompiled;
+			Iterator mIt;
+			Iterator mEnd;
+		};
+
+		optional<bool> CompiledConditional::Evaluate() const
+		{
+			double* stack = mStack.data();
+			Size top = 0;
+			BOOST_FOREACH(const Instruction& instruction, mInstructions)
+			{
+				switch(instruction.mOpCode)
+				{
+					case OpCodes::PUSH_CONSTANT:
+						stack[top++] = instruction.mConstant;
+					break;
+					case OpCodes::PUSH_VARIABLE:
+					{
+						const Variable& variable = *mVariables[instruction.mVariable];
+						if(variable.mGetter)
+						{
+							stack[top++] = variable.mGetter();
+						}else
+						{
+							double result = 1;
+							if(!mBinder || mBinder->Call<double>(variable.mSymbol,&result).mStatus!=FunctionBinder::CallStatuses::SUCCESS)
+							{
+								return none;
+							}
+							stack[top++] = result;
+						}
+					}break;
+					case OpCodes::NEGATE:
+						stack[top-1] = -stack[top-1];
+					break;
+					default:
+					{
+						double right = stack[--top];
+						double& left = stack[top-1];
+						switch(instruction.mOpCode)
+						{
+							case OpCodes::ADD:				left += right;	break;
+							case OpCodes::SUBTRACT:			left -= right;	break;
+							case OpCodes::MULTIPLY:			left *= right;	break;
+							case OpCodes::DIVIDE:			left /= right;	break;
+							case OpCodes::MODULUS:			left = static_cast<int>(left) % static_cast<int>(right);	break;
+							case OpCodes::GREATER:			left = left > right;	break;
+							case OpCodes::LESS:				left = left < right;	break;
+							case OpCodes::EQUAL:			left = left == right;	break;
+							case OpCodes::NOT_EQUAL:		left = left != right;	break;
+							case OpCodes::GREATER_EQUAL:	left = left >= right;	break;
+							case OpCodes::LESS_EQUAL:		left = left <= right;	break;
+							case OpCodes::AND:				left = (left!=0) && (right!=0);	break;
+							case OpCodes::OR:				left = (left!=0) || (right!=0);	break;
+							default: break;
+						}
+					}break;
+				}
+			}
+			return stack[0]!=0;
+		}
+		
+		shared_ptr<CompiledConditional> ConditionalEvaluator::Compile(const std::string& expression) const
+		{
+			mLastParseErrors.resize(0);
+			shared_ptr<CompiledConditional> compiled(new CompiledConditional());
+			compiled->mExpression = expression;
+			compiled->mBinder = mBinder;
+			Compiler compiler(*this, *compiled);
+			if(!compiler.Compile())
+			{
+				std::stringstream ss;
+				ss << "Parsing of expression: \""<<expression<<"\" failed at \"" << compiler.GetRemaining() << "\"";
+				ReportError(ss.str());
+				return shared_ptr<CompiledConditional>();
+			}
+			return compiled;
+		}
+
+		optional<bool> ConditionalEvaluator::Evaluate(const std::string& expression) const
+		{
+			std::map< std::string, shared_ptr<CompiledConditional> >::iterator it = mCompiledConditionals.find(expression);
+			if(it==mCompiledConditionals.end())
+			{
+				shared_ptr<CompiledConditional> compiled = Compile(expression);
+				if(!compiled)
+				{
+					return none;
+				}
+				it = mCompiledConditionals.insert(std::make_pair(expression, compiled)).first;
+			}else
+			{
+				mLastParseErrors.resize(0);
+			}
+
+			optional<bool> result = it->second->Evaluate();
+			if(!result)
+			{
+				std::stringstream ss;
+				ss << "Evaluation of expression: \""<<expression<<"\" failed because a symbol look up failed";
+				ReportError(ss.str());
+			}
+			return result;
+		}
+
+		shared_ptr<CompiledConditional::Variable> ConditionalEvaluator::GetVariable(const std::string& symbol) const
+		{
+			shared_ptr<CompiledConditional::Variable>& variable = mVariables[symbol];
+			if(!variable)
+			{
+				variable.reset(new CompiledConditional::Variable());
+				variable->mSymbol = symbol;
+			}
+			return variable;
+		}
+
 		////////////////////////////////////////////////////////////////////////
 		// VariableSubstitutor
 		